@@ -0,0 +1,557 @@
+/* bench_tinycrypt.c - TinyCrypt microbenchmarks */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *  DESCRIPTION
+ * Times the TinyCrypt primitives and prints one CSV line per case:
+ *
+ *   name,bytes,iterations,ns_per_op,cycles_per_op,cycles_per_byte,
+ *   mb_per_s,ops_per_s
+ *
+ *  Bulk primitives (AES modes, SHA-256, HMAC, CMAC, PRNGs) run at several
+ *  message sizes; ECC operations have bytes == 0 and report ops_per_s.
+ *  Every case is run once to warm up, then timed over 5 samples of at least
+ *  -t milliseconds each (default 50), and the median sample is reported, so
+ *  that one preempted sample does not move the result. The inputs are fixed,
+ *  except for the random numbers ECC draws from default_CSPRNG.
+ *
+ *  cycles_per_op is read from the time stamp counter on x86, which counts
+ *  at a constant reference rate rather than the current core clock; on
+ *  other targets it is derived from -f <MHz> if given and left empty if
+ *  not. For stable numbers, pin the process to one core and disable
+ *  frequency scaling.
+ *
+ *  Usage: bench_tinycrypt [-t ms] [-f MHz] [name-prefix ...]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <tinycrypt/aes.h>
+#include <tinycrypt/aes_cache.h>
+#include <tinycrypt/cbc_mode.h>
+#include <tinycrypt/ctr_mode.h>
+#include <tinycrypt/ccm_mode.h>
+#include <tinycrypt/gcm_mode.h>
+#include <tinycrypt/cmac_mode.h>
+#include <tinycrypt/etm_mode.h>
+#include <tinycrypt/sha256.h>
+#include <tinycrypt/hmac.h>
+#include <tinycrypt/hmac_prng.h>
+#include <tinycrypt/ctr_prng.h>
+#include <tinycrypt/ecc.h>
+#include <tinycrypt/ecc_dh.h>
+#include <tinycrypt/ecc_dsa.h>
+#include <tinycrypt/ecc_platform_specific.h>
+#include <tinycrypt/x25519.h>
+#include <tinycrypt/constants.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BENCH_HAVE_TSC
+#endif
+
+#define SAMPLES 5
+#define MAX_SIZE 8192
+
+/* message sizes of the bulk cases; 0 terminates */
+static const unsigned int sizes[] = { 16, 64, 256, 1024, 8192, 0 };
+
+static uint8_t in[MAX_SIZE + 2 * TC_AES_BLOCK_SIZE];
+static uint8_t out[MAX_SIZE + 2 * TC_AES_BLOCK_SIZE];
+
+/* encrypt-then-MAC cases run on records larger than the data caches */
+#define RECORD_SIZE (1U << 20)
+static uint8_t record_in[RECORD_SIZE];
+static uint8_t record_out[RECORD_SIZE + TC_AES_BLOCK_SIZE];
+static uint8_t iv[TC_AES_BLOCK_SIZE];
+static const uint8_t key[TC_AES_KEY_SIZE] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+	0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+
+static struct tc_aes_key_sched_struct enc_sched, dec_sched;
+/* key setup cases cycle through this many handles of a cache that fits them */
+#define CACHE_KEYS 16
+static struct tc_aes_cache_slot cache_slots[CACHE_KEYS];
+static struct tc_aes_cache_struct key_cache;
+static unsigned int cache_key;
+static struct tc_ccm_mode_struct ccm;
+static struct tc_gcm_mode_struct gcm;
+static struct tc_cmac_key_struct cmac;
+static struct tc_hmac_key_struct hmac;
+static struct tc_hmac_prng_struct hmac_prng;
+static TCCtrPrng_t ctr_prng;
+static uint8_t nonce[13];
+
+static uint8_t ecc_private[NUM_ECC_BYTES];
+static uint8_t ecc_public[2 * NUM_ECC_BYTES];
+static uint8_t ecc_peer[2 * NUM_ECC_BYTES];
+static uint8_t ecc_hash[NUM_ECC_BYTES];
+static uint8_t ecc_signature[2 * NUM_ECC_BYTES];
+static uint8_t x25519_private[TC_X25519_KEY_SIZE];
+static uint8_t x25519_peer[TC_X25519_KEY_SIZE];
+
+/* set by a case that fails, so that broken builds do not pass */
+static int failed;
+
+static void check(int r)
+{
+	if (r != TC_CRYPTO_SUCCESS) {
+		failed = 1;
+	}
+}
+
+/* one operation of each case, on size bytes of in */
+static void run_aes_encrypt(unsigned int size)
+{
+	(void)size;
+	check(tc_aes_encrypt(out, in, &enc_sched));
+}
+
+static void run_aes_decrypt(unsigned int size)
+{
+	(void)size;
+	check(tc_aes_decrypt(out, in, &dec_sched));
+}
+
+static void run_key_setup(unsigned int size)
+{
+	struct tc_aes_key_sched_struct e, d;
+
+	(void)size;
+	check(tc_aes128_set_encrypt_key(&e, key));
+	check(tc_aes128_set_decrypt_key(&d, key));
+}
+
+static void run_key_cached(unsigned int size)
+{
+	TCAesKeySched_t e, d;
+	uint32_t handle = cache_key++ % CACHE_KEYS;
+
+	(void)size;
+	check(tc_aes_cache_encrypt_key(&e, &key_cache, handle, key,
+				       sizeof(key)));
+	check(tc_aes_cache_decrypt_key(&d, &key_cache, handle, key,
+				       sizeof(key)));
+}
+
+static void run_ctr(unsigned int size)
+{
+	uint8_t ctr[TC_AES_BLOCK_SIZE];
+
+	memcpy(ctr, iv, sizeof(ctr));
+	check(tc_ctr_mode(out, size, in, size, ctr, &enc_sched));
+}
+
+static void run_cbc_encrypt(unsigned int size)
+{
+	check(tc_cbc_mode_encrypt(out, size + TC_AES_BLOCK_SIZE, in, size, iv,
+				  &enc_sched));
+}
+
+static void run_cbc_decrypt(unsigned int size)
+{
+	/* in holds the iv followed by the ciphertext */
+	check(tc_cbc_mode_decrypt(out, size, in + TC_AES_BLOCK_SIZE, size, in,
+				  &dec_sched));
+}
+
+static void run_ccm(unsigned int size)
+{
+	check(tc_ccm_generation_encryption(out, size + 8, 0, 0, in, size,
+					   &ccm));
+}
+
+static void run_gcm(unsigned int size)
+{
+	check(tc_gcm_generation_encryption(out, size + 16, iv, 12, 0, 0, in,
+					   size, &gcm));
+}
+
+static void run_cmac(unsigned int size)
+{
+	check(tc_cmac_key_mac(out, in, size, &cmac));
+}
+
+static void run_etm_ctr_hmac(unsigned int size)
+{
+	uint8_t ctr[TC_AES_BLOCK_SIZE];
+
+	memcpy(ctr, iv, sizeof(ctr));
+	check(tc_etm_ctr_hmac_encrypt(record_out, size, record_in, size, ctr,
+				      &enc_sched, &hmac, out));
+}
+
+/* the same result in two passes */
+static void run_ctr_then_hmac(unsigned int size)
+{
+	struct tc_sha256_state_struct s;
+	uint8_t ctr[TC_AES_BLOCK_SIZE];
+
+	memcpy(ctr, iv, sizeof(ctr));
+	check(tc_ctr_mode(record_out, size, record_in, size, ctr, &enc_sched));
+	check(tc_hmac_key_init(&s, &hmac));
+	check(tc_sha256_update(&s, iv, sizeof(iv)));
+	check(tc_sha256_update(&s, record_out, size));
+	check(tc_hmac_key_final(out, TC_SHA256_DIGEST_SIZE, &s, &hmac));
+}
+
+static void run_etm_cbc_cmac(unsigned int size)
+{
+	check(tc_etm_cbc_cmac_encrypt(record_out, size + TC_AES_BLOCK_SIZE,
+				      record_in, size, iv, &enc_sched, &cmac,
+				      out));
+}
+
+static void run_cbc_then_cmac(unsigned int size)
+{
+	check(tc_cbc_mode_encrypt(record_out, size + TC_AES_BLOCK_SIZE,
+				  record_in, size, iv, &enc_sched));
+	check(tc_cmac_key_mac(out, record_out, size + TC_AES_BLOCK_SIZE,
+			      &cmac));
+}
+
+static void run_sha256(unsigned int size)
+{
+	struct tc_sha256_state_struct s;
+
+	check(tc_sha256_init(&s));
+	check(tc_sha256_update(&s, in, size));
+	check(tc_sha256_final(out, &s));
+}
+
+static void run_hmac(unsigned int size)
+{
+	check(tc_hmac_key_mac(out, TC_SHA256_DIGEST_SIZE, in, size, &hmac));
+}
+
+static void run_hmac_prng(unsigned int size)
+{
+	check(tc_hmac_prng_generate(out, size, &hmac_prng));
+}
+
+static void run_ctr_prng(unsigned int size)
+{
+	check(tc_ctr_prng_generate(&ctr_prng, 0, 0, out, size));
+}
+
+static void run_ecc_keygen(unsigned int size)
+{
+	(void)size;
+	check(uECC_make_key(out, out + 2 * NUM_ECC_BYTES, uECC_secp256r1()));
+}
+
+static void run_ecc_ecdh(unsigned int size)
+{
+	(void)size;
+	check(uECC_shared_secret(ecc_peer, ecc_private, out,
+				 uECC_secp256r1()));
+}
+
+static void run_ecc_sign(unsigned int size)
+{
+	(void)size;
+	check(uECC_sign(ecc_private, ecc_hash, sizeof(ecc_hash), out,
+			uECC_secp256r1()));
+}
+
+static void run_ecc_sign_det(unsigned int size)
+{
+	(void)size;
+	check(uECC_sign_deterministic(ecc_private, ecc_hash, sizeof(ecc_hash),
+				      out, uECC_secp256r1()));
+}
+
+static void run_ecc_verify(unsigned int size)
+{
+	(void)size;
+	check(uECC_verify(ecc_public, ecc_hash, sizeof(ecc_hash),
+			  ecc_signature, uECC_secp256r1()));
+}
+
+static void run_x25519_keygen(unsigned int size)
+{
+	(void)size;
+	check(tc_x25519_make_key(out, out + TC_X25519_KEY_SIZE));
+}
+
+static void run_x25519_shared(unsigned int size)
+{
+	(void)size;
+	check(tc_x25519_shared_secret(x25519_peer, x25519_private, out));
+}
+
+struct bench_case {
+	const char *name;
+	void (*run)(unsigned int size);
+	/* 0: run at each of sizes[]; otherwise the only size (bytes column) */
+	unsigned int size;
+};
+
+static const struct bench_case cases[] = {
+	{ "aes128_encrypt_block", run_aes_encrypt, TC_AES_BLOCK_SIZE },
+	{ "aes128_decrypt_block", run_aes_decrypt, TC_AES_BLOCK_SIZE },
+	{ "aes128_key_setup", run_key_setup, (unsigned int)-1 },
+	{ "aes128_key_cached", run_key_cached, (unsigned int)-1 },
+	{ "aes128_ctr", run_ctr, 0 },
+	{ "aes128_cbc_encrypt", run_cbc_encrypt, 0 },
+	{ "aes128_cbc_decrypt", run_cbc_decrypt, 0 },
+	{ "aes128_ccm_encrypt", run_ccm, 0 },
+	{ "aes128_gcm_encrypt", run_gcm, 0 },
+	{ "aes128_cmac", run_cmac, 0 },
+	{ "etm_ctr_hmac", run_etm_ctr_hmac, RECORD_SIZE },
+	{ "ctr_then_hmac", run_ctr_then_hmac, RECORD_SIZE },
+	{ "etm_cbc_cmac", run_etm_cbc_cmac, RECORD_SIZE },
+	{ "cbc_then_cmac", run_cbc_then_cmac, RECORD_SIZE },
+	{ "sha256", run_sha256, 0 },
+	{ "hmac_sha256", run_hmac, 0 },
+	{ "hmac_prng_generate", run_hmac_prng, 0 },
+	{ "ctr_prng_generate", run_ctr_prng, 0 },
+	{ "p256_keygen", run_ecc_keygen, (unsigned int)-1 },
+	{ "p256_ecdh", run_ecc_ecdh, (unsigned int)-1 },
+	{ "p256_sign", run_ecc_sign, (unsigned int)-1 },
+	{ "p256_sign_rfc6979", run_ecc_sign_det, (unsigned int)-1 },
+	{ "p256_verify", run_ecc_verify, (unsigned int)-1 },
+	{ "x25519_keygen", run_x25519_keygen, (unsigned int)-1 },
+	{ "x25519_shared", run_x25519_shared, (unsigned int)-1 },
+};
+
+static uint64_t now_ns(void)
+{
+	struct timespec t;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec * 1000000000U + (uint64_t)t.tv_nsec;
+}
+
+static uint64_t now_cycles(void)
+{
+#if defined(BENCH_HAVE_TSC)
+	return __builtin_ia32_rdtsc();
+#else
+	return 0;
+#endif
+}
+
+#if defined(BENCH_HAVE_TSC)
+static const int have_cycles = 1;
+#else
+static const int have_cycles = 0;
+#endif
+
+struct sample {
+	double ns;
+	double cycles;
+};
+
+static int compare_samples(const void *a, const void *b)
+{
+	double x = ((const struct sample *)a)->ns;
+	double y = ((const struct sample *)b)->ns;
+
+	return (x > y) - (x < y);
+}
+
+static void bench(const struct bench_case *c, unsigned int size,
+		  uint64_t min_ns, double mhz)
+{
+	struct sample s[SAMPLES];
+	unsigned long iterations = 1, i;
+	unsigned int bytes = size == (unsigned int)-1 ? 0 : size;
+	uint64_t t0, c0, elapsed;
+	double ns_per_op, cycles_per_op;
+	int j;
+
+	/* warm up, then double the iteration count until a sample is long
+	 * enough */
+	c->run(size);
+	for (;;) {
+		t0 = now_ns();
+		for (i = 0; i < iterations; ++i) {
+			c->run(size);
+		}
+		elapsed = now_ns() - t0;
+		if (elapsed >= min_ns || iterations >= (1UL << 30)) {
+			break;
+		}
+		iterations *= 2;
+	}
+
+	for (j = 0; j < SAMPLES; ++j) {
+		c0 = now_cycles();
+		t0 = now_ns();
+		for (i = 0; i < iterations; ++i) {
+			c->run(size);
+		}
+		s[j].ns = (double)(now_ns() - t0) / iterations;
+		s[j].cycles = (double)(now_cycles() - c0) / iterations;
+	}
+	qsort(s, SAMPLES, sizeof(s[0]), compare_samples);
+
+	ns_per_op = s[SAMPLES / 2].ns;
+	cycles_per_op = s[SAMPLES / 2].cycles;
+	if (mhz > 0) {
+		cycles_per_op = ns_per_op * mhz / 1000.0;
+	}
+
+	printf("%s,%u,%lu,%.1f,", c->name, bytes, iterations, ns_per_op);
+	if (!have_cycles && mhz <= 0) {
+		printf(",,");
+	} else if (bytes > 0) {
+		printf("%.0f,%.2f,", cycles_per_op, cycles_per_op / bytes);
+	} else {
+		printf("%.0f,,", cycles_per_op);
+	}
+	if (bytes > 0) {
+		printf("%.1f,", bytes * 1000.0 / ns_per_op);
+	} else {
+		printf(",");
+	}
+	printf("%.1f\n", 1e9 / ns_per_op);
+	fflush(stdout);
+	if (failed == 1) {
+		fprintf(stderr, "bench_tinycrypt: %s failed at %u bytes\n",
+			c->name, bytes);
+		failed = 2;
+	}
+}
+
+static int selected(const char *name, int argc, char **argv, int first)
+{
+	int i;
+
+	if (first >= argc) {
+		return 1;
+	}
+	for (i = first; i < argc; ++i) {
+		if (strncmp(name, argv[i], strlen(argv[i])) == 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int setup(void)
+{
+	uint8_t seed[32];
+	unsigned int i;
+
+	for (i = 0; i < sizeof(in); ++i) {
+		in[i] = (uint8_t)(i * 31 + 7);
+	}
+	for (i = 0; i < sizeof(nonce); ++i) {
+		nonce[i] = (uint8_t)i;
+	}
+	for (i = 0; i < sizeof(iv); ++i) {
+		iv[i] = (uint8_t)(0xf0 + i);
+	}
+	memset(seed, 0x5a, sizeof(seed));
+
+	if (!tc_aes128_set_encrypt_key(&enc_sched, key) ||
+	    !tc_aes128_set_decrypt_key(&dec_sched, key) ||
+	    !tc_aes_cache_init(&key_cache, cache_slots, CACHE_KEYS) ||
+	    !tc_ccm_config(&ccm, &enc_sched, nonce, sizeof(nonce), 8) ||
+	    !tc_gcm_config(&gcm, &enc_sched, 16) ||
+	    !tc_cmac_key_set(&cmac, key, sizeof(key), &enc_sched) ||
+	    !tc_hmac_key_set(&hmac, key, sizeof(key)) ||
+	    !tc_hmac_prng_init(&hmac_prng, nonce, sizeof(nonce)) ||
+	    !tc_hmac_prng_reseed(&hmac_prng, seed, sizeof(seed), 0, 0) ||
+	    !tc_ctr_prng_init(&ctr_prng, seed, sizeof(seed), 0, 0)) {
+		return 0;
+	}
+
+	uECC_set_rng(&default_CSPRNG);
+	memcpy(ecc_hash, in, sizeof(ecc_hash));
+	return uECC_make_key(ecc_peer, ecc_private, uECC_secp256r1()) &&
+	       uECC_make_key(ecc_public, ecc_private, uECC_secp256r1()) &&
+	       uECC_sign(ecc_private, ecc_hash, sizeof(ecc_hash),
+			 ecc_signature, uECC_secp256r1()) &&
+	       tc_x25519_make_key(x25519_peer, out) &&
+	       tc_x25519_make_key(out, x25519_private);
+}
+
+int main(int argc, char **argv)
+{
+	uint64_t min_ns = 50000000U;
+	double mhz = 0;
+	unsigned int i, j;
+	int first = 1;
+
+	while (first + 1 < argc && argv[first][0] == '-') {
+		if (strcmp(argv[first], "-t") == 0) {
+			min_ns = (uint64_t)strtoul(argv[first + 1], 0, 10) *
+				 1000000U;
+		} else if (strcmp(argv[first], "-f") == 0) {
+			mhz = strtod(argv[first + 1], 0);
+		} else {
+			break;
+		}
+		first += 2;
+	}
+	if (first < argc && argv[first][0] == '-') {
+		fprintf(stderr,
+			"usage: %s [-t ms] [-f MHz] [name-prefix ...]\n",
+			argv[0]);
+		return 2;
+	}
+
+	if (!setup()) {
+		fprintf(stderr, "bench_tinycrypt: setup failed\n");
+		return 1;
+	}
+
+	printf("name,bytes,iterations,ns_per_op,cycles_per_op,"
+	       "cycles_per_byte,mb_per_s,ops_per_s\n");
+	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+		if (!selected(cases[i].name, argc, argv, first)) {
+			continue;
+		}
+		if (cases[i].size != 0) {
+			bench(&cases[i], cases[i].size, min_ns, mhz);
+			continue;
+		}
+		for (j = 0; sizes[j] != 0; ++j) {
+			bench(&cases[i], sizes[j], min_ns, mhz);
+		}
+	}
+
+	if (failed) {
+		fprintf(stderr, "bench_tinycrypt: a primitive failed\n");
+		return 1;
+	}
+	return 0;
+}
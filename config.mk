@@ -8,12 +8,21 @@
 
 # EDIT HERE:
 CC:=gcc
-CFLAGS:=-Os -std=c99 -Wall -Wextra -D_ISOC99_SOURCE -MMD -I../lib/include/ -I../lib/source/ -I../tests/include/
+CFLAGS:=-std=c99 -Wall -Wextra -D_ISOC99_SOURCE -MMD -I../lib/include/ -I../lib/source/ -I../tests/include/
+# Build profile, e.g. "make PROFILE=fast":
+#   tiny     -- -Os and the default options, the smallest code (MCUs)
+#   balanced -- -O2, the run-time detected AES, SHA-256 and GHASH engines and
+#               small ECC tables (about 1.2 KB of const data)
+#   fast     -- -O3 with LTO and loop unrolling, the largest ECC tables,
+#               64-bit ECC words where available, stored AES decryption round
+#               keys and secp256r1 only (servers)
+# lib/tinycrypt_profile.h records the options the library was built with.
+PROFILE?=tiny
 vpath %.c ../lib/source/
 ENABLE_TESTS=true
 
-# override MinGW built-in recipe
-%.o: %.c
+# override MinGW built-in recipe; objects are rebuilt when the profile changes
+%.o: %.c .profile
 	$(COMPILE.c) $(OUTPUT_OPTION) $<
 
 ifeq ($(OS),Windows_NT)
@@ -21,6 +30,38 @@ DOTEXE:=.exe
 endif
 
 # DO NOT EDIT AFTER THIS POINT:
+ifeq ($(PROFILE),tiny)
+PROFILE_CFLAGS:=-Os
+PROFILE_DEFS:=
+else ifeq ($(PROFILE),balanced)
+PROFILE_CFLAGS:=-O2
+PROFILE_DEFS:=TINYCRYPT_AES_HW TINYCRYPT_SHA256_HW TINYCRYPT_GCM_CLMUL \
+	uECC_FIXED_BASE_TEETH=4 uECC_VERIFY_WNAF_WINDOW=4
+else ifeq ($(PROFILE),fast)
+PROFILE_CFLAGS:=-O3 -funroll-loops -flto=auto
+PROFILE_DEFS:=TINYCRYPT_AES_HW TINYCRYPT_SHA256_HW TINYCRYPT_GCM_CLMUL \
+	TINYCRYPT_AES_INV_KEYS uECC_FIXED_BASE_TEETH=6 uECC_VERIFY_WNAF_WINDOW=6 \
+	uECC_SINGLE_CURVE=1
+ifneq ($(shell echo __SIZEOF_INT128__ | $(CC) -E -P - 2>/dev/null),__SIZEOF_INT128__)
+PROFILE_DEFS+=uECC_WORD_SIZE=8
+endif
+# the LTO objects are linked with the same options, and archived with the
+# LTO plugin
+LDFLAGS+=$(PROFILE_CFLAGS)
+ifeq ($(CC),gcc)
+AR:=gcc-ar
+endif
+else
+$(error PROFILE must be tiny, balanced or fast)
+endif
+CFLAGS += $(PROFILE_CFLAGS) $(addprefix -D,$(PROFILE_DEFS))
+
+# .profile changes, and so forces a rebuild, when the profile does
+PROFILE_LINE:=$(PROFILE) $(PROFILE_CFLAGS) $(PROFILE_DEFS)
+.profile: .profile-check
+	@echo "$(PROFILE_LINE)" | cmp -s - $@ || echo "$(PROFILE_LINE)" > $@
+.profile-check:
+
 ifeq ($(ENABLE_TESTS), true)
 CFLAGS += -DENABLE_TESTS
 else
@@ -29,6 +70,7 @@ endif
 
 export CC
 export CFLAGS
+export PROFILE
 export VPATH
 export ENABLE_TESTS
 
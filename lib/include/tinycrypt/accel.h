@@ -0,0 +1,263 @@
+/* accel.h - TinyCrypt interface to external crypto accelerator drivers */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief -- Interface to external crypto accelerator drivers.
+ *
+ *  Overview:   Many MCUs (e.g. the Renesas SCE and TSIP) have on-chip AES,
+ *              SHA-256 and ECC engines. A driver for such an engine fills in
+ *              a table of operations for one primitive and registers it, with
+ *              a context pointer of its own, at run time. When the library
+ *              is built with TINYCRYPT_ACCEL:
+ *
+ *              - tc_aes_encrypt, tc_aes_decrypt and their _blocks variants
+ *                (and so every mode built on them) hand their blocks to the
+ *                registered AES operations;
+ *              - the SHA-256 compression of tc_sha256_update and
+ *                tc_sha256_final hands its blocks to the registered SHA-256
+ *                operation;
+ *              - the P-256 scalar multiplications of key generation, ECDSA
+ *                signing and ECDH go to the registered P-256 operation.
+ *
+ *              An operation which is missing (NULL), or which returns
+ *              TC_CRYPTO_FAIL (busy, key size not supported, ...), is run in
+ *              software instead, as it is when no driver is registered: a
+ *              driver only implements what its engine does well. The driver
+ *              is tried before the CPU instruction engines of aes_hw.h and
+ *              sha256_hw.h.
+ *
+ *              tc_aes_encrypt_blocks_async and tc_aes_decrypt_blocks_async
+ *              queue a bulk job on the engine and return at once; a callback
+ *              reports its completion. Without an asynchronous driver they
+ *              do the job in software and call the callback before
+ *              returning, so callers need a single code path.
+ *
+ *  Security:   Results of the P-256 operation are checked to be on the curve
+ *              before being used; a bad one makes the software compute the
+ *              product again. The software countermeasures of ECDH (the
+ *              random initial Z) are left to the engine when it does the
+ *              multiplication. Drivers receive key schedules, keys and
+ *              scalars, and must not keep copies of them beyond an
+ *              operation.
+ *
+ *              Registration is not thread-safe: register the drivers before
+ *              the library is used, and unregister them (with NULL) only
+ *              when it is no longer used.
+ */
+
+#ifndef __TC_ACCEL_H__
+#define __TC_ACCEL_H__
+
+#include <tinycrypt/aes.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the sizes of the P-256 operands of struct tc_accel_p256_ops */
+#define TC_ACCEL_P256_SCALAR_SIZE (32)
+#define TC_ACCEL_P256_POINT_SIZE (64)
+
+/**
+ *  @brief Completion callback of an asynchronous job
+ *  @param arg IN -- the argument given with the job
+ *  @param result IN -- TC_CRYPTO_SUCCESS (1) if the output was written,
+ *                      TC_CRYPTO_FAIL (0) if the engine failed
+ */
+typedef void (*tc_accel_done_t)(void *arg, int result);
+
+/*
+ * AES operations of a driver. Each receives the ctx given to
+ * tc_accel_register_aes and an encryption key schedule s, whose key can be
+ * read with tc_accel_aes_key. They return TC_CRYPTO_SUCCESS after writing
+ * out, or TC_CRYPTO_FAIL, leaving out (and so in, when out == in) untouched,
+ * to have the software do the work. out and in point to 16 bytes (nblocks *
+ * 16 for the _blocks operations) and out may be equal to in. Any operation
+ * may be NULL.
+ *
+ * The _async operations return TC_CRYPTO_SUCCESS once the job is accepted
+ * and then call done(arg, result) exactly once, possibly from an interrupt
+ * handler; out and in stay valid until then. They return TC_CRYPTO_FAIL,
+ * without calling done, to decline the job.
+ */
+struct tc_accel_aes_ops {
+	int (*encrypt)(void *ctx, uint8_t *out, const uint8_t *in,
+		       const TCAesKeySched_t s);
+	int (*decrypt)(void *ctx, uint8_t *out, const uint8_t *in,
+		       const TCAesKeySched_t s);
+	int (*encrypt_blocks)(void *ctx, uint8_t *out, const uint8_t *in,
+			      unsigned int nblocks, const TCAesKeySched_t s);
+	int (*decrypt_blocks)(void *ctx, uint8_t *out, const uint8_t *in,
+			      unsigned int nblocks, const TCAesKeySched_t s);
+	int (*encrypt_blocks_async)(void *ctx, uint8_t *out, const uint8_t *in,
+				    unsigned int nblocks,
+				    const TCAesKeySched_t s,
+				    tc_accel_done_t done, void *arg);
+	int (*decrypt_blocks_async)(void *ctx, uint8_t *out, const uint8_t *in,
+				    unsigned int nblocks,
+				    const TCAesKeySched_t s,
+				    tc_accel_done_t done, void *arg);
+};
+
+/*
+ * SHA-256 operation of a driver: runs the compression function over nblocks
+ * 64-byte blocks of data, updating the chaining value iv (eight words, as in
+ * struct tc_sha256_state_struct). Returns TC_CRYPTO_SUCCESS, or
+ * TC_CRYPTO_FAIL, leaving iv untouched, to have the software do the work.
+ */
+struct tc_accel_sha256_ops {
+	int (*compress_blocks)(void *ctx, unsigned int *iv,
+			       const uint8_t *data, size_t nblocks);
+};
+
+/*
+ * P-256 operation of a driver: result = scalar * point, where point is the
+ * generator when it is NULL. result and point are x || y as big-endian
+ * coordinates (TC_ACCEL_P256_POINT_SIZE bytes), scalar is big-endian
+ * (TC_ACCEL_P256_SCALAR_SIZE bytes) with 0 < scalar < n. Returns
+ * TC_CRYPTO_SUCCESS, or TC_CRYPTO_FAIL to have the software do the work.
+ */
+struct tc_accel_p256_ops {
+	int (*mult)(void *ctx, uint8_t *result, const uint8_t *point,
+		    const uint8_t *scalar);
+};
+
+/**
+ *  @brief Registers the AES operations of a driver
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *  @note ops must stay valid while registered; NULL unregisters the driver
+ *  @param ops IN -- operations of the driver, or NULL
+ *  @param ctx IN -- passed to each operation
+ */
+int tc_accel_register_aes(const struct tc_accel_aes_ops *ops, void *ctx);
+
+/**
+ *  @brief Registers the SHA-256 operation of a driver
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *  @note ops must stay valid while registered; NULL unregisters the driver
+ *  @param ops IN -- operation of the driver, or NULL
+ *  @param ctx IN -- passed to the operation
+ */
+int tc_accel_register_sha256(const struct tc_accel_sha256_ops *ops,
+			     void *ctx);
+
+/**
+ *  @brief Registers the P-256 operation of a driver
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *  @note ops must stay valid while registered; NULL unregisters the driver
+ *  @param ops IN -- operation of the driver, or NULL
+ *  @param ctx IN -- passed to the operation
+ */
+int tc_accel_register_p256(const struct tc_accel_p256_ops *ops, void *ctx);
+
+/**
+ *  @brief Reads the key back from an encryption key schedule, for drivers
+ *         of engines which expand keys themselves
+ *  @return returns the key size in bytes (16, 24 or 32)
+ *  @param key OUT -- receives the key, TC_AES_256_KEY_SIZE bytes at most
+ *  @param s IN -- key schedule initialized by tc_aes_set_encrypt_key
+ */
+unsigned int tc_accel_aes_key(uint8_t *key, const TCAesKeySched_t s);
+
+/**
+ *  @brief AES encryption of nblocks independent blocks as an asynchronous job
+ *  @return returns TC_CRYPTO_SUCCESS (1) once the job is queued or done;
+ *          done is then called exactly once
+ *          returns TC_CRYPTO_FAIL (0) if out == NULL or in == NULL or
+ *          s == NULL or done == NULL; done is not called
+ *  @note out and in point to nblocks * 16 bytes, out may be equal to in, and
+ *        neither may be touched until done is called. Without a driver
+ *        accepting the job, it is done in software and done is called
+ *        before returning.
+ *  @param out IN/OUT -- buffer to receive ciphertext blocks
+ *  @param in IN -- plaintext blocks to encrypt
+ *  @param nblocks IN -- number of blocks in in
+ *  @param s IN -- initialized AES key schedule
+ *  @param done IN -- completion callback
+ *  @param arg IN -- argument of done
+ */
+int tc_aes_encrypt_blocks_async(uint8_t *out, const uint8_t *in,
+				unsigned int nblocks, const TCAesKeySched_t s,
+				tc_accel_done_t done, void *arg);
+
+/**
+ *  @brief AES decryption of nblocks independent blocks as an asynchronous job
+ *  @return returns TC_CRYPTO_SUCCESS (1) once the job is queued or done;
+ *          done is then called exactly once
+ *          returns TC_CRYPTO_FAIL (0) if out == NULL or in == NULL or
+ *          s == NULL or done == NULL; done is not called
+ *  @note s is the encryption key schedule, as for tc_aes_decrypt_blocks;
+ *        the buffers are handled as by tc_aes_encrypt_blocks_async
+ *  @param out IN/OUT -- buffer to receive plaintext blocks
+ *  @param in IN -- ciphertext blocks to decrypt
+ *  @param nblocks IN -- number of blocks in in
+ *  @param s IN -- initialized AES key schedule
+ *  @param done IN -- completion callback
+ *  @param arg IN -- argument of done
+ */
+int tc_aes_decrypt_blocks_async(uint8_t *out, const uint8_t *in,
+				unsigned int nblocks, const TCAesKeySched_t s,
+				tc_accel_done_t done, void *arg);
+
+/*
+ * Dispatch to the registered drivers, used by the primitives. Each returns
+ * TC_CRYPTO_SUCCESS if a driver did the work, TC_CRYPTO_FAIL otherwise.
+ */
+int tc_accel_aes_encrypt(uint8_t *out, const uint8_t *in,
+			 const TCAesKeySched_t s);
+int tc_accel_aes_decrypt(uint8_t *out, const uint8_t *in,
+			 const TCAesKeySched_t s);
+int tc_accel_aes_encrypt_blocks(uint8_t *out, const uint8_t *in,
+				unsigned int nblocks, const TCAesKeySched_t s);
+int tc_accel_aes_decrypt_blocks(uint8_t *out, const uint8_t *in,
+				unsigned int nblocks, const TCAesKeySched_t s);
+int tc_accel_aes_encrypt_blocks_async(uint8_t *out, const uint8_t *in,
+				      unsigned int nblocks,
+				      const TCAesKeySched_t s,
+				      tc_accel_done_t done, void *arg);
+int tc_accel_aes_decrypt_blocks_async(uint8_t *out, const uint8_t *in,
+				      unsigned int nblocks,
+				      const TCAesKeySched_t s,
+				      tc_accel_done_t done, void *arg);
+int tc_accel_sha256_compress_blocks(unsigned int *iv, const uint8_t *data,
+				    size_t nblocks);
+int tc_accel_p256_mult(uint8_t *result, const uint8_t *point,
+		       const uint8_t *scalar);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_ACCEL_H__ */
@@ -39,9 +39,22 @@
  *              perform a transformation specified by a symmetric key in fixed-
  *              length data sets, also called blocks.
  *
+ *              AES-192 and AES-256 key schedules are also provided; the
+ *              schedule records its number of rounds, so all the modes built
+ *              on tc_aes_encrypt/decrypt work with any of the key sizes.
+ *              Define TINYCRYPT_AES_128_ONLY to shrink the schedule to the
+ *              AES-128 size and leave the larger keys out.
+ *
+ *              Define TINYCRYPT_AES_INV_KEYS to give the schedule room for
+ *              the decryption round keys (up to 208 more bytes), so that
+ *              tc_aes_set_decrypt_key derives them once rather than on each
+ *              decryption call.
+ *
  *  Security:   AES-128 provides approximately 128 bits of security.
  *
- *  Usage:      1) call tc_aes128_set_encrypt/decrypt_key to set the key.
+ *  Usage:      1) call tc_aes128_set_encrypt/decrypt_key (or
+ *                 tc_aes_set_encrypt/decrypt_key for other key sizes) to set
+ *                 the key.
  *
  *              2) call tc_aes_encrypt/decrypt to process the data.
  */
@@ -60,26 +73,70 @@ extern "C" {
 #define Nr (10) /* number of rounds */
 #define TC_AES_BLOCK_SIZE (Nb*Nk)
 #define TC_AES_KEY_SIZE (Nb*Nk)
+#define TC_AES_192_KEY_SIZE (24)
+#define TC_AES_256_KEY_SIZE (32)
+
+#if defined(TINYCRYPT_AES_128_ONLY)
+#define TC_AES_MAX_ROUNDS (Nr)
+#else
+#define TC_AES_MAX_ROUNDS (14) /* number of rounds of AES-256 */
+#endif
 
 typedef struct tc_aes_key_sched_struct {
-	unsigned int words[Nb*(Nr+1)];
+	unsigned int words[Nb*(TC_AES_MAX_ROUNDS+1)];
+	/* rounds beyond the Nr of AES-128 (0, 2 or 4); stored as an offset so
+	 * that a zeroed schedule remains an AES-128 one */
+	unsigned int extra_rounds;
+#if defined(TINYCRYPT_AES_INV_KEYS)
+	/* middle round keys of the equivalent inverse cipher (InvMixColumns of
+	 * words[Nb] .. words[Nb*rounds-1]); set by tc_aes_prepare_decrypt and
+	 * valid if inv_ready != 0 */
+	unsigned int inv_words[Nb*(TC_AES_MAX_ROUNDS-1)];
+	unsigned int inv_ready;
+#endif
 } *TCAesKeySched_t;
 
+/* number of rounds of an initialized key schedule */
+#define TC_AES_ROUNDS(s) (Nr + (s)->extra_rounds)
+
+/* the stored decryption round keys of s, or a null pointer if it has none */
+#if defined(TINYCRYPT_AES_INV_KEYS)
+#define TC_AES_INV_WORDS(s) \
+	((s)->inv_ready ? (const unsigned int *) (s)->inv_words : \
+			  (const unsigned int *) 0)
+#else
+#define TC_AES_INV_WORDS(s) ((const unsigned int *) 0)
+#endif
+
+/**
+ *  @brief Set AES encryption key
+ *  Uses key k of klen bytes to initialize s for AES-128 (klen == 16),
+ *  AES-192 (klen == 24) or AES-256 (klen == 32)
+ *  @return  returns TC_CRYPTO_SUCCESS (1)
+ *           returns TC_CRYPTO_FAIL (0) if: s == NULL or k == NULL or
+ *                                          klen is not a supported key size
+ *  @note       Only klen == 16 is supported if TINYCRYPT_AES_128_ONLY is
+ *              defined
+ *  @param      s IN/OUT -- initialized struct tc_aes_key_sched_struct
+ *  @param      k IN -- points to the AES key
+ *  @param      klen IN -- size of the key in bytes
+ */
+int tc_aes_set_encrypt_key(TCAesKeySched_t s, const uint8_t *k,
+			   unsigned int klen);
+
 /**
  *  @brief Set AES-128 encryption key
  *  Uses key k to initialize s
  *  @return  returns TC_CRYPTO_SUCCESS (1)
  *           returns TC_CRYPTO_FAIL (0) if: s == NULL or k == NULL
- *  @note       This implementation skips the additional steps required for keys
- *              larger than 128 bits, and must not be used for AES-192 or
- *              AES-256 key schedule -- see FIPS 197 for details
+ *  @note       Same as tc_aes_set_encrypt_key(s, k, TC_AES_KEY_SIZE)
  *  @param      s IN/OUT -- initialized struct tc_aes_key_sched_struct
  *  @param      k IN -- points to the AES key
  */
 int tc_aes128_set_encrypt_key(TCAesKeySched_t s, const uint8_t *k);
 
 /**
- *  @brief AES-128 Encryption procedure
+ *  @brief AES Encryption procedure
  *  Encrypts contents of in buffer into out buffer under key;
  *              schedule s
  *  @note Assumes s was initialized by aes_set_encrypt_key;
@@ -93,24 +150,69 @@ int tc_aes128_set_encrypt_key(TCAesKeySched_t s, const uint8_t *k);
 int tc_aes_encrypt(uint8_t *out, const uint8_t *in, 
 		   const TCAesKeySched_t s);
 
+/**
+ *  @brief AES Encryption procedure for several blocks
+ *  Encrypts nblocks independent blocks (ECB) of in buffer into out buffer
+ *  under key schedule s. Accelerated engines process several blocks at once
+ *  here, so modes with independent blocks (e.g. CTR) should prefer it to
+ *  repeated tc_aes_encrypt calls.
+ *  @note Assumes s was initialized by aes_set_encrypt_key;
+ *              out and in point to nblocks * 16 bytes; out may be equal
+ *              to in
+ *  @return  returns TC_CRYPTO_SUCCESS (1)
+ *           returns TC_CRYPTO_FAIL (0) if: out == NULL or in == NULL or s == NULL
+ *  @param out IN/OUT -- buffer to receive ciphertext blocks
+ *  @param in IN -- plaintext blocks to encrypt
+ *  @param nblocks IN -- number of blocks in in
+ *  @param s IN -- initialized AES key schedule
+ */
+int tc_aes_encrypt_blocks(uint8_t *out, const uint8_t *in,
+			  unsigned int nblocks, const TCAesKeySched_t s);
+
+/**
+ *  @brief Set the AES decryption key
+ *  Uses key k of klen bytes to initialize s for AES-128 (klen == 16),
+ *  AES-192 (klen == 24) or AES-256 (klen == 32)
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if: s == NULL or k == NULL or
+ *                                         klen is not a supported key size
+ *  @note       Same as tc_aes_set_encrypt_key followed by
+ *              tc_aes_prepare_decrypt, so either direction can use s
+ *  @param s  IN/OUT -- initialized struct tc_aes_key_sched_struct
+ *  @param k  IN -- points to the AES key
+ *  @param klen IN -- size of the key in bytes
+ */
+int tc_aes_set_decrypt_key(TCAesKeySched_t s, const uint8_t *k,
+			   unsigned int klen);
+
+/**
+ *  @brief Derive the decryption round keys of an encryption key schedule
+ *  tc_aes_decrypt and tc_aes_decrypt_blocks run the equivalent inverse
+ *  cipher of FIPS-197 figure 15, whose middle round keys are InvMixColumns
+ *  of the encryption ones. This stores them in s, which then serves both
+ *  directions; without it they are derived again on each decryption call.
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if s == NULL
+ *  @note   Assumes s was initialized by aes_set_encrypt_key; setting a new
+ *          key discards the decryption round keys. Does nothing unless
+ *          TINYCRYPT_AES_INV_KEYS is defined
+ *  @param s  IN/OUT -- initialized AES key schedule
+ */
+int tc_aes_prepare_decrypt(TCAesKeySched_t s);
+
 /**
  *  @brief Set the AES-128 decryption key
  *  Uses key k to initialize s
  *  @return returns TC_CRYPTO_SUCCESS (1)
  *          returns TC_CRYPTO_FAIL (0) if: s == NULL or k == NULL
- *  @note       This is the implementation of the straightforward inverse cipher
- *              using the cipher documented in FIPS-197 figure 12, not the
- *              equivalent inverse cipher presented in Figure 15
- *  @warning    This routine skips the additional steps required for keys larger
- *              than 128, and must not be used for AES-192 or AES-256 key
- *              schedule -- see FIPS 197 for details
+ *  @note       Same as tc_aes_set_decrypt_key(s, k, TC_AES_KEY_SIZE)
  *  @param s  IN/OUT -- initialized struct tc_aes_key_sched_struct
  *  @param k  IN -- points to the AES key
  */
 int tc_aes128_set_decrypt_key(TCAesKeySched_t s, const uint8_t *k);
 
 /**
- *  @brief AES-128 Encryption procedure
+ *  @brief AES Decryption procedure
  *  Decrypts in buffer into out buffer under key schedule s
  *  @return returns TC_CRYPTO_SUCCESS (1)
  *          returns TC_CRYPTO_FAIL (0) if: out is NULL or in is NULL or s is NULL
@@ -123,6 +225,25 @@ int tc_aes128_set_decrypt_key(TCAesKeySched_t s, const uint8_t *k);
 int tc_aes_decrypt(uint8_t *out, const uint8_t *in, 
 		   const TCAesKeySched_t s);
 
+/**
+ *  @brief AES Decryption procedure for several blocks
+ *  Decrypts nblocks independent blocks (ECB) of in buffer into out buffer
+ *  under key schedule s. Accelerated engines process several blocks at once
+ *  here, so modes whose decryption has no chaining dependency (e.g. CBC)
+ *  should prefer it to repeated tc_aes_decrypt calls.
+ *  @note Assumes s was initialized by aes_set_encrypt_key;
+ *              out and in point to nblocks * 16 bytes; out may be equal
+ *              to in
+ *  @return  returns TC_CRYPTO_SUCCESS (1)
+ *           returns TC_CRYPTO_FAIL (0) if: out == NULL or in == NULL or s == NULL
+ *  @param out IN/OUT -- buffer to receive plaintext blocks
+ *  @param in IN -- ciphertext blocks to decrypt
+ *  @param nblocks IN -- number of blocks in in
+ *  @param s IN -- initialized AES key schedule
+ */
+int tc_aes_decrypt_blocks(uint8_t *out, const uint8_t *in,
+			  unsigned int nblocks, const TCAesKeySched_t s);
+
 #ifdef __cplusplus
 }
 #endif
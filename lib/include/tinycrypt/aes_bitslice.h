@@ -0,0 +1,105 @@
+/* aes_bitslice.h - TinyCrypt interface to the bitsliced AES engine */
+
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief -- Interface to a bitsliced, constant-time AES engine.
+ *
+ *  Overview:   This engine encrypts and decrypts 8 blocks at a time without
+ *              any table lookup: the blocks are transposed into 8 bit planes
+ *              (plane j holding bit j of every byte) and the S-box is computed
+ *              as a boolean circuit (Boyar and Peralta) on whole machine
+ *              words. It works directly on the key schedule produced by
+ *              tc_aes128_set_encrypt_key (or tc_aes128_set_decrypt_key).
+ *
+ *              The planes are 32-bit words on 32-bit targets and 64-bit words
+ *              on 64-bit targets; define TINYCRYPT_AES_BITSLICE_WORD to 32 or
+ *              64 to override the choice.
+ *
+ *              Define TINYCRYPT_AES_BITSLICE to make the multi-block entry
+ *              points (tc_aes_encrypt_blocks, used by the CTR bulk path) run
+ *              on this engine when no hardware engine is in use. Single-block
+ *              calls keep using the table implementation, since the engine
+ *              always processes 8 blocks.
+ *
+ *  Security:   The running time and memory access pattern do not depend on
+ *              the key or the data.
+ */
+
+#ifndef __TC_AES_BITSLICE_H__
+#define __TC_AES_BITSLICE_H__
+
+#include <tinycrypt/aes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of blocks the engine processes per pass. */
+#define TC_AES_BITSLICE_BLOCKS (8)
+
+/**
+ *  @brief Bitsliced AES encryption of nblocks independent blocks
+ *  @return  returns TC_CRYPTO_SUCCESS (1)
+ *           returns TC_CRYPTO_FAIL (0) if: out == NULL or in == NULL or s == NULL
+ *  @note Assumes s was initialized by aes_set_encrypt_key; out and in point
+ *        to nblocks * 16 bytes and out may be equal to in
+ *  @param out IN/OUT -- buffer to receive ciphertext blocks
+ *  @param in IN -- plaintext blocks to encrypt
+ *  @param nblocks IN -- number of blocks in in
+ *  @param s IN -- initialized AES key schedule
+ */
+int tc_aes_bitslice_encrypt_blocks(uint8_t *out, const uint8_t *in,
+				   unsigned int nblocks,
+				   const TCAesKeySched_t s);
+
+/**
+ *  @brief Bitsliced AES decryption of nblocks independent blocks
+ *  @return  returns TC_CRYPTO_SUCCESS (1)
+ *           returns TC_CRYPTO_FAIL (0) if: out == NULL or in == NULL or s == NULL
+ *  @note Assumes s was initialized by aes_set_encrypt_key; out and in point
+ *        to nblocks * 16 bytes and out may be equal to in
+ *  @param out IN/OUT -- buffer to receive plaintext blocks
+ *  @param in IN -- ciphertext blocks to decrypt
+ *  @param nblocks IN -- number of blocks in in
+ *  @param s IN -- initialized AES key schedule
+ */
+int tc_aes_bitslice_decrypt_blocks(uint8_t *out, const uint8_t *in,
+				   unsigned int nblocks,
+				   const TCAesKeySched_t s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_AES_BITSLICE_H__ */
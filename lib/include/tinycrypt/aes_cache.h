@@ -0,0 +1,195 @@
+/* aes_cache.h - TinyCrypt interface to an AES key schedule cache */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to a bounded cache of AES key schedules.
+ *
+ *  Overview:   Code juggling many keys (e.g. one per session) would otherwise
+ *              run the AES key expansion each time a key is used again. The
+ *              cache keeps up to count expanded keys, each in a slot of its
+ *              own named by a caller-chosen 32-bit handle (a session or key
+ *              id). A slot holds the schedule of its key, to which the
+ *              decryption round keys (see tc_aes_prepare_decrypt) are added
+ *              the first time they are asked for; the key itself need not be
+ *              kept anywhere else, since it can be read back from the first
+ *              words of the schedule.
+ *
+ *              Slots are padded and aligned to TINYCRYPT_CACHE_LINE_SIZE
+ *              bytes (with GCC-compatible compilers), so no two keys share a
+ *              cache line. When the cache is full, the least recently used
+ *              slot is erased and reused.
+ *
+ *  Security:   Evicted slots are erased with _set_secure. A lookup given the
+ *              key checks it against the cached one in constant time, so a
+ *              handle reused for another key never returns a stale schedule.
+ *              The cache holds key material until tc_aes_cache_evict or
+ *              tc_aes_cache_erase; the slots deserve the same protection as
+ *              the keys.
+ *
+ *              The cache is not thread-safe: give each thread its own, or
+ *              serialize the calls.
+ *
+ *  Requires:   AES-128 (and AES-192/256 unless TINYCRYPT_AES_128_ONLY)
+ *
+ *  Usage:      1) allocate an array of count struct tc_aes_cache_slot and
+ *              call tc_aes_cache_init
+ *
+ *              2) call tc_aes_cache_encrypt_key (or tc_aes_cache_decrypt_key)
+ *              with the key's handle whenever a schedule is needed, and pass
+ *              the schedule it returns to tc_ccm_config, tc_gcm_config,
+ *              tc_ctr_mode, etc.; it is valid until the next call on the
+ *              same cache
+ *
+ *              3) call tc_aes_cache_evict when a key is retired, and
+ *              tc_aes_cache_erase once the cache is no longer used
+ */
+
+#ifndef __TC_AES_CACHE_H__
+#define __TC_AES_CACHE_H__
+
+#include <tinycrypt/aes.h>
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef TINYCRYPT_CACHE_LINE_SIZE
+#define TINYCRYPT_CACHE_LINE_SIZE 64
+#endif
+
+#if defined(__GNUC__)
+#define TC_AES_CACHE_ALIGNED __attribute__((aligned(TINYCRYPT_CACHE_LINE_SIZE)))
+#else
+#define TC_AES_CACHE_ALIGNED
+#endif
+
+/* struct tc_aes_cache_slot holds the schedule of one key */
+struct tc_aes_cache_slot {
+	/* handle of the key, meaningful if state != 0 */
+	uint32_t handle;
+	/* 0 if the slot is free */
+	uint32_t state;
+	/* value of the cache clock at the last use */
+	uint32_t stamp;
+	/* serves both directions once tc_aes_cache_decrypt_key has added its
+	 * decryption round keys */
+	struct tc_aes_key_sched_struct sched;
+} TC_AES_CACHE_ALIGNED;
+
+typedef struct tc_aes_cache_struct {
+	/* array of count slots */
+	struct tc_aes_cache_slot *slot;
+	unsigned int count;
+	/* advanced on every lookup */
+	uint32_t clock;
+} *TCAesCache_t;
+
+/**
+ *  @brief Cache initialization procedure
+ *  Empties the count slots and hands them to c
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                c == NULL,
+ *                slots == NULL or
+ *                count == 0
+ *  @param c OUT -- the cache to initialize
+ *  @param slots IN/OUT -- array of count slots, owned by the cache until
+ *                tc_aes_cache_erase
+ *  @param count IN -- number of slots
+ */
+int tc_aes_cache_init(TCAesCache_t c, struct tc_aes_cache_slot *slots,
+		      unsigned int count);
+
+/**
+ *  @brief Returns the encryption schedule of the key named handle
+ *  Expands k into a slot, evicting the least recently used one if need be,
+ *  unless handle is cached with the same key already.
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                sched == NULL,
+ *                c == NULL,
+ *                k == NULL and handle is not cached or
+ *                klen is not a supported key size
+ *  @note With k == NULL, only looks handle up (klen is then ignored); code
+ *        that does not keep its keys around can then expand one only once
+ *  @note *sched stays valid until the next call on c
+ *  @param sched OUT -- the cached schedule
+ *  @param c IN/OUT -- the cache
+ *  @param handle IN -- the name of the key
+ *  @param k IN -- the key, or NULL
+ *  @param klen IN -- size of k in bytes (16, 24 or 32)
+ */
+int tc_aes_cache_encrypt_key(TCAesKeySched_t *sched, TCAesCache_t c,
+			     uint32_t handle, const uint8_t *k,
+			     unsigned int klen);
+
+/**
+ *  @brief Returns the decryption schedule of the key named handle
+ *  Same as tc_aes_cache_encrypt_key, for tc_aes_decrypt and the modes built
+ *  on it. The schedule is the same one, whose decryption round keys are
+ *  derived the first time it is asked for; it still encrypts.
+ *  @param sched OUT -- the cached schedule
+ *  @param c IN/OUT -- the cache
+ *  @param handle IN -- the name of the key
+ *  @param k IN -- the key, or NULL
+ *  @param klen IN -- size of k in bytes (16, 24 or 32)
+ */
+int tc_aes_cache_decrypt_key(TCAesKeySched_t *sched, TCAesCache_t c,
+			     uint32_t handle, const uint8_t *k,
+			     unsigned int klen);
+
+/**
+ *  @brief Erases the slot of the key named handle
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                c == NULL or
+ *                handle is not cached
+ *  @param c IN/OUT -- the cache
+ *  @param handle IN -- the name of the key
+ */
+int tc_aes_cache_evict(TCAesCache_t c, uint32_t handle);
+
+/**
+ *  @brief Erases every slot; c must be initialized again before reuse
+ *  @return none
+ *  @param c IN/OUT -- the cache
+ */
+void tc_aes_cache_erase(TCAesCache_t c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_AES_CACHE_H__ */
@@ -0,0 +1,137 @@
+/* aes_hw.h - TinyCrypt interface to the hardware accelerated AES engine */
+
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief -- Interface to the AES-NI / ARMv8 Crypto Extension AES engine.
+ *
+ *  Overview:   This engine runs the AES rounds on the AES instructions of the
+ *              processor when they are available. It works directly on the
+ *              key schedule produced by tc_aes128_set_encrypt_key (or
+ *              tc_aes128_set_decrypt_key), so callers keep using
+ *              TCAesKeySched_t unchanged.
+ *
+ *              The x86 engine is compiled whenever the compiler supports the
+ *              target attribute (GCC and clang); the instructions are then
+ *              checked for at run time with CPUID. The ARM engine requires
+ *              the crypto extension to be enabled at build time (e.g.
+ *              -march=armv8-a+crypto) and, on Linux, is also checked for at
+ *              run time through HWCAP.
+ *
+ *              Define TINYCRYPT_AES_HW to make tc_aes_encrypt/tc_aes_decrypt
+ *              (and therefore all modes built on them) use the engine
+ *              whenever tc_aes_hw_available() reports it; the portable code
+ *              is used otherwise.
+ *
+ *  Security:   The AES instructions run in constant time.
+ */
+
+#ifndef __TC_AES_HW_H__
+#define __TC_AES_HW_H__
+
+#include <tinycrypt/aes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  @brief Reports whether the hardware AES engine can be used
+ *  @return returns 1 if the engine is compiled in and the CPU supports it
+ *          returns 0 otherwise
+ */
+int tc_aes_hw_available(void);
+
+/**
+ *  @brief AES encryption of one block with the AES instructions
+ *  @return  returns TC_CRYPTO_SUCCESS (1)
+ *           returns TC_CRYPTO_FAIL (0) if the engine is not available
+ *  @note Assumes tc_aes_hw_available() returned 1 and s was initialized by
+ *        aes_set_encrypt_key; out and in point to 16 byte buffers
+ *  @param out IN/OUT -- buffer to receive ciphertext block
+ *  @param in IN -- a plaintext block to encrypt
+ *  @param s IN -- initialized AES key schedule
+ */
+int tc_aes_hw_encrypt(uint8_t *out, const uint8_t *in,
+		      const TCAesKeySched_t s);
+
+/**
+ *  @brief AES encryption of nblocks independent blocks with the AES
+ *         instructions, several blocks being processed at once
+ *  @return  returns TC_CRYPTO_SUCCESS (1)
+ *           returns TC_CRYPTO_FAIL (0) if the engine is not available
+ *  @note Assumes tc_aes_hw_available() returned 1 and s was initialized by
+ *        aes_set_encrypt_key; out and in point to nblocks * 16 bytes and
+ *        out may be equal to in
+ *  @param out IN/OUT -- buffer to receive ciphertext blocks
+ *  @param in IN -- plaintext blocks to encrypt
+ *  @param nblocks IN -- number of blocks in in
+ *  @param s IN -- initialized AES key schedule
+ */
+int tc_aes_hw_encrypt_blocks(uint8_t *out, const uint8_t *in,
+			     unsigned int nblocks, const TCAesKeySched_t s);
+
+/**
+ *  @brief AES decryption of one block with the AES instructions
+ *  @return  returns TC_CRYPTO_SUCCESS (1)
+ *           returns TC_CRYPTO_FAIL (0) if the engine is not available
+ *  @note Assumes tc_aes_hw_available() returned 1 and s was initialized by
+ *        aes_set_encrypt_key; out and in point to 16 byte buffers
+ *  @param out IN/OUT -- buffer to receive plaintext block
+ *  @param in IN -- a ciphertext block to decrypt
+ *  @param s IN -- initialized AES key schedule
+ */
+int tc_aes_hw_decrypt(uint8_t *out, const uint8_t *in,
+		      const TCAesKeySched_t s);
+
+/**
+ *  @brief AES decryption of several independent blocks with the AES
+ *  instructions
+ *  @return  returns TC_CRYPTO_SUCCESS (1)
+ *           returns TC_CRYPTO_FAIL (0) if the engine is not available
+ *  @note Assumes tc_aes_hw_available() returned 1 and s was initialized by
+ *        aes_set_encrypt_key; out and in point to nblocks * 16 bytes and
+ *        out may be equal to in
+ *  @param out IN/OUT -- buffer to receive plaintext blocks
+ *  @param in IN -- ciphertext blocks to decrypt
+ *  @param nblocks IN -- number of blocks in in
+ *  @param s IN -- initialized AES key schedule
+ */
+int tc_aes_hw_decrypt_blocks(uint8_t *out, const uint8_t *in,
+			     unsigned int nblocks, const TCAesKeySched_t s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_AES_HW_H__ */
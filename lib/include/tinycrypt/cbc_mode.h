@@ -75,6 +75,7 @@
 #define __TC_CBC_MODE_H__
 
 #include <tinycrypt/aes.h>
+#include <tinycrypt/iovec.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -111,6 +112,31 @@ int tc_cbc_mode_encrypt(uint8_t *out, unsigned int outlen, const uint8_t *in,
 			unsigned int inlen, const uint8_t *iv,
 			const TCAesKeySched_t sched);
 
+/**
+ *  @brief CBC scatter-gather encryption procedure
+ *  Same as tc_cbc_mode_encrypt, reading the plaintext from the incnt
+ *  segments of in and writing iv and ciphertext to the outcnt segments of out
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                in == NULL or
+ *                iv == NULL or
+ *                sched == NULL or
+ *                the plaintext is empty or
+ *                its length is not a multiple of TC_AES_BLOCK_SIZE or
+ *                the output length is not its length + TC_AES_BLOCK_SIZE
+ *  @note Segments may be split anywhere, not only on block boundaries
+ *  @param out IN -- segments receiving iv and ciphertext
+ *  @param outcnt IN -- number of output segments
+ *  @param in IN -- segments of the plaintext
+ *  @param incnt IN -- number of input segments
+ *  @param iv IN -- the IV for this encrypt
+ *  @param sched IN --  AES key schedule for this encrypt
+ */
+int tc_cbc_mode_encryptv(const struct tc_iovec *out, unsigned int outcnt,
+			 const struct tc_iovec *in, unsigned int incnt,
+			 const uint8_t *iv, const TCAesKeySched_t sched);
+
 /**
  * @brief CBC decryption procedure
  * CBC decrypts inlen bytes of the in buffer into the out buffer
@@ -130,8 +156,11 @@ int tc_cbc_mode_encrypt(uint8_t *out, unsigned int outlen, const uint8_t *in,
  *                algorithm that would not otherwise be possible
  *              - sched was configured by aes_set_decrypt_key
  *              - out buffer is large enough to hold the decrypted plaintext
- *              and is a contiguous buffer
+ *              and is a contiguous buffer; out may be equal to in (in-place
+ *              decryption) or start below it, but not inside it
  *              - inlen gives the number of bytes in the in buffer
+ *              - blocks are deciphered TINYCRYPT_CBC_BATCH_BLOCKS at a time
+ *              through tc_aes_decrypt_blocks
  * @param out IN/OUT -- buffer to receive decrypted data
  * @param outlen IN -- length of plaintext buffer in bytes
  * @param in IN -- ciphertext to decrypt, including IV
@@ -69,6 +69,13 @@
  *            2) call tc_ccm_mode_encrypt to encrypt data and generate tag.
  *
  *            3) call tc_ccm_mode_decrypt to decrypt data and verify tag.
+ *
+ *            Data held in several buffers can instead be processed with the
+ *            incremental interface: call tc_ccm_stream_init with the total
+ *            lengths, feed the associated data with tc_ccm_stream_update_aad
+ *            and the payload with tc_ccm_stream_encrypt (or
+ *            tc_ccm_stream_decrypt), then call tc_ccm_stream_final (or
+ *            tc_ccm_stream_verify).
  */
 
 #ifndef __TC_CCM_MODE_H__
@@ -204,6 +211,116 @@ int tc_ccm_decryption_verification(uint8_t *out, unsigned int olen,
 				   unsigned int alen, const uint8_t *payload, unsigned int plen,
 				   TCCcmMode_t c);
 
+/* struct tc_ccm_stream_struct represents an incremental CCM computation */
+typedef struct tc_ccm_stream_struct {
+	TCCcmMode_t c; /* CCM configuration: key schedule, nonce, mac length */
+	uint8_t mac[TC_AES_BLOCK_SIZE]; /* CBC-MAC chaining block */
+	uint8_t ctr[TC_AES_BLOCK_SIZE]; /* counter block of the last keystream */
+	uint8_t ks[TC_AES_BLOCK_SIZE]; /* keystream block */
+	unsigned int mac_used; /* bytes mixed into mac since it was encrypted */
+	unsigned int ks_used; /* bytes of ks already used */
+	unsigned int alen; /* associated data bytes still expected */
+	unsigned int plen; /* payload bytes still expected */
+} *TCCcmStream_t;
+
+/**
+ * @brief CCM incremental initialization procedure
+ * Starts the computation for alen bytes of associated data and plen bytes of
+ * payload; CCM authenticates the lengths first, so both must be known here.
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                c == NULL or
+ *                (alen >= TC_CCM_AAD_MAX_BYTES) or
+ *                (plen >= TC_CCM_PAYLOAD_MAX_BYTES)
+ * @param s OUT -- incremental CCM state
+ * @param c IN -- CCM state configured by tc_ccm_config; it must stay valid
+ *                until the computation ends
+ * @param alen IN -- total associated data length in bytes
+ * @param plen IN -- total payload length in bytes (without the tag)
+ */
+int tc_ccm_stream_init(TCCcmStream_t s, TCCcmMode_t c, unsigned int alen,
+		       unsigned int plen);
+
+/**
+ * @brief CCM incremental associated data procedure
+ * Authenticates the next len bytes of associated data
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                ((len > 0) and (data == NULL)) or
+ *                len is more than the associated data still expected
+ * @param s IN/OUT -- incremental CCM state
+ * @param data IN -- associated data
+ * @param len IN -- associated data length in bytes
+ */
+int tc_ccm_stream_update_aad(TCCcmStream_t s, const uint8_t *data,
+			     unsigned int len);
+
+/**
+ * @brief CCM incremental encryption procedure
+ * Encrypts and authenticates the next len bytes of payload
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                ((len > 0) and ((in == NULL) or (out == NULL))) or
+ *                associated data is still expected or
+ *                len is more than the payload still expected
+ * @param s IN/OUT -- incremental CCM state
+ * @param out OUT -- ciphertext, len bytes; may be the same buffer as in
+ * @param in IN -- plaintext
+ * @param len IN -- length in bytes
+ */
+int tc_ccm_stream_encrypt(TCCcmStream_t s, uint8_t *out, const uint8_t *in,
+			  unsigned int len);
+
+/**
+ * @brief CCM incremental decryption procedure
+ * Decrypts and authenticates the next len bytes of payload
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) under the same conditions as
+ *         tc_ccm_stream_encrypt
+ * @warning The plaintext is released before the tag is checked; it must not
+ *          be used unless tc_ccm_stream_verify succeeds.
+ * @param s IN/OUT -- incremental CCM state
+ * @param out OUT -- plaintext, len bytes; may be the same buffer as in
+ * @param in IN -- ciphertext (without the tag)
+ * @param len IN -- length in bytes
+ */
+int tc_ccm_stream_decrypt(TCCcmStream_t s, uint8_t *out, const uint8_t *in,
+			  unsigned int len);
+
+/**
+ * @brief CCM incremental tag generation procedure
+ * Writes the c->mlen bytes of the tag to tag
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                tag == NULL or
+ *                taglen < c->mlen or
+ *                associated data or payload is still expected
+ * @note s is erased before exiting
+ * @param s IN/OUT -- incremental CCM state
+ * @param tag OUT -- tag
+ * @param taglen IN -- size of the tag buffer in bytes
+ */
+int tc_ccm_stream_final(TCCcmStream_t s, uint8_t *tag, unsigned int taglen);
+
+/**
+ * @brief CCM incremental tag verification procedure
+ * Compares the computed tag with the c->mlen bytes at tag in constant time
+ * @return returns TC_CRYPTO_SUCCESS (1) if the tag is valid
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                the tag is invalid or
+ *                tc_ccm_stream_final would fail
+ * @note s is erased before exiting
+ * @param s IN/OUT -- incremental CCM state
+ * @param tag IN -- received tag
+ * @param taglen IN -- received tag length in bytes
+ */
+int tc_ccm_stream_verify(TCCcmStream_t s, const uint8_t *tag,
+			 unsigned int taglen);
+
 #ifdef __cplusplus
 }
 #endif
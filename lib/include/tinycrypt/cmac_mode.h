@@ -66,10 +66,11 @@
  *           oriented.
  *
  *           To begin a CMAC session, use tc_cmac_setup to initialize a struct
- *           tc_cmac_struct with encryption key and buffer. Our implementation
- *           always assume that the AES key to be the same size as the block
- *           cipher block size. Once setup, this data structure can be used for
- *           many CMAC computations.
+ *           tc_cmac_struct with encryption key and buffer. tc_cmac_setup
+ *           assumes the AES key to be the same size as the block cipher block
+ *           size; use tc_cmac_setup_key_size for AES-192 and AES-256 keys.
+ *           Once setup, this data structure can be used for many CMAC
+ *           computations.
  *
  *           Once the state has been setup with a key, computing the CMAC of
  *           some data requires three steps:
@@ -89,6 +90,30 @@
  *           multiple messages. A practical limit is 2^48 1K messages before you
  *           have to change the key.
  *
+ *           When many short messages are tagged under one key, the
+ *           tc_cmac_key_* functions avoid setting up and erasing the whole
+ *           state for each of them: tc_cmac_key_set expands the AES key and
+ *           derives K1 and K2 once into a struct tc_cmac_key_struct, and each
+ *           message then only needs a small struct tc_cmac_msg_struct that
+ *           tc_cmac_key_init resets and tc_cmac_key_final erases, leaving the
+ *           key object intact. tc_cmac_key_mac does all three for a message
+ *           held in one buffer.
+ *
+ *           Re-key limit (countdown): in struct tc_cmac_struct, countdown
+ *           bounds the number of tc_cmac_update calls and is reset by every
+ *           tc_cmac_init, so in practice it limits the segments of a single
+ *           message. The key object instead holds the budget for the key
+ *           itself: tc_cmac_key_set allows 2^48 messages, each
+ *           tc_cmac_key_init consumes one, and once it reaches zero
+ *           tc_cmac_key_init fails until the key is set again.
+ *
+ *           Many independent messages under the same key can be tagged in one
+ *           call with tc_cmac_mb, which advances up to TC_CMAC_MB_LANES CBC
+ *           chains side by side so that the AES engine sees a batch of blocks
+ *           at a time instead of one dependent block after another. Each
+ *           message counts as one tc_cmac_update call against the re-key
+ *           limit.
+ *
  *           Once you are done computing CMAC with a key, it is a good idea to
  *           destroy the state so an attacker cannot recover the key; use
  *           tc_cmac_erase to accomplish this.
@@ -98,6 +123,7 @@
 #define __TC_CMAC_MODE_H__
 
 #include <tinycrypt/aes.h>
+#include <tinycrypt/iovec.h>
 
 #include <stddef.h>
 
@@ -108,6 +134,9 @@ extern "C" {
 /* padding for last message block */
 #define TC_CMAC_PADDING 0x80
 
+/* number of messages tc_cmac_mb chains in parallel */
+#define TC_CMAC_MB_LANES (8)
+
 /* struct tc_cmac_struct represents the state of a CMAC computation */
 typedef struct tc_cmac_struct {
 /* initialization vector */
@@ -128,6 +157,30 @@ typedef struct tc_cmac_struct {
 	uint64_t countdown;
 } *TCCmacState_t;
 
+/* struct tc_cmac_key_struct holds what stays fixed across messages */
+typedef struct tc_cmac_key_struct {
+/* used if message length is a multiple of block_size bytes */
+	uint8_t K1[TC_AES_BLOCK_SIZE];
+/* used if message length isn't a multiple block_size bytes */
+	uint8_t K2[TC_AES_BLOCK_SIZE];
+/* AES key schedule */
+	TCAesKeySched_t sched;
+/* messages left before re-key */
+	uint64_t countdown;
+} *TCCmacKey_t;
+
+/* struct tc_cmac_msg_struct is the per-message part of a CMAC computation */
+typedef struct tc_cmac_msg_struct {
+/* chaining value */
+	uint8_t iv[TC_AES_BLOCK_SIZE];
+/* where to put bytes that didn't fill a block */
+	uint8_t leftover[TC_AES_BLOCK_SIZE];
+/* next available leftover location */
+	unsigned int leftover_offset;
+/* the key object the message is MACed under */
+	TCCmacKey_t key;
+} *TCCmacMsg_t;
+
 /**
  * @brief Configures the CMAC state to use the given AES key
  * @return returns TC_CRYPTO_SUCCESS (1) after having configured the CMAC state
@@ -142,6 +195,22 @@ typedef struct tc_cmac_struct {
 int tc_cmac_setup(TCCmacState_t s, const uint8_t *key,
 		      TCAesKeySched_t sched);
 
+/**
+ * @brief Configures the CMAC state to use the given AES key of key_size bytes
+ * @return returns TC_CRYPTO_SUCCESS (1) after having configured the CMAC state
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *              s == NULL or
+ *              key == NULL or
+ *              key_size is not an AES key size (16, 24 or 32)
+ *
+ * @param s IN/OUT -- the state to set up
+ * @param key IN -- the key to use
+ * @param key_size IN -- size of the key in bytes
+ * @param sched IN -- AES key schedule
+ */
+int tc_cmac_setup_key_size(TCCmacState_t s, const uint8_t *key,
+			   unsigned int key_size, TCAesKeySched_t sched);
+
 /**
  * @brief Erases the CMAC state
  * @return returns TC_CRYPTO_SUCCESS (1) after having configured the CMAC state
@@ -175,6 +244,22 @@ int tc_cmac_init(TCCmacState_t s);
  */
 int tc_cmac_update(TCCmacState_t s, const uint8_t *data, size_t dlen);
 
+/**
+ * @brief Same as tc_cmac_update for the concatenation of iovcnt segments;
+ * counts as one call against the state's countdown
+ * @return returns TC_CRYPTO_SUCCESS (1) after successfully updating the state
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *              s == NULL or
+ *              iov == NULL when iovcnt > 0 or
+ *              a segment base is NULL when its length is > 0
+ *
+ * @param s IN/OUT -- the CMAC state
+ * @param iov IN -- the next data segments to MAC (see iovec.h)
+ * @param iovcnt IN -- the number of segments
+ */
+int tc_cmac_updatev(TCCmacState_t s, const struct tc_iovec *iov,
+		    unsigned int iovcnt);
+
 /**
  * @brief Generates the tag from the CMAC state
  * @return returns TC_CRYPTO_SUCCESS (1) after successfully generating the tag
@@ -187,6 +272,115 @@ int tc_cmac_update(TCCmacState_t s, const uint8_t *data, size_t dlen);
  */
 int tc_cmac_final(uint8_t *tag, TCCmacState_t s);
 
+/**
+ * @brief Sets up a reusable CMAC key object
+ * Expands the AES key into sched and derives the subkeys K1 and K2.
+ * @return returns TC_CRYPTO_SUCCESS (1) after having set up the key object
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *              key == NULL or
+ *              k == NULL or
+ *              key_size is not an AES key size (16, 24 or 32)
+ *
+ * @param key OUT -- the key object to set up
+ * @param k IN -- the AES key
+ * @param key_size IN -- size of k in bytes
+ * @param sched IN -- AES key schedule, which must outlive the key object
+ */
+int tc_cmac_key_set(TCCmacKey_t key, const uint8_t *k, unsigned int key_size,
+		    TCAesKeySched_t sched);
+
+/**
+ * @brief Erases a CMAC key object
+ * Note that the AES key schedule is owned by the caller and is not erased.
+ * @return returns TC_CRYPTO_SUCCESS (1) after having erased the key object
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *              key == NULL
+ *
+ * @param key IN/OUT -- the key object to erase
+ */
+int tc_cmac_key_erase(TCCmacKey_t key);
+
+/**
+ * @brief Starts a CMAC computation under a key object
+ * Consumes one message from the key's re-key countdown.
+ * @return returns TC_CRYPTO_SUCCESS (1) after having initialized m
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *              m == NULL or
+ *              key == NULL or
+ *              no messages are left before re-key
+ *
+ * @param m OUT -- the per-message state
+ * @param key IN/OUT -- key object set by tc_cmac_key_set
+ */
+int tc_cmac_key_init(TCCmacMsg_t m, TCCmacKey_t key);
+
+/**
+ * @brief Incrementally computes CMAC over the next data segment
+ * @return returns TC_CRYPTO_SUCCESS (1) after successfully updating m
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *              m == NULL or
+ *              m was not started by tc_cmac_key_init or
+ *              data == NULL when dlen > 0
+ *
+ * @param m IN/OUT -- the per-message state
+ * @param data IN -- the next data segment to MAC
+ * @param dlen IN -- the length of data in bytes
+ */
+int tc_cmac_key_update(TCCmacMsg_t m, const uint8_t *data, size_t dlen);
+
+/**
+ * @brief Generates the tag and erases the per-message state
+ * The key object m was started from remains set up.
+ * @return returns TC_CRYPTO_SUCCESS (1) after successfully generating the tag
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *              tag == NULL or
+ *              m == NULL or
+ *              m was not started by tc_cmac_key_init
+ *
+ * @param tag OUT -- the CMAC tag
+ * @param m IN/OUT -- the per-message state
+ */
+int tc_cmac_key_final(uint8_t *tag, TCCmacMsg_t m);
+
+/**
+ * @brief Computes the CMAC tag of one buffer under a key object
+ * Same as tc_cmac_key_init, tc_cmac_key_update and tc_cmac_key_final.
+ * @return returns TC_CRYPTO_SUCCESS (1) after successfully generating the tag
+ *         returns TC_CRYPTO_FAIL (0) on the same conditions as those calls
+ *
+ * @param tag OUT -- the CMAC tag
+ * @param data IN -- the message
+ * @param dlen IN -- the length of data in bytes
+ * @param key IN/OUT -- key object set by tc_cmac_key_set
+ */
+int tc_cmac_key_mac(uint8_t *tag, const uint8_t *data, size_t dlen,
+		    TCCmacKey_t key);
+
+/**
+ * @brief Computes the CMAC tags of count independent messages
+ * Computes tag[i] = CMAC(data[i]) for i from 0 to count - 1 under the key s
+ * was set up with. The messages are processed TC_CMAC_MB_LANES at a time,
+ * with one block of each in flight per AES batch. s remains set up for
+ * further use.
+ * @return returns TC_CRYPTO_SUCCESS (1) after successfully generating the tags
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *              tag == NULL or
+ *              data == NULL or
+ *              datalen == NULL or
+ *              s == NULL or
+ *              tag[i] == NULL for some i or
+ *              data[i] == NULL when datalen[i] > 0 for some i or
+ *              fewer than count calls are left before re-key
+ *
+ * @param tag OUT -- array of count buffers of TC_AES_BLOCK_SIZE bytes
+ * @param data IN -- array of count messages to MAC
+ * @param datalen IN -- array of count message lengths
+ * @param count IN -- number of messages
+ * @param s IN/OUT -- CMAC state set up with the key
+ */
+int tc_cmac_mb(uint8_t *const *tag, const uint8_t *const *data,
+	       const size_t *datalen, unsigned int count, TCCmacState_t s);
+
 #ifdef __cplusplus
 }
 #endif
@@ -69,6 +69,7 @@
 
 #include <tinycrypt/aes.h>
 #include <tinycrypt/constants.h>
+#include <tinycrypt/iovec.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -101,6 +102,32 @@ extern "C" {
 int tc_ctr_mode(uint8_t *out, unsigned int outlen, const uint8_t *in,
 		unsigned int inlen, uint8_t *ctr, const TCAesKeySched_t sched);
 
+/**
+ *  @brief CTR mode scatter-gather procedure.
+ *  Same as tc_ctr_mode, reading the input from the incnt segments of in and
+ *  writing the output to the outcnt segments of out
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                in == NULL or
+ *                ctr == NULL or
+ *                sched == NULL or
+ *                the input is empty or
+ *                the input and output lengths differ
+ *  @note Segments may be split anywhere; the keystream carries over. An
+ *        output segment may be the input segment it replaces (in-place
+ *        operation), but output must not overlap input not yet read
+ * @param out IN -- segments receiving the ciphertext (plaintext)
+ * @param outcnt IN -- number of output segments
+ * @param in IN -- segments of the data to encrypt (or decrypt)
+ * @param incnt IN -- number of input segments
+ * @param ctr IN/OUT -- the current counter value
+ * @param sched IN -- an initialized AES key schedule
+ */
+int tc_ctr_modev(const struct tc_iovec *out, unsigned int outcnt,
+		 const struct tc_iovec *in, unsigned int incnt, uint8_t *ctr,
+		 const TCAesKeySched_t sched);
+
 #ifdef __cplusplus
 }
 #endif
@@ -51,7 +51,8 @@
  *              2) call tc_ctr_prng_reseed to mix in additional entropy into
  *              the prng context
  *
- *              3) call tc_ctr_prng_generate to output the pseudo-random data
+ *              3) call tc_ctr_prng_generate to output the pseudo-random data,
+ *              or tc_ctr_prng_generate_bulk for outputs beyond one request
  *
  *              4) call tc_ctr_prng_uninstantiate to zero out the prng context
  */
@@ -61,6 +62,8 @@
 
 #include <tinycrypt/aes.h>
 
+#include <stddef.h>
+
 #define TC_CTR_PRNG_RESEED_REQ -1
 
 #ifdef __cplusplus
@@ -151,6 +154,33 @@ int tc_ctr_prng_generate(TCCtrPrng_t * const ctx,
 			 uint8_t * const out,
 			 unsigned int outlen);
 
+/**
+ *  @brief CTR-PRNG bulk generate procedure
+ *  Generates outlen pseudo-random bytes into out buffer as a sequence of
+ *  maximum-size generate requests (65520 bytes each, within the 2^19 bit
+ *  limit of SP 800-90A), so that the state update that closes each request
+ *  is paid once per 64 KB rather than once per caller request. Each request
+ *  counts towards the reseed limit.
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CTR_PRNG_RESEED_REQ (-1) if the requests needed for
+ *             outlen bytes would pass the reseed limit; nothing is generated
+ *             returns TC_CRYPTO_FAIL (0) if:
+ *                ctx == NULL,
+ *                out == NULL
+ *  @note Assumes tc_ctr_prng_init has been called for ctx
+ *  @note additional_input is mixed into the first request only
+ *  @param ctx IN/OUT -- the PRNG context
+ *  @param additional_input IN -- additional input to the prng (may be null)
+ *  @param additionallen IN -- additional input length in bytes
+ *  @param out IN/OUT -- buffer to receive output
+ *  @param outlen IN -- size of out buffer in bytes
+ */
+int tc_ctr_prng_generate_bulk(TCCtrPrng_t * const ctx,
+			      uint8_t const * const additional_input,
+			      unsigned int additionallen,
+			      uint8_t * const out,
+			      size_t outlen);
+
 /**
  *  @brief CTR-PRNG uninstantiate procedure
  *  Zeroes the internal state of the supplied prng context
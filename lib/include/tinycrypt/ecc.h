@@ -77,8 +77,11 @@
 extern "C" {
 #endif
 
-/* Word size (4 bytes considering 32-bits architectures) */
+/* Word size: 4 bytes for 32-bit architectures, or 8 bytes (needs a compiler
+ * with unsigned __int128, such as GCC or clang on 64-bit targets): */
+#ifndef uECC_WORD_SIZE
 #define uECC_WORD_SIZE 4
+#endif
 
 /* setting max number of calls to prng: */
 #ifndef uECC_RNG_MAX_TRIES
@@ -90,6 +93,21 @@ typedef int8_t wordcount_t;
 typedef int16_t bitcount_t;
 /* defining data type for comparison result: */
 typedef int8_t cmpresult_t;
+#if uECC_WORD_SIZE == 8
+#if !defined(__SIZEOF_INT128__)
+#error "uECC_WORD_SIZE 8 needs unsigned __int128"
+#endif
+/* defining data type to store ECC coordinate/point in 64bits words: */
+typedef uint64_t uECC_word_t;
+/* defining data type to store the product of two 64bits words: */
+typedef unsigned __int128 uECC_dword_t;
+
+/* defining masks useful for ecc computations: */
+#define HIGH_BIT_SET 0x8000000000000000ull
+#define uECC_WORD_BITS 64
+#define uECC_WORD_BITS_SHIFT 6
+#define uECC_WORD_BITS_MASK 0x03F
+#elif uECC_WORD_SIZE == 4
 /* defining data type to store ECC coordinate/point in 32bits words: */
 typedef unsigned int uECC_word_t;
 /* defining data type to store an ECC coordinate/point in 64bits words: */
@@ -100,12 +118,180 @@ typedef uint64_t uECC_dword_t;
 #define uECC_WORD_BITS 32
 #define uECC_WORD_BITS_SHIFT 5
 #define uECC_WORD_BITS_MASK 0x01F
+#else
+#error "uECC_WORD_SIZE must be 4 or 8"
+#endif
 
-/* Number of words of 32 bits to represent an element of the the curve p-256: */
-#define NUM_ECC_WORDS 8
+/* Number of words to represent an element of the the curve p-256: */
+#define NUM_ECC_WORDS (32 / uECC_WORD_SIZE)
 /* Number of bytes to represent an element of the the curve p-256: */
 #define NUM_ECC_BYTES (uECC_WORD_SIZE*NUM_ECC_WORDS)
 
+/* Number of teeth of the fixed-base comb used to multiply the generator in key
+ * generation and signing: 4, 5 or 6, trading (2^teeth - 1) * 64 bytes of
+ * const table (960, 1984 or 4032 bytes) for fewer point doublings. 0 disables
+ * the comb and multiplies the generator with the Montgomery ladder. */
+#ifndef uECC_FIXED_BASE_TEETH
+#define uECC_FIXED_BASE_TEETH 0
+#endif
+
+/* Window width of the table of odd multiples of the generator used by the
+ * variable-time wNAF verification in uECC_verify: 4 to 7, i.e. 256 to 2048
+ * bytes of const table. 0 keeps Shamir's trick, which needs no table. */
+#ifndef uECC_VERIFY_WNAF_WINDOW
+#define uECC_VERIFY_WNAF_WINDOW 0
+#endif
+
+/* Window width, and resulting number of odd multiples, of the table computed
+ * for the public key in wNAF verification: */
+#define uECC_WNAF_Q_WINDOW 5
+#define uECC_WNAF_Q_POINTS (1 << (uECC_WNAF_Q_WINDOW - 2))
+
+/* Number of signatures uECC_verify_batch processes together when wNAF
+ * verification is enabled; stack use grows by about 1.3 KB per signature. */
+#ifndef uECC_VERIFY_BATCH_SIZE
+#define uECC_VERIFY_BATCH_SIZE 4
+#endif
+
+/* Set to 1 on Thumb-2 cores with UMAAL (Cortex-M4, M7, M33 with the DSP
+ * extension) to multiply, square and reduce modulo p with the constant-time
+ * kernels of ecc_arm.c instead of the generic C loops. Needs uECC_WORD_SIZE 4
+ * and GCC or clang. */
+#ifndef uECC_ARM_USE_UMAAL
+#define uECC_ARM_USE_UMAAL 0
+#endif
+
+/* Set to 1 to compile in secp256k1 (uECC_secp256k1()), with its own fast
+ * reduction modulo p = 2^256 - 2^32 - 977. The fixed-base comb and the wNAF
+ * generator table are made for NIST p-256 and are not used for it. */
+#ifndef uECC_SUPPORTS_secp256k1
+#define uECC_SUPPORTS_secp256k1 0
+#endif
+
+/* Set to 1 to specialize the ECC code for secp256r1 at compile time: the
+ * curve hooks (double_jacobian, x_side, mmod_fast, mod_sqrt) become direct
+ * calls and the word and byte counts of the curve become constants, so the
+ * compiler can unroll and inline the NUM_ECC_WORDS-word arithmetic. The API
+ * keeps its uECC_Curve arguments, which must then be uECC_secp256r1(). */
+#ifndef uECC_SINGLE_CURVE
+#define uECC_SINGLE_CURVE 0
+#endif
+
+#if uECC_SINGLE_CURVE && uECC_SUPPORTS_secp256k1
+#error "uECC_SINGLE_CURVE and uECC_SUPPORTS_secp256k1 are exclusive"
+#endif
+
+/* Scratch of the *_ws functions (uECC_make_key_ws, uECC_shared_secret_ws,
+ * uECC_sign_ws, uECC_verify_ws), in uECC_word_t so that any array of that
+ * type is suitably aligned. The large temporaries of the point arithmetic
+ * (ladder points, tables, regularized scalars) live there instead of on the
+ * stack; only the field arithmetic keeps a few hundred bytes of locals. Each
+ * operation needs at most its own count of words, and uECC_WS_WORDS covers
+ * all of them. The functions without _ws put the same area on the stack. */
+#define uECC_WS_MAX(a, b) ((a) > (b) ? (a) : (b))
+/* EccPoint_mult_ws: both ladder points and the final Z */
+#define uECC_MULT_WS_WORDS (5 * NUM_ECC_WORDS)
+/* EccPoint_mult_base_ws: the comb sum, the candidate sum and a table entry */
+#if uECC_FIXED_BASE_TEETH > 0
+#define uECC_BASE_WS_WORDS (8 * NUM_ECC_WORDS)
+#else
+#define uECC_BASE_WS_WORDS 0
+#endif
+/* EccPoint_compute_public_key_ws: the two regularized scalars and the ladder,
+ * or the comb */
+#define uECC_PUBKEY_WS_WORDS \
+	uECC_WS_MAX(2 * NUM_ECC_WORDS + uECC_MULT_WS_WORDS, uECC_BASE_WS_WORDS)
+/* Number of digits of a wNAF recoded scalar */
+#define uECC_WNAF_DIGITS (NUM_ECC_WORDS * uECC_WORD_BITS + 1)
+#if uECC_VERIFY_WNAF_WINDOW > 0
+/* EccPoint_odd_multiples_ws, per point: 2P and an inversion input and
+ * scratch word per odd multiple */
+#define uECC_ODD_MULT_WS_WORDS ((2 + 2 * uECC_WNAF_Q_POINTS) * NUM_ECC_WORDS)
+/* EccPoint_mult_double_unsafe_ws: the two digit strings, a byte per digit */
+#define uECC_WNAF_WS_WORDS \
+	((2 * uECC_WNAF_DIGITS + uECC_WORD_SIZE - 1) / uECC_WORD_SIZE)
+#endif
+
+#define uECC_MAKE_KEY_WS_WORDS \
+	(3 * NUM_ECC_WORDS + uECC_WS_MAX(2 * NUM_ECC_WORDS, uECC_PUBKEY_WS_WORDS))
+#define uECC_SHARED_SECRET_WS_WORDS (6 * NUM_ECC_WORDS + uECC_MULT_WS_WORDS)
+#define uECC_SIGN_WS_WORDS (5 * NUM_ECC_WORDS + uECC_PUBKEY_WS_WORDS)
+#if uECC_VERIFY_WNAF_WINDOW > 0
+#define uECC_VERIFY_WS_WORDS \
+	((6 + 2 * uECC_WNAF_Q_POINTS) * NUM_ECC_WORDS + \
+	 uECC_WS_MAX(uECC_ODD_MULT_WS_WORDS, \
+		     6 * NUM_ECC_WORDS + uECC_WNAF_WS_WORDS))
+#else
+#define uECC_VERIFY_WS_WORDS (14 * NUM_ECC_WORDS)
+#endif
+
+#define uECC_WS_WORDS \
+	uECC_WS_MAX(uECC_WS_MAX(uECC_MAKE_KEY_WS_WORDS, \
+				uECC_SHARED_SECRET_WS_WORDS), \
+		    uECC_WS_MAX(uECC_SIGN_WS_WORDS, uECC_VERIFY_WS_WORDS))
+#define uECC_WS_SIZE (uECC_WS_WORDS * uECC_WORD_SIZE)
+
+/* Set to 1 to count the field multiplications, squarings and inversions and
+ * the point operations of the ECC code, and to add up their cycles where a
+ * cycle counter is known (see uECC_CYCLE_COUNTER below). The totals are read
+ * with uECC_stats_get. The counters are global and not thread-safe: they are
+ * meant for profiling a single-threaded run. With 0 the hooks compile to
+ * nothing. */
+#ifndef uECC_ENABLE_STATS
+#define uECC_ENABLE_STATS 0
+#endif
+
+#if uECC_ENABLE_STATS
+/* uECC_CYCLE_COUNTER() reads a free-running cycle counter of type
+ * uECC_CYCLE_TYPE: the time stamp counter on x86, and DWT_CYCCNT on
+ * Cortex-M3/M4/M7/M33, which the application must enable first (set TRCENA
+ * in DEMCR and CYCCNTENA in DWT_CTRL). Define both to use another counter;
+ * without one only the operations are counted. */
+#if !defined(uECC_CYCLE_COUNTER)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define uECC_CYCLE_COUNTER() __builtin_ia32_rdtsc()
+#define uECC_CYCLE_TYPE uint64_t
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+      defined(__ARM_ARCH_8M_MAIN__)
+#define uECC_CYCLE_COUNTER() (*(volatile uint32_t *)0xE0001004)
+#define uECC_CYCLE_TYPE uint32_t
+#endif
+#endif
+
+/* operations counted by uECC_ENABLE_STATS: */
+enum {
+	uECC_STAT_MULT,		/* modular multiplication (mod p or n) */
+	uECC_STAT_SQUARE,	/* modular squaring mod p */
+	uECC_STAT_INV,		/* modular inversion (uECC_vli_modInv) */
+	uECC_STAT_DOUBLE,	/* Jacobian point doubling */
+	uECC_STAT_ADD,		/* co-Z addition (XYcZ_add) */
+	uECC_STAT_ADDC,		/* co-Z conjugate addition (XYcZ_addC) */
+	uECC_STAT_POINT_MULT,	/* Montgomery ladder (EccPoint_mult) */
+	uECC_STAT_NUM
+};
+
+struct uECC_stats {
+	/* number of calls of each operation */
+	uint32_t count[uECC_STAT_NUM];
+	/* cycles spent in each operation, including the operations it calls;
+	 * left at 0 for MULT and SQUARE, where reading the counter would cost
+	 * a sizable fraction of the operation, and without a cycle counter */
+	uint64_t cycles[uECC_STAT_NUM];
+};
+
+/*
+ * @brief Clears the operation counters.
+ */
+void uECC_stats_reset(void);
+
+/*
+ * @brief Copies the operation counters accumulated since the last
+ * uECC_stats_reset.
+ * @param stats OUT -- the counters
+ */
+void uECC_stats_get(struct uECC_stats *stats);
+#endif
+
 /* structure that represents an elliptic curve (e.g. p256):*/
 struct uECC_Curve_t;
 typedef const struct uECC_Curve_t * uECC_Curve;
@@ -121,6 +307,7 @@ struct uECC_Curve_t {
 	uECC_Curve curve);
   void (*x_side)(uECC_word_t *result, const uECC_word_t *x, uECC_Curve curve);
   void (*mmod_fast)(uECC_word_t *result, uECC_word_t *product);
+  void (*mod_sqrt)(uECC_word_t *a, uECC_Curve curve);
 };
 
 /*
@@ -148,11 +335,51 @@ void x_side_default(uECC_word_t *result, const uECC_word_t *x,
  * @param result OUT -- product % curve_p
  * @param product IN -- value to be reduced mod curve_p
  */
-void vli_mmod_fast_secp256r1(unsigned int *result, unsigned int *product);
+void vli_mmod_fast_secp256r1(uECC_word_t *result, uECC_word_t *product);
+
+/*
+ * @brief Computes a = sqrt(a) mod curve_p for NIST p-256, in place.
+ * @note Uses a fixed exponentiation chain (253 squarings, 7 multiplications),
+ * so its timing does not depend on a. If a is not a square the result is
+ * meaningless; callers must check that its square equals a.
+ * @param a IN/OUT -- value whose square root is computed, smaller than p
+ * @param curve IN -- elliptic curve (NIST p-256)
+ */
+void mod_sqrt_secp256r1(uECC_word_t *a, uECC_Curve curve);
+
+#if uECC_ARM_USE_UMAAL
+/*
+ * @brief Computes result = left * right for 256-bit values with UMAAL
+ * @param result OUT -- 16-word product, must not overlap left or right
+ * @param left IN -- 8-word value
+ * @param right IN -- 8-word value
+ */
+void uECC_vli_mult_umaal(uECC_word_t *result, const uECC_word_t *left,
+			 const uECC_word_t *right);
+
+/*
+ * @brief Computes result = left^2 for 256-bit values with UMAAL
+ * @param result OUT -- 16-word square, must not overlap left
+ * @param left IN -- 8-word value
+ */
+void uECC_vli_square_umaal(uECC_word_t *result, const uECC_word_t *left);
+
+/*
+ * @brief Constant-time version of vli_mmod_fast_secp256r1
+ * @param result OUT -- product % curve_p, may overlap product
+ * @param product IN -- value to be reduced mod curve_p
+ */
+void vli_mmod_fast_secp256r1_ct(uECC_word_t *result, uECC_word_t *product);
+#endif
 
 /* Bytes to words ordering: */
+#if uECC_WORD_SIZE == 8
+#define BYTES_TO_WORDS_8(a, b, c, d, e, f, g, h) 0x##h##g##f##e##d##c##b##a##ull
+#define BYTES_TO_WORDS_4(a, b, c, d) 0x##d##c##b##a##ull
+#else
 #define BYTES_TO_WORDS_8(a, b, c, d, e, f, g, h) 0x##d##c##b##a, 0x##h##g##f##e
 #define BYTES_TO_WORDS_4(a, b, c, d) 0x##d##c##b##a
+#endif
 #define BITS_TO_WORDS(num_bits) \
 	((num_bits + ((uECC_WORD_SIZE * 8) - 1)) / (uECC_WORD_SIZE * 8))
 #define BITS_TO_BYTES(num_bits) ((num_bits + 7) / 8)
@@ -189,11 +416,54 @@ static const struct uECC_Curve_t curve_secp256r1 = {
 	},
         &double_jacobian_default,
         &x_side_default,
-        &vli_mmod_fast_secp256r1
+#if uECC_ARM_USE_UMAAL
+        &vli_mmod_fast_secp256r1_ct,
+#else
+        &vli_mmod_fast_secp256r1,
+#endif
+        &mod_sqrt_secp256r1
 };
 
 uECC_Curve uECC_secp256r1(void);
 
+/* Accessors of the curve used by the ECC code; with uECC_SINGLE_CURVE they
+ * resolve to the secp256r1 constants and functions. */
+#if uECC_SINGLE_CURVE
+/* curve is still evaluated, so that parameters only used here stay used */
+#define uECC_NUM_WORDS(curve) ((void)(curve), (wordcount_t)NUM_ECC_WORDS)
+#define uECC_NUM_BYTES(curve) ((void)(curve), (wordcount_t)NUM_ECC_BYTES)
+#define uECC_NUM_N_BITS(curve) ((void)(curve), (bitcount_t)256)
+#define uECC_DOUBLE_JACOBIAN(X1, Y1, Z1, curve) \
+	double_jacobian_default(X1, Y1, Z1, curve)
+#define uECC_X_SIDE(result, x, curve) x_side_default(result, x, curve)
+#if uECC_ARM_USE_UMAAL
+#define uECC_MMOD_FAST(result, product, curve) \
+	((void)(curve), vli_mmod_fast_secp256r1_ct(result, product))
+#else
+#define uECC_MMOD_FAST(result, product, curve) \
+	((void)(curve), vli_mmod_fast_secp256r1(result, product))
+#endif
+#define uECC_MOD_SQRT(a, curve) mod_sqrt_secp256r1(a, curve)
+#else
+#define uECC_NUM_WORDS(curve) ((curve)->num_words)
+#define uECC_NUM_BYTES(curve) ((curve)->num_bytes)
+#define uECC_NUM_N_BITS(curve) ((curve)->num_n_bits)
+#define uECC_DOUBLE_JACOBIAN(X1, Y1, Z1, curve) \
+	(curve)->double_jacobian(X1, Y1, Z1, curve)
+#define uECC_X_SIDE(result, x, curve) (curve)->x_side(result, x, curve)
+#define uECC_MMOD_FAST(result, product, curve) \
+	(curve)->mmod_fast(result, product)
+#define uECC_MOD_SQRT(a, curve) (curve)->mod_sqrt(a, curve)
+#endif
+
+#if uECC_SUPPORTS_secp256k1
+/*
+ * @brief The curve secp256k1 (SEC 2), y^2 = x^3 + 7.
+ * @return the curve, for every function taking a uECC_Curve
+ */
+uECC_Curve uECC_secp256k1(void);
+#endif
+
 /*
  * @brief Generates a random integer in the range 0 < random < top.
  * Both random and top have num_words words.
@@ -242,6 +512,35 @@ void uECC_set_rng(uECC_RNG_Function rng_function);
  */
 uECC_RNG_Function uECC_get_rng(void);
 
+/* uECC_RNG_Ctx_Function type
+ * Same as uECC_RNG_Function, with a caller-supplied context (for instance a
+ * TCCtrPrng_t or TCHmacPrng_t owned by one thread). The *_with_rng functions
+ * take one of these with its context instead of using the function set with
+ * uECC_set_rng(), so concurrent callers need not share an RNG. Passing a null
+ * function to them means no RNG, like uECC_set_rng(0).
+ */
+typedef int(*uECC_RNG_Ctx_Function)(void *ctx, uint8_t *dest,
+				     unsigned int size);
+
+/*
+ * @brief uECC_RNG_Ctx_Function calling the function set with uECC_set_rng().
+ * @param ctx IN -- unused
+ * @param dest OUT -- buffer to fill with random bytes
+ * @param size IN -- number of bytes
+ * @return the result of the function set with uECC_set_rng(), or 0 if none
+ */
+int uECC_global_rng(void *ctx, uint8_t *dest, unsigned int size);
+
+/*
+ * @brief Same as uECC_generate_random_int, drawing from rng.
+ * @param rng IN -- RNG function, or 0 to fail
+ * @param rng_ctx IN -- context passed to rng
+ */
+int uECC_generate_random_int_with_rng(uECC_word_t *random,
+				      const uECC_word_t *top,
+				      wordcount_t num_words,
+				      uECC_RNG_Ctx_Function rng, void *rng_ctx);
+
 /*
  * @brief computes the size of a private key for the curve in bytes.
  * @param curve IN -- elliptic curve
@@ -266,6 +565,33 @@ int uECC_curve_public_key_size(uECC_Curve curve);
 int uECC_compute_public_key(const uint8_t *private_key,
 			    uint8_t *public_key, uECC_Curve curve);
 
+/*
+ * @brief Compress a public key.
+ * @param public_key IN -- The public key to compress (2 * num_bytes bytes)
+ * @param compressed OUT -- Will be filled in with the compressed public key:
+ * 0x02 or 0x03 for an even or odd y, followed by x (num_bytes + 1 bytes, 33
+ * for NIST p-256)
+ * @param curve IN -- elliptic curve
+ * @note public_key is not validated; compress only keys that are.
+ */
+void uECC_compress(const uint8_t *public_key, uint8_t *compressed,
+		   uECC_Curve curve);
+
+/*
+ * @brief Decompress a compressed public key.
+ * @param compressed IN -- The compressed public key (num_bytes + 1 bytes)
+ * @param public_key OUT -- Will be filled in with the uncompressed public key
+ * (2 * num_bytes bytes)
+ * @param curve IN -- elliptic curve
+ * @return Returns 1 if the key was decompressed, 0 if the prefix is not 0x02
+ * or 0x03, x is not smaller than p, or x is not the x coordinate of a point
+ * on the curve. public_key is left untouched on error.
+ * @note A decompressed key is a point on the curve, but uECC_valid_public_key
+ * may still reject it (e.g. if it is the generator).
+ */
+int uECC_decompress(const uint8_t *compressed, uint8_t *public_key,
+		    uECC_Curve curve);
+
 /*
  * @brief Compute public-key.
  * @return corresponding public-key.
@@ -276,6 +602,14 @@ int uECC_compute_public_key(const uint8_t *private_key,
 uECC_word_t EccPoint_compute_public_key(uECC_word_t *result,
 					uECC_word_t *private_key, uECC_Curve curve);
 
+/*
+ * @brief Same as EccPoint_compute_public_key, with its temporaries in ws.
+ * @param ws IN/OUT -- scratch of uECC_PUBKEY_WS_WORDS words
+ */
+uECC_word_t EccPoint_compute_public_key_ws(uECC_word_t *result,
+					   uECC_word_t *private_key,
+					   uECC_Curve curve, uECC_word_t *ws);
+
 /*
  * @brief Regularize the bitcount for the private key so that attackers cannot
  * use a side channel attack to learn the number of leading zeros.
@@ -303,6 +637,99 @@ void EccPoint_mult(uECC_word_t * result, const uECC_word_t * point,
 		   const uECC_word_t * scalar, const uECC_word_t * initial_Z,
 		   bitcount_t num_bits, uECC_Curve curve);
 
+/*
+ * @brief Same as EccPoint_mult, with the ladder points in ws.
+ * @param ws IN/OUT -- scratch of uECC_MULT_WS_WORDS words
+ */
+void EccPoint_mult_ws(uECC_word_t * result, const uECC_word_t * point,
+		      const uECC_word_t * scalar, const uECC_word_t * initial_Z,
+		      bitcount_t num_bits, uECC_Curve curve, uECC_word_t *ws);
+
+#if defined(TINYCRYPT_ACCEL)
+/*
+ * @brief Multiplication of a secp256r1 point by a scalar on the registered
+ * accelerator driver (see accel.h).
+ * @return 1 if the driver computed a valid point, 0 if the software must do
+ * the multiplication
+ * @param result OUT -- returns scalar*point in affine coordinates
+ * @param point IN -- elliptic curve point, or NULL for the generator
+ * @param scalar IN -- scalar, 0 < scalar < n
+ * @param curve IN -- elliptic curve
+ */
+int EccPoint_mult_accel(uECC_word_t *result, const uECC_word_t *point,
+			const uECC_word_t *scalar, uECC_Curve curve);
+#endif
+
+#if uECC_FIXED_BASE_TEETH > 0
+/*
+ * @brief Constant-time multiplication of the curve generator by a scalar,
+ * using a comb over a precomputed table of multiples of G.
+ * @param result OUT -- returns scalar*G in affine coordinates
+ * @param scalar IN -- scalar, at most 256 bits
+ * @param curve IN -- elliptic curve (secp256r1)
+ */
+void EccPoint_mult_base(uECC_word_t *result, const uECC_word_t *scalar,
+			uECC_Curve curve);
+
+/*
+ * @brief Same as EccPoint_mult_base, with its temporaries in ws.
+ * @param ws IN/OUT -- scratch of uECC_BASE_WS_WORDS words
+ */
+void EccPoint_mult_base_ws(uECC_word_t *result, const uECC_word_t *scalar,
+			   uECC_Curve curve, uECC_word_t *ws);
+#endif
+
+#if uECC_VERIFY_WNAF_WINDOW > 0
+/*
+ * @brief Computes the odd multiples P, 3P, ..., (2 * uECC_WNAF_Q_POINTS - 1)P
+ * of count points, in affine coordinates, for EccPoint_mult_double_unsafe.
+ * Two modular inversions are shared by all the points.
+ * @note Not constant-time; use only with public points.
+ * @param tables OUT -- count tables of uECC_WNAF_Q_POINTS points of
+ * 2 * NUM_ECC_WORDS words each
+ * @param points IN -- count elliptic curve points P of 2 * NUM_ECC_WORDS words
+ * @param count IN -- number of points, 1 to uECC_VERIFY_BATCH_SIZE
+ * @param curve IN -- elliptic curve
+ */
+void EccPoint_odd_multiples(uECC_word_t *tables, const uECC_word_t *points,
+			    unsigned int count, uECC_Curve curve);
+
+/*
+ * @brief Same as EccPoint_odd_multiples, with its temporaries in ws.
+ * @param ws IN/OUT -- scratch of count * uECC_ODD_MULT_WS_WORDS words
+ */
+void EccPoint_odd_multiples_ws(uECC_word_t *tables, const uECC_word_t *points,
+			       unsigned int count, uECC_Curve curve,
+			       uECC_word_t *ws);
+
+/*
+ * @brief Computes u1*G + u2*Q with interleaved wNAF, using a precomputed table
+ * for the generator G and the odd multiples of Q made by
+ * EccPoint_odd_multiples.
+ * @note Not constant-time; use only with public scalars and points.
+ * @param X OUT -- x coordinate of the result, Jacobian
+ * @param Y OUT -- y coordinate of the result, Jacobian
+ * @param Z OUT -- z coordinate of the result, 0 for the point at infinity
+ * @param u1 IN -- scalar multiplying G, at most 256 bits
+ * @param u2 IN -- scalar multiplying Q, at most 256 bits
+ * @param table IN -- odd multiples of Q
+ * @param curve IN -- elliptic curve (secp256r1)
+ */
+void EccPoint_mult_double_unsafe(uECC_word_t *X, uECC_word_t *Y, uECC_word_t *Z,
+				 const uECC_word_t *u1, const uECC_word_t *u2,
+				 const uECC_word_t *table, uECC_Curve curve);
+
+/*
+ * @brief Same as EccPoint_mult_double_unsafe, with the recoded scalars in ws.
+ * @param ws IN/OUT -- scratch of uECC_WNAF_WS_WORDS words
+ */
+void EccPoint_mult_double_unsafe_ws(uECC_word_t *X, uECC_word_t *Y,
+				    uECC_word_t *Z, const uECC_word_t *u1,
+				    const uECC_word_t *u2,
+				    const uECC_word_t *table, uECC_Curve curve,
+				    uECC_word_t *ws);
+#endif
+
 /*
  * @brief Constant-time comparison to zero - secure way to compare long integers
  * @param vli IN -- very long integer
@@ -408,6 +835,15 @@ void uECC_vli_mmod(uECC_word_t *result, uECC_word_t *product,
 void uECC_vli_modMult_fast(uECC_word_t *result, const uECC_word_t *left,
 			   const uECC_word_t *right, uECC_Curve curve);
 
+/*
+ * @brief Computes modular square (using curve->mmod_fast)
+ * @param result OUT -- left^2 mod % curve_p
+ * @param left IN -- term to be squared
+ * @param curve IN -- elliptic curve
+ */
+void uECC_vli_modSquare_fast(uECC_word_t *result, const uECC_word_t *left,
+			     uECC_Curve curve);
+
 /*
  * @brief Computes result = left - right.
  * @note Can modify in place.
@@ -443,9 +879,11 @@ void uECC_vli_modMult(uECC_word_t *result, const uECC_word_t *left,
 	              wordcount_t num_words);
 
 /*
- * @brief Computes (1 / input) % mod
- * @note All VLIs are the same size.
- * @note See "Euclid's GCD to Montgomery Multiplication to the Great Divide"
+ * @brief Computes (1 / input) % mod in constant time
+ * @note All VLIs are the same size; mod must be odd and at most 256 bits,
+ * and input below mod. An input of 0 gives 0.
+ * @note See Bernstein and Yang, "Fast constant-time gcd computation and
+ * modular inversion"
  * @param result OUT -- (1 / input) % mod
  * @param input IN -- value to be modular inverted
  * @param mod IN -- mod
@@ -454,6 +892,21 @@ void uECC_vli_modMult(uECC_word_t *result, const uECC_word_t *left,
 void uECC_vli_modInv(uECC_word_t *result, const uECC_word_t *input,
 		     const uECC_word_t *mod, wordcount_t num_words);
 
+/*
+ * @brief Replaces each of count values with (1 / value) % mod, using a single
+ * modular inversion (Montgomery's simultaneous inversion). Zero values are
+ * left as they are and do not affect the others.
+ * @note Not constant-time; use only with public values.
+ * @param values IN/OUT -- count values of curve->num_words words each
+ * @param scratch -- room for count values
+ * @param count IN -- number of values
+ * @param mod IN -- curve->p or curve->n
+ * @param curve IN -- elliptic curve
+ */
+void uECC_vli_modInv_batch(uECC_word_t *values, uECC_word_t *scratch,
+			   unsigned int count, const uECC_word_t *mod,
+			   uECC_Curve curve);
+
 /*
  * @brief Sets dest = src.
  * @param dest OUT -- destination buffer
@@ -527,7 +980,7 @@ int uECC_valid_public_key(const uint8_t *public_key, uECC_Curve curve);
   * @param native IN -- uECC native representation
   */
 void uECC_vli_nativeToBytes(uint8_t *bytes, int num_bytes,
-    			    const unsigned int *native);
+    			    const uECC_word_t *native);
 
 /*
  * @brief Converts big-endian bytes to an integer in uECC native format.
@@ -535,7 +988,7 @@ void uECC_vli_nativeToBytes(uint8_t *bytes, int num_bytes,
  * @param bytes IN -- bytes representation
  * @param num_bytes IN -- number of bytes
  */
-void uECC_vli_bytesToNative(unsigned int *native, const uint8_t *bytes,
+void uECC_vli_bytesToNative(uECC_word_t *native, const uint8_t *bytes,
 			    int num_bytes);
 
 #ifdef __cplusplus
@@ -70,6 +70,7 @@
 #define __TC_ECC_DH_H__
 
 #include <tinycrypt/ecc.h>
+#include <tinycrypt/hmac_prng.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -93,6 +94,25 @@ extern "C" {
  */
 int uECC_make_key(uint8_t *p_public_key, uint8_t *p_private_key, uECC_Curve curve);
 
+/**
+ * @brief Same as uECC_make_key(), drawing random bytes from rng.
+ * @param rng IN -- RNG function (see uECC_RNG_Ctx_Function)
+ * @param rng_ctx IN -- context passed to rng
+ */
+int uECC_make_key_with_rng(uint8_t *p_public_key, uint8_t *p_private_key,
+			   uECC_Curve curve, uECC_RNG_Ctx_Function rng,
+			   void *rng_ctx);
+
+/**
+ * @brief Same as uECC_make_key(), with its temporaries in a caller-owned
+ * scratch area instead of on the stack.
+ * @param ws IN/OUT -- scratch of uECC_MAKE_KEY_WS_WORDS (or uECC_WS_WORDS)
+ * words; it is cleared before returning, and may be reused by any other
+ * *_ws call that does not run at the same time.
+ */
+int uECC_make_key_ws(uint8_t *p_public_key, uint8_t *p_private_key,
+		     uECC_Curve curve, uECC_word_t *ws);
+
 #ifdef ENABLE_TESTS
 
 /**
@@ -102,7 +122,7 @@ int uECC_make_key(uint8_t *p_public_key, uint8_t *p_private_key, uECC_Curve curv
  * uECC_make_key() function for real applications.
  */
 int uECC_make_key_with_d(uint8_t *p_public_key, uint8_t *p_private_key,
-    			 unsigned int *d, uECC_Curve curve);
+    			 uECC_word_t *d, uECC_Curve curve);
 #endif
 
 /**
@@ -124,6 +144,97 @@ int uECC_make_key_with_d(uint8_t *p_public_key, uint8_t *p_private_key,
 int uECC_shared_secret(const uint8_t *p_public_key, const uint8_t *p_private_key,
 		       uint8_t *p_secret, uECC_Curve curve);
 
+/**
+ * @brief Same as uECC_shared_secret(), drawing the random initial Z from rng.
+ * @param rng IN -- RNG function (see uECC_RNG_Ctx_Function), or 0 for none
+ * @param rng_ctx IN -- context passed to rng
+ */
+int uECC_shared_secret_with_rng(const uint8_t *p_public_key,
+				const uint8_t *p_private_key, uint8_t *p_secret,
+				uECC_Curve curve, uECC_RNG_Ctx_Function rng,
+				void *rng_ctx);
+
+/**
+ * @brief Same as uECC_shared_secret(), with its temporaries in a caller-owned
+ * scratch area instead of on the stack.
+ * @param ws IN/OUT -- scratch of uECC_SHARED_SECRET_WS_WORDS (or
+ * uECC_WS_WORDS) words; it is cleared before returning.
+ */
+int uECC_shared_secret_ws(const uint8_t *p_public_key,
+			  const uint8_t *p_private_key, uint8_t *p_secret,
+			  uECC_Curve curve, uECC_word_t *ws);
+
+/* Number of random Z candidates an EC-DH context draws from its DRBG at
+ * once, which spreads the cost of the DRBG's state update: */
+#ifndef uECC_DH_CTX_Z_POOL
+#define uECC_DH_CTX_Z_POOL 8
+#endif
+
+/* EC-DH context for repeated key agreement with the same remote party: */
+struct uECC_dh_ctx_t {
+	/* the validated public key of the remote party, in native words */
+	uECC_word_t peer[2 * NUM_ECC_WORDS];
+	/* DRBG supplying the random initial Z of each point multiplication */
+	struct tc_hmac_prng_struct z_prng;
+	/* Z candidates drawn from z_prng and not used yet */
+	uECC_word_t z_pool[uECC_DH_CTX_Z_POOL][NUM_ECC_WORDS];
+	unsigned int z_left;
+	/* whether z_prng is seeded; without an RNG, Z is not randomized */
+	int z_seeded;
+	uECC_Curve curve;
+	/* RNG seeding z_prng, with its context */
+	uECC_RNG_Ctx_Function rng;
+	void *rng_ctx;
+};
+
+typedef struct uECC_dh_ctx_t *uECC_DhCtx;
+
+/**
+ * @brief Validate a remote public key once and set up ctx for
+ * uECC_dh_ctx_shared_secret().
+ * @return returns TC_CRYPTO_SUCCESS (1) if ctx was set up successfully
+ *         returns TC_CRYPTO_FAIL (0) if the public key is invalid or the Z
+ *         randomization DRBG could not be seeded
+ *
+ * @param ctx OUT -- context to set up
+ * @param p_public_key IN -- The public key of the remote party.
+ * @param curve IN -- elliptic curve
+ *
+ * @note If an RNG is set (uECC_set_rng()), 32 bytes are drawn from it to seed
+ * an HMAC-DRBG, which then supplies the random Z values instead of the RNG.
+ */
+int uECC_dh_ctx_init(uECC_DhCtx ctx, const uint8_t *p_public_key,
+		     uECC_Curve curve);
+
+/**
+ * @brief Same as uECC_dh_ctx_init(), seeding (and later reseeding) the DRBG
+ * from rng, which must stay usable as long as ctx is.
+ * @param rng IN -- RNG function (see uECC_RNG_Ctx_Function), or 0 for none
+ * @param rng_ctx IN -- context passed to rng
+ */
+int uECC_dh_ctx_init_with_rng(uECC_DhCtx ctx, const uint8_t *p_public_key,
+			      uECC_Curve curve, uECC_RNG_Ctx_Function rng,
+			      void *rng_ctx);
+
+/**
+ * @brief Compute a shared secret with the remote party of ctx; same result as
+ * uECC_shared_secret() without revalidating or converting the public key.
+ * @return returns TC_CRYPTO_SUCCESS (1) if the shared secret was computed successfully
+ *         returns TC_CRYPTO_FAIL (0) otherwise
+ *
+ * @param ctx IN/OUT -- context set up by uECC_dh_ctx_init()
+ * @param p_private_key IN -- Your private key.
+ * @param p_secret OUT -- Will be filled in with the shared secret value.
+ */
+int uECC_dh_ctx_shared_secret(uECC_DhCtx ctx, const uint8_t *p_private_key,
+			      uint8_t *p_secret);
+
+/**
+ * @brief Erase ctx.
+ * @param ctx IN/OUT -- context to erase
+ */
+void uECC_dh_ctx_clear(uECC_DhCtx ctx);
+
 #ifdef __cplusplus
 }
 #endif
@@ -105,6 +105,38 @@ extern "C" {
 int uECC_sign(const uint8_t *p_private_key, const uint8_t *p_message_hash,
 	      unsigned p_hash_size, uint8_t *p_signature, uECC_Curve curve);
 
+/**
+ * @brief Same as uECC_sign(), drawing random bytes from rng.
+ * @param rng IN -- RNG function (see uECC_RNG_Ctx_Function)
+ * @param rng_ctx IN -- context passed to rng
+ */
+int uECC_sign_with_rng(const uint8_t *p_private_key,
+		       const uint8_t *p_message_hash, unsigned p_hash_size,
+		       uint8_t *p_signature, uECC_Curve curve,
+		       uECC_RNG_Ctx_Function rng, void *rng_ctx);
+
+/**
+ * @brief Same as uECC_sign(), with its temporaries in a caller-owned scratch
+ * area instead of on the stack.
+ * @param ws IN/OUT -- scratch of uECC_SIGN_WS_WORDS (or uECC_WS_WORDS) words;
+ * it is cleared before returning.
+ */
+int uECC_sign_ws(const uint8_t *p_private_key, const uint8_t *p_message_hash,
+		 unsigned p_hash_size, uint8_t *p_signature, uECC_Curve curve,
+		 uECC_word_t *ws);
+
+/**
+ * @brief Same as uECC_sign(), with k derived from the private key and hash
+ * as in RFC 6979 (HMAC-SHA256 DRBG) instead of drawn from an RNG.
+ * @note Signing the same hash with the same key always gives the same
+ * signature, and no RNG need be set. The inversion of k is still blinded,
+ * with a number from a second generator seeded the same way.
+ */
+int uECC_sign_deterministic(const uint8_t *p_private_key,
+			    const uint8_t *p_message_hash,
+			    unsigned p_hash_size, uint8_t *p_signature,
+			    uECC_Curve curve);
+
 #ifdef ENABLE_TESTS
 /*
  * THIS FUNCTION SHOULD BE CALLED FOR TEST PURPOSES ONLY.
@@ -132,6 +164,92 @@ int uECC_sign_with_k(const uint8_t *private_key, const uint8_t *message_hash,
 int uECC_verify(const uint8_t *p_public_key, const uint8_t *p_message_hash,
 		unsigned int p_hash_size, const uint8_t *p_signature, uECC_Curve curve);
 
+/**
+ * @brief Same as uECC_verify(), with its temporaries in a caller-owned
+ * scratch area instead of on the stack.
+ * @param ws IN/OUT -- scratch of uECC_VERIFY_WS_WORDS (or uECC_WS_WORDS)
+ * words. Only public values are left in it.
+ */
+int uECC_verify_ws(const uint8_t *p_public_key, const uint8_t *p_message_hash,
+		   unsigned int p_hash_size, const uint8_t *p_signature,
+		   uECC_Curve curve, uECC_word_t *ws);
+
+/**
+ * @brief Verify several ECDSA signatures at once.
+ * @return returns TC_CRYPTO_SUCCESS (1) if all signatures are valid
+ *         returns TC_CRYPTO_FAIL (0) if any signature is invalid.
+ *
+ * @param p_public_keys IN -- The signers' public keys, one per signature.
+ * @param p_message_hashes IN -- The hashes of the signed data.
+ * @param p_hash_size IN -- The size of each message hash in bytes.
+ * @param p_signatures IN -- The signature values.
+ * @param p_count IN -- The number of signatures.
+ * @param p_results OUT -- p_count entries, each set to what uECC_verify would
+ * return for that signature.
+ *
+ * @note With wNAF verification enabled (uECC_VERIFY_WNAF_WINDOW), signatures
+ * are handled in groups of uECC_VERIFY_BATCH_SIZE that share one modular
+ * inversion for the 1/s values and two for the public-key tables. Otherwise
+ * this calls uECC_verify for each signature.
+ */
+int uECC_verify_batch(const uint8_t *const *p_public_keys,
+		      const uint8_t *const *p_message_hashes,
+		      unsigned int p_hash_size,
+		      const uint8_t *const *p_signatures, unsigned int p_count,
+		      int *p_results, uECC_Curve curve);
+
+/* Signer's public key prepared for repeated verification: */
+struct uECC_verify_key_t {
+	/* the validated public key, in native words */
+	uECC_word_t q[2 * NUM_ECC_WORDS];
+#if uECC_VERIFY_WNAF_WINDOW > 0
+	/* odd multiples q, 3q, 5q, ..., in affine coordinates */
+	uECC_word_t table[uECC_WNAF_Q_POINTS][2 * NUM_ECC_WORDS];
+#else
+	/* i*G + j*q at [i + 4j - 1] for 0 <= i, j <= 3, in affine coordinates,
+	 * for Shamir's trick on 2-bit windows */
+	uECC_word_t table[15][2 * NUM_ECC_WORDS];
+#endif
+	uECC_Curve curve;
+};
+
+typedef struct uECC_verify_key_t *uECC_VerifyKey;
+
+/**
+ * @brief Validate a signer's public key once and precompute what
+ * uECC_verify() would recompute for it on every call.
+ * @return returns TC_CRYPTO_SUCCESS (1) if key was set up successfully
+ *         returns TC_CRYPTO_FAIL (0) if uECC_valid_public_key() rejects the
+ *         public key
+ *
+ * @param key OUT -- prepared key to set up
+ * @param p_public_key IN -- The signer's public key.
+ * @param curve IN -- elliptic curve
+ *
+ * @note key holds 15 points (1 KB with Q), the small combinations of G and Q
+ * that let uECC_verify_prepared() take 2-bit windows in Shamir's trick, or,
+ * with wNAF verification enabled, the uECC_WNAF_Q_POINTS odd multiples of Q
+ * (576 bytes with Q). Without wNAF, keys equal to +-(i/j)G for i, j in 1..3
+ * are refused as well. key holds no secret and need not be erased.
+ */
+int uECC_verify_key_init(uECC_VerifyKey key, const uint8_t *p_public_key,
+			 uECC_Curve curve);
+
+/**
+ * @brief Verify an ECDSA signature against a prepared public key; same result
+ * as uECC_verify() without converting the key or rebuilding its table.
+ * @return returns TC_CRYPTO_SUCCESS (1) if the signature is valid
+ *         returns TC_CRYPTO_FAIL (0) if the signature is invalid.
+ *
+ * @param key IN -- prepared key set up by uECC_verify_key_init()
+ * @param p_message_hash IN -- The hash of the signed data.
+ * @param p_hash_size IN -- The size of p_message_hash in bytes.
+ * @param p_signature IN -- The signature values.
+ */
+int uECC_verify_prepared(const struct uECC_verify_key_t *key,
+			 const uint8_t *p_message_hash, unsigned int p_hash_size,
+			 const uint8_t *p_signature);
+
 #ifdef __cplusplus
 }
 #endif
@@ -76,6 +76,25 @@
 */
 #define default_RNG_defined 1
 
+/*
+ * On POSIX systems default_CSPRNG reads from getrandom() where available
+ * (Linux with glibc 2.25 or later), otherwise from a /dev/urandom descriptor
+ * that is opened once and kept open.
+ *
+ * Setting uECC_CSPRNG_CTR_DRBG to 1 instead serves requests from a CTR-DRBG
+ * per thread, seeded from the operating system on first use and again after
+ * fork(); requests of up to uECC_CSPRNG_BUFFER_SIZE bytes come out of a buffer
+ * of its output. This needs ctr_prng and AES to be linked in, and pays off
+ * when AES is fast (TINYCRYPT_AES_HW) or the operating system RNG is slow.
+ */
+#ifndef uECC_CSPRNG_CTR_DRBG
+#define uECC_CSPRNG_CTR_DRBG 0
+#endif
+
+#ifndef uECC_CSPRNG_BUFFER_SIZE
+#define uECC_CSPRNG_BUFFER_SIZE 256
+#endif
+
 int default_CSPRNG(uint8_t *dest, unsigned int size);
 
 #endif /* __UECC_PLATFORM_SPECIFIC_H_ */
@@ -0,0 +1,198 @@
+/* etm_mode.h - TinyCrypt interface to encrypt-then-MAC composite modes */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to one-pass encrypt-then-MAC compositions.
+ *
+ *  Overview: Encrypting a buffer with CTR (or CBC) and then MACing the
+ *            ciphertext with HMAC-SHA256 (or CMAC) reads the whole buffer
+ *            twice; on records larger than the data cache the second pass
+ *            has to fetch it from memory again. These functions instead
+ *            encrypt TINYCRYPT_ETM_CHUNK_SIZE bytes at a time and MAC each
+ *            chunk while it is still in cache. Decryption MACs each chunk of
+ *            ciphertext before deciphering it, and checks the tag at the end.
+ *
+ *            The output is exactly that of the two separate passes: the tag
+ *            is HMAC-SHA256(initial counter block || ciphertext) for CTR and
+ *            CMAC(iv || ciphertext) for CBC, so the counter or iv is
+ *            authenticated along with the ciphertext.
+ *
+ *  Security: The cipher and MAC keys must be independent. Since the tag is
+ *            only known after the last chunk, decryption writes plaintext
+ *            before the tag is checked; when it does not match, the whole
+ *            output is zeroed before returning TC_CRYPTO_FAIL. Callers must
+ *            not use any output of a failed decryption.
+ *
+ *            Every message encrypted under a key needs a fresh counter (CTR)
+ *            or a random iv (CBC).
+ *
+ *  Requires: AES-128, CTR or CBC, and HMAC-SHA256 or AES-CMAC
+ *
+ *  Usage:    1) set up the AES key schedule and the MAC key object
+ *            (tc_hmac_key_set or tc_cmac_key_set)
+ *
+ *            2) call tc_etm_ctr_hmac_encrypt (or tc_etm_cbc_cmac_encrypt) to
+ *            encrypt and compute the tag
+ *
+ *            3) call tc_etm_ctr_hmac_decrypt (or tc_etm_cbc_cmac_decrypt) to
+ *            verify the tag and decrypt
+ */
+
+#ifndef __TC_ETM_MODE_H__
+#define __TC_ETM_MODE_H__
+
+#include <tinycrypt/aes.h>
+#include <tinycrypt/hmac.h>
+#include <tinycrypt/cmac_mode.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* tag sizes in bytes */
+#define TC_ETM_HMAC_TAG_SIZE TC_SHA256_DIGEST_SIZE
+#define TC_ETM_CMAC_TAG_SIZE TC_AES_BLOCK_SIZE
+
+/**
+ *  @brief CTR encryption with an HMAC-SHA256 tag over the ciphertext
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                in == NULL or
+ *                ctr == NULL or
+ *                sched == NULL or
+ *                mac_key == NULL or
+ *                tag == NULL or
+ *                inlen == 0 or
+ *                outlen != inlen
+ *  @note out may be equal to in. ctr is advanced as by tc_ctr_mode.
+ *  @param out OUT -- ciphertext
+ *  @param outlen IN -- length of out in bytes
+ *  @param in IN -- plaintext
+ *  @param inlen IN -- length of in in bytes
+ *  @param ctr IN/OUT -- the current counter value
+ *  @param sched IN -- AES encryption key schedule
+ *  @param mac_key IN -- HMAC key state set by tc_hmac_key_set
+ *  @param tag OUT -- TC_ETM_HMAC_TAG_SIZE bytes
+ */
+int tc_etm_ctr_hmac_encrypt(uint8_t *out, unsigned int outlen,
+			    const uint8_t *in, unsigned int inlen,
+			    uint8_t *ctr, const TCAesKeySched_t sched,
+			    const struct tc_hmac_key_struct *mac_key,
+			    uint8_t *tag);
+
+/**
+ *  @brief Verifies the HMAC-SHA256 tag of a CTR ciphertext and decrypts it
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                an argument is invalid as for tc_etm_ctr_hmac_encrypt or
+ *                the tag does not match, in which case out is zeroed
+ *  @note out may be equal to in
+ *  @param out OUT -- plaintext
+ *  @param outlen IN -- length of out in bytes
+ *  @param in IN -- ciphertext
+ *  @param inlen IN -- length of in in bytes
+ *  @param ctr IN/OUT -- the counter value the message was encrypted with
+ *  @param sched IN -- AES encryption key schedule
+ *  @param mac_key IN -- HMAC key state set by tc_hmac_key_set
+ *  @param tag IN -- TC_ETM_HMAC_TAG_SIZE bytes
+ */
+int tc_etm_ctr_hmac_decrypt(uint8_t *out, unsigned int outlen,
+			    const uint8_t *in, unsigned int inlen,
+			    uint8_t *ctr, const TCAesKeySched_t sched,
+			    const struct tc_hmac_key_struct *mac_key,
+			    const uint8_t *tag);
+
+/**
+ *  @brief CBC encryption with a CMAC tag over iv and ciphertext
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                in == NULL or
+ *                iv == NULL or
+ *                sched == NULL or
+ *                mac_key == NULL or
+ *                tag == NULL or
+ *                inlen == 0 or
+ *                (inlen % TC_AES_BLOCK_SIZE) != 0 or
+ *                outlen != inlen + TC_AES_BLOCK_SIZE or
+ *                the CMAC key has no messages left before re-key
+ *  @note out receives iv then the ciphertext, as with tc_cbc_mode_encrypt
+ *  @param out OUT -- iv and ciphertext
+ *  @param outlen IN -- length of out in bytes
+ *  @param in IN -- plaintext
+ *  @param inlen IN -- length of in in bytes
+ *  @param iv IN -- a 16 byte random iv
+ *  @param sched IN -- AES encryption key schedule
+ *  @param mac_key IN/OUT -- CMAC key object set by tc_cmac_key_set
+ *  @param tag OUT -- TC_ETM_CMAC_TAG_SIZE bytes
+ */
+int tc_etm_cbc_cmac_encrypt(uint8_t *out, unsigned int outlen,
+			    const uint8_t *in, unsigned int inlen,
+			    const uint8_t *iv, const TCAesKeySched_t sched,
+			    TCCmacKey_t mac_key, uint8_t *tag);
+
+/**
+ *  @brief Verifies the CMAC tag of a CBC ciphertext and decrypts it
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                in == NULL or
+ *                sched == NULL or
+ *                mac_key == NULL or
+ *                tag == NULL or
+ *                inlen < 2 * TC_AES_BLOCK_SIZE or
+ *                (inlen % TC_AES_BLOCK_SIZE) != 0 or
+ *                outlen != inlen - TC_AES_BLOCK_SIZE or
+ *                the CMAC key has no messages left before re-key or
+ *                the tag does not match, in which case out is zeroed
+ *  @note in is iv followed by the ciphertext, as written by
+ *        tc_etm_cbc_cmac_encrypt; out may be equal to in
+ *  @param out OUT -- plaintext
+ *  @param outlen IN -- length of out in bytes
+ *  @param in IN -- iv and ciphertext
+ *  @param inlen IN -- length of in in bytes
+ *  @param sched IN -- AES decryption key schedule
+ *  @param mac_key IN/OUT -- CMAC key object set by tc_cmac_key_set
+ *  @param tag IN -- TC_ETM_CMAC_TAG_SIZE bytes
+ */
+int tc_etm_cbc_cmac_decrypt(uint8_t *out, unsigned int outlen,
+			    const uint8_t *in, unsigned int inlen,
+			    const TCAesKeySched_t sched, TCCmacKey_t mac_key,
+			    const uint8_t *tag);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_ETM_MODE_H__ */
@@ -0,0 +1,173 @@
+/* gcm_mode.h - TinyCrypt interface to a GCM mode implementation */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to a GCM mode implementation.
+ *
+ *  Overview: GCM (for "Galois/Counter Mode") is a NIST approved mode of
+ *            operation defined in SP 800-38D. It encrypts the payload in CTR
+ *            mode (with a 32-bit counter, see ctr_mode.h) and authenticates
+ *            the associated data and the ciphertext with GHASH, a universal
+ *            hash over GF(2^128) keyed with H = AES(K, 0^128).
+ *
+ *            TinyCrypt GCM implementation accepts IVs of any non-zero
+ *            length; 12-byte IVs are processed without GHASH and are the
+ *            recommended choice.
+ *
+ *            GHASH uses a 4-bit multiplication table computed from H by
+ *            tc_gcm_config. Its lookups depend on the data and the key, like
+ *            the S-box of the portable AES. Building with TINYCRYPT_GCM_CLMUL
+ *            makes GHASH use the carry-less multiply instructions of the
+ *            processor (PCLMULQDQ on x86, PMULL on ARMv8) when they are
+ *            available at run time; they run in constant time.
+ *
+ *  Security: The same IV must never be used for two messages under the same
+ *            key: doing so reveals the xor of the plaintexts and lets an
+ *            adversary forge tags. Random IVs should only be used with the
+ *            12-byte length, and the number of messages per key kept well
+ *            below 2^32 (see SP 800-38D section 8).
+ *
+ *            Short tags weaken authentication; SP 800-38D allows 4- and
+ *            8-byte tags only under the constraints of its appendix C.
+ *
+ *  Requires: AES-128 (or AES-192/256 schedules)
+ *
+ *  Usage:    1) call tc_gcm_config to configure.
+ *
+ *            2) call tc_gcm_generation_encryption to encrypt data and
+ *               generate tag.
+ *
+ *            3) call tc_gcm_decryption_verification to verify tag and
+ *               decrypt data.
+ */
+
+#ifndef __TC_GCM_MODE_H__
+#define __TC_GCM_MODE_H__
+
+#include <tinycrypt/aes.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* struct tc_gcm_mode_struct represents the key-dependent state of GCM */
+typedef struct tc_gcm_mode_struct {
+	TCAesKeySched_t sched; /* AES key schedule */
+	uint64_t hl[16]; /* GHASH table: low halves of i * H */
+	uint64_t hh[16]; /* GHASH table: high halves of i * H */
+	uint8_t h[TC_AES_BLOCK_SIZE]; /* hash subkey H */
+	unsigned int mlen; /* tag length in bytes (parameter t in SP 800-38D) */
+} *TCGcmMode_t;
+
+/**
+ * @brief GCM configuration procedure
+ * Computes the hash subkey H and its GHASH table
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                g == NULL or
+ *                sched == NULL or
+ *                mlen != {4, 8, 12, 13, 14, 15, 16}
+ * @note g holds key material; erase it with _set() when done
+ * @param g OUT -- GCM state
+ * @param sched IN -- AES key schedule; it must stay valid while g is in use
+ * @param mlen IN -- tag length in bytes
+ */
+int tc_gcm_config(TCGcmMode_t g, TCAesKeySched_t sched, unsigned int mlen);
+
+/**
+ * @brief GCM encryption and tag generation procedure
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                g == NULL or
+ *                iv == NULL or
+ *                ivlen == 0 or
+ *                ((plen > 0) and (payload == NULL)) or
+ *                ((alen > 0) and (associated_data == NULL)) or
+ *                (olen < plen + g->mlen)
+ *
+ * @param out OUT -- ciphertext followed by the g->mlen-byte tag
+ * @param olen IN -- output length in bytes
+ * @param iv IN -- initialization vector
+ * @param ivlen IN -- initialization vector length in bytes
+ * @param associated_data IN -- associated data
+ * @param alen IN -- associated data length in bytes
+ * @param payload IN -- payload; may be the same buffer as out
+ * @param plen IN -- payload length in bytes
+ * @param g IN -- GCM state
+ */
+int tc_gcm_generation_encryption(uint8_t *out, unsigned int olen,
+				 const uint8_t *iv, unsigned int ivlen,
+				 const uint8_t *associated_data,
+				 unsigned int alen, const uint8_t *payload,
+				 unsigned int plen, TCGcmMode_t g);
+
+/**
+ * @brief GCM tag verification and decryption procedure
+ * The tag is checked before anything is decrypted; out is only written if
+ * it is valid.
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                the tag is invalid or
+ *                out == NULL or
+ *                g == NULL or
+ *                iv == NULL or
+ *                ivlen == 0 or
+ *                payload == NULL or
+ *                ((alen > 0) and (associated_data == NULL)) or
+ *                (plen < g->mlen) or
+ *                (olen < plen - g->mlen)
+ *
+ * @param out OUT -- decrypted data
+ * @param olen IN -- output length in bytes
+ * @param iv IN -- initialization vector
+ * @param ivlen IN -- initialization vector length in bytes
+ * @param associated_data IN -- associated data
+ * @param alen IN -- associated data length in bytes
+ * @param payload IN -- ciphertext followed by the tag; may be the same
+ *                      buffer as out
+ * @param plen IN -- payload length in bytes, tag included
+ * @param g IN -- GCM state
+ */
+int tc_gcm_decryption_verification(uint8_t *out, unsigned int olen,
+				   const uint8_t *iv, unsigned int ivlen,
+				   const uint8_t *associated_data,
+				   unsigned int alen, const uint8_t *payload,
+				   unsigned int plen, TCGcmMode_t g);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_GCM_MODE_H__ */
@@ -77,6 +77,14 @@ struct tc_hmac_state_struct {
 };
 typedef struct tc_hmac_state_struct *TCHmacState_t;
 
+struct tc_hmac_key_struct {
+	/* SHA-256 state after hashing the ipad key block */
+	struct tc_sha256_state_struct inner;
+	/* SHA-256 state after hashing the opad key block */
+	struct tc_sha256_state_struct outer;
+};
+typedef struct tc_hmac_key_struct *TCHmacKey_t;
+
 /**
  *  @brief HMAC set key procedure
  *  Configures ctx to use key
@@ -132,6 +140,86 @@ int tc_hmac_update(TCHmacState_t ctx, const void *data,
  */
 int tc_hmac_final(uint8_t *tag, unsigned int taglen, TCHmacState_t ctx);
 
+/**
+ *  @brief HMAC scatter-gather update procedure
+ *  Same as tc_hmac_update for the concatenation of iovcnt segments
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                ctx == NULL or
+ *                iov == NULL and iovcnt != 0 or
+ *                a segment base is NULL
+ *  @param ctx IN/OUT -- state of HMAC computation so far
+ *  @param iov IN -- segments of the data (see iovec.h)
+ *  @param iovcnt IN -- number of segments
+ */
+int tc_hmac_updatev(TCHmacState_t ctx, const struct tc_iovec *iov,
+		    unsigned int iovcnt);
+
+/**
+ *  @brief HMAC key precomputation procedure
+ *  Hashes the ipad and opad key blocks once and keeps the two SHA-256
+ *  midstates in key, so that each later MAC under the same key starts from
+ *  them and saves two compressions.
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                key == NULL or
+ *                k == NULL or
+ *                key_size == 0
+ *  @note key holds key material; erase it with _set() when done
+ *  @param key OUT -- the precomputed key state
+ *  @param k IN -- the HMAC key
+ *  @param key_size IN -- the HMAC key size
+ */
+int tc_hmac_key_set(TCHmacKey_t key, const uint8_t *k, unsigned int key_size);
+
+/**
+ *  @brief Keyed HMAC init procedure
+ *  Starts a MAC computation in s from the inner midstate of key. Feed the
+ *  message to s with tc_sha256_update and finish with tc_hmac_key_final.
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if: s == NULL or key == NULL
+ *  @param s OUT -- hash state of the MAC computation
+ *  @param key IN -- key state set by tc_hmac_key_set
+ */
+int tc_hmac_key_init(TCSha256State_t s, const struct tc_hmac_key_struct *key);
+
+/**
+ *  @brief Keyed HMAC final procedure
+ *  Writes the HMAC tag of the message hashed into s
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                tag == NULL or
+ *                s == NULL or
+ *                key == NULL or
+ *                taglen != TC_SHA256_DIGEST_SIZE
+ *  @note s is erased before exiting; key is left untouched for the next MAC
+ *  @param tag OUT -- buffer to receive computed HMAC tag
+ *  @param taglen IN -- size of tag in bytes
+ *  @param s IN/OUT -- hash state started by tc_hmac_key_init
+ *  @param key IN -- the key state s was started from
+ */
+int tc_hmac_key_final(uint8_t *tag, unsigned int taglen, TCSha256State_t s,
+		      const struct tc_hmac_key_struct *key);
+
+/**
+ *  @brief Keyed HMAC one-shot procedure
+ *  Computes the HMAC tag of data_length bytes at data under key
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                tag == NULL or
+ *                key == NULL or
+ *                data == NULL and data_length != 0 or
+ *                taglen != TC_SHA256_DIGEST_SIZE
+ *  @param tag OUT -- buffer to receive computed HMAC tag
+ *  @param taglen IN -- size of tag in bytes
+ *  @param data IN -- message to authenticate
+ *  @param data_length IN -- size of data in bytes
+ *  @param key IN -- key state set by tc_hmac_key_set
+ */
+int tc_hmac_key_mac(uint8_t *tag, unsigned int taglen, const void *data,
+		    unsigned int data_length,
+		    const struct tc_hmac_key_struct *key);
+
 #ifdef __cplusplus
 }
 #endif
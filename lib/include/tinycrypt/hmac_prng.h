@@ -78,8 +78,8 @@ extern "C" {
 #define TC_HMAC_PRNG_RESEED_REQ -1
 
 struct tc_hmac_prng_struct {
-	/* the HMAC instance for this PRNG */
-	struct tc_hmac_state_struct h;
+	/* the HMAC midstates of the current PRNG key */
+	struct tc_hmac_key_struct h;
 	/* the PRNG key */
 	uint8_t key[TC_SHA256_DIGEST_SIZE];
 	/* PRNG state */
@@ -0,0 +1,86 @@
+/* iovec.h - TinyCrypt interface to scatter-gather buffers */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Segment type for scatter-gather input and output.
+ *
+ *  Overview:   A message held as a chain of buffers (a packet split into
+ *              fragments, for instance) is described by an array of
+ *              struct tc_iovec, in order. The *v entry points of SHA-256,
+ *              HMAC, CMAC, CTR and CBC take such arrays and carry their
+ *              block state across segment boundaries, so the result is the
+ *              same as for the segments concatenated, without copying them
+ *              into one buffer first.
+ *
+ *              Segments may have any length, zero included. An output array
+ *              need not be split like the input one; only the total lengths
+ *              have to match.
+ */
+
+#ifndef __TC_IOVEC_H__
+#define __TC_IOVEC_H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* one segment: len bytes at base (read only when used for input) */
+struct tc_iovec {
+	void *base;
+	size_t len;
+};
+
+/**
+ * @brief Total length of a segment array
+ * @return the sum of the cnt segment lengths
+ * @param iov IN -- the segments
+ * @param cnt IN -- number of segments
+ */
+static inline size_t tc_iov_length(const struct tc_iovec *iov,
+				   unsigned int cnt)
+{
+	size_t len = 0;
+
+	while (cnt-- > 0) {
+		len += iov++->len;
+	}
+	return len;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_IOVEC_H__ */
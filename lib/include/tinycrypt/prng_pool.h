@@ -0,0 +1,207 @@
+/* prng_pool.h - TinyCrypt interface to a pool of per-thread CTR-PRNGs */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to a pool of independently seeded CTR-PRNGs.
+ *
+ *  Overview:   A single PRNG context shared by many threads needs a lock
+ *              around every request. The pool instead owns one CTR-PRNG
+ *              (see ctr_prng.h) per shard, each seeded from its own entropy,
+ *              and each shard is used by one thread or core only. A request
+ *              touches nothing but its own shard, so the generate path takes
+ *              no lock and shares no cache lines with other threads.
+ *
+ *              Small requests are served from a buffer of
+ *              TINYCRYPT_PRNG_POOL_BUFFER_SIZE bytes per shard, so the
+ *              CTR-PRNG update cost is shared by many of them; larger
+ *              requests go straight to tc_ctr_prng_generate_bulk.
+ *
+ *              Reseeding: a shard reseeds itself from the pool's entropy
+ *              function (typically default_CSPRNG from
+ *              ecc_platform_specific.h) every
+ *              TINYCRYPT_PRNG_POOL_RESEED_INTERVAL refills, when its
+ *              CTR-PRNG asks for it, and after tc_prng_pool_request_reseed.
+ *              The latter only advances a pool-wide epoch counter and can be
+ *              called from any thread (a housekeeping timer, or a fork
+ *              handler in the child process); each shard notices the new
+ *              epoch on its next request and reseeds in its owner's context,
+ *              so a shard is never touched by two threads at once.
+ *
+ *  Security:   The output of each shard is as good as the entropy it was
+ *              seeded with. If the entropy function fails while a shard has
+ *              to reseed, the request fails and the shard retries on the
+ *              next one.
+ *
+ *  Requires:   CTR-PRNG and AES-128
+ *
+ *  Usage:      1) allocate an array of count struct tc_prng_shard_struct,
+ *              one per thread or core, and call tc_prng_pool_init
+ *
+ *              2) in each thread, get its shard with tc_prng_pool_shard and
+ *              call tc_prng_pool_generate on that shard only
+ *
+ *              3) for ECC, pass tc_prng_pool_rng with the thread's shard to
+ *              the uECC_*_with_rng functions
+ *
+ *              4) once no thread uses the pool, call
+ *              tc_prng_pool_uninstantiate to zero out all shards
+ */
+
+#ifndef __TC_PRNG_POOL_H__
+#define __TC_PRNG_POOL_H__
+
+#include <tinycrypt/ctr_prng.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* bytes of output buffered per shard for small requests */
+#ifndef TINYCRYPT_PRNG_POOL_BUFFER_SIZE
+#define TINYCRYPT_PRNG_POOL_BUFFER_SIZE 256
+#endif
+
+/* refills or bulk requests a shard serves before it reseeds itself */
+#ifndef TINYCRYPT_PRNG_POOL_RESEED_INTERVAL
+#define TINYCRYPT_PRNG_POOL_RESEED_INTERVAL 65536U
+#endif
+
+/* entropy source: fills size bytes of dest, returns 1 on success, 0 if not */
+typedef int (*tc_prng_pool_entropy_fn)(uint8_t *dest, unsigned int size);
+
+struct tc_prng_pool_struct;
+
+/* struct tc_prng_shard_struct is the state owned by one thread */
+typedef struct tc_prng_shard_struct {
+	/* the shard's own CTR-PRNG */
+	TCCtrPrng_t prng;
+	/* buffered output; the unused bytes are at the start */
+	uint8_t buffer[TINYCRYPT_PRNG_POOL_BUFFER_SIZE];
+	/* number of unused bytes in buffer */
+	unsigned int left;
+	/* refills and bulk requests since the last reseed */
+	unsigned int requests;
+	/* pool epoch at the last reseed */
+	unsigned int epoch;
+	/* the pool the shard belongs to */
+	struct tc_prng_pool_struct *pool;
+} *TCPrngShard_t;
+
+/* struct tc_prng_pool_struct ties the shards to their entropy source */
+typedef struct tc_prng_pool_struct {
+	/* array of count shards */
+	struct tc_prng_shard_struct *shard;
+	unsigned int count;
+	/* where the shards get their seeds */
+	tc_prng_pool_entropy_fn entropy;
+	/* advanced by tc_prng_pool_request_reseed */
+	volatile unsigned int epoch;
+} *TCPrngPool_t;
+
+/**
+ *  @brief Pool initialization procedure
+ *  Seeds each of the count shards with its own entropy
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                pool == NULL,
+ *                shards == NULL,
+ *                count == 0,
+ *                entropy == NULL or
+ *                entropy fails
+ *  @param pool OUT -- the pool to initialize
+ *  @param shards IN/OUT -- array of count shards, owned by the pool until
+ *                tc_prng_pool_uninstantiate
+ *  @param count IN -- number of shards
+ *  @param entropy IN -- entropy source used for seeding and reseeding
+ */
+int tc_prng_pool_init(TCPrngPool_t pool, struct tc_prng_shard_struct *shards,
+		      unsigned int count, tc_prng_pool_entropy_fn entropy);
+
+/**
+ *  @brief Returns shard index of the pool, or NULL if index >= count
+ *  @param pool IN -- the pool
+ *  @param index IN -- index of the shard (e.g. the thread or core number)
+ */
+TCPrngShard_t tc_prng_pool_shard(TCPrngPool_t pool, unsigned int index);
+
+/**
+ *  @brief Pool generate procedure
+ *  Generates outlen pseudo-random bytes from shard s into out, reseeding s
+ *  first if it is due. Takes no lock: only the thread owning s may call it.
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL,
+ *                out == NULL,
+ *                a due reseed failed
+ *  @param s IN/OUT -- the calling thread's shard
+ *  @param out OUT -- buffer to receive output
+ *  @param outlen IN -- size of out in bytes
+ */
+int tc_prng_pool_generate(TCPrngShard_t s, uint8_t *out, size_t outlen);
+
+/**
+ *  @brief Asks every shard to reseed before its next request
+ *  Safe to call from any thread while the shards are in use.
+ *  @return none
+ *  @param pool IN/OUT -- the pool
+ */
+void tc_prng_pool_request_reseed(TCPrngPool_t pool);
+
+/**
+ *  @brief Pool RNG callback for the ECC *_with_rng functions
+ *  Has the uECC_RNG_Ctx_Function signature (see ecc.h), with ctx the calling
+ *  thread's shard, e.g.
+ *      uECC_make_key_with_rng(pub, priv, curve, tc_prng_pool_rng, shard);
+ *  @return returns 1 if size bytes were generated into dest, 0 if not
+ *  @param ctx IN/OUT -- the calling thread's TCPrngShard_t
+ *  @param dest OUT -- buffer to receive output
+ *  @param size IN -- size of dest in bytes
+ */
+int tc_prng_pool_rng(void *ctx, uint8_t *dest, unsigned int size);
+
+/**
+ *  @brief Pool uninstantiate procedure
+ *  Zeroes the state of every shard; no thread may use the pool afterwards
+ *  @return none
+ *  @param pool IN/OUT -- the pool
+ */
+void tc_prng_pool_uninstantiate(TCPrngPool_t pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_PRNG_POOL_H__ */
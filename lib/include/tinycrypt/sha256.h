@@ -57,6 +57,8 @@
 #ifndef __TC_SHA256_H__
 #define __TC_SHA256_H__
 
+#include <tinycrypt/iovec.h>
+
 #include <stddef.h>
 #include <stdint.h>
 
@@ -104,6 +106,21 @@ int tc_sha256_init(TCSha256State_t s);
  */
 int tc_sha256_update (TCSha256State_t s, const uint8_t *data, size_t datalen);
 
+/**
+ *  @brief SHA256 scatter-gather update procedure
+ *  Same as tc_sha256_update for the concatenation of iovcnt segments
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL,
+ *                iov == NULL and iovcnt != 0,
+ *                a segment base is NULL
+ *  @param s Sha256 state struct
+ *  @param iov segments of the message to hash (see iovec.h)
+ *  @param iovcnt number of segments
+ */
+int tc_sha256_updatev(TCSha256State_t s, const struct tc_iovec *iov,
+		      unsigned int iovcnt);
+
 /**
  *  @brief SHA256 final procedure
  *  Inserts the completed hash computation into digest
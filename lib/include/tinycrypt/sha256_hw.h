@@ -0,0 +1,92 @@
+/* sha256_hw.h - TinyCrypt interface to the hardware accelerated SHA-256 compression */
+
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief -- Interface to the SHA-NI / ARMv8 SHA-256 compression engine.
+ *
+ *  Overview:   This engine runs the SHA-256 compression function on the SHA
+ *              instructions of the processor when they are available. It
+ *              works directly on the chaining value of a
+ *              tc_sha256_state_struct, so the state layout (and thus HMAC
+ *              states) is unchanged.
+ *
+ *              The x86 engine (SHA extensions, with SSSE3 and SSE4.1) is
+ *              compiled whenever the compiler supports the target attribute
+ *              (GCC and clang); the instructions are then checked for at run
+ *              time with CPUID. The ARM engine requires the crypto extension
+ *              to be enabled at build time (e.g. -march=armv8-a+crypto) and,
+ *              on Linux, is also checked for at run time through HWCAP.
+ *
+ *              Define TINYCRYPT_SHA256_HW to make tc_sha256_update and
+ *              tc_sha256_final (and therefore HMAC, HMAC-PRNG and ECDSA
+ *              message hashing) use the engine whenever
+ *              tc_sha256_hw_available() reports it; the portable code is used
+ *              otherwise.
+ */
+
+#ifndef __TC_SHA256_HW_H__
+#define __TC_SHA256_HW_H__
+
+#include <tinycrypt/sha256.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  @brief Reports whether the hardware SHA-256 engine can be used
+ *  @return returns 1 if the engine is compiled in and the CPU supports it
+ *          returns 0 otherwise
+ */
+int tc_sha256_hw_available(void);
+
+/**
+ *  @brief SHA-256 compression of whole blocks with the SHA instructions
+ *  Updates the chaining value iv with nblocks 64-byte blocks of data
+ *  @return  returns TC_CRYPTO_SUCCESS (1)
+ *           returns TC_CRYPTO_FAIL (0) if the engine is not available
+ *  @note Assumes tc_sha256_hw_available() returned 1; iv is the iv field of
+ *        a tc_sha256_state_struct and data may have any alignment
+ *  @param iv IN/OUT -- the eight 32-bit words of the chaining value
+ *  @param data IN -- nblocks * 64 bytes of message
+ *  @param nblocks IN -- number of blocks in data
+ */
+int tc_sha256_hw_compress_blocks(unsigned int *iv, const uint8_t *data,
+				 size_t nblocks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_SHA256_HW_H__ */
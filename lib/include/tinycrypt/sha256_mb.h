@@ -0,0 +1,116 @@
+/* sha256_mb.h - TinyCrypt interface to multi-buffer SHA-256 */
+
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief -- Interface to multi-buffer SHA-256.
+ *
+ *  Overview:   Hashes many independent messages together: the contexts of an
+ *              array are advanced in lockstep, TC_SHA256_MB_LANES of them at
+ *              a time, each taking one 32-bit lane of SIMD vectors (two SSE2
+ *              or NEON registers, or one AVX2 register, used when the CPU
+ *              supports it and TINYCRYPT_SHA256_HW is defined). Short
+ *              messages, where the cost of a single compression dominates,
+ *              get the largest benefit.
+ *
+ *              The contexts are ordinary tc_sha256_state_struct values: they
+ *              are initialized with tc_sha256_init and may be mixed freely
+ *              with tc_sha256_update/tc_sha256_final, before or after the
+ *              multi-buffer calls.
+ *
+ *              The lanes are written with the GCC/clang vector extensions;
+ *              with other compilers these functions fall back to hashing the
+ *              contexts one after the other.
+ *
+ *  Usage:      1) call tc_sha256_init on each of the count contexts
+ *
+ *              2) call tc_sha256_mb_update, with one data pointer and length
+ *              per context, as many times as needed
+ *
+ *              3) call tc_sha256_mb_final to obtain the count digests
+ */
+
+#ifndef __TC_SHA256_MB_H__
+#define __TC_SHA256_MB_H__
+
+#include <tinycrypt/sha256.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TC_SHA256_MB_LANES (8)
+
+/**
+ *  @brief Multi-buffer SHA256 update procedure
+ *  Hashes datalen[i] bytes addressed by data[i] into state s[i], for i from
+ *  0 to count - 1
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL,
+ *                data == NULL,
+ *                datalen == NULL or
+ *                data[i] == NULL for some i
+ *  @note Assumes each s[i] has been initialized by tc_sha256_init; a data[i]
+ *        may be shared by several contexts
+ *  @param s IN/OUT -- array of count Sha256 state structs
+ *  @param data IN -- array of count messages to hash
+ *  @param datalen IN -- array of count message lengths
+ *  @param count IN -- number of contexts
+ */
+int tc_sha256_mb_update(struct tc_sha256_state_struct *s,
+			const uint8_t *const *data, const size_t *datalen,
+			unsigned int count);
+
+/**
+ *  @brief Multi-buffer SHA256 final procedure
+ *  Inserts the completed hash computation of s[i] into digest[i], for i from
+ *  0 to count - 1, and destroys the states
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                digest == NULL,
+ *                s == NULL or
+ *                digest[i] == NULL for some i
+ *  @param digest IN/OUT -- array of count buffers of TC_SHA256_DIGEST_SIZE
+ *                bytes
+ *  @param s IN/OUT -- array of count Sha256 state structs
+ *  @param count IN -- number of contexts
+ */
+int tc_sha256_mb_final(uint8_t *const *digest,
+		       struct tc_sha256_state_struct *s, unsigned int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_SHA256_MB_H__ */
@@ -39,6 +39,8 @@
 #ifndef __TC_UTILS_H__
 #define __TC_UTILS_H__
 
+#include <tinycrypt/constants.h>
+
 #include <stdint.h>
 #include <stddef.h>
 #include <string.h>
@@ -63,6 +65,8 @@ unsigned int _copy(uint8_t *to, unsigned int to_len,
 
 /**
  * @brief Set the value 'val' into the buffer 'to', 'len' times.
+ *        The stores are kept even when 'to' is not read again, since _set is
+ *        also used to erase key material.
  *
  * @param to OUT -- destination buffer
  * @param val IN -- value to be set in 'to'
@@ -70,6 +74,34 @@ unsigned int _copy(uint8_t *to, unsigned int to_len,
  */
 void _set(void *to, uint8_t val, unsigned int len);
 
+/*
+ * With GCC-compatible compilers, _copy and _set are also defined inline here,
+ * so that copies and clears of a known size become a few word or vector moves
+ * at the call site; gnu_inline keeps these definitions for inlining only, the
+ * library still exports the functions declared above. Other compilers call
+ * the library functions.
+ */
+#if defined(__GNUC__)
+extern __inline__ __attribute__((gnu_inline))
+unsigned int _copy(uint8_t *to, unsigned int to_len,
+		   const uint8_t *from, unsigned int from_len)
+{
+	if (from_len <= to_len) {
+		(void)memcpy(to, from, from_len);
+		return from_len;
+	} else {
+		return TC_CRYPTO_FAIL;
+	}
+}
+
+extern __inline__ __attribute__((gnu_inline))
+void _set(void *to, uint8_t val, unsigned int len)
+{
+	(void)memset(to, val, len);
+	__asm__ __volatile__("" :: "g"(to) : "memory");
+}
+#endif /* __GNUC__ */
+
 /**
  * @brief Set the value 'val' into the buffer 'to', 'len' times, in a way
  *         which does not risk getting optimized out by the compiler
@@ -106,6 +138,8 @@ uint8_t _double_byte(uint8_t a);
 
 /*
  * @brief Constant-time algorithm to compare if two sequences of bytes are equal
+ *        The sequences are compared a word at a time; the running time
+ *        depends on size only.
  * @return Returns 0 if equal, and non-zero otherwise
  *
  * @param a IN -- sequence of bytes a
@@ -114,6 +148,21 @@ uint8_t _double_byte(uint8_t a);
  */
 int _compare(const uint8_t *a, const uint8_t *b, size_t size);
 
+/* Flags returned by _cpu_features(): */
+#define TC_CPU_AES (1 << 0) /* AES-NI (with SSSE3) or ARMv8 AES instructions */
+#define TC_CPU_SHA256 (1 << 1) /* SHA extensions (with SSSE3 and SSE4.1) or
+				* ARMv8 SHA-256 instructions */
+#define TC_CPU_AVX2 (1 << 2) /* AVX2, with the OS saving the ymm registers */
+#define TC_CPU_CLMUL (1 << 3) /* PCLMULQDQ (with SSSE3) or ARMv8 PMULL */
+
+/*
+ * @brief Run-time detection of the optional CPU instructions used by the
+ *        accelerated engines. The result is computed once and cached.
+ * @return Returns a mask of TC_CPU_* flags, or 0 if no optional instructions
+ *         are available or the platform has no detection support
+ */
+unsigned int _cpu_features(void);
+
 #ifdef __cplusplus
 }
 #endif
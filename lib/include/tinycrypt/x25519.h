@@ -0,0 +1,136 @@
+/* x25519.h - TinyCrypt interface to X25519 key agreement */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief -- Interface to X25519 key agreement.
+ *
+ *  Overview: X25519 (RFC 7748) is Diffie-Hellman on the Montgomery curve
+ *            Curve25519, y^2 = x^3 + 486662 x^2 + x over GF(2^255 - 19).
+ *            Only the u coordinate is used: keys and shared secrets are
+ *            32-byte little-endian strings, and the scalar multiplication is
+ *            a Montgomery ladder with a conditional swap, so its timing and
+ *            memory accesses do not depend on the private key.
+ *
+ *            Field elements are kept in 5 limbs of 51 bits on compilers with
+ *            unsigned __int128, and in 10 limbs of alternately 26 and 25 bits
+ *            otherwise (see TINYCRYPT_X25519_RADIX51 in x25519.c).
+ *
+ *  Security: Curve25519 provides approximately 128 bits of security.
+ *            Every 32-byte string is a valid public key, so there is nothing
+ *            to validate; tc_x25519_shared_secret() instead refuses public
+ *            keys of small order, which give an all-zero secret.
+ *
+ *  Requires: the uECC RNG functions in ecc.h/c, for key generation only.
+ */
+
+#ifndef __TC_X25519_H__
+#define __TC_X25519_H__
+
+#include <tinycrypt/ecc.h>
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TC_X25519_KEY_SIZE 32
+
+/**
+ * @brief X25519 function of RFC 7748: multiply the point with u coordinate
+ * point by the scalar, after clamping it.
+ * @return returns TC_CRYPTO_SUCCESS (1) if the result is not zero
+ *         returns TC_CRYPTO_FAIL (0) if the result is zero (point of small
+ *         order)
+ *
+ * @param out OUT -- u coordinate of the result (32 bytes)
+ * @param scalar IN -- scalar (32 bytes); bits 0-2 and 255 are cleared and bit
+ * 254 is set before use
+ * @param point IN -- u coordinate of the point (32 bytes); bit 255 is ignored
+ */
+int tc_x25519(uint8_t *out, const uint8_t *scalar, const uint8_t *point);
+
+/**
+ * @brief Compute the public key of a private key (X25519 with u = 9).
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *
+ * @param public_key OUT -- public key (32 bytes)
+ * @param private_key IN -- private key, 32 random bytes
+ */
+int tc_x25519_public_key(uint8_t *public_key, const uint8_t *private_key);
+
+/**
+ * @brief Create a public/private key pair.
+ * @return returns TC_CRYPTO_SUCCESS (1) if the key pair was generated
+ *         successfully
+ *         returns TC_CRYPTO_FAIL (0) if no RNG is set or it failed
+ *
+ * @param public_key OUT -- public key (32 bytes)
+ * @param private_key OUT -- private key (32 bytes)
+ *
+ * @warning A cryptographically-secure PRNG function must be set (using
+ * uECC_set_rng()) before calling tc_x25519_make_key().
+ */
+int tc_x25519_make_key(uint8_t *public_key, uint8_t *private_key);
+
+/**
+ * @brief Same as tc_x25519_make_key(), drawing random bytes from rng.
+ * @param rng IN -- RNG function (see uECC_RNG_Ctx_Function)
+ * @param rng_ctx IN -- context passed to rng
+ */
+int tc_x25519_make_key_with_rng(uint8_t *public_key, uint8_t *private_key,
+				uECC_RNG_Ctx_Function rng, void *rng_ctx);
+
+/**
+ * @brief Compute a shared secret given your private key and someone else's
+ * public key.
+ * @return returns TC_CRYPTO_SUCCESS (1) if the shared secret was computed
+ *         successfully
+ *         returns TC_CRYPTO_FAIL (0) if the public key has small order; secret
+ *         is then all zero
+ *
+ * @param public_key IN -- The public key of the remote party (32 bytes).
+ * @param private_key IN -- Your private key (32 bytes).
+ * @param secret OUT -- Will be filled in with the shared secret (32 bytes).
+ *
+ * @warning As with uECC_shared_secret(), the secret should go through a key
+ * derivation function before use as a symmetric key.
+ */
+int tc_x25519_shared_secret(const uint8_t *public_key,
+			    const uint8_t *private_key, uint8_t *secret);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_X25519_H__ */
@@ -0,0 +1,171 @@
+/* accel.c - TinyCrypt registry of crypto accelerator drivers */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/accel.h>
+#include <tinycrypt/constants.h>
+
+static const struct tc_accel_aes_ops *aes_ops;
+static void *aes_ctx;
+static const struct tc_accel_sha256_ops *sha256_ops;
+static void *sha256_ctx;
+static const struct tc_accel_p256_ops *p256_ops;
+static void *p256_ctx;
+
+int tc_accel_register_aes(const struct tc_accel_aes_ops *ops, void *ctx)
+{
+	aes_ops = ops;
+	aes_ctx = ctx;
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_accel_register_sha256(const struct tc_accel_sha256_ops *ops,
+			     void *ctx)
+{
+	sha256_ops = ops;
+	sha256_ctx = ctx;
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_accel_register_p256(const struct tc_accel_p256_ops *ops, void *ctx)
+{
+	p256_ops = ops;
+	p256_ctx = ctx;
+	return TC_CRYPTO_SUCCESS;
+}
+
+unsigned int tc_accel_aes_key(uint8_t *key, const TCAesKeySched_t s)
+{
+	unsigned int nk = TC_AES_ROUNDS(s) - 6;
+	unsigned int i;
+
+	/* a schedule holds at most an AES-256 key */
+	if (nk > TC_AES_256_KEY_SIZE / Nb) {
+		nk = TC_AES_256_KEY_SIZE / Nb;
+	}
+	for (i = 0; i < nk; ++i) {
+		key[Nb*i] = (uint8_t)(s->words[i] >> 24);
+		key[Nb*i+1] = (uint8_t)(s->words[i] >> 16);
+		key[Nb*i+2] = (uint8_t)(s->words[i] >> 8);
+		key[Nb*i+3] = (uint8_t)(s->words[i]);
+	}
+	return Nb * nk;
+}
+
+int tc_accel_aes_encrypt(uint8_t *out, const uint8_t *in,
+			 const TCAesKeySched_t s)
+{
+	if (aes_ops == (const struct tc_accel_aes_ops *) 0 ||
+	    aes_ops->encrypt == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	return aes_ops->encrypt(aes_ctx, out, in, s) == TC_CRYPTO_SUCCESS;
+}
+
+int tc_accel_aes_decrypt(uint8_t *out, const uint8_t *in,
+			 const TCAesKeySched_t s)
+{
+	if (aes_ops == (const struct tc_accel_aes_ops *) 0 ||
+	    aes_ops->decrypt == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	return aes_ops->decrypt(aes_ctx, out, in, s) == TC_CRYPTO_SUCCESS;
+}
+
+int tc_accel_aes_encrypt_blocks(uint8_t *out, const uint8_t *in,
+				unsigned int nblocks, const TCAesKeySched_t s)
+{
+	if (aes_ops == (const struct tc_accel_aes_ops *) 0 ||
+	    aes_ops->encrypt_blocks == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	return aes_ops->encrypt_blocks(aes_ctx, out, in, nblocks, s) ==
+	       TC_CRYPTO_SUCCESS;
+}
+
+int tc_accel_aes_decrypt_blocks(uint8_t *out, const uint8_t *in,
+				unsigned int nblocks, const TCAesKeySched_t s)
+{
+	if (aes_ops == (const struct tc_accel_aes_ops *) 0 ||
+	    aes_ops->decrypt_blocks == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	return aes_ops->decrypt_blocks(aes_ctx, out, in, nblocks, s) ==
+	       TC_CRYPTO_SUCCESS;
+}
+
+int tc_accel_aes_encrypt_blocks_async(uint8_t *out, const uint8_t *in,
+				      unsigned int nblocks,
+				      const TCAesKeySched_t s,
+				      tc_accel_done_t done, void *arg)
+{
+	if (aes_ops == (const struct tc_accel_aes_ops *) 0 ||
+	    aes_ops->encrypt_blocks_async == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	return aes_ops->encrypt_blocks_async(aes_ctx, out, in, nblocks, s,
+					     done, arg) == TC_CRYPTO_SUCCESS;
+}
+
+int tc_accel_aes_decrypt_blocks_async(uint8_t *out, const uint8_t *in,
+				      unsigned int nblocks,
+				      const TCAesKeySched_t s,
+				      tc_accel_done_t done, void *arg)
+{
+	if (aes_ops == (const struct tc_accel_aes_ops *) 0 ||
+	    aes_ops->decrypt_blocks_async == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	return aes_ops->decrypt_blocks_async(aes_ctx, out, in, nblocks, s,
+					     done, arg) == TC_CRYPTO_SUCCESS;
+}
+
+int tc_accel_sha256_compress_blocks(unsigned int *iv, const uint8_t *data,
+				    size_t nblocks)
+{
+	if (sha256_ops == (const struct tc_accel_sha256_ops *) 0 ||
+	    sha256_ops->compress_blocks == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	return sha256_ops->compress_blocks(sha256_ctx, iv, data, nblocks) ==
+	       TC_CRYPTO_SUCCESS;
+}
+
+int tc_accel_p256_mult(uint8_t *result, const uint8_t *point,
+		       const uint8_t *scalar)
+{
+	if (p256_ops == (const struct tc_accel_p256_ops *) 0 ||
+	    p256_ops->mult == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	return p256_ops->mult(p256_ctx, result, point, scalar) ==
+	       TC_CRYPTO_SUCCESS;
+}
@@ -0,0 +1,576 @@
+/* aes_bitslice.c - TinyCrypt implementation of the bitsliced AES engine */
+
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/aes_bitslice.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+#if !defined(TINYCRYPT_AES_BITSLICE_WORD)
+#if UINTPTR_MAX > 0xffffffffu
+#define TINYCRYPT_AES_BITSLICE_WORD 64
+#else
+#define TINYCRYPT_AES_BITSLICE_WORD 32
+#endif
+#endif
+
+/*
+ * Each bit plane is a set of words. Every block takes a 16-bit lane of a
+ * word, in which bit (4 * c + r) holds row r of column c of the state, i.e.
+ * byte (4 * c + r) of the block as it is laid out in memory.
+ */
+#if TINYCRYPT_AES_BITSLICE_WORD == 64
+typedef uint64_t bs_word;
+#define LANES(x) ((bs_word)(x) * 0x0001000100010001ull)
+#elif TINYCRYPT_AES_BITSLICE_WORD == 32
+typedef uint32_t bs_word;
+#define LANES(x) ((bs_word)(x) * 0x00010001u)
+#else
+#error "TINYCRYPT_AES_BITSLICE_WORD must be 32 or 64"
+#endif
+
+/* words per plane needed to hold TC_AES_BITSLICE_BLOCKS blocks: */
+#define BS_WORDS ((TC_AES_BITSLICE_BLOCKS * 16) / TINYCRYPT_AES_BITSLICE_WORD)
+/* bytes of input held by one word of every plane: */
+#define BS_WORD_BYTES (TINYCRYPT_AES_BITSLICE_WORD)
+
+/*
+ * Transposes the 8x8 bit matrix whose row i is byte i of x, so that byte j of
+ * the result collects bit j of every byte of x.
+ */
+static inline uint64_t transpose8(uint64_t x)
+{
+	uint64_t t;
+
+	t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAull;
+	x = x ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCull;
+	x = x ^ t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ull;
+	x = x ^ t ^ (t << 28);
+	return x;
+}
+
+static inline uint64_t load64_le(const uint8_t *p)
+{
+	return ((uint64_t) p[0]) | ((uint64_t) p[1] << 8) |
+	       ((uint64_t) p[2] << 16) | ((uint64_t) p[3] << 24) |
+	       ((uint64_t) p[4] << 32) | ((uint64_t) p[5] << 40) |
+	       ((uint64_t) p[6] << 48) | ((uint64_t) p[7] << 56);
+}
+
+static inline void store64_le(uint8_t *p, uint64_t x)
+{
+	unsigned int i;
+
+	for (i = 0; i < 8; ++i) {
+		p[i] = (uint8_t)(x >> (8 * i));
+	}
+}
+
+/* Converts BS_WORD_BYTES bytes into one word of each of the 8 planes. */
+static void bs_load(bs_word *q, const uint8_t *in)
+{
+	uint64_t x;
+	unsigned int g;
+	unsigned int j;
+
+	for (j = 0; j < 8; ++j) {
+		q[j] = 0;
+	}
+	for (g = 0; g < BS_WORD_BYTES / 8; ++g) {
+		x = transpose8(load64_le(in + 8 * g));
+		for (j = 0; j < 8; ++j) {
+			q[j] |= (bs_word)((x >> (8 * j)) & 0xff) << (8 * g);
+		}
+	}
+}
+
+static void bs_store(uint8_t *out, const bs_word *q)
+{
+	uint64_t x;
+	unsigned int g;
+	unsigned int j;
+
+	for (g = 0; g < BS_WORD_BYTES / 8; ++g) {
+		x = 0;
+		for (j = 0; j < 8; ++j) {
+			x |= (uint64_t)((q[j] >> (8 * g)) & 0xff) << (8 * j);
+		}
+		store64_le(out + 8 * g, transpose8(x));
+	}
+}
+
+/* Bitslices round key w[0..3] into 8 planes, replicated in every lane. */
+static void bs_round_key(bs_word *rk, const unsigned int *w)
+{
+	uint8_t k[16];
+	uint64_t lo, hi;
+	unsigned int j;
+
+	for (j = 0; j < 16; ++j) {
+		k[j] = (uint8_t)(w[j / 4] >> (24 - 8 * (j % 4)));
+	}
+	lo = transpose8(load64_le(k));
+	hi = transpose8(load64_le(k + 8));
+	for (j = 0; j < 8; ++j) {
+		rk[j] = LANES(((lo >> (8 * j)) & 0xff) |
+			      (((hi >> (8 * j)) & 0xff) << 8));
+	}
+	_set(k, 0, sizeof(k));
+}
+
+static inline void add_round_key(bs_word *q, const bs_word *rk)
+{
+	unsigned int j;
+
+	for (j = 0; j < 8; ++j) {
+		q[j] ^= rk[j];
+	}
+}
+
+/*
+ * The S-box as the circuit of Boyar and Peralta, "A new combinational logic
+ * minimization technique with applications to cryptology"
+ * (https://eprint.iacr.org/2009/191.pdf). Variables x* (input) and s*
+ * (output) are numbered from the most significant bit down.
+ */
+static void sub_bytes(bs_word *q)
+{
+	bs_word x0, x1, x2, x3, x4, x5, x6, x7;
+	bs_word y1, y2, y3, y4, y5, y6, y7, y8, y9;
+	bs_word y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+	bs_word y20, y21;
+	bs_word z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+	bs_word z10, z11, z12, z13, z14, z15, z16, z17;
+	bs_word t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+	bs_word t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+	bs_word t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+	bs_word t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+	bs_word t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+	bs_word t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+	bs_word t60, t61, t62, t63, t64, t65, t66, t67;
+	bs_word s0, s1, s2, s3, s4, s5, s6, s7;
+
+	x0 = q[7];
+	x1 = q[6];
+	x2 = q[5];
+	x3 = q[4];
+	x4 = q[3];
+	x5 = q[2];
+	x6 = q[1];
+	x7 = q[0];
+
+	/* top linear transformation */
+	y14 = x3 ^ x5;
+	y13 = x0 ^ x6;
+	y9 = x0 ^ x3;
+	y8 = x0 ^ x5;
+	t0 = x1 ^ x2;
+	y1 = t0 ^ x7;
+	y4 = y1 ^ x3;
+	y12 = y13 ^ y14;
+	y2 = y1 ^ x0;
+	y5 = y1 ^ x6;
+	y3 = y5 ^ y8;
+	t1 = x4 ^ y12;
+	y15 = t1 ^ x5;
+	y20 = t1 ^ x1;
+	y6 = y15 ^ x7;
+	y10 = y15 ^ t0;
+	y11 = y20 ^ y9;
+	y7 = x7 ^ y11;
+	y17 = y10 ^ y11;
+	y19 = y10 ^ y8;
+	y16 = t0 ^ y11;
+	y21 = y13 ^ y16;
+	y18 = x0 ^ y16;
+
+	/* non-linear section */
+	t2 = y12 & y15;
+	t3 = y3 & y6;
+	t4 = t3 ^ t2;
+	t5 = y4 & x7;
+	t6 = t5 ^ t2;
+	t7 = y13 & y16;
+	t8 = y5 & y1;
+	t9 = t8 ^ t7;
+	t10 = y2 & y7;
+	t11 = t10 ^ t7;
+	t12 = y9 & y11;
+	t13 = y14 & y17;
+	t14 = t13 ^ t12;
+	t15 = y8 & y10;
+	t16 = t15 ^ t12;
+	t17 = t4 ^ t14;
+	t18 = t6 ^ t16;
+	t19 = t9 ^ t14;
+	t20 = t11 ^ t16;
+	t21 = t17 ^ y20;
+	t22 = t18 ^ y19;
+	t23 = t19 ^ y21;
+	t24 = t20 ^ y18;
+
+	t25 = t21 ^ t22;
+	t26 = t21 & t23;
+	t27 = t24 ^ t26;
+	t28 = t25 & t27;
+	t29 = t28 ^ t22;
+	t30 = t23 ^ t24;
+	t31 = t22 ^ t26;
+	t32 = t31 & t30;
+	t33 = t32 ^ t24;
+	t34 = t23 ^ t33;
+	t35 = t27 ^ t33;
+	t36 = t24 & t35;
+	t37 = t36 ^ t34;
+	t38 = t27 ^ t36;
+	t39 = t29 & t38;
+	t40 = t25 ^ t39;
+
+	t41 = t40 ^ t37;
+	t42 = t29 ^ t33;
+	t43 = t29 ^ t40;
+	t44 = t33 ^ t37;
+	t45 = t42 ^ t41;
+	z0 = t44 & y15;
+	z1 = t37 & y6;
+	z2 = t33 & x7;
+	z3 = t43 & y16;
+	z4 = t40 & y1;
+	z5 = t29 & y7;
+	z6 = t42 & y11;
+	z7 = t45 & y17;
+	z8 = t41 & y10;
+	z9 = t44 & y12;
+	z10 = t37 & y3;
+	z11 = t33 & y4;
+	z12 = t43 & y13;
+	z13 = t40 & y5;
+	z14 = t29 & y2;
+	z15 = t42 & y9;
+	z16 = t45 & y14;
+	z17 = t41 & y8;
+
+	/* bottom linear transformation */
+	t46 = z15 ^ z16;
+	t47 = z10 ^ z11;
+	t48 = z5 ^ z13;
+	t49 = z9 ^ z10;
+	t50 = z2 ^ z12;
+	t51 = z2 ^ z5;
+	t52 = z7 ^ z8;
+	t53 = z0 ^ z3;
+	t54 = z6 ^ z7;
+	t55 = z16 ^ z17;
+	t56 = z12 ^ t48;
+	t57 = t50 ^ t53;
+	t58 = z4 ^ t46;
+	t59 = z3 ^ t54;
+	t60 = t46 ^ t57;
+	t61 = z14 ^ t57;
+	t62 = t52 ^ t58;
+	t63 = t49 ^ t58;
+	t64 = z4 ^ t59;
+	t65 = t61 ^ t62;
+	t66 = z1 ^ t63;
+	s0 = t59 ^ t63;
+	s6 = t56 ^ ~t62;
+	s7 = t48 ^ ~t60;
+	t67 = t64 ^ t65;
+	s3 = t53 ^ t66;
+	s4 = t51 ^ t66;
+	s5 = t47 ^ t65;
+	s1 = t64 ^ ~s3;
+	s2 = t55 ^ ~t67;
+
+	q[7] = s0;
+	q[6] = s1;
+	q[5] = s2;
+	q[4] = s3;
+	q[3] = s4;
+	q[2] = s5;
+	q[1] = s6;
+	q[0] = s7;
+}
+
+/*
+ * Inverse of the affine transformation of the S-box:
+ * b[i] = b'[i+2] ^ b'[i+5] ^ b'[i+7] ^ (0x05 bit i), indices modulo 8.
+ */
+static inline void inv_affine(bs_word *q)
+{
+	bs_word t[8];
+	unsigned int j;
+
+	for (j = 0; j < 8; ++j) {
+		t[j] = q[(j + 2) & 7] ^ q[(j + 5) & 7] ^ q[(j + 7) & 7];
+	}
+	for (j = 0; j < 8; ++j) {
+		q[j] = t[j];
+	}
+	q[0] = ~q[0];
+	q[2] = ~q[2];
+}
+
+/*
+ * Since S = A o I (A the affine transformation, I the field inversion), the
+ * inverse S-box I o A^-1 is A^-1 o S o A^-1: it reuses the forward circuit.
+ */
+static void inv_sub_bytes(bs_word *q)
+{
+	inv_affine(q);
+	sub_bytes(q);
+	inv_affine(q);
+}
+
+/* Rotates every 16-bit lane of x right by k bits (0 < k < 16). */
+static inline bs_word rotr_lanes(bs_word x, unsigned int k)
+{
+	return ((x >> k) & LANES(0xffff >> k)) |
+	       ((x << (16 - k)) & LANES((0xffff << (16 - k)) & 0xffff));
+}
+
+#define ROW(r) LANES(0x1111 << (r))
+
+/* Row r moves left by r columns, i.e. its bits move down by 4 * r. */
+static inline void shift_rows(bs_word *q)
+{
+	unsigned int j;
+
+	for (j = 0; j < 8; ++j) {
+		q[j] = (q[j] & ROW(0)) | (rotr_lanes(q[j], 4) & ROW(1)) |
+		       (rotr_lanes(q[j], 8) & ROW(2)) |
+		       (rotr_lanes(q[j], 12) & ROW(3));
+	}
+}
+
+static inline void inv_shift_rows(bs_word *q)
+{
+	unsigned int j;
+
+	for (j = 0; j < 8; ++j) {
+		q[j] = (q[j] & ROW(0)) | (rotr_lanes(q[j], 12) & ROW(1)) |
+		       (rotr_lanes(q[j], 8) & ROW(2)) |
+		       (rotr_lanes(q[j], 4) & ROW(3));
+	}
+}
+
+/* Rotates the rows of every column up by one (row r receives row r + 1). */
+static inline bs_word rot1(bs_word x)
+{
+	return ((x >> 1) & LANES(0x7777)) | ((x << 3) & LANES(0x8888));
+}
+
+/* Rotates the rows of every column up by two. */
+static inline bs_word rot2(bs_word x)
+{
+	return ((x >> 2) & LANES(0x3333)) | ((x << 2) & LANES(0xcccc));
+}
+
+/* Multiplication by x in GF(2^8) of every byte: bit planes shift up and
+ * the carried-out plane 7 is reduced by 0x1b. */
+static inline void xtime(bs_word *q)
+{
+	bs_word t7 = q[7];
+
+	q[7] = q[6];
+	q[6] = q[5];
+	q[5] = q[4];
+	q[4] = q[3] ^ t7;
+	q[3] = q[2] ^ t7;
+	q[2] = q[1];
+	q[1] = q[0] ^ t7;
+	q[0] = t7;
+}
+
+/* out[r] = 2 * (a[r] ^ a[r+1]) ^ a[r+1] ^ a[r+2] ^ a[r+3] */
+static void mix_columns(bs_word *q)
+{
+	bs_word t[8];
+	bs_word a1;
+	unsigned int j;
+
+	for (j = 0; j < 8; ++j) {
+		a1 = rot1(q[j]);
+		t[j] = q[j] ^ a1;
+		q[j] = a1 ^ rot2(t[j]);
+	}
+	xtime(t);
+	for (j = 0; j < 8; ++j) {
+		q[j] ^= t[j];
+	}
+}
+
+/*
+ * InvMixColumns is MixColumns applied after multiplying each column by
+ * 4x^2 + 5, i.e. a[r] ^= 4 * (a[r] ^ a[r+2]).
+ */
+static void inv_mix_columns(bs_word *q)
+{
+	bs_word t[8];
+	unsigned int j;
+
+	for (j = 0; j < 8; ++j) {
+		t[j] = q[j] ^ rot2(q[j]);
+	}
+	xtime(t);
+	xtime(t);
+	for (j = 0; j < 8; ++j) {
+		q[j] ^= t[j];
+	}
+	mix_columns(q);
+}
+
+static void encrypt_pass(bs_word q[BS_WORDS][8], const unsigned int *w,
+			 unsigned int rounds)
+{
+	bs_word rk[8];
+	unsigned int i;
+	unsigned int r;
+
+	bs_round_key(rk, w);
+	for (i = 0; i < BS_WORDS; ++i) {
+		add_round_key(q[i], rk);
+	}
+	for (r = 1; r < rounds; ++r) {
+		bs_round_key(rk, w + Nb*r);
+		for (i = 0; i < BS_WORDS; ++i) {
+			sub_bytes(q[i]);
+			shift_rows(q[i]);
+			mix_columns(q[i]);
+			add_round_key(q[i], rk);
+		}
+	}
+	bs_round_key(rk, w + Nb*rounds);
+	for (i = 0; i < BS_WORDS; ++i) {
+		sub_bytes(q[i]);
+		shift_rows(q[i]);
+		add_round_key(q[i], rk);
+	}
+	_set(rk, 0, sizeof(rk));
+}
+
+static void decrypt_pass(bs_word q[BS_WORDS][8], const unsigned int *w,
+			 unsigned int rounds)
+{
+	bs_word rk[8];
+	unsigned int i;
+	unsigned int r;
+
+	bs_round_key(rk, w + Nb*rounds);
+	for (i = 0; i < BS_WORDS; ++i) {
+		add_round_key(q[i], rk);
+	}
+	for (r = rounds - 1; r > 0; --r) {
+		bs_round_key(rk, w + Nb*r);
+		for (i = 0; i < BS_WORDS; ++i) {
+			inv_shift_rows(q[i]);
+			inv_sub_bytes(q[i]);
+			add_round_key(q[i], rk);
+			inv_mix_columns(q[i]);
+		}
+	}
+	bs_round_key(rk, w);
+	for (i = 0; i < BS_WORDS; ++i) {
+		inv_shift_rows(q[i]);
+		inv_sub_bytes(q[i]);
+		add_round_key(q[i], rk);
+	}
+	_set(rk, 0, sizeof(rk));
+}
+
+static int process_blocks(uint8_t *out, const uint8_t *in,
+			  unsigned int nblocks, const TCAesKeySched_t s,
+			  int encrypt)
+{
+	uint8_t buffer[TC_AES_BITSLICE_BLOCKS * TC_AES_BLOCK_SIZE];
+	bs_word q[BS_WORDS][8];
+	unsigned int n;
+	unsigned int i;
+
+	if (out == (uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (in == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (s == (TCAesKeySched_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	while (nblocks > 0) {
+		n = nblocks < TC_AES_BITSLICE_BLOCKS ?
+		    nblocks : TC_AES_BITSLICE_BLOCKS;
+
+		/* a partial pass runs on zero blocks in the unused lanes */
+		_set(buffer, 0, sizeof(buffer));
+		(void)_copy(buffer, sizeof(buffer), in, n * TC_AES_BLOCK_SIZE);
+		for (i = 0; i < BS_WORDS; ++i) {
+			bs_load(q[i], buffer + i * BS_WORD_BYTES);
+		}
+
+		if (encrypt) {
+			encrypt_pass(q, s->words, TC_AES_ROUNDS(s));
+		} else {
+			decrypt_pass(q, s->words, TC_AES_ROUNDS(s));
+		}
+
+		for (i = 0; i < BS_WORDS; ++i) {
+			bs_store(buffer + i * BS_WORD_BYTES, q[i]);
+		}
+		(void)_copy(out, n * TC_AES_BLOCK_SIZE, buffer,
+			    n * TC_AES_BLOCK_SIZE);
+
+		out += n * TC_AES_BLOCK_SIZE;
+		in += n * TC_AES_BLOCK_SIZE;
+		nblocks -= n;
+	}
+
+	/* zeroing out the state */
+	_set(buffer, 0, sizeof(buffer));
+	_set(q, 0, sizeof(q));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_aes_bitslice_encrypt_blocks(uint8_t *out, const uint8_t *in,
+				   unsigned int nblocks,
+				   const TCAesKeySched_t s)
+{
+	return process_blocks(out, in, nblocks, s, 1);
+}
+
+int tc_aes_bitslice_decrypt_blocks(uint8_t *out, const uint8_t *in,
+				   unsigned int nblocks,
+				   const TCAesKeySched_t s)
+{
+	return process_blocks(out, in, nblocks, s, 0);
+}
@@ -0,0 +1,208 @@
+/* aes_cache.c - TinyCrypt implementation of an AES key schedule cache */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/aes_cache.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+#define SLOT_USED (1U)
+
+static void slot_erase(struct tc_aes_cache_slot *slot)
+{
+	_set_secure(slot, 0, sizeof(*slot));
+}
+
+/* reads the key back from the first words of a schedule */
+static unsigned int sched_key(uint8_t *k,
+			      const struct tc_aes_key_sched_struct *s)
+{
+	unsigned int nk = TC_AES_ROUNDS(s) - 6;
+	unsigned int i;
+
+	for (i = 0; i < nk; ++i) {
+		k[Nb*i] = (uint8_t)(s->words[i] >> 24);
+		k[Nb*i+1] = (uint8_t)(s->words[i] >> 16);
+		k[Nb*i+2] = (uint8_t)(s->words[i] >> 8);
+		k[Nb*i+3] = (uint8_t)(s->words[i]);
+	}
+	return Nb * nk;
+}
+
+static int key_matches(const struct tc_aes_key_sched_struct *s,
+		       const uint8_t *k, unsigned int klen)
+{
+	uint8_t cached[TC_AES_256_KEY_SIZE];
+	int r;
+
+	r = sched_key(cached, s) == klen && _compare(cached, k, klen) == 0;
+	_set_secure(cached, 0, sizeof(cached));
+	return r;
+}
+
+/* the slot holding handle, expanding k into one if it is not there */
+static struct tc_aes_cache_slot *fetch(TCAesCache_t c, uint32_t handle,
+				       const uint8_t *k, unsigned int klen)
+{
+	struct tc_aes_cache_slot *slot = (struct tc_aes_cache_slot *) 0;
+	struct tc_aes_cache_slot *victim;
+	unsigned int i;
+
+	if (c == (TCAesCache_t) 0 || c->slot == (struct tc_aes_cache_slot *) 0) {
+		return slot;
+	}
+
+	for (i = 0; i < c->count; ++i) {
+		if (c->slot[i].state != 0 && c->slot[i].handle == handle) {
+			slot = &c->slot[i];
+			break;
+		}
+	}
+
+	if (slot != (struct tc_aes_cache_slot *) 0 &&
+	    k != (const uint8_t *) 0 && !key_matches(&slot->sched, k, klen)) {
+		/* the handle names another key now */
+		slot_erase(slot);
+		slot = (struct tc_aes_cache_slot *) 0;
+	}
+
+	if (slot == (struct tc_aes_cache_slot *) 0) {
+		if (k == (const uint8_t *) 0) {
+			return slot;
+		}
+		/* a free slot if any, else the least recently used one */
+		victim = &c->slot[0];
+		for (i = 0; i < c->count && victim->state != 0; ++i) {
+			if (c->slot[i].state == 0 ||
+			    c->clock - c->slot[i].stamp >
+			    c->clock - victim->stamp) {
+				victim = &c->slot[i];
+			}
+		}
+		slot_erase(victim);
+		if (tc_aes_set_encrypt_key(&victim->sched, k, klen) == 0) {
+			slot_erase(victim);
+			return slot;
+		}
+		victim->handle = handle;
+		victim->state = SLOT_USED;
+		slot = victim;
+	}
+
+	slot->stamp = ++c->clock;
+	return slot;
+}
+
+int tc_aes_cache_init(TCAesCache_t c, struct tc_aes_cache_slot *slots,
+		      unsigned int count)
+{
+	if (c == (TCAesCache_t) 0 ||
+	    slots == (struct tc_aes_cache_slot *) 0 ||
+	    count == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	_set(slots, 0, count * sizeof(slots[0]));
+	c->slot = slots;
+	c->count = count;
+	c->clock = 0;
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_aes_cache_encrypt_key(TCAesKeySched_t *sched, TCAesCache_t c,
+			     uint32_t handle, const uint8_t *k,
+			     unsigned int klen)
+{
+	struct tc_aes_cache_slot *slot;
+
+	if (sched == (TCAesKeySched_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	slot = fetch(c, handle, k, klen);
+	if (slot == (struct tc_aes_cache_slot *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	*sched = &slot->sched;
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_aes_cache_decrypt_key(TCAesKeySched_t *sched, TCAesCache_t c,
+			     uint32_t handle, const uint8_t *k,
+			     unsigned int klen)
+{
+	struct tc_aes_cache_slot *slot;
+
+	if (sched == (TCAesKeySched_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	slot = fetch(c, handle, k, klen);
+	if (slot == (struct tc_aes_cache_slot *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	if (TC_AES_INV_WORDS(&slot->sched) == (const unsigned int *) 0) {
+		(void)tc_aes_prepare_decrypt(&slot->sched);
+	}
+
+	*sched = &slot->sched;
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_aes_cache_evict(TCAesCache_t c, uint32_t handle)
+{
+	unsigned int i;
+
+	if (c == (TCAesCache_t) 0 || c->slot == (struct tc_aes_cache_slot *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	for (i = 0; i < c->count; ++i) {
+		if (c->slot[i].state != 0 && c->slot[i].handle == handle) {
+			slot_erase(&c->slot[i]);
+			return TC_CRYPTO_SUCCESS;
+		}
+	}
+	return TC_CRYPTO_FAIL;
+}
+
+void tc_aes_cache_erase(TCAesCache_t c)
+{
+	if (c != (TCAesCache_t) 0 &&
+	    c->slot != (struct tc_aes_cache_slot *) 0) {
+		_set_secure(c->slot, 0, c->count * sizeof(c->slot[0]));
+		c->slot = (struct tc_aes_cache_slot *) 0;
+		c->count = 0;
+	}
+}
@@ -32,7 +32,14 @@
 
 #include <tinycrypt/aes.h>
 #include <tinycrypt/constants.h>
+#include <tinycrypt/accel.h>
 #include <tinycrypt/utils.h>
+#if defined(TINYCRYPT_AES_HW)
+#include <tinycrypt/aes_hw.h>
+#endif
+#if defined(TINYCRYPT_AES_BITSLICE)
+#include <tinycrypt/aes_bitslice.h>
+#endif
 
 static const uint8_t inv_sbox[256] = {
 	0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e,
@@ -59,77 +66,159 @@ static const uint8_t inv_sbox[256] = {
 	0x55, 0x21, 0x0c, 0x7d
 };
 
+int tc_aes_set_decrypt_key(TCAesKeySched_t s, const uint8_t *k,
+			   unsigned int klen)
+{
+	if (tc_aes_set_encrypt_key(s, k, klen) == TC_CRYPTO_FAIL) {
+		return TC_CRYPTO_FAIL;
+	}
+	return tc_aes_prepare_decrypt(s);
+}
+
 int tc_aes128_set_decrypt_key(TCAesKeySched_t s, const uint8_t *k)
 {
-	return tc_aes128_set_encrypt_key(s, k);
+	return tc_aes_set_decrypt_key(s, k, TC_AES_KEY_SIZE);
 }
 
-#define mult8(a)(_double_byte(_double_byte(_double_byte(a))))
-#define mult9(a)(mult8(a)^(a))
-#define multb(a)(mult8(a)^_double_byte(a)^(a))
-#define multd(a)(mult8(a)^_double_byte(_double_byte(a))^(a))
-#define multe(a)(mult8(a)^_double_byte(_double_byte(a))^_double_byte(a))
+/*
+ * Decryption runs the equivalent inverse cipher (FIPS-197 Figure 15) on
+ * 32-bit columns, packed like the schedule words (row 0 in the most
+ * significant byte). Its first and last round keys are those of the
+ * encryption schedule, its middle ones InvMixColumns of the encryption ones.
+ * With TINYCRYPT_AES_INV_KEYS, tc_aes_prepare_decrypt stores the latter in
+ * the schedule; otherwise, or for a schedule set up for encryption only,
+ * inverse_keys derives them on the stack once per call.
+ * InvMixColumns only uses shifts and XORs, so, as with the straightforward
+ * inverse cipher, the only data-dependent memory accesses are the inv_sbox
+ * lookups.
+ */
 
-static inline void mult_row_column(uint8_t *out, const uint8_t *in)
+/* multiplies the four bytes of w by x in GF(2^8) */
+static inline uint32_t xtime_word(uint32_t w)
 {
-	out[0] = multe(in[0]) ^ multb(in[1]) ^ multd(in[2]) ^ mult9(in[3]);
-	out[1] = mult9(in[0]) ^ multe(in[1]) ^ multb(in[2]) ^ multd(in[3]);
-	out[2] = multd(in[0]) ^ mult9(in[1]) ^ multe(in[2]) ^ multb(in[3]);
-	out[3] = multb(in[0]) ^ multd(in[1]) ^ mult9(in[2]) ^ multe(in[3]);
+	return ((w & 0x7f7f7f7fU) << 1) ^ (((w >> 7) & 0x01010101U) * 0x1b);
 }
 
-static inline void inv_mix_columns(uint8_t *s)
+static inline uint32_t rotl8(uint32_t w)
 {
-	uint8_t t[Nb*Nk];
+	return (w << 8) | (w >> 24);
+}
 
-	mult_row_column(t, s);
-	mult_row_column(&t[Nb], s+Nb);
-	mult_row_column(&t[2*Nb], s+(2*Nb));
-	mult_row_column(&t[3*Nb], s+(3*Nb));
-	(void)_copy(s, sizeof(t), t, sizeof(t));
+static inline uint32_t rotl16(uint32_t w)
+{
+	return (w << 16) | (w >> 16);
 }
 
-static inline void add_round_key(uint8_t *s, const unsigned int *k)
+/*
+ * InvMixColumns of one column, as MixColumns of the column with
+ * {04}.(a0 ^ a2) added to rows 0 and 2 and {04}.(a1 ^ a3) to rows 1 and 3.
+ */
+static inline uint32_t inv_mix_column(uint32_t w)
 {
-	s[0] ^= (uint8_t)(k[0] >> 24); s[1] ^= (uint8_t)(k[0] >> 16);
-	s[2] ^= (uint8_t)(k[0] >> 8); s[3] ^= (uint8_t)(k[0]);
-	s[4] ^= (uint8_t)(k[1] >> 24); s[5] ^= (uint8_t)(k[1] >> 16);
-	s[6] ^= (uint8_t)(k[1] >> 8); s[7] ^= (uint8_t)(k[1]);
-	s[8] ^= (uint8_t)(k[2] >> 24); s[9] ^= (uint8_t)(k[2] >> 16);
-	s[10] ^= (uint8_t)(k[2] >> 8); s[11] ^= (uint8_t)(k[2]);
-	s[12] ^= (uint8_t)(k[3] >> 24); s[13] ^= (uint8_t)(k[3] >> 16);
-	s[14] ^= (uint8_t)(k[3] >> 8); s[15] ^= (uint8_t)(k[3]);
+	uint32_t t;
+
+	w ^= xtime_word(xtime_word(w ^ rotl16(w)));
+	t = w ^ rotl8(w);
+	return xtime_word(t) ^ rotl8(w) ^ rotl16(t);
 }
 
-static inline void inv_sub_bytes(uint8_t *s)
+#define inv_sub_byte(w, o) ((uint32_t) inv_sbox[((w) >> (o)) & 0xff] << (o))
+
+/* InvShiftRows and InvSubBytes of the state t into column c */
+#define inv_sub_shift(t, c) \
+	(inv_sub_byte((t)[(c)], 24) | inv_sub_byte((t)[((c) + 3) & 3], 16) | \
+	 inv_sub_byte((t)[((c) + 2) & 3], 8) | inv_sub_byte((t)[((c) + 1) & 3], 0))
+
+static void inverse_keys(unsigned int *inv, const TCAesKeySched_t s)
 {
 	unsigned int i;
 
-	for (i = 0; i < (Nb*Nk); ++i) {
-		s[i] = inv_sbox[s[i]];
+	for (i = Nb; i < Nb*TC_AES_ROUNDS(s); ++i) {
+		inv[i - Nb] = inv_mix_column(s->words[i]);
 	}
 }
 
-/*
- * This inv_shift_rows also implements the matrix flip required for
- * inv_mix_columns, but performs it here to reduce the number of memory
- * operations.
- */
-static inline void inv_shift_rows(uint8_t *s)
+static inline uint32_t load_column(const uint8_t *in)
 {
-	uint8_t t[Nb*Nk];
+	return ((uint32_t) in[0] << 24) | ((uint32_t) in[1] << 16) |
+	       ((uint32_t) in[2] << 8) | (uint32_t) in[3];
+}
 
-	t[0]  = s[0]; t[1] = s[13]; t[2] = s[10]; t[3] = s[7];
-	t[4]  = s[4]; t[5] = s[1]; t[6] = s[14]; t[7] = s[11];
-	t[8]  = s[8]; t[9] = s[5]; t[10] = s[2]; t[11] = s[15];
-	t[12] = s[12]; t[13] = s[9]; t[14] = s[6]; t[15] = s[3];
-	(void)_copy(s, sizeof(t), t, sizeof(t));
+static inline void store_column(uint8_t *out, uint32_t w)
+{
+	out[0] = (uint8_t)(w >> 24);
+	out[1] = (uint8_t)(w >> 16);
+	out[2] = (uint8_t)(w >> 8);
+	out[3] = (uint8_t)(w);
 }
 
-int tc_aes_decrypt(uint8_t *out, const uint8_t *in, const TCAesKeySched_t s)
+/* decrypts with the first and last round keys of ek, the others of inv */
+static void decrypt_block(uint8_t *out, const uint8_t *in,
+			  const unsigned int *ek, const unsigned int *inv,
+			  unsigned int rounds)
 {
-	uint8_t state[Nk*Nb];
+	uint32_t state[Nb];
+	uint32_t t[Nb];
 	unsigned int i;
+	unsigned int c;
+
+	for (c = 0; c < Nb; ++c) {
+		state[c] = load_column(in + Nb*c) ^ ek[Nb*rounds + c];
+	}
+
+	for (i = rounds - 1; i > 0; --i) {
+		for (c = 0; c < Nb; ++c) {
+			t[c] = state[c];
+		}
+		for (c = 0; c < Nb; ++c) {
+			state[c] = inv_mix_column(inv_sub_shift(t, c)) ^
+				   inv[Nb*(i - 1) + c];
+		}
+	}
+
+	for (c = 0; c < Nb; ++c) {
+		t[c] = state[c];
+	}
+	for (c = 0; c < Nb; ++c) {
+		store_column(out + Nb*c, inv_sub_shift(t, c) ^ ek[c]);
+	}
+
+	/*zeroing out the state buffers */
+	_set(state, TC_ZERO_BYTE, sizeof(state));
+	_set(t, TC_ZERO_BYTE, sizeof(t));
+}
+
+int tc_aes_prepare_decrypt(TCAesKeySched_t s)
+{
+	if (s == (TCAesKeySched_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+#if defined(TINYCRYPT_AES_INV_KEYS)
+	inverse_keys(s->inv_words, s);
+	s->inv_ready = 1;
+#endif
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+/* the middle decryption round keys of s, derived into tmp if s has none */
+static const unsigned int *decrypt_keys(unsigned int *tmp,
+					const TCAesKeySched_t s)
+{
+	const unsigned int *inv = TC_AES_INV_WORDS(s);
+
+	if (inv != (const unsigned int *) 0) {
+		return inv;
+	}
+	inverse_keys(tmp, s);
+	return tmp;
+}
+
+int tc_aes_decrypt(uint8_t *out, const uint8_t *in, const TCAesKeySched_t s)
+{
+	unsigned int tmp[Nb*(TC_AES_MAX_ROUNDS-1)];
+	const unsigned int *inv;
 
 	if (out == (uint8_t *) 0) {
 		return TC_CRYPTO_FAIL;
@@ -139,26 +228,89 @@ int tc_aes_decrypt(uint8_t *out, const uint8_t *in, const TCAesKeySched_t s)
 		return TC_CRYPTO_FAIL;
 	}
 
-	(void)_copy(state, sizeof(state), in, sizeof(state));
+#if defined(TINYCRYPT_ACCEL)
+	if (tc_accel_aes_decrypt(out, in, s)) {
+		return TC_CRYPTO_SUCCESS;
+	}
+#endif
+#if defined(TINYCRYPT_AES_HW)
+	if (tc_aes_hw_available()) {
+		return tc_aes_hw_decrypt(out, in, s);
+	}
+#endif
+
+	inv = decrypt_keys(tmp, s);
+	decrypt_block(out, in, s->words, inv, TC_AES_ROUNDS(s));
+	if (inv == tmp) {
+		_set(tmp, TC_ZERO_BYTE, sizeof(tmp));
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
 
-	add_round_key(state, s->words + Nb*Nr);
+int tc_aes_decrypt_blocks(uint8_t *out, const uint8_t *in,
+			  unsigned int nblocks, const TCAesKeySched_t s)
+{
+	unsigned int tmp[Nb*(TC_AES_MAX_ROUNDS-1)];
+	const unsigned int *inv;
+	unsigned int i;
 
-	for (i = Nr - 1; i > 0; --i) {
-		inv_shift_rows(state);
-		inv_sub_bytes(state);
-		add_round_key(state, s->words + Nb*i);
-		inv_mix_columns(state);
+	if (out == (uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (in == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (s == (TCAesKeySched_t) 0) {
+		return TC_CRYPTO_FAIL;
 	}
 
-	inv_shift_rows(state);
-	inv_sub_bytes(state);
-	add_round_key(state, s->words);
+#if defined(TINYCRYPT_ACCEL)
+	if (tc_accel_aes_decrypt_blocks(out, in, nblocks, s)) {
+		return TC_CRYPTO_SUCCESS;
+	}
+#endif
+#if defined(TINYCRYPT_AES_HW)
+	if (tc_aes_hw_available()) {
+		return tc_aes_hw_decrypt_blocks(out, in, nblocks, s);
+	}
+#endif
+#if defined(TINYCRYPT_AES_BITSLICE)
+	return tc_aes_bitslice_decrypt_blocks(out, in, nblocks, s);
+#endif
 
-	(void)_copy(out, sizeof(state), state, sizeof(state));
+	inv = decrypt_keys(tmp, s);
+	for (i = 0; i < nblocks; ++i) {
+		decrypt_block(out, in, s->words, inv, TC_AES_ROUNDS(s));
+		out += TC_AES_BLOCK_SIZE;
+		in += TC_AES_BLOCK_SIZE;
+	}
+	if (inv == tmp) {
+		_set(tmp, TC_ZERO_BYTE, sizeof(tmp));
+	}
 
-	/*zeroing out the state buffer */
-	_set(state, TC_ZERO_BYTE, sizeof(state));
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_aes_decrypt_blocks_async(uint8_t *out, const uint8_t *in,
+				unsigned int nblocks, const TCAesKeySched_t s,
+				tc_accel_done_t done, void *arg)
+{
+	if (out == (uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (in == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (s == (TCAesKeySched_t) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (done == (tc_accel_done_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+#if defined(TINYCRYPT_ACCEL)
+	if (tc_accel_aes_decrypt_blocks_async(out, in, nblocks, s, done, arg)) {
+		return TC_CRYPTO_SUCCESS;
+	}
+#endif
 
+	done(arg, tc_aes_decrypt_blocks(out, in, nblocks, s));
 
 	return TC_CRYPTO_SUCCESS;
 }
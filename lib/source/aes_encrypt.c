@@ -33,6 +33,13 @@
 #include <tinycrypt/aes.h>
 #include <tinycrypt/utils.h>
 #include <tinycrypt/constants.h>
+#include <tinycrypt/accel.h>
+#if defined(TINYCRYPT_AES_HW)
+#include <tinycrypt/aes_hw.h>
+#endif
+#if defined(TINYCRYPT_AES_BITSLICE)
+#include <tinycrypt/aes_bitslice.h>
+#endif
 
 static const uint8_t sbox[256] = {
 	0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b,
@@ -67,12 +74,14 @@ static inline unsigned int rotword(unsigned int a)
 #define subbyte(a, o)(sbox[((a) >> (o))&0xff] << (o))
 #define subword(a)(subbyte(a, 24)|subbyte(a, 16)|subbyte(a, 8)|subbyte(a, 0))
 
-int tc_aes128_set_encrypt_key(TCAesKeySched_t s, const uint8_t *k)
+int tc_aes_set_encrypt_key(TCAesKeySched_t s, const uint8_t *k,
+			   unsigned int klen)
 {
 	const unsigned int rconst[11] = {
 		0x00000000, 0x01000000, 0x02000000, 0x04000000, 0x08000000, 0x10000000,
 		0x20000000, 0x40000000, 0x80000000, 0x1b000000, 0x36000000
 	};
+	unsigned int nk;
 	unsigned int i;
 	unsigned int t;
 
@@ -80,24 +89,49 @@ int tc_aes128_set_encrypt_key(TCAesKeySched_t s, const uint8_t *k)
 		return TC_CRYPTO_FAIL;
 	} else if (k == (const uint8_t *) 0) {
 		return TC_CRYPTO_FAIL;
+	} else if (klen != TC_AES_KEY_SIZE
+#if !defined(TINYCRYPT_AES_128_ONLY)
+		   && klen != TC_AES_192_KEY_SIZE && klen != TC_AES_256_KEY_SIZE
+#endif
+		   ) {
+		return TC_CRYPTO_FAIL;
 	}
 
-	for (i = 0; i < Nk; ++i) {
+	/* Nk = 4, 6 or 8 words of key run Nk + 6 rounds: */
+	nk = klen / Nb;
+	s->extra_rounds = nk + 6 - Nr;
+
+	for (i = 0; i < nk; ++i) {
 		s->words[i] = (k[Nb*i]<<24) | (k[Nb*i+1]<<16) |
 			      (k[Nb*i+2]<<8) | (k[Nb*i+3]);
 	}
 
-	for (; i < (Nb * (Nr + 1)); ++i) {
+	for (; i < (Nb * (TC_AES_ROUNDS(s) + 1)); ++i) {
 		t = s->words[i-1];
-		if ((i % Nk) == 0) {
-			t = subword(rotword(t)) ^ rconst[i/Nk];
+		if ((i % nk) == 0) {
+			t = subword(rotword(t)) ^ rconst[i/nk];
+		} else if (nk > 6 && (i % nk) == 4) {
+			t = subword(t);
 		}
-		s->words[i] = s->words[i-Nk] ^ t;
+		s->words[i] = s->words[i-nk] ^ t;
 	}
 
+	/* clear whatever a longer key may have left in the unused words */
+	_set(&s->words[i], 0, sizeof(s->words) - i * sizeof(s->words[0]));
+#if defined(TINYCRYPT_AES_INV_KEYS)
+	/* and the decryption round keys of the previous key */
+	_set(s->inv_words, 0, sizeof(s->inv_words));
+	s->inv_ready = 0;
+#endif
+
 	return TC_CRYPTO_SUCCESS;
 }
 
+int tc_aes128_set_encrypt_key(TCAesKeySched_t s, const uint8_t *k)
+{
+	return tc_aes_set_encrypt_key(s, k, TC_AES_KEY_SIZE);
+}
+
 static inline void add_round_key(uint8_t *s, const unsigned int *k)
 {
 	s[0] ^= (uint8_t)(k[0] >> 24); s[1] ^= (uint8_t)(k[0] >> 16);
@@ -155,23 +189,16 @@ static inline void shift_rows(uint8_t *s)
 	(void) _copy(s, sizeof(t), t, sizeof(t));
 }
 
-int tc_aes_encrypt(uint8_t *out, const uint8_t *in, const TCAesKeySched_t s)
+static void encrypt_block(uint8_t *out, const uint8_t *in,
+			  const TCAesKeySched_t s)
 {
 	uint8_t state[Nk*Nb];
 	unsigned int i;
 
-	if (out == (uint8_t *) 0) {
-		return TC_CRYPTO_FAIL;
-	} else if (in == (const uint8_t *) 0) {
-		return TC_CRYPTO_FAIL;
-	} else if (s == (TCAesKeySched_t) 0) {
-		return TC_CRYPTO_FAIL;
-	}
-
 	(void)_copy(state, sizeof(state), in, sizeof(state));
 	add_round_key(state, s->words);
 
-	for (i = 0; i < (Nr - 1); ++i) {
+	for (i = 0; i < (TC_AES_ROUNDS(s) - 1); ++i) {
 		sub_bytes(state);
 		shift_rows(state);
 		mix_columns(state);
@@ -186,6 +213,91 @@ int tc_aes_encrypt(uint8_t *out, const uint8_t *in, const TCAesKeySched_t s)
 
 	/* zeroing out the state buffer */
 	_set(state, TC_ZERO_BYTE, sizeof(state));
+}
+
+int tc_aes_encrypt(uint8_t *out, const uint8_t *in, const TCAesKeySched_t s)
+{
+	if (out == (uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (in == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (s == (TCAesKeySched_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+#if defined(TINYCRYPT_ACCEL)
+	if (tc_accel_aes_encrypt(out, in, s)) {
+		return TC_CRYPTO_SUCCESS;
+	}
+#endif
+#if defined(TINYCRYPT_AES_HW)
+	if (tc_aes_hw_available()) {
+		return tc_aes_hw_encrypt(out, in, s);
+	}
+#endif
+
+	encrypt_block(out, in, s);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_aes_encrypt_blocks(uint8_t *out, const uint8_t *in,
+			  unsigned int nblocks, const TCAesKeySched_t s)
+{
+	unsigned int i;
+
+	if (out == (uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (in == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (s == (TCAesKeySched_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+#if defined(TINYCRYPT_ACCEL)
+	if (tc_accel_aes_encrypt_blocks(out, in, nblocks, s)) {
+		return TC_CRYPTO_SUCCESS;
+	}
+#endif
+#if defined(TINYCRYPT_AES_HW)
+	if (tc_aes_hw_available()) {
+		return tc_aes_hw_encrypt_blocks(out, in, nblocks, s);
+	}
+#endif
+#if defined(TINYCRYPT_AES_BITSLICE)
+	return tc_aes_bitslice_encrypt_blocks(out, in, nblocks, s);
+#endif
+
+	for (i = 0; i < nblocks; ++i) {
+		encrypt_block(out, in, s);
+		out += TC_AES_BLOCK_SIZE;
+		in += TC_AES_BLOCK_SIZE;
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_aes_encrypt_blocks_async(uint8_t *out, const uint8_t *in,
+				unsigned int nblocks, const TCAesKeySched_t s,
+				tc_accel_done_t done, void *arg)
+{
+	if (out == (uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (in == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (s == (TCAesKeySched_t) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (done == (tc_accel_done_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+#if defined(TINYCRYPT_ACCEL)
+	if (tc_accel_aes_encrypt_blocks_async(out, in, nblocks, s, done, arg)) {
+		return TC_CRYPTO_SUCCESS;
+	}
+#endif
+
+	done(arg, tc_aes_encrypt_blocks(out, in, nblocks, s));
 
 	return TC_CRYPTO_SUCCESS;
 }
@@ -0,0 +1,421 @@
+/* aes_hw.c - TinyCrypt implementation of the hardware accelerated AES engine */
+
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/aes_hw.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TC_AES_HW_X86
+#include <immintrin.h>
+#define TC_AES_HW_TARGET __attribute__((target("aes,ssse3")))
+#elif (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES)) && \
+      defined(__ARM_NEON)
+#define TC_AES_HW_ARM
+#include <arm_neon.h>
+#endif
+
+#if defined(TC_AES_HW_X86)
+
+/*
+ * The key schedule holds each round key as four words whose most significant
+ * byte comes first; loading them little-endian reverses every 32-bit lane, so
+ * a byte shuffle puts the round key back into AES byte order.
+ */
+TC_AES_HW_TARGET
+static inline __m128i load_round_key(const unsigned int *w)
+{
+	const __m128i bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11,
+					   4, 5, 6, 7, 0, 1, 2, 3);
+
+	return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) w), bswap);
+}
+
+TC_AES_HW_TARGET
+static void encrypt_block(uint8_t *out, const uint8_t *in,
+			  const unsigned int *w, unsigned int rounds)
+{
+	__m128i b = _mm_loadu_si128((const __m128i *) in);
+	unsigned int i;
+
+	b = _mm_xor_si128(b, load_round_key(w));
+	for (i = 1; i < rounds; ++i) {
+		b = _mm_aesenc_si128(b, load_round_key(w + Nb*i));
+	}
+	b = _mm_aesenclast_si128(b, load_round_key(w + Nb*rounds));
+	_mm_storeu_si128((__m128i *) out, b);
+}
+
+/* Four independent blocks in flight hide the latency of AESENC. */
+TC_AES_HW_TARGET
+static void encrypt_4_blocks(uint8_t *out, const uint8_t *in,
+			     const unsigned int *w, unsigned int rounds)
+{
+	__m128i k = load_round_key(w);
+	__m128i b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in), k);
+	__m128i b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in + 1), k);
+	__m128i b2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in + 2), k);
+	__m128i b3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in + 3), k);
+	unsigned int i;
+
+	for (i = 1; i < rounds; ++i) {
+		k = load_round_key(w + Nb*i);
+		b0 = _mm_aesenc_si128(b0, k);
+		b1 = _mm_aesenc_si128(b1, k);
+		b2 = _mm_aesenc_si128(b2, k);
+		b3 = _mm_aesenc_si128(b3, k);
+	}
+	k = load_round_key(w + Nb*rounds);
+	_mm_storeu_si128((__m128i *) out, _mm_aesenclast_si128(b0, k));
+	_mm_storeu_si128((__m128i *) out + 1, _mm_aesenclast_si128(b1, k));
+	_mm_storeu_si128((__m128i *) out + 2, _mm_aesenclast_si128(b2, k));
+	_mm_storeu_si128((__m128i *) out + 3, _mm_aesenclast_si128(b3, k));
+}
+
+/* Two blocks, e.g. the CBC-MAC and CTR blocks of one CCM step. */
+TC_AES_HW_TARGET
+static void encrypt_2_blocks(uint8_t *out, const uint8_t *in,
+			     const unsigned int *w, unsigned int rounds)
+{
+	__m128i k = load_round_key(w);
+	__m128i b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in), k);
+	__m128i b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in + 1), k);
+	unsigned int i;
+
+	for (i = 1; i < rounds; ++i) {
+		k = load_round_key(w + Nb*i);
+		b0 = _mm_aesenc_si128(b0, k);
+		b1 = _mm_aesenc_si128(b1, k);
+	}
+	k = load_round_key(w + Nb*rounds);
+	_mm_storeu_si128((__m128i *) out, _mm_aesenclast_si128(b0, k));
+	_mm_storeu_si128((__m128i *) out + 1, _mm_aesenclast_si128(b1, k));
+}
+
+/*
+ * AESDEC implements the rounds of the equivalent inverse cipher, whose round
+ * keys are InvMixColumns of the encryption round keys. They are those of inv,
+ * stored by tc_aes_prepare_decrypt, if the schedule has them, and otherwise
+ * derived on the fly with AESIMC, so the same schedule serves both
+ * directions.
+ */
+TC_AES_HW_TARGET
+static inline __m128i decrypt_round_key(const unsigned int *w,
+					const unsigned int *inv,
+					unsigned int i)
+{
+	if (inv != (const unsigned int *) 0) {
+		return load_round_key(inv + Nb*(i - 1));
+	}
+	return _mm_aesimc_si128(load_round_key(w + Nb*i));
+}
+
+TC_AES_HW_TARGET
+static void decrypt_block(uint8_t *out, const uint8_t *in,
+			  const unsigned int *w, const unsigned int *inv,
+			  unsigned int rounds)
+{
+	__m128i b = _mm_loadu_si128((const __m128i *) in);
+	unsigned int i;
+
+	b = _mm_xor_si128(b, load_round_key(w + Nb*rounds));
+	for (i = rounds - 1; i > 0; --i) {
+		b = _mm_aesdec_si128(b, decrypt_round_key(w, inv, i));
+	}
+	b = _mm_aesdeclast_si128(b, load_round_key(w));
+	_mm_storeu_si128((__m128i *) out, b);
+}
+
+TC_AES_HW_TARGET
+static void decrypt_4_blocks(uint8_t *out, const uint8_t *in,
+			     const unsigned int *w, const unsigned int *inv,
+			     unsigned int rounds)
+{
+	__m128i k = load_round_key(w + Nb*rounds);
+	__m128i b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in), k);
+	__m128i b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in + 1), k);
+	__m128i b2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in + 2), k);
+	__m128i b3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in + 3), k);
+	unsigned int i;
+
+	for (i = rounds - 1; i > 0; --i) {
+		k = decrypt_round_key(w, inv, i);
+		b0 = _mm_aesdec_si128(b0, k);
+		b1 = _mm_aesdec_si128(b1, k);
+		b2 = _mm_aesdec_si128(b2, k);
+		b3 = _mm_aesdec_si128(b3, k);
+	}
+	k = load_round_key(w);
+	_mm_storeu_si128((__m128i *) out, _mm_aesdeclast_si128(b0, k));
+	_mm_storeu_si128((__m128i *) out + 1, _mm_aesdeclast_si128(b1, k));
+	_mm_storeu_si128((__m128i *) out + 2, _mm_aesdeclast_si128(b2, k));
+	_mm_storeu_si128((__m128i *) out + 3, _mm_aesdeclast_si128(b3, k));
+}
+
+#elif defined(TC_AES_HW_ARM)
+
+static inline uint8x16_t load_round_key(const unsigned int *w)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	return vld1q_u8((const uint8_t *) w);
+#else
+	return vrev32q_u8(vld1q_u8((const uint8_t *) w));
+#endif
+}
+
+/* AESE performs AddRoundKey, SubBytes and ShiftRows; AESMC is MixColumns. */
+static void encrypt_block(uint8_t *out, const uint8_t *in,
+			  const unsigned int *w, unsigned int rounds)
+{
+	uint8x16_t b = vld1q_u8(in);
+	unsigned int i;
+
+	for (i = 0; i < rounds - 1; ++i) {
+		b = vaesmcq_u8(vaeseq_u8(b, load_round_key(w + Nb*i)));
+	}
+	b = vaeseq_u8(b, load_round_key(w + Nb*(rounds - 1)));
+	b = veorq_u8(b, load_round_key(w + Nb*rounds));
+	vst1q_u8(out, b);
+}
+
+/* Four independent blocks in flight hide the latency of AESE/AESMC. */
+static void encrypt_4_blocks(uint8_t *out, const uint8_t *in,
+			     const unsigned int *w, unsigned int rounds)
+{
+	uint8x16_t b0 = vld1q_u8(in);
+	uint8x16_t b1 = vld1q_u8(in + 16);
+	uint8x16_t b2 = vld1q_u8(in + 32);
+	uint8x16_t b3 = vld1q_u8(in + 48);
+	uint8x16_t k;
+	unsigned int i;
+
+	for (i = 0; i < rounds - 1; ++i) {
+		k = load_round_key(w + Nb*i);
+		b0 = vaesmcq_u8(vaeseq_u8(b0, k));
+		b1 = vaesmcq_u8(vaeseq_u8(b1, k));
+		b2 = vaesmcq_u8(vaeseq_u8(b2, k));
+		b3 = vaesmcq_u8(vaeseq_u8(b3, k));
+	}
+	k = load_round_key(w + Nb*(rounds - 1));
+	b0 = vaeseq_u8(b0, k);
+	b1 = vaeseq_u8(b1, k);
+	b2 = vaeseq_u8(b2, k);
+	b3 = vaeseq_u8(b3, k);
+	k = load_round_key(w + Nb*rounds);
+	vst1q_u8(out, veorq_u8(b0, k));
+	vst1q_u8(out + 16, veorq_u8(b1, k));
+	vst1q_u8(out + 32, veorq_u8(b2, k));
+	vst1q_u8(out + 48, veorq_u8(b3, k));
+}
+
+/* Two blocks, e.g. the CBC-MAC and CTR blocks of one CCM step. */
+static void encrypt_2_blocks(uint8_t *out, const uint8_t *in,
+			     const unsigned int *w, unsigned int rounds)
+{
+	uint8x16_t b0 = vld1q_u8(in);
+	uint8x16_t b1 = vld1q_u8(in + 16);
+	uint8x16_t k;
+	unsigned int i;
+
+	for (i = 0; i < rounds - 1; ++i) {
+		k = load_round_key(w + Nb*i);
+		b0 = vaesmcq_u8(vaeseq_u8(b0, k));
+		b1 = vaesmcq_u8(vaeseq_u8(b1, k));
+	}
+	k = load_round_key(w + Nb*(rounds - 1));
+	b0 = vaeseq_u8(b0, k);
+	b1 = vaeseq_u8(b1, k);
+	k = load_round_key(w + Nb*rounds);
+	vst1q_u8(out, veorq_u8(b0, k));
+	vst1q_u8(out + 16, veorq_u8(b1, k));
+}
+
+/*
+ * AESD performs AddRoundKey, InvShiftRows and InvSubBytes; AESIMC is
+ * InvMixColumns, which also turns the encryption round keys into those of
+ * the equivalent inverse cipher when the schedule has none stored in inv.
+ */
+static inline uint8x16_t decrypt_round_key(const unsigned int *w,
+					   const unsigned int *inv,
+					   unsigned int i)
+{
+	if (inv != (const unsigned int *) 0) {
+		return load_round_key(inv + Nb*(i - 1));
+	}
+	return vaesimcq_u8(load_round_key(w + Nb*i));
+}
+
+static void decrypt_block(uint8_t *out, const uint8_t *in,
+			  const unsigned int *w, const unsigned int *inv,
+			  unsigned int rounds)
+{
+	uint8x16_t b = vld1q_u8(in);
+	unsigned int i;
+
+	b = vaesimcq_u8(vaesdq_u8(b, load_round_key(w + Nb*rounds)));
+	for (i = rounds - 1; i > 1; --i) {
+		b = vaesimcq_u8(vaesdq_u8(b, decrypt_round_key(w, inv, i)));
+	}
+	b = vaesdq_u8(b, decrypt_round_key(w, inv, 1));
+	b = veorq_u8(b, load_round_key(w));
+	vst1q_u8(out, b);
+}
+
+static void decrypt_4_blocks(uint8_t *out, const uint8_t *in,
+			     const unsigned int *w, const unsigned int *inv,
+			     unsigned int rounds)
+{
+	uint8x16_t b0 = vld1q_u8(in);
+	uint8x16_t b1 = vld1q_u8(in + 16);
+	uint8x16_t b2 = vld1q_u8(in + 32);
+	uint8x16_t b3 = vld1q_u8(in + 48);
+	uint8x16_t k = load_round_key(w + Nb*rounds);
+	unsigned int i;
+
+	b0 = vaesimcq_u8(vaesdq_u8(b0, k));
+	b1 = vaesimcq_u8(vaesdq_u8(b1, k));
+	b2 = vaesimcq_u8(vaesdq_u8(b2, k));
+	b3 = vaesimcq_u8(vaesdq_u8(b3, k));
+	for (i = rounds - 1; i > 1; --i) {
+		k = decrypt_round_key(w, inv, i);
+		b0 = vaesimcq_u8(vaesdq_u8(b0, k));
+		b1 = vaesimcq_u8(vaesdq_u8(b1, k));
+		b2 = vaesimcq_u8(vaesdq_u8(b2, k));
+		b3 = vaesimcq_u8(vaesdq_u8(b3, k));
+	}
+	k = decrypt_round_key(w, inv, 1);
+	b0 = vaesdq_u8(b0, k);
+	b1 = vaesdq_u8(b1, k);
+	b2 = vaesdq_u8(b2, k);
+	b3 = vaesdq_u8(b3, k);
+	k = load_round_key(w);
+	vst1q_u8(out, veorq_u8(b0, k));
+	vst1q_u8(out + 16, veorq_u8(b1, k));
+	vst1q_u8(out + 32, veorq_u8(b2, k));
+	vst1q_u8(out + 48, veorq_u8(b3, k));
+}
+
+#endif
+
+int tc_aes_hw_available(void)
+{
+#if defined(TC_AES_HW_X86) || defined(TC_AES_HW_ARM)
+	return (_cpu_features() & TC_CPU_AES) != 0;
+#else
+	return 0;
+#endif
+}
+
+int tc_aes_hw_encrypt(uint8_t *out, const uint8_t *in,
+		      const TCAesKeySched_t s)
+{
+#if defined(TC_AES_HW_X86) || defined(TC_AES_HW_ARM)
+	encrypt_block(out, in, s->words, TC_AES_ROUNDS(s));
+	return TC_CRYPTO_SUCCESS;
+#else
+	(void) out;
+	(void) in;
+	(void) s;
+	return TC_CRYPTO_FAIL;
+#endif
+}
+
+int tc_aes_hw_encrypt_blocks(uint8_t *out, const uint8_t *in,
+			     unsigned int nblocks, const TCAesKeySched_t s)
+{
+#if defined(TC_AES_HW_X86) || defined(TC_AES_HW_ARM)
+	for (; nblocks >= 4; nblocks -= 4) {
+		encrypt_4_blocks(out, in, s->words, TC_AES_ROUNDS(s));
+		out += 4 * TC_AES_BLOCK_SIZE;
+		in += 4 * TC_AES_BLOCK_SIZE;
+	}
+	if (nblocks >= 2) {
+		encrypt_2_blocks(out, in, s->words, TC_AES_ROUNDS(s));
+		out += 2 * TC_AES_BLOCK_SIZE;
+		in += 2 * TC_AES_BLOCK_SIZE;
+		nblocks -= 2;
+	}
+	for (; nblocks > 0; --nblocks) {
+		encrypt_block(out, in, s->words, TC_AES_ROUNDS(s));
+		out += TC_AES_BLOCK_SIZE;
+		in += TC_AES_BLOCK_SIZE;
+	}
+	return TC_CRYPTO_SUCCESS;
+#else
+	(void) out;
+	(void) in;
+	(void) nblocks;
+	(void) s;
+	return TC_CRYPTO_FAIL;
+#endif
+}
+
+int tc_aes_hw_decrypt(uint8_t *out, const uint8_t *in,
+		      const TCAesKeySched_t s)
+{
+#if defined(TC_AES_HW_X86) || defined(TC_AES_HW_ARM)
+	decrypt_block(out, in, s->words, TC_AES_INV_WORDS(s), TC_AES_ROUNDS(s));
+	return TC_CRYPTO_SUCCESS;
+#else
+	(void) out;
+	(void) in;
+	(void) s;
+	return TC_CRYPTO_FAIL;
+#endif
+}
+
+int tc_aes_hw_decrypt_blocks(uint8_t *out, const uint8_t *in,
+			     unsigned int nblocks, const TCAesKeySched_t s)
+{
+#if defined(TC_AES_HW_X86) || defined(TC_AES_HW_ARM)
+	const unsigned int *inv = TC_AES_INV_WORDS(s);
+
+	for (; nblocks >= 4; nblocks -= 4) {
+		decrypt_4_blocks(out, in, s->words, inv, TC_AES_ROUNDS(s));
+		out += 4 * TC_AES_BLOCK_SIZE;
+		in += 4 * TC_AES_BLOCK_SIZE;
+	}
+	for (; nblocks > 0; --nblocks) {
+		decrypt_block(out, in, s->words, inv, TC_AES_ROUNDS(s));
+		out += TC_AES_BLOCK_SIZE;
+		in += TC_AES_BLOCK_SIZE;
+	}
+	return TC_CRYPTO_SUCCESS;
+#else
+	(void) out;
+	(void) in;
+	(void) nblocks;
+	(void) s;
+	return TC_CRYPTO_FAIL;
+#endif
+}
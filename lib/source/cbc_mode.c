@@ -34,6 +34,31 @@
 #include <tinycrypt/constants.h>
 #include <tinycrypt/utils.h>
 
+#include <string.h>
+
+/*
+ * Number of ciphertext blocks deciphered together by tc_cbc_mode_decrypt;
+ * each batch takes 16 bytes of stack per block.
+ */
+#ifndef TINYCRYPT_CBC_BATCH_BLOCKS
+#define TINYCRYPT_CBC_BATCH_BLOCKS 8
+#endif
+
+/* out ^= in, len is a multiple of the word size */
+static inline void xor_words(uint8_t *out, const uint8_t *in,
+			     unsigned int len)
+{
+	uint32_t a, b;
+	unsigned int i;
+
+	for (i = 0; i < len; i += sizeof(a)) {
+		(void)memcpy(&a, out + i, sizeof(a));
+		(void)memcpy(&b, in + i, sizeof(b));
+		a ^= b;
+		(void)memcpy(out + i, &a, sizeof(a));
+	}
+}
+
 int tc_cbc_mode_encrypt(uint8_t *out, unsigned int outlen, const uint8_t *in,
 			    unsigned int inlen, const uint8_t *iv,
 			    const TCAesKeySched_t sched)
@@ -74,14 +99,89 @@ int tc_cbc_mode_encrypt(uint8_t *out, unsigned int outlen, const uint8_t *in,
 	return TC_CRYPTO_SUCCESS;
 }
 
+/*
+ * Writes len bytes of data at offset *off of segment **out, moving on to the
+ * next segments as they fill up.
+ */
+static void iov_put(const struct tc_iovec **out, size_t *off,
+		    const uint8_t *data, size_t len)
+{
+	size_t n;
+
+	while (len > 0) {
+		if (*off == (*out)->len) {
+			++*out;
+			*off = 0;
+			continue;
+		}
+		n = (*out)->len - *off;
+		if (n > len) {
+			n = len;
+		}
+		(void)memcpy((uint8_t *)(*out)->base + *off, data, n);
+		*off += n;
+		data += n;
+		len -= n;
+	}
+}
+
+int tc_cbc_mode_encryptv(const struct tc_iovec *out, unsigned int outcnt,
+			 const struct tc_iovec *in, unsigned int incnt,
+			 const uint8_t *iv, const TCAesKeySched_t sched)
+{
+
+	uint8_t buffer[TC_AES_BLOCK_SIZE];
+	const uint8_t *p;
+	size_t out_off = 0;
+	size_t inlen;
+	size_t n;
+	unsigned int i, m;
+
+	/* input sanity check: */
+	if (out == (const struct tc_iovec *) 0 ||
+	    in == (const struct tc_iovec *) 0 ||
+	    iv == (const uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	inlen = tc_iov_length(in, incnt);
+	if (inlen == 0 ||
+	    (inlen % TC_AES_BLOCK_SIZE) != 0 ||
+	    tc_iov_length(out, outcnt) != inlen + TC_AES_BLOCK_SIZE) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* copy iv to the buffer and to the output */
+	(void)_copy(buffer, TC_AES_BLOCK_SIZE, iv, TC_AES_BLOCK_SIZE);
+	iov_put(&out, &out_off, iv, TC_AES_BLOCK_SIZE);
+
+	/* the partially xored block in buffer carries over between segments */
+	for (i = m = 0; i < incnt; ++i) {
+		p = (const uint8_t *)in[i].base;
+		for (n = 0; n < in[i].len; ++n) {
+			buffer[m++] ^= p[n];
+			if (m == TC_AES_BLOCK_SIZE) {
+				(void)tc_aes_encrypt(buffer, buffer, sched);
+				iov_put(&out, &out_off, buffer,
+					TC_AES_BLOCK_SIZE);
+				m = 0;
+			}
+		}
+	}
+
+	_set(buffer, TC_ZERO_BYTE, sizeof(buffer));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
 int tc_cbc_mode_decrypt(uint8_t *out, unsigned int outlen, const uint8_t *in,
 			    unsigned int inlen, const uint8_t *iv,
 			    const TCAesKeySched_t sched)
 {
 
-	uint8_t buffer[TC_AES_BLOCK_SIZE];
-	const uint8_t *p;
-	unsigned int n, m;
+	uint8_t buffer[TINYCRYPT_CBC_BATCH_BLOCKS * TC_AES_BLOCK_SIZE];
+	uint8_t prev[TC_AES_BLOCK_SIZE];
+	unsigned int len;
 
 	/* sanity check the inputs */
 	if (out == (uint8_t *) 0 ||
@@ -96,19 +196,39 @@ int tc_cbc_mode_decrypt(uint8_t *out, unsigned int outlen, const uint8_t *in,
 	}
 
 	/*
-	 * Note that in == iv + ciphertext, i.e. the iv and the ciphertext are
-	 * contiguous. This allows for a very efficient decryption algorithm
-	 * that would not otherwise be possible.
+	 * Unlike encryption, decryption has no chaining dependency: a batch of
+	 * ciphertext blocks is deciphered at once, then each block is xored
+	 * with the ciphertext block before it (the iv for the first one). The
+	 * last ciphertext block of a batch is kept in prev before the output
+	 * is written, so out may be equal to (or below) in.
 	 */
-	p = iv;
-	for (n = m = 0; n < outlen; ++n) {
-		if ((n % TC_AES_BLOCK_SIZE) == 0) {
-			(void)tc_aes_decrypt(buffer, in, sched);
-			in += TC_AES_BLOCK_SIZE;
-			m = 0;
+	(void)_copy(prev, TC_AES_BLOCK_SIZE, iv, TC_AES_BLOCK_SIZE);
+	while (outlen > 0) {
+		len = sizeof(buffer);
+		if (len > outlen) {
+			len = outlen;
+		}
+
+		if (tc_aes_decrypt_blocks(buffer, in, len / TC_AES_BLOCK_SIZE,
+					  sched) == 0) {
+			_set(buffer, TC_ZERO_BYTE, sizeof(buffer));
+			return TC_CRYPTO_FAIL;
 		}
-		*out++ = buffer[m++] ^ *p++;
+
+		xor_words(buffer, prev, TC_AES_BLOCK_SIZE);
+		xor_words(&buffer[TC_AES_BLOCK_SIZE], in,
+			  len - TC_AES_BLOCK_SIZE);
+		(void)_copy(prev, TC_AES_BLOCK_SIZE,
+			    &in[len - TC_AES_BLOCK_SIZE], TC_AES_BLOCK_SIZE);
+
+		(void)_copy(out, len, buffer, len);
+		out += len;
+		in += len;
+		outlen -= len;
 	}
 
+	/* zeroing out the plaintext buffer */
+	_set(buffer, TC_ZERO_BYTE, sizeof(buffer));
+
 	return TC_CRYPTO_SUCCESS;
 }
@@ -58,209 +58,375 @@ int tc_ccm_config(TCCcmMode_t c, TCAesKeySched_t sched, uint8_t *nonce,
 	return TC_CRYPTO_SUCCESS;
 }
 
-/**
- * Variation of CBC-MAC mode used in CCM.
- */
-static void ccm_cbc_mac(uint8_t *T, const uint8_t *data, unsigned int dlen,
-			unsigned int flag, TCAesKeySched_t sched)
+int tc_ccm_generation_encryption(uint8_t *out, unsigned int olen,
+				 const uint8_t *associated_data,
+				 unsigned int alen, const uint8_t *payload,
+				 unsigned int plen, TCCcmMode_t c)
 {
 
-	unsigned int i;
+	/* input sanity check: */
+	if ((out == (uint8_t *) 0) ||
+		(c == (TCCcmMode_t) 0) ||
+		((plen > 0) && (payload == (uint8_t *) 0)) ||
+		((alen > 0) && (associated_data == (uint8_t *) 0)) ||
+		(alen >= TC_CCM_AAD_MAX_BYTES) || /* associated data size unsupported */
+		(plen >= TC_CCM_PAYLOAD_MAX_BYTES) || /* payload size unsupported */
+		(olen < (plen + c->mlen))) {  /* invalid output buffer size */
+		return TC_CRYPTO_FAIL;
+	}
 
-	if (flag > 0) {
-		T[0] ^= (uint8_t)(dlen >> 8);
-		T[1] ^= (uint8_t)(dlen);
-		dlen += 2; i = 2;
-	} else {
-		i = 0;
+	struct tc_ccm_stream_struct s;
+
+	(void) tc_ccm_stream_init(&s, c, alen, plen);
+	(void) tc_ccm_stream_update_aad(&s, associated_data, alen);
+	(void) tc_ccm_stream_encrypt(&s, out, payload, plen);
+
+	return tc_ccm_stream_final(&s, out + plen, c->mlen);
+}
+
+int tc_ccm_decryption_verification(uint8_t *out, unsigned int olen,
+				   const uint8_t *associated_data,
+				   unsigned int alen, const uint8_t *payload,
+				   unsigned int plen, TCCcmMode_t c)
+{
+
+	/* input sanity check: */
+	if ((out == (uint8_t *) 0) ||
+	    (c == (TCCcmMode_t) 0) ||
+	    ((plen > 0) && (payload == (uint8_t *) 0)) ||
+	    ((alen > 0) && (associated_data == (uint8_t *) 0)) ||
+	    (alen >= TC_CCM_AAD_MAX_BYTES) || /* associated data size unsupported */
+	    (plen >= TC_CCM_PAYLOAD_MAX_BYTES) || /* payload size unsupported */
+	    (plen < c->mlen) || /* no room for the tag */
+	    (olen < plen - c->mlen)) { /* invalid output buffer size */
+		return TC_CRYPTO_FAIL;
 	}
 
-	while (i < dlen) {
-		T[i++ % (Nb * Nk)] ^= *data++;
-		if (((i % (Nb * Nk)) == 0) || dlen == i) {
-			(void) tc_aes_encrypt(T, T, sched);
-		}
+	struct tc_ccm_stream_struct s;
+
+	(void) tc_ccm_stream_init(&s, c, alen, plen - c->mlen);
+	(void) tc_ccm_stream_update_aad(&s, associated_data, alen);
+	(void) tc_ccm_stream_decrypt(&s, out, payload, plen - c->mlen);
+
+	/* comparing the received tag and the computed one: */
+	if (tc_ccm_stream_verify(&s, payload + plen - c->mlen, c->mlen)) {
+		return TC_CRYPTO_SUCCESS;
+	} else {
+		/* erase the decrypted buffer in case of mac validation failure: */
+		_set(out, 0, plen - c->mlen);
+		return TC_CRYPTO_FAIL;
 	}
 }
 
-/**
- * Variation of CTR mode used in CCM.
- * The CTR mode used by CCM is slightly different than the conventional CTR
- * mode (the counter is increased before encryption, instead of after
- * encryption). Besides, it is assumed that the counter is stored in the last
- * 2 bytes of the nonce.
- */
-static int ccm_ctr_mode(uint8_t *out, unsigned int outlen, const uint8_t *in,
-			unsigned int inlen, uint8_t *ctr, const TCAesKeySched_t sched)
+int tc_ccm_stream_init(TCCcmStream_t s, TCCcmMode_t c, unsigned int alen,
+		       unsigned int plen)
 {
-
-	uint8_t buffer[TC_AES_BLOCK_SIZE];
-	uint8_t nonce[TC_AES_BLOCK_SIZE];
-	uint16_t block_num;
 	unsigned int i;
 
 	/* input sanity check: */
-	if (out == (uint8_t *) 0 ||
-	    in == (uint8_t *) 0 ||
-	    ctr == (uint8_t *) 0 ||
-	    sched == (TCAesKeySched_t) 0 ||
-	    inlen == 0 ||
-	    outlen == 0 ||
-	    outlen != inlen) {
+	if (s == (TCCcmStream_t) 0 ||
+	    c == (TCCcmMode_t) 0 ||
+	    alen >= TC_CCM_AAD_MAX_BYTES ||
+	    plen >= TC_CCM_PAYLOAD_MAX_BYTES) {
 		return TC_CRYPTO_FAIL;
 	}
 
-	/* copy the counter to the nonce */
-	(void) _copy(nonce, sizeof(nonce), ctr, sizeof(nonce));
-
-	/* select the last 2 bytes of the nonce to be incremented */
-	block_num = (uint16_t) ((nonce[14] << 8)|(nonce[15]));
-	for (i = 0; i < inlen; ++i) {
-		if ((i % (TC_AES_BLOCK_SIZE)) == 0) {
-			block_num++;
-			nonce[14] = (uint8_t)(block_num >> 8);
-			nonce[15] = (uint8_t)(block_num);
-			if (!tc_aes_encrypt(buffer, nonce, sched)) {
-				return TC_CRYPTO_FAIL;
-			}
-		}
-		/* update the output */
-		*out++ = buffer[i % (TC_AES_BLOCK_SIZE)] ^ *in++;
+	s->c = c;
+	s->alen = alen;
+	s->plen = plen;
+
+	/* formatting the sequence b for authentication: */
+	s->mac[0] = ((alen > 0) ? 0x40:0) | (((c->mlen - 2) / 2 << 3)) | (1);
+	for (i = 1; i <= 13; ++i) {
+		s->mac[i] = c->nonce[i - 1];
 	}
+	s->mac[14] = (uint8_t)(plen >> 8);
+	s->mac[15] = (uint8_t)(plen);
+	(void) tc_aes_encrypt(s->mac, s->mac, c->sched);
 
-	/* update the counter */
-	ctr[14] = nonce[14]; ctr[15] = nonce[15];
+	/* the associated data is prefixed with its length: */
+	if (alen > 0) {
+		s->mac[0] ^= (uint8_t)(alen >> 8);
+		s->mac[1] ^= (uint8_t)(alen);
+		s->mac_used = 2;
+	} else {
+		s->mac_used = 0;
+	}
+
+	/* formatting the sequence b for encryption: */
+	s->ctr[0] = 1; /* q - 1 = 2 - 1 = 1 */
+	for (i = 1; i <= 13; ++i) {
+		s->ctr[i] = c->nonce[i - 1];
+	}
+	s->ctr[14] = s->ctr[15] = TC_ZERO_BYTE;
+	s->ks_used = TC_AES_BLOCK_SIZE;
 
 	return TC_CRYPTO_SUCCESS;
 }
 
-int tc_ccm_generation_encryption(uint8_t *out, unsigned int olen,
-				 const uint8_t *associated_data,
-				 unsigned int alen, const uint8_t *payload,
-				 unsigned int plen, TCCcmMode_t c)
+/**
+ * Mixes len bytes into the CBC-MAC, encrypting each block as it fills up.
+ */
+static void stream_mac(TCCcmStream_t s, const uint8_t *data, unsigned int len)
 {
+	unsigned int i, n;
 
-	/* input sanity check: */
-	if ((out == (uint8_t *) 0) ||
-		(c == (TCCcmMode_t) 0) ||
-		((plen > 0) && (payload == (uint8_t *) 0)) ||
-		((alen > 0) && (associated_data == (uint8_t *) 0)) ||
-		(alen >= TC_CCM_AAD_MAX_BYTES) || /* associated data size unsupported */
-		(plen >= TC_CCM_PAYLOAD_MAX_BYTES) || /* payload size unsupported */
-		(olen < (plen + c->mlen))) {  /* invalid output buffer size */
-		return TC_CRYPTO_FAIL;
+	while (len > 0) {
+		n = TC_AES_BLOCK_SIZE - s->mac_used;
+		if (n > len) {
+			n = len;
+		}
+		for (i = 0; i < n; ++i) {
+			s->mac[s->mac_used + i] ^= data[i];
+		}
+		s->mac_used += n;
+		data += n;
+		len -= n;
+		if (s->mac_used == TC_AES_BLOCK_SIZE) {
+			(void) tc_aes_encrypt(s->mac, s->mac, s->c->sched);
+			s->mac_used = 0;
+		}
 	}
+}
+/**
+ * Pads the current CBC-MAC block with zeros and encrypts it.
+ */
+static void stream_mac_pad(TCCcmStream_t s)
+{
 
-	uint8_t b[Nb * Nk];
-	uint8_t tag[Nb * Nk];
+	if (s->mac_used > 0) {
+		(void) tc_aes_encrypt(s->mac, s->mac, s->c->sched);
+		s->mac_used = 0;
+	}
+}
+
+/**
+ * Increments the 2-byte counter at the end of the counter block.
+ */
+static void ctr_inc(uint8_t *ctr)
+{
+
+	if (++ctr[15] == 0) {
+		++ctr[14];
+	}
+}
+
+/**
+ * Returns the next keystream byte, encrypting the next counter block when the
+ * current one is used up.
+ */
+static uint8_t stream_ks(TCCcmStream_t s)
+{
+
+	if (s->ks_used == TC_AES_BLOCK_SIZE) {
+		ctr_inc(s->ctr);
+		(void) tc_aes_encrypt(s->ks, s->ctr, s->c->sched);
+		s->ks_used = 0;
+	}
+	return s->ks[s->ks_used++];
+}
+
+/**
+ * Fused CBC-MAC and CTR over nblocks whole blocks, for a state at a block
+ * boundary. Each input block is read once, and the CBC-MAC and keystream
+ * encryptions of a step go to the AES engine in one tc_aes_encrypt_blocks
+ * call, so pipelined or hardware engines can overlap them.
+ * When decrypting, the CBC-MAC input is only known once the keystream block
+ * has been applied, so the keystream of block i + 1 is generated together
+ * with the CBC-MAC of block i.
+ */
+static void stream_blocks(TCCcmStream_t s, uint8_t *out, const uint8_t *in,
+			  unsigned int nblocks, int decrypt)
+{
+	uint8_t buf[2 * TC_AES_BLOCK_SIZE]; /* CBC-MAC chain | counter block */
+	uint8_t p[TC_AES_BLOCK_SIZE];
+	uint8_t *ks = buf + TC_AES_BLOCK_SIZE;
 	unsigned int i;
 
-	/* GENERATING THE AUTHENTICATION TAG: */
+	(void) _copy(buf, TC_AES_BLOCK_SIZE, s->mac, TC_AES_BLOCK_SIZE);
+	if (decrypt) {
+		ctr_inc(s->ctr);
+		(void) tc_aes_encrypt(ks, s->ctr, s->c->sched);
+	}
+	while (nblocks-- > 0) {
+		if (decrypt) {
+			for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
+				p[i] = in[i] ^ ks[i];
+				buf[i] ^= p[i];
+			}
+			if (nblocks > 0) {
+				ctr_inc(s->ctr);
+				(void) _copy(ks, TC_AES_BLOCK_SIZE, s->ctr,
+					     TC_AES_BLOCK_SIZE);
+			}
+			(void) tc_aes_encrypt_blocks(buf, buf,
+						     (nblocks > 0) ? 2 : 1,
+						     s->c->sched);
+		} else {
+			for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
+				p[i] = in[i];
+				buf[i] ^= p[i];
+			}
+			ctr_inc(s->ctr);
+			(void) _copy(ks, TC_AES_BLOCK_SIZE, s->ctr,
+				     TC_AES_BLOCK_SIZE);
+			(void) tc_aes_encrypt_blocks(buf, buf, 2, s->c->sched);
+			for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
+				p[i] ^= ks[i];
+			}
+		}
+		(void) _copy(out, TC_AES_BLOCK_SIZE, p, TC_AES_BLOCK_SIZE);
+		in += TC_AES_BLOCK_SIZE;
+		out += TC_AES_BLOCK_SIZE;
+	}
+	(void) _copy(s->mac, TC_AES_BLOCK_SIZE, buf, TC_AES_BLOCK_SIZE);
+	_set(buf, 0, sizeof(buf));
+	_set(p, 0, sizeof(p));
+}
 
-	/* formatting the sequence b for authentication: */
-	b[0] = ((alen > 0) ? 0x40:0) | (((c->mlen - 2) / 2 << 3)) | (1);
-	for (i = 1; i <= 13; ++i) {
-		b[i] = c->nonce[i - 1];
+/**
+ * Encrypts or decrypts len bytes of payload: bytes up to the next block
+ * boundary one at a time, whole blocks with stream_blocks, and the rest one
+ * at a time again. The CBC-MAC and keystream positions always agree, since
+ * the associated data ends on a (padded) block boundary.
+ */
+static void stream_payload(TCCcmStream_t s, uint8_t *out, const uint8_t *in,
+			   unsigned int len, int decrypt)
+{
+	unsigned int nblocks;
+	uint8_t p;
+
+	while (len > 0 && s->mac_used != 0) {
+		p = decrypt ? (*in++ ^ stream_ks(s)) : *in++;
+		stream_mac(s, &p, 1);
+		*out++ = decrypt ? p : (p ^ stream_ks(s));
+		--len;
 	}
-	b[14] = (uint8_t)(plen >> 8);
-	b[15] = (uint8_t)(plen);
 
-	/* computing the authentication tag using cbc-mac: */
-	(void) tc_aes_encrypt(tag, b, c->sched);
-	if (alen > 0) {
-		ccm_cbc_mac(tag, associated_data, alen, 1, c->sched);
+	nblocks = len / TC_AES_BLOCK_SIZE;
+	if (nblocks > 0) {
+		stream_blocks(s, out, in, nblocks, decrypt);
+		in += nblocks * TC_AES_BLOCK_SIZE;
+		out += nblocks * TC_AES_BLOCK_SIZE;
+		len -= nblocks * TC_AES_BLOCK_SIZE;
 	}
-	if (plen > 0) {
-		ccm_cbc_mac(tag, payload, plen, 0, c->sched);
+
+	while (len-- > 0) {
+		p = decrypt ? (*in++ ^ stream_ks(s)) : *in++;
+		stream_mac(s, &p, 1);
+		*out++ = decrypt ? p : (p ^ stream_ks(s));
 	}
+}
+
+int tc_ccm_stream_update_aad(TCCcmStream_t s, const uint8_t *data,
+			     unsigned int len)
+{
 
-	/* ENCRYPTION: */
+	/* input sanity check: */
+	if (s == (TCCcmStream_t) 0 ||
+	    (len > 0 && data == (const uint8_t *) 0) ||
+	    len > s->alen) {
+		return TC_CRYPTO_FAIL;
+	}
 
-	/* formatting the sequence b for encryption: */
-	b[0] = 1; /* q - 1 = 2 - 1 = 1 */
-	b[14] = b[15] = TC_ZERO_BYTE;
+	stream_mac(s, data, len);
+	s->alen -= len;
+	if (s->alen == 0) {
+		stream_mac_pad(s);
+	}
 
-	/* encrypting payload using ctr mode: */
-	ccm_ctr_mode(out, plen, payload, plen, b, c->sched);
+	return TC_CRYPTO_SUCCESS;
+}
 
-	b[14] = b[15] = TC_ZERO_BYTE; /* restoring initial counter for ctr_mode (0):*/
+int tc_ccm_stream_encrypt(TCCcmStream_t s, uint8_t *out, const uint8_t *in,
+			  unsigned int len)
+{
 
-	/* encrypting b and adding the tag to the output: */
-	(void) tc_aes_encrypt(b, b, c->sched);
-	out += plen;
-	for (i = 0; i < c->mlen; ++i) {
-		*out++ = tag[i] ^ b[i];
+	/* input sanity check: */
+	if (s == (TCCcmStream_t) 0 ||
+	    (len > 0 && (in == (const uint8_t *) 0 || out == (uint8_t *) 0)) ||
+	    s->alen > 0 ||
+	    len > s->plen) {
+		return TC_CRYPTO_FAIL;
 	}
 
+	s->plen -= len;
+	stream_payload(s, out, in, len, 0);
+
 	return TC_CRYPTO_SUCCESS;
 }
 
-int tc_ccm_decryption_verification(uint8_t *out, unsigned int olen,
-				   const uint8_t *associated_data,
-				   unsigned int alen, const uint8_t *payload,
-				   unsigned int plen, TCCcmMode_t c)
+int tc_ccm_stream_decrypt(TCCcmStream_t s, uint8_t *out, const uint8_t *in,
+			  unsigned int len)
 {
 
 	/* input sanity check: */
-	if ((out == (uint8_t *) 0) ||
-	    (c == (TCCcmMode_t) 0) ||
-	    ((plen > 0) && (payload == (uint8_t *) 0)) ||
-	    ((alen > 0) && (associated_data == (uint8_t *) 0)) ||
-	    (alen >= TC_CCM_AAD_MAX_BYTES) || /* associated data size unsupported */
-	    (plen >= TC_CCM_PAYLOAD_MAX_BYTES) || /* payload size unsupported */
-	    (olen < plen - c->mlen)) { /* invalid output buffer size */
+	if (s == (TCCcmStream_t) 0 ||
+	    (len > 0 && (in == (const uint8_t *) 0 || out == (uint8_t *) 0)) ||
+	    s->alen > 0 ||
+	    len > s->plen) {
 		return TC_CRYPTO_FAIL;
-  }
+	}
+
+	s->plen -= len;
+	stream_payload(s, out, in, len, 1);
+
+	return TC_CRYPTO_SUCCESS;
+}
 
-	uint8_t b[Nb * Nk];
-	uint8_t tag[Nb * Nk];
+/**
+ * Finishes the CBC-MAC and encrypts it with the counter block 0.
+ */
+static int stream_tag(TCCcmStream_t s, unsigned int taglen)
+{
 	unsigned int i;
 
-	/* DECRYPTION: */
+	if (s == (TCCcmStream_t) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (taglen < s->c->mlen || s->alen > 0 || s->plen > 0) {
+		_set(s, 0, sizeof(*s));
+		return TC_CRYPTO_FAIL;
+	}
 
-	/* formatting the sequence b for decryption: */
-	b[0] = 1; /* q - 1 = 2 - 1 = 1 */
-	for (i = 1; i < 14; ++i) {
-		b[i] = c->nonce[i - 1];
+	stream_mac_pad(s);
+	s->ctr[14] = s->ctr[15] = TC_ZERO_BYTE;
+	(void) tc_aes_encrypt(s->ks, s->ctr, s->c->sched);
+	for (i = 0; i < s->c->mlen; ++i) {
+		s->mac[i] ^= s->ks[i];
 	}
-	b[14] = b[15] = TC_ZERO_BYTE; /* initial counter value is 0 */
 
-	/* decrypting payload using ctr mode: */
-	ccm_ctr_mode(out, plen - c->mlen, payload, plen - c->mlen, b, c->sched);
+	return TC_CRYPTO_SUCCESS;
+}
 
-	b[14] = b[15] = TC_ZERO_BYTE; /* restoring initial counter value (0) */
+int tc_ccm_stream_final(TCCcmStream_t s, uint8_t *tag, unsigned int taglen)
+{
 
-	/* encrypting b and restoring the tag from input: */
-	(void) tc_aes_encrypt(b, b, c->sched);
-	for (i = 0; i < c->mlen; ++i) {
-		tag[i] = *(payload + plen - c->mlen + i) ^ b[i];
+	/* input sanity check: */
+	if (tag == (uint8_t *) 0 ||
+	    stream_tag(s, taglen) != TC_CRYPTO_SUCCESS) {
+		return TC_CRYPTO_FAIL;
 	}
 
-	/* VERIFYING THE AUTHENTICATION TAG: */
+	(void) _copy(tag, taglen, s->mac, s->c->mlen);
+	_set(s, 0, sizeof(*s));
 
-	/* formatting the sequence b for authentication: */
-	b[0] = ((alen > 0) ? 0x40:0)|(((c->mlen - 2) / 2 << 3)) | (1);
-	for (i = 1; i < 14; ++i) {
-		b[i] = c->nonce[i - 1];
-	}
-	b[14] = (uint8_t)((plen - c->mlen) >> 8);
-	b[15] = (uint8_t)(plen - c->mlen);
+	return TC_CRYPTO_SUCCESS;
+}
 
-	/* computing the authentication tag using cbc-mac: */
-	(void) tc_aes_encrypt(b, b, c->sched);
-	if (alen > 0) {
-		ccm_cbc_mac(b, associated_data, alen, 1, c->sched);
-	}
-	if (plen > 0) {
-		ccm_cbc_mac(b, out, plen - c->mlen, 0, c->sched);
-	}
+int tc_ccm_stream_verify(TCCcmStream_t s, const uint8_t *tag,
+			 unsigned int taglen)
+{
+	int result;
 
-	/* comparing the received tag and the computed one: */
-	if (_compare(b, tag, c->mlen) == 0) {
-		return TC_CRYPTO_SUCCESS;
-  	} else {
-		/* erase the decrypted buffer in case of mac validation failure: */
-		_set(out, 0, plen - c->mlen);
+	/* input sanity check: */
+	if (tag == (const uint8_t *) 0 ||
+	    stream_tag(s, taglen) != TC_CRYPTO_SUCCESS) {
 		return TC_CRYPTO_FAIL;
 	}
+
+	result = (taglen == s->c->mlen && _compare(s->mac, tag, taglen) == 0) ?
+		 TC_CRYPTO_SUCCESS : TC_CRYPTO_FAIL;
+	_set(s, 0, sizeof(*s));
+
+	return result;
 }
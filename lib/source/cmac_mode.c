@@ -95,6 +95,110 @@ void gf_double(uint8_t *out, uint8_t *in)
 }
 
 int tc_cmac_setup(TCCmacState_t s, const uint8_t *key, TCAesKeySched_t sched)
+{
+	return tc_cmac_setup_key_size(s, key, TC_AES_KEY_SIZE, sched);
+}
+
+/*
+ *  cmac_subkeys -- derives K1 and K2 from the key schedule configured in sched
+ */
+static void cmac_subkeys(uint8_t *K1, uint8_t *K2, TCAesKeySched_t sched)
+{
+	uint8_t L[TC_AES_BLOCK_SIZE];
+
+	_set(L, 0, TC_AES_BLOCK_SIZE);
+	tc_aes_encrypt(L, L, sched);
+	gf_double(K1, L);
+	gf_double(K2, K1);
+	_set(L, 0, TC_AES_BLOCK_SIZE);
+}
+
+/*
+ *  cmac_absorb -- CBC-MACs data into iv, keeping back the last (possibly
+ *  full) block in leftover so that the final step can mask it with K1 or K2.
+ */
+static void cmac_absorb(uint8_t *iv, uint8_t *leftover, unsigned int *offset,
+			TCAesKeySched_t sched, const uint8_t *data,
+			size_t data_length)
+{
+	unsigned int i;
+
+	if (*offset > 0) {
+		/* last data added didn't end on a TC_AES_BLOCK_SIZE byte boundary */
+		size_t remaining_space = TC_AES_BLOCK_SIZE - *offset;
+
+		if (data_length <= remaining_space) {
+			/*
+			 * still not enough data to encrypt this time either; a
+			 * block that is just filled is kept, since it may be the
+			 * last one and then has to be masked with K1
+			 */
+			_copy(&leftover[*offset], data_length, data, data_length);
+			*offset += data_length;
+			return;
+		}
+		/* leftover block is now full; encrypt it first */
+		_copy(&leftover[*offset],
+		      remaining_space,
+		      data,
+		      remaining_space);
+		data_length -= remaining_space;
+		data += remaining_space;
+		*offset = 0;
+
+		for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
+			iv[i] ^= leftover[i];
+		}
+		tc_aes_encrypt(iv, iv, sched);
+	}
+
+	/* CBC encrypt each (except the last) of the data blocks */
+	while (data_length > TC_AES_BLOCK_SIZE) {
+		for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
+			iv[i] ^= data[i];
+		}
+		tc_aes_encrypt(iv, iv, sched);
+		data += TC_AES_BLOCK_SIZE;
+		data_length  -= TC_AES_BLOCK_SIZE;
+	}
+
+	if (data_length > 0) {
+		/* save leftover data for next time */
+		_copy(leftover, data_length, data, data_length);
+		*offset = data_length;
+	}
+}
+
+/*
+ *  cmac_finish -- pads and masks the last block and encrypts it into tag
+ */
+static void cmac_finish(uint8_t *tag, uint8_t *iv, uint8_t *leftover,
+			unsigned int offset, const uint8_t *K1,
+			const uint8_t *K2, TCAesKeySched_t sched)
+{
+	const uint8_t *k;
+	unsigned int i;
+
+	if (offset == TC_AES_BLOCK_SIZE) {
+		/* the last message block is a full-sized block */
+		k = K1;
+	} else {
+		/* the final message block is not a full-sized  block */
+		size_t remaining = TC_AES_BLOCK_SIZE - offset;
+
+		_set(&leftover[offset], 0, remaining);
+		leftover[offset] = TC_CMAC_PADDING;
+		k = K2;
+	}
+	for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
+		iv[i] ^= leftover[i] ^ k[i];
+	}
+
+	tc_aes_encrypt(tag, iv, sched);
+}
+
+int tc_cmac_setup_key_size(TCCmacState_t s, const uint8_t *key,
+			   unsigned int key_size, TCAesKeySched_t sched)
 {
 
 	/* input sanity check: */
@@ -108,13 +212,12 @@ int tc_cmac_setup(TCCmacState_t s, const uint8_t *key, TCAesKeySched_t sched)
 	s->sched = sched;
 
 	/* configure the encryption key used by the underlying block cipher */
-	tc_aes128_set_encrypt_key(s->sched, key);
+	if (tc_aes_set_encrypt_key(s->sched, key, key_size) == 0) {
+		return TC_CRYPTO_FAIL;
+	}
 
-	/* compute s->K1 and s->K2 from s->iv using s->keyid */
-	_set(s->iv, 0, TC_AES_BLOCK_SIZE);
-	tc_aes_encrypt(s->iv, s->iv, s->sched);
-	gf_double (s->K1, s->iv);
-	gf_double (s->K2, s->K1);
+	/* compute s->K1 and s->K2 */
+	cmac_subkeys(s->K1, s->K2, s->sched);
 
 	/* reset s->iv to 0 in case someone wants to compute now */
 	tc_cmac_init(s);
@@ -156,8 +259,6 @@ int tc_cmac_init(TCCmacState_t s)
 
 int tc_cmac_update(TCCmacState_t s, const uint8_t *data, size_t data_length)
 {
-	unsigned int i;
-
 	/* input sanity check: */
 	if (s == (TCCmacState_t) 0) {
 		return TC_CRYPTO_FAIL;
@@ -175,45 +276,40 @@ int tc_cmac_update(TCCmacState_t s, const uint8_t *data, size_t data_length)
 
 	s->countdown--;
 
-	if (s->leftover_offset > 0) {
-		/* last data added to s didn't end on a TC_AES_BLOCK_SIZE byte boundary */
-		size_t remaining_space = TC_AES_BLOCK_SIZE - s->leftover_offset;
+	cmac_absorb(s->iv, s->leftover, &s->leftover_offset, s->sched,
+		    data, data_length);
 
-		if (data_length < remaining_space) {
-			/* still not enough data to encrypt this time either */
-			_copy(&s->leftover[s->leftover_offset], data_length, data, data_length);
-			s->leftover_offset += data_length;
-			return TC_CRYPTO_SUCCESS;
-		}
-		/* leftover block is now full; encrypt it first */
-		_copy(&s->leftover[s->leftover_offset],
-		      remaining_space,
-		      data,
-		      remaining_space);
-		data_length -= remaining_space;
-		data += remaining_space;
-		s->leftover_offset = 0;
+	return TC_CRYPTO_SUCCESS;
+}
 
-		for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
-			s->iv[i] ^= s->leftover[i];
+int tc_cmac_updatev(TCCmacState_t s, const struct tc_iovec *iov,
+		    unsigned int iovcnt)
+{
+	unsigned int i;
+
+	/* input sanity check: */
+	if (s == (TCCmacState_t) 0 ||
+	    (iov == (const struct tc_iovec *) 0 && iovcnt != 0)) {
+		return TC_CRYPTO_FAIL;
+	}
+	for (i = 0; i < iovcnt; ++i) {
+		if (iov[i].base == (void *) 0 && iov[i].len != 0) {
+			return TC_CRYPTO_FAIL;
 		}
-		tc_aes_encrypt(s->iv, s->iv, s->sched);
 	}
 
-	/* CBC encrypt each (except the last) of the data blocks */
-	while (data_length > TC_AES_BLOCK_SIZE) {
-		for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
-			s->iv[i] ^= data[i];
-		}
-		tc_aes_encrypt(s->iv, s->iv, s->sched);
-		data += TC_AES_BLOCK_SIZE;
-		data_length  -= TC_AES_BLOCK_SIZE;
+	if (s->countdown == 0) {
+		return TC_CRYPTO_FAIL;
 	}
 
-	if (data_length > 0) {
-		/* save leftover data for next time */
-		_copy(s->leftover, data_length, data, data_length);
-		s->leftover_offset = data_length;
+	s->countdown--;
+
+	/* the leftover block carries over from one segment to the next */
+	for (i = 0; i < iovcnt; ++i) {
+		if (iov[i].len != 0) {
+			cmac_absorb(s->iv, s->leftover, &s->leftover_offset,
+				    s->sched, iov[i].base, iov[i].len);
+		}
 	}
 
 	return TC_CRYPTO_SUCCESS;
@@ -221,34 +317,230 @@ int tc_cmac_update(TCCmacState_t s, const uint8_t *data, size_t data_length)
 
 int tc_cmac_final(uint8_t *tag, TCCmacState_t s)
 {
-	uint8_t *k;
-	unsigned int i;
-
 	/* input sanity check: */
 	if (tag == (uint8_t *) 0 ||
 	    s == (TCCmacState_t) 0) {
 		return TC_CRYPTO_FAIL;
 	}
 
-	if (s->leftover_offset == TC_AES_BLOCK_SIZE) {
-		/* the last message block is a full-sized block */
-		k = (uint8_t *) s->K1;
-	} else {
-		/* the final message block is not a full-sized  block */
-		size_t remaining = TC_AES_BLOCK_SIZE - s->leftover_offset;
+	cmac_finish(tag, s->iv, s->leftover, s->leftover_offset, s->K1, s->K2,
+		    s->sched);
+
+	/* erasing state: */
+	tc_cmac_erase(s);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_cmac_key_set(TCCmacKey_t key, const uint8_t *k, unsigned int key_size,
+		    TCAesKeySched_t sched)
+{
 
-		_set(&s->leftover[s->leftover_offset], 0, remaining);
-		s->leftover[s->leftover_offset] = TC_CMAC_PADDING;
-		k = (uint8_t *) s->K2;
+	/* input sanity check: */
+	if (key == (TCCmacKey_t) 0 ||
+	    k == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
 	}
-	for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
-		s->iv[i] ^= s->leftover[i] ^ k[i];
+
+	_set(key, 0, sizeof(*key));
+	key->sched = sched;
+
+	if (tc_aes_set_encrypt_key(key->sched, k, key_size) == 0) {
+		return TC_CRYPTO_FAIL;
 	}
 
-	tc_aes_encrypt(tag, s->iv, s->sched);
+	cmac_subkeys(key->K1, key->K2, key->sched);
 
-	/* erasing state: */
-	tc_cmac_erase(s);
+	/* messages allowed before re-keying: */
+	key->countdown = MAX_CALLS;
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_cmac_key_erase(TCCmacKey_t key)
+{
+	if (key == (TCCmacKey_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	_set(key, 0, sizeof(*key));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_cmac_key_init(TCCmacMsg_t m, TCCmacKey_t key)
+{
+	/* input sanity check: */
+	if (m == (TCCmacMsg_t) 0 ||
+	    key == (TCCmacKey_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	if (key->countdown == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	key->countdown--;
+
+	_set(m->iv, 0, TC_AES_BLOCK_SIZE);
+	m->leftover_offset = 0;
+	m->key = key;
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_cmac_key_update(TCCmacMsg_t m, const uint8_t *data, size_t data_length)
+{
+	/* input sanity check: */
+	if (m == (TCCmacMsg_t) 0 ||
+	    m->key == (TCCmacKey_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	if (data_length == 0) {
+		return  TC_CRYPTO_SUCCESS;
+	}
+	if (data == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	cmac_absorb(m->iv, m->leftover, &m->leftover_offset, m->key->sched,
+		    data, data_length);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_cmac_key_final(uint8_t *tag, TCCmacMsg_t m)
+{
+	/* input sanity check: */
+	if (tag == (uint8_t *) 0 ||
+	    m == (TCCmacMsg_t) 0 ||
+	    m->key == (TCCmacKey_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	cmac_finish(tag, m->iv, m->leftover, m->leftover_offset, m->key->K1,
+		    m->key->K2, m->key->sched);
+
+	/* erasing the message state only; the key stays usable */
+	_set(m, 0, sizeof(*m));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_cmac_key_mac(uint8_t *tag, const uint8_t *data, size_t data_length,
+		    TCCmacKey_t key)
+{
+	struct tc_cmac_msg_struct m;
+
+	if (tag == (uint8_t *) 0 ||
+	    tc_cmac_key_init(&m, key) != TC_CRYPTO_SUCCESS ||
+	    tc_cmac_key_update(&m, data, data_length) != TC_CRYPTO_SUCCESS) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	return tc_cmac_key_final(tag, &m);
+}
+
+/*
+ *  cmac_mb_block -- xors the next block of a message into its chaining value.
+ *  The last block is padded and masked with K1 or K2 exactly as in
+ *  tc_cmac_final; returns 1 once that block has been mixed in.
+ */
+static int cmac_mb_block(uint8_t *iv, const uint8_t *data, size_t *pos,
+			 size_t len, TCCmacState_t s)
+{
+	size_t remaining = len - *pos;
+	unsigned int i;
+
+	if (remaining > TC_AES_BLOCK_SIZE) {
+		for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
+			iv[i] ^= data[*pos + i];
+		}
+		*pos += TC_AES_BLOCK_SIZE;
+		return 0;
+	}
+
+	if (remaining == TC_AES_BLOCK_SIZE) {
+		for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
+			iv[i] ^= data[*pos + i] ^ s->K1[i];
+		}
+	} else {
+		for (i = 0; i < remaining; ++i) {
+			iv[i] ^= data[*pos + i];
+		}
+		iv[remaining] ^= TC_CMAC_PADDING;
+		for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
+			iv[i] ^= s->K2[i];
+		}
+	}
+	*pos = len;
+	return 1;
+}
+
+int tc_cmac_mb(uint8_t *const *tag, const uint8_t *const *data,
+	       const size_t *datalen, unsigned int count, TCCmacState_t s)
+{
+	uint8_t iv[TC_CMAC_MB_LANES * TC_AES_BLOCK_SIZE];
+	unsigned int msg[TC_CMAC_MB_LANES];
+	size_t pos[TC_CMAC_MB_LANES];
+	uint8_t done[TC_CMAC_MB_LANES];
+	unsigned int lanes, next, l, i;
+
+	/* input sanity check: */
+	if (tag == (uint8_t *const *) 0 ||
+	    data == (const uint8_t *const *) 0 ||
+	    datalen == (const size_t *) 0 ||
+	    s == (TCCmacState_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	for (i = 0; i < count; ++i) {
+		if (tag[i] == (uint8_t *) 0 ||
+		    (data[i] == (const uint8_t *) 0 && datalen[i] > 0)) {
+			return TC_CRYPTO_FAIL;
+		}
+	}
+	if (s->countdown < count) {
+		return TC_CRYPTO_FAIL;
+	}
+	s->countdown -= count;
+
+	lanes = 0;
+	next = 0;
+	while (lanes > 0 || next < count) {
+		/* refill idle lanes with the next messages */
+		while (lanes < TC_CMAC_MB_LANES && next < count) {
+			_set(&iv[lanes * TC_AES_BLOCK_SIZE], 0, TC_AES_BLOCK_SIZE);
+			msg[lanes] = next++;
+			pos[lanes] = 0;
+			lanes++;
+		}
+
+		for (l = 0; l < lanes; ++l) {
+			done[l] = (uint8_t) cmac_mb_block(&iv[l * TC_AES_BLOCK_SIZE],
+							  data[msg[l]], &pos[l],
+							  datalen[msg[l]], s);
+		}
+		tc_aes_encrypt_blocks(iv, iv, lanes, s->sched);
+
+		/* retire finished lanes, moving the last lane into the hole */
+		for (l = lanes; l-- > 0;) {
+			if (!done[l]) {
+				continue;
+			}
+			_copy(tag[msg[l]], TC_AES_BLOCK_SIZE,
+			      &iv[l * TC_AES_BLOCK_SIZE], TC_AES_BLOCK_SIZE);
+			lanes--;
+			if (l != lanes) {
+				_copy(&iv[l * TC_AES_BLOCK_SIZE], TC_AES_BLOCK_SIZE,
+				      &iv[lanes * TC_AES_BLOCK_SIZE],
+				      TC_AES_BLOCK_SIZE);
+				msg[l] = msg[lanes];
+				pos[l] = pos[lanes];
+				done[l] = done[lanes];
+			}
+		}
+	}
 
+	_set(iv, 0, sizeof(iv));
 	return TC_CRYPTO_SUCCESS;
 }
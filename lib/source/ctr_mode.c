@@ -34,14 +34,110 @@
 #include <tinycrypt/ctr_mode.h>
 #include <tinycrypt/utils.h>
 
+#include <string.h>
+
+/*
+ * Number of counter blocks encrypted together by the bulk path; each batch
+ * takes 2 * 16 bytes of stack per block.
+ */
+#ifndef TINYCRYPT_CTR_BATCH_BLOCKS
+#define TINYCRYPT_CTR_BATCH_BLOCKS 8
+#endif
+
+static inline void xor_words(uint8_t *out, const uint8_t *in,
+			     const uint8_t *keystream, unsigned int len)
+{
+	uint32_t a, b;
+	unsigned int i;
+
+	for (i = 0; i < len; i += sizeof(a)) {
+		(void)memcpy(&a, in + i, sizeof(a));
+		(void)memcpy(&b, keystream + i, sizeof(b));
+		a ^= b;
+		(void)memcpy(out + i, &a, sizeof(a));
+	}
+}
+
+/* copies ctr to the nonce of every block of a batch; returns its counter */
+static unsigned int ctr_load(uint8_t *nonce, const uint8_t *ctr)
+{
+	unsigned int i;
+
+	for (i = 0; i < TINYCRYPT_CTR_BATCH_BLOCKS; ++i) {
+		(void)_copy(&nonce[i * TC_AES_BLOCK_SIZE], TC_AES_BLOCK_SIZE,
+			    ctr, TC_AES_BLOCK_SIZE);
+	}
+
+	/* select the last 4 bytes of the nonce to be incremented */
+	return ((unsigned int)nonce[12] << 24) | (nonce[13] << 16) |
+		(nonce[14] << 8) | (nonce[15]);
+}
+
+/*
+ * Encrypts the keystream for the next batch of blocks, enough for len more
+ * bytes, into buffer; returns the number of keystream bytes used, or 0 if
+ * the block cipher failed.
+ */
+static unsigned int ctr_keystream(uint8_t *buffer, uint8_t *nonce,
+				  unsigned int *block_num, size_t len,
+				  const TCAesKeySched_t sched)
+{
+	unsigned int nblocks;
+	unsigned int i;
+
+	/* a trailing partial block takes one more keystream block */
+	nblocks = TINYCRYPT_CTR_BATCH_BLOCKS;
+	if (len < (size_t)nblocks * TC_AES_BLOCK_SIZE) {
+		nblocks = (unsigned int)(len + TC_AES_BLOCK_SIZE - 1) /
+			TC_AES_BLOCK_SIZE;
+	}
+
+	for (i = 0; i < nblocks; ++i, ++*block_num) {
+		nonce[i * TC_AES_BLOCK_SIZE + 12] = (uint8_t)(*block_num >> 24);
+		nonce[i * TC_AES_BLOCK_SIZE + 13] = (uint8_t)(*block_num >> 16);
+		nonce[i * TC_AES_BLOCK_SIZE + 14] = (uint8_t)(*block_num >> 8);
+		nonce[i * TC_AES_BLOCK_SIZE + 15] = (uint8_t)(*block_num);
+	}
+
+	/* encrypt data using the current batch of nonces */
+	if (tc_aes_encrypt_blocks(buffer, nonce, nblocks, sched) == 0) {
+		return 0;
+	}
+
+	if (len > nblocks * TC_AES_BLOCK_SIZE) {
+		len = nblocks * TC_AES_BLOCK_SIZE;
+	}
+	return (unsigned int)len;
+}
+
+/* out = in ^ keystream, whole words first */
+static void xor_bytes(uint8_t *out, const uint8_t *in,
+		      const uint8_t *keystream, unsigned int len)
+{
+	unsigned int i = len - (len % sizeof(uint32_t));
+
+	xor_words(out, in, keystream, i);
+	for (; i < len; ++i) {
+		out[i] = keystream[i] ^ in[i];
+	}
+}
+
+static void ctr_store(uint8_t *ctr, unsigned int block_num)
+{
+	ctr[12] = (uint8_t)(block_num >> 24);
+	ctr[13] = (uint8_t)(block_num >> 16);
+	ctr[14] = (uint8_t)(block_num >> 8);
+	ctr[15] = (uint8_t)(block_num);
+}
+
 int tc_ctr_mode(uint8_t *out, unsigned int outlen, const uint8_t *in,
 		unsigned int inlen, uint8_t *ctr, const TCAesKeySched_t sched)
 {
 
-	uint8_t buffer[TC_AES_BLOCK_SIZE];
-	uint8_t nonce[TC_AES_BLOCK_SIZE];
+	uint8_t buffer[TINYCRYPT_CTR_BATCH_BLOCKS * TC_AES_BLOCK_SIZE];
+	uint8_t nonce[TINYCRYPT_CTR_BATCH_BLOCKS * TC_AES_BLOCK_SIZE];
 	unsigned int block_num;
-	unsigned int i;
+	unsigned int len;
 
 	/* input sanity check: */
 	if (out == (uint8_t *) 0 ||
@@ -54,32 +150,101 @@ int tc_ctr_mode(uint8_t *out, unsigned int outlen, const uint8_t *in,
 		return TC_CRYPTO_FAIL;
 	}
 
-	/* copy the ctr to the nonce */
-	(void)_copy(nonce, sizeof(nonce), ctr, sizeof(nonce));
+	block_num = ctr_load(nonce, ctr);
 
-	/* select the last 4 bytes of the nonce to be incremented */
-	block_num = (nonce[12] << 24) | (nonce[13] << 16) |
-		    (nonce[14] << 8) | (nonce[15]);
-	for (i = 0; i < inlen; ++i) {
-		if ((i % (TC_AES_BLOCK_SIZE)) == 0) {
-			/* encrypt data using the current nonce */
-			if (tc_aes_encrypt(buffer, nonce, sched)) {
-				block_num++;
-				nonce[12] = (uint8_t)(block_num >> 24);
-				nonce[13] = (uint8_t)(block_num >> 16);
-				nonce[14] = (uint8_t)(block_num >> 8);
-				nonce[15] = (uint8_t)(block_num);
-			} else {
-				return TC_CRYPTO_FAIL;
+	while (inlen > 0) {
+		len = ctr_keystream(buffer, nonce, &block_num, inlen, sched);
+		if (len == 0) {
+			_set(buffer, TC_ZERO_BYTE, sizeof(buffer));
+			return TC_CRYPTO_FAIL;
+		}
+
+		/* update the output, whole blocks a word at a time */
+		xor_bytes(out, in, buffer, len);
+		out += len;
+		in += len;
+		inlen -= len;
+	}
+
+	/* update the counter */
+	ctr_store(ctr, block_num);
+
+	/* zeroing out the keystream buffer */
+	_set(buffer, TC_ZERO_BYTE, sizeof(buffer));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_ctr_modev(const struct tc_iovec *out, unsigned int outcnt,
+		 const struct tc_iovec *in, unsigned int incnt, uint8_t *ctr,
+		 const TCAesKeySched_t sched)
+{
+
+	uint8_t buffer[TINYCRYPT_CTR_BATCH_BLOCKS * TC_AES_BLOCK_SIZE];
+	uint8_t nonce[TINYCRYPT_CTR_BATCH_BLOCKS * TC_AES_BLOCK_SIZE];
+	unsigned int block_num;
+	unsigned int len;
+	unsigned int k;
+	size_t in_off = 0;
+	size_t out_off = 0;
+	size_t inlen;
+	size_t n;
+
+	/* input sanity check: */
+	if (out == (const struct tc_iovec *) 0 ||
+	    in == (const struct tc_iovec *) 0 ||
+	    ctr == (uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	inlen = tc_iov_length(in, incnt);
+	if (inlen == 0 || tc_iov_length(out, outcnt) != inlen) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	block_num = ctr_load(nonce, ctr);
+
+	while (inlen > 0) {
+		len = ctr_keystream(buffer, nonce, &block_num, inlen, sched);
+		if (len == 0) {
+			_set(buffer, TC_ZERO_BYTE, sizeof(buffer));
+			return TC_CRYPTO_FAIL;
+		}
+
+		/*
+		 * Spend the keystream across segment boundaries; both arrays
+		 * hold at least len more bytes, so neither runs out here.
+		 */
+		for (k = 0; k < len; k += n) {
+			while (in_off == in->len) {
+				++in;
+				in_off = 0;
 			}
+			while (out_off == out->len) {
+				++out;
+				out_off = 0;
+			}
+			n = len - k;
+			if (n > in->len - in_off) {
+				n = in->len - in_off;
+			}
+			if (n > out->len - out_off) {
+				n = out->len - out_off;
+			}
+			xor_bytes((uint8_t *)out->base + out_off,
+				  (const uint8_t *)in->base + in_off, buffer + k,
+				  (unsigned int)n);
+			in_off += n;
+			out_off += n;
 		}
-		/* update the output */
-		*out++ = buffer[i%(TC_AES_BLOCK_SIZE)] ^ *in++;
+		inlen -= len;
 	}
 
 	/* update the counter */
-	ctr[12] = nonce[12]; ctr[13] = nonce[13];
-	ctr[14] = nonce[14]; ctr[15] = nonce[15];
+	ctr_store(ctr, block_num);
+
+	/* zeroing out the keystream buffer */
+	_set(buffer, TC_ZERO_BYTE, sizeof(buffer));
 
 	return TC_CRYPTO_SUCCESS;
 }
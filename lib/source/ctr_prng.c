@@ -42,6 +42,23 @@
  *
  */
 
+/*
+ * Number of counter blocks encrypted together when producing keystream; the
+ * batch takes 16 bytes of stack per block.
+ */
+#ifndef TINYCRYPT_CTR_PRNG_BATCH_BLOCKS
+#define TINYCRYPT_CTR_PRNG_BATCH_BLOCKS 8
+#endif
+
+/* 2^48 - see section 10.2.1 */
+static const uint64_t MAX_REQS_BEFORE_RESEED = 0x1000000000000ULL;
+
+/* 2^19 bits - see section 10.2.1 */
+static const unsigned int MAX_BYTES_PER_REQ = 65536U;
+
+/* whole blocks per request when tc_ctr_prng_generate_bulk splits its output */
+static const unsigned int BULK_BYTES_PER_REQ = 65536U - TC_AES_BLOCK_SIZE;
+
 /**
  *  @brief Array incrementer
  *  Treats the supplied array as one contiguous number (MSB in arr[0]), and
@@ -62,6 +79,51 @@ static void arrInc(uint8_t arr[], unsigned int len)
 	}
 }
 
+/**
+ *  @brief CTR PRNG keystream
+ *  Fills out with len bytes of keystream: for each block, increments V and
+ *  encrypts it (10.2.1.2 step 2, 10.2.1.5.1 step 4). The counter blocks are
+ *  encrypted TINYCRYPT_CTR_PRNG_BATCH_BLOCKS at a time.
+ *  @return none
+ *  @param ctx IN/OUT -- CTR PRNG state
+ *  @param out OUT -- buffer to receive the keystream
+ *  @param len IN -- number of bytes to produce
+ */
+static void ctr_prng_keystream(TCCtrPrng_t * const ctx, uint8_t *out,
+			       unsigned int len)
+{
+	uint8_t counters[TINYCRYPT_CTR_PRNG_BATCH_BLOCKS * TC_AES_BLOCK_SIZE];
+	unsigned int nblocks, n, i;
+
+	while (len > 0U) {
+		nblocks = (len + TC_AES_BLOCK_SIZE - 1U) / TC_AES_BLOCK_SIZE;
+		if (nblocks > TINYCRYPT_CTR_PRNG_BATCH_BLOCKS) {
+			nblocks = TINYCRYPT_CTR_PRNG_BATCH_BLOCKS;
+		}
+		for (i = 0U; i < nblocks; i++) {
+			arrInc(ctx->V, sizeof ctx->V);
+			memcpy(&counters[i * TC_AES_BLOCK_SIZE], ctx->V,
+			       TC_AES_BLOCK_SIZE);
+		}
+
+		n = nblocks * TC_AES_BLOCK_SIZE;
+		if (n <= len) {
+			(void)tc_aes_encrypt_blocks(out, counters, nblocks,
+						    &ctx->key);
+		} else {
+			/* partial last block */
+			(void)tc_aes_encrypt_blocks(counters, counters, nblocks,
+						    &ctx->key);
+			n = len;
+			memcpy(out, counters, n);
+		}
+		out += n;
+		len -= n;
+	}
+
+	memset(counters, 0x00, sizeof counters);
+}
+
 /**
  *  @brief CTR PRNG update
  *  Updates the internal state of supplied the CTR PRNG context
@@ -76,27 +138,9 @@ static void tc_ctr_prng_update(TCCtrPrng_t * const ctx, uint8_t const * const pr
 	if (0 != ctx) {
 		/* 10.2.1.2 step 1 */
 		uint8_t temp[TC_AES_KEY_SIZE + TC_AES_BLOCK_SIZE];
-		unsigned int len = 0U;
-
-		/* 10.2.1.2 step 2 */
-		while (len < sizeof temp) {
-			unsigned int blocklen = sizeof(temp) - len;
-			uint8_t output_block[TC_AES_BLOCK_SIZE];
-
-			/* 10.2.1.2 step 2.1 */
-			arrInc(ctx->V, sizeof ctx->V);
 
-			/* 10.2.1.2 step 2.2 */
-			if (blocklen > TC_AES_BLOCK_SIZE) {
-				blocklen = TC_AES_BLOCK_SIZE;
-			}
-			(void)tc_aes_encrypt(output_block, ctx->V, &ctx->key);
-
-			/* 10.2.1.2 step 2.3/step 3 */
-			memcpy(&(temp[len]), output_block, blocklen);
-
-			len += blocklen;
-		}
+		/* 10.2.1.2 step 2/step 3 */
+		ctr_prng_keystream(ctx, temp, sizeof temp);
 
 		/* 10.2.1.2 step 4 */
 		if (0 != providedData) {
@@ -208,12 +252,6 @@ int tc_ctr_prng_generate(TCCtrPrng_t * const ctx,
 			uint8_t * const out,
 			unsigned int outlen)
 {
-	/* 2^48 - see section 10.2.1 */
-	static const uint64_t MAX_REQS_BEFORE_RESEED = 0x1000000000000ULL; 
-
-	/* 2^19 bits - see section 10.2.1 */ 
-	static const unsigned int MAX_BYTES_PER_REQ = 65536U; 
-
 	unsigned int result = TC_CRYPTO_FAIL;
 
 	if ((0 != ctx) && (0 != out) && (outlen < MAX_BYTES_PER_REQ)) {
@@ -234,27 +272,9 @@ int tc_ctr_prng_generate(TCCtrPrng_t * const ctx,
       
 			/* 10.2.1.5.1 step 3 - implicit */
 
-			/* 10.2.1.5.1 step 4 */
-			unsigned int len = 0U;      
-			while (len < outlen) {
-				unsigned int blocklen = outlen - len;
-				uint8_t output_block[TC_AES_BLOCK_SIZE];
-
-				/* 10.2.1.5.1 step 4.1 */
-				arrInc(ctx->V, sizeof ctx->V);
+			/* 10.2.1.5.1 step 4/step 5 */
+			ctr_prng_keystream(ctx, out, outlen);
 
-				/* 10.2.1.5.1 step 4.2 */
-				(void)tc_aes_encrypt(output_block, ctx->V, &ctx->key);
-      
-				/* 10.2.1.5.1 step 4.3/step 5 */
-				if (blocklen > TC_AES_BLOCK_SIZE) {
-					blocklen = TC_AES_BLOCK_SIZE;
-				}
-				memcpy(&(out[len]), output_block, blocklen);
-
-				len += blocklen;
-			}
-      
 			/* 10.2.1.5.1 step 6 */
 			tc_ctr_prng_update(ctx, additional_input_buf);
 
@@ -269,6 +289,48 @@ int tc_ctr_prng_generate(TCCtrPrng_t * const ctx,
 	return result;
 }
 
+int tc_ctr_prng_generate_bulk(TCCtrPrng_t * const ctx,
+			      uint8_t const * const additional_input,
+			      unsigned int additionallen,
+			      uint8_t * const out,
+			      size_t outlen)
+{
+	uint64_t requests;
+	size_t done = 0U;
+	int result;
+
+	if ((0 == ctx) || (0 == out)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* refuse up front rather than stop part way through out */
+	requests = (outlen + BULK_BYTES_PER_REQ - 1U) / BULK_BYTES_PER_REQ;
+	if (requests == 0U) {
+		requests = 1U;
+	}
+	if (ctx->reseedCount + requests - 1U > MAX_REQS_BEFORE_RESEED) {
+		return TC_CTR_PRNG_RESEED_REQ;
+	}
+
+	do {
+		unsigned int len = BULK_BYTES_PER_REQ;
+
+		if (outlen - done < len) {
+			len = (unsigned int)(outlen - done);
+		}
+		/* the additional input only goes into the first request */
+		result = tc_ctr_prng_generate(ctx,
+					      done == 0U ? additional_input : 0,
+					      additionallen, &out[done], len);
+		if (TC_CRYPTO_SUCCESS != result) {
+			return result;
+		}
+		done += len;
+	} while (done < outlen);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
 void tc_ctr_prng_uninstantiate(TCCtrPrng_t * const ctx)
 {
 	if (0 != ctx) {
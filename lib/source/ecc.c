@@ -54,8 +54,42 @@
 
 #include <tinycrypt/ecc.h>
 #include <tinycrypt/ecc_platform_specific.h>
+#if defined(TINYCRYPT_ACCEL)
+#include <tinycrypt/accel.h>
+#include <tinycrypt/utils.h>
+#endif
 #include <string.h>
 
+#if uECC_ENABLE_STATS
+static struct uECC_stats ecc_stats;
+
+#define STAT_INC(op) (ecc_stats.count[op]++)
+#if defined(uECC_CYCLE_COUNTER)
+#define STAT_START(op) \
+	uECC_CYCLE_TYPE stat_start = uECC_CYCLE_COUNTER(); STAT_INC(op)
+#define STAT_STOP(op) \
+	(ecc_stats.cycles[op] += (uECC_CYCLE_TYPE)(uECC_CYCLE_COUNTER() - \
+						   stat_start))
+#else
+#define STAT_START(op) STAT_INC(op)
+#define STAT_STOP(op) ((void)0)
+#endif
+
+void uECC_stats_reset(void)
+{
+	memset(&ecc_stats, 0, sizeof(ecc_stats));
+}
+
+void uECC_stats_get(struct uECC_stats *stats)
+{
+	*stats = ecc_stats;
+}
+#else
+#define STAT_INC(op) ((void)0)
+#define STAT_START(op) ((void)0)
+#define STAT_STOP(op) ((void)0)
+#endif
+
 /* IMPORTANT: Make sure a cryptographically-secure PRNG is set and the platform
  * has access to enough entropy in order to feed the PRNG regularly. */
 #if default_RNG_defined
@@ -74,14 +108,20 @@ uECC_RNG_Function uECC_get_rng(void)
 	return g_rng_function;
 }
 
+int uECC_global_rng(void *ctx, uint8_t *dest, unsigned int size)
+{
+	(void)ctx;
+	return g_rng_function ? g_rng_function(dest, size) : 0;
+}
+
 int uECC_curve_private_key_size(uECC_Curve curve)
 {
-	return BITS_TO_BYTES(curve->num_n_bits);
+	return BITS_TO_BYTES(uECC_NUM_N_BITS(curve));
 }
 
 int uECC_curve_public_key_size(uECC_Curve curve)
 {
-	return 2 * curve->num_bytes;
+	return 2 * uECC_NUM_BYTES(curve);
 }
 
 void uECC_vli_clear(uECC_word_t *vli, wordcount_t num_words)
@@ -186,6 +226,15 @@ uECC_word_t cond_set(uECC_word_t p_true, uECC_word_t p_false, unsigned int cond)
 	return (p_true*(cond)) | (p_false*(!cond));
 }
 
+/* With uECC_SINGLE_CURVE every caller of the arithmetic kernels below passes
+ * NUM_ECC_WORDS; restating it makes their loop bounds constants that the
+ * compiler can unroll. */
+#if uECC_SINGLE_CURVE
+#define FIXED_NUM_WORDS(num_words) ((num_words) = NUM_ECC_WORDS)
+#else
+#define FIXED_NUM_WORDS(num_words) ((void)(num_words))
+#endif
+
 /* Computes result = left - right, returning borrow, in constant time.
  * Can modify in place. */
 uECC_word_t uECC_vli_sub(uECC_word_t *result, const uECC_word_t *left,
@@ -193,6 +242,8 @@ uECC_word_t uECC_vli_sub(uECC_word_t *result, const uECC_word_t *left,
 {
 	uECC_word_t borrow = 0;
 	wordcount_t i;
+
+	FIXED_NUM_WORDS(num_words);
 	for (i = 0; i < num_words; ++i) {
 		uECC_word_t diff = left[i] - right[i] - borrow;
 		uECC_word_t val = (diff > left[i]);
@@ -210,6 +261,8 @@ static uECC_word_t uECC_vli_add(uECC_word_t *result, const uECC_word_t *left,
 {
 	uECC_word_t carry = 0;
 	wordcount_t i;
+
+	FIXED_NUM_WORDS(num_words);
 	for (i = 0; i < num_words; ++i) {
 		uECC_word_t sum = left[i] + right[i] + carry;
 		uECC_word_t val = (sum < left[i]);
@@ -234,6 +287,7 @@ static void uECC_vli_rshift1(uECC_word_t *vli, wordcount_t num_words)
 	uECC_word_t *end = vli;
 	uECC_word_t carry = 0;
 
+	FIXED_NUM_WORDS(num_words);
 	vli += num_words;
 	while (vli-- > end) {
 		uECC_word_t temp = *vli;
@@ -265,6 +319,14 @@ static void uECC_vli_mult(uECC_word_t *result, const uECC_word_t *left,
 	uECC_word_t r2 = 0;
 	wordcount_t i, k;
 
+	FIXED_NUM_WORDS(num_words);
+#if uECC_ARM_USE_UMAAL
+	if (num_words == NUM_ECC_WORDS) {
+		uECC_vli_mult_umaal(result, left, right);
+		return;
+	}
+#endif
+
 	/* Compute each digit of result in sequence, maintaining the carries. */
 	for (k = 0; k < num_words; ++k) {
 
@@ -291,6 +353,59 @@ static void uECC_vli_mult(uECC_word_t *result, const uECC_word_t *left,
 	result[num_words * 2 - 1] = r0;
 }
 
+/* Adds 2 * a * b to the three-word accumulator r2:r1:r0. */
+static void mul2add(uECC_word_t a, uECC_word_t b, uECC_word_t *r0,
+		    uECC_word_t *r1, uECC_word_t *r2)
+{
+
+	uECC_dword_t p = (uECC_dword_t)a * b;
+	uECC_dword_t r01 = ((uECC_dword_t)(*r1) << uECC_WORD_BITS) | *r0;
+	*r2 += (p >> (uECC_WORD_BITS * 2 - 1));
+	p *= 2;
+	r01 += p;
+	*r2 += (r01 < p);
+	*r1 = r01 >> uECC_WORD_BITS;
+	*r0 = (uECC_word_t)r01;
+
+}
+
+/* Computes result = left^2. Result must be 2 * num_words long. Each cross
+ * product left[i] * left[k - i], i < k - i, is computed once and added
+ * twice. */
+static void uECC_vli_square(uECC_word_t *result, const uECC_word_t *left,
+			    wordcount_t num_words)
+{
+
+	uECC_word_t r0 = 0;
+	uECC_word_t r1 = 0;
+	uECC_word_t r2 = 0;
+	wordcount_t i, k;
+
+	FIXED_NUM_WORDS(num_words);
+#if uECC_ARM_USE_UMAAL
+	if (num_words == NUM_ECC_WORDS) {
+		uECC_vli_square_umaal(result, left);
+		return;
+	}
+#endif
+
+	for (k = 0; k < num_words * 2 - 1; ++k) {
+		wordcount_t min = (k < num_words ? 0 : (k + 1) - num_words);
+		for (i = min; i <= k && i <= k - i; ++i) {
+			if (i < k - i) {
+				mul2add(left[i], left[k - i], &r0, &r1, &r2);
+			} else {
+				muladd(left[i], left[k - i], &r0, &r1, &r2);
+			}
+		}
+		result[k] = r0;
+		r0 = r1;
+		r1 = r2;
+		r2 = 0;
+	}
+	result[num_words * 2 - 1] = r0;
+}
+
 void uECC_vli_modAdd(uECC_word_t *result, const uECC_word_t *left,
 		     const uECC_word_t *right, const uECC_word_t *mod,
 		     wordcount_t num_words)
@@ -366,6 +481,8 @@ void uECC_vli_modMult(uECC_word_t *result, const uECC_word_t *left,
 		      wordcount_t num_words)
 {
 	uECC_word_t product[2 * NUM_ECC_WORDS];
+
+	STAT_INC(uECC_STAT_MULT);
 	uECC_vli_mult(product, left, right, num_words);
 	uECC_vli_mmod(result, product, mod, num_words);
 }
@@ -374,80 +491,302 @@ void uECC_vli_modMult_fast(uECC_word_t *result, const uECC_word_t *left,
 			   const uECC_word_t *right, uECC_Curve curve)
 {
 	uECC_word_t product[2 * NUM_ECC_WORDS];
-	uECC_vli_mult(product, left, right, curve->num_words);
 
-	curve->mmod_fast(result, product);
+	STAT_INC(uECC_STAT_MULT);
+	uECC_vli_mult(product, left, right, uECC_NUM_WORDS(curve));
+
+	uECC_MMOD_FAST(result, product, curve);
+}
+
+void uECC_vli_modSquare_fast(uECC_word_t *result, const uECC_word_t *left,
+			     uECC_Curve curve)
+{
+	uECC_word_t product[2 * NUM_ECC_WORDS];
+
+	STAT_INC(uECC_STAT_SQUARE);
+	uECC_vli_square(product, left, uECC_NUM_WORDS(curve));
+
+	uECC_MMOD_FAST(result, product, curve);
+}
+
+/*
+ * Constant-time modular inversion with the safegcd algorithm of Bernstein
+ * and Yang ("Fast constant-time gcd computation and modular inversion",
+ * 2019), in the form used by libsecp256k1's modinv32. Values are held as
+ * nine signed 30-bit limbs; 20 rounds of 30 divsteps each cover the 590
+ * divsteps needed for 256-bit moduli, and every round is applied to f, g
+ * and to the Bezout coefficients d, e as one 2x2 matrix.
+ */
+#define SIGNED30_LIMBS 9
+#define M30 ((int32_t)0x3FFFFFFF)
+
+typedef struct {
+	int32_t v[SIGNED30_LIMBS];
+} vli_signed30;
+
+typedef struct {
+	int32_t u, v, q, r;
+} divsteps_matrix;
+
+static void vli_to_signed30(vli_signed30 *out, const uECC_word_t *vli,
+			    wordcount_t num_words)
+{
+	bitcount_t bit;
+	wordcount_t i;
+
+	for (i = 0; i < SIGNED30_LIMBS; ++i) {
+		out->v[i] = 0;
+	}
+	for (bit = 0; bit < num_words * uECC_WORD_BITS; ++bit) {
+		out->v[bit / 30] |= (int32_t)((vli[bit >> uECC_WORD_BITS_SHIFT] >>
+			(bit & uECC_WORD_BITS_MASK)) & 1) << (bit % 30);
+	}
 }
 
-static void uECC_vli_modSquare_fast(uECC_word_t *result,
-				    const uECC_word_t *left,
-				    uECC_Curve curve)
+static void signed30_to_vli(uECC_word_t *vli, const vli_signed30 *in,
+			    wordcount_t num_words)
 {
-	uECC_vli_modMult_fast(result, left, left, curve);
+	bitcount_t bit;
+
+	uECC_vli_clear(vli, num_words);
+	for (bit = 0; bit < num_words * uECC_WORD_BITS; ++bit) {
+		vli[bit >> uECC_WORD_BITS_SHIFT] |=
+			(uECC_word_t)((in->v[bit / 30] >> (bit % 30)) & 1) <<
+			(bit & uECC_WORD_BITS_MASK);
+	}
 }
 
+/* Runs 30 divsteps on the low bits f0, g0 of f and g, returning the new zeta
+ * (-(delta + 1/2)) and the transition matrix scaled by 2^30. */
+static int32_t divsteps_30(int32_t zeta, uint32_t f0, uint32_t g0,
+			   divsteps_matrix *t)
+{
+	uint32_t u = 1, v = 0, q = 0, r = 1;
+	uint32_t f = f0, g = g0, x, y, z;
+	uint32_t mask1, mask2;
+	int i;
+
+	for (i = 0; i < 30; ++i) {
+		/* masks for zeta < 0 and for g odd: */
+		mask1 = (uint32_t)(zeta >> 31);
+		mask2 = -(g & 1);
+		/* if g is odd, add (f, u, v), negated when zeta < 0, to (g, q, r): */
+		x = (f ^ mask1) - mask1;
+		y = (u ^ mask1) - mask1;
+		z = (v ^ mask1) - mask1;
+		g += x & mask2;
+		q += y & mask2;
+		r += z & mask2;
+		/* if both, swap in: zeta = -zeta - 2 and (f, u, v) += (g, q, r): */
+		mask1 &= mask2;
+		zeta = (zeta ^ (int32_t)mask1) - 1;
+		f += g & mask1;
+		u += q & mask1;
+		v += r & mask1;
+		g >>= 1;
+		u <<= 1;
+		v <<= 1;
+	}
+	t->u = (int32_t)u;
+	t->v = (int32_t)v;
+	t->q = (int32_t)q;
+	t->r = (int32_t)r;
+	return zeta;
+}
 
-#define EVEN(vli) (!(vli[0] & 1))
+/* Computes (d, e) = (t * (d, e) + mod * (md, me)) / 2^30, with md and me
+ * chosen so that the division is exact; d and e stay in (-2 * mod, mod). */
+static void update_de_30(vli_signed30 *d, vli_signed30 *e,
+			 const divsteps_matrix *t, const vli_signed30 *mod,
+			 uint32_t mod_inv30)
+{
+	const int32_t u = t->u, v = t->v, q = t->q, r = t->r;
+	int32_t di, ei, md, me, sd, se;
+	int64_t cd, ce;
+	int i;
+
+	/* start with (u, q) if d is negative, plus (v, r) if e is negative: */
+	sd = d->v[SIGNED30_LIMBS - 1] >> 31;
+	se = e->v[SIGNED30_LIMBS - 1] >> 31;
+	md = (u & sd) + (v & se);
+	me = (q & sd) + (r & se);
+	di = d->v[0];
+	ei = e->v[0];
+	cd = (int64_t)u * di + (int64_t)v * ei;
+	ce = (int64_t)q * di + (int64_t)r * ei;
+	/* make the low 30 bits of the sum zero: */
+	md -= (int32_t)((mod_inv30 * (uint32_t)cd + (uint32_t)md) & M30);
+	me -= (int32_t)((mod_inv30 * (uint32_t)ce + (uint32_t)me) & M30);
+	cd += (int64_t)mod->v[0] * md;
+	ce += (int64_t)mod->v[0] * me;
+	cd >>= 30;
+	ce >>= 30;
+	for (i = 1; i < SIGNED30_LIMBS; ++i) {
+		di = d->v[i];
+		ei = e->v[i];
+		cd += (int64_t)u * di + (int64_t)v * ei;
+		ce += (int64_t)q * di + (int64_t)r * ei;
+		cd += (int64_t)mod->v[i] * md;
+		ce += (int64_t)mod->v[i] * me;
+		d->v[i - 1] = (int32_t)cd & M30;
+		cd >>= 30;
+		e->v[i - 1] = (int32_t)ce & M30;
+		ce >>= 30;
+	}
+	d->v[SIGNED30_LIMBS - 1] = (int32_t)cd;
+	e->v[SIGNED30_LIMBS - 1] = (int32_t)ce;
+}
+
+/* Computes (f, g) = t * (f, g) / 2^30, which is exact by construction. */
+static void update_fg_30(vli_signed30 *f, vli_signed30 *g,
+			 const divsteps_matrix *t)
+{
+	const int32_t u = t->u, v = t->v, q = t->q, r = t->r;
+	int32_t fi, gi;
+	int64_t cf, cg;
+	int i;
+
+	fi = f->v[0];
+	gi = g->v[0];
+	cf = (int64_t)u * fi + (int64_t)v * gi;
+	cg = (int64_t)q * fi + (int64_t)r * gi;
+	cf >>= 30;
+	cg >>= 30;
+	for (i = 1; i < SIGNED30_LIMBS; ++i) {
+		fi = f->v[i];
+		gi = g->v[i];
+		cf += (int64_t)u * fi + (int64_t)v * gi;
+		cg += (int64_t)q * fi + (int64_t)r * gi;
+		f->v[i - 1] = (int32_t)cf & M30;
+		cf >>= 30;
+		g->v[i - 1] = (int32_t)cg & M30;
+		cg >>= 30;
+	}
+	f->v[SIGNED30_LIMBS - 1] = (int32_t)cf;
+	g->v[SIGNED30_LIMBS - 1] = (int32_t)cg;
+}
 
-static void vli_modInv_update(uECC_word_t *uv,
-			      const uECC_word_t *mod,
-			      wordcount_t num_words)
+/* Propagates carries so that limbs 0..7 are back in [0, 2^30). */
+static void signed30_propagate(vli_signed30 *r)
 {
+	int i;
 
-	uECC_word_t carry = 0;
+	for (i = 0; i < SIGNED30_LIMBS - 1; ++i) {
+		r->v[i + 1] += r->v[i] >> 30;
+		r->v[i] &= M30;
+	}
+}
+
+/* Brings d from (-2 * mod, mod) to [0, mod), negated if sign is negative. */
+static void normalize_30(vli_signed30 *d, int32_t sign,
+			 const vli_signed30 *mod)
+{
+	int32_t add = d->v[SIGNED30_LIMBS - 1] >> 31;
+	int32_t negate = sign >> 31;
+	int i;
 
-	if (!EVEN(uv)) {
-		carry = uECC_vli_add(uv, uv, mod, num_words);
+	/* add mod if negative, then negate if asked: now in (-mod, mod) */
+	for (i = 0; i < SIGNED30_LIMBS; ++i) {
+		d->v[i] = ((d->v[i] + (mod->v[i] & add)) ^ negate) - negate;
 	}
-	uECC_vli_rshift1(uv, num_words);
-	if (carry) {
-		uv[num_words - 1] |= HIGH_BIT_SET;
+	signed30_propagate(d);
+	/* add mod if still negative: */
+	add = d->v[SIGNED30_LIMBS - 1] >> 31;
+	for (i = 0; i < SIGNED30_LIMBS; ++i) {
+		d->v[i] += mod->v[i] & add;
 	}
+	signed30_propagate(d);
 }
 
 void uECC_vli_modInv(uECC_word_t *result, const uECC_word_t *input,
 		     const uECC_word_t *mod, wordcount_t num_words)
 {
-	uECC_word_t a[NUM_ECC_WORDS], b[NUM_ECC_WORDS];
-	uECC_word_t u[NUM_ECC_WORDS], v[NUM_ECC_WORDS];
-	cmpresult_t cmpResult;
+	vli_signed30 d, e, f, g, m;
+	divsteps_matrix t;
+	uint32_t mod_inv30;
+	int32_t zeta = -1;
+	int i;
+
+	STAT_START(uECC_STAT_INV);
+
+	vli_to_signed30(&m, mod, num_words);
+	vli_to_signed30(&g, input, num_words);
+	f = m;
+	for (i = 0; i < SIGNED30_LIMBS; ++i) {
+		d.v[i] = 0;
+		e.v[i] = 0;
+	}
+	e.v[0] = 1;
 
-	if (uECC_vli_isZero(input, num_words)) {
-		uECC_vli_clear(result, num_words);
-		return;
+	/* 1 / mod modulo 2^30 by Newton's iteration; mod is odd, so mod is its
+	 * own inverse modulo 2^3 and each step doubles the correct bits. */
+	mod_inv30 = (uint32_t)m.v[0];
+	for (i = 0; i < 4; ++i) {
+		mod_inv30 *= 2 - (uint32_t)m.v[0] * mod_inv30;
 	}
 
-	uECC_vli_set(a, input, num_words);
-	uECC_vli_set(b, mod, num_words);
-	uECC_vli_clear(u, num_words);
-	u[0] = 1;
-	uECC_vli_clear(v, num_words);
-	while ((cmpResult = uECC_vli_cmp_unsafe(a, b, num_words)) != 0) {
-		if (EVEN(a)) {
-			uECC_vli_rshift1(a, num_words);
-      			vli_modInv_update(u, mod, num_words);
-    		} else if (EVEN(b)) {
-			uECC_vli_rshift1(b, num_words);
-			vli_modInv_update(v, mod, num_words);
-		} else if (cmpResult > 0) {
-			uECC_vli_sub(a, a, b, num_words);
-			uECC_vli_rshift1(a, num_words);
-			if (uECC_vli_cmp_unsafe(u, v, num_words) < 0) {
-        			uECC_vli_add(u, u, mod, num_words);
-      			}
-      			uECC_vli_sub(u, u, v, num_words);
-      			vli_modInv_update(u, mod, num_words);
-    		} else {
-      			uECC_vli_sub(b, b, a, num_words);
-      			uECC_vli_rshift1(b, num_words);
-      			if (uECC_vli_cmp_unsafe(v, u, num_words) < 0) {
-        			uECC_vli_add(v, v, mod, num_words);
-      			}
-      			uECC_vli_sub(v, v, u, num_words);
-      			vli_modInv_update(v, mod, num_words);
-    		}
-  	}
-  	uECC_vli_set(result, u, num_words);
+	for (i = 0; i < 20; ++i) {
+		zeta = divsteps_30(zeta, (uint32_t)f.v[0], (uint32_t)g.v[0], &t);
+		update_de_30(&d, &e, &t, &m, mod_inv30);
+		update_fg_30(&f, &g, &t);
+	}
+
+	/* g is now 0 and f is +/-1 (or +/-mod when input was 0, leaving d at 0),
+	 * so d is +/- the inverse. */
+	normalize_30(&d, f.v[SIGNED30_LIMBS - 1], &m);
+	signed30_to_vli(result, &d, num_words);
+
+	STAT_STOP(uECC_STAT_INV);
+}
+
+static void mod_mult(uECC_word_t *result, const uECC_word_t *left,
+		     const uECC_word_t *right, const uECC_word_t *mod,
+		     uECC_Curve curve)
+{
+	if (mod == curve->p) {
+		uECC_vli_modMult_fast(result, left, right, curve);
+	} else {
+		uECC_vli_modMult(result, left, right, mod, uECC_NUM_WORDS(curve));
+	}
+}
+
+void uECC_vli_modInv_batch(uECC_word_t *values, uECC_word_t *scratch,
+			   unsigned int count, const uECC_word_t *mod,
+			   uECC_Curve curve)
+{
+	uECC_word_t inv[NUM_ECC_WORDS];
+	uECC_word_t t[NUM_ECC_WORDS];
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+	uECC_word_t *v;
+	unsigned int i;
+
+	/* scratch[i] = product of the non-zero values[0..i] */
+	uECC_vli_clear(inv, num_words);
+	inv[0] = 1;
+	for (i = 0; i < count; ++i) {
+		v = values + i * num_words;
+		if (!uECC_vli_isZero(v, num_words)) {
+			mod_mult(inv, inv, v, mod, curve);
+		}
+		uECC_vli_set(scratch + i * num_words, inv, num_words);
+	}
+
+	uECC_vli_modInv(inv, inv, mod, num_words);
+
+	/* inv = 1 / scratch[i], so 1 / values[i] = inv * scratch[i - 1] */
+	for (i = count; i-- > 0;) {
+		v = values + i * num_words;
+		if (uECC_vli_isZero(v, num_words)) {
+			continue;
+		}
+		if (i > 0) {
+			mod_mult(t, inv, scratch + (i - 1) * num_words, mod, curve);
+		} else {
+			uECC_vli_set(t, inv, num_words);
+		}
+		mod_mult(inv, inv, v, mod, curve);
+		uECC_vli_set(v, t, num_words);
+	}
 }
 
 /* ------ Point operations ------ */
@@ -458,12 +797,14 @@ void double_jacobian_default(uECC_word_t * X1, uECC_word_t * Y1,
 	/* t1 = X, t2 = Y, t3 = Z */
 	uECC_word_t t4[NUM_ECC_WORDS];
 	uECC_word_t t5[NUM_ECC_WORDS];
-	wordcount_t num_words = curve->num_words;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
 
 	if (uECC_vli_isZero(Z1, num_words)) {
 		return;
 	}
 
+	STAT_START(uECC_STAT_DOUBLE);
+
 	uECC_vli_modSquare_fast(t4, Y1, curve);   /* t4 = y1^2 */
 	uECC_vli_modMult_fast(t5, X1, t4, curve); /* t5 = x1*y1^2 = A */
 	uECC_vli_modSquare_fast(t4, t4, curve);   /* t4 = y1^4 */
@@ -497,6 +838,8 @@ void double_jacobian_default(uECC_word_t * X1, uECC_word_t * Y1,
 	uECC_vli_set(X1, Z1, num_words);
 	uECC_vli_set(Z1, Y1, num_words);
 	uECC_vli_set(Y1, t4, num_words);
+
+	STAT_STOP(uECC_STAT_DOUBLE);
 }
 
 void x_side_default(uECC_word_t *result,
@@ -504,7 +847,7 @@ void x_side_default(uECC_word_t *result,
 		    uECC_Curve curve)
 {
 	uECC_word_t _3[NUM_ECC_WORDS] = {3}; /* -a = 3 */
-	wordcount_t num_words = curve->num_words;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
 
 	uECC_vli_modSquare_fast(result, x, curve); /* r = x^2 */
 	uECC_vli_modSub(result, result, _3, curve->p, num_words); /* r = x^2 - 3 */
@@ -513,19 +856,114 @@ void x_side_default(uECC_word_t *result,
 	uECC_vli_modAdd(result, result, curve->b, curve->p, num_words);
 }
 
+/* Computes result = input^(2^n) mod p. */
+static void mod_square_n(uECC_word_t *result, const uECC_word_t *input,
+			 unsigned int n, uECC_Curve curve)
+{
+	uECC_vli_modSquare_fast(result, input, curve);
+	while (--n) {
+		uECC_vli_modSquare_fast(result, result, curve);
+	}
+}
+
+void mod_sqrt_secp256r1(uECC_word_t *a, uECC_Curve curve)
+{
+	/* p = 3 mod 4, so sqrt(a) = a^((p + 1) / 4), and
+	 * (p + 1) / 4 = 2^94 * ((2^32 - 1) * 2^128 + 2^96 + 1). */
+	uECC_word_t t[NUM_ECC_WORDS];
+	uECC_word_t r[NUM_ECC_WORDS];
+
+	mod_square_n(t, a, 1, curve);
+	uECC_vli_modMult_fast(t, t, a, curve);     /* t = a^(2^2 - 1) */
+	mod_square_n(r, t, 2, curve);
+	uECC_vli_modMult_fast(t, r, t, curve);     /* t = a^(2^4 - 1) */
+	mod_square_n(r, t, 4, curve);
+	uECC_vli_modMult_fast(t, r, t, curve);     /* t = a^(2^8 - 1) */
+	mod_square_n(r, t, 8, curve);
+	uECC_vli_modMult_fast(t, r, t, curve);     /* t = a^(2^16 - 1) */
+	mod_square_n(r, t, 16, curve);
+	uECC_vli_modMult_fast(t, r, t, curve);     /* t = a^(2^32 - 1) */
+
+	mod_square_n(r, t, 32, curve);
+	uECC_vli_modMult_fast(r, r, a, curve);
+	mod_square_n(r, r, 96, curve);
+	uECC_vli_modMult_fast(r, r, a, curve);
+	mod_square_n(a, r, 94, curve);
+}
+
 uECC_Curve uECC_secp256r1(void)
 {
 	return &curve_secp256r1;
 }
 
-void vli_mmod_fast_secp256r1(unsigned int *result, unsigned int*product)
+void vli_mmod_fast_secp256r1(uECC_word_t *result, uECC_word_t *product)
 {
-	unsigned int tmp[NUM_ECC_WORDS];
+	uECC_word_t tmp[NUM_ECC_WORDS];
 	int carry;
 
 	/* t */
 	uECC_vli_set(result, product, NUM_ECC_WORDS);
 
+#if uECC_WORD_SIZE == 8
+	/* s1 */
+	tmp[0] = 0;
+	tmp[1] = product[5] & 0xffffffff00000000ull;
+	tmp[2] = product[6];
+	tmp[3] = product[7];
+	carry = (int)uECC_vli_add(tmp, tmp, tmp, NUM_ECC_WORDS);
+	carry += uECC_vli_add(result, result, tmp, NUM_ECC_WORDS);
+
+	/* s2 */
+	tmp[0] = 0;
+	tmp[1] = product[6] << 32;
+	tmp[2] = (product[6] >> 32) | (product[7] << 32);
+	tmp[3] = product[7] >> 32;
+	carry += uECC_vli_add(tmp, tmp, tmp, NUM_ECC_WORDS);
+	carry += uECC_vli_add(result, result, tmp, NUM_ECC_WORDS);
+
+	/* s3 */
+	tmp[0] = product[4];
+	tmp[1] = product[5] & 0xffffffff;
+	tmp[2] = 0;
+	tmp[3] = product[7];
+	carry += uECC_vli_add(result, result, tmp, NUM_ECC_WORDS);
+
+	/* s4 */
+	tmp[0] = (product[4] >> 32) | (product[5] << 32);
+	tmp[1] = (product[5] >> 32) | (product[6] & 0xffffffff00000000ull);
+	tmp[2] = product[7];
+	tmp[3] = (product[6] >> 32) | (product[4] << 32);
+	carry += uECC_vli_add(result, result, tmp, NUM_ECC_WORDS);
+
+	/* d1 */
+	tmp[0] = (product[5] >> 32) | (product[6] << 32);
+	tmp[1] = product[6] >> 32;
+	tmp[2] = 0;
+	tmp[3] = (product[4] & 0xffffffff) | (product[5] << 32);
+	carry -= uECC_vli_sub(result, result, tmp, NUM_ECC_WORDS);
+
+	/* d2 */
+	tmp[0] = product[6];
+	tmp[1] = product[7];
+	tmp[2] = 0;
+	tmp[3] = (product[4] >> 32) | (product[5] & 0xffffffff00000000ull);
+	carry -= uECC_vli_sub(result, result, tmp, NUM_ECC_WORDS);
+
+	/* d3 */
+	tmp[0] = (product[6] >> 32) | (product[7] << 32);
+	tmp[1] = (product[7] >> 32) | (product[4] << 32);
+	tmp[2] = (product[4] >> 32) | (product[5] << 32);
+	tmp[3] = product[6] << 32;
+	carry -= uECC_vli_sub(result, result, tmp, NUM_ECC_WORDS);
+
+	/* d4 */
+	tmp[0] = product[7];
+	tmp[1] = product[4] & 0xffffffff00000000ull;
+	tmp[2] = product[5];
+	tmp[3] = product[6] & 0xffffffff00000000ull;
+	carry -= uECC_vli_sub(result, result, tmp, NUM_ECC_WORDS);
+#else
+
 	/* s1 */
 	tmp[0] = tmp[1] = tmp[2] = 0;
 	tmp[3] = product[11];
@@ -605,6 +1043,7 @@ void vli_mmod_fast_secp256r1(unsigned int *result, unsigned int*product)
 	tmp[6] = 0;
 	tmp[7] = product[13];
 	carry -= uECC_vli_sub(result, result, tmp, NUM_ECC_WORDS);
+#endif
 
 	if (carry < 0) {
 		do {
@@ -619,9 +1058,201 @@ void vli_mmod_fast_secp256r1(unsigned int *result, unsigned int*product)
 	}
 }
 
+#if uECC_SUPPORTS_secp256k1
+static const struct uECC_Curve_t curve_secp256k1;
+
+static void double_jacobian_secp256k1(uECC_word_t * X1, uECC_word_t * Y1,
+				      uECC_word_t * Z1, uECC_Curve curve)
+{
+	/* t1 = X, t2 = Y, t3 = Z */
+	uECC_word_t t4[NUM_ECC_WORDS];
+	uECC_word_t t5[NUM_ECC_WORDS];
+	uECC_word_t carry;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+
+	if (uECC_vli_isZero(Z1, num_words)) {
+		return;
+	}
+
+	STAT_START(uECC_STAT_DOUBLE);
+
+	uECC_vli_modSquare_fast(t5, Y1, curve);   /* t5 = y1^2 */
+	uECC_vli_modMult_fast(t4, X1, t5, curve); /* t4 = x1*y1^2 = A */
+	uECC_vli_modSquare_fast(X1, X1, curve);   /* t1 = x1^2 */
+	uECC_vli_modSquare_fast(t5, t5, curve);   /* t5 = y1^4 */
+	uECC_vli_modMult_fast(Z1, Y1, Z1, curve); /* t3 = y1*z1 = z3 */
+
+	uECC_vli_modAdd(Y1, X1, X1, curve->p, num_words); /* t2 = 2*x1^2 */
+	uECC_vli_modAdd(Y1, Y1, X1, curve->p, num_words); /* t2 = 3*x1^2 */
+	if (uECC_vli_testBit(Y1, 0)) {
+		carry = uECC_vli_add(Y1, Y1, curve->p, num_words);
+		uECC_vli_rshift1(Y1, num_words);
+		Y1[num_words - 1] |= carry << (uECC_WORD_BITS - 1);
+	} else {
+		uECC_vli_rshift1(Y1, num_words);
+	}
+	/* t2 = 3/2*(x1^2) = B */
+
+	uECC_vli_modSquare_fast(X1, Y1, curve); /* t1 = B^2 */
+	uECC_vli_modSub(X1, X1, t4, curve->p, num_words); /* t1 = B^2 - A */
+	uECC_vli_modSub(X1, X1, t4, curve->p, num_words); /* t1 = B^2 - 2A = x3 */
+
+	uECC_vli_modSub(t4, t4, X1, curve->p, num_words); /* t4 = A - x3 */
+	uECC_vli_modMult_fast(Y1, Y1, t4, curve); /* t2 = B * (A - x3) */
+	/* t2 = B * (A - x3) - y1^4 = y3: */
+	uECC_vli_modSub(Y1, Y1, t5, curve->p, num_words);
+
+	STAT_STOP(uECC_STAT_DOUBLE);
+}
+
+static void x_side_secp256k1(uECC_word_t *result, const uECC_word_t *x,
+			     uECC_Curve curve)
+{
+	uECC_vli_modSquare_fast(result, x, curve); /* r = x^2 */
+	uECC_vli_modMult_fast(result, result, x, curve); /* r = x^3 */
+	/* r = x^3 + b: */
+	uECC_vli_modAdd(result, result, curve->b, curve->p, uECC_NUM_WORDS(curve));
+}
+
+/* Computes result = right * (2^32 + 977), result having NUM_ECC_WORDS + 2
+ * words. */
+static void omega_mult_secp256k1(uECC_word_t *result, const uECC_word_t *right)
+{
+	uECC_word_t carry = 0;
+	uECC_dword_t p;
+	wordcount_t k;
+
+#if uECC_WORD_SIZE == 8
+	for (k = 0; k < NUM_ECC_WORDS; ++k) {
+		p = (uECC_dword_t)0x1000003D1ull * right[k] + carry;
+		result[k] = (uECC_word_t)p;
+		carry = (uECC_word_t)(p >> 64);
+	}
+	result[NUM_ECC_WORDS] = carry;
+	result[NUM_ECC_WORDS + 1] = 0;
+#else
+	for (k = 0; k < NUM_ECC_WORDS; ++k) {
+		p = (uECC_dword_t)0x3D1 * right[k] + carry;
+		result[k] = (uECC_word_t)p;
+		carry = (uECC_word_t)(p >> 32);
+	}
+	result[NUM_ECC_WORDS] = carry;
+	/* add the 2^32 multiple */
+	result[NUM_ECC_WORDS + 1] = uECC_vli_add(result + 1, result + 1, right,
+						 NUM_ECC_WORDS);
+#endif
+}
+
+/* 2^256 = 2^32 + 977 mod p, so the high half of product folds into the low
+ * half after multiplying by 2^32 + 977, twice. */
+static void vli_mmod_fast_secp256k1(uECC_word_t *result, uECC_word_t *product)
+{
+	uECC_word_t tmp[2 * NUM_ECC_WORDS];
+	uECC_word_t carry;
+
+	uECC_vli_clear(tmp, 2 * NUM_ECC_WORDS);
+	omega_mult_secp256k1(tmp, product + NUM_ECC_WORDS); /* (rq, q) = h * c */
+	carry = uECC_vli_add(result, product, tmp, NUM_ECC_WORDS); /* r = l + q */
+
+	uECC_vli_clear(product, NUM_ECC_WORDS + 2);
+	omega_mult_secp256k1(product, tmp + NUM_ECC_WORDS); /* rq * c */
+	carry += uECC_vli_add(result, result, product, NUM_ECC_WORDS);
+
+	/* each carry is 2^256 = p + c: subtracting p wraps around to + c */
+	while (carry > 0) {
+		--carry;
+		uECC_vli_sub(result, result, curve_secp256k1.p, NUM_ECC_WORDS);
+	}
+	if (uECC_vli_cmp_unsafe(curve_secp256k1.p, result, NUM_ECC_WORDS) != 1) {
+		uECC_vli_sub(result, result, curve_secp256k1.p, NUM_ECC_WORDS);
+	}
+}
+
+static void mod_sqrt_secp256k1(uECC_word_t *a, uECC_Curve curve)
+{
+	/* a^((p + 1) / 4) with the addition chain of libsecp256k1; x_k below
+	 * is a^(2^k - 1). */
+	uECC_word_t x2[NUM_ECC_WORDS];
+	uECC_word_t x3[NUM_ECC_WORDS];
+	uECC_word_t x22[NUM_ECC_WORDS];
+	uECC_word_t x44[NUM_ECC_WORDS];
+	uECC_word_t t[NUM_ECC_WORDS];
+	uECC_word_t r[NUM_ECC_WORDS];
+
+	mod_square_n(x2, a, 1, curve);
+	uECC_vli_modMult_fast(x2, x2, a, curve);
+	mod_square_n(x3, x2, 1, curve);
+	uECC_vli_modMult_fast(x3, x3, a, curve);
+	mod_square_n(t, x3, 3, curve);
+	uECC_vli_modMult_fast(t, t, x3, curve);      /* x6 */
+	mod_square_n(t, t, 3, curve);
+	uECC_vli_modMult_fast(t, t, x3, curve);      /* x9 */
+	mod_square_n(t, t, 2, curve);
+	uECC_vli_modMult_fast(t, t, x2, curve);      /* x11 */
+	mod_square_n(x22, t, 11, curve);
+	uECC_vli_modMult_fast(x22, x22, t, curve);
+	mod_square_n(x44, x22, 22, curve);
+	uECC_vli_modMult_fast(x44, x44, x22, curve);
+	mod_square_n(t, x44, 44, curve);
+	uECC_vli_modMult_fast(t, t, x44, curve);     /* x88 */
+	mod_square_n(r, t, 88, curve);
+	uECC_vli_modMult_fast(r, r, t, curve);       /* x176 */
+	mod_square_n(r, r, 44, curve);
+	uECC_vli_modMult_fast(r, r, x44, curve);     /* x220 */
+	mod_square_n(r, r, 3, curve);
+	uECC_vli_modMult_fast(r, r, x3, curve);      /* x223 */
+
+	mod_square_n(r, r, 23, curve);
+	uECC_vli_modMult_fast(r, r, x22, curve);
+	mod_square_n(r, r, 6, curve);
+	uECC_vli_modMult_fast(r, r, x2, curve);
+	mod_square_n(a, r, 2, curve);
+}
+
+static const struct uECC_Curve_t curve_secp256k1 = {
+	NUM_ECC_WORDS,
+	NUM_ECC_BYTES,
+	256, /* num_n_bits */ {
+		BYTES_TO_WORDS_8(2F, FC, FF, FF, FE, FF, FF, FF),
+		BYTES_TO_WORDS_8(FF, FF, FF, FF, FF, FF, FF, FF),
+		BYTES_TO_WORDS_8(FF, FF, FF, FF, FF, FF, FF, FF),
+		BYTES_TO_WORDS_8(FF, FF, FF, FF, FF, FF, FF, FF)
+	}, {
+		BYTES_TO_WORDS_8(41, 41, 36, D0, 8C, 5E, D2, BF),
+		BYTES_TO_WORDS_8(3B, A0, 48, AF, E6, DC, AE, BA),
+		BYTES_TO_WORDS_8(FE, FF, FF, FF, FF, FF, FF, FF),
+		BYTES_TO_WORDS_8(FF, FF, FF, FF, FF, FF, FF, FF)
+	}, {
+		BYTES_TO_WORDS_8(98, 17, F8, 16, 5B, 81, F2, 59),
+		BYTES_TO_WORDS_8(D9, 28, CE, 2D, DB, FC, 9B, 02),
+		BYTES_TO_WORDS_8(07, 0B, 87, CE, 95, 62, A0, 55),
+		BYTES_TO_WORDS_8(AC, BB, DC, F9, 7E, 66, BE, 79),
+
+		BYTES_TO_WORDS_8(B8, D4, 10, FB, 8F, D0, 47, 9C),
+		BYTES_TO_WORDS_8(19, 54, 85, A6, 48, B4, 17, FD),
+		BYTES_TO_WORDS_8(A8, 08, 11, 0E, FC, FB, A4, 5D),
+		BYTES_TO_WORDS_8(65, C4, A3, 26, 77, DA, 3A, 48)
+	}, {
+		BYTES_TO_WORDS_8(07, 00, 00, 00, 00, 00, 00, 00),
+		BYTES_TO_WORDS_8(00, 00, 00, 00, 00, 00, 00, 00),
+		BYTES_TO_WORDS_8(00, 00, 00, 00, 00, 00, 00, 00),
+		BYTES_TO_WORDS_8(00, 00, 00, 00, 00, 00, 00, 00)
+	},
+	&double_jacobian_secp256k1,
+	&x_side_secp256k1,
+	&vli_mmod_fast_secp256k1,
+	&mod_sqrt_secp256k1
+};
+
+uECC_Curve uECC_secp256k1(void)
+{
+	return &curve_secp256k1;
+}
+#endif /* uECC_SUPPORTS_secp256k1 */
+
 uECC_word_t EccPoint_isZero(const uECC_word_t *point, uECC_Curve curve)
 {
-	return uECC_vli_isZero(point, curve->num_words * 2);
+	return uECC_vli_isZero(point, uECC_NUM_WORDS(curve) * 2);
 }
 
 void apply_z(uECC_word_t * X1, uECC_word_t * Y1, const uECC_word_t * const Z,
@@ -642,7 +1273,7 @@ static void XYcZ_initial_double(uECC_word_t * X1, uECC_word_t * Y1,
 				uECC_Curve curve)
 {
 	uECC_word_t z[NUM_ECC_WORDS];
-	wordcount_t num_words = curve->num_words;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
 	if (initial_Z) {
 		uECC_vli_set(z, initial_Z, num_words);
 	} else {
@@ -654,7 +1285,7 @@ static void XYcZ_initial_double(uECC_word_t * X1, uECC_word_t * Y1,
 	uECC_vli_set(Y2, Y1, num_words);
 
 	apply_z(X1, Y1, z, curve);
-	curve->double_jacobian(X1, Y1, z, curve);
+	uECC_DOUBLE_JACOBIAN(X1, Y1, z, curve);
 	apply_z(X2, Y2, z, curve);
 }
 
@@ -664,7 +1295,9 @@ void XYcZ_add(uECC_word_t * X1, uECC_word_t * Y1,
 {
 	/* t1 = X1, t2 = Y1, t3 = X2, t4 = Y2 */
 	uECC_word_t t5[NUM_ECC_WORDS];
-	wordcount_t num_words = curve->num_words;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+
+	STAT_START(uECC_STAT_ADD);
 
 	uECC_vli_modSub(t5, X2, X1, curve->p, num_words); /* t5 = x2 - x1 */
 	uECC_vli_modSquare_fast(t5, t5, curve); /* t5 = (x2 - x1)^2 = A */
@@ -682,6 +1315,8 @@ void XYcZ_add(uECC_word_t * X1, uECC_word_t * Y1,
 	uECC_vli_modSub(Y2, Y2, Y1, curve->p, num_words); /* t4 = y3 */
 
 	uECC_vli_set(X2, t5, num_words);
+
+	STAT_STOP(uECC_STAT_ADD);
 }
 
 /* Input P = (x1, y1, Z), Q = (x2, y2, Z)
@@ -696,7 +1331,9 @@ static void XYcZ_addC(uECC_word_t * X1, uECC_word_t * Y1,
 	uECC_word_t t5[NUM_ECC_WORDS];
 	uECC_word_t t6[NUM_ECC_WORDS];
 	uECC_word_t t7[NUM_ECC_WORDS];
-	wordcount_t num_words = curve->num_words;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+
+	STAT_START(uECC_STAT_ADDC);
 
 	uECC_vli_modSub(t5, X2, X1, curve->p, num_words); /* t5 = x2 - x1 */
 	uECC_vli_modSquare_fast(t5, t5, curve); /* t5 = (x2 - x1)^2 = A */
@@ -724,20 +1361,34 @@ static void XYcZ_addC(uECC_word_t * X1, uECC_word_t * Y1,
 	uECC_vli_modSub(Y1, t6, Y1, curve->p, num_words);
 
 	uECC_vli_set(X1, t7, num_words);
+
+	STAT_STOP(uECC_STAT_ADDC);
 }
 
 void EccPoint_mult(uECC_word_t * result, const uECC_word_t * point,
 		   const uECC_word_t * scalar,
 		   const uECC_word_t * initial_Z,
 		   bitcount_t num_bits, uECC_Curve curve) 
+{
+	uECC_word_t ws[uECC_MULT_WS_WORDS];
+
+	EccPoint_mult_ws(result, point, scalar, initial_Z, num_bits, curve, ws);
+}
+
+void EccPoint_mult_ws(uECC_word_t * result, const uECC_word_t * point,
+		      const uECC_word_t * scalar,
+		      const uECC_word_t * initial_Z,
+		      bitcount_t num_bits, uECC_Curve curve, uECC_word_t *ws)
 {
 	/* R0 and R1 */
-	uECC_word_t Rx[2][NUM_ECC_WORDS];
-	uECC_word_t Ry[2][NUM_ECC_WORDS];
-	uECC_word_t z[NUM_ECC_WORDS];
+	uECC_word_t *Rx[2] = { ws, ws + NUM_ECC_WORDS };
+	uECC_word_t *Ry[2] = { ws + 2 * NUM_ECC_WORDS, ws + 3 * NUM_ECC_WORDS };
+	uECC_word_t *z = ws + 4 * NUM_ECC_WORDS;
 	bitcount_t i;
 	uECC_word_t nb;
-	wordcount_t num_words = curve->num_words;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+
+	STAT_START(uECC_STAT_POINT_MULT);
 
 	uECC_vli_set(Rx[1], point, num_words);
   	uECC_vli_set(Ry[1], point + num_words, num_words);
@@ -769,15 +1420,53 @@ void EccPoint_mult(uECC_word_t * result, const uECC_word_t * point,
 
 	uECC_vli_set(result, Rx[0], num_words);
 	uECC_vli_set(result + num_words, Ry[0], num_words);
+
+	STAT_STOP(uECC_STAT_POINT_MULT);
+}
+
+#if defined(TINYCRYPT_ACCEL)
+int EccPoint_mult_accel(uECC_word_t *result, const uECC_word_t *point,
+			const uECC_word_t *scalar, uECC_Curve curve)
+{
+	/* the result, then the point and the scalar, big-endian */
+	uint8_t buf[2 * TC_ACCEL_P256_POINT_SIZE + TC_ACCEL_P256_SCALAR_SIZE];
+	uint8_t *_result = buf;
+	uint8_t *_point = buf + TC_ACCEL_P256_POINT_SIZE;
+	uint8_t *_scalar = buf + 2 * TC_ACCEL_P256_POINT_SIZE;
+	int r = 0;
+
+	if (curve != uECC_secp256r1() || uECC_vli_isZero(scalar, NUM_ECC_WORDS) ||
+	    uECC_vli_cmp(curve->n, scalar, NUM_ECC_WORDS) != 1) {
+		return 0;
+	}
+
+	uECC_vli_nativeToBytes(_scalar, NUM_ECC_BYTES, scalar);
+	if (point) {
+		uECC_vli_nativeToBytes(_point, NUM_ECC_BYTES, point);
+		uECC_vli_nativeToBytes(_point + NUM_ECC_BYTES, NUM_ECC_BYTES,
+				       point + NUM_ECC_WORDS);
+	}
+
+	if (tc_accel_p256_mult(_result, point ? _point : 0, _scalar)) {
+		uECC_vli_bytesToNative(result, _result, NUM_ECC_BYTES);
+		uECC_vli_bytesToNative(result + NUM_ECC_WORDS,
+				       _result + NUM_ECC_BYTES, NUM_ECC_BYTES);
+		/* a faulty engine must not leak a point off the curve */
+		r = uECC_valid_point(result, curve) == 0;
+	}
+
+	_set_secure(buf, 0, sizeof(buf));
+	return r;
 }
+#endif
 
 uECC_word_t regularize_k(const uECC_word_t * const k, uECC_word_t *k0,
 			 uECC_word_t *k1, uECC_Curve curve)
 {
 
-	wordcount_t num_n_words = BITS_TO_WORDS(curve->num_n_bits);
+	wordcount_t num_n_words = BITS_TO_WORDS(uECC_NUM_N_BITS(curve));
 
-	bitcount_t num_n_bits = curve->num_n_bits;
+	bitcount_t num_n_bits = uECC_NUM_N_BITS(curve);
 
 	uECC_word_t carry = uECC_vli_add(k0, k, curve->n, num_n_words) ||
 			     (num_n_bits < ((bitcount_t)num_n_words * uECC_WORD_SIZE * 8) &&
@@ -792,17 +1481,43 @@ uECC_word_t EccPoint_compute_public_key(uECC_word_t *result,
 					uECC_word_t *private_key,
 					uECC_Curve curve)
 {
+	uECC_word_t ws[uECC_PUBKEY_WS_WORDS];
 
-	uECC_word_t tmp1[NUM_ECC_WORDS];
- 	uECC_word_t tmp2[NUM_ECC_WORDS];
+	return EccPoint_compute_public_key_ws(result, private_key, curve, ws);
+}
+
+uECC_word_t EccPoint_compute_public_key_ws(uECC_word_t *result,
+					   uECC_word_t *private_key,
+					   uECC_Curve curve, uECC_word_t *ws)
+{
+
+	uECC_word_t *tmp1 = ws;
+	uECC_word_t *tmp2 = ws + NUM_ECC_WORDS;
 	uECC_word_t *p2[2] = {tmp1, tmp2};
 	uECC_word_t carry;
 
-	/* Regularize the bitcount for the private key so that attackers cannot
-	 * use a side channel attack to learn the number of leading zeros. */
-	carry = regularize_k(private_key, tmp1, tmp2, curve);
-
-	EccPoint_mult(result, curve->G, p2[!carry], 0, curve->num_n_bits + 1, curve);
+#if defined(TINYCRYPT_ACCEL)
+	if (EccPoint_mult_accel(result, 0, private_key, curve)) {
+		/* done by the accelerator */
+	} else
+#endif
+#if uECC_FIXED_BASE_TEETH > 0
+	/* The comb runs over every bit of the scalar, so no regularization
+	 * is needed. Its table holds multiples of the p-256 generator. */
+	if (curve == &curve_secp256r1) {
+		EccPoint_mult_base_ws(result, private_key, curve, ws);
+	} else
+#endif
+	{
+		/* Regularize the bitcount for the private key so that attackers
+		 * cannot use a side channel attack to learn the number of
+		 * leading zeros. */
+		carry = regularize_k(private_key, tmp1, tmp2, curve);
+
+		EccPoint_mult_ws(result, curve->G, p2[!carry], 0,
+				 uECC_NUM_N_BITS(curve) + 1, curve,
+				 ws + 2 * NUM_ECC_WORDS);
+	}
 
 	if (EccPoint_isZero(result, curve)) {
 		return 0;
@@ -812,7 +1527,7 @@ uECC_word_t EccPoint_compute_public_key(uECC_word_t *result,
 
 /* Converts an integer in uECC native format to big-endian bytes. */
 void uECC_vli_nativeToBytes(uint8_t *bytes, int num_bytes,
-			    const unsigned int *native)
+			    const uECC_word_t *native)
 {
 	wordcount_t i;
 	for (i = 0; i < num_bytes; ++i) {
@@ -822,7 +1537,7 @@ void uECC_vli_nativeToBytes(uint8_t *bytes, int num_bytes,
 }
 
 /* Converts big-endian bytes to an integer in uECC native format. */
-void uECC_vli_bytesToNative(unsigned int *native, const uint8_t *bytes,
+void uECC_vli_bytesToNative(uECC_word_t *native, const uint8_t *bytes,
 			    int num_bytes)
 {
 	wordcount_t i;
@@ -836,17 +1551,27 @@ void uECC_vli_bytesToNative(unsigned int *native, const uint8_t *bytes,
 
 int uECC_generate_random_int(uECC_word_t *random, const uECC_word_t *top,
 			     wordcount_t num_words)
+{
+	return uECC_generate_random_int_with_rng(random, top, num_words,
+						 g_rng_function ?
+						 &uECC_global_rng : 0, 0);
+}
+
+int uECC_generate_random_int_with_rng(uECC_word_t *random,
+				      const uECC_word_t *top,
+				      wordcount_t num_words,
+				      uECC_RNG_Ctx_Function rng, void *rng_ctx)
 {
 	uECC_word_t mask = (uECC_word_t)-1;
 	uECC_word_t tries;
 	bitcount_t num_bits = uECC_vli_numBits(top, num_words);
 
-	if (!g_rng_function) {
+	if (!rng) {
 		return 0;
 	}
 
 	for (tries = 0; tries < uECC_RNG_MAX_TRIES; ++tries) {
-		if (!g_rng_function((uint8_t *)random, num_words * uECC_WORD_SIZE)) {
+		if (!rng(rng_ctx, (uint8_t *)random, num_words * uECC_WORD_SIZE)) {
       			return 0;
     		}
 		random[num_words - 1] &=
@@ -864,7 +1589,7 @@ int uECC_valid_point(const uECC_word_t *point, uECC_Curve curve)
 {
 	uECC_word_t tmp1[NUM_ECC_WORDS];
 	uECC_word_t tmp2[NUM_ECC_WORDS];
-	wordcount_t num_words = curve->num_words;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
 
 	/* The point at infinity is invalid. */
 	if (EccPoint_isZero(point, curve)) {
@@ -878,7 +1603,7 @@ int uECC_valid_point(const uECC_word_t *point, uECC_Curve curve)
 	}
 
 	uECC_vli_modSquare_fast(tmp1, point + num_words, curve);
-	curve->x_side(tmp2, point, curve); /* tmp2 = x^3 + ax + b */
+	uECC_X_SIDE(tmp2, point, curve); /* tmp2 = x^3 + ax + b */
 
 	/* Make sure that y^2 == x^3 + ax + b */
 	if (uECC_vli_equal(tmp1, tmp2, num_words) != 0)
@@ -892,11 +1617,11 @@ int uECC_valid_public_key(const uint8_t *public_key, uECC_Curve curve)
 
 	uECC_word_t _public[NUM_ECC_WORDS * 2];
 
-	uECC_vli_bytesToNative(_public, public_key, curve->num_bytes);
+	uECC_vli_bytesToNative(_public, public_key, uECC_NUM_BYTES(curve));
 	uECC_vli_bytesToNative(
-	_public + curve->num_words,
-	public_key + curve->num_bytes,
-	curve->num_bytes);
+	_public + uECC_NUM_WORDS(curve),
+	public_key + uECC_NUM_BYTES(curve),
+	uECC_NUM_BYTES(curve));
 
 	if (uECC_vli_cmp_unsafe(_public, curve->G, NUM_ECC_WORDS * 2) == 0) {
 		return -4;
@@ -905,6 +1630,52 @@ int uECC_valid_public_key(const uint8_t *public_key, uECC_Curve curve)
 	return uECC_valid_point(_public, curve);
 }
 
+void uECC_compress(const uint8_t *public_key, uint8_t *compressed,
+		   uECC_Curve curve)
+{
+	wordcount_t i;
+
+	for (i = 0; i < uECC_NUM_BYTES(curve); ++i) {
+		compressed[i + 1] = public_key[i];
+	}
+	compressed[0] = 2 + (public_key[uECC_NUM_BYTES(curve) * 2 - 1] & 0x01);
+}
+
+int uECC_decompress(const uint8_t *compressed, uint8_t *public_key,
+		    uECC_Curve curve)
+{
+	uECC_word_t point[NUM_ECC_WORDS * 2];
+	uECC_word_t *y = point + uECC_NUM_WORDS(curve);
+
+	if (compressed[0] != 2 && compressed[0] != 3) {
+		return 0;
+	}
+
+	uECC_vli_bytesToNative(point, compressed + 1, uECC_NUM_BYTES(curve));
+
+	/* x must be smaller than p; the curve equation needs reduced values. */
+	if (uECC_vli_cmp_unsafe(curve->p, point, uECC_NUM_WORDS(curve)) != 1) {
+		return 0;
+	}
+
+	uECC_X_SIDE(y, point, curve);
+	uECC_MOD_SQRT(y, curve);
+
+	if ((y[0] & 0x01) != (compressed[0] & 0x01)) {
+		uECC_vli_sub(y, curve->p, y, uECC_NUM_WORDS(curve));
+	}
+
+	/* Fails if x^3 + ax + b has no square root, i.e. x is not on the
+	 * curve. */
+	if (uECC_valid_point(point, curve) != 0) {
+		return 0;
+	}
+
+	uECC_vli_nativeToBytes(public_key, uECC_NUM_BYTES(curve), point);
+	uECC_vli_nativeToBytes(public_key + uECC_NUM_BYTES(curve), uECC_NUM_BYTES(curve), y);
+	return 1;
+}
+
 int uECC_compute_public_key(const uint8_t *private_key, uint8_t *public_key,
 			    uECC_Curve curve)
 {
@@ -915,14 +1686,14 @@ int uECC_compute_public_key(const uint8_t *private_key, uint8_t *public_key,
 	uECC_vli_bytesToNative(
 	_private,
 	private_key,
-	BITS_TO_BYTES(curve->num_n_bits));
+	BITS_TO_BYTES(uECC_NUM_N_BITS(curve)));
 
 	/* Make sure the private key is in the range [1, n-1]. */
-	if (uECC_vli_isZero(_private, BITS_TO_WORDS(curve->num_n_bits))) {
+	if (uECC_vli_isZero(_private, BITS_TO_WORDS(uECC_NUM_N_BITS(curve)))) {
 		return 0;
 	}
 
-	if (uECC_vli_cmp(curve->n, _private, BITS_TO_WORDS(curve->num_n_bits)) != 1) {
+	if (uECC_vli_cmp(curve->n, _private, BITS_TO_WORDS(uECC_NUM_N_BITS(curve))) != 1) {
 		return 0;
 	}
 
@@ -931,10 +1702,10 @@ int uECC_compute_public_key(const uint8_t *private_key, uint8_t *public_key,
 		return 0;
 	}
 
-	uECC_vli_nativeToBytes(public_key, curve->num_bytes, _public);
+	uECC_vli_nativeToBytes(public_key, uECC_NUM_BYTES(curve), _public);
 	uECC_vli_nativeToBytes(
 	public_key +
-	curve->num_bytes, curve->num_bytes, _public + curve->num_words);
+	uECC_NUM_BYTES(curve), uECC_NUM_BYTES(curve), _public + uECC_NUM_WORDS(curve));
 	return 1;
 }
 
@@ -0,0 +1,570 @@
+/* ecc_arm.c - TinyCrypt ARM assembly kernels for secp256r1 arithmetic */
+
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/ecc.h>
+
+#if uECC_ARM_USE_UMAAL
+
+#if uECC_WORD_SIZE != 4
+#error "uECC_ARM_USE_UMAAL needs uECC_WORD_SIZE 4"
+#endif
+#if !defined(__GNUC__) || !defined(__thumb2__) || !defined(__ARM_FEATURE_DSP)
+#error "uECC_ARM_USE_UMAAL needs GCC or clang targeting Thumb-2 with UMAAL"
+#endif
+
+/*
+ * Both kernels keep left[0..7] in r4-r11 and scan the operand by rows: row i
+ * adds left * right[i] into result[i..i + 8], with each word step a single
+ * UMAAL (result word + carry + left[j] * right[i] never overflows 64 bits).
+ * Neither has a branch or a data-dependent address.
+ */
+__attribute__((naked))
+void uECC_vli_mult_umaal(uECC_word_t *result, const uECC_word_t *left,
+			 const uECC_word_t *right)
+{
+	__asm__ volatile(
+		".syntax unified\n\t"
+		"push {r4-r11, lr}\n\t"
+		"ldm r1, {r4-r11}\n\t"
+		"ldr r3, [r2, #0]\n\t"
+		"mov r1, #0\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r4, r3\n\t"
+		"str r12, [r0, #0]\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r5, r3\n\t"
+		"str r12, [r0, #4]\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r6, r3\n\t"
+		"str r12, [r0, #8]\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r7, r3\n\t"
+		"str r12, [r0, #12]\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r8, r3\n\t"
+		"str r12, [r0, #16]\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r9, r3\n\t"
+		"str r12, [r0, #20]\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r10, r3\n\t"
+		"str r12, [r0, #24]\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r11, r3\n\t"
+		"str r12, [r0, #28]\n\t"
+		"str r1, [r0, #32]\n\t"
+		"ldr r3, [r2, #4]\n\t"
+		"mov r1, #0\n\t"
+		"ldr r12, [r0, #4]\n\t"
+		"umaal r12, r1, r4, r3\n\t"
+		"str r12, [r0, #4]\n\t"
+		"ldr r12, [r0, #8]\n\t"
+		"umaal r12, r1, r5, r3\n\t"
+		"str r12, [r0, #8]\n\t"
+		"ldr r12, [r0, #12]\n\t"
+		"umaal r12, r1, r6, r3\n\t"
+		"str r12, [r0, #12]\n\t"
+		"ldr r12, [r0, #16]\n\t"
+		"umaal r12, r1, r7, r3\n\t"
+		"str r12, [r0, #16]\n\t"
+		"ldr r12, [r0, #20]\n\t"
+		"umaal r12, r1, r8, r3\n\t"
+		"str r12, [r0, #20]\n\t"
+		"ldr r12, [r0, #24]\n\t"
+		"umaal r12, r1, r9, r3\n\t"
+		"str r12, [r0, #24]\n\t"
+		"ldr r12, [r0, #28]\n\t"
+		"umaal r12, r1, r10, r3\n\t"
+		"str r12, [r0, #28]\n\t"
+		"ldr r12, [r0, #32]\n\t"
+		"umaal r12, r1, r11, r3\n\t"
+		"str r12, [r0, #32]\n\t"
+		"str r1, [r0, #36]\n\t"
+		"ldr r3, [r2, #8]\n\t"
+		"mov r1, #0\n\t"
+		"ldr r12, [r0, #8]\n\t"
+		"umaal r12, r1, r4, r3\n\t"
+		"str r12, [r0, #8]\n\t"
+		"ldr r12, [r0, #12]\n\t"
+		"umaal r12, r1, r5, r3\n\t"
+		"str r12, [r0, #12]\n\t"
+		"ldr r12, [r0, #16]\n\t"
+		"umaal r12, r1, r6, r3\n\t"
+		"str r12, [r0, #16]\n\t"
+		"ldr r12, [r0, #20]\n\t"
+		"umaal r12, r1, r7, r3\n\t"
+		"str r12, [r0, #20]\n\t"
+		"ldr r12, [r0, #24]\n\t"
+		"umaal r12, r1, r8, r3\n\t"
+		"str r12, [r0, #24]\n\t"
+		"ldr r12, [r0, #28]\n\t"
+		"umaal r12, r1, r9, r3\n\t"
+		"str r12, [r0, #28]\n\t"
+		"ldr r12, [r0, #32]\n\t"
+		"umaal r12, r1, r10, r3\n\t"
+		"str r12, [r0, #32]\n\t"
+		"ldr r12, [r0, #36]\n\t"
+		"umaal r12, r1, r11, r3\n\t"
+		"str r12, [r0, #36]\n\t"
+		"str r1, [r0, #40]\n\t"
+		"ldr r3, [r2, #12]\n\t"
+		"mov r1, #0\n\t"
+		"ldr r12, [r0, #12]\n\t"
+		"umaal r12, r1, r4, r3\n\t"
+		"str r12, [r0, #12]\n\t"
+		"ldr r12, [r0, #16]\n\t"
+		"umaal r12, r1, r5, r3\n\t"
+		"str r12, [r0, #16]\n\t"
+		"ldr r12, [r0, #20]\n\t"
+		"umaal r12, r1, r6, r3\n\t"
+		"str r12, [r0, #20]\n\t"
+		"ldr r12, [r0, #24]\n\t"
+		"umaal r12, r1, r7, r3\n\t"
+		"str r12, [r0, #24]\n\t"
+		"ldr r12, [r0, #28]\n\t"
+		"umaal r12, r1, r8, r3\n\t"
+		"str r12, [r0, #28]\n\t"
+		"ldr r12, [r0, #32]\n\t"
+		"umaal r12, r1, r9, r3\n\t"
+		"str r12, [r0, #32]\n\t"
+		"ldr r12, [r0, #36]\n\t"
+		"umaal r12, r1, r10, r3\n\t"
+		"str r12, [r0, #36]\n\t"
+		"ldr r12, [r0, #40]\n\t"
+		"umaal r12, r1, r11, r3\n\t"
+		"str r12, [r0, #40]\n\t"
+		"str r1, [r0, #44]\n\t"
+		"ldr r3, [r2, #16]\n\t"
+		"mov r1, #0\n\t"
+		"ldr r12, [r0, #16]\n\t"
+		"umaal r12, r1, r4, r3\n\t"
+		"str r12, [r0, #16]\n\t"
+		"ldr r12, [r0, #20]\n\t"
+		"umaal r12, r1, r5, r3\n\t"
+		"str r12, [r0, #20]\n\t"
+		"ldr r12, [r0, #24]\n\t"
+		"umaal r12, r1, r6, r3\n\t"
+		"str r12, [r0, #24]\n\t"
+		"ldr r12, [r0, #28]\n\t"
+		"umaal r12, r1, r7, r3\n\t"
+		"str r12, [r0, #28]\n\t"
+		"ldr r12, [r0, #32]\n\t"
+		"umaal r12, r1, r8, r3\n\t"
+		"str r12, [r0, #32]\n\t"
+		"ldr r12, [r0, #36]\n\t"
+		"umaal r12, r1, r9, r3\n\t"
+		"str r12, [r0, #36]\n\t"
+		"ldr r12, [r0, #40]\n\t"
+		"umaal r12, r1, r10, r3\n\t"
+		"str r12, [r0, #40]\n\t"
+		"ldr r12, [r0, #44]\n\t"
+		"umaal r12, r1, r11, r3\n\t"
+		"str r12, [r0, #44]\n\t"
+		"str r1, [r0, #48]\n\t"
+		"ldr r3, [r2, #20]\n\t"
+		"mov r1, #0\n\t"
+		"ldr r12, [r0, #20]\n\t"
+		"umaal r12, r1, r4, r3\n\t"
+		"str r12, [r0, #20]\n\t"
+		"ldr r12, [r0, #24]\n\t"
+		"umaal r12, r1, r5, r3\n\t"
+		"str r12, [r0, #24]\n\t"
+		"ldr r12, [r0, #28]\n\t"
+		"umaal r12, r1, r6, r3\n\t"
+		"str r12, [r0, #28]\n\t"
+		"ldr r12, [r0, #32]\n\t"
+		"umaal r12, r1, r7, r3\n\t"
+		"str r12, [r0, #32]\n\t"
+		"ldr r12, [r0, #36]\n\t"
+		"umaal r12, r1, r8, r3\n\t"
+		"str r12, [r0, #36]\n\t"
+		"ldr r12, [r0, #40]\n\t"
+		"umaal r12, r1, r9, r3\n\t"
+		"str r12, [r0, #40]\n\t"
+		"ldr r12, [r0, #44]\n\t"
+		"umaal r12, r1, r10, r3\n\t"
+		"str r12, [r0, #44]\n\t"
+		"ldr r12, [r0, #48]\n\t"
+		"umaal r12, r1, r11, r3\n\t"
+		"str r12, [r0, #48]\n\t"
+		"str r1, [r0, #52]\n\t"
+		"ldr r3, [r2, #24]\n\t"
+		"mov r1, #0\n\t"
+		"ldr r12, [r0, #24]\n\t"
+		"umaal r12, r1, r4, r3\n\t"
+		"str r12, [r0, #24]\n\t"
+		"ldr r12, [r0, #28]\n\t"
+		"umaal r12, r1, r5, r3\n\t"
+		"str r12, [r0, #28]\n\t"
+		"ldr r12, [r0, #32]\n\t"
+		"umaal r12, r1, r6, r3\n\t"
+		"str r12, [r0, #32]\n\t"
+		"ldr r12, [r0, #36]\n\t"
+		"umaal r12, r1, r7, r3\n\t"
+		"str r12, [r0, #36]\n\t"
+		"ldr r12, [r0, #40]\n\t"
+		"umaal r12, r1, r8, r3\n\t"
+		"str r12, [r0, #40]\n\t"
+		"ldr r12, [r0, #44]\n\t"
+		"umaal r12, r1, r9, r3\n\t"
+		"str r12, [r0, #44]\n\t"
+		"ldr r12, [r0, #48]\n\t"
+		"umaal r12, r1, r10, r3\n\t"
+		"str r12, [r0, #48]\n\t"
+		"ldr r12, [r0, #52]\n\t"
+		"umaal r12, r1, r11, r3\n\t"
+		"str r12, [r0, #52]\n\t"
+		"str r1, [r0, #56]\n\t"
+		"ldr r3, [r2, #28]\n\t"
+		"mov r1, #0\n\t"
+		"ldr r12, [r0, #28]\n\t"
+		"umaal r12, r1, r4, r3\n\t"
+		"str r12, [r0, #28]\n\t"
+		"ldr r12, [r0, #32]\n\t"
+		"umaal r12, r1, r5, r3\n\t"
+		"str r12, [r0, #32]\n\t"
+		"ldr r12, [r0, #36]\n\t"
+		"umaal r12, r1, r6, r3\n\t"
+		"str r12, [r0, #36]\n\t"
+		"ldr r12, [r0, #40]\n\t"
+		"umaal r12, r1, r7, r3\n\t"
+		"str r12, [r0, #40]\n\t"
+		"ldr r12, [r0, #44]\n\t"
+		"umaal r12, r1, r8, r3\n\t"
+		"str r12, [r0, #44]\n\t"
+		"ldr r12, [r0, #48]\n\t"
+		"umaal r12, r1, r9, r3\n\t"
+		"str r12, [r0, #48]\n\t"
+		"ldr r12, [r0, #52]\n\t"
+		"umaal r12, r1, r10, r3\n\t"
+		"str r12, [r0, #52]\n\t"
+		"ldr r12, [r0, #56]\n\t"
+		"umaal r12, r1, r11, r3\n\t"
+		"str r12, [r0, #56]\n\t"
+		"str r1, [r0, #60]\n\t"
+		"pop {r4-r11, pc}\n\t"
+	);
+}
+
+/*
+ * Squaring first sums the 28 products left[i] * left[j], i < j, row by row,
+ * doubles them with one ADCS chain and then adds the eight squares
+ * left[i]^2 with a second chain; UMULL and the loads and stores in between
+ * leave the carry flag alone.
+ */
+__attribute__((naked))
+void uECC_vli_square_umaal(uECC_word_t *result, const uECC_word_t *left)
+{
+	__asm__ volatile(
+		".syntax unified\n\t"
+		"push {r4-r11, lr}\n\t"
+		"ldm r1, {r4-r11}\n\t"
+		"mov lr, #0\n\t"
+		"mov r1, #0\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r5, r4\n\t"
+		"str r12, [r0, #4]\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r6, r4\n\t"
+		"str r12, [r0, #8]\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r7, r4\n\t"
+		"str r12, [r0, #12]\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r8, r4\n\t"
+		"str r12, [r0, #16]\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r9, r4\n\t"
+		"str r12, [r0, #20]\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r10, r4\n\t"
+		"str r12, [r0, #24]\n\t"
+		"mov r12, #0\n\t"
+		"umaal r12, r1, r11, r4\n\t"
+		"str r12, [r0, #28]\n\t"
+		"str r1, [r0, #32]\n\t"
+		"mov r1, #0\n\t"
+		"ldr r12, [r0, #12]\n\t"
+		"umaal r12, r1, r6, r5\n\t"
+		"str r12, [r0, #12]\n\t"
+		"ldr r12, [r0, #16]\n\t"
+		"umaal r12, r1, r7, r5\n\t"
+		"str r12, [r0, #16]\n\t"
+		"ldr r12, [r0, #20]\n\t"
+		"umaal r12, r1, r8, r5\n\t"
+		"str r12, [r0, #20]\n\t"
+		"ldr r12, [r0, #24]\n\t"
+		"umaal r12, r1, r9, r5\n\t"
+		"str r12, [r0, #24]\n\t"
+		"ldr r12, [r0, #28]\n\t"
+		"umaal r12, r1, r10, r5\n\t"
+		"str r12, [r0, #28]\n\t"
+		"ldr r12, [r0, #32]\n\t"
+		"umaal r12, r1, r11, r5\n\t"
+		"str r12, [r0, #32]\n\t"
+		"str r1, [r0, #36]\n\t"
+		"mov r1, #0\n\t"
+		"ldr r12, [r0, #20]\n\t"
+		"umaal r12, r1, r7, r6\n\t"
+		"str r12, [r0, #20]\n\t"
+		"ldr r12, [r0, #24]\n\t"
+		"umaal r12, r1, r8, r6\n\t"
+		"str r12, [r0, #24]\n\t"
+		"ldr r12, [r0, #28]\n\t"
+		"umaal r12, r1, r9, r6\n\t"
+		"str r12, [r0, #28]\n\t"
+		"ldr r12, [r0, #32]\n\t"
+		"umaal r12, r1, r10, r6\n\t"
+		"str r12, [r0, #32]\n\t"
+		"ldr r12, [r0, #36]\n\t"
+		"umaal r12, r1, r11, r6\n\t"
+		"str r12, [r0, #36]\n\t"
+		"str r1, [r0, #40]\n\t"
+		"mov r1, #0\n\t"
+		"ldr r12, [r0, #28]\n\t"
+		"umaal r12, r1, r8, r7\n\t"
+		"str r12, [r0, #28]\n\t"
+		"ldr r12, [r0, #32]\n\t"
+		"umaal r12, r1, r9, r7\n\t"
+		"str r12, [r0, #32]\n\t"
+		"ldr r12, [r0, #36]\n\t"
+		"umaal r12, r1, r10, r7\n\t"
+		"str r12, [r0, #36]\n\t"
+		"ldr r12, [r0, #40]\n\t"
+		"umaal r12, r1, r11, r7\n\t"
+		"str r12, [r0, #40]\n\t"
+		"str r1, [r0, #44]\n\t"
+		"mov r1, #0\n\t"
+		"ldr r12, [r0, #36]\n\t"
+		"umaal r12, r1, r9, r8\n\t"
+		"str r12, [r0, #36]\n\t"
+		"ldr r12, [r0, #40]\n\t"
+		"umaal r12, r1, r10, r8\n\t"
+		"str r12, [r0, #40]\n\t"
+		"ldr r12, [r0, #44]\n\t"
+		"umaal r12, r1, r11, r8\n\t"
+		"str r12, [r0, #44]\n\t"
+		"str r1, [r0, #48]\n\t"
+		"mov r1, #0\n\t"
+		"ldr r12, [r0, #44]\n\t"
+		"umaal r12, r1, r10, r9\n\t"
+		"str r12, [r0, #44]\n\t"
+		"ldr r12, [r0, #48]\n\t"
+		"umaal r12, r1, r11, r9\n\t"
+		"str r12, [r0, #48]\n\t"
+		"str r1, [r0, #52]\n\t"
+		"mov r1, #0\n\t"
+		"ldr r12, [r0, #52]\n\t"
+		"umaal r12, r1, r11, r10\n\t"
+		"str r12, [r0, #52]\n\t"
+		"str r1, [r0, #56]\n\t"
+		"str lr, [r0]\n\t"
+		"ldr r1, [r0, #4]\n\t"
+		"adds r1, r1, r1\n\t"
+		"str r1, [r0, #4]\n\t"
+		"ldr r1, [r0, #8]\n\t"
+		"adcs r1, r1, r1\n\t"
+		"str r1, [r0, #8]\n\t"
+		"ldr r1, [r0, #12]\n\t"
+		"adcs r1, r1, r1\n\t"
+		"str r1, [r0, #12]\n\t"
+		"ldr r1, [r0, #16]\n\t"
+		"adcs r1, r1, r1\n\t"
+		"str r1, [r0, #16]\n\t"
+		"ldr r1, [r0, #20]\n\t"
+		"adcs r1, r1, r1\n\t"
+		"str r1, [r0, #20]\n\t"
+		"ldr r1, [r0, #24]\n\t"
+		"adcs r1, r1, r1\n\t"
+		"str r1, [r0, #24]\n\t"
+		"ldr r1, [r0, #28]\n\t"
+		"adcs r1, r1, r1\n\t"
+		"str r1, [r0, #28]\n\t"
+		"ldr r1, [r0, #32]\n\t"
+		"adcs r1, r1, r1\n\t"
+		"str r1, [r0, #32]\n\t"
+		"ldr r1, [r0, #36]\n\t"
+		"adcs r1, r1, r1\n\t"
+		"str r1, [r0, #36]\n\t"
+		"ldr r1, [r0, #40]\n\t"
+		"adcs r1, r1, r1\n\t"
+		"str r1, [r0, #40]\n\t"
+		"ldr r1, [r0, #44]\n\t"
+		"adcs r1, r1, r1\n\t"
+		"str r1, [r0, #44]\n\t"
+		"ldr r1, [r0, #48]\n\t"
+		"adcs r1, r1, r1\n\t"
+		"str r1, [r0, #48]\n\t"
+		"ldr r1, [r0, #52]\n\t"
+		"adcs r1, r1, r1\n\t"
+		"str r1, [r0, #52]\n\t"
+		"ldr r1, [r0, #56]\n\t"
+		"adcs r1, r1, r1\n\t"
+		"str r1, [r0, #56]\n\t"
+		"adc r1, lr, lr\n\t"
+		"str r1, [r0, #60]\n\t"
+		"umull r1, r2, r4, r4\n\t"
+		"ldrd r3, r12, [r0, #0]\n\t"
+		"adds r3, r3, r1\n\t"
+		"adcs r12, r12, r2\n\t"
+		"strd r3, r12, [r0, #0]\n\t"
+		"umull r1, r2, r5, r5\n\t"
+		"ldrd r3, r12, [r0, #8]\n\t"
+		"adcs r3, r3, r1\n\t"
+		"adcs r12, r12, r2\n\t"
+		"strd r3, r12, [r0, #8]\n\t"
+		"umull r1, r2, r6, r6\n\t"
+		"ldrd r3, r12, [r0, #16]\n\t"
+		"adcs r3, r3, r1\n\t"
+		"adcs r12, r12, r2\n\t"
+		"strd r3, r12, [r0, #16]\n\t"
+		"umull r1, r2, r7, r7\n\t"
+		"ldrd r3, r12, [r0, #24]\n\t"
+		"adcs r3, r3, r1\n\t"
+		"adcs r12, r12, r2\n\t"
+		"strd r3, r12, [r0, #24]\n\t"
+		"umull r1, r2, r8, r8\n\t"
+		"ldrd r3, r12, [r0, #32]\n\t"
+		"adcs r3, r3, r1\n\t"
+		"adcs r12, r12, r2\n\t"
+		"strd r3, r12, [r0, #32]\n\t"
+		"umull r1, r2, r9, r9\n\t"
+		"ldrd r3, r12, [r0, #40]\n\t"
+		"adcs r3, r3, r1\n\t"
+		"adcs r12, r12, r2\n\t"
+		"strd r3, r12, [r0, #40]\n\t"
+		"umull r1, r2, r10, r10\n\t"
+		"ldrd r3, r12, [r0, #48]\n\t"
+		"adcs r3, r3, r1\n\t"
+		"adcs r12, r12, r2\n\t"
+		"strd r3, r12, [r0, #48]\n\t"
+		"umull r1, r2, r11, r11\n\t"
+		"ldrd r3, r12, [r0, #56]\n\t"
+		"adcs r3, r3, r1\n\t"
+		"adcs r12, r12, r2\n\t"
+		"strd r3, r12, [r0, #56]\n\t"
+		"pop {r4-r11, pc}\n\t"
+	);
+}
+
+#define P(i) ((int64_t)product[i])
+
+void vli_mmod_fast_secp256r1_ct(uECC_word_t *result, uECC_word_t *product)
+{
+	const uECC_word_t *p = curve_secp256r1.p;
+	int64_t acc;
+	int64_t carry;
+	uECC_word_t mask;
+	uECC_word_t diff[NUM_ECC_WORDS];
+	wordcount_t i;
+
+	/* t + 2s1 + 2s2 + s3 + s4 - d1 - d2 - d3 - d4, one limb at a time; the
+	 * signed carry out of the top limb is in [-4, 6]. Only product words
+	 * 8..15 and the current limb are read, so result may alias product. */
+	acc = P(0) + P(8) + P(9) - P(11) - P(12) - P(13) - P(14);
+	result[0] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += P(1) + P(9) + P(10) - P(12) - P(13) - P(14) - P(15);
+	result[1] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += P(2) + P(10) + P(11) - P(13) - P(14) - P(15);
+	result[2] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += P(3) + 2 * (P(11) + P(12)) + P(13) - P(15) - P(8) - P(9);
+	result[3] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += P(4) + 2 * (P(12) + P(13)) + P(14) - P(9) - P(10);
+	result[4] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += P(5) + 2 * (P(13) + P(14)) + P(15) - P(10) - P(11);
+	result[5] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += P(6) + P(13) + 3 * P(14) + 2 * P(15) - P(8) - P(9);
+	result[6] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += P(7) + 3 * P(15) + P(8) - P(10) - P(11) - P(12) - P(13);
+	result[7] = (uECC_word_t)acc;
+	carry = acc >> 32;
+
+	/* Fold the carry back in with 2^256 = 2^224 - 2^192 - 2^96 + 1 mod p;
+	 * what is left over 256 bits is -1, 0 or 1. */
+	acc = (int64_t)result[0] + carry;
+	result[0] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += (int64_t)result[1];
+	result[1] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += (int64_t)result[2];
+	result[2] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += (int64_t)result[3] - carry;
+	result[3] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += (int64_t)result[4];
+	result[4] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += (int64_t)result[5];
+	result[5] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += (int64_t)result[6] - carry;
+	result[6] = (uECC_word_t)acc;
+	acc >>= 32;
+	acc += (int64_t)result[7] + carry;
+	result[7] = (uECC_word_t)acc;
+	carry = acc >> 32;
+
+	/* A negative value needs p added once, which also clears the carry. */
+	mask = -(uECC_word_t)((uint64_t)carry >> 63);
+	acc = 0;
+	for (i = 0; i < NUM_ECC_WORDS; ++i) {
+		acc += (int64_t)result[i] + (p[i] & mask);
+		result[i] = (uECC_word_t)acc;
+		acc >>= 32;
+	}
+	carry += acc;
+
+	/* Now the value is below 2p, so subtracting p once when carry is set or
+	 * result >= p brings it under p. */
+	acc = 0;
+	for (i = 0; i < NUM_ECC_WORDS; ++i) {
+		acc += (int64_t)result[i] - p[i];
+		diff[i] = (uECC_word_t)acc;
+		acc >>= 32;
+	}
+	mask = -(uECC_word_t)(carry | (acc + 1));
+	for (i = 0; i < NUM_ECC_WORDS; ++i) {
+		result[i] = (diff[i] & mask) | (result[i] & ~mask);
+	}
+}
+
+#endif /* uECC_ARM_USE_UMAAL */
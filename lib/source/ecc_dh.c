@@ -61,7 +61,7 @@
 #include <string.h>
 
 int uECC_make_key_with_d(uint8_t *public_key, uint8_t *private_key,
-			 unsigned int *d, uECC_Curve curve)
+			 uECC_word_t *d, uECC_Curve curve)
 {
 
 	uECC_word_t _private[NUM_ECC_WORDS];
@@ -77,14 +77,14 @@ int uECC_make_key_with_d(uint8_t *public_key, uint8_t *private_key,
 
 		/* Converting buffers to correct bit order: */
 		uECC_vli_nativeToBytes(private_key,
-				       BITS_TO_BYTES(curve->num_n_bits),
+				       BITS_TO_BYTES(uECC_NUM_N_BITS(curve)),
 				       _private);
 		uECC_vli_nativeToBytes(public_key,
-				       curve->num_bytes,
+				       uECC_NUM_BYTES(curve),
 				       _public);
-		uECC_vli_nativeToBytes(public_key + curve->num_bytes,
-				       curve->num_bytes,
-				       _public + curve->num_words);
+		uECC_vli_nativeToBytes(public_key + uECC_NUM_BYTES(curve),
+				       uECC_NUM_BYTES(curve),
+				       _public + uECC_NUM_WORDS(curve));
 
 		/* erasing temporary buffer used to store secret: */
 		_set_secure(_private, 0, NUM_ECC_BYTES);
@@ -94,73 +94,153 @@ int uECC_make_key_with_d(uint8_t *public_key, uint8_t *private_key,
 	return 0;
 }
 
-int uECC_make_key(uint8_t *public_key, uint8_t *private_key, uECC_Curve curve)
+/* uECC_make_key_with_rng with its temporaries in ws (uECC_MAKE_KEY_WS_WORDS
+ * words), which is cleared before returning. */
+static int make_key_ws(uint8_t *public_key, uint8_t *private_key,
+		       uECC_Curve curve, uECC_RNG_Ctx_Function rng,
+		       void *rng_ctx, uECC_word_t *ws)
 {
-
-	uECC_word_t _random[NUM_ECC_WORDS * 2];
-	uECC_word_t _private[NUM_ECC_WORDS];
-	uECC_word_t _public[NUM_ECC_WORDS * 2];
+	uECC_word_t *_private = ws;
+	uECC_word_t *_public = ws + NUM_ECC_WORDS;
+	uECC_word_t *_random = ws + 3 * NUM_ECC_WORDS;
 	uECC_word_t tries;
+	int r = 0;
 
-	for (tries = 0; tries < uECC_RNG_MAX_TRIES; ++tries) {
+	for (tries = 0; tries < uECC_RNG_MAX_TRIES && !r; ++tries) {
 		/* Generating _private uniformly at random: */
-		uECC_RNG_Function rng_function = uECC_get_rng();
-		if (!rng_function ||
-			!rng_function((uint8_t *)_random, 2 * NUM_ECC_WORDS*uECC_WORD_SIZE)) {
-        		return 0;
+		if (!rng ||
+			!rng(rng_ctx, (uint8_t *)_random, 2 * NUM_ECC_WORDS*uECC_WORD_SIZE)) {
+			break;
 		}
 
 		/* computing modular reduction of _random (see FIPS 186.4 B.4.1): */
-		uECC_vli_mmod(_private, _random, curve->n, BITS_TO_WORDS(curve->num_n_bits));
+		uECC_vli_mmod(_private, _random, curve->n, BITS_TO_WORDS(uECC_NUM_N_BITS(curve)));
 
-		/* Computing public-key from private: */
-		if (EccPoint_compute_public_key(_public, _private, curve)) {
+		/* Computing public-key from private; _random is reused: */
+		if (EccPoint_compute_public_key_ws(_public, _private, curve,
+						   ws + 3 * NUM_ECC_WORDS)) {
 
 			/* Converting buffers to correct bit order: */
 			uECC_vli_nativeToBytes(private_key,
-					       BITS_TO_BYTES(curve->num_n_bits),
+					       BITS_TO_BYTES(uECC_NUM_N_BITS(curve)),
 					       _private);
 			uECC_vli_nativeToBytes(public_key,
-					       curve->num_bytes,
+					       uECC_NUM_BYTES(curve),
 					       _public);
-			uECC_vli_nativeToBytes(public_key + curve->num_bytes,
- 					       curve->num_bytes,
-					       _public + curve->num_words);
+			uECC_vli_nativeToBytes(public_key + uECC_NUM_BYTES(curve),
+					       uECC_NUM_BYTES(curve),
+					       _public + uECC_NUM_WORDS(curve));
+			r = 1;
+		}
+	}
 
-			/* erasing temporary buffer that stored secret: */
-			_set_secure(_private, 0, NUM_ECC_BYTES);
+	/* erasing temporary buffers that stored secrets: */
+	_set_secure(ws, 0, uECC_MAKE_KEY_WS_WORDS * uECC_WORD_SIZE);
+	return r;
+}
 
-      			return 1;
-    		}
-  	}
+int uECC_make_key(uint8_t *public_key, uint8_t *private_key, uECC_Curve curve)
+{
+	return uECC_make_key_with_rng(public_key, private_key, curve,
+				      uECC_get_rng() ? &uECC_global_rng : 0, 0);
+}
+
+int uECC_make_key_with_rng(uint8_t *public_key, uint8_t *private_key,
+			   uECC_Curve curve, uECC_RNG_Ctx_Function rng,
+			   void *rng_ctx)
+{
+	uECC_word_t ws[uECC_MAKE_KEY_WS_WORDS];
+
+	return make_key_ws(public_key, private_key, curve, rng, rng_ctx, ws);
+}
+
+int uECC_make_key_ws(uint8_t *public_key, uint8_t *private_key,
+		     uECC_Curve curve, uECC_word_t *ws)
+{
+	return make_key_ws(public_key, private_key, curve,
+			   uECC_get_rng() ? &uECC_global_rng : 0, 0, ws);
+}
+
+/* Draws a random Z in [1, p) from the context's pool, refilling the pool
+ * from its DRBG, and reseeding that from the context's RNG when it asks for
+ * it. */
+static int dh_ctx_random_z(uECC_DhCtx ctx, uECC_word_t *z)
+{
+	uECC_Curve curve = ctx->curve;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+	uECC_word_t mask = (uECC_word_t)-1;
+	bitcount_t num_bits = uECC_vli_numBits(curve->p, num_words);
+	uint8_t seed[NUM_ECC_BYTES];
+	uECC_word_t tries;
+	int r;
+
+	for (tries = 0; tries < uECC_RNG_MAX_TRIES; ++tries) {
+		if (ctx->z_left == 0) {
+			r = tc_hmac_prng_generate((uint8_t *)ctx->z_pool,
+						  sizeof(ctx->z_pool),
+						  &ctx->z_prng);
+			if (r == TC_HMAC_PRNG_RESEED_REQ) {
+				r = ctx->rng(ctx->rng_ctx, seed, sizeof(seed)) &&
+				    tc_hmac_prng_reseed(&ctx->z_prng, seed,
+							sizeof(seed), 0, 0);
+				_set_secure(seed, 0, sizeof(seed));
+				if (!r) {
+					return 0;
+				}
+				continue;
+			} else if (r != TC_CRYPTO_SUCCESS) {
+				return 0;
+			}
+			ctx->z_left = uECC_DH_CTX_Z_POOL;
+		}
+
+		--ctx->z_left;
+		uECC_vli_set(z, ctx->z_pool[ctx->z_left], num_words);
+		_set_secure(ctx->z_pool[ctx->z_left], 0,
+			    sizeof(ctx->z_pool[ctx->z_left]));
+		z[num_words - 1] &=
+			mask >> ((bitcount_t)(num_words * uECC_WORD_SIZE * 8 -
+					      num_bits));
+		if (!uECC_vli_isZero(z, num_words) &&
+		    uECC_vli_cmp(curve->p, z, num_words) == 1) {
+			return 1;
+		}
+	}
 	return 0;
 }
 
-int uECC_shared_secret(const uint8_t *public_key, const uint8_t *private_key,
-		       uint8_t *secret, uECC_Curve curve)
+/* Scratch of dh_compute: the result, the two regularized scalars, the ladder */
+#define DH_COMPUTE_WS_WORDS (4 * NUM_ECC_WORDS + uECC_MULT_WS_WORDS)
+
+/* Computes secret = x(private_key * peer). The initial Z comes from ctx when
+ * given, else from rng when there is one. ws (DH_COMPUTE_WS_WORDS words) is
+ * cleared before returning. */
+static int dh_compute(uint8_t *secret, const uECC_word_t *peer,
+		      const uint8_t *private_key, uECC_DhCtx ctx,
+		      uECC_Curve curve, uECC_RNG_Ctx_Function rng,
+		      void *rng_ctx, uECC_word_t *ws)
 {
 
-	uECC_word_t _public[NUM_ECC_WORDS * 2];
-	uECC_word_t _private[NUM_ECC_WORDS];
+	uECC_word_t *_result = ws;
+	uECC_word_t *_private = ws + 2 * NUM_ECC_WORDS;
 
-	uECC_word_t tmp[NUM_ECC_WORDS];
+	uECC_word_t *tmp = ws + 3 * NUM_ECC_WORDS;
 	uECC_word_t *p2[2] = {_private, tmp};
 	uECC_word_t *initial_Z = 0;
 	uECC_word_t carry;
-	wordcount_t num_words = curve->num_words;
-	wordcount_t num_bytes = curve->num_bytes;
+	wordcount_t num_bytes = uECC_NUM_BYTES(curve);
 	int r;
 
 	/* Converting buffers to correct bit order: */
 	uECC_vli_bytesToNative(_private,
-      			       private_key,
-			       BITS_TO_BYTES(curve->num_n_bits));
-	uECC_vli_bytesToNative(_public,
-      			       public_key,
-			       num_bytes);
-	uECC_vli_bytesToNative(_public + num_words,
-			       public_key + num_bytes,
-			       num_bytes);
+			       private_key,
+			       BITS_TO_BYTES(uECC_NUM_N_BITS(curve)));
+
+#if defined(TINYCRYPT_ACCEL)
+	if (EccPoint_mult_accel(_result, peer, _private, curve)) {
+		goto done;
+	}
+#endif
 
 	/* Regularize the bitcount for the private key so that attackers cannot use a
 	 * side channel attack to learn the number of leading zeros. */
@@ -168,25 +248,142 @@ int uECC_shared_secret(const uint8_t *public_key, const uint8_t *private_key,
 
 	/* If an RNG function was specified, try to get a random initial Z value to
 	 * improve protection against side-channel attacks. */
-	if (uECC_get_rng()) {
-		if (!uECC_generate_random_int(p2[carry], curve->p, num_words)) {
+	if (ctx && ctx->z_seeded) {
+		if (!dh_ctx_random_z(ctx, p2[carry])) {
 			r = 0;
 			goto clear_and_out;
-    		}
-    		initial_Z = p2[carry];
-  	}
+		}
+		initial_Z = p2[carry];
+	} else if (!ctx && rng) {
+		if (!uECC_generate_random_int_with_rng(p2[carry], curve->p,
+						       uECC_NUM_WORDS(curve),
+						       rng, rng_ctx)) {
+			r = 0;
+			goto clear_and_out;
+		}
+		initial_Z = p2[carry];
+	}
 
-	EccPoint_mult(_public, _public, p2[!carry], initial_Z, curve->num_n_bits + 1,
-		      curve);
+	EccPoint_mult_ws(_result, peer, p2[!carry], initial_Z,
+			 uECC_NUM_N_BITS(curve) + 1, curve, ws + 4 * NUM_ECC_WORDS);
 
-	uECC_vli_nativeToBytes(secret, num_bytes, _public);
-	r = !EccPoint_isZero(_public, curve);
+#if defined(TINYCRYPT_ACCEL)
+done:
+#endif
+	uECC_vli_nativeToBytes(secret, num_bytes, _result);
+	r = !EccPoint_isZero(_result, curve);
 
 clear_and_out:
 	/* erasing temporary buffer used to store secret: */
 	_set_secure(p2, 0, sizeof(p2));
-	_set_secure(tmp, 0, sizeof(tmp));
-	_set_secure(_private, 0, sizeof(_private));
+	_set_secure(ws, 0, DH_COMPUTE_WS_WORDS * uECC_WORD_SIZE);
+
+	return r;
+}
+
+/* uECC_shared_secret_with_rng with its temporaries in ws
+ * (uECC_SHARED_SECRET_WS_WORDS words). */
+static int shared_secret_ws(const uint8_t *public_key,
+			    const uint8_t *private_key, uint8_t *secret,
+			    uECC_Curve curve, uECC_RNG_Ctx_Function rng,
+			    void *rng_ctx, uECC_word_t *ws)
+{
+	uECC_word_t *_public = ws;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+	wordcount_t num_bytes = uECC_NUM_BYTES(curve);
+
+	uECC_vli_bytesToNative(_public,
+			       public_key,
+			       num_bytes);
+	uECC_vli_bytesToNative(_public + num_words,
+			       public_key + num_bytes,
+			       num_bytes);
+
+	return dh_compute(secret, _public, private_key, 0, curve, rng, rng_ctx,
+			  ws + 2 * NUM_ECC_WORDS);
+}
+
+int uECC_shared_secret(const uint8_t *public_key, const uint8_t *private_key,
+		       uint8_t *secret, uECC_Curve curve)
+{
+	return uECC_shared_secret_with_rng(public_key, private_key, secret,
+					   curve, uECC_get_rng() ?
+					   &uECC_global_rng : 0, 0);
+}
+
+int uECC_shared_secret_with_rng(const uint8_t *public_key,
+				const uint8_t *private_key, uint8_t *secret,
+				uECC_Curve curve, uECC_RNG_Ctx_Function rng,
+				void *rng_ctx)
+{
+	uECC_word_t ws[uECC_SHARED_SECRET_WS_WORDS];
+
+	return shared_secret_ws(public_key, private_key, secret, curve, rng,
+				rng_ctx, ws);
+}
+
+int uECC_shared_secret_ws(const uint8_t *public_key,
+			  const uint8_t *private_key, uint8_t *secret,
+			  uECC_Curve curve, uECC_word_t *ws)
+{
+	return shared_secret_ws(public_key, private_key, secret, curve,
+				uECC_get_rng() ? &uECC_global_rng : 0, 0, ws);
+}
+
+int uECC_dh_ctx_init(uECC_DhCtx ctx, const uint8_t *public_key,
+		     uECC_Curve curve)
+{
+	return uECC_dh_ctx_init_with_rng(ctx, public_key, curve,
+					 uECC_get_rng() ? &uECC_global_rng : 0,
+					 0);
+}
+
+int uECC_dh_ctx_init_with_rng(uECC_DhCtx ctx, const uint8_t *public_key,
+			      uECC_Curve curve, uECC_RNG_Ctx_Function rng,
+			      void *rng_ctx)
+{
+	static const uint8_t personalization[] = "uECC_dh_ctx";
+	uint8_t seed[NUM_ECC_BYTES];
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+	wordcount_t num_bytes = uECC_NUM_BYTES(curve);
+	int r = TC_CRYPTO_SUCCESS;
+
+	_set_secure(ctx, 0, sizeof(*ctx));
+	if (uECC_valid_public_key(public_key, curve) != 0) {
+		return TC_CRYPTO_FAIL;
+	}
 
+	ctx->curve = curve;
+	ctx->rng = rng;
+	ctx->rng_ctx = rng_ctx;
+	uECC_vli_bytesToNative(ctx->peer, public_key, num_bytes);
+	uECC_vli_bytesToNative(ctx->peer + num_words, public_key + num_bytes,
+			       num_bytes);
+
+	if (rng) {
+		if (!rng(rng_ctx, seed, sizeof(seed)) ||
+		    !tc_hmac_prng_init(&ctx->z_prng, personalization,
+				       sizeof(personalization)) ||
+		    !tc_hmac_prng_reseed(&ctx->z_prng, seed, sizeof(seed),
+					 public_key, 2 * num_bytes)) {
+			r = TC_CRYPTO_FAIL;
+		}
+		ctx->z_seeded = r;
+		_set_secure(seed, 0, sizeof(seed));
+	}
 	return r;
 }
+
+int uECC_dh_ctx_shared_secret(uECC_DhCtx ctx, const uint8_t *private_key,
+			      uint8_t *secret)
+{
+	uECC_word_t ws[DH_COMPUTE_WS_WORDS];
+
+	return dh_compute(secret, ctx->peer, private_key, ctx, ctx->curve, 0, 0,
+			  ws);
+}
+
+void uECC_dh_ctx_clear(uECC_DhCtx ctx)
+{
+	_set_secure(ctx, 0, sizeof(*ctx));
+}
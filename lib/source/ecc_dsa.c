@@ -56,13 +56,15 @@
 #include <tinycrypt/constants.h>
 #include <tinycrypt/ecc.h>
 #include <tinycrypt/ecc_dsa.h>
+#include <tinycrypt/hmac_prng.h>
+#include <tinycrypt/utils.h>
 
 
 static void bits2int(uECC_word_t *native, const uint8_t *bits,
 		     unsigned bits_size, uECC_Curve curve)
 {
-	unsigned num_n_bytes = BITS_TO_BYTES(curve->num_n_bits);
-	unsigned num_n_words = BITS_TO_WORDS(curve->num_n_bits);
+	unsigned num_n_bytes = BITS_TO_BYTES(uECC_NUM_N_BITS(curve));
+	unsigned num_n_words = BITS_TO_WORDS(uECC_NUM_N_BITS(curve));
 	int shift;
 	uECC_word_t carry;
 	uECC_word_t *ptr;
@@ -73,10 +75,10 @@ static void bits2int(uECC_word_t *native, const uint8_t *bits,
 
 	uECC_vli_clear(native, num_n_words);
 	uECC_vli_bytesToNative(native, bits, bits_size);
-	if (bits_size * 8 <= (unsigned)curve->num_n_bits) {
+	if (bits_size * 8 <= (unsigned)uECC_NUM_N_BITS(curve)) {
 		return;
 	}
-	shift = bits_size * 8 - curve->num_n_bits;
+	shift = bits_size * 8 - uECC_NUM_N_BITS(curve);
 	carry = 0;
 	ptr = native + num_n_words;
 	while (ptr-- > native) {
@@ -91,19 +93,20 @@ static void bits2int(uECC_word_t *native, const uint8_t *bits,
 	}
 }
 
-int uECC_sign_with_k(const uint8_t *private_key, const uint8_t *message_hash,
-		     unsigned hash_size, uECC_word_t *k, uint8_t *signature,
-		     uECC_Curve curve)
+/* uECC_sign_with_k, blinding the inversion of k with a number from rng when
+ * there is one. ws holds 4 * NUM_ECC_WORDS + uECC_PUBKEY_WS_WORDS words. */
+static int sign_with_k_rng(const uint8_t *private_key,
+			   const uint8_t *message_hash, unsigned hash_size,
+			   uECC_word_t *k, uint8_t *signature, uECC_Curve curve,
+			   uECC_RNG_Ctx_Function rng, void *rng_ctx,
+			   uECC_word_t *ws)
 {
 
-	uECC_word_t tmp[NUM_ECC_WORDS];
-	uECC_word_t s[NUM_ECC_WORDS];
-	uECC_word_t *k2[2] = {tmp, s};
-	uECC_word_t p[NUM_ECC_WORDS * 2];
-	uECC_word_t carry;
-	wordcount_t num_words = curve->num_words;
-	wordcount_t num_n_words = BITS_TO_WORDS(curve->num_n_bits);
-	bitcount_t num_n_bits = curve->num_n_bits;
+	uECC_word_t *tmp = ws;
+	uECC_word_t *s = ws + NUM_ECC_WORDS;
+	uECC_word_t *p = ws + 2 * NUM_ECC_WORDS;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+	wordcount_t num_n_words = BITS_TO_WORDS(uECC_NUM_N_BITS(curve));
 
 	/* Make sure 0 < k < curve_n */
   	if (uECC_vli_isZero(k, num_words) ||
@@ -111,19 +114,20 @@ int uECC_sign_with_k(const uint8_t *private_key, const uint8_t *message_hash,
 		return 0;
 	}
 
-	carry = regularize_k(k, tmp, s, curve);
-	EccPoint_mult(p, curve->G, k2[!carry], 0, num_n_bits + 1, curve);
-	if (uECC_vli_isZero(p, num_words)) {
+	/* p = k * G, with the fixed-base comb where there is one */
+	if (!EccPoint_compute_public_key_ws(p, k, curve,
+					    ws + 4 * NUM_ECC_WORDS)) {
 		return 0;
 	}
 
 	/* If an RNG function was specified, get a random number
 	to prevent side channel analysis of k. */
-	if (!uECC_get_rng()) {
+	if (!rng) {
 		uECC_vli_clear(tmp, num_n_words);
 		tmp[0] = 1;
 	}
-	else if (!uECC_generate_random_int(tmp, curve->n, num_n_words)) {
+	else if (!uECC_generate_random_int_with_rng(tmp, curve->n, num_n_words,
+						    rng, rng_ctx)) {
 		return 0;
 	}
 
@@ -133,10 +137,10 @@ int uECC_sign_with_k(const uint8_t *private_key, const uint8_t *message_hash,
 	uECC_vli_modInv(k, k, curve->n, num_n_words);       /* k = 1 / k' */
 	uECC_vli_modMult(k, k, tmp, curve->n, num_n_words); /* k = 1 / k */
 
-	uECC_vli_nativeToBytes(signature, curve->num_bytes, p); /* store r */
+	uECC_vli_nativeToBytes(signature, uECC_NUM_BYTES(curve), p); /* store r */
 
 	/* tmp = d: */
-	uECC_vli_bytesToNative(tmp, private_key, BITS_TO_BYTES(curve->num_n_bits));
+	uECC_vli_bytesToNative(tmp, private_key, BITS_TO_BYTES(uECC_NUM_N_BITS(curve)));
 
 	s[num_n_words - 1] = 0;
 	uECC_vli_set(s, p, num_words);
@@ -145,77 +149,199 @@ int uECC_sign_with_k(const uint8_t *private_key, const uint8_t *message_hash,
 	bits2int(tmp, message_hash, hash_size, curve);
 	uECC_vli_modAdd(s, tmp, s, curve->n, num_n_words); /* s = e + r*d */
 	uECC_vli_modMult(s, s, k, curve->n, num_n_words);  /* s = (e + r*d) / k */
-	if (uECC_vli_numBits(s, num_n_words) > (bitcount_t)curve->num_bytes * 8) {
+	if (uECC_vli_numBits(s, num_n_words) > (bitcount_t)uECC_NUM_BYTES(curve) * 8) {
 		return 0;
 	}
 
-	uECC_vli_nativeToBytes(signature + curve->num_bytes, curve->num_bytes, s);
+	uECC_vli_nativeToBytes(signature + uECC_NUM_BYTES(curve), uECC_NUM_BYTES(curve), s);
 	return 1;
 }
 
-int uECC_sign(const uint8_t *private_key, const uint8_t *message_hash,
-	      unsigned hash_size, uint8_t *signature, uECC_Curve curve)
+int uECC_sign_with_k(const uint8_t *private_key, const uint8_t *message_hash,
+		     unsigned hash_size, uECC_word_t *k, uint8_t *signature,
+		     uECC_Curve curve)
 {
-	      uECC_word_t _random[2*NUM_ECC_WORDS];
-	      uECC_word_t k[NUM_ECC_WORDS];
-	      uECC_word_t tries;
+	uECC_word_t ws[uECC_SIGN_WS_WORDS];
+
+	return sign_with_k_rng(private_key, message_hash, hash_size, k,
+			       signature, curve,
+			       uECC_get_rng() ? &uECC_global_rng : 0, 0, ws);
+}
 
-	for (tries = 0; tries < uECC_RNG_MAX_TRIES; ++tries) {
+/* uECC_sign_with_rng with its temporaries in ws (uECC_SIGN_WS_WORDS words),
+ * which is cleared before returning. */
+static int sign_rng_ws(const uint8_t *private_key, const uint8_t *message_hash,
+		       unsigned hash_size, uint8_t *signature, uECC_Curve curve,
+		       uECC_RNG_Ctx_Function rng, void *rng_ctx,
+		       uECC_word_t *ws)
+{
+	uECC_word_t *k = ws;
+	uECC_word_t *_random = ws + NUM_ECC_WORDS;
+	uECC_word_t tries;
+	int r = 0;
+
+	for (tries = 0; tries < uECC_RNG_MAX_TRIES && !r; ++tries) {
 		/* Generating _random uniformly at random: */
-		uECC_RNG_Function rng_function = uECC_get_rng();
-		if (!rng_function ||
-		    !rng_function((uint8_t *)_random, 2*NUM_ECC_WORDS*uECC_WORD_SIZE)) {
-			return 0;
+		if (!rng ||
+		    !rng(rng_ctx, (uint8_t *)_random, 2*NUM_ECC_WORDS*uECC_WORD_SIZE)) {
+			break;
 		}
 
 		// computing k as modular reduction of _random (see FIPS 186.4 B.5.1):
-		uECC_vli_mmod(k, _random, curve->n, BITS_TO_WORDS(curve->num_n_bits));
+		uECC_vli_mmod(k, _random, curve->n, BITS_TO_WORDS(uECC_NUM_N_BITS(curve)));
+
+		/* _random is dead now, and sign_with_k_rng reuses its words */
+		r = sign_with_k_rng(private_key, message_hash, hash_size, k,
+				    signature, curve, rng, rng_ctx,
+				    ws + NUM_ECC_WORDS);
+	}
+	_set_secure(ws, 0, uECC_SIGN_WS_WORDS * uECC_WORD_SIZE);
+	return r;
+}
+
+int uECC_sign(const uint8_t *private_key, const uint8_t *message_hash,
+	      unsigned hash_size, uint8_t *signature, uECC_Curve curve)
+{
+	return uECC_sign_with_rng(private_key, message_hash, hash_size,
+				  signature, curve,
+				  uECC_get_rng() ? &uECC_global_rng : 0, 0);
+}
 
-		if (uECC_sign_with_k(private_key, message_hash, hash_size, k, signature, 
-		    curve)) {
-			return 1;
+int uECC_sign_with_rng(const uint8_t *private_key, const uint8_t *message_hash,
+		       unsigned hash_size, uint8_t *signature, uECC_Curve curve,
+		       uECC_RNG_Ctx_Function rng, void *rng_ctx)
+{
+	uECC_word_t ws[uECC_SIGN_WS_WORDS];
+
+	return sign_rng_ws(private_key, message_hash, hash_size, signature,
+			   curve, rng, rng_ctx, ws);
+}
+
+int uECC_sign_ws(const uint8_t *private_key, const uint8_t *message_hash,
+		 unsigned hash_size, uint8_t *signature, uECC_Curve curve,
+		 uECC_word_t *ws)
+{
+	return sign_rng_ws(private_key, message_hash, hash_size, signature,
+			   curve, uECC_get_rng() ? &uECC_global_rng : 0, 0, ws);
+}
+
+/* uECC_RNG_Ctx_Function drawing from a TCHmacPrng_t. */
+static int hmac_prng_rng(void *ctx, uint8_t *dest, unsigned int size)
+{
+	return tc_hmac_prng_generate(dest, size, (TCHmacPrng_t)ctx) ==
+		TC_CRYPTO_SUCCESS;
+}
+
+int uECC_sign_deterministic(const uint8_t *private_key,
+			    const uint8_t *message_hash, unsigned hash_size,
+			    uint8_t *signature, uECC_Curve curve)
+{
+	/* drbg[0] yields the k candidates, drbg[1] the inversion blinding */
+	struct tc_hmac_prng_struct drbg[2];
+	uECC_word_t ws[uECC_SIGN_WS_WORDS];
+	uECC_word_t *k = ws;
+	uint8_t seed[2 * NUM_ECC_BYTES + 1];
+	unsigned num_n_bytes = BITS_TO_BYTES(uECC_NUM_N_BITS(curve));
+	uECC_word_t tries;
+	int r = 0;
+
+	/* seed = int2octets(x) || bits2octets(h1) */
+	_copy(seed, num_n_bytes, private_key, num_n_bytes);
+	bits2int(k, message_hash, hash_size, curve);
+	uECC_vli_nativeToBytes(seed + num_n_bytes, num_n_bytes, k);
+
+	/*
+	 * Steps b to g of RFC 6979 section 3.2 are the HMAC_DRBG instantiation
+	 * done by tc_hmac_prng_init, with seed as personalization. The RFC has
+	 * no reseed, so generation is enabled directly. The blinding generator
+	 * gets one more seed byte, which keeps its output apart from k.
+	 */
+	(void)tc_hmac_prng_init(&drbg[0], seed, 2 * num_n_bytes);
+	seed[2 * num_n_bytes] = 0x01;
+	(void)tc_hmac_prng_init(&drbg[1], seed, 2 * num_n_bytes + 1);
+	drbg[0].countdown = (unsigned int)-1;
+	drbg[1].countdown = (unsigned int)-1;
+
+	for (tries = 0; tries < uECC_RNG_MAX_TRIES && !r; ++tries) {
+		/*
+		 * Step h: T = V = HMAC_K(V), then K and V are updated for the next
+		 * candidate, which is one generate call. Every supported curve
+		 * has an n of whole bytes, so bits2int(T) is T itself, and
+		 * sign_with_k_rng rejects it unless 0 < k < n.
+		 */
+		if (tc_hmac_prng_generate(seed, num_n_bytes, &drbg[0]) !=
+		    TC_CRYPTO_SUCCESS) {
+			break;
 		}
+		uECC_vli_bytesToNative(k, seed, num_n_bytes);
+		r = sign_with_k_rng(private_key, message_hash, hash_size, k,
+				    signature, curve, &hmac_prng_rng, &drbg[1],
+				    ws + NUM_ECC_WORDS);
+	}
+	_set_secure(drbg, 0, sizeof(drbg));
+	_set_secure(seed, 0, sizeof(seed));
+	_set_secure(ws, 0, sizeof(ws));
+	return r;
+}
+
+#if uECC_VERIFY_WNAF_WINDOW > 0
+/*
+ * Whether the affine x of the Jacobian point (X, Y, Z) is r modulo n, without
+ * inverting Z: x is r or r + n since x < p < 2n, so compare X against r*Z^2
+ * and, when r + n < p, against (r + n)*Z^2.
+ */
+static int jacobian_x_matches(const uECC_word_t *X, const uECC_word_t *Z,
+			      const uECC_word_t *r, uECC_Curve curve)
+{
+	uECC_word_t zz[NUM_ECC_WORDS];
+	uECC_word_t t[NUM_ECC_WORDS];
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+
+	if (uECC_vli_isZero(Z, num_words)) {
+		return 0;
+	}
+
+	uECC_vli_modSquare_fast(zz, Z, curve);
+	uECC_vli_modMult_fast(t, r, zz, curve);
+	if (uECC_vli_equal(t, X, num_words) == 0) {
+		return 1;
 	}
-	return 0;
+
+	uECC_vli_sub(t, curve->p, curve->n, num_words);
+	if (uECC_vli_cmp_unsafe(t, r, num_words) != 1) {
+		return 0;
+	}
+	uECC_vli_modAdd(t, r, curve->n, curve->p, num_words);
+	uECC_vli_modMult_fast(t, t, zz, curve);
+	return (int)(uECC_vli_equal(t, X, num_words) == 0);
 }
+#endif
+
+/* Scratch of verify_rs, and of verify_rs_wnaf */
+#if uECC_VERIFY_WNAF_WINDOW > 0
+#define VERIFY_RS_WS_WORDS \
+	uECC_WS_MAX(8 * NUM_ECC_WORDS, 6 * NUM_ECC_WORDS + uECC_WNAF_WS_WORDS)
+#else
+#define VERIFY_RS_WS_WORDS (8 * NUM_ECC_WORDS)
+#endif
 
 static bitcount_t smax(bitcount_t a, bitcount_t b)
 {
 	return (a > b ? a : b);
 }
 
-int uECC_verify(const uint8_t *public_key, const uint8_t *message_hash,
-		unsigned hash_size, const uint8_t *signature,
-	        uECC_Curve curve)
+/* Reads a signature, checking that 0 < r, s < n. */
+static int load_rs(uECC_word_t *r, uECC_word_t *s, const uint8_t *signature,
+		   uECC_Curve curve)
 {
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+	wordcount_t num_n_words = BITS_TO_WORDS(uECC_NUM_N_BITS(curve));
 
-	uECC_word_t u1[NUM_ECC_WORDS], u2[NUM_ECC_WORDS];
-	uECC_word_t z[NUM_ECC_WORDS];
-	uECC_word_t sum[NUM_ECC_WORDS * 2];
-	uECC_word_t rx[NUM_ECC_WORDS];
-	uECC_word_t ry[NUM_ECC_WORDS];
-	uECC_word_t tx[NUM_ECC_WORDS];
-	uECC_word_t ty[NUM_ECC_WORDS];
-	uECC_word_t tz[NUM_ECC_WORDS];
-	const uECC_word_t *points[4];
-	const uECC_word_t *point;
-	bitcount_t num_bits;
-	bitcount_t i;
-
-	uECC_word_t _public[NUM_ECC_WORDS * 2];
-	uECC_word_t r[NUM_ECC_WORDS], s[NUM_ECC_WORDS];
-	wordcount_t num_words = curve->num_words;
-	wordcount_t num_n_words = BITS_TO_WORDS(curve->num_n_bits);
-
-	rx[num_n_words - 1] = 0;
 	r[num_n_words - 1] = 0;
 	s[num_n_words - 1] = 0;
 
-	uECC_vli_bytesToNative(_public, public_key, curve->num_bytes);
-	uECC_vli_bytesToNative(_public + num_words, public_key + curve->num_bytes,
-			       curve->num_bytes);
-	uECC_vli_bytesToNative(r, signature, curve->num_bytes);
-	uECC_vli_bytesToNative(s, signature + curve->num_bytes, curve->num_bytes);
+	uECC_vli_bytesToNative(r, signature, uECC_NUM_BYTES(curve));
+	uECC_vli_bytesToNative(s, signature + uECC_NUM_BYTES(curve), uECC_NUM_BYTES(curve));
 
 	/* r, s must not be 0. */
 	if (uECC_vli_isZero(r, num_words) || uECC_vli_isZero(s, num_words)) {
@@ -227,45 +353,141 @@ int uECC_verify(const uint8_t *public_key, const uint8_t *message_hash,
 	    uECC_vli_cmp_unsafe(curve->n, s, num_n_words) != 1) {
 		return 0;
 	}
+	return 1;
+}
+
+/* Reads a public key and signature, checking that 0 < r, s < n. */
+static int load_signature(uECC_word_t *_public, uECC_word_t *r, uECC_word_t *s,
+			  const uint8_t *public_key, const uint8_t *signature,
+			  uECC_Curve curve)
+{
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+
+	uECC_vli_bytesToNative(_public, public_key, uECC_NUM_BYTES(curve));
+	uECC_vli_bytesToNative(_public + num_words, public_key + uECC_NUM_BYTES(curve),
+			       uECC_NUM_BYTES(curve));
+	return load_rs(r, s, signature, curve);
+}
+
+/* u1 = e/s and u2 = r/s, given z = 1/s */
+static void compute_u(uECC_word_t *u1, uECC_word_t *u2, const uECC_word_t *z,
+		      const uECC_word_t *r, const uint8_t *message_hash,
+		      unsigned hash_size, uECC_Curve curve)
+{
+	wordcount_t num_n_words = BITS_TO_WORDS(uECC_NUM_N_BITS(curve));
 
-	/* Calculate u1 and u2. */
-	uECC_vli_modInv(z, s, curve->n, num_n_words); /* z = 1/s */
 	u1[num_n_words - 1] = 0;
 	bits2int(u1, message_hash, hash_size, curve);
 	uECC_vli_modMult(u1, u1, z, curve->n, num_n_words); /* u1 = e/s */
 	uECC_vli_modMult(u2, r, z, curve->n, num_n_words); /* u2 = r/s */
+}
+
+#if uECC_VERIFY_WNAF_WINDOW > 0
+/* Checks the signature (r, s) of message_hash against the p-256 public key
+ * whose odd multiples are in table, with VERIFY_RS_WS_WORDS words of ws. */
+static int verify_rs_wnaf(const uECC_word_t *table, const uECC_word_t *r,
+		     const uECC_word_t *s, const uint8_t *message_hash,
+		     unsigned hash_size, uECC_Curve curve, uECC_word_t *ws)
+{
+	uECC_word_t *u1 = ws, *u2 = ws + NUM_ECC_WORDS;
+	uECC_word_t *z = ws + 2 * NUM_ECC_WORDS;
+	uECC_word_t *rx = ws + 3 * NUM_ECC_WORDS;
+	uECC_word_t *ry = ws + 4 * NUM_ECC_WORDS;
+	uECC_word_t *tz = ws + 5 * NUM_ECC_WORDS;
+	wordcount_t num_n_words = BITS_TO_WORDS(uECC_NUM_N_BITS(curve));
+
+	/* Calculate u1 and u2. */
+	uECC_vli_modInv(z, s, curve->n, num_n_words); /* z = 1/s */
+	compute_u(u1, u2, z, r, message_hash, hash_size, curve);
 
-	/* Calculate sum = G + Q. */
-	uECC_vli_set(sum, _public, num_words);
-	uECC_vli_set(sum + num_words, _public + num_words, num_words);
-	uECC_vli_set(tx, curve->G, num_words);
-	uECC_vli_set(ty, curve->G + num_words, num_words);
-	uECC_vli_modSub(z, sum, tx, curve->p, num_words); /* z = x2 - x1 */
-	XYcZ_add(tx, ty, sum, sum + num_words, curve);
+	/* u1 and u2 are public: interleaved wNAF, variable-time. */
+	EccPoint_mult_double_unsafe_ws(rx, ry, tz, u1, u2, table, curve,
+				       ws + 6 * NUM_ECC_WORDS);
+	return jacobian_x_matches(rx, tz, r, curve);
+}
+#endif
+
+/* Computes result = a + b for affine points with different x; returns 0 if
+ * their x are equal. ws holds 3 * NUM_ECC_WORDS words. */
+static int affine_add(uECC_word_t *result, const uECC_word_t *a,
+		      const uECC_word_t *b, uECC_Curve curve, uECC_word_t *ws)
+{
+	uECC_word_t *tx = ws;
+	uECC_word_t *ty = ws + NUM_ECC_WORDS;
+	uECC_word_t *z = ws + 2 * NUM_ECC_WORDS;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+
+	uECC_vli_set(result, b, 2 * num_words);
+	uECC_vli_set(tx, a, num_words);
+	uECC_vli_set(ty, a + num_words, num_words);
+	uECC_vli_modSub(z, result, tx, curve->p, num_words); /* z = x2 - x1 */
+	if (uECC_vli_isZero(z, num_words)) {
+		return 0;
+	}
+	XYcZ_add(tx, ty, result, result + num_words, curve);
 	uECC_vli_modInv(z, z, curve->p, num_words); /* z = 1/z */
-	apply_z(sum, sum + num_words, z, curve);
+	apply_z(result, result + num_words, z, curve);
+	return 1;
+}
+
+/* The w bits of k starting at bit */
+static unsigned int window_bits(const uECC_word_t *k, bitcount_t bit,
+				unsigned int w)
+{
+	unsigned int bits = 0;
+	unsigned int i;
+
+	for (i = 0; i < w; ++i) {
+		bits |= (unsigned int)(!!uECC_vli_testBit(k, bit + i)) << i;
+	}
+	return bits;
+}
+
+/* Checks the signature (r, s) of message_hash with Shamir's trick on windows
+ * of w bits of u1 and u2: points[i + (j << w)] is i*G + j*Q, 0 for 0. ws holds
+ * 8 * NUM_ECC_WORDS words. */
+static int verify_rs(const uECC_word_t *const *points, unsigned int w,
+		     const uECC_word_t *r, const uECC_word_t *s,
+		     const uint8_t *message_hash, unsigned hash_size,
+		     uECC_Curve curve, uECC_word_t *ws)
+{
+	uECC_word_t *u1 = ws, *u2 = ws + NUM_ECC_WORDS;
+	uECC_word_t *z = ws + 2 * NUM_ECC_WORDS;
+	uECC_word_t *rx = ws + 3 * NUM_ECC_WORDS;
+	uECC_word_t *ry = ws + 4 * NUM_ECC_WORDS;
+	uECC_word_t *tx = ws + 5 * NUM_ECC_WORDS;
+	uECC_word_t *ty = ws + 6 * NUM_ECC_WORDS;
+	uECC_word_t *tz = ws + 7 * NUM_ECC_WORDS;
+	const uECC_word_t *point;
+	bitcount_t num_bits;
+	bitcount_t i;
+	unsigned int j;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+	wordcount_t num_n_words = BITS_TO_WORDS(uECC_NUM_N_BITS(curve));
+
+	rx[num_n_words - 1] = 0;
+
+	/* Calculate u1 and u2. */
+	uECC_vli_modInv(z, s, curve->n, num_n_words); /* z = 1/s */
+	compute_u(u1, u2, z, r, message_hash, hash_size, curve);
 
 	/* Use Shamir's trick to calculate u1*G + u2*Q */
-	points[0] = 0;
-	points[1] = curve->G;
-	points[2] = _public;
-	points[3] = sum;
 	num_bits = smax(uECC_vli_numBits(u1, num_n_words),
 	uECC_vli_numBits(u2, num_n_words));
+	i = (num_bits - 1) / w * w;
 
-	point = points[(!!uECC_vli_testBit(u1, num_bits - 1)) |
-                       ((!!uECC_vli_testBit(u2, num_bits - 1)) << 1)];
+	point = points[window_bits(u1, i, w) | (window_bits(u2, i, w) << w)];
 	uECC_vli_set(rx, point, num_words);
 	uECC_vli_set(ry, point + num_words, num_words);
 	uECC_vli_clear(z, num_words);
 	z[0] = 1;
 
-	for (i = num_bits - 2; i >= 0; --i) {
-		uECC_word_t index;
-		curve->double_jacobian(rx, ry, z, curve);
+	for (i -= (bitcount_t)w; i >= 0; i -= (bitcount_t)w) {
+		for (j = 0; j < w; ++j) {
+			uECC_DOUBLE_JACOBIAN(rx, ry, z, curve);
+		}
 
-		index = (!!uECC_vli_testBit(u1, i)) | ((!!uECC_vli_testBit(u2, i)) << 1);
-		point = points[index];
+		point = points[window_bits(u1, i, w) | (window_bits(u2, i, w) << w)];
 		if (point) {
 			uECC_vli_set(tx, point, num_words);
 			uECC_vli_set(ty, point + num_words, num_words);
@@ -288,3 +510,241 @@ int uECC_verify(const uint8_t *public_key, const uint8_t *message_hash,
 	return (int)(uECC_vli_equal(rx, r, num_words) == 0);
 }
 
+#if uECC_VERIFY_WNAF_WINDOW == 0
+/* Computes result = 2a for an affine point a. */
+static void affine_double(uECC_word_t *result, const uECC_word_t *a,
+			  uECC_Curve curve)
+{
+	uECC_word_t z[NUM_ECC_WORDS];
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+
+	uECC_vli_set(result, a, 2 * num_words);
+	uECC_vli_clear(z, num_words);
+	z[0] = 1;
+	uECC_DOUBLE_JACOBIAN(result, result + num_words, z, curve);
+	uECC_vli_modInv(z, z, curve->p, num_words); /* z = 1/z */
+	apply_z(result, result + num_words, z, curve);
+}
+
+/* Computes the 2-bit window table of Shamir's trick, table[i + 4j - 1] =
+ * i*G + j*Q for 0 <= i, j <= 3; returns 0 if a sum would need a doubling, which
+ * happens for Q = +-(i/j)G. */
+static int joint_table(uECC_word_t (*table)[NUM_ECC_WORDS * 2],
+		       const uECC_word_t *q, uECC_Curve curve)
+{
+	uECC_word_t ws[3 * NUM_ECC_WORDS];
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+	unsigned int i;
+	unsigned int j;
+
+	uECC_vli_set(table[0], curve->G, 2 * num_words);
+	affine_double(table[1], table[0], curve);
+	uECC_vli_set(table[3], q, 2 * num_words);
+	affine_double(table[7], table[3], curve);
+	if (!affine_add(table[2], table[0], table[1], curve, ws) ||
+	    !affine_add(table[11], table[3], table[7], curve, ws)) {
+		return 0;
+	}
+	for (j = 1; j <= 3; ++j) {
+		for (i = 1; i <= 3; ++i) {
+			if (!affine_add(table[i + 4 * j - 1], table[i - 1],
+					table[4 * j - 1], curve, ws)) {
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+#endif
+
+int uECC_verify(const uint8_t *public_key, const uint8_t *message_hash,
+		unsigned hash_size, const uint8_t *signature,
+	        uECC_Curve curve)
+{
+	uECC_word_t ws[uECC_VERIFY_WS_WORDS];
+
+	return uECC_verify_ws(public_key, message_hash, hash_size, signature,
+			      curve, ws);
+}
+
+int uECC_verify_ws(const uint8_t *public_key, const uint8_t *message_hash,
+		   unsigned hash_size, const uint8_t *signature,
+		   uECC_Curve curve, uECC_word_t *ws)
+{
+	uECC_word_t *_public = ws;
+	uECC_word_t *r = ws + 2 * NUM_ECC_WORDS;
+	uECC_word_t *s = ws + 3 * NUM_ECC_WORDS;
+	uECC_word_t *sum = ws + 4 * NUM_ECC_WORDS;
+	const uECC_word_t *points[4];
+#if uECC_VERIFY_WNAF_WINDOW > 0
+	uECC_word_t *q_table = ws + 6 * NUM_ECC_WORDS;
+	uECC_word_t *rest = q_table + uECC_WNAF_Q_POINTS * 2 * NUM_ECC_WORDS;
+#endif
+
+	if (!load_signature(_public, r, s, public_key, signature, curve)) {
+		return 0;
+	}
+
+#if uECC_VERIFY_WNAF_WINDOW > 0
+	/* The wNAF table of the generator is made for p-256. */
+	if (curve == uECC_secp256r1()) {
+		EccPoint_odd_multiples_ws(q_table, _public, 1, curve, rest);
+		return verify_rs_wnaf(q_table, r, s, message_hash, hash_size,
+				      curve, rest);
+	}
+#endif
+
+	/* Calculate sum = G + Q; Q = +-G is refused. */
+	if (!affine_add(sum, curve->G, _public, curve,
+			ws + 6 * NUM_ECC_WORDS)) {
+		return 0;
+	}
+	points[0] = 0;
+	points[1] = curve->G;
+	points[2] = _public;
+	points[3] = sum;
+	return verify_rs(points, 1, r, s, message_hash, hash_size, curve,
+			 ws + 6 * NUM_ECC_WORDS);
+}
+
+int uECC_verify_key_init(uECC_VerifyKey key, const uint8_t *public_key,
+			 uECC_Curve curve)
+{
+#if uECC_VERIFY_WNAF_WINDOW > 0
+	uECC_word_t ws[3 * NUM_ECC_WORDS];
+#endif
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+
+	if (uECC_valid_public_key(public_key, curve) != 0) {
+		return 0;
+	}
+
+	uECC_vli_bytesToNative(key->q, public_key, uECC_NUM_BYTES(curve));
+	uECC_vli_bytesToNative(key->q + num_words, public_key + uECC_NUM_BYTES(curve),
+			       uECC_NUM_BYTES(curve));
+	key->curve = curve;
+#if uECC_VERIFY_WNAF_WINDOW > 0
+	if (curve == uECC_secp256r1()) {
+		EccPoint_odd_multiples(key->table[0], key->q, 1, curve);
+		return 1;
+	}
+	/* Other curves keep G + Q for Shamir's trick. */
+	return affine_add(key->table[0], curve->G, key->q, curve, ws);
+#else
+	return joint_table(key->table, key->q, curve);
+#endif
+}
+
+int uECC_verify_prepared(const struct uECC_verify_key_t *key,
+			 const uint8_t *message_hash, unsigned hash_size,
+			 const uint8_t *signature)
+{
+	uECC_word_t r[NUM_ECC_WORDS], s[NUM_ECC_WORDS];
+	uECC_word_t ws[VERIFY_RS_WS_WORDS];
+	uECC_Curve curve = key->curve;
+#if uECC_VERIFY_WNAF_WINDOW > 0
+	const uECC_word_t *points[4];
+#else
+	const uECC_word_t *points[16];
+	unsigned int i;
+#endif
+
+	if (!load_rs(r, s, signature, curve)) {
+		return 0;
+	}
+
+#if uECC_VERIFY_WNAF_WINDOW > 0
+	if (curve == uECC_secp256r1()) {
+		return verify_rs_wnaf(key->table[0], r, s, message_hash,
+				      hash_size, curve, ws);
+	}
+	points[0] = 0;
+	points[1] = curve->G;
+	points[2] = key->q;
+	points[3] = key->table[0];
+	return verify_rs(points, 1, r, s, message_hash, hash_size, curve, ws);
+#else
+	points[0] = 0;
+	for (i = 1; i < 16; ++i) {
+		points[i] = key->table[i - 1];
+	}
+	return verify_rs(points, 2, r, s, message_hash, hash_size, curve, ws);
+#endif
+}
+
+int uECC_verify_batch(const uint8_t *const *public_keys,
+		      const uint8_t *const *message_hashes, unsigned hash_size,
+		      const uint8_t *const *signatures, unsigned int count,
+		      int *results, uECC_Curve curve)
+{
+	int all_valid = 1;
+#if uECC_VERIFY_WNAF_WINDOW > 0
+	uECC_word_t _public[uECC_VERIFY_BATCH_SIZE][NUM_ECC_WORDS * 2];
+	uECC_word_t q_tables[uECC_VERIFY_BATCH_SIZE][uECC_WNAF_Q_POINTS]
+			    [NUM_ECC_WORDS * 2];
+	uECC_word_t r[uECC_VERIFY_BATCH_SIZE][NUM_ECC_WORDS];
+	uECC_word_t s[uECC_VERIFY_BATCH_SIZE][NUM_ECC_WORDS];
+	uECC_word_t u1[uECC_VERIFY_BATCH_SIZE][NUM_ECC_WORDS];
+	uECC_word_t u2[uECC_VERIFY_BATCH_SIZE][NUM_ECC_WORDS];
+	uECC_word_t X[NUM_ECC_WORDS];
+	uECC_word_t Y[NUM_ECC_WORDS];
+	uECC_word_t Z[NUM_ECC_WORDS];
+	unsigned int batch;
+	unsigned int done;
+	unsigned int i;
+
+	/* The wNAF table of the generator is made for p-256. */
+	if (curve == uECC_secp256r1()) {
+		for (done = 0; done < count; done += batch) {
+			batch = count - done;
+			if (batch > uECC_VERIFY_BATCH_SIZE) {
+				batch = uECC_VERIFY_BATCH_SIZE;
+			}
+
+			/* Rejected signatures keep s = 0, which the batch
+			 * inversion skips. */
+			for (i = 0; i < batch; ++i) {
+				results[done + i] =
+					load_signature(_public[i], r[i], s[i],
+						       public_keys[done + i],
+						       signatures[done + i], curve);
+				if (!results[done + i]) {
+					uECC_vli_clear(s[i], NUM_ECC_WORDS);
+				}
+			}
+
+			/* One inversion mod n for all the 1/s, and two mod p for
+			 * all the tables of odd multiples of the public keys. */
+			uECC_vli_modInv_batch(s[0], u1[0], batch, curve->n,
+					      curve);
+			EccPoint_odd_multiples(q_tables[0][0], _public[0], batch,
+					       curve);
+
+			for (i = 0; i < batch; ++i) {
+				if (results[done + i]) {
+					compute_u(u1[i], u2[i], s[i], r[i],
+						  message_hashes[done + i],
+						  hash_size, curve);
+					EccPoint_mult_double_unsafe(X, Y, Z, u1[i],
+								    u2[i],
+								    q_tables[i][0],
+								    curve);
+					results[done + i] =
+						jacobian_x_matches(X, Z, r[i], curve);
+				}
+				all_valid &= results[done + i];
+			}
+		}
+		return all_valid;
+	}
+#else
+	unsigned int i;
+#endif
+
+	for (i = 0; i < count; ++i) {
+		results[i] = uECC_verify(public_keys[i], message_hashes[i],
+					 hash_size, signatures[i], curve);
+		all_valid &= results[i];
+	}
+	return all_valid;
+}
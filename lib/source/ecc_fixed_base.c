@@ -0,0 +1,1349 @@
+/* ecc_fixed_base.c - TinyCrypt implementation of fixed-base point multiplication */
+
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/ecc.h>
+
+#if uECC_FIXED_BASE_TEETH > 0
+
+/*
+ * Comb table for secp256r1's generator with uECC_FIXED_BASE_TEETH teeth of
+ * spacing COMB_SPACING = ceil(256 / teeth). Entry j - 1 holds the affine point
+ * sum(2^(i * COMB_SPACING) * G) over the bits i set in j.
+ */
+/* BEGIN tables generated by tools/tcgentab.c (make -C tools tables) */
+#if uECC_FIXED_BASE_TEETH == 4
+#define COMB_SPACING 64
+static const uECC_word_t comb_table[(1 << 4) - 1][2 * NUM_ECC_WORDS] = {
+	{
+		BYTES_TO_WORDS_8(96, C2, 98, D8, 45, 39, A1, F4),
+		BYTES_TO_WORDS_8(A0, 33, EB, 2D, 81, 7D, 03, 77),
+		BYTES_TO_WORDS_8(F2, 40, A4, 63, E5, E6, BC, F8),
+		BYTES_TO_WORDS_8(47, 42, 2C, E1, F2, D1, 17, 6B),
+		BYTES_TO_WORDS_8(F5, 51, BF, 37, 68, 40, B6, CB),
+		BYTES_TO_WORDS_8(CE, 5E, 31, 6B, 57, 33, CE, 2B),
+		BYTES_TO_WORDS_8(16, 9E, 0F, 7C, 4A, EB, E7, 8E),
+		BYTES_TO_WORDS_8(9B, 7F, 1A, FE, E2, 42, E3, 4F)
+	},
+	{
+		BYTES_TO_WORDS_8(63, DB, 14, 8E, B4, 5C, E7, 90),
+		BYTES_TO_WORDS_8(7E, 1F, 65, AD, AA, 3B, 49, 29),
+		BYTES_TO_WORDS_8(DE, 25, 6E, 32, 2E, 59, 92, 84),
+		BYTES_TO_WORDS_8(A5, AA, 11, 28, BC, 22, A8, 0F),
+		BYTES_TO_WORDS_8(E7, 2E, 46, 5F, 54, 24, 11, E4),
+		BYTES_TO_WORDS_8(F5, 82, FE, 50, 50, A6, B1, 34),
+		BYTES_TO_WORDS_8(8B, 18, DF, B3, BC, D4, 4A, 6F),
+		BYTES_TO_WORDS_8(0D, A8, DB, F5, E8, 4A, F4, BF)
+	},
+	{
+		BYTES_TO_WORDS_8(AF, 92, 79, 09, E2, 1C, 39, 93),
+		BYTES_TO_WORDS_8(FA, F1, 35, 0D, FD, 98, 6C, E9),
+		BYTES_TO_WORDS_8(89, 27, E0, 95, DE, C0, 57, B2),
+		BYTES_TO_WORDS_8(6F, 72, D6, 89, BC, 4B, 0A, 30),
+		BYTES_TO_WORDS_8(A0, 27, 81, C0, 91, A2, 54, AA),
+		BYTES_TO_WORDS_8(A5, 06, D8, A9, AD, EE, B1, 5B),
+		BYTES_TO_WORDS_8(6F, 3C, 1E, FF, 25, DB, 1D, 7F),
+		BYTES_TO_WORDS_8(44, 46, 9B, D0, E0, C7, AA, 72)
+	},
+	{
+		BYTES_TO_WORDS_8(85, BD, 89, D7, C9, 4F, C8, 57),
+		BYTES_TO_WORDS_8(C3, EA, 97, C2, 7D, FF, 35, FC),
+		BYTES_TO_WORDS_8(6E, 76, C6, 88, D5, 2F, 98, FB),
+		BYTES_TO_WORDS_8(67, 5E, DB, EE, 9B, 73, 7D, 44),
+		BYTES_TO_WORDS_8(32, 5B, E2, 72, C9, 33, 7E, 0C),
+		BYTES_TO_WORDS_8(00, E5, FA, A7, 95, 9B, 34, 3D),
+		BYTES_TO_WORDS_8(F7, AF, 4A, 3A, 95, 9D, 2E, E1),
+		BYTES_TO_WORDS_8(EE, 31, 41, 83, AB, 25, 48, 2D)
+	},
+	{
+		BYTES_TO_WORDS_8(7F, 36, 1D, 2A, 93, 9C, 94, 13),
+		BYTES_TO_WORDS_8(B7, 11, 0A, 1A, 2B, BD, 7F, EF),
+		BYTES_TO_WORDS_8(60, FC, 1D, B9, 8B, 06, C6, DD),
+		BYTES_TO_WORDS_8(FF, 72, 9C, 8A, 32, 19, 95, EF),
+		BYTES_TO_WORDS_8(A8, D8, 76, 73, A7, 35, 60, 19),
+		BYTES_TO_WORDS_8(40, 17, CA, 95, 08, 3B, 18, 23),
+		BYTES_TO_WORDS_8(9C, 21, 2C, 02, 07, 98, EE, C1),
+		BYTES_TO_WORDS_8(9B, 2C, BB, 7D, C3, 9F, 1E, 61)
+	},
+	{
+		BYTES_TO_WORDS_8(BC, F4, 57, 0B, 92, B1, E2, CA),
+		BYTES_TO_WORDS_8(36, BC, C9, C6, 5E, DF, 36, 29),
+		BYTES_TO_WORDS_8(BF, 38, 12, E1, 82, 64, EA, 7D),
+		BYTES_TO_WORDS_8(D8, F5, 51, 7B, 79, 63, 06, 55),
+		BYTES_TO_WORDS_8(4C, 96, 8A, 34, 16, E2, FF, 44),
+		BYTES_TO_WORDS_8(E1, FB, DE, DB, 76, D5, B3, 9F),
+		BYTES_TO_WORDS_8(E5, 50, 9D, 8D, 01, 40, FA, 0A),
+		BYTES_TO_WORDS_8(51, B8, EC, 8A, 84, 64, 71, 15)
+	},
+	{
+		BYTES_TO_WORDS_8(01, DE, 5C, FC, FF, CA, 8E, E4),
+		BYTES_TO_WORDS_8(26, 5F, 71, 0D, E7, 84, CD, 7C),
+		BYTES_TO_WORDS_8(91, 43, 3E, F4, 83, F4, E8, A2),
+		BYTES_TO_WORDS_8(EA, 41, 11, B2, 45, 77, 5D, EB),
+		BYTES_TO_WORDS_8(79, 34, 1A, 73, E2, 17, C9, CA),
+		BYTES_TO_WORDS_8(45, B6, 44, 28, FE, 2C, F2, 85),
+		BYTES_TO_WORDS_8(EE, 6C, 00, 58, A1, E6, 90, 09),
+		BYTES_TO_WORDS_8(7B, C1, EC, DB, EB, 72, FD, EA)
+	},
+	{
+		BYTES_TO_WORDS_8(BE, 28, 37, 31, FB, 0F, F2, 6C),
+		BYTES_TO_WORDS_8(4A, B9, C6, A3, 91, 95, 43, 96),
+		BYTES_TO_WORDS_8(C5, 5F, 31, 44, 83, FF, 36, 27),
+		BYTES_TO_WORDS_8(76, 92, 84, A7, 77, 96, D3, A6),
+		BYTES_TO_WORDS_8(F4, F5, 57, C3, 33, B8, BA, F2),
+		BYTES_TO_WORDS_8(9B, 05, 84, 22, 0C, 92, 4A, 82),
+		BYTES_TO_WORDS_8(DF, EC, 27, 2D, BD, BA, B8, 66),
+		BYTES_TO_WORDS_8(16, 88, 0B, 9B, 74, 84, 4F, 67)
+	},
+	{
+		BYTES_TO_WORDS_8(3E, 8A, 7C, 67, 04, 8C, F4, 2D),
+		BYTES_TO_WORDS_8(6B, A5, 03, 02, 08, 2F, E0, 74),
+		BYTES_TO_WORDS_8(DB, FE, C7, B8, 7D, 5F, 85, 31),
+		BYTES_TO_WORDS_8(AD, DD, C9, 72, 76, 9E, 76, 4E),
+		BYTES_TO_WORDS_8(B0, BB, 24, B8, 65, 61, C3, A4),
+		BYTES_TO_WORDS_8(A5, 22, 91, 3B, 6F, E1, 9A, FB),
+		BYTES_TO_WORDS_8(81, 72, 94, 06, 72, 05, C0, 1E),
+		BYTES_TO_WORDS_8(63, 06, 83, DE, 82, 90, B9, 42)
+	},
+	{
+		BYTES_TO_WORDS_8(B9, 68, A8, DD, 50, 51, F9, 6E),
+		BYTES_TO_WORDS_8(31, E1, 0C, 9C, 79, 9E, F8, D1),
+		BYTES_TO_WORDS_8(78, C4, A1, 08, A0, 1C, DC, 7F),
+		BYTES_TO_WORDS_8(4D, E0, 6C, 1C, F6, 8E, 87, 78),
+		BYTES_TO_WORDS_8(76, D9, E0, 1F, 12, B9, 62, 9C),
+		BYTES_TO_WORDS_8(4F, 8D, E0, BD, 0E, 57, CE, 6A),
+		BYTES_TO_WORDS_8(EF, 9D, 30, 12, 2C, 14, 53, DE),
+		BYTES_TO_WORDS_8(21, C3, 72, 7B, 5D, 3F, CB, B6)
+	},
+	{
+		BYTES_TO_WORDS_8(73, 35, 1A, C3, D2, 1E, 99, 7F),
+		BYTES_TO_WORDS_8(96, B4, 4F, D5, 5B, DD, 82, 5B),
+		BYTES_TO_WORDS_8(AE, FC, 2F, 81, 20, 52, 5C, 59),
+		BYTES_TO_WORDS_8(87, 12, 6B, 71, 4D, BC, 88, 0C),
+		BYTES_TO_WORDS_8(A8, AC, 48, 5F, 63, BF, 57, 3A),
+		BYTES_TO_WORDS_8(F3, 64, 25, DF, F4, 81, 81, 7C),
+		BYTES_TO_WORDS_8(AA, E6, 04, 9C, B3, B5, D1, 18),
+		BYTES_TO_WORDS_8(C6, 1D, 90, F3, A3, DE, 5D, DD)
+	},
+	{
+		BYTES_TO_WORDS_8(0C, AD, 72, 3E, FB, 79, 6A, E9),
+		BYTES_TO_WORDS_8(2F, 79, BA, 42, 8C, A2, A0, 43),
+		BYTES_TO_WORDS_8(F3, 49, 3E, 08, 23, A4, E0, EF),
+		BYTES_TO_WORDS_8(66, 74, 31, 6B, AF, 44, F3, 68),
+		BYTES_TO_WORDS_8(4A, 4D, B2, 3F, DB, 17, FE, CD),
+		BYTES_TO_WORDS_8(26, C6, F5, 71, 22, FC, 8B, 66),
+		BYTES_TO_WORDS_8(F3, 7F, D6, 24, 3C, D9, 4E, 60),
+		BYTES_TO_WORDS_8(20, 0A, 54, F8, 05, C4, B9, 31)
+	},
+	{
+		BYTES_TO_WORDS_8(7F, 2E, 58, A2, 89, 47, 6B, D3),
+		BYTES_TO_WORDS_8(28, 9C, C3, 4E, 14, 10, 1A, 0D),
+		BYTES_TO_WORDS_8(A0, D7, BA, ED, C3, 62, 3C, 66),
+		BYTES_TO_WORDS_8(B9, 1D, 46, 6F, 4B, BF, 52, 40),
+		BYTES_TO_WORDS_8(EB, 25, 8D, 18, C3, 27, 5A, 23),
+		BYTES_TO_WORDS_8(5B, CC, BF, 99, 39, F3, 24, E7),
+		BYTES_TO_WORDS_8(C8, 0C, D7, 71, BD, E6, 2B, 86),
+		BYTES_TO_WORDS_8(61, FC, B0, 90, 51, 4D, CF, FE)
+	},
+	{
+		BYTES_TO_WORDS_8(AC, CF, D4, A1, 10, 6C, 34, 74),
+		BYTES_TO_WORDS_8(A4, A7, 26, 85, C0, 5C, DF, AF),
+		BYTES_TO_WORDS_8(7A, FF, 2B, F6, A8, 02, 32, 12),
+		BYTES_TO_WORDS_8(1A, E4, 02, C8, E2, BA, DD, 1E),
+		BYTES_TO_WORDS_8(44, F8, 03, D6, 2D, AF, A0, 8F),
+		BYTES_TO_WORDS_8(17, 19, 70, 4C, 7E, 6B, E0, 36),
+		BYTES_TO_WORDS_8(A0, 33, DB, 73, 52, F4, 45, 0C),
+		BYTES_TO_WORDS_8(FC, BC, 0E, 56, 86, 4D, 10, 43)
+	},
+	{
+		BYTES_TO_WORDS_8(E5, 78, 1D, 0D, 11, B5, 15, 96),
+		BYTES_TO_WORDS_8(4B, 74, C4, 25, 32, DE, B0, 66),
+		BYTES_TO_WORDS_8(3A, 36, AF, 6A, FB, 46, 4A, 0A),
+		BYTES_TO_WORDS_8(1C, A2, F7, 84, B4, 26, 8E, B4),
+		BYTES_TO_WORDS_8(2D, 1B, A0, 21, F6, B0, EB, 06),
+		BYTES_TO_WORDS_8(98, 0F, 7B, 8B, 04, E4, 04, C0),
+		BYTES_TO_WORDS_8(68, F6, D6, FE, CD, 1B, 13, 64),
+		BYTES_TO_WORDS_8(AB, 3D, 4D, 4D, 40, 15, C0, FA)
+	}
+};
+#elif uECC_FIXED_BASE_TEETH == 5
+#define COMB_SPACING 52
+static const uECC_word_t comb_table[(1 << 5) - 1][2 * NUM_ECC_WORDS] = {
+	{
+		BYTES_TO_WORDS_8(96, C2, 98, D8, 45, 39, A1, F4),
+		BYTES_TO_WORDS_8(A0, 33, EB, 2D, 81, 7D, 03, 77),
+		BYTES_TO_WORDS_8(F2, 40, A4, 63, E5, E6, BC, F8),
+		BYTES_TO_WORDS_8(47, 42, 2C, E1, F2, D1, 17, 6B),
+		BYTES_TO_WORDS_8(F5, 51, BF, 37, 68, 40, B6, CB),
+		BYTES_TO_WORDS_8(CE, 5E, 31, 6B, 57, 33, CE, 2B),
+		BYTES_TO_WORDS_8(16, 9E, 0F, 7C, 4A, EB, E7, 8E),
+		BYTES_TO_WORDS_8(9B, 7F, 1A, FE, E2, 42, E3, 4F)
+	},
+	{
+		BYTES_TO_WORDS_8(83, 5C, 1E, 07, 92, BC, A6, EE),
+		BYTES_TO_WORDS_8(BE, A0, 42, 85, 19, 7F, D2, 8B),
+		BYTES_TO_WORDS_8(B1, E5, 58, 2A, B7, 45, A8, 20),
+		BYTES_TO_WORDS_8(3F, D7, 26, 50, 41, C9, CC, 54),
+		BYTES_TO_WORDS_8(A1, 16, 09, 14, F7, 8E, D0, CF),
+		BYTES_TO_WORDS_8(96, E4, 8E, 5D, CC, 0B, 9E, 92),
+		BYTES_TO_WORDS_8(22, BF, D2, DA, 15, 87, 8F, 3A),
+		BYTES_TO_WORDS_8(32, 45, 51, B4, 45, 3F, 43, 1C)
+	},
+	{
+		BYTES_TO_WORDS_8(70, C8, BA, 04, B7, 4B, D2, F7),
+		BYTES_TO_WORDS_8(AB, C6, 23, 3A, A0, 09, 3A, 59),
+		BYTES_TO_WORDS_8(1D, 9D, 4C, F9, 58, 23, CC, DF),
+		BYTES_TO_WORDS_8(02, ED, 7B, 29, 87, 0F, FA, 3C),
+		BYTES_TO_WORDS_8(40, 69, F2, 40, 0B, A3, 98, CE),
+		BYTES_TO_WORDS_8(AF, A8, 48, 02, 0D, 1C, 12, 62),
+		BYTES_TO_WORDS_8(9B, AF, 09, 83, 80, AA, 58, A7),
+		BYTES_TO_WORDS_8(C6, 12, BE, 70, 94, 76, E3, E4)
+	},
+	{
+		BYTES_TO_WORDS_8(E0, A7, CC, 3E, EA, A5, 39, C7),
+		BYTES_TO_WORDS_8(3E, 33, 43, 67, 8F, C9, D2, A7),
+		BYTES_TO_WORDS_8(28, 94, 4D, 22, 35, 63, EF, 0F),
+		BYTES_TO_WORDS_8(0C, 2A, 79, 5C, 3C, EE, F2, 7E),
+		BYTES_TO_WORDS_8(94, C0, 2A, 55, DD, 22, 2B, 30),
+		BYTES_TO_WORDS_8(20, 3D, BD, DF, 50, 14, B2, 81),
+		BYTES_TO_WORDS_8(DB, 09, E6, D5, 51, 7F, F6, A4),
+		BYTES_TO_WORDS_8(11, C0, AC, 30, 27, 86, B6, AF)
+	},
+	{
+		BYTES_TO_WORDS_8(7D, 7D, EF, 86, FF, E3, 37, DD),
+		BYTES_TO_WORDS_8(DB, 86, 8B, 08, 27, 7C, D7, F6),
+		BYTES_TO_WORDS_8(91, 54, 4C, 25, 4F, 9A, FE, 28),
+		BYTES_TO_WORDS_8(5E, FD, F0, 6D, 37, 03, 69, D6),
+		BYTES_TO_WORDS_8(96, D5, DA, AD, 92, 49, F0, 9F),
+		BYTES_TO_WORDS_8(F9, 73, 43, 9E, AF, A7, D1, F3),
+		BYTES_TO_WORDS_8(67, 41, 07, DF, 78, 95, 3E, A1),
+		BYTES_TO_WORDS_8(22, 3D, D1, E6, 3C, A5, E2, 20)
+	},
+	{
+		BYTES_TO_WORDS_8(05, 96, 87, B0, EE, 6A, B8, D7),
+		BYTES_TO_WORDS_8(65, 72, 3C, BE, 2D, EC, 24, A4),
+		BYTES_TO_WORDS_8(9E, 1E, F0, 12, C2, 03, 62, 27),
+		BYTES_TO_WORDS_8(E9, 46, 7E, B7, C5, FA, 66, B6),
+		BYTES_TO_WORDS_8(2D, C5, F0, 3B, 1A, BB, 31, F4),
+		BYTES_TO_WORDS_8(B6, D8, 6C, 72, 4A, A4, 46, EF),
+		BYTES_TO_WORDS_8(A9, E5, 3D, EE, 19, BC, 5A, EB),
+		BYTES_TO_WORDS_8(04, 69, 24, 90, 80, A3, AA, 38)
+	},
+	{
+		BYTES_TO_WORDS_8(BF, 6A, 5D, 52, 35, D7, BF, AE),
+		BYTES_TO_WORDS_8(5A, A2, BE, 96, F4, F8, 02, C3),
+		BYTES_TO_WORDS_8(A4, 20, 49, 54, EA, B3, 82, DB),
+		BYTES_TO_WORDS_8(2E, DB, EA, 02, D1, 75, 1C, 62),
+		BYTES_TO_WORDS_8(F0, 85, F4, 9E, 4C, DC, 39, 89),
+		BYTES_TO_WORDS_8(63, 6D, C4, 57, D8, 03, 5D, 22),
+		BYTES_TO_WORDS_8(70, 7F, 2D, 52, 6F, C9, DA, 4F),
+		BYTES_TO_WORDS_8(9D, 64, FA, B4, FE, A4, C4, D7)
+	},
+	{
+		BYTES_TO_WORDS_8(2A, 83, 3E, 94, F1, 2E, 76, 9C),
+		BYTES_TO_WORDS_8(70, DF, 86, 17, B0, 0A, E5, 07),
+		BYTES_TO_WORDS_8(8E, F1, 89, 25, A8, 73, F5, 90),
+		BYTES_TO_WORDS_8(1A, A5, C2, A7, 8B, F2, 2B, 0D),
+		BYTES_TO_WORDS_8(7C, D3, 20, 5B, F1, 3A, 26, 48),
+		BYTES_TO_WORDS_8(46, 14, 55, 60, B9, 9D, EC, 27),
+		BYTES_TO_WORDS_8(ED, E7, B4, 94, 0A, A1, 87, 70),
+		BYTES_TO_WORDS_8(AC, 00, BD, 13, 43, 3F, AC, 0C)
+	},
+	{
+		BYTES_TO_WORDS_8(2A, 37, B9, C0, AA, 59, C6, 8B),
+		BYTES_TO_WORDS_8(3F, 58, D9, ED, 58, 99, 65, F7),
+		BYTES_TO_WORDS_8(88, 7D, 26, 8C, 4A, F9, 05, 9F),
+		BYTES_TO_WORDS_8(9D, 73, 9A, C9, E7, 46, DC, 00),
+		BYTES_TO_WORDS_8(F2, D0, 55, DF, 00, 0A, F5, 4A),
+		BYTES_TO_WORDS_8(6A, BF, 56, 81, 2D, 20, EB, B5),
+		BYTES_TO_WORDS_8(11, C1, 28, 52, AB, E3, D1, 40),
+		BYTES_TO_WORDS_8(24, 34, 79, 45, 57, A5, 12, 03)
+	},
+	{
+		BYTES_TO_WORDS_8(E0, 86, 64, 9E, A8, CD, 90, 9D),
+		BYTES_TO_WORDS_8(C0, 22, 75, 1C, BD, 20, A8, C8),
+		BYTES_TO_WORDS_8(AB, D7, DC, 08, 80, 55, 7C, 86),
+		BYTES_TO_WORDS_8(92, 78, 2A, 88, E2, 0C, 51, 3C),
+		BYTES_TO_WORDS_8(C6, 54, 6D, 64, 34, 33, 28, 0E),
+		BYTES_TO_WORDS_8(46, E0, A4, ED, 76, 27, 39, 33),
+		BYTES_TO_WORDS_8(B0, 97, A9, 5B, 08, FC, A7, C3),
+		BYTES_TO_WORDS_8(3F, 05, CF, 5A, 0F, 62, 5E, D3)
+	},
+	{
+		BYTES_TO_WORDS_8(EE, CF, B8, 7E, F7, 92, 96, 8D),
+		BYTES_TO_WORDS_8(3D, 01, 8C, 0D, 23, F2, E3, 05),
+		BYTES_TO_WORDS_8(59, 2E, E3, 84, 52, 7A, 34, 76),
+		BYTES_TO_WORDS_8(E5, A1, B0, 15, 90, E2, 53, 3C),
+		BYTES_TO_WORDS_8(D4, 98, E7, FA, A5, 7D, 8B, 53),
+		BYTES_TO_WORDS_8(91, 35, D2, 00, D1, 1B, 9F, 1B),
+		BYTES_TO_WORDS_8(3F, 69, 08, 9A, 72, F0, A9, 11),
+		BYTES_TO_WORDS_8(B3, FE, 0E, 14, DA, 7C, 0E, D3)
+	},
+	{
+		BYTES_TO_WORDS_8(04, C0, D6, 4D, 26, C9, DE, 81),
+		BYTES_TO_WORDS_8(D5, 10, D2, DA, FE, 14, ED, BF),
+		BYTES_TO_WORDS_8(11, 99, 6B, B9, 69, FF, F9, 39),
+		BYTES_TO_WORDS_8(4D, 02, C2, 29, 73, 7B, FD, 02),
+		BYTES_TO_WORDS_8(FC, 29, 5D, 71, B8, CE, CF, 50),
+		BYTES_TO_WORDS_8(11, 63, 23, 0C, 99, B9, 82, B6),
+		BYTES_TO_WORDS_8(31, 78, 79, C7, DD, 4A, F3, 00),
+		BYTES_TO_WORDS_8(F3, 7D, 92, 59, CB, D3, EB, 42)
+	},
+	{
+		BYTES_TO_WORDS_8(83, F6, E8, F8, 87, F7, FC, 6D),
+		BYTES_TO_WORDS_8(90, BE, 7F, 3F, 7A, 2B, D7, 13),
+		BYTES_TO_WORDS_8(CF, 32, F2, 2D, 94, 6D, 42, FD),
+		BYTES_TO_WORDS_8(AD, 9A, E3, 5F, 42, BB, 84, ED),
+		BYTES_TO_WORDS_8(FC, 95, 29, 73, A1, 67, 3E, 02),
+		BYTES_TO_WORDS_8(E3, 30, 54, 35, 8E, 0A, DD, 67),
+		BYTES_TO_WORDS_8(03, D7, A1, 97, 61, 3B, F8, 0C),
+		BYTES_TO_WORDS_8(F2, 33, 3C, 58, 55, 34, 23, A3)
+	},
+	{
+		BYTES_TO_WORDS_8(04, 29, 14, 68, B4, 4A, 01, 27),
+		BYTES_TO_WORDS_8(17, A6, CF, 00, 82, 08, 50, FB),
+		BYTES_TO_WORDS_8(58, B9, 09, 70, 87, FF, 45, 67),
+		BYTES_TO_WORDS_8(2D, 24, 49, D4, BC, 89, 98, 9E),
+		BYTES_TO_WORDS_8(C8, 16, 56, 57, 3B, 61, 5B, 03),
+		BYTES_TO_WORDS_8(E2, 99, 8E, 13, 56, 51, 85, 00),
+		BYTES_TO_WORDS_8(A0, 6A, 2E, 29, 4B, D2, C0, 94),
+		BYTES_TO_WORDS_8(A2, B3, 79, 7E, 68, 5B, BA, D9)
+	},
+	{
+		BYTES_TO_WORDS_8(99, 5D, 16, 5F, 7B, BC, BB, CE),
+		BYTES_TO_WORDS_8(61, EE, 4E, 8A, C1, 51, CC, 50),
+		BYTES_TO_WORDS_8(1F, 0D, 4D, 1B, 53, 23, 1D, B3),
+		BYTES_TO_WORDS_8(DA, 2A, 38, 66, 52, 84, E1, 95),
+		BYTES_TO_WORDS_8(5B, 9B, 83, 0A, 81, 4F, AD, AC),
+		BYTES_TO_WORDS_8(0F, FF, 42, 41, 6E, A9, A2, A0),
+		BYTES_TO_WORDS_8(2F, A1, 4F, 1F, 89, 82, AA, 3E),
+		BYTES_TO_WORDS_8(F3, B8, 0F, 6B, 8F, 8C, D6, 68)
+	},
+	{
+		BYTES_TO_WORDS_8(5F, B8, 9B, 83, C3, 09, 0F, 32),
+		BYTES_TO_WORDS_8(2C, E6, 50, A0, 06, FB, 01, 01),
+		BYTES_TO_WORDS_8(58, 34, D5, 9A, C9, 82, 75, 55),
+		BYTES_TO_WORDS_8(2B, 43, 66, 16, 8D, 39, D5, 55),
+		BYTES_TO_WORDS_8(6F, 93, ED, 4F, 18, 31, F6, F7),
+		BYTES_TO_WORDS_8(E1, D9, 33, 18, 7F, 6A, 0D, D9),
+		BYTES_TO_WORDS_8(2A, A7, BA, 8E, 9E, 6A, 9C, 05),
+		BYTES_TO_WORDS_8(2D, 8E, FF, 49, 90, 22, 6E, 57)
+	},
+	{
+		BYTES_TO_WORDS_8(F1, B3, BB, 51, 69, A2, 11, 93),
+		BYTES_TO_WORDS_8(65, 4F, 0F, 8D, BD, 26, 0F, E8),
+		BYTES_TO_WORDS_8(B9, CB, EC, 6B, 34, C3, 3D, 9D),
+		BYTES_TO_WORDS_8(E4, 5D, 1E, 10, D5, 44, E2, 54),
+		BYTES_TO_WORDS_8(28, 9E, B1, F1, 6E, 4C, AD, B3),
+		BYTES_TO_WORDS_8(B7, E3, C2, 58, C0, FB, 34, 43),
+		BYTES_TO_WORDS_8(25, 9C, DF, 35, 07, 41, BD, 19),
+		BYTES_TO_WORDS_8(B6, 6E, 10, EC, 0E, EC, BB, D6)
+	},
+	{
+		BYTES_TO_WORDS_8(C5, 6D, 04, E5, C7, 51, 82, 78),
+		BYTES_TO_WORDS_8(7B, 32, 79, F1, 95, 9B, 83, 12),
+		BYTES_TO_WORDS_8(6E, B4, 8C, 4A, 98, 5D, C0, F1),
+		BYTES_TO_WORDS_8(6B, 73, 00, 3C, CD, 37, 37, 44),
+		BYTES_TO_WORDS_8(E5, 8F, CD, 12, 56, A4, 60, A7),
+		BYTES_TO_WORDS_8(D9, BD, 17, 08, DE, 89, 74, 79),
+		BYTES_TO_WORDS_8(E8, 23, 2C, F4, 0A, B8, 6E, C5),
+		BYTES_TO_WORDS_8(F5, 7A, FE, E6, D7, 9D, 71, 83)
+	},
+	{
+		BYTES_TO_WORDS_8(C8, CF, EF, 3F, 83, 1A, 88, E8),
+		BYTES_TO_WORDS_8(0B, 29, B5, B9, E0, C9, A3, AE),
+		BYTES_TO_WORDS_8(88, 46, 1E, 77, CD, 7E, B3, 10),
+		BYTES_TO_WORDS_8(B6, 21, D0, D4, A3, 16, 08, EE),
+		BYTES_TO_WORDS_8(A1, CA, A8, B3, BF, 29, 99, 8E),
+		BYTES_TO_WORDS_8(D1, F2, 05, C1, CF, 5D, 91, 48),
+		BYTES_TO_WORDS_8(9F, 01, 49, DB, 82, DF, 5F, 3A),
+		BYTES_TO_WORDS_8(E1, 06, 90, AD, E3, 38, A4, C4)
+	},
+	{
+		BYTES_TO_WORDS_8(29, 4B, DE, 87, 0F, 62, B9, 5D),
+		BYTES_TO_WORDS_8(2E, CB, 1E, D9, 18, 0C, 42, D7),
+		BYTES_TO_WORDS_8(05, F1, AC, 32, B2, A1, 1B, 30),
+		BYTES_TO_WORDS_8(37, A9, 53, 78, 0C, BB, 96, DB),
+		BYTES_TO_WORDS_8(34, AC, 59, C3, F6, FE, 4B, D8),
+		BYTES_TO_WORDS_8(1D, 2A, 85, 64, F0, CE, 80, AB),
+		BYTES_TO_WORDS_8(17, 17, DA, B9, D3, E4, BE, 3F),
+		BYTES_TO_WORDS_8(2C, 22, 13, 7A, 4E, 07, 25, B3)
+	},
+	{
+		BYTES_TO_WORDS_8(C9, D2, 3A, E8, 03, C5, 6D, 5D),
+		BYTES_TO_WORDS_8(BE, 35, D0, AE, 1D, 7A, 9F, CA),
+		BYTES_TO_WORDS_8(33, 1E, D2, CB, AC, 88, 27, 55),
+		BYTES_TO_WORDS_8(F0, B9, 9C, E0, 31, DD, 99, 86),
+		BYTES_TO_WORDS_8(61, F9, 9B, 32, 96, 41, 58, 38),
+		BYTES_TO_WORDS_8(F9, 5A, 2A, B8, 96, 0E, B2, 4C),
+		BYTES_TO_WORDS_8(C1, 78, 2C, C7, 08, 99, 19, 24),
+		BYTES_TO_WORDS_8(B7, 59, 28, E9, 84, 54, E6, 16)
+	},
+	{
+		BYTES_TO_WORDS_8(29, DE, 2F, 05, 4B, 1C, 20, 6A),
+		BYTES_TO_WORDS_8(B4, DB, 31, 00, 23, 71, 89, 6C),
+		BYTES_TO_WORDS_8(96, DA, C1, 16, 82, 99, 75, 4A),
+		BYTES_TO_WORDS_8(14, 72, C6, 2C, 75, B9, C0, EE),
+		BYTES_TO_WORDS_8(4E, 86, 2C, 81, F1, B9, 08, B9),
+		BYTES_TO_WORDS_8(BA, F6, 39, 84, 6A, B6, 7F, 36),
+		BYTES_TO_WORDS_8(29, F3, 66, F9, 4B, 66, 9D, 78),
+		BYTES_TO_WORDS_8(83, D2, F1, F7, 70, F7, 2A, E0)
+	},
+	{
+		BYTES_TO_WORDS_8(DD, 38, 30, DB, 70, 2C, 0A, A2),
+		BYTES_TO_WORDS_8(7C, 5C, 9D, E9, D5, 46, 0B, 5F),
+		BYTES_TO_WORDS_8(83, 0B, 60, 4B, 37, 7D, B9, C9),
+		BYTES_TO_WORDS_8(5E, 24, F3, 3D, 79, 7F, 6C, 18),
+		BYTES_TO_WORDS_8(7F, E5, 1C, 4F, 60, 24, F7, 2A),
+		BYTES_TO_WORDS_8(ED, D8, E2, 91, 7F, 89, 49, 92),
+		BYTES_TO_WORDS_8(97, A7, 2E, 8D, 6A, B3, 39, 81),
+		BYTES_TO_WORDS_8(13, 89, B5, 9A, B8, 8D, 42, 9C)
+	},
+	{
+		BYTES_TO_WORDS_8(A0, AA, 71, 64, FB, 96, A1, B4),
+		BYTES_TO_WORDS_8(30, 97, 6B, 1B, 50, B6, BA, DC),
+		BYTES_TO_WORDS_8(D2, 57, 5B, 29, 8A, CC, FC, 7A),
+		BYTES_TO_WORDS_8(5D, A6, 33, 4E, F4, 80, 22, EE),
+		BYTES_TO_WORDS_8(12, CD, 0F, 89, 03, 08, 7A, C4),
+		BYTES_TO_WORDS_8(6B, 4F, 60, 82, 8D, A9, 98, 4E),
+		BYTES_TO_WORDS_8(D2, BB, 5F, ED, 06, 8F, 59, 0D),
+		BYTES_TO_WORDS_8(84, EB, A1, A6, 91, EC, 46, CE)
+	},
+	{
+		BYTES_TO_WORDS_8(8D, 45, E6, 4B, 3F, 4F, 1E, 1F),
+		BYTES_TO_WORDS_8(47, 65, 5E, 59, 22, CC, 72, 5F),
+		BYTES_TO_WORDS_8(F1, 93, 1A, 27, 1E, 34, C5, 5B),
+		BYTES_TO_WORDS_8(63, F2, A5, 58, 5C, 15, 2E, C6),
+		BYTES_TO_WORDS_8(F4, 7F, BA, 58, 5A, 84, 6F, 5F),
+		BYTES_TO_WORDS_8(AD, A6, 36, 7E, DC, F7, E1, 67),
+		BYTES_TO_WORDS_8(04, 4D, AA, EE, 57, 76, 3A, D3),
+		BYTES_TO_WORDS_8(4E, 7E, 26, 18, 22, 23, 9F, FF)
+	},
+	{
+		BYTES_TO_WORDS_8(9F, 78, 53, 4A, 1F, F1, 69, D3),
+		BYTES_TO_WORDS_8(37, B4, 96, 36, B6, 6F, 87, C7),
+		BYTES_TO_WORDS_8(9A, A2, AB, 0B, A7, F0, E8, A0),
+		BYTES_TO_WORDS_8(14, E5, F6, 32, 5F, 8A, 31, A0),
+		BYTES_TO_WORDS_8(08, 5A, 77, 11, D1, 43, 4A, 5C),
+		BYTES_TO_WORDS_8(B1, EB, 2E, 36, 7C, 50, 8C, 41),
+		BYTES_TO_WORDS_8(AA, 25, A3, 09, 3F, 90, 08, FD),
+		BYTES_TO_WORDS_8(3A, BB, EE, F0, FC, B8, 20, F3)
+	},
+	{
+		BYTES_TO_WORDS_8(1D, 4C, 64, C7, 55, 02, 3F, E3),
+		BYTES_TO_WORDS_8(D8, 02, 90, BB, C3, EC, 30, 40),
+		BYTES_TO_WORDS_8(9F, 6F, 64, F4, 16, 69, 48, A4),
+		BYTES_TO_WORDS_8(FA, 44, 9C, 95, 0C, 7D, 67, 5E),
+		BYTES_TO_WORDS_8(44, 91, 8B, D8, D0, D7, E7, E2),
+		BYTES_TO_WORDS_8(1F, F9, 48, 62, 6F, A8, 93, 5D),
+		BYTES_TO_WORDS_8(EA, 3A, 99, 02, D5, 0B, 3D, E3),
+		BYTES_TO_WORDS_8(1E, D3, 00, 31, E6, 0C, 9F, 44)
+	},
+	{
+		BYTES_TO_WORDS_8(78, 26, CF, 73, 5A, 92, CD, 3F),
+		BYTES_TO_WORDS_8(C7, AF, D0, A6, 3B, 92, CA, 34),
+		BYTES_TO_WORDS_8(1F, 79, 67, 30, 1D, 09, 11, 90),
+		BYTES_TO_WORDS_8(E4, 41, 79, 5A, 74, 88, 56, 8C),
+		BYTES_TO_WORDS_8(00, 98, 33, FC, 80, 71, D3, 34),
+		BYTES_TO_WORDS_8(F4, 51, 5C, 59, 6B, 31, 44, 77),
+		BYTES_TO_WORDS_8(20, 64, 8C, E8, 93, B6, DD, F2),
+		BYTES_TO_WORDS_8(D2, 14, AD, 5B, B1, 48, 3A, FB)
+	},
+	{
+		BYTES_TO_WORDS_8(56, B2, AA, FD, 88, 15, DF, 52),
+		BYTES_TO_WORDS_8(4C, 35, 27, 31, 44, CD, C0, 68),
+		BYTES_TO_WORDS_8(53, F8, 91, A5, 71, 94, 84, 2A),
+		BYTES_TO_WORDS_8(92, CB, D0, 93, E9, 88, DA, E4),
+		BYTES_TO_WORDS_8(24, C6, 39, 16, 5D, A3, 1E, 6D),
+		BYTES_TO_WORDS_8(BA, 07, 37, 26, 36, 2A, FE, 60),
+		BYTES_TO_WORDS_8(51, BC, F3, D0, DE, 50, FC, 97),
+		BYTES_TO_WORDS_8(80, 2E, 06, 10, 15, 4D, FA, F7)
+	},
+	{
+		BYTES_TO_WORDS_8(8D, 16, 4C, 02, 13, A1, 29, C4),
+		BYTES_TO_WORDS_8(72, A2, EA, 3F, FB, 35, C9, B6),
+		BYTES_TO_WORDS_8(09, EC, 39, E6, 71, 60, 8A, B5),
+		BYTES_TO_WORDS_8(E7, 3D, C1, F9, 3A, 25, 59, 4B),
+		BYTES_TO_WORDS_8(55, 89, FB, FB, F2, 68, 2D, 6D),
+		BYTES_TO_WORDS_8(E2, 3F, 72, 50, 12, 4C, 06, F0),
+		BYTES_TO_WORDS_8(F5, 85, F1, 01, 20, 78, 5D, E8),
+		BYTES_TO_WORDS_8(93, 9C, A7, 7F, BF, 07, 03, AA)
+	},
+	{
+		BYTES_TO_WORDS_8(27, 65, 69, 5B, 66, A2, 75, 2E),
+		BYTES_TO_WORDS_8(9C, 16, 00, 5A, B0, 30, 25, 1A),
+		BYTES_TO_WORDS_8(42, FB, 86, 42, 80, C1, C4, 76),
+		BYTES_TO_WORDS_8(5B, 1D, 83, 8E, 94, 01, 5F, 82),
+		BYTES_TO_WORDS_8(39, 37, 70, EF, 1F, A1, F0, DB),
+		BYTES_TO_WORDS_8(6A, 10, 5B, CE, C4, 9B, 6F, 10),
+		BYTES_TO_WORDS_8(50, 11, 11, 24, 4F, 4C, 79, 61),
+		BYTES_TO_WORDS_8(17, 3A, 72, BC, FE, 72, 58, 43)
+	}
+};
+#elif uECC_FIXED_BASE_TEETH == 6
+#define COMB_SPACING 43
+static const uECC_word_t comb_table[(1 << 6) - 1][2 * NUM_ECC_WORDS] = {
+	{
+		BYTES_TO_WORDS_8(96, C2, 98, D8, 45, 39, A1, F4),
+		BYTES_TO_WORDS_8(A0, 33, EB, 2D, 81, 7D, 03, 77),
+		BYTES_TO_WORDS_8(F2, 40, A4, 63, E5, E6, BC, F8),
+		BYTES_TO_WORDS_8(47, 42, 2C, E1, F2, D1, 17, 6B),
+		BYTES_TO_WORDS_8(F5, 51, BF, 37, 68, 40, B6, CB),
+		BYTES_TO_WORDS_8(CE, 5E, 31, 6B, 57, 33, CE, 2B),
+		BYTES_TO_WORDS_8(16, 9E, 0F, 7C, 4A, EB, E7, 8E),
+		BYTES_TO_WORDS_8(9B, 7F, 1A, FE, E2, 42, E3, 4F)
+	},
+	{
+		BYTES_TO_WORDS_8(CD, E7, 49, B0, 88, 3F, 01, CD),
+		BYTES_TO_WORDS_8(00, DC, 7F, E5, 7A, 25, F9, E8),
+		BYTES_TO_WORDS_8(01, 93, 3A, FC, 69, 19, E7, 3B),
+		BYTES_TO_WORDS_8(37, F9, CF, 58, 6D, 25, 7F, 98),
+		BYTES_TO_WORDS_8(D6, 35, FA, 6E, BC, 4B, 25, B7),
+		BYTES_TO_WORDS_8(DB, FF, AA, 07, 52, 60, B4, 47),
+		BYTES_TO_WORDS_8(9E, E3, 07, 00, D6, EB, 60, E8),
+		BYTES_TO_WORDS_8(5C, 50, EC, 94, 56, 69, 92, 8E)
+	},
+	{
+		BYTES_TO_WORDS_8(B1, 3F, 1C, 5A, 7C, 16, DB, 59),
+		BYTES_TO_WORDS_8(B2, 8E, 31, BF, 2A, CE, B3, 98),
+		BYTES_TO_WORDS_8(A6, 2F, BC, D2, 1E, C4, F1, 2D),
+		BYTES_TO_WORDS_8(AF, B2, D1, 6E, 43, 2C, CC, EF),
+		BYTES_TO_WORDS_8(13, 55, B2, 97, F1, 07, FE, 17),
+		BYTES_TO_WORDS_8(89, A5, 34, 37, 33, 45, 82, 46),
+		BYTES_TO_WORDS_8(43, F5, 34, ED, 77, 4A, 38, A5),
+		BYTES_TO_WORDS_8(63, 38, 9F, 8D, 9C, 4F, 68, F3)
+	},
+	{
+		BYTES_TO_WORDS_8(2C, 0C, 78, BF, 83, 3E, C7, FD),
+		BYTES_TO_WORDS_8(17, 68, 66, 2D, 94, 67, DC, FF),
+		BYTES_TO_WORDS_8(93, 68, 43, 02, DD, 66, 4B, C1),
+		BYTES_TO_WORDS_8(0C, 65, 54, 0D, 67, 95, EC, 6E),
+		BYTES_TO_WORDS_8(32, CD, BF, ED, A1, C1, 9E, 08),
+		BYTES_TO_WORDS_8(89, FF, 07, 3A, 15, 66, AB, 79),
+		BYTES_TO_WORDS_8(05, 01, EA, 65, E0, 1D, 28, FC),
+		BYTES_TO_WORDS_8(C2, 32, 77, 99, 50, 53, BB, 14)
+	},
+	{
+		BYTES_TO_WORDS_8(8E, 18, 18, 73, 64, 02, C9, AE),
+		BYTES_TO_WORDS_8(99, 70, 16, CA, 28, EC, 0B, 41),
+		BYTES_TO_WORDS_8(2B, 20, 9C, 09, 2F, 4D, 66, BF),
+		BYTES_TO_WORDS_8(5C, 62, FA, 55, 34, CA, CC, 13),
+		BYTES_TO_WORDS_8(0C, 1C, 42, 05, 31, C2, 84, AA),
+		BYTES_TO_WORDS_8(71, 0D, DB, 6C, 21, 75, 64, 6B),
+		BYTES_TO_WORDS_8(5E, 6A, 21, FB, B1, 46, 04, E9),
+		BYTES_TO_WORDS_8(3D, 89, 46, AF, A5, A5, 5B, 4B)
+	},
+	{
+		BYTES_TO_WORDS_8(DB, C5, 62, 48, 08, FA, A2, AC),
+		BYTES_TO_WORDS_8(8A, 7F, 71, A1, 22, C2, FF, DD),
+		BYTES_TO_WORDS_8(D2, 9F, E0, E4, 14, 9A, 83, AB),
+		BYTES_TO_WORDS_8(F5, 30, 03, 98, 78, 90, 6A, F8),
+		BYTES_TO_WORDS_8(CC, 7D, DD, C1, 4C, F2, 90, 68),
+		BYTES_TO_WORDS_8(98, FD, 6E, EA, FA, CC, 5D, F7),
+		BYTES_TO_WORDS_8(3B, 09, 9A, FF, B8, 12, 26, BA),
+		BYTES_TO_WORDS_8(3C, 65, 68, 25, 0C, 7D, 34, 20)
+	},
+	{
+		BYTES_TO_WORDS_8(78, 1C, DB, CB, 09, 28, B2, D3),
+		BYTES_TO_WORDS_8(A4, CD, F6, 30, EB, C8, 91, 55),
+		BYTES_TO_WORDS_8(8B, 0F, E8, BF, 40, 87, E2, B6),
+		BYTES_TO_WORDS_8(E7, E7, E7, 40, 2A, 34, 74, 0F),
+		BYTES_TO_WORDS_8(F2, 51, 1C, 35, 87, 8E, 96, D2),
+		BYTES_TO_WORDS_8(5E, 7B, E1, F5, 81, C5, C5, 65),
+		BYTES_TO_WORDS_8(2E, 4E, 99, 9D, 2A, F0, 58, 6F),
+		BYTES_TO_WORDS_8(07, EC, C1, F5, 00, 0B, 1C, 53)
+	},
+	{
+		BYTES_TO_WORDS_8(5E, 66, 6B, 1A, 21, 21, 04, EB),
+		BYTES_TO_WORDS_8(3A, 80, F6, A7, 9E, 77, 2F, 80),
+		BYTES_TO_WORDS_8(C3, 04, 08, 3C, 2A, 1F, 50, 47),
+		BYTES_TO_WORDS_8(D4, A1, 45, 49, 9B, 91, 63, A2),
+		BYTES_TO_WORDS_8(FB, DC, BC, 30, 00, 04, E4, 9E),
+		BYTES_TO_WORDS_8(E2, EF, 00, 4C, DF, 83, 3F, AC),
+		BYTES_TO_WORDS_8(C5, 60, 0D, E6, 9D, 3C, 9D, 2E),
+		BYTES_TO_WORDS_8(FC, 20, ED, 2A, BD, 00, 32, 87)
+	},
+	{
+		BYTES_TO_WORDS_8(51, AA, 21, 8B, 7D, C4, 52, 2B),
+		BYTES_TO_WORDS_8(0D, 87, 7E, 5A, 29, 36, 50, 0F),
+		BYTES_TO_WORDS_8(27, 51, B4, 88, 14, 28, A9, BA),
+		BYTES_TO_WORDS_8(50, E0, 02, C4, 1E, 45, D6, 27),
+		BYTES_TO_WORDS_8(2D, 43, 67, 55, 14, EC, 96, 5C),
+		BYTES_TO_WORDS_8(C7, 50, 41, 0F, 29, 98, EB, CD),
+		BYTES_TO_WORDS_8(66, F5, EE, CD, 0C, 74, 91, 5D),
+		BYTES_TO_WORDS_8(83, E5, E9, 1B, 5E, FA, 58, 2A)
+	},
+	{
+		BYTES_TO_WORDS_8(F6, C0, 88, 57, FF, 2D, 14, D8),
+		BYTES_TO_WORDS_8(25, DE, 7F, 24, 29, 52, BF, 89),
+		BYTES_TO_WORDS_8(0F, 28, E2, 14, DB, 1D, 97, 5C),
+		BYTES_TO_WORDS_8(3F, 4E, 90, 09, 91, 7E, 5B, 78),
+		BYTES_TO_WORDS_8(0B, 6F, 7E, 2E, 19, 45, 5E, 44),
+		BYTES_TO_WORDS_8(DD, 93, E2, 4C, 0E, 44, 89, 87),
+		BYTES_TO_WORDS_8(30, BE, 97, C7, 57, 4F, B8, 96),
+		BYTES_TO_WORDS_8(2D, A3, 3E, FA, 9D, 05, 44, 6B)
+	},
+	{
+		BYTES_TO_WORDS_8(79, A9, 95, 21, 50, C5, B7, 73),
+		BYTES_TO_WORDS_8(13, 58, DD, B8, 74, D4, 7E, 2D),
+		BYTES_TO_WORDS_8(AC, E9, 04, E1, D2, EC, B9, C0),
+		BYTES_TO_WORDS_8(D8, 0E, BD, A2, 75, D9, 90, DC),
+		BYTES_TO_WORDS_8(2E, EB, D6, 4D, 03, 52, B5, 9F),
+		BYTES_TO_WORDS_8(E8, FD, 1D, C0, BB, 54, D5, 50),
+		BYTES_TO_WORDS_8(30, 7A, 97, F0, 77, 32, FD, 4C),
+		BYTES_TO_WORDS_8(C4, 74, 53, 81, 32, E2, 7C, C8)
+	},
+	{
+		BYTES_TO_WORDS_8(A9, 3C, 9A, CF, B6, 41, B5, E4),
+		BYTES_TO_WORDS_8(2F, 9B, B4, 08, 87, 05, 65, 1C),
+		BYTES_TO_WORDS_8(1E, 64, 52, F5, B3, 91, 5F, B9),
+		BYTES_TO_WORDS_8(77, 12, 30, 5C, AC, 23, DC, BD),
+		BYTES_TO_WORDS_8(43, BA, DA, 04, 00, 07, 9D, 51),
+		BYTES_TO_WORDS_8(A2, CF, 50, 84, C3, DC, 03, C0),
+		BYTES_TO_WORDS_8(DE, EF, 48, 4E, F5, C8, A1, 73),
+		BYTES_TO_WORDS_8(61, F7, 04, 5B, 42, A9, 0C, 7D)
+	},
+	{
+		BYTES_TO_WORDS_8(6D, 40, 03, 17, 5B, C3, 4D, CB),
+		BYTES_TO_WORDS_8(4C, C5, DA, 75, C9, AF, D3, 4F),
+		BYTES_TO_WORDS_8(78, 28, F0, 29, EB, 21, 23, 11),
+		BYTES_TO_WORDS_8(5F, 22, 6B, AD, 2F, 8D, B1, AF),
+		BYTES_TO_WORDS_8(67, 6A, 77, F1, 73, 82, F5, DD),
+		BYTES_TO_WORDS_8(2F, 6C, B9, F6, 55, 97, 88, 96),
+		BYTES_TO_WORDS_8(FB, 8F, 20, 22, 63, D6, A8, 31),
+		BYTES_TO_WORDS_8(77, 48, CA, FC, 10, 1C, D8, 5E)
+	},
+	{
+		BYTES_TO_WORDS_8(C4, A3, 34, E8, 34, 1F, 0E, FF),
+		BYTES_TO_WORDS_8(36, B2, 4A, 1C, AE, B6, 59, 0D),
+		BYTES_TO_WORDS_8(1B, 21, 5A, 01, 4A, 19, EB, 10),
+		BYTES_TO_WORDS_8(C5, DD, 92, 38, E0, 13, 6E, ED),
+		BYTES_TO_WORDS_8(8D, 67, 3F, FB, 04, DF, 88, AC),
+		BYTES_TO_WORDS_8(A9, 26, 40, 54, 44, BF, 0F, 6F),
+		BYTES_TO_WORDS_8(BA, EC, 9C, 61, 7A, CD, E8, CD),
+		BYTES_TO_WORDS_8(CC, A8, D9, 80, E5, 22, F3, 02)
+	},
+	{
+		BYTES_TO_WORDS_8(40, AF, 6A, 33, 1B, 1E, C6, 2D),
+		BYTES_TO_WORDS_8(B7, F5, 51, 42, BD, 87, 7E, 89),
+		BYTES_TO_WORDS_8(70, B3, 11, 65, 23, 20, B3, 2F),
+		BYTES_TO_WORDS_8(99, F4, 41, 23, CF, A9, 0F, 46),
+		BYTES_TO_WORDS_8(A7, 01, AF, CB, 79, 3B, E6, 03),
+		BYTES_TO_WORDS_8(34, 74, 15, 44, 3F, 12, 7E, 93),
+		BYTES_TO_WORDS_8(1A, 4A, 9E, 80, 6E, 22, 59, 9D),
+		BYTES_TO_WORDS_8(62, 5E, 77, 41, 3A, F6, D6, 18)
+	},
+	{
+		BYTES_TO_WORDS_8(DF, 52, AA, A9, E4, F4, D5, 3C),
+		BYTES_TO_WORDS_8(7F, 62, 2A, B4, B1, 52, C4, 18),
+		BYTES_TO_WORDS_8(E6, EC, 91, D9, 89, 41, BC, 6D),
+		BYTES_TO_WORDS_8(F7, 8B, 60, 7F, C9, 11, A5, 45),
+		BYTES_TO_WORDS_8(6C, C1, 5E, 12, 12, BD, 52, 7B),
+		BYTES_TO_WORDS_8(CE, 55, 29, D2, 27, 9B, 91, 5A),
+		BYTES_TO_WORDS_8(D2, 5A, 62, CB, 7F, 33, E3, 3F),
+		BYTES_TO_WORDS_8(6D, 9B, EA, 73, C7, 0E, BE, 73)
+	},
+	{
+		BYTES_TO_WORDS_8(EA, 76, 64, 01, D0, B6, E4, C6),
+		BYTES_TO_WORDS_8(10, 25, EC, D4, E5, A7, B9, 71),
+		BYTES_TO_WORDS_8(D2, 90, E4, CB, 1E, B7, 75, 19),
+		BYTES_TO_WORDS_8(25, CD, 2A, B5, 2F, 47, 6B, DF),
+		BYTES_TO_WORDS_8(EB, 55, 40, 78, 16, 87, 73, F1),
+		BYTES_TO_WORDS_8(9E, 39, 7D, B8, B3, B0, C7, CC),
+		BYTES_TO_WORDS_8(19, 11, B5, 1B, 37, 13, 9A, 3C),
+		BYTES_TO_WORDS_8(93, D5, 8F, A8, E1, 39, 26, B4)
+	},
+	{
+		BYTES_TO_WORDS_8(0B, C2, 19, C2, 54, 8D, A3, 86),
+		BYTES_TO_WORDS_8(33, 47, 0A, B5, CA, D2, CD, AF),
+		BYTES_TO_WORDS_8(38, 66, 09, 72, 97, 87, CF, F4),
+		BYTES_TO_WORDS_8(94, 0E, CE, 24, A2, CA, 49, D9),
+		BYTES_TO_WORDS_8(13, AE, F9, 96, AE, 64, 86, 67),
+		BYTES_TO_WORDS_8(46, DE, 84, C9, A9, 5B, EF, 00),
+		BYTES_TO_WORDS_8(67, 95, 54, 8D, 7F, BC, 2A, 62),
+		BYTES_TO_WORDS_8(4D, 92, DB, 57, 00, D5, 3E, 67)
+	},
+	{
+		BYTES_TO_WORDS_8(97, D6, B4, 20, 06, 42, E9, 41),
+		BYTES_TO_WORDS_8(F9, 0D, FA, 29, D9, D0, 0F, A1),
+		BYTES_TO_WORDS_8(38, 2C, 02, 76, A7, B0, 1E, F1),
+		BYTES_TO_WORDS_8(63, 1C, 62, A5, DC, 7D, CB, FF),
+		BYTES_TO_WORDS_8(5A, 96, 27, 09, 1B, 7B, E3, 24),
+		BYTES_TO_WORDS_8(9E, 19, 2C, BD, 02, C1, 9F, 8D),
+		BYTES_TO_WORDS_8(85, 3F, 7F, 90, 5E, E7, 2D, 86),
+		BYTES_TO_WORDS_8(8E, 77, 9C, 5A, 29, 51, 98, D3)
+	},
+	{
+		BYTES_TO_WORDS_8(51, C4, 6B, B5, 48, 37, D6, 48),
+		BYTES_TO_WORDS_8(0A, 44, 39, A9, 81, DE, 44, 05),
+		BYTES_TO_WORDS_8(9C, C1, 4E, 66, 0B, EB, 24, DA),
+		BYTES_TO_WORDS_8(F6, 2B, F4, 41, 62, E5, B6, 4F),
+		BYTES_TO_WORDS_8(6B, 5D, BB, 66, 0E, C8, B2, 21),
+		BYTES_TO_WORDS_8(1B, D4, 5B, D2, 24, 39, 12, A4),
+		BYTES_TO_WORDS_8(18, D4, E2, BC, F2, F5, 95, 6F),
+		BYTES_TO_WORDS_8(D8, 91, 6D, 4D, 76, 27, 23, A9)
+	},
+	{
+		BYTES_TO_WORDS_8(CC, B8, 19, F1, E7, 08, 6A, 54),
+		BYTES_TO_WORDS_8(6A, 69, FC, 8A, 23, D5, B7, 03),
+		BYTES_TO_WORDS_8(B4, 70, 9F, 45, 32, 61, 89, 0A),
+		BYTES_TO_WORDS_8(16, 91, 6A, A8, 57, 62, A4, 57),
+		BYTES_TO_WORDS_8(65, 4C, 31, BB, EF, 6F, A5, FA),
+		BYTES_TO_WORDS_8(6D, 5C, 79, 74, 40, 1F, E6, F4),
+		BYTES_TO_WORDS_8(D6, 50, 78, 43, 52, 56, 3C, 1A),
+		BYTES_TO_WORDS_8(11, EC, 21, 66, 7D, 12, 4B, 7C)
+	},
+	{
+		BYTES_TO_WORDS_8(35, FA, 3C, E8, 26, 5E, D2, 6D),
+		BYTES_TO_WORDS_8(DC, BD, F3, 1F, A0, 4D, E4, 61),
+		BYTES_TO_WORDS_8(FA, 33, 17, 12, 02, 7B, B6, B7),
+		BYTES_TO_WORDS_8(CA, 98, D7, FC, 0D, F6, 48, 7C),
+		BYTES_TO_WORDS_8(54, 51, 0F, 09, 4A, 23, 4D, 24),
+		BYTES_TO_WORDS_8(BB, 33, AE, 8C, FB, F2, B7, 93),
+		BYTES_TO_WORDS_8(16, 15, 6D, 42, F6, F2, 8B, 15),
+		BYTES_TO_WORDS_8(6E, E8, 01, A8, A8, 47, A9, A8)
+	},
+	{
+		BYTES_TO_WORDS_8(5E, 81, C8, 56, 07, 03, 1E, F4),
+		BYTES_TO_WORDS_8(F1, A2, 37, 7D, E3, 47, F6, BA),
+		BYTES_TO_WORDS_8(F5, FB, FA, FE, 36, EB, 91, 77),
+		BYTES_TO_WORDS_8(06, F6, B7, 35, FB, 62, 82, 15),
+		BYTES_TO_WORDS_8(E5, E9, DC, 32, 55, 22, C3, F6),
+		BYTES_TO_WORDS_8(80, 47, 1B, 36, CE, D4, 7C, 6C),
+		BYTES_TO_WORDS_8(8F, 28, 85, 3F, 70, 5E, BE, E5),
+		BYTES_TO_WORDS_8(4A, 62, 8E, C9, A3, 1A, 28, 4C)
+	},
+	{
+		BYTES_TO_WORDS_8(E5, 8A, D5, 7F, 9E, 74, 7F, 9D),
+		BYTES_TO_WORDS_8(A2, 57, EA, 37, 63, A2, 8B, C7),
+		BYTES_TO_WORDS_8(B7, B5, 5A, 4F, 27, 51, C0, B5),
+		BYTES_TO_WORDS_8(3B, 64, 2D, 5F, 4D, F5, D3, 6F),
+		BYTES_TO_WORDS_8(CE, B8, 16, 21, 11, E3, 28, 34),
+		BYTES_TO_WORDS_8(87, 89, B2, 71, 24, 1D, 2D, C5),
+		BYTES_TO_WORDS_8(1F, 42, 99, 82, E9, 0B, F7, 87),
+		BYTES_TO_WORDS_8(98, 97, F4, 64, 98, D0, 5F, 0A)
+	},
+	{
+		BYTES_TO_WORDS_8(EF, 3D, 6A, 4D, DD, 11, 29, 5B),
+		BYTES_TO_WORDS_8(F1, 08, 60, B9, 7C, D0, ED, 4B),
+		BYTES_TO_WORDS_8(64, 7D, 6E, E3, 6F, 8A, 74, EE),
+		BYTES_TO_WORDS_8(F4, 5C, BF, 4B, 34, 99, C4, BF),
+		BYTES_TO_WORDS_8(0F, 75, 74, 8E, 2D, F6, C6, 55),
+		BYTES_TO_WORDS_8(02, 99, 91, 48, 87, 9F, 63, 22),
+		BYTES_TO_WORDS_8(8F, 24, 8A, 95, 94, AA, 01, FA),
+		BYTES_TO_WORDS_8(40, AA, 51, ED, 8A, AE, 43, 27)
+	},
+	{
+		BYTES_TO_WORDS_8(C0, CB, 6C, E7, CB, 69, EA, 75),
+		BYTES_TO_WORDS_8(B7, DE, 62, A7, 51, 60, 73, C9),
+		BYTES_TO_WORDS_8(4C, FF, 2B, AF, C6, D4, 20, A7),
+		BYTES_TO_WORDS_8(BA, 6D, 6D, BE, 10, 7B, 4C, 8E),
+		BYTES_TO_WORDS_8(33, 84, 12, 2F, FE, 0E, 5C, AF),
+		BYTES_TO_WORDS_8(EC, 85, FE, A1, 1F, BF, 4C, 83),
+		BYTES_TO_WORDS_8(18, F0, 85, 26, A6, C5, 21, D3),
+		BYTES_TO_WORDS_8(40, 53, 7A, 71, F6, 9C, B0, B5)
+	},
+	{
+		BYTES_TO_WORDS_8(15, 78, EB, 86, 21, A8, DD, 9C),
+		BYTES_TO_WORDS_8(65, 32, 41, CE, 12, 36, 00, 8C),
+		BYTES_TO_WORDS_8(F5, 77, B5, 91, AB, 1F, CE, 8B),
+		BYTES_TO_WORDS_8(0C, 73, 8F, 48, FF, 29, 3F, 0F),
+		BYTES_TO_WORDS_8(55, 0D, 96, E6, 63, 80, B0, EB),
+		BYTES_TO_WORDS_8(67, F4, CB, AE, E2, 99, 96, 1A),
+		BYTES_TO_WORDS_8(1B, 76, E5, 4C, A4, 64, 15, 6B),
+		BYTES_TO_WORDS_8(96, 29, 38, 81, A5, 0E, F0, 08)
+	},
+	{
+		BYTES_TO_WORDS_8(A5, 8E, BF, 96, D2, CD, 10, 6C),
+		BYTES_TO_WORDS_8(8F, 86, CD, E8, 8A, 48, 8C, E2),
+		BYTES_TO_WORDS_8(00, 2D, 44, 46, C3, 26, 92, BA),
+		BYTES_TO_WORDS_8(4B, 86, 1F, FA, ED, CA, 25, 91),
+		BYTES_TO_WORDS_8(AF, B4, 21, 2E, 6E, D6, 3B, F3),
+		BYTES_TO_WORDS_8(8C, E5, DB, 68, 37, 55, DC, 12),
+		BYTES_TO_WORDS_8(44, 30, 35, E5, 23, 51, B8, D9),
+		BYTES_TO_WORDS_8(60, 6B, BC, 07, DE, 5B, 92, F4)
+	},
+	{
+		BYTES_TO_WORDS_8(21, 4A, 51, 70, 39, FF, 17, 0D),
+		BYTES_TO_WORDS_8(EE, 80, DD, DA, BA, B5, A7, D2),
+		BYTES_TO_WORDS_8(C4, C8, 26, 81, C3, 33, 1E, 94),
+		BYTES_TO_WORDS_8(DE, C1, 57, 1D, D0, 56, E1, B9),
+		BYTES_TO_WORDS_8(AD, 05, 81, EA, 0D, 50, 0D, 22),
+		BYTES_TO_WORDS_8(AE, F3, 02, 02, 62, A4, 2A, 6A),
+		BYTES_TO_WORDS_8(56, 63, C9, 3D, AB, 56, 00, 45),
+		BYTES_TO_WORDS_8(C3, 42, 21, 45, AA, B6, 6A, 50)
+	},
+	{
+		BYTES_TO_WORDS_8(99, D5, 20, 1B, 29, 10, CB, E0),
+		BYTES_TO_WORDS_8(A0, FB, A5, 10, 3D, D8, 1E, 7B),
+		BYTES_TO_WORDS_8(13, 77, 00, 04, 2B, B3, 5F, 7D),
+		BYTES_TO_WORDS_8(39, 26, C8, 79, 90, B5, BA, 93),
+		BYTES_TO_WORDS_8(9D, 7D, B9, 49, A6, A5, 7F, 97),
+		BYTES_TO_WORDS_8(4A, 25, 51, 35, 33, 23, 59, A3),
+		BYTES_TO_WORDS_8(EB, A3, F7, A9, 88, 73, 27, 8F),
+		BYTES_TO_WORDS_8(2C, 6E, 02, E3, 35, A9, AB, 36)
+	},
+	{
+		BYTES_TO_WORDS_8(CD, 31, 51, C0, 5B, 73, 97, F1),
+		BYTES_TO_WORDS_8(67, B5, BE, 22, 68, 07, 65, 05),
+		BYTES_TO_WORDS_8(1F, 5B, F5, F7, 89, B1, F2, DB),
+		BYTES_TO_WORDS_8(14, 26, 2C, 13, 82, 4C, 14, AA),
+		BYTES_TO_WORDS_8(51, 22, 82, B3, 14, BE, 1C, F4),
+		BYTES_TO_WORDS_8(BE, AF, D0, FF, B2, 72, CE, B1),
+		BYTES_TO_WORDS_8(FA, 43, 47, 84, 18, 4D, A1, 01),
+		BYTES_TO_WORDS_8(B8, 39, 37, 92, E3, 9F, D8, C1)
+	},
+	{
+		BYTES_TO_WORDS_8(7D, 84, 79, 0B, F1, 79, F6, F0),
+		BYTES_TO_WORDS_8(E6, 9B, B1, 6B, B6, A8, 19, 37),
+		BYTES_TO_WORDS_8(D5, 43, 7F, DC, 3D, 6C, DB, 2D),
+		BYTES_TO_WORDS_8(E2, 82, 09, DA, 3A, 04, 00, 28),
+		BYTES_TO_WORDS_8(DA, 9E, 8D, 90, 83, 00, 5B, FE),
+		BYTES_TO_WORDS_8(E9, 3A, 51, B8, DB, 58, 70, A8),
+		BYTES_TO_WORDS_8(3B, DC, A4, 84, 65, 79, C0, B6),
+		BYTES_TO_WORDS_8(09, 29, E8, 67, 46, 17, 99, 0F)
+	},
+	{
+		BYTES_TO_WORDS_8(80, 5B, 3F, 5F, 5C, 6A, 41, 12),
+		BYTES_TO_WORDS_8(22, 24, 52, DA, DB, 03, E9, 58),
+		BYTES_TO_WORDS_8(7E, 86, 91, 42, F1, 80, CC, 18),
+		BYTES_TO_WORDS_8(2B, 2C, 15, 7A, F8, 5C, 03, B2),
+		BYTES_TO_WORDS_8(DE, 0E, C8, 95, 91, 56, 12, 71),
+		BYTES_TO_WORDS_8(B0, C5, 97, AF, 68, 25, E0, BF),
+		BYTES_TO_WORDS_8(93, E4, 14, 8A, C5, 1D, 3E, 60),
+		BYTES_TO_WORDS_8(DE, 80, 96, 74, 9C, 35, 2F, F1)
+	},
+	{
+		BYTES_TO_WORDS_8(9D, B4, A2, 6A, BA, B0, AA, 1C),
+		BYTES_TO_WORDS_8(02, C5, 7F, 6F, 68, A7, 75, 6A),
+		BYTES_TO_WORDS_8(0F, 12, EA, 57, A8, A5, 5E, 6A),
+		BYTES_TO_WORDS_8(96, DF, 6B, DB, F9, D5, 8C, 99),
+		BYTES_TO_WORDS_8(A9, 84, 71, 46, 4C, BA, D7, D2),
+		BYTES_TO_WORDS_8(23, 37, C0, 25, 54, 8E, 17, BE),
+		BYTES_TO_WORDS_8(F3, 9E, 38, BC, 07, 17, FC, 6B),
+		BYTES_TO_WORDS_8(B3, 9F, 7D, 7B, A0, A8, 56, 32)
+	},
+	{
+		BYTES_TO_WORDS_8(0C, 7B, A7, FE, 1B, 9D, 42, 40),
+		BYTES_TO_WORDS_8(31, 9A, 5E, 59, DC, A4, 51, 46),
+		BYTES_TO_WORDS_8(3A, 69, 12, E7, B1, AA, 00, 89),
+		BYTES_TO_WORDS_8(2D, 61, BF, 84, 67, 77, EA, 90),
+		BYTES_TO_WORDS_8(B6, F2, 02, 0D, 25, 04, D1, BD),
+		BYTES_TO_WORDS_8(4F, 59, 4D, FB, CC, 3B, 58, F5),
+		BYTES_TO_WORDS_8(A1, B6, A7, 5B, 62, 44, 75, 75),
+		BYTES_TO_WORDS_8(F4, 86, 1E, 10, D3, 21, A3, D1)
+	},
+	{
+		BYTES_TO_WORDS_8(DB, B3, C0, 5A, B2, 10, 2F, 7A),
+		BYTES_TO_WORDS_8(28, 89, B9, F0, A0, FF, DE, E6),
+		BYTES_TO_WORDS_8(1A, B0, B0, E6, 9B, 93, B2, B4),
+		BYTES_TO_WORDS_8(A8, 2C, 3F, 0A, 52, 1D, 3E, A0),
+		BYTES_TO_WORDS_8(24, AD, BE, 2C, 31, 95, 77, FC),
+		BYTES_TO_WORDS_8(F9, A3, 0F, D3, 08, 29, 36, E8),
+		BYTES_TO_WORDS_8(BB, 00, 3B, F2, F4, D6, 29, 6F),
+		BYTES_TO_WORDS_8(0A, 2E, B8, EB, 2F, D2, 1A, EA)
+	},
+	{
+		BYTES_TO_WORDS_8(69, A0, 2D, E6, 6C, B2, 90, 68),
+		BYTES_TO_WORDS_8(65, 62, 58, 7C, 19, 23, 70, A5),
+		BYTES_TO_WORDS_8(AB, 72, 56, 86, BF, 19, 4E, E6),
+		BYTES_TO_WORDS_8(93, 98, 7D, A0, F5, 03, 65, A6),
+		BYTES_TO_WORDS_8(43, 47, FE, 21, C0, B7, DE, E4),
+		BYTES_TO_WORDS_8(BE, 00, 71, 7D, 7D, 84, AE, 3B),
+		BYTES_TO_WORDS_8(29, 1D, 7B, E1, A7, FC, 69, 17),
+		BYTES_TO_WORDS_8(60, FC, 0A, 32, EC, 60, BA, AD)
+	},
+	{
+		BYTES_TO_WORDS_8(19, 6E, 80, 89, 1C, 4E, 81, 74),
+		BYTES_TO_WORDS_8(DE, 85, EC, F9, 8D, FC, 35, 91),
+		BYTES_TO_WORDS_8(5B, D2, AF, 09, A6, 60, E6, 0E),
+		BYTES_TO_WORDS_8(84, A2, 40, 67, B7, E3, 3D, 94),
+		BYTES_TO_WORDS_8(D9, 27, 22, 62, 7F, 32, A0, DB),
+		BYTES_TO_WORDS_8(E8, 86, C4, D4, D6, C6, 24, A5),
+		BYTES_TO_WORDS_8(1A, 58, 34, 71, 79, B7, 7F, 21),
+		BYTES_TO_WORDS_8(7E, 4A, 25, E4, 5F, B6, A3, AF)
+	},
+	{
+		BYTES_TO_WORDS_8(58, 81, E4, C4, 14, D6, C9, A3),
+		BYTES_TO_WORDS_8(08, C5, 8F, AE, 98, 4A, 6B, B2),
+		BYTES_TO_WORDS_8(18, 8E, B6, 38, E0, 8B, EF, 44),
+		BYTES_TO_WORDS_8(CD, 1F, 27, DB, 96, F5, 9C, BE),
+		BYTES_TO_WORDS_8(AD, 95, 6F, 8E, 3E, 65, 7B, 73),
+		BYTES_TO_WORDS_8(0A, 4D, 9E, 9B, FF, E6, DB, 73),
+		BYTES_TO_WORDS_8(59, 9F, 13, A4, 8C, 2A, 77, 4B),
+		BYTES_TO_WORDS_8(8A, 7E, C6, 66, E5, 35, F3, A1)
+	},
+	{
+		BYTES_TO_WORDS_8(5B, 71, 00, 2D, EE, A3, BF, 0A),
+		BYTES_TO_WORDS_8(47, 7B, 29, C8, C1, 5D, F6, F3),
+		BYTES_TO_WORDS_8(85, 9E, 66, 00, 59, B6, 99, 41),
+		BYTES_TO_WORDS_8(67, 95, C0, 23, 7F, DF, 88, 75),
+		BYTES_TO_WORDS_8(27, 32, 8D, 86, FA, 62, DF, AB),
+		BYTES_TO_WORDS_8(FC, A8, 99, 80, 34, 4D, 84, A0),
+		BYTES_TO_WORDS_8(72, BC, AB, 3B, C0, B9, 61, 33),
+		BYTES_TO_WORDS_8(3B, F0, 5B, 6D, A4, 57, 03, BB)
+	},
+	{
+		BYTES_TO_WORDS_8(52, F1, 7C, F7, FB, 61, B1, C0),
+		BYTES_TO_WORDS_8(43, 00, E3, 8C, ED, 4F, 3C, 24),
+		BYTES_TO_WORDS_8(DF, 20, 0E, 05, D0, A2, B4, B1),
+		BYTES_TO_WORDS_8(AE, 99, 49, C3, 86, A2, 61, 5A),
+		BYTES_TO_WORDS_8(B7, 4E, 21, 70, 68, AF, 7B, 8C),
+		BYTES_TO_WORDS_8(FE, 61, C2, F2, 7D, CA, 5B, 97),
+		BYTES_TO_WORDS_8(E8, 1A, D9, 1E, 31, DF, C6, 03),
+		BYTES_TO_WORDS_8(38, 0D, 38, A1, AD, AA, CF, E8)
+	},
+	{
+		BYTES_TO_WORDS_8(3C, 61, 6F, 01, 4D, C8, BC, A6),
+		BYTES_TO_WORDS_8(56, 4E, EC, C2, 38, E0, 5C, AE),
+		BYTES_TO_WORDS_8(B4, 76, BE, F8, 35, F0, 80, AD),
+		BYTES_TO_WORDS_8(D4, 2D, 64, 84, 5C, 6C, 45, 00),
+		BYTES_TO_WORDS_8(C8, 48, 36, DE, 9F, 07, F7, 0E),
+		BYTES_TO_WORDS_8(70, A1, D0, 68, AB, B3, F0, 7B),
+		BYTES_TO_WORDS_8(E3, 84, C6, 56, B8, 96, 5C, A8),
+		BYTES_TO_WORDS_8(88, 5C, D6, 91, F2, B0, 39, FD)
+	},
+	{
+		BYTES_TO_WORDS_8(DD, 28, 6D, 96, 78, 31, 9E, C7),
+		BYTES_TO_WORDS_8(C1, A2, F8, 89, 86, 86, BA, 67),
+		BYTES_TO_WORDS_8(42, 8D, CF, 4A, 6D, 9C, 1F, AF),
+		BYTES_TO_WORDS_8(7D, 7F, 84, E0, 73, 42, 2B, 2D),
+		BYTES_TO_WORDS_8(EC, 0C, 13, 69, 90, 1A, 9E, 1D),
+		BYTES_TO_WORDS_8(B5, E7, 83, 93, FD, 10, CB, 95),
+		BYTES_TO_WORDS_8(AE, 71, CC, 44, 26, 8A, 43, 73),
+		BYTES_TO_WORDS_8(49, EA, E4, 1E, 10, EB, EA, 37)
+	},
+	{
+		BYTES_TO_WORDS_8(7B, 76, 0C, 62, 54, 5B, 67, 2A),
+		BYTES_TO_WORDS_8(8E, 59, E6, 5A, 08, 5F, 23, F1),
+		BYTES_TO_WORDS_8(9B, 5E, A3, 48, CD, A1, F6, 3C),
+		BYTES_TO_WORDS_8(F8, B5, A1, D8, 3E, 11, 1A, F1),
+		BYTES_TO_WORDS_8(87, A8, 42, 17, 5D, 98, 01, A4),
+		BYTES_TO_WORDS_8(9B, 3D, A7, B6, 07, BD, 83, 3F),
+		BYTES_TO_WORDS_8(67, 60, 73, 82, A0, 07, 73, 3C),
+		BYTES_TO_WORDS_8(B6, FB, 12, 1F, 6D, A6, A1, 64)
+	},
+	{
+		BYTES_TO_WORDS_8(DE, 37, 4A, D8, CB, B5, 12, 1C),
+		BYTES_TO_WORDS_8(1A, EA, B1, C7, B4, 6D, D6, 56),
+		BYTES_TO_WORDS_8(9A, 1E, E3, 2C, 20, E4, 2B, 85),
+		BYTES_TO_WORDS_8(48, AF, 0F, E4, 2D, 9C, BE, 17),
+		BYTES_TO_WORDS_8(97, 87, CC, 38, CB, 3C, 5B, 73),
+		BYTES_TO_WORDS_8(3E, 09, B1, 34, 80, 9D, 8D, 1F),
+		BYTES_TO_WORDS_8(C0, 81, 5B, E7, 86, 6E, CC, D8),
+		BYTES_TO_WORDS_8(97, E6, DB, 3F, 94, BF, 14, 69)
+	},
+	{
+		BYTES_TO_WORDS_8(81, 39, CF, 0C, C9, 18, 26, 42),
+		BYTES_TO_WORDS_8(36, 39, AB, 8D, 10, 96, 5F, 7F),
+		BYTES_TO_WORDS_8(28, 6A, 0A, 8E, 50, B7, 4A, CA),
+		BYTES_TO_WORDS_8(33, B1, BA, D5, FE, E2, 66, 82),
+		BYTES_TO_WORDS_8(F6, 00, 55, AB, 5B, 54, A7, FA),
+		BYTES_TO_WORDS_8(86, 4D, 99, 5D, EB, DA, 1E, A9),
+		BYTES_TO_WORDS_8(2D, 46, FB, 67, 4B, 19, 5B, 0A),
+		BYTES_TO_WORDS_8(CE, 78, 71, 28, 68, FD, 9C, 08)
+	},
+	{
+		BYTES_TO_WORDS_8(35, 6F, B1, 00, 33, 4D, B4, 54),
+		BYTES_TO_WORDS_8(07, 57, 2D, 00, F3, 8E, 98, 59),
+		BYTES_TO_WORDS_8(94, 4F, 49, D0, EB, E1, 6F, 25),
+		BYTES_TO_WORDS_8(E4, 0D, 71, 7F, 69, 41, F8, AE),
+		BYTES_TO_WORDS_8(04, 96, D4, 8B, 1F, FB, 38, CA),
+		BYTES_TO_WORDS_8(5C, B1, A0, BF, AE, DA, C9, AE),
+		BYTES_TO_WORDS_8(DD, F6, 2C, 64, 5E, 36, 51, 15),
+		BYTES_TO_WORDS_8(FF, 8F, 0E, 16, FA, B0, B8, 75)
+	},
+	{
+		BYTES_TO_WORDS_8(35, EA, FE, 01, 27, 60, 46, B2),
+		BYTES_TO_WORDS_8(F1, 61, 7C, 31, 80, F5, 17, EA),
+		BYTES_TO_WORDS_8(EB, AC, 6A, 78, BA, EA, 71, 8D),
+		BYTES_TO_WORDS_8(AB, 7D, C4, 1C, 4A, 45, E7, 7D),
+		BYTES_TO_WORDS_8(66, 12, 1B, FF, 62, 9D, B6, 10),
+		BYTES_TO_WORDS_8(9C, 07, AB, B9, 9B, C5, 2C, E2),
+		BYTES_TO_WORDS_8(41, D4, B2, 42, 3F, E4, 57, 9A),
+		BYTES_TO_WORDS_8(85, 5F, C8, E8, EC, 0F, 34, 22)
+	},
+	{
+		BYTES_TO_WORDS_8(B9, 9C, AB, ED, 13, D1, 33, 60),
+		BYTES_TO_WORDS_8(EE, 45, 9D, E6, A3, 7B, F8, 1D),
+		BYTES_TO_WORDS_8(03, 5A, D6, E4, 36, 62, 43, 93),
+		BYTES_TO_WORDS_8(08, A5, 98, 3F, F9, F6, 93, 58),
+		BYTES_TO_WORDS_8(AB, 4F, D5, AA, 15, 2E, 83, B3),
+		BYTES_TO_WORDS_8(5E, 36, C7, 6B, 0D, FF, 77, 32),
+		BYTES_TO_WORDS_8(B8, 4F, 0C, 20, 18, 11, 30, E8),
+		BYTES_TO_WORDS_8(4D, 38, E9, D4, BC, 71, E4, 26)
+	},
+	{
+		BYTES_TO_WORDS_8(39, 8F, C2, 68, 1A, D9, 1D, 1C),
+		BYTES_TO_WORDS_8(CA, 69, 56, F3, 34, 43, 49, FA),
+		BYTES_TO_WORDS_8(43, B7, AB, 51, BD, 0A, B4, 77),
+		BYTES_TO_WORDS_8(25, 3A, 87, E7, BA, 00, 74, EE),
+		BYTES_TO_WORDS_8(D9, 09, 23, ED, F5, 9B, 5D, F1),
+		BYTES_TO_WORDS_8(5A, 78, A8, 3D, 3F, D1, 90, 8A),
+		BYTES_TO_WORDS_8(7D, B6, E8, 1B, 6C, B9, 4F, 7E),
+		BYTES_TO_WORDS_8(81, ED, E9, CA, A4, 1B, 6C, 19)
+	},
+	{
+		BYTES_TO_WORDS_8(D8, 27, 24, C5, A4, C5, 76, 32),
+		BYTES_TO_WORDS_8(64, 4B, A3, F5, 43, 82, 95, 66),
+		BYTES_TO_WORDS_8(92, 0D, 6E, F3, 98, 67, 16, 04),
+		BYTES_TO_WORDS_8(3F, E6, E9, C6, 27, 39, E3, 43),
+		BYTES_TO_WORDS_8(2B, 8D, CA, F0, 76, ED, 9A, 89),
+		BYTES_TO_WORDS_8(D8, 0D, F5, 0A, DE, 9C, B8, 43),
+		BYTES_TO_WORDS_8(3B, E1, 51, 59, 1E, A2, 5E, 80),
+		BYTES_TO_WORDS_8(43, 30, 41, 28, A4, DA, 10, E2)
+	},
+	{
+		BYTES_TO_WORDS_8(FC, 74, A1, 98, 7B, 62, 7F, E1),
+		BYTES_TO_WORDS_8(5E, 28, FA, 4D, FF, E1, BC, 5E),
+		BYTES_TO_WORDS_8(25, F9, C5, 54, 3D, E2, 5F, C9),
+		BYTES_TO_WORDS_8(78, BA, 88, 31, 09, 9A, A5, 5E),
+		BYTES_TO_WORDS_8(63, 81, 2D, 2D, 54, BB, 15, 66),
+		BYTES_TO_WORDS_8(95, 3D, B0, 5D, 1E, 4A, BE, 37),
+		BYTES_TO_WORDS_8(62, 77, C4, 4F, 92, 56, 1B, C5),
+		BYTES_TO_WORDS_8(1D, 93, 42, D1, 42, CA, 94, B9)
+	},
+	{
+		BYTES_TO_WORDS_8(5B, 03, 58, 07, 65, A1, 46, CE),
+		BYTES_TO_WORDS_8(C9, A0, 70, E0, AD, F1, 3D, B3),
+		BYTES_TO_WORDS_8(C9, 34, 69, 68, 38, FB, 01, BF),
+		BYTES_TO_WORDS_8(D0, 6E, F1, F0, 57, 62, BA, 1C),
+		BYTES_TO_WORDS_8(9C, 40, 93, EE, B6, A9, 38, E5),
+		BYTES_TO_WORDS_8(DA, 38, 6B, 4A, A1, 29, 24, D8),
+		BYTES_TO_WORDS_8(B1, 15, C2, A5, 0D, 77, 88, 14),
+		BYTES_TO_WORDS_8(58, 76, 1D, 89, 8E, 1F, DE, 4A)
+	},
+	{
+		BYTES_TO_WORDS_8(05, 31, A0, 51, A8, CD, 93, BF),
+		BYTES_TO_WORDS_8(ED, 33, E4, 7B, 60, 4A, 4F, B1),
+		BYTES_TO_WORDS_8(A1, 97, 1C, FA, C3, C4, A4, 0A),
+		BYTES_TO_WORDS_8(6E, 72, ED, BC, 75, 63, 1A, FE),
+		BYTES_TO_WORDS_8(04, C3, 09, 04, 87, 82, B6, 4D),
+		BYTES_TO_WORDS_8(F4, 7A, F3, EB, 22, 96, FB, 08),
+		BYTES_TO_WORDS_8(F4, DF, AB, F6, EC, 03, 70, 67),
+		BYTES_TO_WORDS_8(37, CC, B7, 3F, 72, E8, B2, E6)
+	},
+	{
+		BYTES_TO_WORDS_8(3F, E6, AD, 27, 4B, 2B, 70, FE),
+		BYTES_TO_WORDS_8(3A, 67, 05, A1, 33, 1A, F1, 5D),
+		BYTES_TO_WORDS_8(CE, B9, 62, A3, 80, CB, 33, 0D),
+		BYTES_TO_WORDS_8(09, B2, 5B, 85, F5, 42, BB, A7),
+		BYTES_TO_WORDS_8(75, E5, 5F, C9, 96, 60, CC, FD),
+		BYTES_TO_WORDS_8(C6, DE, 51, 23, D7, 08, 0E, FF),
+		BYTES_TO_WORDS_8(28, 5B, 6A, BB, F5, 3F, 32, A3),
+		BYTES_TO_WORDS_8(AB, A2, F7, 89, AE, 2D, AA, 2C)
+	},
+	{
+		BYTES_TO_WORDS_8(BB, 89, FF, 51, B6, 66, 25, 25),
+		BYTES_TO_WORDS_8(DC, 3D, 97, DB, 3E, 33, 3C, 45),
+		BYTES_TO_WORDS_8(C2, 2C, 3F, D8, 09, 5A, CD, FB),
+		BYTES_TO_WORDS_8(D5, DB, 21, 31, EC, 18, 78, 18),
+		BYTES_TO_WORDS_8(49, B9, 46, 3B, 5F, B4, A1, AE),
+		BYTES_TO_WORDS_8(E0, 53, F7, 55, 23, 46, 31, 42),
+		BYTES_TO_WORDS_8(FA, 91, 99, B0, 0B, B0, 9A, D5),
+		BYTES_TO_WORDS_8(D7, C8, E0, 0A, 0D, 65, 05, EE)
+	},
+	{
+		BYTES_TO_WORDS_8(49, EB, A7, 2D, 76, D6, 96, 20),
+		BYTES_TO_WORDS_8(41, 5E, 77, FB, 8E, 76, 04, 6E),
+		BYTES_TO_WORDS_8(6C, F7, 24, AF, 3D, 9C, 34, C3),
+		BYTES_TO_WORDS_8(F6, 90, 0C, DE, CA, 6C, DB, E6),
+		BYTES_TO_WORDS_8(87, FD, 16, A4, F5, 01, AA, 98),
+		BYTES_TO_WORDS_8(27, C4, 1E, 78, 0B, 27, C3, 84),
+		BYTES_TO_WORDS_8(B2, 34, 10, 02, 04, 0F, 68, 37),
+		BYTES_TO_WORDS_8(35, F7, 4B, 65, 3C, FE, 90, EB)
+	},
+	{
+		BYTES_TO_WORDS_8(D8, 6D, 97, E4, 3C, 62, F7, EA),
+		BYTES_TO_WORDS_8(B4, D0, 9B, E2, 1A, 8B, 52, 92),
+		BYTES_TO_WORDS_8(2A, EC, 5C, 64, CD, 8E, 15, 78),
+		BYTES_TO_WORDS_8(E9, 25, 13, B1, D8, EA, 65, 32),
+		BYTES_TO_WORDS_8(B7, 80, 47, C0, F8, 7A, A2, 1C),
+		BYTES_TO_WORDS_8(7D, 86, 65, 24, 45, 08, EF, 14),
+		BYTES_TO_WORDS_8(38, FE, EE, 2F, 87, 18, 5C, B4),
+		BYTES_TO_WORDS_8(E9, 30, 87, 5D, BC, 96, 4D, 7C)
+	},
+	{
+		BYTES_TO_WORDS_8(76, 19, 57, B3, 16, BF, 35, 8E),
+		BYTES_TO_WORDS_8(E7, 64, 68, 34, 63, 0C, EB, E2),
+		BYTES_TO_WORDS_8(7F, 6C, 9B, 7E, E0, 57, 7B, 2B),
+		BYTES_TO_WORDS_8(98, 5A, B3, 70, 6F, CF, 57, 31),
+		BYTES_TO_WORDS_8(A5, 9E, C4, 5A, 14, 4C, C2, FE),
+		BYTES_TO_WORDS_8(AE, 32, 1A, 6B, 90, 56, 0C, C2),
+		BYTES_TO_WORDS_8(35, A3, 5F, 34, 4E, 7B, EF, EA),
+		BYTES_TO_WORDS_8(5F, 47, 77, 40, 5D, 65, C9, B4)
+	},
+	{
+		BYTES_TO_WORDS_8(DA, B3, 38, 6C, 9B, 8C, 3D, 3C),
+		BYTES_TO_WORDS_8(E3, 33, 44, 75, 02, 83, 81, 80),
+		BYTES_TO_WORDS_8(2A, 54, 9E, E2, 07, AB, 68, FE),
+		BYTES_TO_WORDS_8(2C, BB, 2C, D1, 61, 5A, A2, 81),
+		BYTES_TO_WORDS_8(47, 56, 68, 8F, A7, 48, 99, 55),
+		BYTES_TO_WORDS_8(74, 65, A5, 83, F6, BC, 4E, E1),
+		BYTES_TO_WORDS_8(0F, DB, 77, 7A, 32, 66, 60, 1A),
+		BYTES_TO_WORDS_8(93, CE, 92, 08, 8F, 83, 9D, F4)
+	},
+	{
+		BYTES_TO_WORDS_8(B9, 66, F8, FC, FE, E3, F4, F3),
+		BYTES_TO_WORDS_8(D5, 0A, 8B, E1, 07, 08, 2A, 15),
+		BYTES_TO_WORDS_8(7B, 2E, 9B, 1B, 06, C7, C4, 2E),
+		BYTES_TO_WORDS_8(6F, 00, DD, DA, 2B, E9, D7, 41),
+		BYTES_TO_WORDS_8(F7, 6E, 4B, 1D, 79, 8A, 0A, FF),
+		BYTES_TO_WORDS_8(47, 2F, AA, B2, FF, 4D, 34, 02),
+		BYTES_TO_WORDS_8(81, 06, 7A, 35, 04, D7, 26, 17),
+		BYTES_TO_WORDS_8(F4, 85, BC, C1, 77, BB, E6, 4C)
+	},
+	{
+		BYTES_TO_WORDS_8(0D, A0, 16, 89, 86, BB, 1E, 65),
+		BYTES_TO_WORDS_8(8D, 90, 1E, 00, A9, 2D, 4D, BA),
+		BYTES_TO_WORDS_8(B0, FC, 84, 16, E6, 68, 2B, 5F),
+		BYTES_TO_WORDS_8(DF, 6E, AC, 10, 75, 8D, FF, C3),
+		BYTES_TO_WORDS_8(61, 9A, C4, F5, EA, E3, 97, 69),
+		BYTES_TO_WORDS_8(68, DC, A4, B1, 72, F3, 4F, 8F),
+		BYTES_TO_WORDS_8(B2, 2D, 5C, C9, 04, CE, A7, BE),
+		BYTES_TO_WORDS_8(61, F7, 10, 9D, F4, B4, CC, 2A)
+	},
+	{
+		BYTES_TO_WORDS_8(EF, 2B, CC, AF, F4, 37, E4, B9),
+		BYTES_TO_WORDS_8(53, 2B, DA, 3A, D6, B2, 1F, 4F),
+		BYTES_TO_WORDS_8(9A, 0C, 58, BB, 2D, E1, C0, E6),
+		BYTES_TO_WORDS_8(6D, 54, C7, 33, 34, 37, 18, 25),
+		BYTES_TO_WORDS_8(B9, 2F, D9, BF, 0F, D9, 12, AB),
+		BYTES_TO_WORDS_8(46, AE, 85, A1, B3, B9, B9, 2C),
+		BYTES_TO_WORDS_8(9F, F4, E6, 9C, 7E, 7A, 0C, 2A),
+		BYTES_TO_WORDS_8(F2, 21, 8F, B4, 7F, 30, 1F, 53)
+	}
+};
+#else
+#error "uECC_FIXED_BASE_TEETH must be 0, 4, 5 or 6"
+#endif
+/* END tables generated by tools/tcgentab.c */
+
+#define COMB_ENTRIES ((1 << uECC_FIXED_BASE_TEETH) - 1)
+
+/*
+ * The additions and doublings below use the complete projective formulas for
+ * a = -3 by Renes, Costello and Batina (https://eprint.iacr.org/2015/1060,
+ * algorithms 5 and 6). They have no exceptional cases, so the point at infinity
+ * (0 : 1 : 0) and doublings hidden inside additions need no branches.
+ */
+static void point_double(uECC_word_t *X3, uECC_word_t *Y3, uECC_word_t *Z3,
+			 uECC_Curve curve)
+{
+	uECC_word_t t0[NUM_ECC_WORDS];
+	uECC_word_t t1[NUM_ECC_WORDS];
+	uECC_word_t t2[NUM_ECC_WORDS];
+	uECC_word_t t3[NUM_ECC_WORDS];
+	uECC_word_t x[NUM_ECC_WORDS];
+	uECC_word_t y[NUM_ECC_WORDS];
+	uECC_word_t z[NUM_ECC_WORDS];
+	const uECC_word_t *p = curve->p;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+
+	uECC_vli_set(x, X3, num_words);
+	uECC_vli_set(y, Y3, num_words);
+	uECC_vli_set(z, Z3, num_words);
+
+	uECC_vli_modSquare_fast(t0, x, curve);
+	uECC_vli_modSquare_fast(t1, y, curve);
+	uECC_vli_modSquare_fast(t2, z, curve);
+	uECC_vli_modMult_fast(t3, x, y, curve);
+	uECC_vli_modAdd(t3, t3, t3, p, num_words);
+	uECC_vli_modMult_fast(Z3, x, z, curve);
+	uECC_vli_modAdd(Z3, Z3, Z3, p, num_words);
+	uECC_vli_modMult_fast(Y3, curve->b, t2, curve);
+	uECC_vli_modSub(Y3, Y3, Z3, p, num_words);
+	uECC_vli_modAdd(X3, Y3, Y3, p, num_words);
+	uECC_vli_modAdd(Y3, X3, Y3, p, num_words);
+	uECC_vli_modSub(X3, t1, Y3, p, num_words);
+	uECC_vli_modAdd(Y3, t1, Y3, p, num_words);
+	uECC_vli_modMult_fast(Y3, X3, Y3, curve);
+	uECC_vli_modMult_fast(X3, X3, t3, curve);
+	uECC_vli_modAdd(t3, t2, t2, p, num_words);
+	uECC_vli_modAdd(t2, t2, t3, p, num_words);
+	uECC_vli_modMult_fast(Z3, curve->b, Z3, curve);
+	uECC_vli_modSub(Z3, Z3, t2, p, num_words);
+	uECC_vli_modSub(Z3, Z3, t0, p, num_words);
+	uECC_vli_modAdd(t3, Z3, Z3, p, num_words);
+	uECC_vli_modAdd(Z3, Z3, t3, p, num_words);
+	uECC_vli_modAdd(t3, t0, t0, p, num_words);
+	uECC_vli_modAdd(t0, t3, t0, p, num_words);
+	uECC_vli_modSub(t0, t0, t2, p, num_words);
+	uECC_vli_modMult_fast(t0, t0, Z3, curve);
+	uECC_vli_modAdd(Y3, Y3, t0, p, num_words);
+	uECC_vli_modMult_fast(t0, y, z, curve);
+	uECC_vli_modAdd(t0, t0, t0, p, num_words);
+	uECC_vli_modMult_fast(Z3, t0, Z3, curve);
+	uECC_vli_modSub(X3, X3, Z3, p, num_words);
+	uECC_vli_modMult_fast(Z3, t0, t1, curve);
+	uECC_vli_modAdd(Z3, Z3, Z3, p, num_words);
+	uECC_vli_modAdd(Z3, Z3, Z3, p, num_words);
+}
+
+/* (X3 : Y3 : Z3) += (X2, Y2), the latter affine and not the point at infinity */
+static void point_add_mixed(uECC_word_t *X3, uECC_word_t *Y3, uECC_word_t *Z3,
+			    const uECC_word_t *X2, const uECC_word_t *Y2,
+			    uECC_Curve curve)
+{
+	uECC_word_t t0[NUM_ECC_WORDS];
+	uECC_word_t t1[NUM_ECC_WORDS];
+	uECC_word_t t2[NUM_ECC_WORDS];
+	uECC_word_t t3[NUM_ECC_WORDS];
+	uECC_word_t t4[NUM_ECC_WORDS];
+	uECC_word_t x[NUM_ECC_WORDS];
+	uECC_word_t y[NUM_ECC_WORDS];
+	uECC_word_t z[NUM_ECC_WORDS];
+	const uECC_word_t *p = curve->p;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+
+	uECC_vli_set(x, X3, num_words);
+	uECC_vli_set(y, Y3, num_words);
+	uECC_vli_set(z, Z3, num_words);
+
+	uECC_vli_modMult_fast(t0, x, X2, curve);
+	uECC_vli_modMult_fast(t1, y, Y2, curve);
+	uECC_vli_modAdd(t3, X2, Y2, p, num_words);
+	uECC_vli_modAdd(t4, x, y, p, num_words);
+	uECC_vli_modMult_fast(t3, t3, t4, curve);
+	uECC_vli_modAdd(t4, t0, t1, p, num_words);
+	uECC_vli_modSub(t3, t3, t4, p, num_words);
+	uECC_vli_modMult_fast(t4, Y2, z, curve);
+	uECC_vli_modAdd(t4, t4, y, p, num_words);
+	uECC_vli_modMult_fast(Y3, X2, z, curve);
+	uECC_vli_modAdd(Y3, Y3, x, p, num_words);
+	uECC_vli_modMult_fast(Z3, curve->b, z, curve);
+	uECC_vli_modSub(X3, Y3, Z3, p, num_words);
+	uECC_vli_modAdd(Z3, X3, X3, p, num_words);
+	uECC_vli_modAdd(X3, X3, Z3, p, num_words);
+	uECC_vli_modSub(Z3, t1, X3, p, num_words);
+	uECC_vli_modAdd(X3, t1, X3, p, num_words);
+	uECC_vli_modMult_fast(Y3, curve->b, Y3, curve);
+	uECC_vli_modAdd(t1, z, z, p, num_words);
+	uECC_vli_modAdd(t2, t1, z, p, num_words);
+	uECC_vli_modSub(Y3, Y3, t2, p, num_words);
+	uECC_vli_modSub(Y3, Y3, t0, p, num_words);
+	uECC_vli_modAdd(t1, Y3, Y3, p, num_words);
+	uECC_vli_modAdd(Y3, t1, Y3, p, num_words);
+	uECC_vli_modAdd(t1, t0, t0, p, num_words);
+	uECC_vli_modAdd(t0, t1, t0, p, num_words);
+	uECC_vli_modSub(t0, t0, t2, p, num_words);
+	uECC_vli_modMult_fast(t1, t4, Y3, curve);
+	uECC_vli_modMult_fast(t2, t0, Y3, curve);
+	uECC_vli_modMult_fast(Y3, X3, Z3, curve);
+	uECC_vli_modAdd(Y3, Y3, t2, p, num_words);
+	uECC_vli_modMult_fast(X3, t3, X3, curve);
+	uECC_vli_modSub(X3, X3, t1, p, num_words);
+	uECC_vli_modMult_fast(Z3, t4, Z3, curve);
+	uECC_vli_modMult_fast(t1, t3, t0, curve);
+	uECC_vli_modAdd(Z3, Z3, t1, p, num_words);
+}
+
+/* dest = mask ? src : dest, without branching on mask (0 or all ones) */
+static void vli_select(uECC_word_t *dest, const uECC_word_t *src,
+		       uECC_word_t mask, wordcount_t num_words)
+{
+	wordcount_t i;
+
+	for (i = 0; i < num_words; ++i) {
+		dest[i] ^= (dest[i] ^ src[i]) & mask;
+	}
+}
+
+void EccPoint_mult_base(uECC_word_t *result, const uECC_word_t *scalar,
+			uECC_Curve curve)
+{
+	uECC_word_t ws[uECC_BASE_WS_WORDS];
+
+	EccPoint_mult_base_ws(result, scalar, curve, ws);
+}
+
+void EccPoint_mult_base_ws(uECC_word_t *result, const uECC_word_t *scalar,
+			   uECC_Curve curve, uECC_word_t *ws)
+{
+	uECC_word_t *X = ws;
+	uECC_word_t *Y = ws + NUM_ECC_WORDS;
+	uECC_word_t *Z = ws + 2 * NUM_ECC_WORDS;
+	uECC_word_t *sX = ws + 3 * NUM_ECC_WORDS;
+	uECC_word_t *sY = ws + 4 * NUM_ECC_WORDS;
+	uECC_word_t *sZ = ws + 5 * NUM_ECC_WORDS;
+	uECC_word_t *entry = ws + 6 * NUM_ECC_WORDS;
+	uECC_word_t mask;
+	unsigned int index;
+	bitcount_t bit;
+	wordcount_t num_words = uECC_NUM_WORDS(curve);
+	int col;
+	int i;
+	unsigned int j;
+
+	/* R = (0 : 1 : 0), the point at infinity */
+	uECC_vli_clear(X, num_words);
+	uECC_vli_clear(Y, num_words);
+	uECC_vli_clear(Z, num_words);
+	Y[0] = 1;
+
+	for (col = COMB_SPACING - 1; col >= 0; --col) {
+		point_double(X, Y, Z, curve);
+
+		index = 0;
+		for (i = 0; i < uECC_FIXED_BASE_TEETH; ++i) {
+			bit = (bitcount_t)(i * COMB_SPACING + col);
+			if (bit < NUM_ECC_WORDS * uECC_WORD_BITS) {
+				index |= (!!uECC_vli_testBit(scalar, bit)) << i;
+			}
+		}
+
+		/* Read every entry so that the access pattern does not depend on
+		 * the scalar; index 0 picks up entry 0 and throws the sum away. */
+		uECC_vli_set(entry, comb_table[0], 2 * num_words);
+		for (j = 2; j <= COMB_ENTRIES; ++j) {
+			mask = -(uECC_word_t)(j == index);
+			vli_select(entry, comb_table[j - 1], mask, 2 * num_words);
+		}
+
+		uECC_vli_set(sX, X, num_words);
+		uECC_vli_set(sY, Y, num_words);
+		uECC_vli_set(sZ, Z, num_words);
+		point_add_mixed(sX, sY, sZ, entry, entry + num_words, curve);
+
+		mask = -(uECC_word_t)(index != 0);
+		vli_select(X, sX, mask, num_words);
+		vli_select(Y, sY, mask, num_words);
+		vli_select(Z, sZ, mask, num_words);
+	}
+
+	/* Back to affine; a zero scalar leaves Z = 0 and yields (0, 0). */
+	uECC_vli_modInv(Z, Z, curve->p, num_words);
+	uECC_vli_modMult_fast(result, X, Z, curve);
+	uECC_vli_modMult_fast(result + num_words, Y, Z, curve);
+}
+
+#endif /* uECC_FIXED_BASE_TEETH > 0 */
@@ -56,50 +56,269 @@
  */
 
 
+/* madvise() and MADV_WIPEONFORK are outside of strict C99/POSIX. */
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
+#include <stdint.h>
+#include <tinycrypt/ecc_platform_specific.h>
+
 #if defined(unix) || defined(__linux__) || defined(__unix__) || \
     defined(__unix) |  (defined(__APPLE__) && defined(__MACH__)) || \
     defined(uECC_POSIX)
 
 /* Some POSIX-like system with /dev/urandom or /dev/random. */
 #include <sys/types.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
 
-#include <stdint.h>
+#if defined(__linux__) && defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 25))
+/* getrandom() needs no file descriptor: one syscall per request. */
+#define uECC_HAVE_GETRANDOM
+#include <sys/random.h>
+#endif
+
+#if defined(uECC_HAVE_GETRANDOM)
+/* set when the kernel turns out to predate getrandom(): */
+static int getrandom_missing;
+#endif
 
 #ifndef O_CLOEXEC
 #define O_CLOEXEC 0
 #endif
 
-int default_CSPRNG(uint8_t *dest, unsigned int size) {
+/* /dev/urandom (or /dev/random) stays open once opened. */
+static int urandom_fd = -1;
 
-  /* input sanity check: */
-  if (dest == (uint8_t *) 0 || (size <= 0))
-    return 0;
+static int open_urandom(void) {
 
-  int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+  int fd = urandom_fd;
+  if (fd != -1) {
+    return fd;
+  }
+
+  fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
   if (fd == -1) {
     fd = open("/dev/random", O_RDONLY | O_CLOEXEC);
     if (fd == -1) {
+      return -1;
+    }
+  }
+
+#if defined(__GNUC__)
+  /* another thread may have got there first: */
+  if (!__sync_bool_compare_and_swap(&urandom_fd, -1, fd)) {
+    close(fd);
+    fd = urandom_fd;
+  }
+#else
+  urandom_fd = fd;
+#endif
+  return fd;
+}
+
+/* Fills dest with size bytes from the operating system. */
+static int os_random(uint8_t *dest, size_t size) {
+
+#if defined(uECC_HAVE_GETRANDOM)
+  while (size > 0 && !getrandom_missing) {
+    ssize_t bytes_read = getrandom(dest, size, 0);
+    if (bytes_read < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == ENOSYS) { /* kernel older than 3.17 */
+        getrandom_missing = 1;
+        break;
+      }
       return 0;
     }
+    size -= bytes_read;
+    dest += bytes_read;
+  }
+  if (size == 0) {
+    return 1;
+  }
+#endif
+
+  int fd = open_urandom();
+  if (fd == -1) {
+    return 0;
   }
 
-  char *ptr = (char *)dest;
-  size_t left = (size_t) size;
-  while (left > 0) {
-    ssize_t bytes_read = read(fd, ptr, left);
+  while (size > 0) {
+    ssize_t bytes_read = read(fd, dest, size);
+    if (bytes_read < 0 && errno == EINTR) {
+      continue;
+    }
     if (bytes_read <= 0) { // read failed
-      close(fd);
       return 0;
     }
-    left -= bytes_read;
-    ptr += bytes_read;
+    size -= bytes_read;
+    dest += bytes_read;
+  }
+  return 1;
+}
+
+#if uECC_CSPRNG_CTR_DRBG
+
+#if !defined(__GNUC__)
+#error "uECC_CSPRNG_CTR_DRBG needs GCC or clang for thread-local state"
+#endif
+
+#include <tinycrypt/ctr_prng.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#define CSPRNG_SEED_SIZE (TC_AES_KEY_SIZE + TC_AES_BLOCK_SIZE)
+
+/* Each thread runs its own CTR-DRBG, seeded from the operating system on
+ * first use, and serves requests of up to uECC_CSPRNG_BUFFER_SIZE bytes from
+ * a buffer of its output. */
+static __thread struct {
+  TCCtrPrng_t prng;
+  uint8_t buffer[uECC_CSPRNG_BUFFER_SIZE];
+  unsigned int left;
+  int seeded;
+  pid_t pid;
+} csprng;
+
+#if defined(__linux__) && defined(MADV_WIPEONFORK)
+/* A page that reads 1 in the process that mapped it and that the kernel
+ * zeroes in a child after fork(); NULL until mapped, MAP_FAILED if the
+ * kernel does not support MADV_WIPEONFORK. */
+static volatile uint8_t *fork_page;
+
+static volatile uint8_t *get_fork_page(void) {
+
+  volatile uint8_t *page = fork_page;
+  void *p;
+
+  if (page) {
+    return page;
   }
 
-  close(fd);
+  p = mmap(0, 4096, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+           -1, 0);
+  if (p != MAP_FAILED && madvise(p, 4096, MADV_WIPEONFORK) != 0) {
+    munmap(p, 4096);
+    p = MAP_FAILED;
+  }
+  if (p != MAP_FAILED) {
+    *(volatile uint8_t *)p = 1;
+  }
+  if (!__sync_bool_compare_and_swap(&fork_page, 0, (volatile uint8_t *)p)) {
+    if (p != MAP_FAILED) {
+      munmap(p, 4096);
+    }
+  }
+  return fork_page;
+}
+#endif
+
+/* Returns 1 if the state was seeded in another process (the parent of a
+ * fork()), whose output must not be repeated here. */
+static int csprng_forked(void) {
+
+#if defined(__linux__) && defined(MADV_WIPEONFORK)
+  volatile uint8_t *page = get_fork_page();
+  if (page != (volatile uint8_t *)MAP_FAILED) {
+    if (*page == 0) {
+      *page = 1;
+      return 1;
+    }
+    return 0;
+  }
+#endif
+  return csprng.pid != getpid();
+}
+
+static int csprng_seed(void) {
+
+  uint8_t seed[CSPRNG_SEED_SIZE];
+  int r;
+
+  if (!os_random(seed, sizeof(seed))) {
+    return 0;
+  }
+  if (csprng.seeded) {
+    r = tc_ctr_prng_reseed(&csprng.prng, seed, sizeof(seed), 0, 0);
+  } else {
+    r = tc_ctr_prng_init(&csprng.prng, seed, sizeof(seed), 0, 0);
+  }
+  _set_secure(seed, 0, sizeof(seed));
+  _set_secure(csprng.buffer, 0, sizeof(csprng.buffer));
+  csprng.left = 0;
+  csprng.seeded = r;
+  csprng.pid = getpid();
+  return r;
+}
+
+static int csprng_generate(uint8_t *dest, unsigned int size) {
+
+  int r = tc_ctr_prng_generate(&csprng.prng, 0, 0, dest, size);
+  if (r == TC_CTR_PRNG_RESEED_REQ) {
+    r = csprng_seed() && tc_ctr_prng_generate(&csprng.prng, 0, 0, dest, size);
+  }
+  return r == TC_CRYPTO_SUCCESS;
+}
+
+int default_CSPRNG(uint8_t *dest, unsigned int size) {
+
+  /* input sanity check: */
+  if (dest == (uint8_t *) 0 || (size <= 0))
+    return 0;
+
+  /* csprng_forked() also sets up fork detection on the first call, so it
+   * runs before the seeded test: */
+  if ((csprng_forked() || !csprng.seeded) && !csprng_seed()) {
+    return 0;
+  }
+
+  if (size > uECC_CSPRNG_BUFFER_SIZE) {
+    while (size > 0) {
+      unsigned int chunk = size < 0x8000 ? size : 0x8000;
+      if (!csprng_generate(dest, chunk)) {
+        return 0;
+      }
+      size -= chunk;
+      dest += chunk;
+    }
+    return 1;
+  }
+
+  if (csprng.left < size) {
+    if (!csprng_generate(csprng.buffer, sizeof(csprng.buffer))) {
+      return 0;
+    }
+    csprng.left = sizeof(csprng.buffer);
+  }
+  /* hand out the end of the buffer and erase it: */
+  csprng.left -= size;
+  memcpy(dest, csprng.buffer + csprng.left, size);
+  _set_secure(csprng.buffer + csprng.left, 0, size);
   return 1;
 }
 
-#endif /* platform */
+#else
+
+int default_CSPRNG(uint8_t *dest, unsigned int size) {
 
+  /* input sanity check: */
+  if (dest == (uint8_t *) 0 || (size <= 0))
+    return 0;
+
+  return os_random(dest, size);
+}
+
+#endif /* uECC_CSPRNG_CTR_DRBG */
+
+#endif /* platform */
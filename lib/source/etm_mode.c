@@ -0,0 +1,253 @@
+/* etm_mode.c - TinyCrypt implementation of encrypt-then-MAC composite modes */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/etm_mode.h>
+#include <tinycrypt/ctr_mode.h>
+#include <tinycrypt/cbc_mode.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+/*
+ * Bytes encrypted (or decrypted) before they are MACed. A chunk of input and
+ * one of output should fit in the data cache together; CBC needs a multiple
+ * of the block size.
+ */
+#ifndef TINYCRYPT_ETM_CHUNK_SIZE
+#define TINYCRYPT_ETM_CHUNK_SIZE 4096
+#endif
+
+#if (TINYCRYPT_ETM_CHUNK_SIZE % TC_AES_BLOCK_SIZE) != 0 || \
+	TINYCRYPT_ETM_CHUNK_SIZE == 0
+#error "TINYCRYPT_ETM_CHUNK_SIZE must be a non-zero multiple of 16"
+#endif
+
+static unsigned int chunk(unsigned int len)
+{
+	return len < TINYCRYPT_ETM_CHUNK_SIZE ? len : TINYCRYPT_ETM_CHUNK_SIZE;
+}
+
+int tc_etm_ctr_hmac_encrypt(uint8_t *out, unsigned int outlen,
+			    const uint8_t *in, unsigned int inlen,
+			    uint8_t *ctr, const TCAesKeySched_t sched,
+			    const struct tc_hmac_key_struct *mac_key,
+			    uint8_t *tag)
+{
+	struct tc_sha256_state_struct s;
+	unsigned int len;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    in == (const uint8_t *) 0 ||
+	    ctr == (uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0 ||
+	    mac_key == (const struct tc_hmac_key_struct *) 0 ||
+	    tag == (uint8_t *) 0 ||
+	    inlen == 0 ||
+	    outlen != inlen) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* the tag covers the initial counter block, then the ciphertext */
+	(void)tc_hmac_key_init(&s, mac_key);
+	(void)tc_sha256_update(&s, ctr, TC_AES_BLOCK_SIZE);
+
+	while (inlen > 0) {
+		len = chunk(inlen);
+		if (tc_ctr_mode(out, len, in, len, ctr, sched) == 0) {
+			_set(&s, 0, sizeof(s));
+			return TC_CRYPTO_FAIL;
+		}
+		(void)tc_sha256_update(&s, out, len);
+		out += len;
+		in += len;
+		inlen -= len;
+	}
+
+	(void)tc_hmac_key_final(tag, TC_ETM_HMAC_TAG_SIZE, &s, mac_key);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_etm_ctr_hmac_decrypt(uint8_t *out, unsigned int outlen,
+			    const uint8_t *in, unsigned int inlen,
+			    uint8_t *ctr, const TCAesKeySched_t sched,
+			    const struct tc_hmac_key_struct *mac_key,
+			    const uint8_t *tag)
+{
+	struct tc_sha256_state_struct s;
+	uint8_t computed[TC_ETM_HMAC_TAG_SIZE];
+	uint8_t *start = out;
+	unsigned int len;
+	int r;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    in == (const uint8_t *) 0 ||
+	    ctr == (uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0 ||
+	    mac_key == (const struct tc_hmac_key_struct *) 0 ||
+	    tag == (const uint8_t *) 0 ||
+	    inlen == 0 ||
+	    outlen != inlen) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)tc_hmac_key_init(&s, mac_key);
+	(void)tc_sha256_update(&s, ctr, TC_AES_BLOCK_SIZE);
+
+	/* MAC each chunk before deciphering it, so that out may be in */
+	while (inlen > 0) {
+		len = chunk(inlen);
+		(void)tc_sha256_update(&s, in, len);
+		if (tc_ctr_mode(out, len, in, len, ctr, sched) == 0) {
+			_set(&s, 0, sizeof(s));
+			_set(start, 0, outlen);
+			return TC_CRYPTO_FAIL;
+		}
+		out += len;
+		in += len;
+		inlen -= len;
+	}
+
+	(void)tc_hmac_key_final(computed, sizeof(computed), &s, mac_key);
+	r = _compare(computed, tag, sizeof(computed)) == 0;
+	_set(computed, 0, sizeof(computed));
+	if (!r) {
+		_set(start, 0, outlen);
+		return TC_CRYPTO_FAIL;
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_etm_cbc_cmac_encrypt(uint8_t *out, unsigned int outlen,
+			    const uint8_t *in, unsigned int inlen,
+			    const uint8_t *iv, const TCAesKeySched_t sched,
+			    TCCmacKey_t mac_key, uint8_t *tag)
+{
+	struct tc_cmac_msg_struct m;
+	uint8_t chain[TC_AES_BLOCK_SIZE];
+	unsigned int len;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    in == (const uint8_t *) 0 ||
+	    iv == (const uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0 ||
+	    tag == (uint8_t *) 0 ||
+	    inlen == 0 ||
+	    (inlen % TC_AES_BLOCK_SIZE) != 0 ||
+	    outlen != inlen + TC_AES_BLOCK_SIZE ||
+	    tc_cmac_key_init(&m, mac_key) == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* the tag covers the iv, then the ciphertext */
+	(void)tc_cmac_key_update(&m, iv, TC_AES_BLOCK_SIZE);
+	(void)_copy(chain, sizeof(chain), iv, TC_AES_BLOCK_SIZE);
+
+	/*
+	 * Each chunk is chained from the ciphertext block before it, which
+	 * tc_cbc_mode_encrypt writes again (unchanged) in front of the chunk.
+	 */
+	while (inlen > 0) {
+		len = chunk(inlen);
+		(void)tc_cbc_mode_encrypt(out, len + TC_AES_BLOCK_SIZE, in, len,
+					  chain, sched);
+		out += len;
+		(void)tc_cmac_key_update(&m, out - len + TC_AES_BLOCK_SIZE, len);
+		(void)_copy(chain, sizeof(chain), out, TC_AES_BLOCK_SIZE);
+		in += len;
+		inlen -= len;
+	}
+
+	(void)tc_cmac_key_final(tag, &m);
+	_set(chain, 0, sizeof(chain));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_etm_cbc_cmac_decrypt(uint8_t *out, unsigned int outlen,
+			    const uint8_t *in, unsigned int inlen,
+			    const TCAesKeySched_t sched, TCCmacKey_t mac_key,
+			    const uint8_t *tag)
+{
+	struct tc_cmac_msg_struct m;
+	uint8_t computed[TC_ETM_CMAC_TAG_SIZE];
+	uint8_t *start = out;
+	unsigned int len;
+	int r;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    in == (const uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0 ||
+	    tag == (const uint8_t *) 0 ||
+	    inlen < 2 * TC_AES_BLOCK_SIZE ||
+	    (inlen % TC_AES_BLOCK_SIZE) != 0 ||
+	    outlen != inlen - TC_AES_BLOCK_SIZE ||
+	    tc_cmac_key_init(&m, mac_key) == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)tc_cmac_key_update(&m, in, TC_AES_BLOCK_SIZE);
+	inlen -= TC_AES_BLOCK_SIZE;
+
+	/*
+	 * in points at the block each chunk is chained from (the iv first).
+	 * A chunk is MACed before it is deciphered, and its output ends one
+	 * block below the next chunk's chaining block, so out may be in.
+	 */
+	while (inlen > 0) {
+		len = chunk(inlen);
+		(void)tc_cmac_key_update(&m, in + TC_AES_BLOCK_SIZE, len);
+		if (tc_cbc_mode_decrypt(out, len, in + TC_AES_BLOCK_SIZE, len,
+					in, sched) == 0) {
+			(void)tc_cmac_key_final(computed, &m);
+			_set(start, 0, outlen);
+			return TC_CRYPTO_FAIL;
+		}
+		out += len;
+		in += len;
+		inlen -= len;
+	}
+
+	(void)tc_cmac_key_final(computed, &m);
+	r = _compare(computed, tag, sizeof(computed)) == 0;
+	_set(computed, 0, sizeof(computed));
+	if (!r) {
+		_set(start, 0, outlen);
+		return TC_CRYPTO_FAIL;
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
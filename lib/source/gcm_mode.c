@@ -0,0 +1,429 @@
+/* gcm_mode.c - TinyCrypt implementation of GCM mode */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/gcm_mode.h>
+#include <tinycrypt/ctr_mode.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+#if defined(TINYCRYPT_GCM_CLMUL)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TC_GCM_CLMUL_X86
+#include <immintrin.h>
+#define TC_GCM_CLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+#elif (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES)) && \
+      defined(__ARM_NEON) && defined(__aarch64__)
+#define TC_GCM_CLMUL_ARM
+#include <arm_neon.h>
+#endif
+#endif
+
+static uint64_t load64_be(const uint8_t *p)
+{
+
+	return ((uint64_t) p[0] << 56) | ((uint64_t) p[1] << 48) |
+	       ((uint64_t) p[2] << 40) | ((uint64_t) p[3] << 32) |
+	       ((uint64_t) p[4] << 24) | ((uint64_t) p[5] << 16) |
+	       ((uint64_t) p[6] << 8) | (uint64_t) p[7];
+}
+
+static void store64_be(uint8_t *p, uint64_t v)
+{
+	unsigned int i;
+
+	for (i = 0; i < 8; ++i) {
+		p[i] = (uint8_t)(v >> (56 - 8 * i));
+	}
+}
+
+/*
+ * Multiplies y by H with the 4-bit table of g (Shoup's method): y is
+ * processed a nibble at a time from its last byte, the product being shifted
+ * right by four bits (towards the higher powers of x in the GHASH bit order)
+ * between nibbles; last4[r] reduces the four bits shifted out.
+ */
+static void gf_mult_table(uint8_t *y, const struct tc_gcm_mode_struct *g)
+{
+	static const uint64_t last4[16] = {
+		0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+		0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+	};
+	uint64_t zh, zl;
+	unsigned int r, n;
+	int i;
+
+	n = y[15] & 0x0f;
+	zh = g->hh[n];
+	zl = g->hl[n];
+	for (i = 15; i >= 0; --i) {
+		if (i != 15) {
+			n = y[i] & 0x0f;
+			r = (unsigned int) zl & 0x0f;
+			zl = (zh << 60) | (zl >> 4);
+			zh = (zh >> 4) ^ (last4[r] << 48);
+			zh ^= g->hh[n];
+			zl ^= g->hl[n];
+		}
+		n = y[i] >> 4;
+		r = (unsigned int) zl & 0x0f;
+		zl = (zh << 60) | (zl >> 4);
+		zh = (zh >> 4) ^ (last4[r] << 48);
+		zh ^= g->hh[n];
+		zl ^= g->hl[n];
+	}
+	store64_be(y, zh);
+	store64_be(y + 8, zl);
+}
+
+#if defined(TC_GCM_CLMUL_X86) || defined(TC_GCM_CLMUL_ARM)
+/*
+ * The carry-less multiply engines reverse the bits of every byte first:
+ * the GHASH bit order then becomes the ordinary one, with the coefficient of
+ * x^i in bit i % 8 of byte i / 8, so the two little-endian 64-bit halves of a
+ * block form a plain polynomial. p[0..3] is the 256-bit product (least
+ * significant word first); it is reduced modulo x^128 + x^7 + x^2 + x + 1,
+ * the bits above x^127 folding back multiplied by x^7 + x^2 + x + 1.
+ */
+static void gf_reduce(uint64_t *r, const uint64_t *p)
+{
+	uint64_t o;
+
+	/* bits of p[3] shifted out above x^255 by the fold of the high half: */
+	o = (p[3] >> 63) ^ (p[3] >> 62) ^ (p[3] >> 57);
+	r[0] = p[0] ^ p[2] ^ (p[2] << 1) ^ (p[2] << 2) ^ (p[2] << 7) ^
+	       o ^ (o << 1) ^ (o << 2) ^ (o << 7);
+	r[1] = p[1] ^ p[3] ^ (p[3] << 1) ^ (p[3] << 2) ^ (p[3] << 7) ^
+	       (p[2] >> 63) ^ (p[2] >> 62) ^ (p[2] >> 57);
+}
+#endif
+
+#if defined(TC_GCM_CLMUL_X86)
+
+TC_GCM_CLMUL_TARGET
+static inline __m128i bit_reverse_bytes(__m128i x)
+{
+	const __m128i rev = _mm_set_epi8(15, 7, 11, 3, 13, 5, 9, 1,
+					 14, 6, 10, 2, 12, 4, 8, 0);
+	const __m128i mask = _mm_set1_epi8(0x0f);
+	__m128i lo = _mm_shuffle_epi8(rev, _mm_and_si128(x, mask));
+	__m128i hi = _mm_shuffle_epi8(rev,
+				      _mm_and_si128(_mm_srli_epi16(x, 4), mask));
+
+	return _mm_or_si128(_mm_slli_epi16(lo, 4), hi);
+}
+
+TC_GCM_CLMUL_TARGET
+static void ghash_clmul(uint8_t *y, const uint8_t *h, const uint8_t *data,
+			unsigned int nblocks)
+{
+	__m128i hv = bit_reverse_bytes(_mm_loadu_si128((const __m128i *) h));
+	__m128i yv = bit_reverse_bytes(_mm_loadu_si128((const __m128i *) y));
+	__m128i lo, mid, hi;
+	uint64_t p[4], r[2];
+
+	while (nblocks-- > 0) {
+		yv = _mm_xor_si128(yv, bit_reverse_bytes(
+					_mm_loadu_si128((const __m128i *) data)));
+		lo = _mm_clmulepi64_si128(yv, hv, 0x00);
+		hi = _mm_clmulepi64_si128(yv, hv, 0x11);
+		mid = _mm_xor_si128(_mm_clmulepi64_si128(yv, hv, 0x01),
+				    _mm_clmulepi64_si128(yv, hv, 0x10));
+		lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+		hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+		_mm_storeu_si128((__m128i *) p, lo);
+		_mm_storeu_si128((__m128i *) (p + 2), hi);
+		gf_reduce(r, p);
+		yv = _mm_loadu_si128((const __m128i *) r);
+		data += TC_AES_BLOCK_SIZE;
+	}
+	_mm_storeu_si128((__m128i *) y, bit_reverse_bytes(yv));
+}
+
+#elif defined(TC_GCM_CLMUL_ARM)
+
+static void ghash_clmul(uint8_t *y, const uint8_t *h, const uint8_t *data,
+			unsigned int nblocks)
+{
+	uint64x2_t hv = vreinterpretq_u64_u8(vrbitq_u8(vld1q_u8(h)));
+	uint64x2_t yv = vreinterpretq_u64_u8(vrbitq_u8(vld1q_u8(y)));
+	poly64_t h0 = (poly64_t) vgetq_lane_u64(hv, 0);
+	poly64_t h1 = (poly64_t) vgetq_lane_u64(hv, 1);
+	uint64x2_t lo, mid, hi;
+	uint64_t p[4], r[2];
+
+	while (nblocks-- > 0) {
+		yv = veorq_u64(yv, vreinterpretq_u64_u8(vrbitq_u8(vld1q_u8(data))));
+		lo = vreinterpretq_u64_p128(vmull_p64(
+				(poly64_t) vgetq_lane_u64(yv, 0), h0));
+		hi = vreinterpretq_u64_p128(vmull_p64(
+				(poly64_t) vgetq_lane_u64(yv, 1), h1));
+		mid = veorq_u64(
+			vreinterpretq_u64_p128(vmull_p64(
+				(poly64_t) vgetq_lane_u64(yv, 0), h1)),
+			vreinterpretq_u64_p128(vmull_p64(
+				(poly64_t) vgetq_lane_u64(yv, 1), h0)));
+		p[0] = vgetq_lane_u64(lo, 0);
+		p[1] = vgetq_lane_u64(lo, 1) ^ vgetq_lane_u64(mid, 0);
+		p[2] = vgetq_lane_u64(hi, 0) ^ vgetq_lane_u64(mid, 1);
+		p[3] = vgetq_lane_u64(hi, 1);
+		gf_reduce(r, p);
+		yv = vld1q_u64(r);
+		data += TC_AES_BLOCK_SIZE;
+	}
+	vst1q_u8(y, vrbitq_u8(vreinterpretq_u8_u64(yv)));
+}
+
+#endif
+
+/*
+ * Updates the GHASH value y with len bytes of data, the last block padded
+ * with zeros.
+ */
+static void ghash(const struct tc_gcm_mode_struct *g, uint8_t *y,
+		  const uint8_t *data, unsigned int len)
+{
+	uint8_t block[TC_AES_BLOCK_SIZE];
+	unsigned int nblocks = len / TC_AES_BLOCK_SIZE;
+	unsigned int i;
+
+#if defined(TC_GCM_CLMUL_X86) || defined(TC_GCM_CLMUL_ARM)
+	if (_cpu_features() & TC_CPU_CLMUL) {
+		ghash_clmul(y, g->h, data, nblocks);
+		data += nblocks * TC_AES_BLOCK_SIZE;
+		len -= nblocks * TC_AES_BLOCK_SIZE;
+		if (len > 0) {
+			_set(block, 0, sizeof(block));
+			(void) _copy(block, sizeof(block), data, len);
+			ghash_clmul(y, g->h, block, 1);
+		}
+		return;
+	}
+#endif
+
+	while (nblocks-- > 0) {
+		for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
+			y[i] ^= data[i];
+		}
+		gf_mult_table(y, g);
+		data += TC_AES_BLOCK_SIZE;
+		len -= TC_AES_BLOCK_SIZE;
+	}
+	if (len > 0) {
+		for (i = 0; i < len; ++i) {
+			y[i] ^= data[i];
+		}
+		gf_mult_table(y, g);
+	}
+	(void) block;
+}
+
+int tc_gcm_config(TCGcmMode_t g, TCAesKeySched_t sched, unsigned int mlen)
+{
+	uint64_t vh, vl, t;
+	unsigned int i, j;
+
+	/* input sanity check: */
+	if (g == (TCGcmMode_t) 0 ||
+	    sched == (TCAesKeySched_t) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (mlen != 4 && mlen != 8 && (mlen < 12 || mlen > 16)) {
+		return TC_CRYPTO_FAIL; /* The allowed tag sizes are: 4, 8, 12-16. */
+	}
+
+	g->sched = sched;
+	g->mlen = mlen;
+
+	/* H = E(K, 0^128): */
+	_set(g->h, 0, sizeof(g->h));
+	(void) tc_aes_encrypt(g->h, g->h, sched);
+
+	/* the table holds i * H, where bit 3 of i is the coefficient of x^0; it
+	 * starts from H, H * x, H * x^2 and H * x^3 and combines them: */
+	vh = load64_be(g->h);
+	vl = load64_be(g->h + 8);
+	g->hh[0] = g->hl[0] = 0;
+	g->hh[8] = vh;
+	g->hl[8] = vl;
+	for (i = 4; i > 0; i >>= 1) {
+		t = (vl & 1) ? 0xe100000000000000ULL : 0;
+		vl = (vh << 63) | (vl >> 1);
+		vh = (vh >> 1) ^ t;
+		g->hh[i] = vh;
+		g->hl[i] = vl;
+	}
+	for (i = 2; i <= 8; i <<= 1) {
+		for (j = 1; j < i; ++j) {
+			g->hh[i + j] = g->hh[i] ^ g->hh[j];
+			g->hl[i + j] = g->hl[i] ^ g->hl[j];
+		}
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+/*
+ * Computes the pre-counter block j0 from the IV and the GHASH of the
+ * associated data and ciphertext; the tag is the first mlen bytes of
+ * E(K, j0) xor s.
+ */
+static void gcm_j0(const struct tc_gcm_mode_struct *g, uint8_t *j0,
+		   const uint8_t *iv, unsigned int ivlen)
+{
+	uint8_t lengths[TC_AES_BLOCK_SIZE];
+
+	_set(j0, 0, TC_AES_BLOCK_SIZE);
+	if (ivlen == 12) {
+		(void) _copy(j0, TC_AES_BLOCK_SIZE, iv, ivlen);
+		j0[15] = 1;
+	} else {
+		ghash(g, j0, iv, ivlen);
+		_set(lengths, 0, sizeof(lengths));
+		store64_be(lengths + 8, (uint64_t) ivlen * 8);
+		ghash(g, j0, lengths, sizeof(lengths));
+	}
+}
+
+static void gcm_tag(const struct tc_gcm_mode_struct *g, uint8_t *tag,
+		    const uint8_t *j0, const uint8_t *associated_data,
+		    unsigned int alen, const uint8_t *ciphertext,
+		    unsigned int clen)
+{
+	uint8_t s[TC_AES_BLOCK_SIZE];
+	uint8_t lengths[TC_AES_BLOCK_SIZE];
+	unsigned int i;
+
+	_set(s, 0, sizeof(s));
+	ghash(g, s, associated_data, alen);
+	ghash(g, s, ciphertext, clen);
+	store64_be(lengths, (uint64_t) alen * 8);
+	store64_be(lengths + 8, (uint64_t) clen * 8);
+	ghash(g, s, lengths, sizeof(lengths));
+
+	(void) tc_aes_encrypt(tag, j0, g->sched);
+	for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
+		tag[i] ^= s[i];
+	}
+	_set(s, 0, sizeof(s));
+}
+
+/* Increments the 32-bit counter in the last four bytes of a counter block. */
+static void inc32(uint8_t *ctr)
+{
+	int i;
+
+	for (i = 15; i >= 12; --i) {
+		if (++ctr[i] != 0) {
+			break;
+		}
+	}
+}
+
+int tc_gcm_generation_encryption(uint8_t *out, unsigned int olen,
+				 const uint8_t *iv, unsigned int ivlen,
+				 const uint8_t *associated_data,
+				 unsigned int alen, const uint8_t *payload,
+				 unsigned int plen, TCGcmMode_t g)
+{
+	uint8_t j0[TC_AES_BLOCK_SIZE];
+	uint8_t ctr[TC_AES_BLOCK_SIZE];
+	uint8_t tag[TC_AES_BLOCK_SIZE];
+
+	/* input sanity check: */
+	if ((out == (uint8_t *) 0) ||
+	    (g == (TCGcmMode_t) 0) ||
+	    (iv == (const uint8_t *) 0) ||
+	    (ivlen == 0) ||
+	    ((plen > 0) && (payload == (const uint8_t *) 0)) ||
+	    ((alen > 0) && (associated_data == (const uint8_t *) 0)) ||
+	    (plen > UINT32_MAX - g->mlen) ||
+	    (olen < (plen + g->mlen))) {  /* invalid output buffer size */
+		return TC_CRYPTO_FAIL;
+	}
+
+	gcm_j0(g, j0, iv, ivlen);
+
+	/* encrypting the payload in CTR mode from inc32(j0): */
+	if (plen > 0) {
+		(void) _copy(ctr, sizeof(ctr), j0, sizeof(j0));
+		inc32(ctr);
+		(void) tc_ctr_mode(out, plen, payload, plen, ctr, g->sched);
+	}
+
+	gcm_tag(g, tag, j0, associated_data, alen, out, plen);
+	(void) _copy(out + plen, g->mlen, tag, g->mlen);
+	_set(tag, 0, sizeof(tag));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_gcm_decryption_verification(uint8_t *out, unsigned int olen,
+				   const uint8_t *iv, unsigned int ivlen,
+				   const uint8_t *associated_data,
+				   unsigned int alen, const uint8_t *payload,
+				   unsigned int plen, TCGcmMode_t g)
+{
+	uint8_t j0[TC_AES_BLOCK_SIZE];
+	uint8_t ctr[TC_AES_BLOCK_SIZE];
+	uint8_t tag[TC_AES_BLOCK_SIZE];
+	unsigned int clen;
+
+	/* input sanity check: */
+	if ((out == (uint8_t *) 0) ||
+	    (g == (TCGcmMode_t) 0) ||
+	    (iv == (const uint8_t *) 0) ||
+	    (ivlen == 0) ||
+	    (payload == (const uint8_t *) 0) ||
+	    ((alen > 0) && (associated_data == (const uint8_t *) 0)) ||
+	    (plen < g->mlen) || /* no room for the tag */
+	    (olen < plen - g->mlen)) { /* invalid output buffer size */
+		return TC_CRYPTO_FAIL;
+	}
+	clen = plen - g->mlen;
+
+	gcm_j0(g, j0, iv, ivlen);
+
+	/* verifying the tag before releasing any plaintext: */
+	gcm_tag(g, tag, j0, associated_data, alen, payload, clen);
+	if (_compare(tag, payload + clen, g->mlen) != 0) {
+		_set(tag, 0, sizeof(tag));
+		return TC_CRYPTO_FAIL;
+	}
+	_set(tag, 0, sizeof(tag));
+
+	if (clen > 0) {
+		(void) _copy(ctr, sizeof(ctr), j0, sizeof(j0));
+		inc32(ctr);
+		(void) tc_ctr_mode(out, clen, payload, clen, ctr, g->sched);
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
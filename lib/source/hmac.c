@@ -121,6 +121,18 @@ int tc_hmac_update(TCHmacState_t ctx,
 	return TC_CRYPTO_SUCCESS;
 }
 
+int tc_hmac_updatev(TCHmacState_t ctx, const struct tc_iovec *iov,
+		    unsigned int iovcnt)
+{
+
+	/* input sanity check: */
+	if (ctx == (TCHmacState_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	return tc_sha256_updatev(&ctx->hash_state, iov, iovcnt);
+}
+
 int tc_hmac_final(uint8_t *tag, unsigned int taglen, TCHmacState_t ctx)
 {
 
@@ -145,3 +157,81 @@ int tc_hmac_final(uint8_t *tag, unsigned int taglen, TCHmacState_t ctx)
 
 	return TC_CRYPTO_SUCCESS;
 }
+
+int tc_hmac_key_set(TCHmacKey_t key, const uint8_t *k, unsigned int key_size)
+{
+	struct tc_hmac_state_struct ctx;
+
+	/* Input sanity check */
+	if (key == (TCHmacKey_t) 0 ||
+	    tc_hmac_set_key(&ctx, k, key_size) != TC_CRYPTO_SUCCESS) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)tc_sha256_init(&key->inner);
+	(void)tc_sha256_update(&key->inner, ctx.key, TC_SHA256_BLOCK_SIZE);
+	(void)tc_sha256_init(&key->outer);
+	(void)tc_sha256_update(&key->outer, &ctx.key[TC_SHA256_BLOCK_SIZE],
+			       TC_SHA256_BLOCK_SIZE);
+
+	_set(&ctx, 0, sizeof(ctx));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_hmac_key_init(TCSha256State_t s, const struct tc_hmac_key_struct *key)
+{
+
+	/* input sanity check: */
+	if (s == (TCSha256State_t) 0 ||
+	    key == (const struct tc_hmac_key_struct *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	*s = key->inner;
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_hmac_key_final(uint8_t *tag, unsigned int taglen, TCSha256State_t s,
+		      const struct tc_hmac_key_struct *key)
+{
+
+	/* input sanity check: */
+	if (tag == (uint8_t *) 0 ||
+	    taglen != TC_SHA256_DIGEST_SIZE ||
+	    s == (TCSha256State_t) 0 ||
+	    key == (const struct tc_hmac_key_struct *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)tc_sha256_final(tag, s);
+
+	*s = key->outer;
+	(void)tc_sha256_update(s, tag, TC_SHA256_DIGEST_SIZE);
+	(void)tc_sha256_final(tag, s);
+
+	/* destroy the current state */
+	_set(s, 0, sizeof(*s));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_hmac_key_mac(uint8_t *tag, unsigned int taglen, const void *data,
+		    unsigned int data_length,
+		    const struct tc_hmac_key_struct *key)
+{
+	struct tc_sha256_state_struct s;
+
+	/* input sanity check: */
+	if (data == (const void *) 0 && data_length != 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	if (tc_hmac_key_init(&s, key) != TC_CRYPTO_SUCCESS) {
+		return TC_CRYPTO_FAIL;
+	}
+	(void)tc_sha256_update(&s, data, data_length);
+
+	return tc_hmac_key_final(tag, taglen, &s, key);
+}
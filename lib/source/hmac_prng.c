@@ -73,58 +73,58 @@ static const unsigned int MAX_GENS = UINT32_MAX;
 static const unsigned int  MAX_OUT = (1 << 19);
 
 /*
+ * Computes HMAC(key, v || separator || data || additional_data) into out,
+ * starting from the key midstates cached in prng->h. The separator, data and
+ * additional_data are each skipped when NULL.
  * Assumes: prng != NULL
  */
+static void prf(TCHmacPrng_t prng, uint8_t *out, const uint8_t *separator,
+		const uint8_t *data, unsigned int datalen,
+		const uint8_t *additional_data, unsigned int additional_datalen)
+{
+	struct tc_sha256_state_struct s;
+
+	(void)tc_hmac_key_init(&s, &prng->h);
+	(void)tc_sha256_update(&s, prng->v, sizeof(prng->v));
+	if (separator)
+		(void)tc_sha256_update(&s, separator, 1);
+	if (data && datalen)
+		(void)tc_sha256_update(&s, data, datalen);
+	if (additional_data && additional_datalen)
+		(void)tc_sha256_update(&s, additional_data, additional_datalen);
+	(void)tc_hmac_key_final(out, TC_SHA256_DIGEST_SIZE, &s, &prng->h);
+}
+
+/*
+ * Assumes: prng != NULL and prng->h holds the midstates of prng->key
+ */
 static void update(TCHmacPrng_t prng, const uint8_t *data, unsigned int datalen, const uint8_t *additional_data, unsigned int additional_datalen)
 {
 	const uint8_t separator0 = 0x00;
 	const uint8_t separator1 = 0x01;
 
-	/* configure the new prng key into the prng's instance of hmac */
-	tc_hmac_set_key(&prng->h, prng->key, sizeof(prng->key));
-
 	/* use current state, e and separator 0 to compute a new prng key: */
-	(void)tc_hmac_init(&prng->h);
-	(void)tc_hmac_update(&prng->h, prng->v, sizeof(prng->v));
-	(void)tc_hmac_update(&prng->h, &separator0, sizeof(separator0));
-
-	if (data && datalen)
-		(void)tc_hmac_update(&prng->h, data, datalen);
-	if (additional_data && additional_datalen)
-		(void)tc_hmac_update(&prng->h, additional_data, additional_datalen);
-
-	(void)tc_hmac_final(prng->key, sizeof(prng->key), &prng->h);
+	prf(prng, prng->key, &separator0, data, datalen,
+	    additional_data, additional_datalen);
 
 	/* configure the new prng key into the prng's instance of hmac */
-	(void)tc_hmac_set_key(&prng->h, prng->key, sizeof(prng->key));
+	(void)tc_hmac_key_set(&prng->h, prng->key, sizeof(prng->key));
 
 	/* use the new key to compute a new state variable v */
-	(void)tc_hmac_init(&prng->h);
-	(void)tc_hmac_update(&prng->h, prng->v, sizeof(prng->v));
-	(void)tc_hmac_final(prng->v, sizeof(prng->v), &prng->h);
+	prf(prng, prng->v, 0, 0, 0, 0, 0);
 
 	if (data == 0 || datalen == 0)
 		return;
 
-	/* configure the new prng key into the prng's instance of hmac */
-	tc_hmac_set_key(&prng->h, prng->key, sizeof(prng->key));
-
 	/* use current state, e and separator 1 to compute a new prng key: */
-	(void)tc_hmac_init(&prng->h);
-	(void)tc_hmac_update(&prng->h, prng->v, sizeof(prng->v));
-	(void)tc_hmac_update(&prng->h, &separator1, sizeof(separator1));
-	(void)tc_hmac_update(&prng->h, data, datalen);
-	if (additional_data && additional_datalen)
-		(void)tc_hmac_update(&prng->h, additional_data, additional_datalen);
-	(void)tc_hmac_final(prng->key, sizeof(prng->key), &prng->h);
+	prf(prng, prng->key, &separator1, data, datalen,
+	    additional_data, additional_datalen);
 
 	/* configure the new prng key into the prng's instance of hmac */
-	(void)tc_hmac_set_key(&prng->h, prng->key, sizeof(prng->key));
+	(void)tc_hmac_key_set(&prng->h, prng->key, sizeof(prng->key));
 
 	/* use the new key to compute a new state variable v */
-	(void)tc_hmac_init(&prng->h);
-	(void)tc_hmac_update(&prng->h, prng->v, sizeof(prng->v));
-	(void)tc_hmac_final(prng->v, sizeof(prng->v), &prng->h);
+	prf(prng, prng->v, 0, 0, 0, 0, 0);
 }
 
 int tc_hmac_prng_init(TCHmacPrng_t prng,
@@ -142,6 +142,7 @@ int tc_hmac_prng_init(TCHmacPrng_t prng,
 	/* put the generator into a known state: */
 	_set(prng->key, 0x00, sizeof(prng->key));
 	_set(prng->v, 0x01, sizeof(prng->v));
+	(void)tc_hmac_key_set(&prng->h, prng->key, sizeof(prng->key));
 
 	update(prng, personalization, plen, 0, 0);
 
@@ -206,13 +207,8 @@ int tc_hmac_prng_generate(uint8_t *out, unsigned int outlen, TCHmacPrng_t prng)
 	prng->countdown--;
 
 	while (outlen != 0) {
-		/* configure the new prng key into the prng's instance of hmac */
-		tc_hmac_set_key(&prng->h, prng->key, sizeof(prng->key));
-
 		/* operate HMAC in OFB mode to create "random" outputs */
-		(void)tc_hmac_init(&prng->h);
-		(void)tc_hmac_update(&prng->h, prng->v, sizeof(prng->v));
-		(void)tc_hmac_final(prng->v, sizeof(prng->v), &prng->h);
+		prf(prng, prng->v, 0, 0, 0, 0, 0);
 
 		bufferlen = (TC_SHA256_DIGEST_SIZE > outlen) ?
 			outlen : TC_SHA256_DIGEST_SIZE;
@@ -0,0 +1,200 @@
+/* prng_pool.c - TinyCrypt implementation of a pool of per-thread CTR-PRNGs */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/prng_pool.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+#include <string.h>
+
+#define POOL_SEED_SIZE (TC_AES_KEY_SIZE + TC_AES_BLOCK_SIZE)
+
+static unsigned int pool_epoch(const struct tc_prng_pool_struct *pool)
+{
+#if defined(__GNUC__)
+	return __atomic_load_n(&pool->epoch, __ATOMIC_ACQUIRE);
+#else
+	return pool->epoch;
+#endif
+}
+
+/*
+ *  shard_seed -- (re)seeds s from the pool's entropy source and drops its
+ *  buffered output.
+ */
+static int shard_seed(TCPrngShard_t s, int reseed)
+{
+	uint8_t seed[POOL_SEED_SIZE];
+	unsigned int epoch = pool_epoch(s->pool);
+	int r;
+
+	if (!s->pool->entropy(seed, sizeof(seed))) {
+		return TC_CRYPTO_FAIL;
+	}
+	if (reseed) {
+		r = tc_ctr_prng_reseed(&s->prng, seed, sizeof(seed), 0, 0);
+	} else {
+		r = tc_ctr_prng_init(&s->prng, seed, sizeof(seed), 0, 0);
+	}
+	_set_secure(seed, 0, sizeof(seed));
+	_set_secure(s->buffer, 0, sizeof(s->buffer));
+	s->left = 0;
+	s->requests = 0;
+	s->epoch = epoch;
+	return r;
+}
+
+/*
+ *  shard_generate -- one counted request on the shard's CTR-PRNG, reseeding
+ *  first when the interval is used up or the CTR-PRNG demands it.
+ */
+static int shard_generate(TCPrngShard_t s, uint8_t *out, size_t outlen)
+{
+	int r;
+
+	if (s->requests >= TINYCRYPT_PRNG_POOL_RESEED_INTERVAL &&
+	    !shard_seed(s, 1)) {
+		return TC_CRYPTO_FAIL;
+	}
+	s->requests++;
+
+	r = tc_ctr_prng_generate_bulk(&s->prng, 0, 0, out, outlen);
+	if (r == TC_CTR_PRNG_RESEED_REQ) {
+		r = shard_seed(s, 1) &&
+		    tc_ctr_prng_generate_bulk(&s->prng, 0, 0, out, outlen);
+	}
+	return r == TC_CRYPTO_SUCCESS;
+}
+
+int tc_prng_pool_init(TCPrngPool_t pool, struct tc_prng_shard_struct *shards,
+		      unsigned int count, tc_prng_pool_entropy_fn entropy)
+{
+	unsigned int i;
+
+	/* input sanity check: */
+	if (pool == (TCPrngPool_t) 0 ||
+	    shards == (struct tc_prng_shard_struct *) 0 ||
+	    count == 0 ||
+	    entropy == (tc_prng_pool_entropy_fn) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	pool->shard = shards;
+	pool->count = count;
+	pool->entropy = entropy;
+	pool->epoch = 0;
+
+	for (i = 0; i < count; ++i) {
+		_set(&shards[i], 0, sizeof(shards[i]));
+		shards[i].pool = pool;
+		if (!shard_seed(&shards[i], 0)) {
+			tc_prng_pool_uninstantiate(pool);
+			return TC_CRYPTO_FAIL;
+		}
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+TCPrngShard_t tc_prng_pool_shard(TCPrngPool_t pool, unsigned int index)
+{
+	if (pool == (TCPrngPool_t) 0 || index >= pool->count) {
+		return (TCPrngShard_t) 0;
+	}
+	return &pool->shard[index];
+}
+
+int tc_prng_pool_generate(TCPrngShard_t s, uint8_t *out, size_t outlen)
+{
+	/* input sanity check: */
+	if (s == (TCPrngShard_t) 0 ||
+	    s->pool == (struct tc_prng_pool_struct *) 0 ||
+	    out == (uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* a reseed was requested since this shard last reseeded */
+	if (s->epoch != pool_epoch(s->pool) && !shard_seed(s, 1)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	if (outlen > sizeof(s->buffer)) {
+		return shard_generate(s, out, outlen);
+	}
+
+	if (s->left < outlen) {
+		if (!shard_generate(s, s->buffer, sizeof(s->buffer))) {
+			return TC_CRYPTO_FAIL;
+		}
+		s->left = sizeof(s->buffer);
+	}
+	/* hand out the end of the buffer and erase it: */
+	s->left -= outlen;
+	memcpy(out, &s->buffer[s->left], outlen);
+	_set_secure(&s->buffer[s->left], 0, outlen);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+void tc_prng_pool_request_reseed(TCPrngPool_t pool)
+{
+	if (pool != (TCPrngPool_t) 0) {
+#if defined(__GNUC__)
+		(void)__atomic_fetch_add(&pool->epoch, 1U, __ATOMIC_RELEASE);
+#else
+		pool->epoch++;
+#endif
+	}
+}
+
+int tc_prng_pool_rng(void *ctx, uint8_t *dest, unsigned int size)
+{
+	if (size == 0) {
+		return 0;
+	}
+	return tc_prng_pool_generate((TCPrngShard_t) ctx, dest, size);
+}
+
+void tc_prng_pool_uninstantiate(TCPrngPool_t pool)
+{
+	unsigned int i;
+
+	if (pool != (TCPrngPool_t) 0 &&
+	    pool->shard != (struct tc_prng_shard_struct *) 0) {
+		for (i = 0; i < pool->count; ++i) {
+			tc_ctr_prng_uninstantiate(&pool->shard[i].prng);
+			_set_secure(&pool->shard[i], 0, sizeof(pool->shard[i]));
+		}
+		pool->shard = (struct tc_prng_shard_struct *) 0;
+		pool->count = 0;
+	}
+}
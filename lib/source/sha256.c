@@ -33,8 +33,16 @@
 #include <tinycrypt/sha256.h>
 #include <tinycrypt/constants.h>
 #include <tinycrypt/utils.h>
+#if defined(TINYCRYPT_ACCEL)
+#include <tinycrypt/accel.h>
+#endif
+#if defined(TINYCRYPT_SHA256_HW)
+#include <tinycrypt/sha256_hw.h>
+#endif
 
 static void compress(unsigned int *iv, const uint8_t *data);
+static void compress_blocks(unsigned int *iv, const uint8_t *data,
+			    size_t nblocks);
 
 int tc_sha256_init(TCSha256State_t s)
 {
@@ -64,6 +72,8 @@ int tc_sha256_init(TCSha256State_t s)
 
 int tc_sha256_update(TCSha256State_t s, const uint8_t *data, size_t datalen)
 {
+	size_t n;
+
 	/* input sanity check: */
 	if (s == (TCSha256State_t) 0 ||
 	    data == (void *) 0) {
@@ -72,12 +82,58 @@ int tc_sha256_update(TCSha256State_t s, const uint8_t *data, size_t datalen)
 		return TC_CRYPTO_SUCCESS;
 	}
 
-	while (datalen-- > 0) {
-		s->leftover[s->leftover_offset++] = *(data++);
-		if (s->leftover_offset >= TC_SHA256_BLOCK_SIZE) {
-			compress(s->iv, s->leftover);
-			s->leftover_offset = 0;
-			s->bits_hashed += (TC_SHA256_BLOCK_SIZE << 3);
+	/* complete a block left over by a previous call */
+	if (s->leftover_offset > 0) {
+		n = TC_SHA256_BLOCK_SIZE - s->leftover_offset;
+		if (n > datalen) {
+			n = datalen;
+		}
+		(void)_copy(s->leftover + s->leftover_offset, n, data, n);
+		s->leftover_offset += n;
+		data += n;
+		datalen -= n;
+		if (s->leftover_offset < TC_SHA256_BLOCK_SIZE) {
+			return TC_CRYPTO_SUCCESS;
+		}
+		compress_blocks(s->iv, s->leftover, 1);
+		s->leftover_offset = 0;
+		s->bits_hashed += (TC_SHA256_BLOCK_SIZE << 3);
+	}
+
+	/* hash whole blocks straight from the caller's buffer */
+	n = datalen / TC_SHA256_BLOCK_SIZE;
+	if (n > 0) {
+		compress_blocks(s->iv, data, n);
+		s->bits_hashed += ((uint64_t) n * TC_SHA256_BLOCK_SIZE) << 3;
+		data += n * TC_SHA256_BLOCK_SIZE;
+		datalen -= n * TC_SHA256_BLOCK_SIZE;
+	}
+
+	/* buffer the tail */
+	if (datalen > 0) {
+		(void)_copy(s->leftover, datalen, data, datalen);
+		s->leftover_offset = datalen;
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_sha256_updatev(TCSha256State_t s, const struct tc_iovec *iov,
+		      unsigned int iovcnt)
+{
+	unsigned int i;
+
+	/* input sanity check: */
+	if (s == (TCSha256State_t) 0 ||
+	    (iov == (const struct tc_iovec *) 0 && iovcnt != 0)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* the leftover buffer carries a partial block into the next segment */
+	for (i = 0; i < iovcnt; ++i) {
+		if (tc_sha256_update(s, iov[i].base, iov[i].len) !=
+		    TC_CRYPTO_SUCCESS) {
+			return TC_CRYPTO_FAIL;
 		}
 	}
 
@@ -101,7 +157,7 @@ int tc_sha256_final(uint8_t *digest, TCSha256State_t s)
 		/* there is not room for all the padding in this block */
 		_set(s->leftover + s->leftover_offset, 0x00,
 		     sizeof(s->leftover) - s->leftover_offset);
-		compress(s->iv, s->leftover);
+		compress_blocks(s->iv, s->leftover, 1);
 		s->leftover_offset = 0;
 	}
 
@@ -118,7 +174,7 @@ int tc_sha256_final(uint8_t *digest, TCSha256State_t s)
 	s->leftover[sizeof(s->leftover) - 8] = (uint8_t)(s->bits_hashed >> 56);
 
 	/* hash the padding and length */
-	compress(s->iv, s->leftover);
+	compress_blocks(s->iv, s->leftover, 1);
 
 	/* copy the iv out to digest */
 	for (i = 0; i < TC_SHA256_STATE_BLOCKS; ++i) {
@@ -215,3 +271,28 @@ static void compress(unsigned int *iv, const uint8_t *data)
 	iv[0] += a; iv[1] += b; iv[2] += c; iv[3] += d;
 	iv[4] += e; iv[5] += f; iv[6] += g; iv[7] += h;
 }
+
+/*
+ * The input is read a byte at a time by BigEndian, so data needs no
+ * particular alignment.
+ */
+static void compress_blocks(unsigned int *iv, const uint8_t *data,
+			    size_t nblocks)
+{
+#if defined(TINYCRYPT_ACCEL)
+	if (tc_accel_sha256_compress_blocks(iv, data, nblocks)) {
+		return;
+	}
+#endif
+#if defined(TINYCRYPT_SHA256_HW)
+	if (tc_sha256_hw_available()) {
+		(void)tc_sha256_hw_compress_blocks(iv, data, nblocks);
+		return;
+	}
+#endif
+
+	for (; nblocks > 0; --nblocks) {
+		compress(iv, data);
+		data += TC_SHA256_BLOCK_SIZE;
+	}
+}
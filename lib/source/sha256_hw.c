@@ -0,0 +1,199 @@
+/* sha256_hw.c - TinyCrypt implementation of the hardware accelerated SHA-256 compression */
+
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/sha256_hw.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TC_SHA256_HW_X86
+#include <immintrin.h>
+#define TC_SHA256_HW_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+#elif (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2)) && \
+      defined(__ARM_NEON)
+#define TC_SHA256_HW_ARM
+#include <arm_neon.h>
+#endif
+
+#if defined(TC_SHA256_HW_X86) || defined(TC_SHA256_HW_ARM)
+
+/* The round constants K of FIPS 180-4, section 4.2.2. */
+static const unsigned int k256[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+	0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+	0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+	0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+	0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+	0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#endif
+
+#if defined(TC_SHA256_HW_X86)
+
+/*
+ * SHA256RNDS2 keeps the working variables as ABEF and CDGH (most significant
+ * word first), so the chaining value is shuffled into that form on entry and
+ * back on exit. Each step of the loop runs four rounds; the message schedule
+ * is held as four vectors of four words W[4j..4j+3].
+ */
+TC_SHA256_HW_TARGET
+static void compress_blocks(unsigned int *iv, const uint8_t *data,
+			    size_t nblocks)
+{
+	const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+					     0x0405060700010203ULL);
+	__m128i state0, state1, save0, save1, tmp, wk;
+	__m128i w[4];
+	unsigned int i;
+
+	tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) iv), 0xb1);
+	state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) iv + 1),
+				   0x1b);
+	state0 = _mm_alignr_epi8(tmp, state1, 8);	/* ABEF */
+	state1 = _mm_blend_epi16(state1, tmp, 0xf0);	/* CDGH */
+
+	for (; nblocks > 0; --nblocks) {
+		save0 = state0;
+		save1 = state1;
+
+		for (i = 0; i < 16; ++i) {
+			if (i < 4) {
+				w[i] = _mm_shuffle_epi8(_mm_loadu_si128(
+					(const __m128i *) data + i), bswap);
+			} else {
+				tmp = _mm_alignr_epi8(w[(i + 3) & 3],
+						      w[(i + 2) & 3], 4);
+				w[i & 3] = _mm_sha256msg1_epu32(w[i & 3],
+								w[(i + 1) & 3]);
+				w[i & 3] = _mm_add_epi32(w[i & 3], tmp);
+				w[i & 3] = _mm_sha256msg2_epu32(w[i & 3],
+								w[(i + 3) & 3]);
+			}
+			wk = _mm_add_epi32(w[i & 3], _mm_loadu_si128(
+					   (const __m128i *) &k256[4 * i]));
+			state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+			wk = _mm_shuffle_epi32(wk, 0x0e);
+			state0 = _mm_sha256rnds2_epu32(state0, state1, wk);
+		}
+
+		state0 = _mm_add_epi32(state0, save0);
+		state1 = _mm_add_epi32(state1, save1);
+		data += TC_SHA256_BLOCK_SIZE;
+	}
+
+	tmp = _mm_shuffle_epi32(state0, 0x1b);		/* FEBA */
+	state1 = _mm_shuffle_epi32(state1, 0xb1);	/* DCHG */
+	state0 = _mm_blend_epi16(tmp, state1, 0xf0);	/* DCBA */
+	state1 = _mm_alignr_epi8(state1, tmp, 8);	/* HGFE */
+	_mm_storeu_si128((__m128i *) iv, state0);
+	_mm_storeu_si128((__m128i *) iv + 1, state1);
+}
+
+#elif defined(TC_SHA256_HW_ARM)
+
+/*
+ * SHA256H/SHA256H2 run four rounds on the ABCD and EFGH halves of the
+ * working variables; SHA256SU0/SHA256SU1 extend the message schedule four
+ * words at a time.
+ */
+static void compress_blocks(unsigned int *iv, const uint8_t *data,
+			    size_t nblocks)
+{
+	uint32x4_t abcd = vld1q_u32(iv);
+	uint32x4_t efgh = vld1q_u32(iv + 4);
+	uint32x4_t save0, save1, tmp, wk;
+	uint32x4_t w[4];
+	unsigned int i;
+
+	for (; nblocks > 0; --nblocks) {
+		save0 = abcd;
+		save1 = efgh;
+
+		for (i = 0; i < 16; ++i) {
+			if (i < 4) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+				w[i] = vreinterpretq_u32_u8(vld1q_u8(data + 16 * i));
+#else
+				w[i] = vreinterpretq_u32_u8(
+					vrev32q_u8(vld1q_u8(data + 16 * i)));
+#endif
+			} else {
+				w[i & 3] = vsha256su1q_u32(
+					vsha256su0q_u32(w[i & 3], w[(i + 1) & 3]),
+					w[(i + 2) & 3], w[(i + 3) & 3]);
+			}
+			wk = vaddq_u32(w[i & 3], vld1q_u32(&k256[4 * i]));
+			tmp = abcd;
+			abcd = vsha256hq_u32(abcd, efgh, wk);
+			efgh = vsha256h2q_u32(efgh, tmp, wk);
+		}
+
+		abcd = vaddq_u32(abcd, save0);
+		efgh = vaddq_u32(efgh, save1);
+		data += TC_SHA256_BLOCK_SIZE;
+	}
+
+	vst1q_u32(iv, abcd);
+	vst1q_u32(iv + 4, efgh);
+}
+
+#endif
+
+int tc_sha256_hw_available(void)
+{
+#if defined(TC_SHA256_HW_X86) || defined(TC_SHA256_HW_ARM)
+	return (_cpu_features() & TC_CPU_SHA256) != 0;
+#else
+	return 0;
+#endif
+}
+
+int tc_sha256_hw_compress_blocks(unsigned int *iv, const uint8_t *data,
+				 size_t nblocks)
+{
+#if defined(TC_SHA256_HW_X86) || defined(TC_SHA256_HW_ARM)
+	compress_blocks(iv, data, nblocks);
+	return TC_CRYPTO_SUCCESS;
+#else
+	(void) iv;
+	(void) data;
+	(void) nblocks;
+	return TC_CRYPTO_FAIL;
+#endif
+}
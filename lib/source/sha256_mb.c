@@ -0,0 +1,440 @@
+/* sha256_mb.c - TinyCrypt implementation of multi-buffer SHA-256 */
+
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/sha256_mb.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+#include <string.h>
+
+#if defined(__GNUC__)
+#define TC_SHA256_MB_VECTOR
+/* the AVX2 copy of the lanes code doubles its size, so only comes with the
+ * SHA-256 CPU engines */
+#if defined(TINYCRYPT_SHA256_HW) && \
+    (defined(__x86_64__) || defined(__i386__)) && !defined(__AVX2__)
+#define TC_SHA256_MB_AVX2
+#endif
+#endif
+
+#if defined(TC_SHA256_MB_VECTOR)
+
+/*
+ * One 32-bit lane per message. Without AVX2 the compiler splits the vectors
+ * into two SSE2 (or NEON) registers, or into words on other targets.
+ */
+typedef unsigned int lanes_t
+	__attribute__((vector_size(4 * TC_SHA256_MB_LANES)));
+
+/* The round constants K of FIPS 180-4, section 4.2.2. */
+static const unsigned int k256[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+	0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+	0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+	0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+	0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+	0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR(a, n)(((a) >> (n)) | ((a) << (32 - (n))))
+#define Sigma0(a)(ROTR((a), 2) ^ ROTR((a), 13) ^ ROTR((a), 22))
+#define Sigma1(a)(ROTR((a), 6) ^ ROTR((a), 11) ^ ROTR((a), 25))
+#define sigma0(a)(ROTR((a), 7) ^ ROTR((a), 18) ^ ((a) >> 3))
+#define sigma1(a)(ROTR((a), 17) ^ ROTR((a), 19) ^ ((a) >> 10))
+#define Ch(a, b, c)(((a) & (b)) ^ ((~(a)) & (c)))
+#define Maj(a, b, c)(((a) & (b)) ^ ((a) & (c)) ^ ((b) & (c)))
+
+#define ROUND(a, b, c, d, e, f, g, h, j) do { \
+		t1 = (h) + Sigma1(e) + Ch((e), (f), (g)) + k256[i + (j)] + w[(j)]; \
+		(d) += t1; \
+		(h) = t1 + Sigma0(a) + Maj((a), (b), (c)); \
+	} while (0)
+
+static const uint8_t zero_block[TC_SHA256_BLOCK_SIZE];
+
+/*
+ * Compresses one block blk[l] into every chaining value iv[l]; lanes with
+ * nothing to hash point to a scratch chaining value and zero_block.
+ */
+static inline __attribute__((always_inline))
+void compress_lanes_generic(unsigned int *const *iv, const uint8_t *const *blk)
+{
+	lanes_t a, b, c, d, e, f, g, h;
+	lanes_t t1;
+	lanes_t w[16];
+	unsigned int tmp[TC_SHA256_MB_LANES];
+	unsigned int i, j, l;
+	const uint8_t *p;
+
+#define GATHER(v, j) do { \
+		for (l = 0; l < TC_SHA256_MB_LANES; ++l) { \
+			tmp[l] = iv[l][(j)]; \
+		} \
+		(void)memcpy(&(v), tmp, sizeof(tmp)); \
+	} while (0)
+	GATHER(a, 0); GATHER(b, 1); GATHER(c, 2); GATHER(d, 3);
+	GATHER(e, 4); GATHER(f, 5); GATHER(g, 6); GATHER(h, 7);
+#undef GATHER
+
+	for (i = 0; i < 16; ++i) {
+		for (l = 0; l < TC_SHA256_MB_LANES; ++l) {
+			p = blk[l] + 4 * i;
+			tmp[l] = ((unsigned int) p[0] << 24) |
+				 ((unsigned int) p[1] << 16) |
+				 ((unsigned int) p[2] << 8) |
+				 ((unsigned int) p[3]);
+		}
+		(void)memcpy(&w[i], tmp, sizeof(tmp));
+	}
+
+	/*
+	 * Sixteen rounds per iteration, renaming the working variables instead
+	 * of moving them, with the next sixteen schedule words computed first.
+	 */
+	for (i = 0; i < 64; i += 16) {
+		if (i > 0) {
+			for (j = 0; j < 16; ++j) {
+				w[j] += sigma0(w[(j + 1) & 0xf]) +
+					sigma1(w[(j + 14) & 0xf]) +
+					w[(j + 9) & 0xf];
+			}
+		}
+		ROUND(a, b, c, d, e, f, g, h, 0);
+		ROUND(h, a, b, c, d, e, f, g, 1);
+		ROUND(g, h, a, b, c, d, e, f, 2);
+		ROUND(f, g, h, a, b, c, d, e, 3);
+		ROUND(e, f, g, h, a, b, c, d, 4);
+		ROUND(d, e, f, g, h, a, b, c, 5);
+		ROUND(c, d, e, f, g, h, a, b, 6);
+		ROUND(b, c, d, e, f, g, h, a, 7);
+		ROUND(a, b, c, d, e, f, g, h, 8);
+		ROUND(h, a, b, c, d, e, f, g, 9);
+		ROUND(g, h, a, b, c, d, e, f, 10);
+		ROUND(f, g, h, a, b, c, d, e, 11);
+		ROUND(e, f, g, h, a, b, c, d, 12);
+		ROUND(d, e, f, g, h, a, b, c, 13);
+		ROUND(c, d, e, f, g, h, a, b, 14);
+		ROUND(b, c, d, e, f, g, h, a, 15);
+	}
+
+#define SCATTER(v, j) do { \
+		(void)memcpy(tmp, &(v), sizeof(tmp)); \
+		for (l = 0; l < TC_SHA256_MB_LANES; ++l) { \
+			iv[l][(j)] += tmp[l]; \
+		} \
+	} while (0)
+	SCATTER(a, 0); SCATTER(b, 1); SCATTER(c, 2); SCATTER(d, 3);
+	SCATTER(e, 4); SCATTER(f, 5); SCATTER(g, 6); SCATTER(h, 7);
+#undef SCATTER
+
+	/* the schedule holds message words: */
+	_set(w, 0, sizeof(w));
+}
+
+#if defined(TC_SHA256_MB_AVX2)
+__attribute__((target("avx2")))
+static void compress_lanes_avx2(unsigned int *const *iv,
+				const uint8_t *const *blk)
+{
+	compress_lanes_generic(iv, blk);
+}
+#endif
+
+static void compress_lanes(unsigned int *const *iv, const uint8_t *const *blk)
+{
+#if defined(TC_SHA256_MB_AVX2)
+	if (_cpu_features() & TC_CPU_AVX2) {
+		compress_lanes_avx2(iv, blk);
+		return;
+	}
+#endif
+	compress_lanes_generic(iv, blk);
+}
+
+/* A context being hashed in one lane by tc_sha256_mb_update. */
+struct lane {
+	TCSha256State_t s;	/* NULL when the lane is idle */
+	const uint8_t *data;
+	size_t datalen;
+	int full_leftover;	/* s->leftover holds a whole block */
+};
+
+/*
+ * Tops up the leftover block of s and makes l hash s if there is at least
+ * one whole block; otherwise buffers the data and leaves l idle.
+ */
+static void lane_start(struct lane *l, TCSha256State_t s,
+		       const uint8_t *data, size_t datalen)
+{
+	size_t n;
+
+	l->full_leftover = 0;
+	if (s->leftover_offset > 0) {
+		n = TC_SHA256_BLOCK_SIZE - s->leftover_offset;
+		if (n > datalen) {
+			n = datalen;
+		}
+		(void)_copy(s->leftover + s->leftover_offset, n, data, n);
+		s->leftover_offset += n;
+		data += n;
+		datalen -= n;
+		l->full_leftover = (s->leftover_offset == TC_SHA256_BLOCK_SIZE);
+	}
+
+	if (l->full_leftover || datalen >= TC_SHA256_BLOCK_SIZE) {
+		l->s = s;
+		l->data = data;
+		l->datalen = datalen;
+	} else {
+		(void)_copy(s->leftover + s->leftover_offset, datalen, data,
+			    datalen);
+		s->leftover_offset += datalen;
+		l->s = (TCSha256State_t) 0;
+	}
+}
+
+/* Accounts for the block just hashed by l; l becomes idle when done. */
+static void lane_advance(struct lane *l)
+{
+	TCSha256State_t s = l->s;
+
+	s->bits_hashed += (TC_SHA256_BLOCK_SIZE << 3);
+	if (l->full_leftover) {
+		l->full_leftover = 0;
+		s->leftover_offset = 0;
+	} else {
+		l->data += TC_SHA256_BLOCK_SIZE;
+		l->datalen -= TC_SHA256_BLOCK_SIZE;
+	}
+
+	if (l->datalen < TC_SHA256_BLOCK_SIZE) {
+		(void)_copy(s->leftover, l->datalen, l->data, l->datalen);
+		s->leftover_offset = l->datalen;
+		l->s = (TCSha256State_t) 0;
+	}
+}
+
+#endif
+
+int tc_sha256_mb_update(struct tc_sha256_state_struct *s,
+			const uint8_t *const *data, const size_t *datalen,
+			unsigned int count)
+{
+	unsigned int i;
+
+	/* input sanity check: */
+	if (s == (TCSha256State_t) 0 ||
+	    data == (const uint8_t *const *) 0 ||
+	    datalen == (const size_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	for (i = 0; i < count; ++i) {
+		if (data[i] == (const uint8_t *) 0) {
+			return TC_CRYPTO_FAIL;
+		}
+	}
+
+#if defined(TC_SHA256_MB_VECTOR)
+	{
+		struct lane lanes[TC_SHA256_MB_LANES];
+		unsigned int *iv[TC_SHA256_MB_LANES];
+		const uint8_t *blk[TC_SHA256_MB_LANES];
+		unsigned int scratch[TC_SHA256_STATE_BLOCKS];
+		unsigned int active;
+		unsigned int l;
+
+		for (l = 0; l < TC_SHA256_MB_LANES; ++l) {
+			lanes[l].s = (TCSha256State_t) 0;
+		}
+		/* idle lanes hash into scratch, which must be defined */
+		_set(scratch, 0, sizeof(scratch));
+
+		for (i = 0; ; ) {
+			/* hand the next contexts to the idle lanes */
+			active = 0;
+			for (l = 0; l < TC_SHA256_MB_LANES; ++l) {
+				while (lanes[l].s == (TCSha256State_t) 0 &&
+				       i < count) {
+					lane_start(&lanes[l], &s[i], data[i],
+						   datalen[i]);
+					++i;
+				}
+				if (lanes[l].s == (TCSha256State_t) 0) {
+					iv[l] = scratch;
+					blk[l] = zero_block;
+				} else if (lanes[l].full_leftover) {
+					iv[l] = lanes[l].s->iv;
+					blk[l] = lanes[l].s->leftover;
+					++active;
+				} else {
+					iv[l] = lanes[l].s->iv;
+					blk[l] = lanes[l].data;
+					++active;
+				}
+			}
+			if (active == 0) {
+				break;
+			}
+
+			compress_lanes(iv, blk);
+
+			for (l = 0; l < TC_SHA256_MB_LANES; ++l) {
+				if (lanes[l].s != (TCSha256State_t) 0) {
+					lane_advance(&lanes[l]);
+				}
+			}
+		}
+	}
+#else
+	for (i = 0; i < count; ++i) {
+		(void)tc_sha256_update(&s[i], data[i], datalen[i]);
+	}
+#endif
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+#if defined(TC_SHA256_MB_VECTOR)
+/* Appends the message length, in big-endian format, to the leftover block. */
+static void put_length(TCSha256State_t s)
+{
+	unsigned int i;
+
+	for (i = 1; i <= 8; ++i) {
+		s->leftover[sizeof(s->leftover) - i] =
+			(uint8_t)(s->bits_hashed >> (8 * (i - 1)));
+	}
+}
+#endif
+
+int tc_sha256_mb_final(uint8_t *const *digest,
+		       struct tc_sha256_state_struct *s, unsigned int count)
+{
+	unsigned int i;
+
+	/* input sanity check: */
+	if (digest == (uint8_t *const *) 0 ||
+	    s == (TCSha256State_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	for (i = 0; i < count; ++i) {
+		if (digest[i] == (uint8_t *) 0) {
+			return TC_CRYPTO_FAIL;
+		}
+	}
+
+#if defined(TC_SHA256_MB_VECTOR)
+	{
+		unsigned int *iv[TC_SHA256_MB_LANES];
+		const uint8_t *blk[TC_SHA256_MB_LANES];
+		unsigned int scratch[TC_SHA256_STATE_BLOCKS];
+		int two_blocks[TC_SHA256_MB_LANES];
+		TCSha256State_t t;
+		unsigned int any;
+		unsigned int n;
+		unsigned int l;
+		unsigned int j;
+
+		/* idle lanes hash into scratch, which must be defined */
+		_set(scratch, 0, sizeof(scratch));
+		for (i = 0; i < count; i += n) {
+			n = count - i;
+			if (n > TC_SHA256_MB_LANES) {
+				n = TC_SHA256_MB_LANES;
+			}
+
+			/* pad; some messages need a block for the length */
+			any = 0;
+			for (l = 0; l < TC_SHA256_MB_LANES; ++l) {
+				iv[l] = scratch;
+				blk[l] = zero_block;
+				two_blocks[l] = 0;
+				if (l >= n) {
+					continue;
+				}
+				t = &s[i + l];
+				t->bits_hashed += (t->leftover_offset << 3);
+				t->leftover[t->leftover_offset++] = 0x80;
+				if (t->leftover_offset > (sizeof(t->leftover) - 8)) {
+					_set(t->leftover + t->leftover_offset, 0x00,
+					     sizeof(t->leftover) - t->leftover_offset);
+					iv[l] = t->iv;
+					blk[l] = t->leftover;
+					two_blocks[l] = 1;
+					any = 1;
+				}
+			}
+			if (any) {
+				compress_lanes(iv, blk);
+			}
+
+			/* hash the padding and length */
+			for (l = 0; l < n; ++l) {
+				t = &s[i + l];
+				if (two_blocks[l]) {
+					t->leftover_offset = 0;
+				}
+				_set(t->leftover + t->leftover_offset, 0x00,
+				     sizeof(t->leftover) - 8 - t->leftover_offset);
+				put_length(t);
+				iv[l] = t->iv;
+				blk[l] = t->leftover;
+			}
+			compress_lanes(iv, blk);
+
+			/* copy the iv out to digest and destroy the state */
+			for (l = 0; l < n; ++l) {
+				t = &s[i + l];
+				for (j = 0; j < TC_SHA256_STATE_BLOCKS; ++j) {
+					digest[i + l][4 * j] = (uint8_t)(t->iv[j] >> 24);
+					digest[i + l][4 * j + 1] = (uint8_t)(t->iv[j] >> 16);
+					digest[i + l][4 * j + 2] = (uint8_t)(t->iv[j] >> 8);
+					digest[i + l][4 * j + 3] = (uint8_t)(t->iv[j]);
+				}
+				_set(t, 0, sizeof(*t));
+			}
+		}
+	}
+#else
+	for (i = 0; i < count; ++i) {
+		(void)tc_sha256_final(digest[i], &s[i]);
+	}
+#endif
+
+	return TC_CRYPTO_SUCCESS;
+}
@@ -35,6 +35,14 @@
 
 #include <string.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define TC_CPUID_X86
+#elif defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#define TC_HWCAP_AARCH64
+#endif
+
 #define MASK_TWENTY_SEVEN 0x1b
 
 unsigned int _copy(uint8_t *to, unsigned int to_len,
@@ -48,9 +56,23 @@ unsigned int _copy(uint8_t *to, unsigned int to_len,
 	}
 }
 
+#if !defined(__GNUC__)
+/*
+ * Without the compiler barrier, memset is called through a volatile pointer,
+ * which the compiler cannot assume to be memset, so a clear of a buffer that
+ * is dead afterwards is not removed (e.g. by whole-program optimization).
+ */
+static void *(*volatile const memset_v)(void *, int, size_t) = memset;
+#endif
+
 void _set(void *to, uint8_t val, unsigned int len)
 {
+#if defined(__GNUC__)
 	(void)memset(to, val, len);
+	__asm__ __volatile__("" :: "g"(to) : "memory");
+#else
+	(void)memset_v(to, val, len);
+#endif
 }
 
 /*
@@ -63,12 +85,102 @@ uint8_t _double_byte(uint8_t a)
 
 int _compare(const uint8_t *a, const uint8_t *b, size_t size)
 {
-	const uint8_t *tempa = a;
-	const uint8_t *tempb = b;
-	uint8_t result = 0;
+	uint64_t wa, wb, acc = 0;
+	size_t i = 0;
+
+	/*
+	 * One byte lane per byte position: the result folds down to the OR of
+	 * the xor of every byte pair, as a byte loop would give.
+	 */
+	for (; i + sizeof(acc) <= size; i += sizeof(acc)) {
+		(void)memcpy(&wa, a + i, sizeof(wa));
+		(void)memcpy(&wb, b + i, sizeof(wb));
+		acc |= wa ^ wb;
+	}
+	for (; i < size; i++) {
+		acc |= (uint64_t)(a[i] ^ b[i]);
+	}
+	acc |= acc >> 32;
+	acc |= acc >> 16;
+	acc |= acc >> 8;
+	return (int)(acc & 0xff);
+}
+
+#if defined(TC_CPUID_X86)
+static unsigned int xgetbv0(void)
+{
+	unsigned int lo, hi;
+
+	__asm__ volatile ("xgetbv" : "=a" (lo), "=d" (hi) : "c" (0));
+	(void)hi;
+	return lo;
+}
+#endif
+
+static unsigned int detect_cpu_features(void)
+{
+	unsigned int features = 0;
+#if defined(TC_CPUID_X86)
+	unsigned int eax, ebx, ecx, edx;
+
+	if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+		/* AES-NI (ecx bit 25) is used together with SSSE3 (ecx bit 9): */
+		if ((ecx & (1 << 25)) && (ecx & (1 << 9))) {
+			features |= TC_CPU_AES;
+		}
+		/* PCLMULQDQ (ecx bit 1) is likewise used with SSSE3: */
+		if ((ecx & (1 << 1)) && (ecx & (1 << 9))) {
+			features |= TC_CPU_CLMUL;
+		}
+		/* SHA (leaf 7 ebx bit 29) with SSSE3 and SSE4.1 (ecx bit 19): */
+		if ((ecx & (1 << 9)) && (ecx & (1 << 19)) &&
+		    __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) &&
+		    (ebx & (1 << 29))) {
+			features |= TC_CPU_SHA256;
+		}
+	}
+	/* AVX2 (leaf 7 ebx bit 5) needs OSXSAVE (ecx bit 27) and the xmm and
+	 * ymm state enabled in XCR0: */
+	if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & (1 << 27)) &&
+	    (xgetbv0() & 0x6) == 0x6 &&
+	    __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) &&
+	    (ebx & (1 << 5))) {
+		features |= TC_CPU_AVX2;
+	}
+#elif defined(TC_HWCAP_AARCH64)
+	unsigned long hwcap = getauxval(AT_HWCAP);
+
+	if (hwcap & (1 << 3)) { /* HWCAP_AES */
+		features |= TC_CPU_AES;
+	}
+	if (hwcap & (1 << 4)) { /* HWCAP_PMULL */
+		features |= TC_CPU_CLMUL;
+	}
+	if (hwcap & (1 << 6)) { /* HWCAP_SHA2 */
+		features |= TC_CPU_SHA256;
+	}
+#else
+	/* no run-time detection available: trust the build configuration */
+#if defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES)
+	features |= TC_CPU_AES | TC_CPU_CLMUL;
+#endif
+#if defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2)
+	features |= TC_CPU_SHA256;
+#endif
+#endif
+	return features;
+}
+
+unsigned int _cpu_features(void)
+{
+	/* bit 31 marks the cached value as valid; detection is idempotent, so a
+	 * concurrent first call at worst repeats it */
+	static volatile unsigned int cached = 0;
+	unsigned int features = cached;
 
-	for (unsigned int i = 0; i < size; i++) {
-		result |= tempa[i] ^ tempb[i];
+	if (features == 0) {
+		features = detect_cpu_features() | (1u << 31);
+		cached = features;
 	}
-	return result;
+	return features & ~(1u << 31);
 }
@@ -0,0 +1,454 @@
+/* x25519.c - TinyCrypt implementation of X25519 key agreement */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/x25519.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+/*
+ * Field elements modulo p = 2^255 - 19 are little-endian arrays of FE_LIMBS
+ * unsigned limbs, limb i holding FE_WIDTH(i) bits in reduced form. Additions
+ * and subtractions leave the carries in the limbs (subtraction adds 2p first
+ * so that nothing goes negative); multiplications fold the part above 2^255
+ * back with 2^255 = 19 (mod p) and carry, so every limb is back to a little
+ * over its width. Only fe_tobytes() reduces fully.
+ *
+ * TINYCRYPT_X25519_RADIX51 set to 1 uses 5 limbs of 51 bits and 64x64->128
+ * bit products, which needs unsigned __int128; set to 0 it uses 10 limbs of
+ * 26 and 25 bits (radix 2^25.5) and 32x32->64 bit products, which suits 32-bit
+ * cores. By default the former is used wherever the compiler has the type.
+ */
+#ifndef TINYCRYPT_X25519_RADIX51
+#if defined(__SIZEOF_INT128__)
+#define TINYCRYPT_X25519_RADIX51 1
+#else
+#define TINYCRYPT_X25519_RADIX51 0
+#endif
+#endif
+
+#if TINYCRYPT_X25519_RADIX51
+#define FE_LIMBS 5
+#define FE_WIDTH(i) 51
+typedef uint64_t fe_limb;
+typedef unsigned __int128 fe_wide;
+#else
+#define FE_LIMBS 10
+#define FE_WIDTH(i) (26 - ((i) & 1))
+typedef uint32_t fe_limb;
+typedef uint64_t fe_wide;
+#endif
+
+#define FE_MASK(i) (((fe_limb)1 << FE_WIDTH(i)) - 1)
+
+typedef fe_limb fe[FE_LIMBS];
+
+/* (A - 2) / 4 for the Curve25519 coefficient A = 486662 */
+#define X25519_A24 121665
+
+static const uint8_t x25519_base[TC_X25519_KEY_SIZE] = { 9 };
+
+/* Carry the double-width limbs t into h, folding the top carry into h[0]. */
+static void fe_reduce(fe h, fe_wide *t)
+{
+	fe_wide c = 0;
+	unsigned int i;
+
+	for (i = 0; i < FE_LIMBS; ++i) {
+		t[i] += c;
+		c = t[i] >> FE_WIDTH(i);
+		h[i] = (fe_limb)t[i] & FE_MASK(i);
+	}
+	c = h[0] + 19 * c;
+	h[0] = (fe_limb)c & FE_MASK(0);
+	h[1] += (fe_limb)(c >> FE_WIDTH(0));
+}
+
+static void fe_carry(fe h)
+{
+	fe_wide t[FE_LIMBS];
+	unsigned int i;
+
+	for (i = 0; i < FE_LIMBS; ++i) {
+		t[i] = h[i];
+	}
+	fe_reduce(h, t);
+}
+
+static void fe_add(fe h, const fe f, const fe g)
+{
+	unsigned int i;
+
+	for (i = 0; i < FE_LIMBS; ++i) {
+		h[i] = f[i] + g[i];
+	}
+}
+
+/* g must be carried (the output of a multiplication or of fe_frombytes). */
+static void fe_sub(fe h, const fe f, const fe g)
+{
+	unsigned int i;
+
+	/* limbs of 2p = 2^256 - 38 */
+	for (i = 0; i < FE_LIMBS; ++i) {
+		h[i] = f[i] + 2 * FE_MASK(i) - (i == 0 ? 36 : 0) - g[i];
+	}
+}
+
+#if TINYCRYPT_X25519_RADIX51
+static void fe_mul(fe h, const fe f, const fe g)
+{
+	fe_wide t[FE_LIMBS];
+	fe_limb g1 = 19 * g[1], g2 = 19 * g[2], g3 = 19 * g[3], g4 = 19 * g[4];
+
+	t[0] = (fe_wide)f[0] * g[0] + (fe_wide)f[1] * g4 +
+	       (fe_wide)f[2] * g3 + (fe_wide)f[3] * g2 + (fe_wide)f[4] * g1;
+	t[1] = (fe_wide)f[0] * g[1] + (fe_wide)f[1] * g[0] +
+	       (fe_wide)f[2] * g4 + (fe_wide)f[3] * g3 + (fe_wide)f[4] * g2;
+	t[2] = (fe_wide)f[0] * g[2] + (fe_wide)f[1] * g[1] +
+	       (fe_wide)f[2] * g[0] + (fe_wide)f[3] * g4 + (fe_wide)f[4] * g3;
+	t[3] = (fe_wide)f[0] * g[3] + (fe_wide)f[1] * g[2] +
+	       (fe_wide)f[2] * g[1] + (fe_wide)f[3] * g[0] + (fe_wide)f[4] * g4;
+	t[4] = (fe_wide)f[0] * g[4] + (fe_wide)f[1] * g[3] +
+	       (fe_wide)f[2] * g[2] + (fe_wide)f[3] * g[1] + (fe_wide)f[4] * g[0];
+	fe_reduce(h, t);
+}
+
+static void fe_sq(fe h, const fe f)
+{
+	fe_wide t[FE_LIMBS];
+	fe_limb f0_2 = 2 * f[0], f1_2 = 2 * f[1];
+	fe_limb f3_19 = 19 * f[3], f4_19 = 19 * f[4];
+
+	t[0] = (fe_wide)f[0] * f[0] + (fe_wide)(2 * f[1]) * f4_19 +
+	       (fe_wide)(2 * f[2]) * f3_19;
+	t[1] = (fe_wide)f0_2 * f[1] + (fe_wide)(2 * f[2]) * f4_19 +
+	       (fe_wide)f[3] * f3_19;
+	t[2] = (fe_wide)f0_2 * f[2] + (fe_wide)f[1] * f[1] +
+	       (fe_wide)(2 * f[3]) * f4_19;
+	t[3] = (fe_wide)f0_2 * f[3] + (fe_wide)f1_2 * f[2] +
+	       (fe_wide)f[4] * f4_19;
+	t[4] = (fe_wide)f0_2 * f[4] + (fe_wide)f1_2 * f[3] +
+	       (fe_wide)f[2] * f[2];
+	fe_reduce(h, t);
+}
+#else
+/*
+ * Limb i starts at bit ceil(25.5 * i), so the product of two odd limbs lands
+ * one bit above the start of limb i + j and is doubled; limbs i + j >= 10
+ * wrap around to i + j - 10 times 19.
+ */
+static void fe_mul(fe h, const fe f, const fe g)
+{
+	fe_wide t[FE_LIMBS];
+	fe_limb f1_2 = 2 * f[1], f3_2 = 2 * f[3], f5_2 = 2 * f[5];
+	fe_limb f7_2 = 2 * f[7], f9_2 = 2 * f[9];
+	fe_limb g1_19 = 19 * g[1], g2_19 = 19 * g[2], g3_19 = 19 * g[3];
+	fe_limb g4_19 = 19 * g[4], g5_19 = 19 * g[5], g6_19 = 19 * g[6];
+	fe_limb g7_19 = 19 * g[7], g8_19 = 19 * g[8], g9_19 = 19 * g[9];
+
+	t[0] = (fe_wide)f[0] * g[0] + (fe_wide)f1_2 * g9_19 +
+	       (fe_wide)f[2] * g8_19 + (fe_wide)f3_2 * g7_19 +
+	       (fe_wide)f[4] * g6_19 + (fe_wide)f5_2 * g5_19 +
+	       (fe_wide)f[6] * g4_19 + (fe_wide)f7_2 * g3_19 +
+	       (fe_wide)f[8] * g2_19 + (fe_wide)f9_2 * g1_19;
+	t[1] = (fe_wide)f[0] * g[1] + (fe_wide)f[1] * g[0] +
+	       (fe_wide)f[2] * g9_19 + (fe_wide)f[3] * g8_19 +
+	       (fe_wide)f[4] * g7_19 + (fe_wide)f[5] * g6_19 +
+	       (fe_wide)f[6] * g5_19 + (fe_wide)f[7] * g4_19 +
+	       (fe_wide)f[8] * g3_19 + (fe_wide)f[9] * g2_19;
+	t[2] = (fe_wide)f[0] * g[2] + (fe_wide)f1_2 * g[1] +
+	       (fe_wide)f[2] * g[0] + (fe_wide)f3_2 * g9_19 +
+	       (fe_wide)f[4] * g8_19 + (fe_wide)f5_2 * g7_19 +
+	       (fe_wide)f[6] * g6_19 + (fe_wide)f7_2 * g5_19 +
+	       (fe_wide)f[8] * g4_19 + (fe_wide)f9_2 * g3_19;
+	t[3] = (fe_wide)f[0] * g[3] + (fe_wide)f[1] * g[2] +
+	       (fe_wide)f[2] * g[1] + (fe_wide)f[3] * g[0] +
+	       (fe_wide)f[4] * g9_19 + (fe_wide)f[5] * g8_19 +
+	       (fe_wide)f[6] * g7_19 + (fe_wide)f[7] * g6_19 +
+	       (fe_wide)f[8] * g5_19 + (fe_wide)f[9] * g4_19;
+	t[4] = (fe_wide)f[0] * g[4] + (fe_wide)f1_2 * g[3] +
+	       (fe_wide)f[2] * g[2] + (fe_wide)f3_2 * g[1] +
+	       (fe_wide)f[4] * g[0] + (fe_wide)f5_2 * g9_19 +
+	       (fe_wide)f[6] * g8_19 + (fe_wide)f7_2 * g7_19 +
+	       (fe_wide)f[8] * g6_19 + (fe_wide)f9_2 * g5_19;
+	t[5] = (fe_wide)f[0] * g[5] + (fe_wide)f[1] * g[4] +
+	       (fe_wide)f[2] * g[3] + (fe_wide)f[3] * g[2] +
+	       (fe_wide)f[4] * g[1] + (fe_wide)f[5] * g[0] +
+	       (fe_wide)f[6] * g9_19 + (fe_wide)f[7] * g8_19 +
+	       (fe_wide)f[8] * g7_19 + (fe_wide)f[9] * g6_19;
+	t[6] = (fe_wide)f[0] * g[6] + (fe_wide)f1_2 * g[5] +
+	       (fe_wide)f[2] * g[4] + (fe_wide)f3_2 * g[3] +
+	       (fe_wide)f[4] * g[2] + (fe_wide)f5_2 * g[1] +
+	       (fe_wide)f[6] * g[0] + (fe_wide)f7_2 * g9_19 +
+	       (fe_wide)f[8] * g8_19 + (fe_wide)f9_2 * g7_19;
+	t[7] = (fe_wide)f[0] * g[7] + (fe_wide)f[1] * g[6] +
+	       (fe_wide)f[2] * g[5] + (fe_wide)f[3] * g[4] +
+	       (fe_wide)f[4] * g[3] + (fe_wide)f[5] * g[2] +
+	       (fe_wide)f[6] * g[1] + (fe_wide)f[7] * g[0] +
+	       (fe_wide)f[8] * g9_19 + (fe_wide)f[9] * g8_19;
+	t[8] = (fe_wide)f[0] * g[8] + (fe_wide)f1_2 * g[7] +
+	       (fe_wide)f[2] * g[6] + (fe_wide)f3_2 * g[5] +
+	       (fe_wide)f[4] * g[4] + (fe_wide)f5_2 * g[3] +
+	       (fe_wide)f[6] * g[2] + (fe_wide)f7_2 * g[1] +
+	       (fe_wide)f[8] * g[0] + (fe_wide)f9_2 * g9_19;
+	t[9] = (fe_wide)f[0] * g[9] + (fe_wide)f[1] * g[8] +
+	       (fe_wide)f[2] * g[7] + (fe_wide)f[3] * g[6] +
+	       (fe_wide)f[4] * g[5] + (fe_wide)f[5] * g[4] +
+	       (fe_wide)f[6] * g[3] + (fe_wide)f[7] * g[2] +
+	       (fe_wide)f[8] * g[1] + (fe_wide)f[9] * g[0];
+	fe_reduce(h, t);
+}
+
+static void fe_sq(fe h, const fe f)
+{
+	fe_mul(h, f, f);
+}
+#endif
+
+static void fe_sqn(fe h, const fe f, unsigned int n)
+{
+	fe_sq(h, f);
+	while (--n) {
+		fe_sq(h, h);
+	}
+}
+
+static void fe_mul_a24(fe h, const fe f)
+{
+	fe_wide t[FE_LIMBS];
+	unsigned int i;
+
+	for (i = 0; i < FE_LIMBS; ++i) {
+		t[i] = (fe_wide)f[i] * X25519_A24;
+	}
+	fe_reduce(h, t);
+}
+
+/* h = z^(p - 2) = 1 / z, with the usual chain of 254 squarings */
+static void fe_invert(fe h, const fe z)
+{
+	fe z2, z9, z11, z2_5_0, z2_10_0, z2_50_0, t, u;
+
+	fe_sq(z2, z);
+	fe_sqn(t, z2, 2);
+	fe_mul(z9, t, z);
+	fe_mul(z11, z9, z2);
+	fe_sq(t, z11);
+	fe_mul(z2_5_0, t, z9);		/* 2^5 - 1 */
+	fe_sqn(t, z2_5_0, 5);
+	fe_mul(z2_10_0, t, z2_5_0);	/* 2^10 - 1 */
+	fe_sqn(t, z2_10_0, 10);
+	fe_mul(u, t, z2_10_0);		/* 2^20 - 1 */
+	fe_sqn(t, u, 20);
+	fe_mul(t, t, u);		/* 2^40 - 1 */
+	fe_sqn(t, t, 10);
+	fe_mul(z2_50_0, t, z2_10_0);	/* 2^50 - 1 */
+	fe_sqn(t, z2_50_0, 50);
+	fe_mul(u, t, z2_50_0);		/* 2^100 - 1 */
+	fe_sqn(t, u, 100);
+	fe_mul(t, t, u);		/* 2^200 - 1 */
+	fe_sqn(t, t, 50);
+	fe_mul(t, t, z2_50_0);		/* 2^250 - 1 */
+	fe_sqn(t, t, 5);
+	fe_mul(h, t, z11);		/* 2^255 - 21 */
+}
+
+/* Bit 255 of s is ignored, as RFC 7748 asks for u coordinates. */
+static void fe_frombytes(fe h, const uint8_t *s)
+{
+	unsigned int i, b, pos = 0;
+
+	for (i = 0; i < FE_LIMBS; ++i) {
+		h[i] = 0;
+		for (b = 0; b < FE_WIDTH(i); ++b, ++pos) {
+			h[i] |= (fe_limb)((s[pos >> 3] >> (pos & 7)) & 1) << b;
+		}
+	}
+}
+
+static void fe_tobytes(uint8_t *s, const fe f)
+{
+	fe h;
+	fe_limb q;
+	unsigned int i, b, pos = 0;
+
+	for (i = 0; i < FE_LIMBS; ++i) {
+		h[i] = f[i];
+	}
+	fe_carry(h);
+
+	/* h < 2p now; q = 1 iff h >= p, i.e. h + 19 >= 2^255 */
+	q = (h[0] + 19) >> FE_WIDTH(0);
+	for (i = 1; i < FE_LIMBS; ++i) {
+		q = (h[i] + q) >> FE_WIDTH(i);
+	}
+	/* subtract q * p: add 19 * q and drop bit 255 */
+	h[0] += 19 * q;
+	for (i = 0; i < FE_LIMBS - 1; ++i) {
+		h[i + 1] += h[i] >> FE_WIDTH(i);
+		h[i] &= FE_MASK(i);
+	}
+	h[FE_LIMBS - 1] &= FE_MASK(FE_LIMBS - 1);
+
+	_set(s, 0, TC_X25519_KEY_SIZE);
+	for (i = 0; i < FE_LIMBS; ++i) {
+		for (b = 0; b < FE_WIDTH(i); ++b, ++pos) {
+			s[pos >> 3] |= (uint8_t)(((h[i] >> b) & 1) << (pos & 7));
+		}
+	}
+}
+
+/* Swap f and g if swap is 1, leave them if it is 0, in constant time. */
+static void fe_cswap(fe f, fe g, fe_limb swap)
+{
+	fe_limb mask = 0 - swap, x;
+	unsigned int i;
+
+	for (i = 0; i < FE_LIMBS; ++i) {
+		x = mask & (f[i] ^ g[i]);
+		f[i] ^= x;
+		g[i] ^= x;
+	}
+}
+
+/*
+ * Montgomery ladder of RFC 7748, section 5: (x2 : z2) and (x3 : z3) hold
+ * k' * P and (k' + 1) * P for the leading bits k' of the scalar.
+ */
+static void x25519_ladder(uint8_t *out, const uint8_t *k, const uint8_t *u)
+{
+	fe x1, x2, z2, x3, z3, a, b, c, d, e, aa, bb;
+	fe_limb swap = 0, bit;
+	int t;
+
+	fe_frombytes(x1, u);
+	_set(x2, 0, sizeof(x2));
+	_set(z2, 0, sizeof(z2));
+	_set(z3, 0, sizeof(z3));
+	x2[0] = 1;
+	z3[0] = 1;
+	_set(x3, 0, sizeof(x3));
+	fe_add(x3, x3, x1);
+
+	for (t = 254; t >= 0; --t) {
+		bit = (k[t >> 3] >> (t & 7)) & 1;
+		swap ^= bit;
+		fe_cswap(x2, x3, swap);
+		fe_cswap(z2, z3, swap);
+		swap = bit;
+
+		fe_add(a, x2, z2);
+		fe_sq(aa, a);
+		fe_sub(b, x2, z2);
+		fe_sq(bb, b);
+		fe_sub(e, aa, bb);
+		fe_add(c, x3, z3);
+		fe_sub(d, x3, z3);
+		fe_mul(d, d, a);	/* DA */
+		fe_mul(c, c, b);	/* CB */
+		fe_add(x3, d, c);
+		fe_sq(x3, x3);
+		fe_sub(z3, d, c);
+		fe_sq(z3, z3);
+		fe_mul(z3, z3, x1);
+		fe_mul(x2, aa, bb);
+		fe_mul_a24(z2, e);
+		fe_add(z2, z2, aa);
+		fe_mul(z2, z2, e);
+	}
+	fe_cswap(x2, x3, swap);
+	fe_cswap(z2, z3, swap);
+
+	fe_invert(z2, z2);
+	fe_mul(x2, x2, z2);
+	fe_tobytes(out, x2);
+
+	_set_secure(x2, 0, sizeof(x2));
+	_set_secure(z2, 0, sizeof(z2));
+	_set_secure(x3, 0, sizeof(x3));
+	_set_secure(z3, 0, sizeof(z3));
+	_set_secure(a, 0, sizeof(a));
+	_set_secure(b, 0, sizeof(b));
+	_set_secure(c, 0, sizeof(c));
+	_set_secure(d, 0, sizeof(d));
+	_set_secure(e, 0, sizeof(e));
+	_set_secure(aa, 0, sizeof(aa));
+	_set_secure(bb, 0, sizeof(bb));
+}
+
+int tc_x25519(uint8_t *out, const uint8_t *scalar, const uint8_t *point)
+{
+	uint8_t k[TC_X25519_KEY_SIZE];
+	uint8_t acc = 0;
+	unsigned int i;
+
+	_copy(k, sizeof(k), scalar, sizeof(k));
+	k[0] &= 248;
+	k[31] &= 127;
+	k[31] |= 64;
+
+	x25519_ladder(out, k, point);
+	_set_secure(k, 0, sizeof(k));
+
+	/* all-zero output means a point of small order (RFC 7748, section 6.1) */
+	for (i = 0; i < TC_X25519_KEY_SIZE; ++i) {
+		acc |= out[i];
+	}
+	return acc ? TC_CRYPTO_SUCCESS : TC_CRYPTO_FAIL;
+}
+
+int tc_x25519_public_key(uint8_t *public_key, const uint8_t *private_key)
+{
+	return tc_x25519(public_key, private_key, x25519_base);
+}
+
+int tc_x25519_make_key(uint8_t *public_key, uint8_t *private_key)
+{
+	return tc_x25519_make_key_with_rng(public_key, private_key,
+					   uECC_get_rng() ? &uECC_global_rng : 0,
+					   0);
+}
+
+int tc_x25519_make_key_with_rng(uint8_t *public_key, uint8_t *private_key,
+				uECC_RNG_Ctx_Function rng, void *rng_ctx)
+{
+	if (!rng || !rng(rng_ctx, private_key, TC_X25519_KEY_SIZE)) {
+		return TC_CRYPTO_FAIL;
+	}
+	return tc_x25519_public_key(public_key, private_key);
+}
+
+int tc_x25519_shared_secret(const uint8_t *public_key,
+			    const uint8_t *private_key, uint8_t *secret)
+{
+	return tc_x25519(secret, private_key, public_key);
+}
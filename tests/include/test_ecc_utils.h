@@ -75,16 +75,16 @@ int hex2bin(uint8_t *buf, const size_t buflen, const char *hex,
 /*
  * Convert hex string to zero-padded nanoECC scalar
  */
-void string2scalar(unsigned int * scalar, unsigned int num_word32, char *str);
+void string2scalar(uECC_word_t * scalar, unsigned int num_words, char *str);
 
 
-void print_ecc_scalar(const char *label, const unsigned int * p_vli,
-		      unsigned int num_word32);
+void print_ecc_scalar(const char *label, const uECC_word_t * p_vli,
+		      unsigned int num_words);
 
 int check_ecc_result(const int num, const char *name,
-		      const unsigned int *expected, 
-		      const unsigned int *computed,
-		      const unsigned int num_word32, const bool verbose);
+		      const uECC_word_t *expected, 
+		      const uECC_word_t *computed,
+		      const unsigned int num_words, const bool verbose);
 
 /* Test ecc_make_keys, and also as keygen part of other tests */
 int keygen_vectors(char **d_vec, char **qx_vec, char **qy_vec, int tests, bool verbose);
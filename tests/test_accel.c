@@ -0,0 +1,556 @@
+/* test_accel.c - TinyCrypt implementation of some accelerator driver tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *  DESCRIPTION
+ * This module tests the crypto accelerator driver interface:
+ *
+ *  Scenarios tested include:
+ *  - reading the key back from a key schedule
+ *  - asynchronous bulk AES, completed in software without a driver
+ *  and, when built with TINYCRYPT_ACCEL, with mock drivers:
+ *  - AES blocks, SHA-256 compression and P-256 multiplications offloaded
+ *  - drivers declining operations, and bad P-256 results, falling back to
+ *    software
+ *  - asynchronous jobs completed later by the driver
+ */
+
+#include <tinycrypt/accel.h>
+#include <tinycrypt/aes.h>
+#include <tinycrypt/sha256.h>
+#include <tinycrypt/ecc.h>
+#include <tinycrypt/ecc_dh.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NBLOCKS 4
+
+static const uint8_t key128[TC_AES_KEY_SIZE] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const uint8_t plain[TC_AES_BLOCK_SIZE] = {
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+	0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+static const uint8_t cipher128[TC_AES_BLOCK_SIZE] = {
+	0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+	0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+
+struct job {
+	int done;
+	int result;
+};
+
+static void job_done(void *arg, int result)
+{
+	struct job *j = (struct job *) arg;
+
+	j->done++;
+	j->result = result;
+}
+
+/* NBLOCKS copies of plain */
+static void fill_blocks(uint8_t *buf)
+{
+	unsigned int i;
+
+	for (i = 0; i < NBLOCKS; ++i) {
+		memcpy(buf + i * TC_AES_BLOCK_SIZE, plain, TC_AES_BLOCK_SIZE);
+	}
+}
+
+static int check_blocks(const uint8_t *buf, const uint8_t *expected)
+{
+	unsigned int i;
+
+	for (i = 0; i < NBLOCKS; ++i) {
+		if (memcmp(buf + i * TC_AES_BLOCK_SIZE, expected,
+			   TC_AES_BLOCK_SIZE) != 0) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* runs an asynchronous encryption and decryption of NBLOCKS blocks; complete
+ * finishes the jobs queued by a driver, if any */
+static int async_round_trip(const TCAesKeySched_t s, void (*complete)(void))
+{
+	uint8_t buf[NBLOCKS * TC_AES_BLOCK_SIZE];
+	struct job j = { 0, 0 };
+
+	fill_blocks(buf);
+	if (tc_aes_encrypt_blocks_async(buf, buf, NBLOCKS, s, job_done, &j) !=
+	    TC_CRYPTO_SUCCESS) {
+		return 0;
+	}
+	if (complete) {
+		complete();
+	}
+	if (j.done != 1 || j.result != TC_CRYPTO_SUCCESS ||
+	    !check_blocks(buf, cipher128)) {
+		return 0;
+	}
+
+	j.done = 0;
+	if (tc_aes_decrypt_blocks_async(buf, buf, NBLOCKS, s, job_done, &j) !=
+	    TC_CRYPTO_SUCCESS) {
+		return 0;
+	}
+	if (complete) {
+		complete();
+	}
+	return j.done == 1 && j.result == TC_CRYPTO_SUCCESS &&
+	       check_blocks(buf, plain);
+}
+
+static int test_software(void)
+{
+	struct tc_aes_key_sched_struct s;
+	uint8_t buf[NBLOCKS * TC_AES_BLOCK_SIZE];
+	uint8_t k[TC_AES_256_KEY_SIZE];
+	struct job j = { 0, 0 };
+
+	TC_PRINT("Performing accelerator test #1 (software paths)\n");
+
+	(void)tc_aes128_set_encrypt_key(&s, key128);
+	if (tc_accel_aes_key(k, &s) != sizeof(key128) ||
+	    memcmp(k, key128, sizeof(key128)) != 0) {
+		TC_ERROR("%s: tc_accel_aes_key failed\n", __func__);
+		return TC_FAIL;
+	}
+
+	/* without a driver, done is called before returning */
+	if (!async_round_trip(&s, 0)) {
+		TC_ERROR("%s: asynchronous AES in software failed\n",
+			 __func__);
+		return TC_FAIL;
+	}
+
+	if (tc_aes_encrypt_blocks_async(0, buf, 1, &s, job_done, &j) !=
+	    TC_CRYPTO_FAIL ||
+	    tc_aes_encrypt_blocks_async(buf, 0, 1, &s, job_done, &j) !=
+	    TC_CRYPTO_FAIL ||
+	    tc_aes_decrypt_blocks_async(buf, buf, 1, 0, job_done, &j) !=
+	    TC_CRYPTO_FAIL ||
+	    tc_aes_decrypt_blocks_async(buf, buf, 1, &s, 0, &j) !=
+	    TC_CRYPTO_FAIL || j.done != 0) {
+		TC_ERROR("%s: invalid input accepted\n", __func__);
+		return TC_FAIL;
+	}
+
+	TC_END_RESULT(TC_PASS);
+	return TC_PASS;
+}
+
+#if defined(TINYCRYPT_ACCEL)
+/*
+ * The mock drivers do their work with the software of the library, which
+ * they reach by unregistering themselves for the duration of a call. They
+ * decline when told to, and count the operations they did.
+ */
+struct mock {
+	int decline;
+	int bad_result;
+	unsigned int calls;
+	/* the job queued by the asynchronous operations */
+	int pending;
+	int pending_decrypt;
+	uint8_t *out;
+	const uint8_t *in;
+	unsigned int nblocks;
+	TCAesKeySched_t s;
+	tc_accel_done_t done;
+	void *arg;
+};
+
+static struct mock aes_mock;
+static struct mock sha256_mock;
+static struct mock p256_mock;
+static const struct tc_accel_aes_ops mock_aes_ops;
+static const struct tc_accel_sha256_ops mock_sha256_ops;
+static const struct tc_accel_p256_ops mock_p256_ops;
+
+static int mock_encrypt(void *ctx, uint8_t *out, const uint8_t *in,
+			const TCAesKeySched_t s)
+{
+	struct mock *m = (struct mock *) ctx;
+	int r;
+
+	if (m->decline) {
+		return TC_CRYPTO_FAIL;
+	}
+	(void)tc_accel_register_aes(0, 0);
+	r = tc_aes_encrypt(out, in, s);
+	(void)tc_accel_register_aes(&mock_aes_ops, m);
+	m->calls++;
+	return r;
+}
+
+static int mock_decrypt(void *ctx, uint8_t *out, const uint8_t *in,
+			const TCAesKeySched_t s)
+{
+	struct mock *m = (struct mock *) ctx;
+	int r;
+
+	if (m->decline) {
+		return TC_CRYPTO_FAIL;
+	}
+	(void)tc_accel_register_aes(0, 0);
+	r = tc_aes_decrypt(out, in, s);
+	(void)tc_accel_register_aes(&mock_aes_ops, m);
+	m->calls++;
+	return r;
+}
+
+static int mock_encrypt_blocks(void *ctx, uint8_t *out, const uint8_t *in,
+			       unsigned int nblocks, const TCAesKeySched_t s)
+{
+	struct mock *m = (struct mock *) ctx;
+	int r;
+
+	if (m->decline) {
+		return TC_CRYPTO_FAIL;
+	}
+	(void)tc_accel_register_aes(0, 0);
+	r = tc_aes_encrypt_blocks(out, in, nblocks, s);
+	(void)tc_accel_register_aes(&mock_aes_ops, m);
+	m->calls++;
+	return r;
+}
+
+static int mock_decrypt_blocks(void *ctx, uint8_t *out, const uint8_t *in,
+			       unsigned int nblocks, const TCAesKeySched_t s)
+{
+	struct mock *m = (struct mock *) ctx;
+	int r;
+
+	if (m->decline) {
+		return TC_CRYPTO_FAIL;
+	}
+	(void)tc_accel_register_aes(0, 0);
+	r = tc_aes_decrypt_blocks(out, in, nblocks, s);
+	(void)tc_accel_register_aes(&mock_aes_ops, m);
+	m->calls++;
+	return r;
+}
+
+static int mock_queue(struct mock *m, int decrypt, uint8_t *out,
+		      const uint8_t *in, unsigned int nblocks,
+		      const TCAesKeySched_t s, tc_accel_done_t done, void *arg)
+{
+	if (m->decline || m->pending) {
+		return TC_CRYPTO_FAIL;
+	}
+	m->pending = 1;
+	m->pending_decrypt = decrypt;
+	m->out = out;
+	m->in = in;
+	m->nblocks = nblocks;
+	m->s = s;
+	m->done = done;
+	m->arg = arg;
+	return TC_CRYPTO_SUCCESS;
+}
+
+static int mock_encrypt_async(void *ctx, uint8_t *out, const uint8_t *in,
+			      unsigned int nblocks, const TCAesKeySched_t s,
+			      tc_accel_done_t done, void *arg)
+{
+	return mock_queue((struct mock *) ctx, 0, out, in, nblocks, s, done,
+			  arg);
+}
+
+static int mock_decrypt_async(void *ctx, uint8_t *out, const uint8_t *in,
+			      unsigned int nblocks, const TCAesKeySched_t s,
+			      tc_accel_done_t done, void *arg)
+{
+	return mock_queue((struct mock *) ctx, 1, out, in, nblocks, s, done,
+			  arg);
+}
+
+/* what the interrupt handler of the engine would do */
+static void mock_complete(void)
+{
+	struct mock *m = &aes_mock;
+	int r;
+
+	if (!m->pending) {
+		return;
+	}
+	m->pending = 0;
+	r = m->pending_decrypt ?
+	    mock_decrypt_blocks(m, m->out, m->in, m->nblocks, m->s) :
+	    mock_encrypt_blocks(m, m->out, m->in, m->nblocks, m->s);
+	m->done(m->arg, r);
+}
+
+static const struct tc_accel_aes_ops mock_aes_ops = {
+	mock_encrypt, mock_decrypt, mock_encrypt_blocks, mock_decrypt_blocks,
+	mock_encrypt_async, mock_decrypt_async
+};
+
+static int mock_compress_blocks(void *ctx, unsigned int *iv,
+				const uint8_t *data, size_t nblocks)
+{
+	struct mock *m = (struct mock *) ctx;
+	struct tc_sha256_state_struct s;
+
+	if (m->decline) {
+		return TC_CRYPTO_FAIL;
+	}
+	/* whole blocks go straight through tc_sha256_update */
+	(void)tc_sha256_init(&s);
+	memcpy(s.iv, iv, sizeof(s.iv));
+	(void)tc_accel_register_sha256(0, 0);
+	(void)tc_sha256_update(&s, data, nblocks * TC_SHA256_BLOCK_SIZE);
+	(void)tc_accel_register_sha256(&mock_sha256_ops, m);
+	memcpy(iv, s.iv, sizeof(s.iv));
+	m->calls++;
+	return TC_CRYPTO_SUCCESS;
+}
+
+static const struct tc_accel_sha256_ops mock_sha256_ops = {
+	mock_compress_blocks
+};
+
+/* multiplies the generator only; returns a point off the curve when told */
+static int mock_mult(void *ctx, uint8_t *result, const uint8_t *point,
+		     const uint8_t *scalar)
+{
+	struct mock *m = (struct mock *) ctx;
+	int r;
+
+	if (m->bad_result) {
+		memset(result, 0x5a, TC_ACCEL_P256_POINT_SIZE);
+		m->calls++;
+		return TC_CRYPTO_SUCCESS;
+	}
+	if (m->decline || point) {
+		return TC_CRYPTO_FAIL;
+	}
+	(void)tc_accel_register_p256(0, 0);
+	r = uECC_compute_public_key(scalar, result, uECC_secp256r1());
+	(void)tc_accel_register_p256(&mock_p256_ops, m);
+	m->calls++;
+	return r ? TC_CRYPTO_SUCCESS : TC_CRYPTO_FAIL;
+}
+
+static const struct tc_accel_p256_ops mock_p256_ops = {
+	mock_mult
+};
+
+static int test_aes(void)
+{
+	struct tc_aes_key_sched_struct s;
+	uint8_t out[TC_AES_BLOCK_SIZE];
+	uint8_t buf[NBLOCKS * TC_AES_BLOCK_SIZE];
+
+	TC_PRINT("Performing accelerator test #2 (AES)\n");
+
+	(void)tc_aes128_set_encrypt_key(&s, key128);
+	(void)tc_accel_register_aes(&mock_aes_ops, &aes_mock);
+
+	/* offloaded single and multiple blocks */
+	fill_blocks(buf);
+	if (tc_aes_encrypt(out, plain, &s) != TC_CRYPTO_SUCCESS ||
+	    memcmp(out, cipher128, sizeof(out)) != 0 ||
+	    tc_aes_decrypt(out, out, &s) != TC_CRYPTO_SUCCESS ||
+	    memcmp(out, plain, sizeof(out)) != 0 ||
+	    tc_aes_encrypt_blocks(buf, buf, NBLOCKS, &s) != TC_CRYPTO_SUCCESS ||
+	    !check_blocks(buf, cipher128) ||
+	    tc_aes_decrypt_blocks(buf, buf, NBLOCKS, &s) != TC_CRYPTO_SUCCESS ||
+	    !check_blocks(buf, plain) || aes_mock.calls != 4) {
+		TC_ERROR("%s: offloaded AES failed\n", __func__);
+		return TC_FAIL;
+	}
+
+	/* jobs completed later by the driver */
+	if (!async_round_trip(&s, mock_complete) || aes_mock.calls != 6) {
+		TC_ERROR("%s: asynchronous AES failed\n", __func__);
+		return TC_FAIL;
+	}
+
+	/* declined operations run in software */
+	aes_mock.decline = 1;
+	fill_blocks(buf);
+	if (tc_aes_encrypt(out, plain, &s) != TC_CRYPTO_SUCCESS ||
+	    memcmp(out, cipher128, sizeof(out)) != 0 ||
+	    tc_aes_encrypt_blocks(buf, buf, NBLOCKS, &s) != TC_CRYPTO_SUCCESS ||
+	    !check_blocks(buf, cipher128) ||
+	    tc_aes_decrypt_blocks(buf, buf, NBLOCKS, &s) != TC_CRYPTO_SUCCESS ||
+	    !check_blocks(buf, plain) || !async_round_trip(&s, 0) ||
+	    aes_mock.calls != 6) {
+		TC_ERROR("%s: software fallback failed\n", __func__);
+		return TC_FAIL;
+	}
+
+	(void)tc_accel_register_aes(0, 0);
+	TC_END_RESULT(TC_PASS);
+	return TC_PASS;
+}
+
+static int test_sha256(void)
+{
+	/* FIPS 180-2 B.2, two blocks once padded */
+	static const char msg[] =
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+	static const uint8_t expected[TC_SHA256_DIGEST_SIZE] = {
+		0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8,
+		0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+		0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67,
+		0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1
+	};
+	struct tc_sha256_state_struct s;
+	uint8_t digest[TC_SHA256_DIGEST_SIZE];
+	int i;
+
+	TC_PRINT("Performing accelerator test #3 (SHA-256)\n");
+
+	(void)tc_accel_register_sha256(&mock_sha256_ops, &sha256_mock);
+	for (i = 0; i < 2; ++i) {
+		sha256_mock.decline = i;
+		(void)tc_sha256_init(&s);
+		(void)tc_sha256_update(&s, (const uint8_t *) msg,
+				       sizeof(msg) - 1);
+		(void)tc_sha256_final(digest, &s);
+		if (memcmp(digest, expected, sizeof(digest)) != 0 ||
+		    sha256_mock.calls != 2) {
+			TC_ERROR("%s: %s SHA-256 failed\n", __func__,
+				 i ? "declined" : "offloaded");
+			return TC_FAIL;
+		}
+	}
+
+	(void)tc_accel_register_sha256(0, 0);
+	TC_END_RESULT(TC_PASS);
+	return TC_PASS;
+}
+
+static int test_p256(void)
+{
+	static const uint8_t d1[NUM_ECC_BYTES] = {
+		0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+		0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+		0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+		0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20
+	};
+	static const uint8_t d2[NUM_ECC_BYTES] = {
+		0x7f, 0x6e, 0x5d, 0x4c, 0x3b, 0x2a, 0x19, 0x08,
+		0xf7, 0xe6, 0xd5, 0xc4, 0xb3, 0xa2, 0x91, 0x80,
+		0x0f, 0x1e, 0x2d, 0x3c, 0x4b, 0x5a, 0x69, 0x78,
+		0x87, 0x96, 0xa5, 0xb4, 0xc3, 0xd2, 0xe1, 0xf0
+	};
+	uECC_Curve curve = uECC_secp256r1();
+	uint8_t pub[2 * NUM_ECC_BYTES];
+	uint8_t expected[2 * NUM_ECC_BYTES];
+	uint8_t secret[NUM_ECC_BYTES];
+	uint8_t expected_secret[NUM_ECC_BYTES];
+
+	TC_PRINT("Performing accelerator test #4 (P-256)\n");
+
+	if (!uECC_compute_public_key(d1, expected, curve) ||
+	    !uECC_shared_secret(expected, d2, expected_secret, curve)) {
+		TC_ERROR("%s: software references failed\n", __func__);
+		return TC_FAIL;
+	}
+
+	/* offloaded generator multiplication, declined ECDH */
+	(void)tc_accel_register_p256(&mock_p256_ops, &p256_mock);
+	if (!uECC_compute_public_key(d1, pub, curve) ||
+	    memcmp(pub, expected, sizeof(pub)) != 0 ||
+	    !uECC_shared_secret(pub, d2, secret, curve) ||
+	    memcmp(secret, expected_secret, sizeof(secret)) != 0 ||
+	    p256_mock.calls != 1) {
+		TC_ERROR("%s: offloaded P-256 failed\n", __func__);
+		return TC_FAIL;
+	}
+
+	/* results off the curve are computed again in software */
+	p256_mock.bad_result = 1;
+	if (!uECC_compute_public_key(d1, pub, curve) ||
+	    memcmp(pub, expected, sizeof(pub)) != 0 ||
+	    !uECC_shared_secret(pub, d2, secret, curve) ||
+	    memcmp(secret, expected_secret, sizeof(secret)) != 0 ||
+	    p256_mock.calls != 3) {
+		TC_ERROR("%s: bad P-256 result accepted\n", __func__);
+		return TC_FAIL;
+	}
+
+	(void)tc_accel_register_p256(0, 0);
+	TC_END_RESULT(TC_PASS);
+	return TC_PASS;
+}
+#endif
+
+/*
+ * Main task to test the accelerator driver interface
+ */
+int main(void)
+{
+	int result = TC_PASS;
+
+	TC_START("Performing accelerator driver tests:");
+
+	result = test_software();
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+#if defined(TINYCRYPT_ACCEL)
+	result = test_aes();
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+	result = test_sha256();
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+	result = test_p256();
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+#endif
+
+	TC_PRINT("All accelerator driver tests succeeded!\n");
+
+exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
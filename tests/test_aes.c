@@ -39,9 +39,15 @@
  * - AES128 NIST encryption test
  * - AES128 NIST fixed-key and variable-text
  * - AES128 NIST variable-key and fixed-text
+ * - AES128 hardware engine against the portable implementation
+ * - AES128 bitsliced engine against the portable implementation
+ * - AES192 and AES256 NIST encryption and decryption tests
+ * - multi-block decryption against encryption for every key size
  */
 
 #include <tinycrypt/aes.h>
+#include <tinycrypt/aes_hw.h>
+#include <tinycrypt/aes_bitslice.h>
 #include <tinycrypt/constants.h>
 #include <test_utils.h>
 
@@ -84,7 +90,12 @@ int test_1(void)
 			0xead27321, 0xb58dbad2, 0x312bf560, 0x7f8d292f,
 			0xac7766f3, 0x19fadc21, 0x28d12941, 0x575c006e,
 			0xd014f9a8, 0xc9ee2589, 0xe13f0cc8, 0xb6630ca6
-		}
+		},
+		0,
+#if defined(TINYCRYPT_AES_INV_KEYS)
+		{ 0 },
+		0
+#endif
 	};
 	struct tc_aes_key_sched_struct s;
 
@@ -2036,6 +2047,302 @@ int test_4(void)
 	return result;
 }
 
+/*
+ * Hardware engine against the portable implementation: successive keys and
+ * blocks are chained from the previous ciphertexts.
+ */
+int test_5(void)
+{
+	int result = TC_PASS;
+	uint8_t key[NUM_OF_NIST_KEYS] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+		0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+	};
+	uint8_t block[NUM_OF_NIST_KEYS] = {
+		0x32, 0x43, 0xf6, 0xa8, 0x88, 0x5a, 0x30, 0x8d,
+		0x31, 0x31, 0x98, 0xa2, 0xe0, 0x37, 0x07, 0x34
+	};
+	uint8_t expected[NUM_OF_NIST_KEYS];
+	uint8_t computed[NUM_OF_NIST_KEYS];
+	uint8_t blocks[7 * NUM_OF_NIST_KEYS];
+	uint8_t blocks_expected[7 * NUM_OF_NIST_KEYS];
+	struct tc_aes_key_sched_struct s;
+	unsigned int i;
+
+	TC_PRINT("AES128 %s (hardware engine test):\n", __func__);
+
+	if (!tc_aes_hw_available()) {
+		TC_PRINT("AES hardware engine not available, skipping\n");
+		goto exitTest5;
+	}
+
+	for (i = 0; i < 256; ++i) {
+		(void)tc_aes128_set_encrypt_key(&s, key);
+
+		(void)tc_aes_encrypt(expected, block, &s);
+		(void)tc_aes_hw_encrypt(computed, block, &s);
+		result = check_result(5, expected, sizeof(expected),
+				      computed, sizeof(computed));
+		if (result == TC_FAIL) {
+			goto exitTest5;
+		}
+
+		(void)tc_aes_hw_decrypt(computed, expected, &s);
+		result = check_result(5, block, sizeof(block),
+				      computed, sizeof(computed));
+		if (result == TC_FAIL) {
+			goto exitTest5;
+		}
+
+		memcpy(key, block, sizeof(key));
+		memcpy(block, expected, sizeof(block));
+	}
+
+	/* the multi-block entry point against single blocks: */
+	for (i = 0; i < sizeof(blocks); ++i) {
+		blocks[i] = (uint8_t) i;
+	}
+	for (i = 0; i < sizeof(blocks); i += NUM_OF_NIST_KEYS) {
+		(void)tc_aes_encrypt(&blocks_expected[i], &blocks[i], &s);
+	}
+	(void)tc_aes_hw_encrypt_blocks(blocks, blocks,
+				       sizeof(blocks) / NUM_OF_NIST_KEYS, &s);
+	result = check_result(5, blocks_expected, sizeof(blocks_expected),
+			      blocks, sizeof(blocks));
+
+exitTest5:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Bitsliced engine against the portable implementation, for every number of
+ * blocks up to three passes of the engine, out of place and in place.
+ */
+int test_6(void)
+{
+	int result = TC_PASS;
+	const uint8_t nist_key[NUM_OF_NIST_KEYS] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+		0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+	};
+	uint8_t in[3 * TC_AES_BITSLICE_BLOCKS * NUM_OF_NIST_KEYS];
+	uint8_t expected[sizeof(in)];
+	uint8_t computed[sizeof(in)];
+	struct tc_aes_key_sched_struct s;
+	unsigned int n;
+	unsigned int i;
+
+	TC_PRINT("AES128 %s (bitsliced engine test):\n", __func__);
+
+	(void)tc_aes128_set_encrypt_key(&s, nist_key);
+	for (i = 0; i < sizeof(in); ++i) {
+		in[i] = (uint8_t)(i * 13 + 5);
+	}
+	for (i = 0; i < sizeof(in); i += NUM_OF_NIST_KEYS) {
+		(void)tc_aes_encrypt(&expected[i], &in[i], &s);
+	}
+
+	for (n = 1; n <= sizeof(in) / NUM_OF_NIST_KEYS; ++n) {
+		(void)tc_aes_bitslice_encrypt_blocks(computed, in, n, &s);
+		result = check_result(6, expected, n * NUM_OF_NIST_KEYS,
+				      computed, n * NUM_OF_NIST_KEYS);
+		if (result == TC_FAIL) {
+			goto exitTest6;
+		}
+
+		(void)tc_aes_bitslice_decrypt_blocks(computed, computed, n, &s);
+		result = check_result(6, in, n * NUM_OF_NIST_KEYS,
+				      computed, n * NUM_OF_NIST_KEYS);
+		if (result == TC_FAIL) {
+			goto exitTest6;
+		}
+	}
+
+exitTest6:
+	TC_END_RESULT(result);
+	return result;
+}
+
+#if !defined(TINYCRYPT_AES_128_ONLY)
+/*
+ * FIPS 197 appendix C.2 (AES-192) and C.3 (AES-256) examples, through the
+ * portable implementation and through the engines.
+ */
+int test_7(void)
+{
+	int result = TC_PASS;
+	const uint8_t key[TC_AES_256_KEY_SIZE] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+		0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+		0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+		0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+	};
+	const uint8_t plaintext[NUM_OF_NIST_KEYS] = {
+		0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+		0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+	};
+	const uint8_t expected_192[NUM_OF_NIST_KEYS] = {
+		0xdd, 0xa9, 0x7c, 0xa4, 0x86, 0x4c, 0xdf, 0xe0,
+		0x6e, 0xaf, 0x70, 0xa0, 0xec, 0x0d, 0x71, 0x91
+	};
+	const uint8_t expected_256[NUM_OF_NIST_KEYS] = {
+		0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf,
+		0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89
+	};
+	const unsigned int key_sizes[2] = {
+		TC_AES_192_KEY_SIZE, TC_AES_256_KEY_SIZE
+	};
+	const uint8_t *expected[2] = { expected_192, expected_256 };
+	uint8_t blocks[TC_AES_BITSLICE_BLOCKS * NUM_OF_NIST_KEYS];
+	uint8_t computed[NUM_OF_NIST_KEYS];
+	struct tc_aes_key_sched_struct s;
+	unsigned int i;
+	unsigned int j;
+
+	TC_PRINT("AES %s (NIST AES-192 and AES-256 test):\n", __func__);
+
+	if (tc_aes_set_encrypt_key(&s, key, 20) != 0) {
+		TC_ERROR("AES %s accepted an invalid key size.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest7;
+	}
+
+	for (i = 0; i < 2; ++i) {
+		if (tc_aes_set_encrypt_key(&s, key, key_sizes[i]) == 0) {
+			TC_ERROR("AES %s (key schedule) failed.\n", __func__);
+			result = TC_FAIL;
+			goto exitTest7;
+		}
+
+		(void)tc_aes_encrypt(computed, plaintext, &s);
+		result = check_result(7, expected[i], NUM_OF_NIST_KEYS,
+				      computed, sizeof(computed));
+		if (result == TC_FAIL) {
+			goto exitTest7;
+		}
+		(void)tc_aes_decrypt(computed, expected[i], &s);
+		result = check_result(7, plaintext, sizeof(plaintext),
+				      computed, sizeof(computed));
+		if (result == TC_FAIL) {
+			goto exitTest7;
+		}
+
+		for (j = 0; j < sizeof(blocks); j += NUM_OF_NIST_KEYS) {
+			memcpy(&blocks[j], plaintext, sizeof(plaintext));
+		}
+		(void)tc_aes_bitslice_encrypt_blocks(blocks, blocks,
+						     TC_AES_BITSLICE_BLOCKS, &s);
+		for (j = 0; j < sizeof(blocks); j += NUM_OF_NIST_KEYS) {
+			result = check_result(7, expected[i], NUM_OF_NIST_KEYS,
+					      &blocks[j], NUM_OF_NIST_KEYS);
+			if (result == TC_FAIL) {
+				goto exitTest7;
+			}
+		}
+		(void)tc_aes_bitslice_decrypt_blocks(blocks, blocks, 1, &s);
+		result = check_result(7, plaintext, sizeof(plaintext),
+				      blocks, NUM_OF_NIST_KEYS);
+		if (result == TC_FAIL) {
+			goto exitTest7;
+		}
+
+		if (tc_aes_hw_available()) {
+			(void)tc_aes_hw_encrypt(computed, plaintext, &s);
+			result = check_result(7, expected[i], NUM_OF_NIST_KEYS,
+					      computed, sizeof(computed));
+			if (result == TC_FAIL) {
+				goto exitTest7;
+			}
+			(void)tc_aes_hw_decrypt(computed, expected[i], &s);
+			result = check_result(7, plaintext, sizeof(plaintext),
+					      computed, sizeof(computed));
+			if (result == TC_FAIL) {
+				goto exitTest7;
+			}
+		}
+	}
+
+exitTest7:
+	TC_END_RESULT(result);
+	return result;
+}
+#endif
+
+/*
+ * tc_aes_decrypt_blocks and tc_aes_decrypt undo tc_aes_encrypt for every key
+ * size, in place, both with the decryption round keys stored by
+ * tc_aes_set_decrypt_key and with an encryption-only schedule, for which they
+ * are derived on each call.
+ */
+int test_8(void)
+{
+	int result = TC_PASS;
+	const unsigned int key_sizes[3] = {
+		TC_AES_KEY_SIZE, TC_AES_192_KEY_SIZE, TC_AES_256_KEY_SIZE
+	};
+	uint8_t key[TC_AES_256_KEY_SIZE];
+	uint8_t in[17 * NUM_OF_NIST_KEYS];
+	uint8_t computed[sizeof(in)];
+	struct tc_aes_key_sched_struct s;
+	unsigned int i;
+	unsigned int j;
+	unsigned int prepared;
+
+	TC_PRINT("AES %s (multi-block decryption test):\n", __func__);
+
+	for (i = 0; i < sizeof(key); ++i) {
+		key[i] = (uint8_t)(i * 29 + 3);
+	}
+	for (i = 0; i < sizeof(in); ++i) {
+		in[i] = (uint8_t)(i * 7 + 1);
+	}
+
+	for (i = 0; i < 6; ++i) {
+#if defined(TINYCRYPT_AES_128_ONLY)
+		if (key_sizes[i % 3] != TC_AES_KEY_SIZE) {
+			continue;
+		}
+#endif
+		prepared = i < 3;
+		if (prepared) {
+			(void)tc_aes_set_decrypt_key(&s, key, key_sizes[i]);
+		} else {
+			(void)tc_aes_set_encrypt_key(&s, key, key_sizes[i - 3]);
+		}
+#if defined(TINYCRYPT_AES_INV_KEYS)
+		if (s.inv_ready != prepared) {
+			TC_ERROR("%s: inv_ready is %u, expected %u\n", __func__,
+				 s.inv_ready, prepared);
+			result = TC_FAIL;
+			goto exitTest8;
+		}
+#endif
+		for (j = 0; j < sizeof(in); j += NUM_OF_NIST_KEYS) {
+			(void)tc_aes_encrypt(&computed[j], &in[j], &s);
+		}
+		(void)tc_aes_decrypt_blocks(computed, computed,
+					    sizeof(in) / NUM_OF_NIST_KEYS, &s);
+		result = check_result(8, in, sizeof(in),
+				      computed, sizeof(computed));
+		if (result == TC_FAIL) {
+			goto exitTest8;
+		}
+
+		(void)tc_aes_encrypt(computed, in, &s);
+		(void)tc_aes_decrypt(computed, computed, &s);
+		result = check_result(8, in, NUM_OF_NIST_KEYS,
+				      computed, NUM_OF_NIST_KEYS);
+		if (result == TC_FAIL) {
+			goto exitTest8;
+		}
+	}
+
+exitTest8:
+	TC_END_RESULT(result);
+	return result;
+}
+
 /*
  * Main task to test AES
  */
@@ -2068,6 +2375,32 @@ int main(void)
 		goto exitTest;
 	}
 
+	result = test_5();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("AES128 test #5 (hardware engine) failed.\n");
+		goto exitTest;
+	}
+
+	result = test_6();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("AES128 test #6 (bitsliced engine) failed.\n");
+		goto exitTest;
+	}
+
+#if !defined(TINYCRYPT_AES_128_ONLY)
+	result = test_7();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("AES test #7 (NIST AES-192 and AES-256) failed.\n");
+		goto exitTest;
+	}
+#endif
+
+	result = test_8();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("AES test #8 (multi-block decryption) failed.\n");
+		goto exitTest;
+	}
+
 	TC_PRINT("All AES128 tests succeeded!\n");
 
  exitTest:
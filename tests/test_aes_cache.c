@@ -0,0 +1,296 @@
+/* test_aes_cache.c - TinyCrypt implementation of some AES key cache tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *  DESCRIPTION
+ * This module tests the AES key schedule cache routines:
+ *
+ *  Scenarios tested include:
+ *  - cached encryption and decryption schedules against FIPS-197 C.1 and C.3
+ *  - lookups by handle alone, and a handle reused for another key
+ *  - least recently used eviction and explicit, zeroing eviction
+ *  - robustness to invalid inputs
+ */
+
+#include <tinycrypt/aes_cache.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SLOTS 4
+
+static const uint8_t key128[TC_AES_KEY_SIZE] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+#if !defined(TINYCRYPT_AES_128_ONLY)
+static const uint8_t key256[TC_AES_256_KEY_SIZE] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+	0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+#endif
+static const uint8_t plain[TC_AES_BLOCK_SIZE] = {
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+	0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+static const uint8_t cipher128[TC_AES_BLOCK_SIZE] = {
+	0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+	0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+#if !defined(TINYCRYPT_AES_128_ONLY)
+static const uint8_t cipher256[TC_AES_BLOCK_SIZE] = {
+	0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf,
+	0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89
+};
+#endif
+
+/* encrypts plain and decrypts the result through the cache */
+static int round_trip(TCAesCache_t c, uint32_t handle, const uint8_t *k,
+		      unsigned int klen, const uint8_t *expected)
+{
+	TCAesKeySched_t s;
+	uint8_t out[TC_AES_BLOCK_SIZE];
+
+	if (tc_aes_cache_encrypt_key(&s, c, handle, k, klen) !=
+	    TC_CRYPTO_SUCCESS ||
+	    tc_aes_encrypt(out, plain, s) != TC_CRYPTO_SUCCESS ||
+	    memcmp(out, expected, sizeof(out)) != 0) {
+		return 0;
+	}
+	if (tc_aes_cache_decrypt_key(&s, c, handle, k, klen) !=
+	    TC_CRYPTO_SUCCESS ||
+	    tc_aes_decrypt(out, out, s) != TC_CRYPTO_SUCCESS ||
+	    memcmp(out, plain, sizeof(out)) != 0) {
+		return 0;
+	}
+	return 1;
+}
+
+static int test_vectors(TCAesCache_t c)
+{
+	TCAesKeySched_t s, t;
+
+	TC_PRINT("Performing AES cache test #1 (cached schedules)\n");
+
+	if (!round_trip(c, 1, key128, sizeof(key128), cipher128)) {
+		TC_ERROR("%s: AES-128 through the cache failed\n", __func__);
+		return TC_FAIL;
+	}
+#if !defined(TINYCRYPT_AES_128_ONLY)
+	if (!round_trip(c, 2, key256, sizeof(key256), cipher256)) {
+		TC_ERROR("%s: AES-256 through the cache failed\n", __func__);
+		return TC_FAIL;
+	}
+#endif
+
+	/* hits return the same slot, with or without the key */
+	if (tc_aes_cache_encrypt_key(&s, c, 1, key128, sizeof(key128)) !=
+	    TC_CRYPTO_SUCCESS ||
+	    tc_aes_cache_encrypt_key(&t, c, 1, 0, 0) != TC_CRYPTO_SUCCESS ||
+	    s != t || !round_trip(c, 1, 0, 0, cipher128)) {
+		TC_ERROR("%s: lookup by handle failed\n", __func__);
+		return TC_FAIL;
+	}
+
+	/* both directions share one schedule */
+	if (tc_aes_cache_decrypt_key(&t, c, 1, 0, 0) != TC_CRYPTO_SUCCESS ||
+	    s != t) {
+		TC_ERROR("%s: decryption schedule not shared\n", __func__);
+		return TC_FAIL;
+	}
+#if defined(TINYCRYPT_AES_INV_KEYS)
+	if (TC_AES_INV_WORDS(t) == (const unsigned int *) 0) {
+		TC_ERROR("%s: decryption round keys not stored\n", __func__);
+		return TC_FAIL;
+	}
+#endif
+
+#if defined(__GNUC__)
+	if ((uintptr_t) s % TINYCRYPT_CACHE_LINE_SIZE !=
+	    (uintptr_t) &c->slot[0].sched % TINYCRYPT_CACHE_LINE_SIZE ||
+	    (uintptr_t) &c->slot[1] % TINYCRYPT_CACHE_LINE_SIZE != 0) {
+		TC_ERROR("%s: slots not aligned to cache lines\n", __func__);
+		return TC_FAIL;
+	}
+#endif
+
+	/* a handle reused for another key gets the new key's schedule */
+	if (!round_trip(c, 2, key128, sizeof(key128), cipher128) ||
+	    tc_aes_cache_encrypt_key(&t, c, 2, 0, 0) != TC_CRYPTO_SUCCESS ||
+	    t->extra_rounds != 0) {
+		TC_ERROR("%s: stale schedule for a reused handle\n", __func__);
+		return TC_FAIL;
+	}
+
+	TC_END_RESULT(TC_PASS);
+	return TC_PASS;
+}
+
+static int test_eviction(TCAesCache_t c)
+{
+	static const uint8_t zero[sizeof(struct tc_aes_cache_slot)];
+	TCAesKeySched_t s;
+	uint8_t k[TC_AES_KEY_SIZE];
+	uint32_t h;
+
+	TC_PRINT("Performing AES cache test #2 (eviction)\n");
+
+	/* fill the cache with handles 10..13, then use 10 again */
+	memcpy(k, key128, sizeof(k));
+	for (h = 10; h < 10 + SLOTS; ++h) {
+		k[0] = (uint8_t) h;
+		if (tc_aes_cache_encrypt_key(&s, c, h, k, sizeof(k)) !=
+		    TC_CRYPTO_SUCCESS) {
+			TC_ERROR("%s: filling the cache failed\n", __func__);
+			return TC_FAIL;
+		}
+	}
+	if (tc_aes_cache_encrypt_key(&s, c, 10, 0, 0) != TC_CRYPTO_SUCCESS) {
+		TC_ERROR("%s: handle 10 not cached\n", __func__);
+		return TC_FAIL;
+	}
+
+	/* a new key replaces the least recently used one, 11 */
+	k[0] = 20;
+	if (tc_aes_cache_encrypt_key(&s, c, 20, k, sizeof(k)) !=
+	    TC_CRYPTO_SUCCESS ||
+	    tc_aes_cache_encrypt_key(&s, c, 11, 0, 0) != TC_CRYPTO_FAIL ||
+	    tc_aes_cache_encrypt_key(&s, c, 10, 0, 0) != TC_CRYPTO_SUCCESS ||
+	    tc_aes_cache_encrypt_key(&s, c, 12, 0, 0) != TC_CRYPTO_SUCCESS) {
+		TC_ERROR("%s: wrong slot evicted\n", __func__);
+		return TC_FAIL;
+	}
+
+	/* explicit eviction leaves nothing behind */
+	if (tc_aes_cache_evict(c, 12) != TC_CRYPTO_SUCCESS ||
+	    tc_aes_cache_evict(c, 12) != TC_CRYPTO_FAIL ||
+	    tc_aes_cache_encrypt_key(&s, c, 12, 0, 0) != TC_CRYPTO_FAIL) {
+		TC_ERROR("%s: tc_aes_cache_evict failed\n", __func__);
+		return TC_FAIL;
+	}
+	for (h = 0; h < SLOTS; ++h) {
+		if (c->slot[h].state == 0 &&
+		    memcmp(&c->slot[h], zero, sizeof(zero)) != 0) {
+			TC_ERROR("%s: evicted slot not erased\n", __func__);
+			return TC_FAIL;
+		}
+	}
+
+	TC_END_RESULT(TC_PASS);
+	return TC_PASS;
+}
+
+static int test_robustness(void)
+{
+	struct tc_aes_cache_slot slots[1];
+	struct tc_aes_cache_struct c;
+	TCAesKeySched_t s;
+
+	TC_PRINT("Performing AES cache test #3 (invalid inputs)\n");
+
+	if (tc_aes_cache_init(0, slots, 1) != TC_CRYPTO_FAIL ||
+	    tc_aes_cache_init(&c, 0, 1) != TC_CRYPTO_FAIL ||
+	    tc_aes_cache_init(&c, slots, 0) != TC_CRYPTO_FAIL ||
+	    tc_aes_cache_init(&c, slots, 1) != TC_CRYPTO_SUCCESS ||
+	    tc_aes_cache_encrypt_key(0, &c, 1, key128, 16) != TC_CRYPTO_FAIL ||
+	    tc_aes_cache_encrypt_key(&s, 0, 1, key128, 16) != TC_CRYPTO_FAIL ||
+	    tc_aes_cache_decrypt_key(&s, &c, 1, 0, 16) != TC_CRYPTO_FAIL ||
+	    tc_aes_cache_encrypt_key(&s, &c, 1, key128, 17) != TC_CRYPTO_FAIL ||
+	    c.slot[0].state != 0 ||
+	    tc_aes_cache_evict(0, 1) != TC_CRYPTO_FAIL) {
+		TC_ERROR("%s: invalid input accepted\n", __func__);
+		return TC_FAIL;
+	}
+
+	tc_aes_cache_erase(&c);
+	tc_aes_cache_erase(0);
+	if (tc_aes_cache_encrypt_key(&s, &c, 1, key128, 16) !=
+	    TC_CRYPTO_FAIL) {
+		TC_ERROR("%s: erased cache still in use\n", __func__);
+		return TC_FAIL;
+	}
+
+	TC_END_RESULT(TC_PASS);
+	return TC_PASS;
+}
+
+/*
+ * Main task to test the AES key schedule cache
+ */
+int main(void)
+{
+	struct tc_aes_cache_slot slots[SLOTS];
+	struct tc_aes_cache_struct cache;
+	int result = TC_PASS;
+
+	TC_START("Performing AES key cache tests:");
+
+	if (tc_aes_cache_init(&cache, slots, SLOTS) != TC_CRYPTO_SUCCESS) {
+		TC_ERROR("tc_aes_cache_init failed\n");
+		result = TC_FAIL;
+		goto exitTest;
+	}
+
+	result = test_vectors(&cache);
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+	result = test_eviction(&cache);
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+
+	tc_aes_cache_erase(&cache);
+	if (cache.slot != 0) {
+		TC_ERROR("tc_aes_cache_erase failed\n");
+		result = TC_FAIL;
+		goto exitTest;
+	}
+
+	result = test_robustness();
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+
+	TC_PRINT("All AES key cache tests succeeded!\n");
+
+exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
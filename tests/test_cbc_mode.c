@@ -35,6 +35,8 @@
  *
  * Scenarios tested include:
  * - AES128 CBC mode encryption SP 800-38a tests
+ * - AES256 CBC mode encryption and decryption SP 800-38a tests
+ * - AES128 CBC mode batched decryption, out of place and in place
  */
 
 #include <tinycrypt/cbc_mode.h>
@@ -132,7 +134,7 @@ int test_1_and_2(void)
 	(void)tc_aes128_set_decrypt_key(&a, key);
 
 	p = &encrypted[TC_AES_BLOCK_SIZE];
-	length = ((unsigned int) sizeof(encrypted));
+	length = ((unsigned int) sizeof(decrypted));
 
 	if (tc_cbc_mode_decrypt(decrypted, length, p, length, encrypted, &a) == 0) {
 		TC_ERROR("CBC test #2 (decryption SP 800-38a tests) failed in. "
@@ -149,6 +151,186 @@ exitTest1:
 	return result;
 }
 
+#if !defined(TINYCRYPT_AES_128_ONLY)
+/*
+ * NIST test vectors from SP 800-38a F.2.5 and F.2.6 (CBC-AES256), using the
+ * same IV and plaintext as above.
+ */
+const uint8_t key_256[32] = {
+	0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0,
+	0x85, 0x7d, 0x77, 0x81, 0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7,
+	0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4
+};
+
+const uint8_t ciphertext_256[80] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+	0x0c, 0x0d, 0x0e, 0x0f, 0xf5, 0x8c, 0x4c, 0x04, 0xd6, 0xe5, 0xf1, 0xba,
+	0x77, 0x9e, 0xab, 0xfb, 0x5f, 0x7b, 0xfb, 0xd6, 0x9c, 0xfc, 0x4e, 0x96,
+	0x7e, 0xdb, 0x80, 0x8d, 0x67, 0x9f, 0x77, 0x7b, 0xc6, 0x70, 0x2c, 0x7d,
+	0x39, 0xf2, 0x33, 0x69, 0xa9, 0xd9, 0xba, 0xcf, 0xa5, 0x30, 0xe2, 0x63,
+	0x04, 0x23, 0x14, 0x61, 0xb2, 0xeb, 0x05, 0xe2, 0xc3, 0x9b, 0xe9, 0xfc,
+	0xda, 0x6c, 0x19, 0x07, 0x8c, 0x6a, 0x9d, 0x1b
+};
+
+int test_3(void)
+{
+	struct tc_aes_key_sched_struct a;
+	uint8_t iv_buffer[16];
+	uint8_t encrypted[80];
+	uint8_t decrypted[64];
+	int result = TC_PASS;
+
+	TC_PRINT("CBC test #3 (AES-256 SP 800-38a tests):\n");
+	(void)tc_aes_set_encrypt_key(&a, key_256, sizeof(key_256));
+	(void)memcpy(iv_buffer, iv, TC_AES_BLOCK_SIZE);
+
+	if (tc_cbc_mode_encrypt(encrypted, sizeof(encrypted), plaintext,
+				sizeof(plaintext), iv_buffer, &a) == 0) {
+		TC_ERROR("CBC test #3 (encryption) failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest3;
+	}
+
+	result = check_result(3, ciphertext_256, sizeof(ciphertext_256),
+			      encrypted, sizeof(encrypted));
+	if (result == TC_FAIL) {
+		goto exitTest3;
+	}
+
+	(void)tc_aes_set_decrypt_key(&a, key_256, sizeof(key_256));
+	if (tc_cbc_mode_decrypt(decrypted, sizeof(decrypted),
+				&encrypted[TC_AES_BLOCK_SIZE], sizeof(decrypted),
+				encrypted, &a) == 0) {
+		TC_ERROR("CBC test #3 (decryption) failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest3;
+	}
+
+	result = check_result(3, plaintext, sizeof(plaintext), decrypted,
+			      sizeof(decrypted));
+
+exitTest3:
+	TC_END_RESULT(result);
+	return result;
+}
+#endif
+
+/*
+ * Batched decryption of what the (block at a time) encryption produced, for
+ * lengths that cover partial and several batches: out of place, in place,
+ * and with the plaintext written over the iv (out == in - 16).
+ */
+int test_4(void)
+{
+	struct tc_aes_key_sched_struct a;
+	uint8_t buf[TC_AES_BLOCK_SIZE + 400];
+	uint8_t encrypted[TC_AES_BLOCK_SIZE + 400];
+	uint8_t expected[400];
+	uint8_t decrypted[400];
+	unsigned int nblocks;
+	unsigned int length;
+	unsigned int i;
+	int result = TC_PASS;
+
+	TC_PRINT("CBC test #4 (batched decryption):\n");
+	(void)tc_aes128_set_encrypt_key(&a, key);
+	for (i = 0; i < sizeof(expected); ++i) {
+		expected[i] = (uint8_t)(i * 13 + 5);
+	}
+
+	for (nblocks = 1; nblocks <= sizeof(expected) / TC_AES_BLOCK_SIZE;
+	     ++nblocks) {
+		length = nblocks * TC_AES_BLOCK_SIZE;
+		(void)tc_cbc_mode_encrypt(encrypted, length + TC_AES_BLOCK_SIZE,
+					  expected, length, iv, &a);
+
+		(void)memset(decrypted, 0, sizeof(decrypted));
+		if (tc_cbc_mode_decrypt(decrypted, length,
+					&encrypted[TC_AES_BLOCK_SIZE], length,
+					encrypted, &a) == 0) {
+			TC_ERROR("CBC test #4 failed in %s.\n", __func__);
+			result = TC_FAIL;
+			goto exitTest4;
+		}
+		result = check_result(4, expected, length, decrypted, length);
+		if (result == TC_FAIL) {
+			goto exitTest4;
+		}
+
+		/* in place */
+		(void)memcpy(buf, encrypted, length + TC_AES_BLOCK_SIZE);
+		(void)tc_cbc_mode_decrypt(&buf[TC_AES_BLOCK_SIZE], length,
+					  &buf[TC_AES_BLOCK_SIZE], length, buf,
+					  &a);
+		result = check_result(4, expected, length,
+				      &buf[TC_AES_BLOCK_SIZE], length);
+		if (result == TC_FAIL) {
+			goto exitTest4;
+		}
+
+		/* over the iv */
+		(void)memcpy(buf, encrypted, length + TC_AES_BLOCK_SIZE);
+		(void)tc_cbc_mode_decrypt(buf, length, &buf[TC_AES_BLOCK_SIZE],
+					  length, buf, &a);
+		result = check_result(4, expected, length, buf, length);
+		if (result == TC_FAIL) {
+			goto exitTest4;
+		}
+	}
+
+exitTest4:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * SP 800-38a vector again, with the plaintext and the output split off
+ * block boundaries and over empty segments.
+ */
+int test_5(void)
+{
+	const unsigned int in_split[] = { 5, 0, 20, 7, 32 };
+	const unsigned int out_split[] = { 3, 16, 0, 40, 21 };
+	struct tc_iovec in_iov[5];
+	struct tc_iovec out_iov[5];
+	struct tc_aes_key_sched_struct a;
+	uint8_t encrypted[80];
+	unsigned int i, off;
+	int result = TC_PASS;
+
+	TC_PRINT("CBC test #5 (scatter-gather encryption):\n");
+	(void)tc_aes128_set_encrypt_key(&a, key);
+	for (i = off = 0; i < 5; off += in_split[i++]) {
+		in_iov[i].base = (void *)&plaintext[off];
+		in_iov[i].len = in_split[i];
+	}
+	for (i = off = 0; i < 5; off += out_split[i++]) {
+		out_iov[i].base = &encrypted[off];
+		out_iov[i].len = out_split[i];
+	}
+
+	if (tc_cbc_mode_encryptv(out_iov, 5, in_iov, 5, iv, &a) == 0) {
+		TC_ERROR("CBC test #5 failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest5;
+	}
+	result = check_result(5, ciphertext, sizeof(ciphertext), encrypted,
+			      sizeof(encrypted));
+	if (result == TC_FAIL) {
+		goto exitTest5;
+	}
+
+	/* the output must hold iv and ciphertext exactly */
+	if (tc_cbc_mode_encryptv(out_iov, 4, in_iov, 5, iv, &a) != 0) {
+		TC_ERROR("CBC test #5 accepted a short output.\n");
+		result = TC_FAIL;
+	}
+
+exitTest5:
+	TC_END_RESULT(result);
+	return result;
+}
+
 /*
  * Main task to test AES
  */
@@ -166,6 +348,29 @@ int main(void)
 		goto exitTest;
 	}
 
+#if !defined(TINYCRYPT_AES_128_ONLY)
+	result = test_3();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("CBC test #3 failed.\n");
+		goto exitTest;
+	}
+#endif
+
+	result = test_4();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("CBC test #4 failed.\n");
+		goto exitTest;
+	}
+
+	result = test_5();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("CBC test #5 failed.\n");
+		goto exitTest;
+	}
+
 	TC_PRINT("All CBC tests succeeded!\n");
 
 exitTest:
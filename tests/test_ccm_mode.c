@@ -43,10 +43,13 @@
  *  - AES128 CCM mode encryption RFC 3610 test vector #9
  *  - AES128 CCM mode encryption No associated data
  *  - AES128 CCM mode encryption No payload data
+ *  - the above through the incremental (tc_ccm_stream_*) interface
+ *  - AES128 CCM mode multi-block payload, fused and byte-wise paths
  */
 
 #include <tinycrypt/ccm_mode.h>
 #include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
 #include <test_utils.h>
 
 #include <string.h>
@@ -67,6 +70,68 @@
 #define EXPECTED_BUF_LEN34 34
 #define EXPECTED_BUF_LEN35 35
 
+/*
+ * Runs the incremental interface over data cut into chunks of 3 and 5 bytes
+ * and checks it against ciphertext (dlen bytes followed by an mlen-byte tag)
+ * from the one-shot procedure.
+ */
+int do_stream_test(TCCcmMode_t c, const uint8_t *hdr, size_t hlen,
+		   const uint8_t *data, size_t dlen, const uint8_t *ciphertext,
+		   const int mlen)
+{
+	struct tc_ccm_stream_struct s;
+	uint8_t out[TC_CCM_MAX_CT_SIZE];
+	uint8_t tag[16];
+	size_t i, n;
+
+	if (tc_ccm_stream_init(&s, c, hlen, dlen) == 0) {
+		TC_ERROR("ccm_stream_init failed in %s.\n", __func__);
+		return TC_FAIL;
+	}
+	for (i = 0; i < hlen; i += n) {
+		n = (hlen - i < 3) ? hlen - i : 3;
+		(void)tc_ccm_stream_update_aad(&s, hdr + i, n);
+	}
+	for (i = 0; i < dlen; i += n) {
+		n = (dlen - i < 5) ? dlen - i : 5;
+		(void)tc_ccm_stream_encrypt(&s, out + i, data + i, n);
+	}
+	if (tc_ccm_stream_final(&s, tag, sizeof(tag)) == 0 ||
+	    memcmp(out, ciphertext, dlen) != 0 ||
+	    memcmp(tag, ciphertext + dlen, mlen) != 0) {
+		TC_ERROR("ccm_stream_encrypt produced wrong output in %s.\n",
+			 __func__);
+		return TC_FAIL;
+	}
+
+	(void)tc_ccm_stream_init(&s, c, hlen, dlen);
+	(void)tc_ccm_stream_update_aad(&s, hdr, hlen);
+	(void)_copy(out, sizeof(out), ciphertext, dlen + mlen);
+	for (i = 0; i < dlen; i += n) {
+		n = (dlen - i < 5) ? dlen - i : 5;
+		(void)tc_ccm_stream_decrypt(&s, out + i, out + i, n);
+	}
+	if (tc_ccm_stream_verify(&s, ciphertext + dlen, mlen) == 0 ||
+	    (dlen > 0 && memcmp(out, data, dlen) != 0)) {
+		TC_ERROR("ccm_stream_decrypt failed in %s.\n", __func__);
+		return TC_FAIL;
+	}
+
+	/* a flipped tag bit must be rejected: */
+	(void)tc_ccm_stream_init(&s, c, hlen, dlen);
+	(void)tc_ccm_stream_update_aad(&s, hdr, hlen);
+	(void)tc_ccm_stream_decrypt(&s, out, ciphertext, dlen);
+	tag[0] = ciphertext[dlen] ^ 1;
+	(void)_copy(tag + 1, sizeof(tag) - 1, ciphertext + dlen + 1, mlen - 1);
+	if (tc_ccm_stream_verify(&s, tag, mlen) != 0) {
+		TC_ERROR("ccm_stream_verify accepted a bad tag in %s.\n",
+			 __func__);
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
 int do_test(const uint8_t *key, uint8_t *nonce, 
 	    size_t nlen, const uint8_t *hdr,
 	    size_t hlen, const uint8_t *data,
@@ -122,7 +187,7 @@ int do_test(const uint8_t *key, uint8_t *nonce,
 		goto exitTest1;
 	}
 
-	result = TC_PASS;
+	result = do_stream_test(&c, hdr, hlen, data, dlen, ciphertext, mlen);
 
 exitTest1:
 	TC_END_RESULT(result);
@@ -414,7 +479,7 @@ int test_vector_7(void)
 		goto exitTest1;
 	}
 
-	result = TC_PASS;
+	result = do_stream_test(&c, hdr, 0, data, sizeof(data), ciphertext, mlen);
 
 exitTest1:
 	TC_END_RESULT(result);
@@ -478,6 +543,87 @@ int test_vector_8(void)
 		goto exitTest1;
 	}
 
+	result = do_stream_test(&c, hdr, sizeof(hdr), data, 0, ciphertext, mlen);
+
+exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+int test_vector_9(void)
+{
+	int result = TC_PASS;
+	/* A 150-byte payload: the one-shot procedures run whole blocks through
+	 * the fused CBC-MAC/CTR path, byte-sized stream chunks do not. */
+	const uint8_t key[NUM_NIST_KEYS] = {
+		0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7,
+		0xC8, 0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF
+	};
+	uint8_t nonce[NONCE_LEN] = {
+		0x00, 0x00, 0x00, 0x0B, 0x0A, 0x09, 0x08, 0xA0,
+		0xA1, 0xA2, 0xA3, 0xA4, 0xA5
+	};
+	const uint8_t hdr[HEADER_LEN] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07
+	};
+	uint8_t data[150];
+	uint8_t ciphertext[sizeof(data) + M_LEN8];
+	uint8_t streamed[sizeof(data) + M_LEN8];
+	uint8_t decrypted[sizeof(data)];
+	struct tc_ccm_mode_struct c;
+	struct tc_ccm_stream_struct s;
+	struct tc_aes_key_sched_struct sched;
+	unsigned int i;
+
+	TC_PRINT("%s: Performing CCM test #9 (multi-block payload):\n",
+		 __func__);
+
+	for (i = 0; i < sizeof(data); ++i) {
+		data[i] = (uint8_t)(i * 7 + 1);
+	}
+	tc_aes128_set_encrypt_key(&sched, key);
+	(void)tc_ccm_config(&c, &sched, nonce, sizeof(nonce), M_LEN8);
+
+	if (tc_ccm_generation_encryption(ciphertext, sizeof(ciphertext), hdr,
+					 sizeof(hdr), data, sizeof(data),
+					 &c) == 0) {
+		TC_ERROR("ccm_encrypt failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+	(void)tc_ccm_stream_init(&s, &c, sizeof(hdr), sizeof(data));
+	(void)tc_ccm_stream_update_aad(&s, hdr, sizeof(hdr));
+	for (i = 0; i < sizeof(data); ++i) {
+		(void)tc_ccm_stream_encrypt(&s, streamed + i, data + i, 1);
+	}
+	(void)tc_ccm_stream_final(&s, streamed + sizeof(data), M_LEN8);
+	if (memcmp(streamed, ciphertext, sizeof(ciphertext)) != 0) {
+		TC_ERROR("fused and byte-wise encryption differ in %s.\n",
+			 __func__);
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	if (tc_ccm_decryption_verification(decrypted, sizeof(decrypted), hdr,
+					   sizeof(hdr), ciphertext,
+					   sizeof(ciphertext), &c) == 0 ||
+	    memcmp(decrypted, data, sizeof(data)) != 0) {
+		TC_ERROR("ccm_decrypt failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	/* an altered payload byte must fail verification: */
+	ciphertext[100] ^= 0x80;
+	if (tc_ccm_decryption_verification(decrypted, sizeof(decrypted), hdr,
+					   sizeof(hdr), ciphertext,
+					   sizeof(ciphertext), &c) != 0) {
+		TC_ERROR("ccm_decrypt accepted a modified payload in %s.\n",
+			 __func__);
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
 	result = TC_PASS;
 
 exitTest1:
@@ -534,6 +680,11 @@ int main(void)
 		TC_ERROR("CCM test #8 (no payload data) failed.\n");
 		goto exitTest;
 	}
+	result = test_vector_9();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("CCM test #9 (multi-block payload) failed.\n");
+		goto exitTest;
+	}
 
 	TC_PRINT("All CCM tests succeeded!\n");
 
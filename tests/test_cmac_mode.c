@@ -39,6 +39,7 @@
  *  - CMAC test #3 1 block msg (SP 800-38B test vector #2)
  *  - CMAC test #4 320 bit msg (SP 800-38B test vector #3)
  *  - CMAC test #5 512 bit msg (SP 800-38B test vector #4)
+ *  - CMAC test #6 AES-256 1 block msg (SP 800-38B example D.3)
  */
 
 #include <tinycrypt/cmac_mode.h>
@@ -191,6 +192,7 @@ static int verify_cmac_320_bit_msg(TCCmacState_t s)
 		0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30,
 		0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27
 	};
+	struct tc_iovec iov[4];
 	uint8_t Tag[BUF_LEN];
 
 	(void) tc_cmac_init(s);
@@ -205,6 +207,27 @@ static int verify_cmac_320_bit_msg(TCCmacState_t s)
 		return TC_FAIL;
 	}
 
+	/* again in segments, one of them empty and one ending on a block */
+	iov[0].base = (void *)msg;
+	iov[0].len = 7;
+	iov[1].base = (void *)&msg[7];
+	iov[1].len = 0;
+	iov[2].base = (void *)&msg[7];
+	iov[2].len = 9;
+	iov[3].base = (void *)&msg[16];
+	iov[3].len = 24;
+	(void) tc_cmac_init(s);
+	(void) tc_cmac_updatev(s, iov, 4);
+	(void) tc_cmac_final(Tag, s);
+
+	if (memcmp(Tag, tag, BUF_LEN) != 0) {
+		TC_ERROR("%s: tc_cmac_updatev failed with 320 bit msg\n",
+			 __func__);
+		show("expected Tag =", tag, sizeof(tag));
+		show("computed Tag =", Tag, sizeof(Tag));
+		return TC_FAIL;
+	}
+
 	TC_END_RESULT(result);
 	return result;
 }
@@ -247,6 +270,224 @@ static int verify_cmac_512_bit_msg(TCCmacState_t s)
 	return result;
 }
 
+/* SP 800-38B examples 1 to 4 are prefixes of the same message */
+static const uint8_t sp800_38b_msg[64] = {
+	0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+	0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+	0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+	0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+	0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+	0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+	0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+	0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+};
+static const uint8_t sp800_38b_tags[4][BUF_LEN] = {
+	{
+		0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28,
+		0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46
+	}, {
+		0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44,
+		0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c
+	}, {
+		0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30,
+		0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27
+	}, {
+		0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92,
+		0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe
+	}
+};
+
+static int verify_cmac_mb(TCCmacState_t s)
+{
+	int result = TC_PASS;
+
+	TC_PRINT("Performing CMAC test #7 (multi-message)\n");
+
+	/* more messages than lanes, mixing lengths so lanes retire unevenly */
+	const size_t lens[] = {
+		0, 16, 40, 64, 1, 15, 17, 33, 64, 0, 48, 31, 2, 63, 16, 47, 32
+	};
+	const unsigned int count = sizeof(lens) / sizeof(lens[0]);
+	uint8_t Tag[sizeof(lens) / sizeof(lens[0])][BUF_LEN];
+	uint8_t expected[BUF_LEN];
+	uint8_t *tag[sizeof(lens) / sizeof(lens[0])];
+	const uint8_t *data[sizeof(lens) / sizeof(lens[0])];
+	struct tc_cmac_struct t;
+	unsigned int i;
+
+	for (i = 0; i < count; ++i) {
+		tag[i] = Tag[i];
+		data[i] = sp800_38b_msg;
+	}
+	data[0] = (const uint8_t *) 0;
+
+	if (tc_cmac_mb(tag, data, lens, count, s) != TC_CRYPTO_SUCCESS) {
+		TC_ERROR("%s: tc_cmac_mb failed\n", __func__);
+		return TC_FAIL;
+	}
+
+	for (i = 0; i < 4; ++i) {
+		if (memcmp(Tag[i], sp800_38b_tags[i], BUF_LEN) != 0) {
+			TC_ERROR("%s: SP 800-38B vector #%u failed\n",
+				 __func__, i + 1);
+			show("expected Tag =", sp800_38b_tags[i], BUF_LEN);
+			show("computed Tag =", Tag[i], BUF_LEN);
+			return TC_FAIL;
+		}
+	}
+
+	for (i = 0; i < count; ++i) {
+		t = *s;
+		(void)tc_cmac_init(&t);
+		(void)tc_cmac_update(&t, sp800_38b_msg, lens[i]);
+		(void)tc_cmac_final(expected, &t);
+		if (memcmp(Tag[i], expected, BUF_LEN) != 0) {
+			TC_ERROR("%s: message %u (%u bytes) differs from "
+				 "tc_cmac_final\n", __func__, i,
+				 (unsigned int) lens[i]);
+			show("expected Tag =", expected, BUF_LEN);
+			show("computed Tag =", Tag[i], BUF_LEN);
+			return TC_FAIL;
+		}
+	}
+
+	data[1] = (const uint8_t *) 0;
+	if (tc_cmac_mb(tag, data, lens, count, s) != TC_CRYPTO_FAIL) {
+		TC_ERROR("%s: NULL data with nonzero length accepted\n",
+			 __func__);
+		return TC_FAIL;
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+static int verify_cmac_key(void)
+{
+	int result = TC_PASS;
+
+	TC_PRINT("Performing CMAC test #8 (reusable key object)\n");
+
+	const uint8_t k[BUF_LEN] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+		0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+	};
+	const size_t lens[4] = { 0, 16, 40, 64 };
+	struct tc_aes_key_sched_struct sched, sched2;
+	struct tc_cmac_key_struct key;
+	struct tc_cmac_struct s;
+	struct tc_cmac_msg_struct m;
+	uint8_t Tag[BUF_LEN];
+	unsigned int i, j;
+
+	(void)tc_cmac_key_set(&key, k, sizeof(k), &sched);
+
+	/* the same key object serves every message, one-shot or in pieces */
+	for (i = 0; i < 4; ++i) {
+		(void)tc_cmac_key_mac(Tag, sp800_38b_msg, lens[i], &key);
+		if (memcmp(Tag, sp800_38b_tags[i], BUF_LEN) != 0) {
+			TC_ERROR("%s: tc_cmac_key_mac failed on vector #%u\n",
+				 __func__, i + 1);
+			show("expected Tag =", sp800_38b_tags[i], BUF_LEN);
+			show("computed Tag =", Tag, BUF_LEN);
+			return TC_FAIL;
+		}
+
+		(void)tc_cmac_key_init(&m, &key);
+		for (j = 0; j < lens[i]; j += 7) {
+			(void)tc_cmac_key_update(&m, &sp800_38b_msg[j],
+						 lens[i] - j < 7 ? lens[i] - j : 7);
+		}
+		(void)tc_cmac_key_final(Tag, &m);
+		if (memcmp(Tag, sp800_38b_tags[i], BUF_LEN) != 0) {
+			TC_ERROR("%s: segmented MAC failed on vector #%u\n",
+				 __func__, i + 1);
+			show("expected Tag =", sp800_38b_tags[i], BUF_LEN);
+			show("computed Tag =", Tag, BUF_LEN);
+			return TC_FAIL;
+		}
+
+		/* segments ending on a block boundary, through the old API */
+		(void)tc_cmac_setup(&s, k, &sched2);
+		for (j = 0; j < lens[i]; j += 8) {
+			(void)tc_cmac_update(&s, &sp800_38b_msg[j], 8);
+		}
+		(void)tc_cmac_final(Tag, &s);
+		if (memcmp(Tag, sp800_38b_tags[i], BUF_LEN) != 0) {
+			TC_ERROR("%s: tc_cmac_update in 8 byte segments failed "
+				 "on vector #%u\n", __func__, i + 1);
+			show("expected Tag =", sp800_38b_tags[i], BUF_LEN);
+			show("computed Tag =", Tag, BUF_LEN);
+			return TC_FAIL;
+		}
+	}
+
+	/* a finished message state must not be usable again */
+	if (tc_cmac_key_update(&m, sp800_38b_msg, 16) != TC_CRYPTO_FAIL) {
+		TC_ERROR("%s: update accepted after final\n", __func__);
+		return TC_FAIL;
+	}
+
+	/* the countdown is per key: once spent, new messages are refused */
+	key.countdown = 1;
+	if (tc_cmac_key_mac(Tag, sp800_38b_msg, 16, &key) != TC_CRYPTO_SUCCESS ||
+	    tc_cmac_key_init(&m, &key) != TC_CRYPTO_FAIL) {
+		TC_ERROR("%s: re-key countdown not enforced\n", __func__);
+		return TC_FAIL;
+	}
+
+	(void)tc_cmac_key_erase(&key);
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+#if !defined(TINYCRYPT_AES_128_ONLY)
+static int verify_cmac_256_bit_key(void)
+{
+	int result = TC_PASS;
+
+	TC_PRINT("Performing CMAC test #6 (AES-256, 1 block msg):\n");
+
+	const uint8_t key[32] = {
+		0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe,
+		0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+		0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7,
+		0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4
+	};
+	const uint8_t msg[BUF_LEN] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+		0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a
+	};
+	const uint8_t tag[BUF_LEN] = {
+		0x28, 0xa7, 0x02, 0x3f, 0x45, 0x2e, 0x8f, 0x82,
+		0xbd, 0x4b, 0xf2, 0x8d, 0x8c, 0x37, 0xc3, 0x5c
+	};
+	struct tc_cmac_struct state;
+	struct tc_aes_key_sched_struct sched;
+	uint8_t Tag[BUF_LEN];
+
+	if (tc_cmac_setup_key_size(&state, key, 20, &sched) != 0) {
+		TC_ERROR("%s: accepted an invalid key size\n", __func__);
+		return TC_FAIL;
+	}
+
+	(void)tc_cmac_setup_key_size(&state, key, sizeof(key), &sched);
+	(void)tc_cmac_update(&state, msg, sizeof(msg));
+	(void)tc_cmac_final(Tag, &state);
+
+	if (memcmp(Tag, tag, BUF_LEN) != 0) {
+		TC_ERROR("%s: aes_cmac failed with 256 bit key\n", __func__);
+		show("expected Tag =", tag, sizeof(tag));
+		show("computed Tag =", Tag, sizeof(Tag));
+		return TC_FAIL;
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+#endif
+
 /*
  * Main task to test CMAC
  * effects:    returns 1 if all tests pass
@@ -304,6 +545,28 @@ int main(void)
 		goto exitTest;
 	}
 
+#if !defined(TINYCRYPT_AES_128_ONLY)
+	result = verify_cmac_256_bit_key();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("CMAC test #6 (256 bit key) failed.\n");
+		goto exitTest;
+	}
+#endif
+	(void) tc_cmac_setup(&state, key, &sched);
+	result = verify_cmac_mb(&state);
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("CMAC test #7 (multi-message) failed.\n");
+		goto exitTest;
+	}
+	result = verify_cmac_key();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("CMAC test #8 (key object) failed.\n");
+		goto exitTest;
+	}
+
 	TC_PRINT("All CMAC tests succeeded!\n");
 
 exitTest:
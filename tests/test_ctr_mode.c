@@ -36,6 +36,8 @@
 
   Scenarios tested include:
   - AES128 CTR mode encryption SP 800-38a tests
+  - AES128 CTR mode bulk path against a block-at-a-time reference
+  - AES256 CTR mode encryption SP 800-38a tests
 */
 
 #include <tinycrypt/ctr_mode.h>
@@ -113,6 +115,233 @@ unsigned int test_1_and_2(void)
         return result;
 }
 
+/*
+ * Block-at-a-time reference of CTR mode, as specified in SP 800-38a.
+ */
+static void ctr_reference(uint8_t *out, const uint8_t *in, unsigned int len,
+			  uint8_t *ctr, const TCAesKeySched_t sched)
+{
+	uint8_t keystream[TC_AES_BLOCK_SIZE];
+	unsigned int i;
+	int j;
+
+	for (i = 0; i < len; ++i) {
+		if ((i % TC_AES_BLOCK_SIZE) == 0) {
+			(void)tc_aes_encrypt(keystream, ctr, sched);
+			/* 32-bit big-endian increment of the last 4 bytes */
+			for (j = 15; j >= 12; --j) {
+				if (++ctr[j] != 0) {
+					break;
+				}
+			}
+		}
+		out[i] = in[i] ^ keystream[i % TC_AES_BLOCK_SIZE];
+	}
+}
+
+/*
+ * Bulk path against the reference: partial batches, tails and a counter
+ * wrapping around 2^32 in the middle of a batch, out of place and in place.
+ */
+unsigned int test_3(void)
+{
+        const uint8_t key[16] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+		0x09, 0xcf, 0x4f, 0x3c
+        };
+        const uint8_t ctr_init[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+		0xff, 0xff, 0xff, 0xfb
+        };
+	const unsigned int lengths[] = {
+		1, 15, 16, 17, 64, 127, 128, 129, 255, 1000
+	};
+	struct tc_aes_key_sched_struct sched;
+	uint8_t in[1000];
+	uint8_t expected[1000];
+	uint8_t computed[1000];
+	uint8_t ctr_ref[16];
+	uint8_t ctr[16];
+	unsigned int result = TC_PASS;
+	unsigned int i;
+
+	TC_PRINT("CTR test #3 (bulk path against reference):\n");
+	(void)tc_aes128_set_encrypt_key(&sched, key);
+	for (i = 0; i < sizeof(in); ++i) {
+		in[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+		(void)memcpy(ctr_ref, ctr_init, sizeof(ctr_ref));
+		ctr_reference(expected, in, lengths[i], ctr_ref, &sched);
+
+		(void)memcpy(ctr, ctr_init, sizeof(ctr));
+		if (tc_ctr_mode(computed, lengths[i], in, lengths[i], ctr,
+				&sched) == 0) {
+			TC_ERROR("CTR test #3 failed in %s.\n", __func__);
+			result = TC_FAIL;
+			goto exitTest3;
+		}
+		result = check_result(3, expected, lengths[i], computed,
+				      lengths[i]);
+		if (result == TC_FAIL) {
+			goto exitTest3;
+		}
+		result = check_result(3, ctr_ref, sizeof(ctr_ref), ctr,
+				      sizeof(ctr));
+		if (result == TC_FAIL) {
+			goto exitTest3;
+		}
+
+		/* in place */
+		(void)memcpy(computed, in, lengths[i]);
+		(void)memcpy(ctr, ctr_init, sizeof(ctr));
+		(void)tc_ctr_mode(computed, lengths[i], computed, lengths[i],
+				  ctr, &sched);
+		result = check_result(3, expected, lengths[i], computed,
+				      lengths[i]);
+		if (result == TC_FAIL) {
+			goto exitTest3;
+		}
+	}
+
+ exitTest3:
+	TC_END_RESULT(result);
+	return result;
+}
+
+#if !defined(TINYCRYPT_AES_128_ONLY)
+/*
+ * NIST SP 800-38a F.5.5 (CTR-AES256.Encrypt).
+ */
+unsigned int test_4(void)
+{
+        const uint8_t key[32] = {
+		0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0,
+		0x85, 0x7d, 0x77, 0x81, 0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7,
+		0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4
+        };
+        uint8_t ctr[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+		0xfc, 0xfd, 0xfe, 0xff
+        };
+        const uint8_t plaintext[64] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11,
+		0x73, 0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+		0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46,
+		0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+		0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b,
+		0xe6, 0x6c, 0x37, 0x10
+        };
+        const uint8_t ciphertext[64] = {
+		0x60, 0x1e, 0xc3, 0x13, 0x77, 0x57, 0x89, 0xa5, 0xb7, 0xa7, 0xf5, 0x04,
+		0xbb, 0xf3, 0xd2, 0x28, 0xf4, 0x43, 0xe3, 0xca, 0x4d, 0x62, 0xb5, 0x9a,
+		0xca, 0x84, 0xe9, 0x90, 0xca, 0xca, 0xf5, 0xc5, 0x2b, 0x09, 0x30, 0xda,
+		0xa2, 0x3d, 0xe9, 0x4c, 0xe8, 0x70, 0x17, 0xba, 0x2d, 0x84, 0x98, 0x8d,
+		0xdf, 0xc9, 0xc5, 0x8d, 0xb6, 0x7a, 0xad, 0xa6, 0x13, 0xc2, 0xdd, 0x08,
+		0x45, 0x79, 0x41, 0xa6
+        };
+        struct tc_aes_key_sched_struct sched;
+        uint8_t out[64];
+        unsigned int result = TC_PASS;
+
+        TC_PRINT("CTR test #4 (AES-256 SP 800-38a tests):\n");
+        (void)tc_aes_set_encrypt_key(&sched, key, sizeof(key));
+
+        if (tc_ctr_mode(out, sizeof(out), plaintext, sizeof(plaintext), ctr,
+			&sched) == 0) {
+                TC_ERROR("CTR test #4 failed in %s.\n", __func__);
+                result = TC_FAIL;
+                goto exitTest4;
+        }
+
+        result = check_result(4, ciphertext, sizeof(ciphertext), out,
+			      sizeof(out));
+
+ exitTest4:
+        TC_END_RESULT(result);
+        return result;
+}
+#endif
+
+/*
+ * Scatter-gather against the contiguous path: input and output split at
+ * different places, empty segments included, then in place.
+ */
+unsigned int test_5(void)
+{
+        const uint8_t key[16] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+		0x09, 0xcf, 0x4f, 0x3c
+        };
+        const uint8_t ctr_init[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+		0xff, 0xff, 0xff, 0xfb
+        };
+	const unsigned int in_split[] = { 1, 0, 15, 17, 200, 3, 64, 0, 300 };
+	const unsigned int out_split[] = { 16, 7, 0, 129, 250, 198 };
+	struct tc_iovec in_iov[9];
+	struct tc_iovec out_iov[6];
+	struct tc_aes_key_sched_struct sched;
+	uint8_t in[600];
+	uint8_t expected[600];
+	uint8_t computed[600];
+	uint8_t ctr_ref[16];
+	uint8_t ctr[16];
+	unsigned int result = TC_PASS;
+	unsigned int i, off;
+
+	TC_PRINT("CTR test #5 (scatter-gather):\n");
+	(void)tc_aes128_set_encrypt_key(&sched, key);
+	for (i = 0; i < sizeof(in); ++i) {
+		in[i] = (uint8_t)(i * 7 + 3);
+	}
+	(void)memcpy(ctr_ref, ctr_init, sizeof(ctr_ref));
+	(void)tc_ctr_mode(expected, sizeof(in), in, sizeof(in), ctr_ref,
+			  &sched);
+
+	for (i = off = 0; i < 9; off += in_split[i++]) {
+		in_iov[i].base = &in[off];
+		in_iov[i].len = in_split[i];
+	}
+	for (i = off = 0; i < 6; off += out_split[i++]) {
+		out_iov[i].base = &computed[off];
+		out_iov[i].len = out_split[i];
+	}
+
+	(void)memcpy(ctr, ctr_init, sizeof(ctr));
+	if (tc_ctr_modev(out_iov, 6, in_iov, 9, ctr, &sched) == 0) {
+		TC_ERROR("CTR test #5 failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest5;
+	}
+	result = check_result(5, expected, sizeof(expected), computed,
+			      sizeof(computed));
+	if (result == TC_FAIL) {
+		goto exitTest5;
+	}
+	result = check_result(5, ctr_ref, sizeof(ctr_ref), ctr, sizeof(ctr));
+	if (result == TC_FAIL) {
+		goto exitTest5;
+	}
+
+	/* in place, and a length mismatch */
+	(void)memcpy(ctr, ctr_init, sizeof(ctr));
+	(void)tc_ctr_modev(in_iov, 9, in_iov, 9, ctr, &sched);
+	result = check_result(5, expected, sizeof(expected), in, sizeof(in));
+	if (result == TC_FAIL) {
+		goto exitTest5;
+	}
+	if (tc_ctr_modev(out_iov, 5, in_iov, 9, ctr, &sched) != 0) {
+		TC_ERROR("CTR test #5 accepted mismatched lengths.\n");
+		result = TC_FAIL;
+	}
+
+ exitTest5:
+	TC_END_RESULT(result);
+	return result;
+}
+
 /*
  * Main task to test AES
  */
@@ -130,6 +359,26 @@ int main(void)
                 goto exitTest;
         }
 
+        result = test_3();
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("CTR test #3 failed.\n");
+                goto exitTest;
+        }
+
+        result = test_5();
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("CTR test #5 failed.\n");
+                goto exitTest;
+        }
+
+#if !defined(TINYCRYPT_AES_128_ONLY)
+        result = test_4();
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("CTR test #4 failed.\n");
+                goto exitTest;
+        }
+#endif
+
         TC_PRINT("All CTR tests succeeded!\n");
 
  exitTest:
@@ -529,6 +529,76 @@ static int test_robustness(void)
 	return result;
 }
 
+static int test_bulk(void)
+{
+	static uint8_t bulk[140000U];
+	static uint8_t split[sizeof bulk];
+	int result = TC_PASS;
+	uint8_t entropy[32U] = {0U}; /* value not important */
+	uint8_t additional_input[32] = {0U};
+	TCCtrPrng_t ctx, ref;
+	int ret;
+
+	memset(additional_input, 0x5A, sizeof additional_input);
+	(void)tc_ctr_prng_init(&ctx, entropy, sizeof entropy, 0, 0U);
+	ref = ctx;
+
+	/* a bulk request is a run of 65520 byte generate requests */
+	ret = tc_ctr_prng_generate_bulk(&ctx, additional_input,
+					sizeof additional_input, bulk,
+					sizeof bulk);
+	if (1 != ret) {
+		result = TC_FAIL;
+		goto exitTest;
+	}
+	(void)tc_ctr_prng_generate(&ref, additional_input,
+				   sizeof additional_input, split, 65520U);
+	(void)tc_ctr_prng_generate(&ref, 0, 0, &split[65520U], 65520U);
+	(void)tc_ctr_prng_generate(&ref, 0, 0, &split[131040U],
+				   sizeof split - 131040U);
+	if (0 != memcmp(bulk, split, sizeof bulk) ||
+	    0 != memcmp(ctx.V, ref.V, sizeof ctx.V) ||
+	    ctx.reseedCount != ref.reseedCount) {
+		result = TC_FAIL;
+		goto exitTest;
+	}
+
+	/* a request that would cross the reseed threshold produces nothing */
+	ctx.reseedCount = 0x1000000000000ULL - 1U;
+	memset(bulk, 0x00, sizeof bulk);
+	ret = tc_ctr_prng_generate_bulk(&ctx, 0, 0, bulk, 2U * 65520U + 1U);
+	if ((-1 != ret) || (0U != bulk[0]) ||
+	    (ctx.reseedCount != 0x1000000000000ULL - 1U)) {
+		result = TC_FAIL;
+		goto exitTest;
+	}
+
+	ret = tc_ctr_prng_generate_bulk(&ctx, 0, 0, bulk, 2U * 65520U);
+	if (1 != ret) {
+		result = TC_FAIL;
+		goto exitTest;
+	}
+
+	ret = tc_ctr_prng_generate_bulk(&ctx, 0, 0, bulk, sizeof bulk);
+	if (-1 != ret) {
+		result = TC_FAIL;
+		goto exitTest;
+	}
+
+	ret = tc_ctr_prng_generate_bulk(0, 0, 0, bulk, sizeof bulk);
+	if (0 != ret) {
+		result = TC_FAIL;
+		goto exitTest;
+	}
+
+	exitTest:
+	if (TC_FAIL == result) {
+		TC_ERROR("CTR PRNG bulk tests failed\n");
+	}
+
+	return result;
+}
+
 /*
  * Main task to test CTR PRNG
  */
@@ -556,6 +626,10 @@ int main(void)
 		goto exitTest;
 	}
 
+	if (TC_PASS != test_bulk()) {
+		goto exitTest;
+	}
+
 	TC_PRINT("All CTR PRNG tests succeeded!\n");
 
 	exitTest:
@@ -72,13 +72,13 @@ int ecdh_vectors(char **qx_vec, char **qy_vec, char **d_vec, char **z_vec,
 		  int tests, int verbose)
 {
 
-	unsigned int pub[2*NUM_ECC_WORDS];
-	unsigned int prv[NUM_ECC_WORDS];
-	unsigned int z[NUM_ECC_WORDS];
+	uECC_word_t pub[2*NUM_ECC_WORDS];
+	uECC_word_t prv[NUM_ECC_WORDS];
+	uECC_word_t z[NUM_ECC_WORDS];
 	unsigned int result = TC_PASS;
 
 	int rc;
-	unsigned int exp_z[NUM_ECC_WORDS];
+	uECC_word_t exp_z[NUM_ECC_WORDS];
 
 	const struct uECC_Curve_t * curve = uECC_secp256r1();
 
@@ -308,7 +308,7 @@ int pkv_vectors(char **qx_vec, char **qy_vec, char **res_vec, int tests,
 		 bool verbose)
 {
 
-	unsigned int pub[2 * NUM_ECC_WORDS];
+	uECC_word_t pub[2 * NUM_ECC_WORDS];
 	uint8_t _public[2 * NUM_ECC_BYTES];
 	int rc;
 	int exp_rc;
@@ -477,6 +477,516 @@ int montecarlo_ecdh(int num_tests, bool verbose)
         return result;
 }
 
+int mod_inverse(int num_tests, bool verbose)
+{
+	int i, j;
+	uECC_word_t x[NUM_ECC_WORDS];
+	uECC_word_t inv[NUM_ECC_WORDS];
+	uECC_word_t one[NUM_ECC_WORDS];
+	const uECC_word_t *mod;
+        unsigned int result = TC_PASS;
+
+	const struct uECC_Curve_t * curve = uECC_secp256r1();
+
+	TC_PRINT("Test #5: modular inversion modulo p and n ");
+	TC_PRINT("NIST-p256\n  ");
+
+	uECC_vli_clear(one, NUM_ECC_WORDS);
+	one[0] = 1;
+
+	for (i = 0; i < num_tests; ++i) {
+		if (verbose) {
+			TC_PRINT(".");
+			fflush(stdout);
+		}
+
+		for (j = 0; j < 2; ++j) {
+			mod = j ? curve->n : curve->p;
+			/* 1, mod - 1, then random values in [1, mod): */
+			if (i == 0) {
+				uECC_vli_set(x, one, NUM_ECC_WORDS);
+			} else if (i == 1) {
+				uECC_vli_sub(x, mod, one, NUM_ECC_WORDS);
+			} else if (!uECC_generate_random_int(x, mod,
+							     NUM_ECC_WORDS)) {
+				TC_ERROR("uECC_generate_random_int() failed\n");
+				result = TC_FAIL;
+				goto exitTest1;
+			}
+
+			uECC_vli_modInv(inv, x, mod, NUM_ECC_WORDS);
+			uECC_vli_modMult(inv, inv, x, mod, NUM_ECC_WORDS);
+			if (uECC_vli_equal(inv, one, NUM_ECC_WORDS) != 0) {
+				TC_ERROR("x * (1 / x) != 1 on test %d\n", i);
+				result = TC_FAIL;
+				goto exitTest1;
+			}
+		}
+	}
+
+	/* 0 has no inverse and gives 0. */
+	uECC_vli_clear(x, NUM_ECC_WORDS);
+	uECC_vli_modInv(inv, x, curve->p, NUM_ECC_WORDS);
+	if (!uECC_vli_isZero(inv, NUM_ECC_WORDS)) {
+		TC_ERROR("1 / 0 is not 0\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	TC_PRINT("\n");
+
+ exitTest1:
+        TC_END_RESULT(result);
+        return result;
+}
+
+int dh_context(int num_tests, bool verbose)
+{
+	int i;
+	uint8_t private1[NUM_ECC_BYTES] = {0};
+	uint8_t private2[NUM_ECC_BYTES] = {0};
+	uint8_t public1[2*NUM_ECC_BYTES] = {0};
+	uint8_t public2[2*NUM_ECC_BYTES] = {0};
+	uint8_t secret1[NUM_ECC_BYTES] = {0};
+	uint8_t secret2[NUM_ECC_BYTES] = {0};
+	struct uECC_dh_ctx_t ctx;
+        unsigned int result = TC_PASS;
+
+	const struct uECC_Curve_t * curve = uECC_secp256r1();
+
+	TC_PRINT("Test #6: EC-DH context (%d secrets with one peer) ", num_tests);
+	TC_PRINT("NIST-p256\n  ");
+
+	if (!uECC_make_key(public2, private2, curve) ||
+	    !uECC_dh_ctx_init(&ctx, public2, curve)) {
+		TC_ERROR("context setup failed\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	for (i = 0; i < num_tests; ++i) {
+		if (verbose) {
+			TC_PRINT(".");
+			fflush(stdout);
+		}
+
+		if (!uECC_make_key(public1, private1, curve)) {
+			TC_ERROR("uECC_make_key() failed\n");
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+
+		if (!uECC_dh_ctx_shared_secret(&ctx, private1, secret1) ||
+		    !uECC_shared_secret(public1, private2, secret2, curve)) {
+			TC_ERROR("shared secret failed on test %d\n", i);
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+
+		if (memcmp(secret1, secret2, sizeof(secret1)) != 0) {
+			TC_ERROR("context and uECC_shared_secret() disagree on "
+				 "test %d\n", i);
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+	}
+
+	/* A point off the curve is refused. */
+	public2[2*NUM_ECC_BYTES - 1] ^= 1;
+	if (uECC_dh_ctx_init(&ctx, public2, curve)) {
+		TC_ERROR("context accepted an invalid public key\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	TC_PRINT("\n");
+
+ exitTest1:
+	uECC_dh_ctx_clear(&ctx);
+        TC_END_RESULT(result);
+        return result;
+}
+
+#if uECC_FIXED_BASE_TEETH > 0
+int fixed_base_comb(int num_tests, bool verbose)
+{
+	int i;
+	uECC_word_t k[NUM_ECC_WORDS];
+	uECC_word_t k0[NUM_ECC_WORDS];
+	uECC_word_t k1[NUM_ECC_WORDS];
+	uECC_word_t expected[2 * NUM_ECC_WORDS];
+	uECC_word_t computed[2 * NUM_ECC_WORDS];
+	uECC_word_t carry;
+	unsigned int spacing;
+	unsigned int bit;
+	unsigned int j;
+	unsigned int t;
+        unsigned int result = TC_PASS;
+
+	const struct uECC_Curve_t * curve = uECC_secp256r1();
+
+	TC_PRINT("Test #7: fixed-base comb (%d teeth) against the Montgomery "
+		 "ladder ", uECC_FIXED_BASE_TEETH);
+	TC_PRINT("NIST-p256\n  ");
+
+	for (i = 0; i < num_tests; ++i) {
+		if (verbose) {
+			TC_PRINT(".");
+			fflush(stdout);
+		}
+
+		/* 1 * G and (n - 1) * G = -G first: the ladder cannot be used
+		 * as the reference there. Random scalars follow. */
+		if (i == 0) {
+			uECC_vli_clear(k, NUM_ECC_WORDS);
+			k[0] = 1;
+			uECC_vli_set(expected, curve->G, 2 * NUM_ECC_WORDS);
+		} else if (i == 1) {
+			uECC_vli_set(k, curve->n, NUM_ECC_WORDS);
+			k[0] -= 1;
+			uECC_vli_set(expected, curve->G, NUM_ECC_WORDS);
+			uECC_vli_sub(expected + NUM_ECC_WORDS, curve->p,
+				     curve->G + NUM_ECC_WORDS, NUM_ECC_WORDS);
+		} else if (!uECC_generate_random_int(k, curve->n,
+						     NUM_ECC_WORDS)) {
+			TC_ERROR("uECC_generate_random_int() failed\n");
+			result = TC_FAIL;
+			goto exitTest1;
+		} else {
+			carry = regularize_k(k, k0, k1, curve);
+			EccPoint_mult(expected, curve->G, carry ? k0 : k1, 0,
+				      curve->num_n_bits + 1, curve);
+		}
+
+		EccPoint_mult_base(computed, k, curve);
+
+		if (memcmp(expected, computed, sizeof(expected)) != 0) {
+			TC_ERROR("comb and ladder disagree on test %d\n", i);
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+	}
+
+	/* Every table entry on its own: with all the bits of the scalar in
+	 * column 0 of the comb, the only addition is that of entry j - 1 to the
+	 * point at infinity. */
+	spacing = (NUM_ECC_BYTES * 8 + uECC_FIXED_BASE_TEETH - 1) /
+		  uECC_FIXED_BASE_TEETH;
+	for (j = 1; j < (1u << uECC_FIXED_BASE_TEETH); ++j) {
+		uECC_vli_clear(k, NUM_ECC_WORDS);
+		for (t = 0; t < uECC_FIXED_BASE_TEETH; ++t) {
+			if (j & (1u << t)) {
+				bit = t * spacing;
+				k[bit / uECC_WORD_BITS] |=
+					(uECC_word_t) 1 << (bit % uECC_WORD_BITS);
+			}
+		}
+		if (j == 1) {
+			uECC_vli_set(expected, curve->G, 2 * NUM_ECC_WORDS);
+		} else {
+			carry = regularize_k(k, k0, k1, curve);
+			EccPoint_mult(expected, curve->G, carry ? k0 : k1, 0,
+				      curve->num_n_bits + 1, curve);
+		}
+
+		EccPoint_mult_base(computed, k, curve);
+
+		if (memcmp(expected, computed, sizeof(expected)) != 0) {
+			TC_ERROR("comb table entry %u differs from the ladder\n",
+				 j - 1);
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+	}
+
+	/* 0 * G is the point at infinity, encoded as all zeroes. */
+	uECC_vli_clear(k, NUM_ECC_WORDS);
+	EccPoint_mult_base(computed, k, curve);
+	if (!EccPoint_isZero(computed, curve)) {
+		TC_ERROR("0 * G is not the point at infinity\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	TC_PRINT("\n");
+
+ exitTest1:
+        TC_END_RESULT(result);
+        return result;
+}
+#endif
+
+int compressed_keys(int num_tests, bool verbose)
+{
+	int i;
+	uint8_t private[NUM_ECC_BYTES] = {0};
+	uint8_t public[2*NUM_ECC_BYTES] = {0};
+	uint8_t decompressed[2*NUM_ECC_BYTES] = {0};
+	uint8_t compressed[NUM_ECC_BYTES + 1] = {0};
+	int rejected = 0;
+        unsigned int result = TC_PASS;
+
+	const struct uECC_Curve_t * curve = uECC_secp256r1();
+
+	TC_PRINT("Test #8: compressed public keys (%d keys) ", num_tests);
+	TC_PRINT("NIST-p256\n  ");
+
+	/* G has an odd y, so it compresses to 03 || Gx. */
+	uECC_vli_nativeToBytes(public, NUM_ECC_BYTES, curve->G);
+	uECC_vli_nativeToBytes(public + NUM_ECC_BYTES, NUM_ECC_BYTES,
+			       curve->G + NUM_ECC_WORDS);
+	uECC_compress(public, compressed, curve);
+	if (compressed[0] != 0x03 ||
+	    memcmp(compressed + 1, public, NUM_ECC_BYTES) != 0) {
+		TC_ERROR("wrong compressed form of the generator\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	/* 02 || Gx is -G, whose y is p - Gy. */
+	compressed[0] = 0x02;
+	if (!uECC_decompress(compressed, decompressed, curve) ||
+	    memcmp(decompressed, public, NUM_ECC_BYTES) != 0 ||
+	    memcmp(decompressed + NUM_ECC_BYTES, public + NUM_ECC_BYTES,
+		   NUM_ECC_BYTES) == 0 ||
+	    uECC_valid_public_key(decompressed, curve) != 0) {
+		TC_ERROR("02 || Gx did not decompress to -G\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	for (i = 0; i < num_tests; ++i) {
+		if (verbose) {
+			TC_PRINT(".");
+			fflush(stdout);
+		}
+
+		if (!uECC_make_key(public, private, curve)) {
+			TC_ERROR("uECC_make_key() failed\n");
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+
+		uECC_compress(public, compressed, curve);
+		if (!uECC_decompress(compressed, decompressed, curve) ||
+		    memcmp(decompressed, public, sizeof(public)) != 0) {
+			TC_ERROR("round trip failed on test %d\n", i);
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+
+		/* About half of all x are not on the curve. */
+		compressed[NUM_ECC_BYTES] ^= 1;
+		if (!uECC_decompress(compressed, decompressed, curve)) {
+			++rejected;
+		} else if (uECC_valid_public_key(decompressed, curve) != 0) {
+			TC_ERROR("decompressed an invalid point on test %d\n", i);
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+		compressed[NUM_ECC_BYTES] ^= 1;
+
+		compressed[0] = 0x04;
+		if (uECC_decompress(compressed, decompressed, curve)) {
+			TC_ERROR("accepted prefix 04 on test %d\n", i);
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+	}
+
+	if (num_tests >= 32 && (rejected == 0 || rejected == num_tests)) {
+		TC_ERROR("%d of %d perturbed x were rejected\n", rejected,
+			 num_tests);
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	/* x = p is out of range. */
+	uECC_vli_nativeToBytes(compressed + 1, NUM_ECC_BYTES, curve->p);
+	compressed[0] = 0x02;
+	if (uECC_decompress(compressed, decompressed, curve)) {
+		TC_ERROR("accepted x = p\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	TC_PRINT("\n");
+
+ exitTest1:
+        TC_END_RESULT(result);
+        return result;
+}
+
+#if uECC_ENABLE_STATS
+int ecc_stats(bool verbose)
+{
+	uint8_t private1[NUM_ECC_BYTES] = {0};
+	uint8_t private2[NUM_ECC_BYTES] = {0};
+	uint8_t public1[2*NUM_ECC_BYTES] = {0};
+	uint8_t public2[2*NUM_ECC_BYTES] = {0};
+	uint8_t secret[NUM_ECC_BYTES] = {0};
+	struct uECC_stats stats;
+        unsigned int result = TC_PASS;
+
+	const struct uECC_Curve_t * curve = uECC_secp256r1();
+
+	(void)verbose;
+	TC_PRINT("Test #9: operation counters ");
+	TC_PRINT("NIST-p256\n  ");
+
+	if (!uECC_make_key(public1, private1, curve) ||
+	    !uECC_make_key(public2, private2, curve)) {
+		TC_ERROR("uECC_make_key() failed\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	uECC_stats_reset();
+	if (!uECC_shared_secret(public1, private2, secret, curve)) {
+		TC_ERROR("uECC_shared_secret() failed\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+	uECC_stats_get(&stats);
+
+	TC_PRINT("point mults %u, adds %u, co-Z adds %u, inversions %u, "
+		 "field mults %u\n  ", (unsigned)stats.count[uECC_STAT_POINT_MULT],
+		 (unsigned)stats.count[uECC_STAT_ADD],
+		 (unsigned)stats.count[uECC_STAT_ADDC],
+		 (unsigned)stats.count[uECC_STAT_INV],
+		 (unsigned)stats.count[uECC_STAT_MULT]);
+
+	if (stats.count[uECC_STAT_POINT_MULT] == 0 ||
+	    stats.count[uECC_STAT_ADD] == 0 ||
+	    stats.count[uECC_STAT_ADDC] == 0 ||
+	    stats.count[uECC_STAT_INV] == 0 ||
+	    stats.count[uECC_STAT_MULT] == 0) {
+		TC_ERROR("a one-point-multiplication operation was not counted\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	/* Reset clears every counter. */
+	uECC_stats_reset();
+	uECC_stats_get(&stats);
+	if (stats.count[uECC_STAT_POINT_MULT] != 0 ||
+	    stats.count[uECC_STAT_MULT] != 0) {
+		TC_ERROR("uECC_stats_reset() left counts behind\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	TC_PRINT("\n");
+
+ exitTest1:
+        TC_END_RESULT(result);
+        return result;
+}
+#endif
+
+#if uECC_SUPPORTS_secp256k1
+int secp256k1_dh(int num_tests, bool verbose)
+{
+	int i;
+	uint8_t private1[NUM_ECC_BYTES] = {0};
+	uint8_t private2[NUM_ECC_BYTES] = {0};
+	uint8_t public1[2*NUM_ECC_BYTES] = {0};
+	uint8_t public2[2*NUM_ECC_BYTES] = {0};
+	uint8_t expected[2*NUM_ECC_BYTES] = {0};
+	uint8_t secret1[NUM_ECC_BYTES] = {0};
+	uint8_t secret2[NUM_ECC_BYTES] = {0};
+	uint8_t compressed[NUM_ECC_BYTES + 1] = {0};
+        unsigned int result = TC_PASS;
+
+	const struct uECC_Curve_t * curve = uECC_secp256k1();
+
+	TC_PRINT("Test #10: EC-DH on secp256k1 (%d key pairs) ", num_tests);
+	TC_PRINT("secp256k1\n  ");
+
+	/* Known key pairs and their shared secret: */
+	hex2bin(private1, sizeof(private1),
+		"750b79840a35e888cea8684b60033cd65db233956ea88f4b4f72fd3f7d254db9",
+		64);
+	hex2bin(private2, sizeof(private2),
+		"aacdabbb49c9c6072c54a01283037cadfde8ec5e3e1544596ebbec4cc598e828",
+		64);
+	hex2bin(expected, sizeof(expected),
+		"aeee6fa56d9117ea1ed6380b85259a1a47fd32d6a6c1dae1c9a7e4f7673883c2"
+		"4249f2466cf01e603e6ea360a004343db643aaecd52c9ac38d71665808843fda",
+		128);
+	if (!uECC_compute_public_key(private1, public1, curve) ||
+	    memcmp(public1, expected, sizeof(public1)) != 0) {
+		TC_ERROR("wrong public key for the first private key\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+	hex2bin(expected, sizeof(expected),
+		"d50d5d95a8775e9df10cae4255479398d5f1bce9d94b5d93e3d88edf9869df1a"
+		"805b09e4d6ba75d1f5a1d98dbdfda053f9f75204ed8b06775850d23e3e7574f7",
+		128);
+	if (!uECC_compute_public_key(private2, public2, curve) ||
+	    memcmp(public2, expected, sizeof(public2)) != 0) {
+		TC_ERROR("wrong public key for the second private key\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+	hex2bin(expected, sizeof(expected),
+		"bdbc6f022ab01ac4ab0ce703c7b42d95d555460b27e1ec7393086d01a643a43f",
+		64);
+	if (uECC_valid_public_key(public1, curve) != 0 ||
+	    !uECC_shared_secret(public2, private1, secret1, curve) ||
+	    memcmp(secret1, expected, sizeof(secret1)) != 0) {
+		TC_ERROR("wrong shared secret\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	for (i = 0; i < num_tests; ++i) {
+		if (verbose) {
+			TC_PRINT(".");
+			fflush(stdout);
+		}
+
+		if (!uECC_make_key(public1, private1, curve) ||
+		    !uECC_make_key(public2, private2, curve)) {
+			TC_ERROR("uECC_make_key() failed\n");
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+
+		if (!uECC_shared_secret(public1, private2, secret1, curve) ||
+		    !uECC_shared_secret(public2, private1, secret2, curve) ||
+		    memcmp(secret1, secret2, sizeof(secret1)) != 0) {
+			TC_ERROR("shared secrets differ on test %d\n", i);
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+
+		uECC_compress(public1, compressed, curve);
+		if (!uECC_decompress(compressed, expected, curve) ||
+		    memcmp(expected, public1, sizeof(public1)) != 0) {
+			TC_ERROR("compression round trip failed on test %d\n", i);
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+	}
+
+	/* A p-256 key is not on secp256k1. */
+	if (!uECC_make_key(public1, private1, uECC_secp256r1()) ||
+	    uECC_valid_public_key(public1, curve) == 0) {
+		TC_ERROR("accepted a p-256 key on secp256k1\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	TC_PRINT("\n");
+
+ exitTest1:
+        TC_END_RESULT(result);
+        return result;
+}
+#endif
+
 int main()
 {
         unsigned int result = TC_PASS;
@@ -512,6 +1022,48 @@ int main()
                 TC_ERROR("montecarlo_ecdh test failed.\n");
                 goto exitTest;
         }
+	TC_PRINT("Performing mod_inverse test:\n");
+	result = mod_inverse(100, verbose);
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("mod_inverse test failed.\n");
+                goto exitTest;
+        }
+	TC_PRINT("Performing dh_context test:\n");
+	result = dh_context(10, verbose);
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("dh_context test failed.\n");
+                goto exitTest;
+        }
+#if uECC_FIXED_BASE_TEETH > 0
+	TC_PRINT("Performing fixed_base_comb test:\n");
+	result = fixed_base_comb(100, verbose);
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("fixed_base_comb test failed.\n");
+                goto exitTest;
+        }
+#endif
+	TC_PRINT("Performing compressed_keys test:\n");
+	result = compressed_keys(100, verbose);
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("compressed_keys test failed.\n");
+                goto exitTest;
+        }
+#if uECC_SUPPORTS_secp256k1
+	TC_PRINT("Performing secp256k1_dh test:\n");
+	result = secp256k1_dh(20, verbose);
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("secp256k1_dh test failed.\n");
+                goto exitTest;
+        }
+#endif
+#if uECC_ENABLE_STATS
+	TC_PRINT("Performing ecc_stats test:\n");
+	result = ecc_stats(verbose);
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("ecc_stats test failed.\n");
+                goto exitTest;
+        }
+#endif
 
         TC_PRINT("All EC-DH tests succeeded!\n");
 
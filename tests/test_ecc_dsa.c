@@ -61,6 +61,7 @@
 #include <tinycrypt/ecc_dh.h>
 #include <tinycrypt/constants.h>
 #include <tinycrypt/sha256.h>
+#include <tinycrypt/hmac_prng.h>
 #include <test_utils.h>
 #include <test_ecc_utils.h>
 
@@ -78,18 +79,18 @@ int sign_vectors(TCSha256State_t hash, char **d_vec, char **k_vec,
 		 char **s_vec, int tests, bool verbose)
 {
 
-	unsigned int k[NUM_ECC_WORDS];
-	unsigned int private[NUM_ECC_WORDS];
+	uECC_word_t k[NUM_ECC_WORDS];
+	uECC_word_t private[NUM_ECC_WORDS];
 	uint8_t private_bytes[NUM_ECC_BYTES];
-	unsigned int sig[2 * NUM_ECC_WORDS];
+	uECC_word_t sig[2 * NUM_ECC_WORDS];
 	uint8_t sig_bytes[2 * NUM_ECC_BYTES];
-	unsigned int digest[TC_SHA256_DIGEST_SIZE / 4];
+	uECC_word_t digest[TC_SHA256_DIGEST_SIZE / uECC_WORD_SIZE];
 	uint8_t  digest_bytes[TC_SHA256_DIGEST_SIZE];
 	unsigned int result = TC_PASS;
 
 	/* expected outputs (converted input vectors) */
-	unsigned int exp_r[NUM_ECC_WORDS];
-	unsigned int exp_s[NUM_ECC_WORDS];
+	uECC_word_t exp_r[NUM_ECC_WORDS];
+	uECC_word_t exp_s[NUM_ECC_WORDS];
 
 	uint8_t msg[BUF_SIZE];
 	size_t msglen;
@@ -121,12 +122,12 @@ int sign_vectors(TCSha256State_t hash, char **d_vec, char **k_vec,
 
 		/* if digest larger than ECC scalar, drop the end
 		 * if digest smaller than ECC scalar, zero-pad front */
-		int hash_dwords = TC_SHA256_DIGEST_SIZE / 4;
+		int hash_dwords = TC_SHA256_DIGEST_SIZE / uECC_WORD_SIZE;
 		if (NUM_ECC_WORDS < hash_dwords) {
 			hash_dwords = NUM_ECC_WORDS;
 		}
 
-		memset(digest, 0, NUM_ECC_BYTES - 4 * hash_dwords);
+		memset(digest, 0, NUM_ECC_BYTES - uECC_WORD_SIZE * hash_dwords);
 		uECC_vli_bytesToNative(digest + (NUM_ECC_WORDS-hash_dwords),
 				        digest_bytes, TC_SHA256_DIGEST_SIZE);
 
@@ -345,12 +346,12 @@ int vrfy_vectors(TCSha256State_t hash, char **msg_vec, char **qx_vec, char **qy_
 {
 
 	const struct uECC_Curve_t * curve = uECC_secp256r1();
-	unsigned int pub[2 * NUM_ECC_WORDS];
+	uECC_word_t pub[2 * NUM_ECC_WORDS];
 	uint8_t pub_bytes[2 * NUM_ECC_BYTES];
-	unsigned int sig[2 * NUM_ECC_WORDS];
+	uECC_word_t sig[2 * NUM_ECC_WORDS];
 	uint8_t sig_bytes[2 * NUM_ECC_BYTES];
 	uint8_t  digest_bytes[TC_SHA256_DIGEST_SIZE];
-	unsigned int digest[TC_SHA256_DIGEST_SIZE / 4];
+	uECC_word_t digest[TC_SHA256_DIGEST_SIZE / uECC_WORD_SIZE];
 	unsigned int result = TC_PASS;
 
 	int rc;
@@ -388,12 +389,12 @@ int vrfy_vectors(TCSha256State_t hash, char **msg_vec, char **qx_vec, char **qy_
 
 		/* if digest larger than ECC scalar, drop the end
 		 * if digest smaller than ECC scalar, zero-pad front */
-		int hash_dwords = TC_SHA256_DIGEST_SIZE / 4;
+		int hash_dwords = TC_SHA256_DIGEST_SIZE / uECC_WORD_SIZE;
 		if (NUM_ECC_WORDS < hash_dwords) {
 			hash_dwords = NUM_ECC_WORDS;
 		}
 
-		memset(digest, 0, NUM_ECC_BYTES - 4 * hash_dwords);
+		memset(digest, 0, NUM_ECC_BYTES - uECC_WORD_SIZE * hash_dwords);
 		uECC_vli_bytesToNative(digest + (NUM_ECC_WORDS-hash_dwords), digest_bytes,
 				       TC_SHA256_DIGEST_SIZE);
 
@@ -595,7 +596,7 @@ int montecarlo_signverify(int num_tests, bool verbose)
 	uint8_t private[NUM_ECC_BYTES];
 	uint8_t public[2*NUM_ECC_BYTES];
 	uint8_t hash[NUM_ECC_BYTES];
-	unsigned int hash_words[NUM_ECC_WORDS];
+	uECC_word_t hash_words[NUM_ECC_WORDS];
 	uint8_t sig[2*NUM_ECC_BYTES];
 
 	const struct uECC_Curve_t * curve = uECC_secp256r1();
@@ -632,6 +633,575 @@ int montecarlo_signverify(int num_tests, bool verbose)
 	return TC_PASS;
 }
 
+#if uECC_VERIFY_WNAF_WINDOW > 0
+/* affine result = k * point, through the Montgomery ladder */
+static void ladder_mult(uECC_word_t *result, const uECC_word_t *point,
+			const uECC_word_t *k, uECC_Curve curve)
+{
+	uECC_word_t k0[NUM_ECC_WORDS];
+	uECC_word_t k1[NUM_ECC_WORDS];
+	uECC_word_t carry = regularize_k(k, k0, k1, curve);
+
+	EccPoint_mult(result, point, carry ? k0 : k1, 0, curve->num_n_bits + 1,
+		      curve);
+}
+
+int wnaf_double_mult(int num_tests, bool verbose)
+{
+	printf("Test #4: wNAF u1*G + u2*Q (%d random scalar pairs) ", num_tests);
+	printf("NIST-p256\n  ");
+	int i;
+	uECC_word_t d[NUM_ECC_WORDS];
+	uECC_word_t q[2 * NUM_ECC_WORDS];
+	uECC_word_t q_table[uECC_WNAF_Q_POINTS][2 * NUM_ECC_WORDS];
+	uECC_word_t u1[NUM_ECC_WORDS];
+	uECC_word_t u2[NUM_ECC_WORDS];
+	uECC_word_t a[2 * NUM_ECC_WORDS];
+	uECC_word_t b[2 * NUM_ECC_WORDS];
+	uECC_word_t X[NUM_ECC_WORDS];
+	uECC_word_t Y[NUM_ECC_WORDS];
+	uECC_word_t Z[NUM_ECC_WORDS];
+
+	const struct uECC_Curve_t * curve = uECC_secp256r1();
+
+	/* Every entry m * G of the generator table on its own: the wNAF of an
+	 * odd m < 2^(w - 1) is the single digit m. */
+	uECC_vli_clear(u1, NUM_ECC_WORDS);
+	uECC_vli_clear(u2, NUM_ECC_WORDS);
+	EccPoint_odd_multiples(q_table[0], curve->G, 1, curve);
+	for (i = 1; i < (1 << (uECC_VERIFY_WNAF_WINDOW - 1)); i += 2) {
+		u1[0] = (uECC_word_t) i;
+		if (i == 1) {
+			uECC_vli_set(b, curve->G, 2 * NUM_ECC_WORDS);
+		} else {
+			ladder_mult(b, curve->G, u1, curve);
+		}
+
+		EccPoint_mult_double_unsafe(X, Y, Z, u1, u2, q_table[0], curve);
+		uECC_vli_modInv(Z, Z, curve->p, NUM_ECC_WORDS);
+		apply_z(X, Y, Z, curve);
+		if (uECC_vli_equal(X, b, NUM_ECC_WORDS) != 0 ||
+		    uECC_vli_equal(Y, b + NUM_ECC_WORDS, NUM_ECC_WORDS) != 0) {
+			TC_ERROR("wNAF table entry %dG differs from the ladder\n",
+				 i);
+			return TC_FAIL;
+		}
+	}
+
+	for (i = 0; i < num_tests; ++i) {
+		if (verbose) {
+			TC_PRINT(".");
+			fflush(stdout);
+		}
+
+		uECC_generate_random_int(d, curve->n, NUM_ECC_WORDS);
+		uECC_generate_random_int(u1, curve->n, NUM_ECC_WORDS);
+		uECC_generate_random_int(u2, curve->n, NUM_ECC_WORDS);
+		ladder_mult(q, curve->G, d, curve);
+		EccPoint_odd_multiples(q_table[0], q, 1, curve);
+
+		/* a = u1*G + u2*Q, added in co-Z form and made affine */
+		ladder_mult(a, curve->G, u1, curve);
+		ladder_mult(b, q, u2, curve);
+		uECC_vli_modSub(Z, b, a, curve->p, NUM_ECC_WORDS);
+		XYcZ_add(a, a + NUM_ECC_WORDS, b, b + NUM_ECC_WORDS, curve);
+		uECC_vli_modInv(Z, Z, curve->p, NUM_ECC_WORDS);
+		apply_z(b, b + NUM_ECC_WORDS, Z, curve);
+
+		EccPoint_mult_double_unsafe(X, Y, Z, u1, u2, q_table[0], curve);
+		uECC_vli_modInv(Z, Z, curve->p, NUM_ECC_WORDS);
+		apply_z(X, Y, Z, curve);
+
+		if (uECC_vli_equal(X, b, NUM_ECC_WORDS) != 0 ||
+		    uECC_vli_equal(Y, b + NUM_ECC_WORDS, NUM_ECC_WORDS) != 0) {
+			TC_ERROR("wNAF result differs from the ladder\n");
+			return TC_FAIL;
+		}
+
+		/* 0*G + u2*Q = u2*Q, and 0*G + 0*Q is the point at infinity */
+		uECC_vli_clear(u1, NUM_ECC_WORDS);
+		ladder_mult(b, q, u2, curve);
+		EccPoint_mult_double_unsafe(X, Y, Z, u1, u2, q_table[0], curve);
+		uECC_vli_modInv(Z, Z, curve->p, NUM_ECC_WORDS);
+		apply_z(X, Y, Z, curve);
+		if (uECC_vli_equal(X, b, NUM_ECC_WORDS) != 0 ||
+		    uECC_vli_equal(Y, b + NUM_ECC_WORDS, NUM_ECC_WORDS) != 0) {
+			TC_ERROR("wNAF result differs from the ladder (u1 = 0)\n");
+			return TC_FAIL;
+		}
+
+		uECC_vli_clear(u2, NUM_ECC_WORDS);
+		EccPoint_mult_double_unsafe(X, Y, Z, u1, u2, q_table[0], curve);
+		if (!uECC_vli_isZero(Z, NUM_ECC_WORDS)) {
+			TC_ERROR("0*G + 0*Q is not the point at infinity\n");
+			return TC_FAIL;
+		}
+	}
+	TC_PRINT("\n");
+	return TC_PASS;
+}
+#endif
+
+int batch_verify(bool verbose)
+{
+	printf("Test #5: Batch verification (10 EC-DSA signatures, 3 invalid) ");
+	printf("NIST-p256, SHA2-256\n  ");
+	int i;
+	uint8_t private[NUM_ECC_BYTES];
+	uint8_t public[10][2*NUM_ECC_BYTES];
+	uint8_t hash[10][NUM_ECC_BYTES];
+	uint8_t sig[10][2*NUM_ECC_BYTES];
+	uECC_word_t hash_words[NUM_ECC_WORDS];
+	const uint8_t *public_ptr[10];
+	const uint8_t *hash_ptr[10];
+	const uint8_t *sig_ptr[10];
+	int results[10];
+	int all_valid;
+
+	const struct uECC_Curve_t * curve = uECC_secp256r1();
+
+	for (i = 0; i < 10; ++i) {
+		if (verbose) {
+			TC_PRINT(".");
+			fflush(stdout);
+		}
+
+		uECC_generate_random_int(hash_words, curve->n, BITS_TO_WORDS(curve->num_n_bits));
+		uECC_vli_nativeToBytes(hash[i], NUM_ECC_BYTES, hash_words);
+
+		if (!uECC_make_key(public[i], private, curve) ||
+		    !uECC_sign(private, hash[i], sizeof(hash[i]), sig[i], curve)) {
+			TC_ERROR("uECC_make_key() or uECC_sign() failed\n");
+			return TC_FAIL;
+		}
+		public_ptr[i] = public[i];
+		hash_ptr[i] = hash[i];
+		sig_ptr[i] = sig[i];
+	}
+
+	/* A changed r, a zero s and a signature of another message: */
+	sig[2][5] ^= 0x20;
+	memset(sig[5] + NUM_ECC_BYTES, 0, NUM_ECC_BYTES);
+	hash_ptr[9] = hash[8];
+
+	all_valid = uECC_verify_batch(public_ptr, hash_ptr, NUM_ECC_BYTES, sig_ptr,
+				      10, results, curve);
+	if (all_valid) {
+		TC_ERROR("uECC_verify_batch() accepted the batch\n");
+		return TC_FAIL;
+	}
+	for (i = 0; i < 10; ++i) {
+		if (results[i] != (i != 2 && i != 5 && i != 9) ||
+		    results[i] != uECC_verify(public_ptr[i], hash_ptr[i],
+					      NUM_ECC_BYTES, sig_ptr[i], curve)) {
+			TC_ERROR("uECC_verify_batch() wrong for signature %d\n", i);
+			return TC_FAIL;
+		}
+	}
+
+	/* Only the valid ones: */
+	all_valid = uECC_verify_batch(public_ptr, hash_ptr, NUM_ECC_BYTES, sig_ptr,
+				      2, results, curve);
+	if (!all_valid || !results[0] || !results[1]) {
+		TC_ERROR("uECC_verify_batch() rejected valid signatures\n");
+		return TC_FAIL;
+	}
+	TC_PRINT("\n");
+	return TC_PASS;
+}
+
+static int hmac_prng_rng(void *ctx, uint8_t *dest, unsigned int size)
+{
+	return tc_hmac_prng_generate(dest, size, (TCHmacPrng_t)ctx) == TC_CRYPTO_SUCCESS;
+}
+
+int rng_context(bool verbose)
+{
+	printf("Test #6: EC-DSA with a caller-owned RNG context ");
+	printf("NIST-p256, SHA2-256\n  ");
+	struct tc_hmac_prng_struct prng[2];
+	uint8_t seed[32];
+	uint8_t private[2][NUM_ECC_BYTES];
+	uint8_t public[2][2*NUM_ECC_BYTES];
+	uint8_t sig[2][2*NUM_ECC_BYTES];
+	uint8_t hash[NUM_ECC_BYTES];
+	int i;
+
+	const struct uECC_Curve_t * curve = uECC_secp256r1();
+
+	memset(seed, 0x5a, sizeof(seed));
+	memset(hash, 0xa5, sizeof(hash));
+	for (i = 0; i < 2; ++i) {
+		if (tc_hmac_prng_init(&prng[i], seed, sizeof(seed)) != TC_CRYPTO_SUCCESS ||
+		    tc_hmac_prng_reseed(&prng[i], seed, sizeof(seed), 0, 0) !=
+		    TC_CRYPTO_SUCCESS) {
+			TC_ERROR("tc_hmac_prng_init() failed\n");
+			return TC_FAIL;
+		}
+	}
+
+	/* No global RNG: everything must come from the contexts. */
+	uECC_set_rng(0);
+	for (i = 0; i < 2; ++i) {
+		if (verbose) {
+			TC_PRINT(".");
+			fflush(stdout);
+		}
+		if (!uECC_make_key_with_rng(public[i], private[i], curve,
+					    &hmac_prng_rng, &prng[i]) ||
+		    !uECC_sign_with_rng(private[i], hash, sizeof(hash), sig[i],
+					curve, &hmac_prng_rng, &prng[i])) {
+			TC_ERROR("uECC_make_key_with_rng() or uECC_sign_with_rng() failed\n");
+			uECC_set_rng(&default_CSPRNG);
+			return TC_FAIL;
+		}
+	}
+	uECC_set_rng(&default_CSPRNG);
+
+	if (memcmp(private[0], private[1], sizeof(private[0])) ||
+	    memcmp(sig[0], sig[1], sizeof(sig[0]))) {
+		TC_ERROR("equally seeded contexts gave different results\n");
+		return TC_FAIL;
+	}
+	if (!uECC_verify(public[0], hash, sizeof(hash), sig[0], curve)) {
+		TC_ERROR("uECC_verify() rejected the signature\n");
+		return TC_FAIL;
+	}
+	TC_PRINT("\n");
+	return TC_PASS;
+}
+
+int prepared_verify(int num_tests, bool verbose)
+{
+	printf("Test #7: Prepared public key (%d EC-DSA signatures) ", num_tests);
+	printf("NIST-p256, SHA2-256\n  ");
+	struct uECC_verify_key_t key;
+	uint8_t private[NUM_ECC_BYTES];
+	uint8_t public[2*NUM_ECC_BYTES];
+	uint8_t hash[NUM_ECC_BYTES];
+	uint8_t sig[2*NUM_ECC_BYTES];
+	uECC_word_t hash_words[NUM_ECC_WORDS];
+	int i;
+
+	const struct uECC_Curve_t * curve = uECC_secp256r1();
+
+	if (!uECC_make_key(public, private, curve) ||
+	    !uECC_verify_key_init(&key, public, curve)) {
+		TC_ERROR("uECC_make_key() or uECC_verify_key_init() failed\n");
+		return TC_FAIL;
+	}
+
+	for (i = 0; i < num_tests; ++i) {
+		if (verbose) {
+			TC_PRINT(".");
+			fflush(stdout);
+		}
+
+		uECC_generate_random_int(hash_words, curve->n, BITS_TO_WORDS(curve->num_n_bits));
+		uECC_vli_nativeToBytes(hash, NUM_ECC_BYTES, hash_words);
+
+		if (!uECC_sign(private, hash, sizeof(hash), sig, curve)) {
+			TC_ERROR("uECC_sign() failed\n");
+			return TC_FAIL;
+		}
+		if (!uECC_verify_prepared(&key, hash, sizeof(hash), sig)) {
+			TC_ERROR("uECC_verify_prepared() rejected signature %d\n", i);
+			return TC_FAIL;
+		}
+
+		/* A changed hash, r or s must be rejected, as by uECC_verify(). */
+		hash[i % sizeof(hash)] ^= 0x01;
+		if (uECC_verify_prepared(&key, hash, sizeof(hash), sig) ||
+		    uECC_verify(public, hash, sizeof(hash), sig, curve)) {
+			TC_ERROR("accepted a signature of another message\n");
+			return TC_FAIL;
+		}
+		hash[i % sizeof(hash)] ^= 0x01;
+		sig[i % sizeof(sig)] ^= 0x80;
+		if (uECC_verify_prepared(&key, hash, sizeof(hash), sig)) {
+			TC_ERROR("accepted a changed signature %d\n", i);
+			return TC_FAIL;
+		}
+	}
+
+	/* A key off the curve cannot be prepared. */
+	public[2*NUM_ECC_BYTES - 1] ^= 1;
+	if (uECC_verify_key_init(&key, public, curve)) {
+		TC_ERROR("uECC_verify_key_init() accepted an invalid public key\n");
+		return TC_FAIL;
+	}
+	TC_PRINT("\n");
+	return TC_PASS;
+}
+
+#if uECC_SUPPORTS_secp256k1
+int secp256k1_dsa(int num_tests, bool verbose)
+{
+	printf("Test #8: EC-DSA on secp256k1 (%d signatures) ", num_tests);
+	printf("secp256k1\n  ");
+	struct uECC_verify_key_t key;
+	uint8_t private[NUM_ECC_BYTES];
+	uint8_t public[2*NUM_ECC_BYTES];
+	uint8_t hash[NUM_ECC_BYTES];
+	uint8_t sig[2*NUM_ECC_BYTES];
+	uint8_t expected[2*NUM_ECC_BYTES];
+	uECC_word_t k[NUM_ECC_WORDS];
+	uECC_word_t hash_words[NUM_ECC_WORDS];
+	const uint8_t *public_ptr[3];
+	const uint8_t *hash_ptr[3];
+	const uint8_t *sig_ptr[3];
+	int results[3];
+	int i;
+
+	const struct uECC_Curve_t * curve = uECC_secp256k1();
+
+	/* A known signature with a given k: */
+	hex2bin(private, sizeof(private),
+		"750b79840a35e888cea8684b60033cd65db233956ea88f4b4f72fd3f7d254db9",
+		64);
+	hex2bin(hash, sizeof(hash),
+		"d2aeeaf914c7d3fd9a1ac067541b8ee6f0969fe15284b2bf8e56916a518a4445",
+		64);
+	string2scalar(k, NUM_ECC_WORDS,
+		"f09b30460cce5b3445fff12fb4d7a20d294b97d08e7981664997082c8b7e20c0");
+	hex2bin(expected, sizeof(expected),
+		"f72701450721e345ebfc991943564ce87da0f95ef7c0173a3b46f62b025cd2af"
+		"b7951c907cb58a228ba8898e22198c989903ba0b0b761e07e03408917e3663cf",
+		128);
+	if (!uECC_compute_public_key(private, public, curve) ||
+	    !uECC_sign_with_k(private, hash, sizeof(hash), k, sig, curve) ||
+	    memcmp(sig, expected, sizeof(sig)) != 0) {
+		TC_ERROR("wrong signature with a given k\n");
+		return TC_FAIL;
+	}
+
+	for (i = 0; i < num_tests; ++i) {
+		if (verbose) {
+			TC_PRINT(".");
+			fflush(stdout);
+		}
+
+		uECC_generate_random_int(hash_words, curve->n, BITS_TO_WORDS(curve->num_n_bits));
+		uECC_vli_nativeToBytes(hash, NUM_ECC_BYTES, hash_words);
+
+		if (!uECC_make_key(public, private, curve) ||
+		    !uECC_sign(private, hash, sizeof(hash), sig, curve) ||
+		    !uECC_verify_key_init(&key, public, curve)) {
+			TC_ERROR("uECC_make_key(), uECC_sign() or "
+				 "uECC_verify_key_init() failed\n");
+			return TC_FAIL;
+		}
+
+		if (!uECC_verify(public, hash, sizeof(hash), sig, curve) ||
+		    !uECC_verify_prepared(&key, hash, sizeof(hash), sig)) {
+			TC_ERROR("rejected signature %d\n", i);
+			return TC_FAIL;
+		}
+
+		/* The same signature for another curve or of another message: */
+		hash[0] ^= 0x01;
+		if (uECC_verify(public, hash, sizeof(hash), sig, curve) ||
+		    uECC_verify_prepared(&key, hash, sizeof(hash), sig) ||
+		    uECC_verify(public, hash, sizeof(hash), sig,
+				uECC_secp256r1())) {
+			TC_ERROR("accepted signature %d of another message\n", i);
+			return TC_FAIL;
+		}
+		hash[0] ^= 0x01;
+	}
+
+	/* The batch call too, with one bad signature: */
+	public_ptr[0] = public_ptr[1] = public_ptr[2] = public;
+	hash_ptr[0] = hash_ptr[2] = hash;
+	hash_ptr[1] = expected;
+	sig_ptr[0] = sig_ptr[1] = sig_ptr[2] = sig;
+	if (uECC_verify_batch(public_ptr, hash_ptr, sizeof(hash), sig_ptr, 3,
+			      results, curve) ||
+	    !results[0] || results[1] || !results[2]) {
+		TC_ERROR("uECC_verify_batch() wrong on secp256k1\n");
+		return TC_FAIL;
+	}
+	TC_PRINT("\n");
+	return TC_PASS;
+}
+#endif
+
+#define WS_GUARD_WORDS 4
+#define WS_CANARY ((uECC_word_t)0xa5a5a5a5a5a5a5a5ull)
+
+int workspace(int num_tests, bool verbose)
+{
+	printf("Test #9: Caller-provided workspace (%d keys) ", num_tests);
+	printf("NIST-p256, SHA2-256\n  ");
+	uint8_t private[2][NUM_ECC_BYTES];
+	uint8_t public[2][2*NUM_ECC_BYTES];
+	uint8_t secret[3][NUM_ECC_BYTES];
+	uint8_t sig[2*NUM_ECC_BYTES];
+	uint8_t hash[NUM_ECC_BYTES];
+	uECC_word_t *buf;
+	uECC_word_t *ws;
+	int result = TC_FAIL;
+	int i, j;
+
+	const struct uECC_Curve_t * curve = uECC_secp256r1();
+
+	/* Exact-size area between two canary guards. */
+	buf = malloc(uECC_WS_SIZE + 2 * WS_GUARD_WORDS * sizeof(uECC_word_t));
+	if (!buf) {
+		TC_ERROR("malloc() failed\n");
+		return TC_FAIL;
+	}
+	ws = buf + WS_GUARD_WORDS;
+	for (j = 0; j < WS_GUARD_WORDS; ++j) {
+		buf[j] = WS_CANARY;
+		ws[uECC_WS_WORDS + j] = WS_CANARY;
+	}
+
+	for (i = 0; i < num_tests; ++i) {
+		if (verbose) {
+			TC_PRINT(".");
+			fflush(stdout);
+		}
+		if (!uECC_make_key_ws(public[0], private[0], curve, ws) ||
+		    !uECC_make_key_ws(public[1], private[1], curve, ws)) {
+			TC_ERROR("uECC_make_key_ws() failed\n");
+			goto done;
+		}
+		for (j = 0; j < uECC_MAKE_KEY_WS_WORDS; ++j) {
+			if (ws[j]) {
+				TC_ERROR("uECC_make_key_ws() left secrets in the workspace\n");
+				goto done;
+			}
+		}
+		if (!uECC_shared_secret_ws(public[1], private[0], secret[0], curve,
+					   ws) ||
+		    !uECC_shared_secret(public[1], private[0], secret[1], curve) ||
+		    !uECC_shared_secret_ws(public[0], private[1], secret[2], curve,
+					   ws) ||
+		    memcmp(secret[0], secret[1], sizeof(secret[0])) ||
+		    memcmp(secret[0], secret[2], sizeof(secret[0]))) {
+			TC_ERROR("uECC_shared_secret_ws() mismatch\n");
+			goto done;
+		}
+
+		memset(hash, i, sizeof(hash));
+		if (!uECC_sign_ws(private[0], hash, sizeof(hash), sig, curve, ws)) {
+			TC_ERROR("uECC_sign_ws() failed\n");
+			goto done;
+		}
+		if (!uECC_verify_ws(public[0], hash, sizeof(hash), sig, curve, ws) ||
+		    !uECC_verify(public[0], hash, sizeof(hash), sig, curve)) {
+			TC_ERROR("uECC_verify_ws() rejected the signature\n");
+			goto done;
+		}
+		hash[0] ^= 1;
+		if (uECC_verify_ws(public[0], hash, sizeof(hash), sig, curve, ws)) {
+			TC_ERROR("uECC_verify_ws() accepted a wrong hash\n");
+			goto done;
+		}
+	}
+
+	for (j = 0; j < WS_GUARD_WORDS; ++j) {
+		if (buf[j] != WS_CANARY || ws[uECC_WS_WORDS + j] != WS_CANARY) {
+			TC_ERROR("workspace guard overwritten\n");
+			goto done;
+		}
+	}
+	TC_PRINT("\n");
+	result = TC_PASS;
+done:
+	free(buf);
+	return result;
+}
+
+/* RFC 6979 appendix A.2.5: P-256 key, SHA-256 of "sample" and "test". */
+static const uint8_t rfc6979_private[NUM_ECC_BYTES] = {
+	0xc9, 0xaf, 0xa9, 0xd8, 0x45, 0xba, 0x75, 0x16,
+	0x6b, 0x5c, 0x21, 0x57, 0x67, 0xb1, 0xd6, 0x93,
+	0x4e, 0x50, 0xc3, 0xdb, 0x36, 0xe8, 0x9b, 0x12,
+	0x7b, 0x8a, 0x62, 0x2b, 0x12, 0x0f, 0x67, 0x21
+};
+static const uint8_t rfc6979_public[2*NUM_ECC_BYTES] = {
+	0x60, 0xfe, 0xd4, 0xba, 0x25, 0x5a, 0x9d, 0x31,
+	0xc9, 0x61, 0xeb, 0x74, 0xc6, 0x35, 0x6d, 0x68,
+	0xc0, 0x49, 0xb8, 0x92, 0x3b, 0x61, 0xfa, 0x6c,
+	0xe6, 0x69, 0x62, 0x2e, 0x60, 0xf2, 0x9f, 0xb6,
+	0x79, 0x03, 0xfe, 0x10, 0x08, 0xb8, 0xbc, 0x99,
+	0xa4, 0x1a, 0xe9, 0xe9, 0x56, 0x28, 0xbc, 0x64,
+	0xf2, 0xf1, 0xb2, 0x0c, 0x2d, 0x7e, 0x9f, 0x51,
+	0x77, 0xa3, 0xc2, 0x94, 0xd4, 0x46, 0x22, 0x99
+};
+static const char *const rfc6979_msg[2] = { "sample", "test" };
+static const uint8_t rfc6979_sig[2][2*NUM_ECC_BYTES] = {
+	{
+		0xef, 0xd4, 0x8b, 0x2a, 0xac, 0xb6, 0xa8, 0xfd,
+		0x11, 0x40, 0xdd, 0x9c, 0xd4, 0x5e, 0x81, 0xd6,
+		0x9d, 0x2c, 0x87, 0x7b, 0x56, 0xaa, 0xf9, 0x91,
+		0xc3, 0x4d, 0x0e, 0xa8, 0x4e, 0xaf, 0x37, 0x16,
+		0xf7, 0xcb, 0x1c, 0x94, 0x2d, 0x65, 0x7c, 0x41,
+		0xd4, 0x36, 0xc7, 0xa1, 0xb6, 0xe2, 0x9f, 0x65,
+		0xf3, 0xe9, 0x00, 0xdb, 0xb9, 0xaf, 0xf4, 0x06,
+		0x4d, 0xc4, 0xab, 0x2f, 0x84, 0x3a, 0xcd, 0xa8
+	}, {
+		0xf1, 0xab, 0xb0, 0x23, 0x51, 0x83, 0x51, 0xcd,
+		0x71, 0xd8, 0x81, 0x56, 0x7b, 0x1e, 0xa6, 0x63,
+		0xed, 0x3e, 0xfc, 0xf6, 0xc5, 0x13, 0x2b, 0x35,
+		0x4f, 0x28, 0xd3, 0xb0, 0xb7, 0xd3, 0x83, 0x67,
+		0x01, 0x9f, 0x41, 0x13, 0x74, 0x2a, 0x2b, 0x14,
+		0xbd, 0x25, 0x92, 0x6b, 0x49, 0xc6, 0x49, 0x15,
+		0x5f, 0x26, 0x7e, 0x60, 0xd3, 0x81, 0x4b, 0x4c,
+		0x0c, 0xc8, 0x42, 0x50, 0xe4, 0x6f, 0x00, 0x83
+	}
+};
+
+int rfc6979(bool verbose)
+{
+	printf("Test #10: RFC 6979 deterministic EC-DSA ");
+	printf("NIST-p256, SHA2-256\n  ");
+	struct tc_sha256_state_struct sha;
+	uint8_t hash[TC_SHA256_DIGEST_SIZE];
+	uint8_t sig[2][2*NUM_ECC_BYTES];
+	int i;
+
+	const struct uECC_Curve_t * curve = uECC_secp256r1();
+
+	/* No RNG: nothing may be drawn from it. */
+	uECC_set_rng(0);
+	for (i = 0; i < 2; ++i) {
+		if (verbose) {
+			TC_PRINT(".");
+			fflush(stdout);
+		}
+		(void)tc_sha256_init(&sha);
+		(void)tc_sha256_update(&sha, (const uint8_t *)rfc6979_msg[i],
+				       strlen(rfc6979_msg[i]));
+		(void)tc_sha256_final(hash, &sha);
+		if (!uECC_sign_deterministic(rfc6979_private, hash, sizeof(hash),
+					     sig[0], curve) ||
+		    !uECC_sign_deterministic(rfc6979_private, hash, sizeof(hash),
+					     sig[1], curve)) {
+			TC_ERROR("uECC_sign_deterministic() failed\n");
+			uECC_set_rng(&default_CSPRNG);
+			return TC_FAIL;
+		}
+		if (memcmp(sig[0], rfc6979_sig[i], sizeof(sig[0])) ||
+		    memcmp(sig[1], rfc6979_sig[i], sizeof(sig[1]))) {
+			TC_ERROR("signature of \"%s\" differs from RFC 6979\n",
+				 rfc6979_msg[i]);
+			uECC_set_rng(&default_CSPRNG);
+			return TC_FAIL;
+		}
+	}
+	uECC_set_rng(&default_CSPRNG);
+
+	if (!uECC_verify(rfc6979_public, hash, sizeof(hash), sig[0], curve)) {
+		TC_ERROR("uECC_verify() rejected the signature\n");
+		return TC_FAIL;
+	}
+	TC_PRINT("\n");
+	return TC_PASS;
+}
+
 int main()
 {
 	unsigned int result = TC_PASS;
@@ -660,6 +1230,52 @@ int main()
 		TC_ERROR("montecarlo_signverify test failed.\n");
 	goto exitTest;
 	}
+	TC_PRINT("Performing batch_verify test:\n");
+	result = batch_verify(verbose);
+	if (result == TC_FAIL) {
+		TC_ERROR("batch_verify test failed.\n");
+		goto exitTest;
+	}
+	TC_PRINT("Performing rng_context test:\n");
+	result = rng_context(verbose);
+	if (result == TC_FAIL) {
+		TC_ERROR("rng_context test failed.\n");
+		goto exitTest;
+	}
+	TC_PRINT("Performing prepared_verify test:\n");
+	result = prepared_verify(20, verbose);
+	if (result == TC_FAIL) {
+		TC_ERROR("prepared_verify test failed.\n");
+		goto exitTest;
+	}
+	TC_PRINT("Performing workspace test:\n");
+	result = workspace(10, verbose);
+	if (result == TC_FAIL) {
+		TC_ERROR("workspace test failed.\n");
+		goto exitTest;
+	}
+	TC_PRINT("Performing rfc6979 test:\n");
+	result = rfc6979(verbose);
+	if (result == TC_FAIL) {
+		TC_ERROR("rfc6979 test failed.\n");
+		goto exitTest;
+	}
+#if uECC_SUPPORTS_secp256k1
+	TC_PRINT("Performing secp256k1_dsa test:\n");
+	result = secp256k1_dsa(20, verbose);
+	if (result == TC_FAIL) {
+		TC_ERROR("secp256k1_dsa test failed.\n");
+		goto exitTest;
+	}
+#endif
+#if uECC_VERIFY_WNAF_WINDOW > 0
+	TC_PRINT("Performing wnaf_double_mult test:\n");
+	result = wnaf_double_mult(20, verbose);
+	if (result == TC_FAIL) {
+		TC_ERROR("wnaf_double_mult test failed.\n");
+		goto exitTest;
+	}
+#endif
 
 	TC_PRINT("\nAll ECC-DSA tests succeeded.\n");
 
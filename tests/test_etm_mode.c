@@ -0,0 +1,267 @@
+/* test_etm_mode.c - TinyCrypt implementation of some encrypt-then-MAC tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ *  DESCRIPTION
+ * This module tests the encrypt-then-MAC compositions against CTR, CBC,
+ * HMAC and CMAC run as separate passes.
+ *
+ *  Scenarios tested include:
+ *  - EtM test #1 CTR + HMAC-SHA256, lengths below, at and above the chunk size
+ *  - EtM test #2 CBC + CMAC, the same lengths rounded to whole blocks
+ *  and for both, in-place decryption and rejection of a modified message.
+ */
+
+#include <tinycrypt/etm_mode.h>
+#include <tinycrypt/ctr_mode.h>
+#include <tinycrypt/cbc_mode.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_LEN 10000
+
+static const uint8_t aes_key[16] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+	0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+static const uint8_t mac_key[16] = {
+	0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe,
+	0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81
+};
+static const uint8_t ctr_init[16] = {
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+	0xf8, 0xf9, 0xfa, 0xfb, 0xff, 0xff, 0xff, 0xfb
+};
+static const unsigned int lengths[] = { 1, 100, 4095, 4096, 4097, 10000 };
+
+static uint8_t plaintext[MAX_LEN];
+static uint8_t expected[MAX_LEN + 16];
+static uint8_t computed[MAX_LEN + 16];
+
+static int is_zero(const uint8_t *p, unsigned int len)
+{
+	while (len-- > 0) {
+		if (*p++ != 0) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+unsigned int test_1(void)
+{
+	struct tc_aes_key_sched_struct sched;
+	struct tc_hmac_key_struct hmac;
+	struct tc_sha256_state_struct s;
+	uint8_t expected_tag[TC_ETM_HMAC_TAG_SIZE];
+	uint8_t tag[TC_ETM_HMAC_TAG_SIZE];
+	uint8_t ctr_ref[16];
+	uint8_t ctr[16];
+	unsigned int result = TC_PASS;
+	unsigned int i, len;
+
+	TC_PRINT("EtM test #1 (CTR + HMAC-SHA256):\n");
+	(void)tc_aes128_set_encrypt_key(&sched, aes_key);
+	(void)tc_hmac_key_set(&hmac, mac_key, sizeof(mac_key));
+
+	for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+		len = lengths[i];
+
+		/* two separate passes */
+		(void)memcpy(ctr_ref, ctr_init, sizeof(ctr_ref));
+		(void)tc_ctr_mode(expected, len, plaintext, len, ctr_ref, &sched);
+		(void)tc_hmac_key_init(&s, &hmac);
+		(void)tc_sha256_update(&s, ctr_init, sizeof(ctr_init));
+		(void)tc_sha256_update(&s, expected, len);
+		(void)tc_hmac_key_final(expected_tag, sizeof(expected_tag), &s,
+					&hmac);
+
+		(void)memcpy(ctr, ctr_init, sizeof(ctr));
+		if (tc_etm_ctr_hmac_encrypt(computed, len, plaintext, len, ctr,
+					    &sched, &hmac, tag) == 0) {
+			TC_ERROR("EtM test #1 failed in %s.\n", __func__);
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+		result = check_result(1, expected, len, computed, len);
+		if (result == TC_FAIL) {
+			goto exitTest1;
+		}
+		result = check_result(1, expected_tag, sizeof(expected_tag),
+				      tag, sizeof(tag));
+		if (result == TC_FAIL) {
+			goto exitTest1;
+		}
+		result = check_result(1, ctr_ref, sizeof(ctr_ref), ctr,
+				      sizeof(ctr));
+		if (result == TC_FAIL) {
+			goto exitTest1;
+		}
+
+		/* in place */
+		(void)memcpy(ctr, ctr_init, sizeof(ctr));
+		if (tc_etm_ctr_hmac_decrypt(computed, len, computed, len, ctr,
+					    &sched, &hmac, tag) == 0) {
+			TC_ERROR("EtM test #1 rejected a valid message.\n");
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+		result = check_result(1, plaintext, len, computed, len);
+		if (result == TC_FAIL) {
+			goto exitTest1;
+		}
+
+		/* the last ciphertext byte, then play it back */
+		expected[len - 1] ^= 1;
+		(void)memcpy(ctr, ctr_init, sizeof(ctr));
+		if (tc_etm_ctr_hmac_decrypt(computed, len, expected, len, ctr,
+					    &sched, &hmac, tag) != 0 ||
+		    !is_zero(computed, len)) {
+			TC_ERROR("EtM test #1 accepted a modified message.\n");
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+	}
+
+ exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+unsigned int test_2(void)
+{
+	struct tc_aes_key_sched_struct enc_sched, dec_sched, mac_sched;
+	struct tc_cmac_key_struct cmac;
+	struct tc_cmac_msg_struct m;
+	uint8_t expected_tag[TC_ETM_CMAC_TAG_SIZE];
+	uint8_t tag[TC_ETM_CMAC_TAG_SIZE];
+	unsigned int result = TC_PASS;
+	unsigned int i, len;
+
+	TC_PRINT("EtM test #2 (CBC + CMAC):\n");
+	(void)tc_aes128_set_encrypt_key(&enc_sched, aes_key);
+	(void)tc_aes128_set_decrypt_key(&dec_sched, aes_key);
+	(void)tc_cmac_key_set(&cmac, mac_key, sizeof(mac_key), &mac_sched);
+
+	for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+		len = (lengths[i] + 15) & ~15u;
+
+		/* two separate passes; the iv is the initial counter block */
+		(void)tc_cbc_mode_encrypt(expected, len + 16, plaintext, len,
+					  ctr_init, &enc_sched);
+		(void)tc_cmac_key_init(&m, &cmac);
+		(void)tc_cmac_key_update(&m, expected, len + 16);
+		(void)tc_cmac_key_final(expected_tag, &m);
+
+		if (tc_etm_cbc_cmac_encrypt(computed, len + 16, plaintext, len,
+					    ctr_init, &enc_sched, &cmac,
+					    tag) == 0) {
+			TC_ERROR("EtM test #2 failed in %s.\n", __func__);
+			result = TC_FAIL;
+			goto exitTest2;
+		}
+		result = check_result(2, expected, len + 16, computed, len + 16);
+		if (result == TC_FAIL) {
+			goto exitTest2;
+		}
+		result = check_result(2, expected_tag, sizeof(expected_tag),
+				      tag, sizeof(tag));
+		if (result == TC_FAIL) {
+			goto exitTest2;
+		}
+
+		/* in place */
+		if (tc_etm_cbc_cmac_decrypt(computed, len, computed, len + 16,
+					    &dec_sched, &cmac, tag) == 0) {
+			TC_ERROR("EtM test #2 rejected a valid message.\n");
+			result = TC_FAIL;
+			goto exitTest2;
+		}
+		result = check_result(2, plaintext, len, computed, len);
+		if (result == TC_FAIL) {
+			goto exitTest2;
+		}
+
+		/* a modified iv */
+		expected[0] ^= 1;
+		if (tc_etm_cbc_cmac_decrypt(computed, len, expected, len + 16,
+					    &dec_sched, &cmac, tag) != 0 ||
+		    !is_zero(computed, len)) {
+			TC_ERROR("EtM test #2 accepted a modified message.\n");
+			result = TC_FAIL;
+			goto exitTest2;
+		}
+	}
+
+ exitTest2:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test encrypt-then-MAC
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+	unsigned int i;
+
+	TC_START("Performing encrypt-then-MAC tests:");
+
+	for (i = 0; i < sizeof(plaintext); ++i) {
+		plaintext[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	result = test_1();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("EtM test #1 failed.\n");
+		goto exitTest;
+	}
+
+	result = test_2();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("EtM test #2 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All encrypt-then-MAC tests succeeded!\n");
+
+exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
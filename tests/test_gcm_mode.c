@@ -0,0 +1,394 @@
+/* test_gcm_mode.c - TinyCrypt implementation of some AES-GCM tests */
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *  DESCRIPTION
+ * This module tests the following AES-GCM Mode routines:
+ *
+ *  Scenarios tested include:
+ *  - AES128 GCM mode test cases 1 to 6 of the GCM specification
+ *    (McGrew and Viega), which cover empty and partial-block payloads,
+ *    associated data and 8- and 60-byte IVs
+ *  - tag verification failures and truncated tags
+ */
+
+#include <tinycrypt/gcm_mode.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <string.h>
+
+#define TC_GCM_MAX_CT_SIZE 80
+#define NUM_NIST_KEYS 16
+
+int do_test(unsigned int testnum, const uint8_t *key, const uint8_t *iv,
+	    size_t ivlen, const uint8_t *hdr, size_t hlen,
+	    const uint8_t *data, size_t dlen, const uint8_t *expected,
+	    size_t elen)
+{
+	int result = TC_PASS;
+	uint8_t ciphertext[TC_GCM_MAX_CT_SIZE];
+	uint8_t decrypted[TC_GCM_MAX_CT_SIZE];
+	struct tc_gcm_mode_struct g;
+	struct tc_aes_key_sched_struct sched;
+
+	TC_PRINT("%s: Performing GCM test #%u:\n", __func__, testnum);
+
+	(void)tc_aes128_set_encrypt_key(&sched, key);
+	if (tc_gcm_config(&g, &sched, 16) == 0) {
+		TC_ERROR("GCM config failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	if (tc_gcm_generation_encryption(ciphertext, sizeof(ciphertext), iv,
+					 ivlen, hdr, hlen, data, dlen,
+					 &g) == 0 ||
+	    memcmp(expected, ciphertext, elen) != 0) {
+		TC_ERROR("gcm_encrypt produced wrong ciphertext in %s.\n",
+			 __func__);
+		show_str("\t\tExpected", expected, elen);
+		show_str("\t\tComputed", ciphertext, elen);
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	if (tc_gcm_decryption_verification(decrypted, sizeof(decrypted), iv,
+					   ivlen, hdr, hlen, ciphertext, elen,
+					   &g) == 0 ||
+	    (dlen > 0 && memcmp(decrypted, data, dlen) != 0)) {
+		TC_ERROR("gcm_decrypt failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	/* a flipped bit in the last byte must be rejected, leaving out as
+	 * it was: */
+	ciphertext[elen - 1] ^= 1;
+	memset(decrypted, 0xa5, sizeof(decrypted));
+	if (tc_gcm_decryption_verification(decrypted, sizeof(decrypted), iv,
+					   ivlen, hdr, hlen, ciphertext, elen,
+					   &g) != 0 ||
+	    decrypted[0] != 0xa5) {
+		TC_ERROR("gcm_decrypt accepted a modified message in %s.\n",
+			 __func__);
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+	ciphertext[elen - 1] ^= 1;
+
+	/* a 12-byte tag is the prefix of the 16-byte one: */
+	(void)tc_gcm_config(&g, &sched, 12);
+	if (tc_gcm_generation_encryption(ciphertext, sizeof(ciphertext), iv,
+					 ivlen, hdr, hlen, data, dlen,
+					 &g) == 0 ||
+	    memcmp(expected, ciphertext, elen - 4) != 0 ||
+	    tc_gcm_decryption_verification(decrypted, sizeof(decrypted), iv,
+					   ivlen, hdr, hlen, ciphertext,
+					   elen - 4, &g) == 0) {
+		TC_ERROR("gcm with a 12-byte tag failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	result = TC_PASS;
+
+exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+int test_vector_1(void)
+{
+	/* GCM specification test case 1 (no payload, no associated data) */
+	const uint8_t key[16] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+	};
+	const uint8_t iv[12] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00
+	};
+	const uint8_t expected[16] = {
+		0x58, 0xe2, 0xfc, 0xce, 0xfa, 0x7e, 0x30, 0x61,
+		0x36, 0x7f, 0x1d, 0x57, 0xa4, 0xe7, 0x45, 0x5a
+	};
+
+	return do_test(1, key, iv, sizeof(iv), NULL, 0, NULL, 0,
+		       expected, sizeof(expected));
+}
+
+int test_vector_2(void)
+{
+	/* GCM specification test case 2 (one block) */
+	const uint8_t key[16] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+	};
+	const uint8_t iv[12] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00
+	};
+	const uint8_t data[16] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+	};
+	const uint8_t expected[32] = {
+		0x03, 0x88, 0xda, 0xce, 0x60, 0xb6, 0xa3, 0x92,
+		0xf3, 0x28, 0xc2, 0xb9, 0x71, 0xb2, 0xfe, 0x78,
+		0xab, 0x6e, 0x47, 0xd4, 0x2c, 0xec, 0x13, 0xbd,
+		0xf5, 0x3a, 0x67, 0xb2, 0x12, 0x57, 0xbd, 0xdf
+	};
+
+	return do_test(2, key, iv, sizeof(iv), NULL, 0, data, sizeof(data),
+		       expected, sizeof(expected));
+}
+
+int test_vector_3(void)
+{
+	/* GCM specification test case 3 (four blocks) */
+	const uint8_t key[16] = {
+		0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+		0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08
+	};
+	const uint8_t iv[12] = {
+		0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad,
+		0xde, 0xca, 0xf8, 0x88
+	};
+	const uint8_t data[64] = {
+		0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5,
+		0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+		0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+		0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+		0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53,
+		0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+		0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57,
+		0xba, 0x63, 0x7b, 0x39, 0x1a, 0xaf, 0xd2, 0x55
+	};
+	const uint8_t expected[80] = {
+		0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24,
+		0x4b, 0x72, 0x21, 0xb7, 0x84, 0xd0, 0xd4, 0x9c,
+		0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0,
+		0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e,
+		0x21, 0xd5, 0x14, 0xb2, 0x54, 0x66, 0x93, 0x1c,
+		0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+		0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97,
+		0x3d, 0x58, 0xe0, 0x91, 0x47, 0x3f, 0x59, 0x85,
+		0x4d, 0x5c, 0x2a, 0xf3, 0x27, 0xcd, 0x64, 0xa6,
+		0x2c, 0xf3, 0x5a, 0xbd, 0x2b, 0xa6, 0xfa, 0xb4
+	};
+
+	return do_test(3, key, iv, sizeof(iv), NULL, 0, data, sizeof(data),
+		       expected, sizeof(expected));
+}
+
+int test_vector_4(void)
+{
+	/* GCM specification test case 4 (associated data, partial block) */
+	const uint8_t key[16] = {
+		0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+		0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08
+	};
+	const uint8_t iv[12] = {
+		0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad,
+		0xde, 0xca, 0xf8, 0x88
+	};
+	const uint8_t hdr[20] = {
+		0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+		0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+		0xab, 0xad, 0xda, 0xd2
+	};
+	const uint8_t data[60] = {
+		0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5,
+		0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+		0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+		0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+		0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53,
+		0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+		0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57,
+		0xba, 0x63, 0x7b, 0x39
+	};
+	const uint8_t expected[76] = {
+		0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24,
+		0x4b, 0x72, 0x21, 0xb7, 0x84, 0xd0, 0xd4, 0x9c,
+		0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0,
+		0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e,
+		0x21, 0xd5, 0x14, 0xb2, 0x54, 0x66, 0x93, 0x1c,
+		0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+		0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97,
+		0x3d, 0x58, 0xe0, 0x91, 0x5b, 0xc9, 0x4f, 0xbc,
+		0x32, 0x21, 0xa5, 0xdb, 0x94, 0xfa, 0xe9, 0x5a,
+		0xe7, 0x12, 0x1a, 0x47
+	};
+
+	return do_test(4, key, iv, sizeof(iv), hdr, sizeof(hdr), data, sizeof(data),
+		       expected, sizeof(expected));
+}
+
+int test_vector_5(void)
+{
+	/* GCM specification test case 5 (8-byte IV) */
+	const uint8_t key[16] = {
+		0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+		0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08
+	};
+	const uint8_t iv[8] = {
+		0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad
+	};
+	const uint8_t hdr[20] = {
+		0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+		0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+		0xab, 0xad, 0xda, 0xd2
+	};
+	const uint8_t data[60] = {
+		0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5,
+		0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+		0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+		0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+		0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53,
+		0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+		0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57,
+		0xba, 0x63, 0x7b, 0x39
+	};
+	const uint8_t expected[76] = {
+		0x61, 0x35, 0x3b, 0x4c, 0x28, 0x06, 0x93, 0x4a,
+		0x77, 0x7f, 0xf5, 0x1f, 0xa2, 0x2a, 0x47, 0x55,
+		0x69, 0x9b, 0x2a, 0x71, 0x4f, 0xcd, 0xc6, 0xf8,
+		0x37, 0x66, 0xe5, 0xf9, 0x7b, 0x6c, 0x74, 0x23,
+		0x73, 0x80, 0x69, 0x00, 0xe4, 0x9f, 0x24, 0xb2,
+		0x2b, 0x09, 0x75, 0x44, 0xd4, 0x89, 0x6b, 0x42,
+		0x49, 0x89, 0xb5, 0xe1, 0xeb, 0xac, 0x0f, 0x07,
+		0xc2, 0x3f, 0x45, 0x98, 0x36, 0x12, 0xd2, 0xe7,
+		0x9e, 0x3b, 0x07, 0x85, 0x56, 0x1b, 0xe1, 0x4a,
+		0xac, 0xa2, 0xfc, 0xcb
+	};
+
+	return do_test(5, key, iv, sizeof(iv), hdr, sizeof(hdr), data, sizeof(data),
+		       expected, sizeof(expected));
+}
+
+int test_vector_6(void)
+{
+	/* GCM specification test case 6 (60-byte IV) */
+	const uint8_t key[16] = {
+		0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+		0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08
+	};
+	const uint8_t iv[60] = {
+		0x93, 0x13, 0x22, 0x5d, 0xf8, 0x84, 0x06, 0xe5,
+		0x55, 0x90, 0x9c, 0x5a, 0xff, 0x52, 0x69, 0xaa,
+		0x6a, 0x7a, 0x95, 0x38, 0x53, 0x4f, 0x7d, 0xa1,
+		0xe4, 0xc3, 0x03, 0xd2, 0xa3, 0x18, 0xa7, 0x28,
+		0xc3, 0xc0, 0xc9, 0x51, 0x56, 0x80, 0x95, 0x39,
+		0xfc, 0xf0, 0xe2, 0x42, 0x9a, 0x6b, 0x52, 0x54,
+		0x16, 0xae, 0xdb, 0xf5, 0xa0, 0xde, 0x6a, 0x57,
+		0xa6, 0x37, 0xb3, 0x9b
+	};
+	const uint8_t hdr[20] = {
+		0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+		0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+		0xab, 0xad, 0xda, 0xd2
+	};
+	const uint8_t data[60] = {
+		0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5,
+		0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+		0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+		0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+		0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53,
+		0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+		0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57,
+		0xba, 0x63, 0x7b, 0x39
+	};
+	const uint8_t expected[76] = {
+		0x8c, 0xe2, 0x49, 0x98, 0x62, 0x56, 0x15, 0xb6,
+		0x03, 0xa0, 0x33, 0xac, 0xa1, 0x3f, 0xb8, 0x94,
+		0xbe, 0x91, 0x12, 0xa5, 0xc3, 0xa2, 0x11, 0xa8,
+		0xba, 0x26, 0x2a, 0x3c, 0xca, 0x7e, 0x2c, 0xa7,
+		0x01, 0xe4, 0xa9, 0xa4, 0xfb, 0xa4, 0x3c, 0x90,
+		0xcc, 0xdc, 0xb2, 0x81, 0xd4, 0x8c, 0x7c, 0x6f,
+		0xd6, 0x28, 0x75, 0xd2, 0xac, 0xa4, 0x17, 0x03,
+		0x4c, 0x34, 0xae, 0xe5, 0x61, 0x9c, 0xc5, 0xae,
+		0xff, 0xfe, 0x0b, 0xfa, 0x46, 0x2a, 0xf4, 0x3c,
+		0x16, 0x99, 0xd0, 0x50
+	};
+
+	return do_test(6, key, iv, sizeof(iv), hdr, sizeof(hdr), data, sizeof(data),
+		       expected, sizeof(expected));
+}
+
+/*
+ * Main task to test GCM
+ */
+int main(void)
+{
+	int result = TC_PASS;
+
+	TC_START("Performing GCM tests:");
+
+	result = test_vector_1();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("GCM test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_vector_2();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("GCM test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_vector_3();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("GCM test #3 failed.\n");
+		goto exitTest;
+	}
+	result = test_vector_4();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("GCM test #4 failed.\n");
+		goto exitTest;
+	}
+	result = test_vector_5();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("GCM test #5 failed.\n");
+		goto exitTest;
+	}
+	result = test_vector_6();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("GCM test #6 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All GCM tests succeeded!\n");
+
+exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
@@ -36,6 +36,7 @@
 
   Scenarios tested include:
   - HMAC tests (RFC 4231 test vectors)
+  - the same vectors through a precomputed key (tc_hmac_key_*)
 */
 
 #include <tinycrypt/hmac.h>
@@ -63,6 +64,66 @@ unsigned int do_hmac_test(TCHmacState_t h, unsigned int testnum, const uint8_t *
         return result;
 }
 
+/*
+ * Repeats a test through a precomputed key, split into two updates; the
+ * key state is used twice to check that a MAC leaves it intact.
+ */
+unsigned int do_hmac_key_test(unsigned int testnum, const uint8_t *key,
+			      size_t keylen, const uint8_t *data,
+			      size_t datalen, const uint8_t *expected,
+			      size_t expectedlen)
+{
+        struct tc_hmac_key_struct k;
+        struct tc_sha256_state_struct s;
+        uint8_t digest[32];
+        unsigned int result;
+
+        (void)tc_hmac_key_set(&k, key, keylen);
+        (void)tc_hmac_key_init(&s, &k);
+        (void)tc_sha256_update(&s, data, datalen / 2);
+        (void)tc_sha256_update(&s, data + datalen / 2, datalen - datalen / 2);
+        (void)tc_hmac_key_final(digest, TC_SHA256_DIGEST_SIZE, &s, &k);
+        result = check_result(testnum, expected, expectedlen,
+			      digest, sizeof(digest));
+        if (result == TC_PASS) {
+                (void)tc_hmac_key_mac(digest, TC_SHA256_DIGEST_SIZE, data,
+				      datalen, &k);
+                result = check_result(testnum, expected, expectedlen,
+				      digest, sizeof(digest));
+        }
+        return result;
+}
+
+/*
+ * Repeats a test with the data in scattered segments, one of them empty and
+ * one ending inside a SHA-256 block.
+ */
+unsigned int do_hmac_iov_test(unsigned int testnum, const uint8_t *key,
+			      size_t keylen, const uint8_t *data,
+			      size_t datalen, const uint8_t *expected,
+			      size_t expectedlen)
+{
+        struct tc_hmac_state_struct h;
+        struct tc_iovec iov[4];
+        uint8_t digest[32];
+
+        iov[0].base = (void *)data;
+        iov[0].len = 1;
+        iov[1].base = (void *)(data + 1);
+        iov[1].len = 0;
+        iov[2].base = (void *)(data + 1);
+        iov[2].len = (datalen - 1) / 2;
+        iov[3].base = (void *)(data + 1 + iov[2].len);
+        iov[3].len = datalen - 1 - iov[2].len;
+
+        (void)tc_hmac_set_key(&h, key, keylen);
+        (void)tc_hmac_init(&h);
+        (void)tc_hmac_updatev(&h, iov, 4);
+        (void)tc_hmac_final(digest, TC_SHA256_DIGEST_SIZE, &h);
+        return check_result(testnum, expected, expectedlen,
+			    digest, sizeof(digest));
+}
+
 /*
  * NIST test vectors for encryption.
  */
@@ -90,6 +151,11 @@ unsigned int test_1(void)
         (void)tc_hmac_set_key(&h, key, sizeof(key));
         result = do_hmac_test(&h, 1, data, sizeof(data),expected,
 			      sizeof(expected));
+        if (result == TC_PASS) {
+                result = do_hmac_key_test(1, key, sizeof(key), data,
+					  sizeof(data), expected,
+					  sizeof(expected));
+        }
         TC_END_RESULT(result);
         return result;
 }
@@ -118,6 +184,11 @@ unsigned int test_2(void)
 
         result = do_hmac_test(&h, 2, data, sizeof(data), expected,
 			      sizeof(expected));
+        if (result == TC_PASS) {
+                result = do_hmac_key_test(2, key, sizeof(key), data,
+					  sizeof(data), expected,
+					  sizeof(expected));
+        }
         TC_END_RESULT(result);
         return result;
 }
@@ -149,6 +220,11 @@ unsigned int test_3(void)
 
         result = do_hmac_test(&h, 3, data, sizeof(data), expected,
 			      sizeof(expected));
+        if (result == TC_PASS) {
+                result = do_hmac_key_test(3, key, sizeof(key), data,
+					  sizeof(data), expected,
+					  sizeof(expected));
+        }
         TC_END_RESULT(result);
         return result;
 }
@@ -182,6 +258,11 @@ unsigned int test_4(void)
 
         result = do_hmac_test(&h, 4, data, sizeof(data), expected,
 			      sizeof(expected));
+        if (result == TC_PASS) {
+                result = do_hmac_key_test(4, key, sizeof(key), data,
+					  sizeof(data), expected,
+					  sizeof(expected));
+        }
         TC_END_RESULT(result);
         return result;
 }
@@ -210,6 +291,11 @@ unsigned int test_5(void)
 
         result = do_hmac_test(&h, 5, data, sizeof(data), expected,
 			      sizeof(expected));
+        if (result == TC_PASS) {
+                result = do_hmac_key_test(5, key, sizeof(key), data,
+					  sizeof(data), expected,
+					  sizeof(expected));
+        }
         TC_END_RESULT(result);
         return result;
 }
@@ -250,6 +336,11 @@ unsigned int test_6(void)
 
         result = do_hmac_test(&h, 6, data, sizeof(data), expected,
 			      sizeof(expected));
+        if (result == TC_PASS) {
+                result = do_hmac_key_test(6, key, sizeof(key), data,
+					  sizeof(data), expected,
+					  sizeof(expected));
+        }
         TC_END_RESULT(result);
         return result;
 }
@@ -298,6 +389,16 @@ unsigned int test_7(void)
 
         result = do_hmac_test(&h, 7, data, sizeof(data), expected,
 			      sizeof(expected));
+        if (result == TC_PASS) {
+                result = do_hmac_key_test(7, key, sizeof(key), data,
+					  sizeof(data), expected,
+					  sizeof(expected));
+        }
+        if (result == TC_PASS) {
+                result = do_hmac_iov_test(7, key, sizeof(key), data,
+					  sizeof(data), expected,
+					  sizeof(expected));
+        }
         TC_END_RESULT(result);
         return result;
 }
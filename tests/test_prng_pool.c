@@ -0,0 +1,272 @@
+/* test_prng_pool.c - TinyCrypt implementation of some CTR-PRNG pool tests */
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *  DESCRIPTION
+ * This module tests the CTR-PRNG pool routines:
+ *
+ *  Scenarios tested include:
+ *  - shards are seeded independently and served from their buffers
+ *  - reseeds requested through the pool epoch, after the reseed interval
+ *    and the recovery from a failing entropy source
+ *  - the uECC_RNG_Ctx_Function adapter
+ *  - robustness to invalid inputs
+ */
+
+#include <tinycrypt/prng_pool.h>
+#include <tinycrypt/ecc.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define SHARDS 4
+
+static unsigned int entropy_calls;
+static int entropy_broken;
+static uint8_t entropy_counter;
+
+/* deterministic stand-in for default_CSPRNG */
+static int test_entropy(uint8_t *dest, unsigned int size)
+{
+	unsigned int i;
+
+	if (entropy_broken) {
+		return 0;
+	}
+	entropy_calls++;
+	for (i = 0; i < size; ++i) {
+		dest[i] = entropy_counter++;
+	}
+	return 1;
+}
+
+static int test_shards(TCPrngPool_t pool)
+{
+	uint8_t a[32], b[32], big[1000];
+	TCPrngShard_t s0 = tc_prng_pool_shard(pool, 0);
+	TCPrngShard_t s1 = tc_prng_pool_shard(pool, 1);
+
+	TC_PRINT("Performing pool test #1 (independent shards)\n");
+
+	if (s0 == 0 || s1 == 0 || s0 == s1 ||
+	    tc_prng_pool_shard(pool, SHARDS) != 0) {
+		TC_ERROR("%s: tc_prng_pool_shard failed\n", __func__);
+		return TC_FAIL;
+	}
+
+	if (tc_prng_pool_generate(s0, a, sizeof(a)) != TC_CRYPTO_SUCCESS ||
+	    tc_prng_pool_generate(s1, b, sizeof(b)) != TC_CRYPTO_SUCCESS ||
+	    memcmp(a, b, sizeof(a)) == 0) {
+		TC_ERROR("%s: shards 0 and 1 agree\n", __func__);
+		return TC_FAIL;
+	}
+
+	/* small requests come out of the buffer without new requests */
+	if (s0->left != TINYCRYPT_PRNG_POOL_BUFFER_SIZE - sizeof(a) ||
+	    s0->requests != 1 ||
+	    tc_prng_pool_generate(s0, b, sizeof(b)) != TC_CRYPTO_SUCCESS ||
+	    memcmp(a, b, sizeof(a)) == 0 || s0->requests != 1) {
+		TC_ERROR("%s: buffered output failed\n", __func__);
+		return TC_FAIL;
+	}
+
+	/* large requests bypass the buffer */
+	if (tc_prng_pool_generate(s0, big, sizeof(big)) != TC_CRYPTO_SUCCESS ||
+	    s0->requests != 2 ||
+	    s0->left != TINYCRYPT_PRNG_POOL_BUFFER_SIZE - 2 * sizeof(a)) {
+		TC_ERROR("%s: bulk output failed\n", __func__);
+		return TC_FAIL;
+	}
+
+	TC_END_RESULT(TC_PASS);
+	return TC_PASS;
+}
+
+static int test_reseed(TCPrngPool_t pool)
+{
+	uint8_t out[16];
+	TCPrngShard_t s0 = tc_prng_pool_shard(pool, 0);
+	TCPrngShard_t s1 = tc_prng_pool_shard(pool, 1);
+	unsigned int calls;
+
+	TC_PRINT("Performing pool test #2 (reseeding)\n");
+
+	/* each shard picks up a requested reseed once, on its next request */
+	calls = entropy_calls;
+	tc_prng_pool_request_reseed(pool);
+	(void)tc_prng_pool_generate(s0, out, sizeof(out));
+	(void)tc_prng_pool_generate(s0, out, sizeof(out));
+	if (entropy_calls != calls + 1 || s0->epoch != pool->epoch ||
+	    s1->epoch == pool->epoch) {
+		TC_ERROR("%s: requested reseed not applied to shard 0\n",
+			 __func__);
+		return TC_FAIL;
+	}
+	(void)tc_prng_pool_generate(s1, out, sizeof(out));
+	if (entropy_calls != calls + 2 || s1->epoch != pool->epoch) {
+		TC_ERROR("%s: requested reseed not applied to shard 1\n",
+			 __func__);
+		return TC_FAIL;
+	}
+
+	/* the interval forces a reseed at the next refill */
+	calls = entropy_calls;
+	s0->requests = TINYCRYPT_PRNG_POOL_RESEED_INTERVAL;
+	s0->left = 0;
+	if (tc_prng_pool_generate(s0, out, sizeof(out)) != TC_CRYPTO_SUCCESS ||
+	    entropy_calls != calls + 1 || s0->requests != 1) {
+		TC_ERROR("%s: reseed interval not enforced\n", __func__);
+		return TC_FAIL;
+	}
+
+	/* no output without a due reseed, and recovery afterwards */
+	entropy_broken = 1;
+	tc_prng_pool_request_reseed(pool);
+	if (tc_prng_pool_generate(s0, out, sizeof(out)) != TC_CRYPTO_FAIL) {
+		TC_ERROR("%s: generate succeeded without entropy\n", __func__);
+		return TC_FAIL;
+	}
+	entropy_broken = 0;
+	if (tc_prng_pool_generate(s0, out, sizeof(out)) != TC_CRYPTO_SUCCESS ||
+	    s0->epoch != pool->epoch) {
+		TC_ERROR("%s: no recovery after entropy failure\n", __func__);
+		return TC_FAIL;
+	}
+
+	TC_END_RESULT(TC_PASS);
+	return TC_PASS;
+}
+
+static int test_rng_hook(TCPrngPool_t pool)
+{
+	uECC_RNG_Ctx_Function rng = tc_prng_pool_rng;
+	uint8_t out[32];
+
+	TC_PRINT("Performing pool test #3 (ECC RNG callback)\n");
+
+	if (rng(tc_prng_pool_shard(pool, 2), out, sizeof(out)) != 1 ||
+	    rng(tc_prng_pool_shard(pool, 2), out, 0) != 0 ||
+	    rng(0, out, sizeof(out)) != 0) {
+		TC_ERROR("%s: tc_prng_pool_rng failed\n", __func__);
+		return TC_FAIL;
+	}
+
+	TC_END_RESULT(TC_PASS);
+	return TC_PASS;
+}
+
+static int test_robustness(void)
+{
+	struct tc_prng_shard_struct shards[SHARDS];
+	struct tc_prng_pool_struct pool;
+	uint8_t out[16];
+
+	TC_PRINT("Performing pool test #4 (invalid inputs)\n");
+
+	if (tc_prng_pool_init(0, shards, SHARDS, test_entropy) != 0 ||
+	    tc_prng_pool_init(&pool, 0, SHARDS, test_entropy) != 0 ||
+	    tc_prng_pool_init(&pool, shards, 0, test_entropy) != 0 ||
+	    tc_prng_pool_init(&pool, shards, SHARDS, 0) != 0 ||
+	    tc_prng_pool_generate(0, out, sizeof(out)) != 0 ||
+	    tc_prng_pool_shard(0, 0) != 0) {
+		TC_ERROR("%s: invalid input accepted\n", __func__);
+		return TC_FAIL;
+	}
+
+	entropy_broken = 1;
+	if (tc_prng_pool_init(&pool, shards, SHARDS, test_entropy) != 0 ||
+	    tc_prng_pool_shard(&pool, 0) != 0) {
+		entropy_broken = 0;
+		TC_ERROR("%s: init succeeded without entropy\n", __func__);
+		return TC_FAIL;
+	}
+	entropy_broken = 0;
+
+	tc_prng_pool_request_reseed(0);
+	tc_prng_pool_uninstantiate(0);
+
+	TC_END_RESULT(TC_PASS);
+	return TC_PASS;
+}
+
+/*
+ * Main task to test the CTR-PRNG pool
+ */
+int main(void)
+{
+	struct tc_prng_shard_struct shards[SHARDS];
+	struct tc_prng_pool_struct pool;
+	int result = TC_PASS;
+
+	TC_START("Performing CTR-PRNG pool tests:");
+
+	if (tc_prng_pool_init(&pool, shards, SHARDS, test_entropy) !=
+	    TC_CRYPTO_SUCCESS || entropy_calls != SHARDS) {
+		TC_ERROR("tc_prng_pool_init failed\n");
+		result = TC_FAIL;
+		goto exitTest;
+	}
+
+	result = test_shards(&pool);
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+	result = test_reseed(&pool);
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+	result = test_rng_hook(&pool);
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+
+	tc_prng_pool_uninstantiate(&pool);
+	if (tc_prng_pool_shard(&pool, 0) != 0) {
+		TC_ERROR("tc_prng_pool_uninstantiate failed\n");
+		result = TC_FAIL;
+		goto exitTest;
+	}
+
+	result = test_robustness();
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+
+	TC_PRINT("All CTR-PRNG pool tests succeeded!\n");
+
+exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
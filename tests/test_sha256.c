@@ -36,9 +36,14 @@
 
   Scenarios tested include:
   - NIST SHA256 test vectors
+  - SHA256 of a message split into chunks of various sizes and alignments
+  - SHA256 hardware compression engine against the portable implementation
+  - Multi-buffer SHA256 against one message at a time
 */
 
 #include <tinycrypt/sha256.h>
+#include <tinycrypt/sha256_hw.h>
+#include <tinycrypt/sha256_mb.h>
 #include <tinycrypt/constants.h>
 #include <test_utils.h>
 
@@ -407,6 +412,194 @@ unsigned int test_14(void)
         return result;
 }
 
+/*
+ * Whole blocks are hashed straight from the caller's buffer: chunks that
+ * leave, complete and skip the leftover block, at odd addresses, must give
+ * the digest of byte-by-byte updates.
+ */
+unsigned int test_15(void)
+{
+        unsigned int result = TC_PASS;
+        TC_PRINT("SHA256 test #15 (chunked updates):\n");
+        const unsigned int chunks[] = {
+		1, 3, 63, 64, 65, 127, 128, 129, 200, 1000
+        };
+        uint8_t m[1001];
+        uint8_t expected[32];
+        uint8_t digest[32];
+        struct tc_sha256_state_struct s;
+        unsigned int i;
+        unsigned int j;
+        unsigned int n;
+
+        for (i = 0; i < sizeof(m); ++i) {
+		m[i] = (uint8_t)(i * 31 + 7);
+        }
+
+        (void)tc_sha256_init(&s);
+        for (i = 1; i < sizeof(m); ++i) {
+		(void)tc_sha256_update(&s, &m[i], 1);
+        }
+        (void)tc_sha256_final(expected, &s);
+
+        for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i) {
+		(void)tc_sha256_init(&s);
+		for (j = 1; j < sizeof(m); j += n) {
+			n = chunks[i];
+			if (n > sizeof(m) - j) {
+				n = sizeof(m) - j;
+			}
+			(void)tc_sha256_update(&s, &m[j], n);
+		}
+		(void)tc_sha256_final(digest, &s);
+
+		result = check_result(15, expected, sizeof(expected),
+				      digest, sizeof(digest));
+		if (result == TC_FAIL) {
+			break;
+		}
+        }
+
+        TC_END_RESULT(result);
+        return result;
+}
+
+/*
+ * The hardware engine must update the chaining value exactly as the portable
+ * compression does (skipped when the CPU has no SHA instructions).
+ */
+unsigned int test_16(void)
+{
+        unsigned int result = TC_PASS;
+        TC_PRINT("SHA256 test #16 (hardware engine):\n");
+        uint8_t m[5 * TC_SHA256_BLOCK_SIZE + 1];
+        struct tc_sha256_state_struct s;
+        struct tc_sha256_state_struct hw;
+        unsigned int i;
+
+        if (!tc_sha256_hw_available()) {
+		TC_PRINT("SHA256 hardware engine not available, skipped\n");
+		TC_END_RESULT(result);
+		return result;
+        }
+
+        for (i = 0; i < sizeof(m); ++i) {
+		m[i] = (uint8_t)(i * 17 + 1);
+        }
+
+        /* chain 1..5 blocks, from an odd address */
+        for (i = 1; i <= 5; ++i) {
+		(void)tc_sha256_init(&s);
+		(void)tc_sha256_init(&hw);
+		(void)tc_sha256_update(&s, &m[1], i * TC_SHA256_BLOCK_SIZE);
+		(void)tc_sha256_hw_compress_blocks(hw.iv, &m[1], i);
+
+		result = check_result(16, (const uint8_t *) s.iv, sizeof(s.iv),
+				      (const uint8_t *) hw.iv, sizeof(hw.iv));
+		if (result == TC_FAIL) {
+			break;
+		}
+        }
+
+        TC_END_RESULT(result);
+        return result;
+}
+
+/*
+ * Multi-buffer hashing of messages of different lengths (so that lanes run
+ * out at different times and are refilled), fed in two updates of different
+ * sizes, must give the digests of tc_sha256_update/tc_sha256_final.
+ */
+unsigned int test_17(void)
+{
+        unsigned int result = TC_PASS;
+        TC_PRINT("SHA256 test #17 (multi-buffer):\n");
+        const unsigned int count = 2 * TC_SHA256_MB_LANES + 3;
+        struct tc_sha256_state_struct s[2 * TC_SHA256_MB_LANES + 3];
+        struct tc_sha256_state_struct t;
+        const uint8_t *data[2 * TC_SHA256_MB_LANES + 3];
+        size_t datalen[2 * TC_SHA256_MB_LANES + 3];
+        uint8_t digests[2 * TC_SHA256_MB_LANES + 3][32];
+        uint8_t *digest[2 * TC_SHA256_MB_LANES + 3];
+        uint8_t expected[32];
+        uint8_t m[700];
+        unsigned int i;
+
+        for (i = 0; i < sizeof(m); ++i) {
+		m[i] = (uint8_t)(i * 7 + 11);
+        }
+
+        for (i = 0; i < count; ++i) {
+		(void)tc_sha256_init(&s[i]);
+		data[i] = &m[i];
+		datalen[i] = (i * 37) % 150;
+		digest[i] = digests[i];
+        }
+        (void)tc_sha256_mb_update(s, data, datalen, count);
+        for (i = 0; i < count; ++i) {
+		data[i] += datalen[i];
+		datalen[i] = (i * 101) % 520;
+        }
+        (void)tc_sha256_mb_update(s, data, datalen, count);
+        (void)tc_sha256_mb_final(digest, s, count);
+
+        for (i = 0; i < count; ++i) {
+		(void)tc_sha256_init(&t);
+		(void)tc_sha256_update(&t, &m[i], (i * 37) % 150);
+		(void)tc_sha256_update(&t, &m[i + (i * 37) % 150],
+				       (i * 101) % 520);
+		(void)tc_sha256_final(expected, &t);
+
+		result = check_result(17, expected, sizeof(expected),
+				      digest[i], sizeof(expected));
+		if (result == TC_FAIL) {
+			break;
+		}
+        }
+
+        TC_END_RESULT(result);
+        return result;
+}
+
+/*
+ * Scatter-gather update over segments that end inside blocks, span several
+ * of them, or are empty must give the digest of one contiguous update.
+ */
+unsigned int test_18(void)
+{
+        unsigned int result = TC_PASS;
+        TC_PRINT("SHA256 test #18 (scatter-gather update):\n");
+        const unsigned int split[] = { 3, 0, 61, 1, 200, 64, 0, 371 };
+        struct tc_sha256_state_struct s;
+        struct tc_iovec iov[8];
+        uint8_t expected[32];
+        uint8_t digest[32];
+        uint8_t m[700];
+        unsigned int i, off;
+
+        for (i = 0; i < sizeof(m); ++i) {
+		m[i] = (uint8_t)(i * 7 + 11);
+        }
+        for (i = off = 0; i < 8; off += split[i++]) {
+		iov[i].base = &m[off];
+		iov[i].len = split[i];
+        }
+
+        (void)tc_sha256_init(&s);
+        (void)tc_sha256_update(&s, m, sizeof(m));
+        (void)tc_sha256_final(expected, &s);
+
+        (void)tc_sha256_init(&s);
+        (void)tc_sha256_updatev(&s, iov, 4);
+        (void)tc_sha256_updatev(&s, &iov[4], 4);
+        (void)tc_sha256_final(digest, &s);
+
+        result = check_result(18, expected, sizeof(expected),
+			      digest, sizeof(digest));
+        TC_END_RESULT(result);
+        return result;
+}
+
 /*
  * Main task to test AES
  */
@@ -502,6 +695,34 @@ int main(void)
                 goto exitTest;
         }
 
+        result = test_15();
+        if (result == TC_FAIL) {
+		/* terminate test */
+                TC_ERROR("SHA256 test #15 failed.\n");
+                goto exitTest;
+        }
+
+        result = test_16();
+        if (result == TC_FAIL) {
+		/* terminate test */
+                TC_ERROR("SHA256 test #16 failed.\n");
+                goto exitTest;
+        }
+
+        result = test_17();
+        if (result == TC_FAIL) {
+		/* terminate test */
+                TC_ERROR("SHA256 test #17 failed.\n");
+                goto exitTest;
+        }
+
+        result = test_18();
+        if (result == TC_FAIL) {
+		/* terminate test */
+                TC_ERROR("SHA256 test #18 failed.\n");
+                goto exitTest;
+        }
+
         TC_PRINT("All SHA256 tests succeeded!\n");
 
 exitTest:
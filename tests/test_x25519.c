@@ -0,0 +1,399 @@
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  test_x25519.c -- Implementation of some X25519 tests
+ *
+ */
+
+/*
+  DESCRIPTION
+  This module tests the following X25519 routines:
+
+  Scenarios tested include:
+  - RFC 7748 X25519 test vectors (section 5.2)
+  - RFC 7748 iterated X25519, 1 and 1,000 iterations
+  - RFC 7748 Diffie-Hellman example (section 6.1)
+  - Non-canonical u coordinates and points of small order
+  - Key agreement between freshly generated key pairs
+*/
+
+#include <tinycrypt/x25519.h>
+#include <tinycrypt/ecc.h>
+#include <tinycrypt/ecc_platform_specific.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * RFC 7748, section 5.2: the two X25519 test vectors.
+ */
+unsigned int test_1(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_PRINT("X25519 test #1 (RFC 7748 vectors):\n");
+const uint8_t k1[TC_X25519_KEY_SIZE] = {
+		0xa5, 0x46, 0xe3, 0x6b, 0xf0, 0x52, 0x7c, 0x9d, 0x3b, 0x16, 0x15, 0x4b,
+		0x82, 0x46, 0x5e, 0xdd, 0x62, 0x14, 0x4c, 0x0a, 0xc1, 0xfc, 0x5a, 0x18,
+		0x50, 0x6a, 0x22, 0x44, 0xba, 0x44, 0x9a, 0xc4
+	};
+	const uint8_t u1[TC_X25519_KEY_SIZE] = {
+		0xe6, 0xdb, 0x68, 0x67, 0x58, 0x30, 0x30, 0xdb, 0x35, 0x94, 0xc1, 0xa4,
+		0x24, 0xb1, 0x5f, 0x7c, 0x72, 0x66, 0x24, 0xec, 0x26, 0xb3, 0x35, 0x3b,
+		0x10, 0xa9, 0x03, 0xa6, 0xd0, 0xab, 0x1c, 0x4c
+	};
+	const uint8_t r1[TC_X25519_KEY_SIZE] = {
+		0xc3, 0xda, 0x55, 0x37, 0x9d, 0xe9, 0xc6, 0x90, 0x8e, 0x94, 0xea, 0x4d,
+		0xf2, 0x8d, 0x08, 0x4f, 0x32, 0xec, 0xcf, 0x03, 0x49, 0x1c, 0x71, 0xf7,
+		0x54, 0xb4, 0x07, 0x55, 0x77, 0xa2, 0x85, 0x52
+	};
+	const uint8_t k2[TC_X25519_KEY_SIZE] = {
+		0x4b, 0x66, 0xe9, 0xd4, 0xd1, 0xb4, 0x67, 0x3c, 0x5a, 0xd2, 0x26, 0x91,
+		0x95, 0x7d, 0x6a, 0xf5, 0xc1, 0x1b, 0x64, 0x21, 0xe0, 0xea, 0x01, 0xd4,
+		0x2c, 0xa4, 0x16, 0x9e, 0x79, 0x18, 0xba, 0x0d
+	};
+	const uint8_t u2[TC_X25519_KEY_SIZE] = {
+		0xe5, 0x21, 0x0f, 0x12, 0x78, 0x68, 0x11, 0xd3, 0xf4, 0xb7, 0x95, 0x9d,
+		0x05, 0x38, 0xae, 0x2c, 0x31, 0xdb, 0xe7, 0x10, 0x6f, 0xc0, 0x3c, 0x3e,
+		0xfc, 0x4c, 0xd5, 0x49, 0xc7, 0x15, 0xa4, 0x93
+	};
+	const uint8_t r2[TC_X25519_KEY_SIZE] = {
+		0x95, 0xcb, 0xde, 0x94, 0x76, 0xe8, 0x90, 0x7d, 0x7a, 0xad, 0xe4, 0x5c,
+		0xb4, 0xb8, 0x73, 0xf8, 0x8b, 0x59, 0x5a, 0x68, 0x79, 0x9f, 0xa1, 0x52,
+		0xe6, 0xf8, 0xf7, 0x64, 0x7a, 0xac, 0x79, 0x57
+	};
+	uint8_t out[TC_X25519_KEY_SIZE];
+
+	if (tc_x25519(out, k1, u1) != TC_CRYPTO_SUCCESS) {
+		TC_ERROR("tc_x25519 failed\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+	result = check_result(1, r1, sizeof(r1), out, sizeof(out));
+	if (result == TC_FAIL) {
+		goto exitTest1;
+	}
+	if (tc_x25519(out, k2, u2) != TC_CRYPTO_SUCCESS) {
+		TC_ERROR("tc_x25519 failed\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+	result = check_result(1, r2, sizeof(r2), out, sizeof(out));
+
+exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * RFC 7748, section 5.2: k = u = 9, then k, u = X25519(k, u), k.
+ */
+unsigned int test_2(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_PRINT("X25519 test #2 (RFC 7748 iterations):\n");
+	const uint8_t after_1[TC_X25519_KEY_SIZE] = {
+		0x42, 0x2c, 0x8e, 0x7a, 0x62, 0x27, 0xd7, 0xbc, 0xa1, 0x35, 0x0b, 0x3e,
+		0x2b, 0xb7, 0x27, 0x9f, 0x78, 0x97, 0xb8, 0x7b, 0xb6, 0x85, 0x4b, 0x78,
+		0x3c, 0x60, 0xe8, 0x03, 0x11, 0xae, 0x30, 0x79
+	};
+	const uint8_t after_1000[TC_X25519_KEY_SIZE] = {
+		0x68, 0x4c, 0xf5, 0x9b, 0xa8, 0x33, 0x09, 0x55, 0x28, 0x00, 0xef, 0x56,
+		0x6f, 0x2f, 0x4d, 0x3c, 0x1c, 0x38, 0x87, 0xc4, 0x93, 0x60, 0xe3, 0x87,
+		0x5f, 0x2e, 0xb9, 0x4d, 0x99, 0x53, 0x2c, 0x51
+	};
+	uint8_t k[TC_X25519_KEY_SIZE] = { 9 };
+	uint8_t u[TC_X25519_KEY_SIZE] = { 9 };
+	uint8_t out[TC_X25519_KEY_SIZE];
+	unsigned int i;
+
+	for (i = 1; i <= 1000; ++i) {
+		(void)tc_x25519(out, k, u);
+		memcpy(u, k, sizeof(u));
+		memcpy(k, out, sizeof(k));
+		if (i == 1) {
+			result = check_result(2, after_1, sizeof(after_1),
+					      k, sizeof(k));
+			if (result == TC_FAIL) {
+				goto exitTest2;
+			}
+		}
+	}
+	result = check_result(2, after_1000, sizeof(after_1000), k, sizeof(k));
+
+exitTest2:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * RFC 7748, section 6.1: Alice and Bob's key pairs and shared secret.
+ */
+unsigned int test_3(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_PRINT("X25519 test #3 (RFC 7748 Diffie-Hellman):\n");
+	const uint8_t alice_priv[TC_X25519_KEY_SIZE] = {
+		0x77, 0x07, 0x6d, 0x0a, 0x73, 0x18, 0xa5, 0x7d, 0x3c, 0x16, 0xc1, 0x72,
+		0x51, 0xb2, 0x66, 0x45, 0xdf, 0x4c, 0x2f, 0x87, 0xeb, 0xc0, 0x99, 0x2a,
+		0xb1, 0x77, 0xfb, 0xa5, 0x1d, 0xb9, 0x2c, 0x2a
+	};
+	const uint8_t alice_pub[TC_X25519_KEY_SIZE] = {
+		0x85, 0x20, 0xf0, 0x09, 0x89, 0x30, 0xa7, 0x54, 0x74, 0x8b, 0x7d, 0xdc,
+		0xb4, 0x3e, 0xf7, 0x5a, 0x0d, 0xbf, 0x3a, 0x0d, 0x26, 0x38, 0x1a, 0xf4,
+		0xeb, 0xa4, 0xa9, 0x8e, 0xaa, 0x9b, 0x4e, 0x6a
+	};
+	const uint8_t bob_priv[TC_X25519_KEY_SIZE] = {
+		0x5d, 0xab, 0x08, 0x7e, 0x62, 0x4a, 0x8a, 0x4b, 0x79, 0xe1, 0x7f, 0x8b,
+		0x83, 0x80, 0x0e, 0xe6, 0x6f, 0x3b, 0xb1, 0x29, 0x26, 0x18, 0xb6, 0xfd,
+		0x1c, 0x2f, 0x8b, 0x27, 0xff, 0x88, 0xe0, 0xeb
+	};
+	const uint8_t bob_pub[TC_X25519_KEY_SIZE] = {
+		0xde, 0x9e, 0xdb, 0x7d, 0x7b, 0x7d, 0xc1, 0xb4, 0xd3, 0x5b, 0x61, 0xc2,
+		0xec, 0xe4, 0x35, 0x37, 0x3f, 0x83, 0x43, 0xc8, 0x5b, 0x78, 0x67, 0x4d,
+		0xad, 0xfc, 0x7e, 0x14, 0x6f, 0x88, 0x2b, 0x4f
+	};
+	const uint8_t shared[TC_X25519_KEY_SIZE] = {
+		0x4a, 0x5d, 0x9d, 0x5b, 0xa4, 0xce, 0x2d, 0xe1, 0x72, 0x8e, 0x3b, 0xf4,
+		0x80, 0x35, 0x0f, 0x25, 0xe0, 0x7e, 0x21, 0xc9, 0x47, 0xd1, 0x9e, 0x33,
+		0x76, 0xf0, 0x9b, 0x3c, 0x1e, 0x16, 0x17, 0x42
+	};
+	uint8_t pub[TC_X25519_KEY_SIZE];
+	uint8_t secret[TC_X25519_KEY_SIZE];
+
+	(void)tc_x25519_public_key(pub, alice_priv);
+	result = check_result(3, alice_pub, sizeof(alice_pub), pub, sizeof(pub));
+	if (result == TC_FAIL) {
+		goto exitTest3;
+	}
+	(void)tc_x25519_public_key(pub, bob_priv);
+	result = check_result(3, bob_pub, sizeof(bob_pub), pub, sizeof(pub));
+	if (result == TC_FAIL) {
+		goto exitTest3;
+	}
+	if (tc_x25519_shared_secret(bob_pub, alice_priv, secret) !=
+	    TC_CRYPTO_SUCCESS) {
+		TC_ERROR("tc_x25519_shared_secret failed\n");
+		result = TC_FAIL;
+		goto exitTest3;
+	}
+	result = check_result(3, shared, sizeof(shared), secret, sizeof(secret));
+	if (result == TC_FAIL) {
+		goto exitTest3;
+	}
+	if (tc_x25519_shared_secret(alice_pub, bob_priv, secret) !=
+	    TC_CRYPTO_SUCCESS) {
+		TC_ERROR("tc_x25519_shared_secret failed\n");
+		result = TC_FAIL;
+		goto exitTest3;
+	}
+	result = check_result(3, shared, sizeof(shared), secret, sizeof(secret));
+
+exitTest3:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * u coordinates with bit 255 set or at least p are taken modulo 2^255 and p;
+ * u = 0, 1 and p - 1 have small order and give an all-zero secret.
+ */
+unsigned int test_4(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_PRINT("X25519 test #4 (non-canonical and small-order points):\n");
+const uint8_t k1[TC_X25519_KEY_SIZE] = {
+		0xa5, 0x46, 0xe3, 0x6b, 0xf0, 0x52, 0x7c, 0x9d, 0x3b, 0x16, 0x15, 0x4b,
+		0x82, 0x46, 0x5e, 0xdd, 0x62, 0x14, 0x4c, 0x0a, 0xc1, 0xfc, 0x5a, 0x18,
+		0x50, 0x6a, 0x22, 0x44, 0xba, 0x44, 0x9a, 0xc4
+	};
+	const uint8_t u1[TC_X25519_KEY_SIZE] = {
+		0xe6, 0xdb, 0x68, 0x67, 0x58, 0x30, 0x30, 0xdb, 0x35, 0x94, 0xc1, 0xa4,
+		0x24, 0xb1, 0x5f, 0x7c, 0x72, 0x66, 0x24, 0xec, 0x26, 0xb3, 0x35, 0x3b,
+		0x10, 0xa9, 0x03, 0xa6, 0xd0, 0xab, 0x1c, 0x4c
+	};
+	const uint8_t r1[TC_X25519_KEY_SIZE] = {
+		0xc3, 0xda, 0x55, 0x37, 0x9d, 0xe9, 0xc6, 0x90, 0x8e, 0x94, 0xea, 0x4d,
+		0xf2, 0x8d, 0x08, 0x4f, 0x32, 0xec, 0xcf, 0x03, 0x49, 0x1c, 0x71, 0xf7,
+		0x54, 0xb4, 0x07, 0x55, 0x77, 0xa2, 0x85, 0x52
+	};
+	/* p + 9 */
+	const uint8_t p_plus_9[TC_X25519_KEY_SIZE] = {
+		0xf6, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f
+	};
+	const uint8_t zero[TC_X25519_KEY_SIZE] = { 0 };
+	const uint8_t nine[TC_X25519_KEY_SIZE] = { 9 };
+	uint8_t u[TC_X25519_KEY_SIZE];
+	uint8_t out[TC_X25519_KEY_SIZE], expected[TC_X25519_KEY_SIZE];
+	unsigned int i;
+
+	memcpy(u, u1, sizeof(u));
+	u[31] |= 0x80;
+	(void)tc_x25519(out, k1, u);
+	result = check_result(4, r1, sizeof(r1), out, sizeof(out));
+	if (result == TC_FAIL) {
+		goto exitTest4;
+	}
+
+	(void)tc_x25519(expected, k1, nine);
+	(void)tc_x25519(out, k1, p_plus_9);
+	result = check_result(4, expected, sizeof(expected), out, sizeof(out));
+	if (result == TC_FAIL) {
+		goto exitTest4;
+	}
+
+	for (i = 0; i < 3; ++i) {
+		memset(u, 0, sizeof(u));
+		if (i == 1) {
+			u[0] = 1;
+		} else if (i == 2) {
+			/* p - 1 */
+			memset(u, 0xff, sizeof(u));
+			u[0] = 0xec;
+			u[31] = 0x7f;
+		}
+		if (tc_x25519_shared_secret(u, k1, out) != TC_CRYPTO_FAIL) {
+			TC_ERROR("small-order point %u accepted\n", i);
+			result = TC_FAIL;
+			goto exitTest4;
+		}
+		result = check_result(4, zero, sizeof(zero), out, sizeof(out));
+		if (result == TC_FAIL) {
+			goto exitTest4;
+		}
+	}
+
+exitTest4:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Two freshly generated key pairs agree on the same secret.
+ */
+unsigned int test_5(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_PRINT("X25519 test #5 (key agreement):\n");
+	uint8_t pub1[TC_X25519_KEY_SIZE], priv1[TC_X25519_KEY_SIZE];
+	uint8_t pub2[TC_X25519_KEY_SIZE], priv2[TC_X25519_KEY_SIZE];
+	uint8_t secret1[TC_X25519_KEY_SIZE], secret2[TC_X25519_KEY_SIZE];
+	unsigned int i;
+
+	for (i = 0; i < 100; ++i) {
+		if (!tc_x25519_make_key(pub1, priv1) ||
+		    !tc_x25519_make_key_with_rng(pub2, priv2,
+						 &uECC_global_rng, 0)) {
+			TC_ERROR("tc_x25519_make_key failed\n");
+			result = TC_FAIL;
+			goto exitTest5;
+		}
+		if (!tc_x25519_shared_secret(pub2, priv1, secret1) ||
+		    !tc_x25519_shared_secret(pub1, priv2, secret2)) {
+			TC_ERROR("tc_x25519_shared_secret failed\n");
+			result = TC_FAIL;
+			goto exitTest5;
+		}
+		result = check_result(5, secret1, sizeof(secret1),
+				      secret2, sizeof(secret2));
+		if (result == TC_FAIL) {
+			goto exitTest5;
+		}
+	}
+
+	if (tc_x25519_make_key_with_rng(pub1, priv1, 0, 0) != TC_CRYPTO_FAIL) {
+		TC_ERROR("tc_x25519_make_key_with_rng without an RNG\n");
+		result = TC_FAIL;
+	}
+
+exitTest5:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test X25519
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing X25519 tests:");
+
+	/* Setup of the Cryptographically Secure PRNG. */
+	uECC_set_rng(&default_CSPRNG);
+
+	result = test_1();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("X25519 test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_2();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("X25519 test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_3();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("X25519 test #3 failed.\n");
+		goto exitTest;
+	}
+	result = test_4();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("X25519 test #4 failed.\n");
+		goto exitTest;
+	}
+	result = test_5();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("X25519 test #5 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All X25519 tests succeeded!\n");
+
+exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+	return result;
+}
@@ -0,0 +1,422 @@
+/* tc_file.c - TinyCrypt host-side file hashing and encryption helpers */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* for mmap, posix_madvise, aio_read and pread */
+#define _POSIX_C_SOURCE 200809L
+
+#include "tc_file.h"
+#include <tinycrypt/ctr_mode.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+#include <aio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Bytes handed to the engines at a time. All chunks but the last are full,
+ * so it must stay a multiple of the AES block size for CTR, and of the page
+ * size for the mmap read-ahead hints.
+ */
+#ifndef TINYCRYPT_FILE_CHUNK_SIZE
+#define TINYCRYPT_FILE_CHUNK_SIZE (256 * 1024)
+#endif
+
+#if TINYCRYPT_FILE_CHUNK_SIZE <= 0 || TINYCRYPT_FILE_CHUNK_SIZE % 4096 != 0
+#error "TINYCRYPT_FILE_CHUNK_SIZE must be a nonzero multiple of 4096"
+#endif
+
+#define CHUNK ((size_t) TINYCRYPT_FILE_CHUNK_SIZE)
+
+/* feeders return 1 on success, 0 on failure and -1 if the method is n/a */
+typedef int (*consume_fn)(void *ctx, const uint8_t *data, size_t len);
+
+static size_t min_size(size_t a, size_t b)
+{
+	return a < b ? a : b;
+}
+
+/* reads len bytes at off, fewer only at end of file */
+static ssize_t pread_full(int fd, uint8_t *buf, size_t len, off_t off)
+{
+	size_t got = 0;
+	ssize_t n;
+
+	while (got < len) {
+		n = pread(fd, buf + got, len - got, off + (off_t) got);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		} else if (n < 0) {
+			return -1;
+		} else if (n == 0) {
+			break;
+		}
+		got += (size_t) n;
+	}
+	return (ssize_t) got;
+}
+
+/* reads len bytes, fewer only at end of file */
+static ssize_t read_full(int fd, uint8_t *buf, size_t len)
+{
+	size_t got = 0;
+	ssize_t n;
+
+	while (got < len) {
+		n = read(fd, buf + got, len - got);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		} else if (n < 0) {
+			return -1;
+		} else if (n == 0) {
+			break;
+		}
+		got += (size_t) n;
+	}
+	return (ssize_t) got;
+}
+
+static int write_full(int fd, const uint8_t *buf, size_t len)
+{
+	ssize_t n;
+
+	while (len > 0) {
+		n = write(fd, buf, len);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		} else if (n <= 0) {
+			return 0;
+		}
+		buf += n;
+		len -= (size_t) n;
+	}
+	return 1;
+}
+
+static int feed_mmap(int fd, off_t size, consume_fn consume, void *ctx)
+{
+	uint8_t *map;
+	size_t total = (size_t) size;
+	size_t off;
+	size_t len;
+	int r = 1;
+
+	if (size == 0) {
+		return 1;
+	} else if ((off_t) total != size) {
+		return -1; /* does not fit the address space */
+	}
+
+	map = mmap(0, total, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) {
+		return -1;
+	}
+	(void) posix_madvise(map, total, POSIX_MADV_SEQUENTIAL);
+
+	for (off = 0; r && off < total; off += len) {
+		len = min_size(CHUNK, total - off);
+		/* have the next chunk paged in while this one is processed */
+		if (off + len < total) {
+			(void) posix_madvise(map + off + len,
+					     min_size(CHUNK, total - off - len),
+					     POSIX_MADV_WILLNEED);
+		}
+		r = consume(ctx, map + off, len);
+	}
+
+	(void) munmap(map, total);
+	return r;
+}
+
+static ssize_t aio_wait(struct aiocb *cb)
+{
+	const struct aiocb *list[1];
+
+	list[0] = cb;
+	while (aio_error(cb) == EINPROGRESS) {
+		(void) aio_suspend(list, 1, 0);
+	}
+	return aio_return(cb);
+}
+
+static int aio_start(struct aiocb *cb, int fd, uint8_t *buf, off_t off)
+{
+	_set(cb, 0, sizeof(*cb));
+	cb->aio_fildes = fd;
+	cb->aio_buf = buf;
+	cb->aio_nbytes = CHUNK;
+	cb->aio_offset = off;
+	cb->aio_sigevent.sigev_notify = SIGEV_NONE;
+	return aio_read(cb) == 0;
+}
+
+static int feed_aio(int fd, consume_fn consume, void *ctx)
+{
+	struct aiocb cb;
+	uint8_t *buf[2];
+	off_t off = 0;
+	ssize_t got;
+	ssize_t n;
+	int pending;
+	int cur = 0;
+	int r = 1;
+
+	buf[0] = malloc(2 * CHUNK);
+	if (buf[0] == 0) {
+		return 0;
+	}
+	buf[1] = buf[0] + CHUNK;
+
+	if (!aio_start(&cb, fd, buf[0], 0)) {
+		free(buf[0]);
+		return -1;
+	}
+	pending = 1;
+
+	while (pending) {
+		got = aio_wait(&cb);
+		pending = 0;
+		if (got < 0) {
+			r = 0;
+			break;
+		}
+		/* a short read may not be the end of the file: top it up */
+		if (got > 0 && (size_t) got < CHUNK) {
+			n = pread_full(fd, buf[cur] + got, CHUNK - (size_t) got,
+				       off + got);
+			if (n < 0) {
+				r = 0;
+				break;
+			}
+			got += n;
+		}
+		if (got == 0) {
+			break;
+		}
+		off += got;
+
+		/* read the next chunk into the other buffer meanwhile */
+		if ((size_t) got == CHUNK) {
+			if (!aio_start(&cb, fd, buf[cur ^ 1], off)) {
+				r = 0;
+				break;
+			}
+			pending = 1;
+		}
+		r = consume(ctx, buf[cur], (size_t) got);
+		if (!r) {
+			break;
+		}
+		cur ^= 1;
+	}
+
+	if (pending) {
+		(void) aio_wait(&cb);
+	}
+	free(buf[0]);
+	return r;
+}
+
+static int feed_read(int fd, consume_fn consume, void *ctx)
+{
+	uint8_t *buf;
+	ssize_t got;
+	int r = 1;
+
+	buf = malloc(CHUNK);
+	if (buf == 0) {
+		return 0;
+	}
+
+	while ((got = read_full(fd, buf, CHUNK)) > 0) {
+		r = consume(ctx, buf, (size_t) got);
+		if (!r || (size_t) got < CHUNK) {
+			break;
+		}
+	}
+	if (got < 0) {
+		r = 0;
+	}
+
+	free(buf);
+	return r;
+}
+
+static int feed(int fd, enum tc_file_io io, consume_fn consume, void *ctx)
+{
+	struct stat st;
+	int r = -1;
+
+	if (fstat(fd, &st) != 0) {
+		return 0;
+	}
+
+	if (!S_ISREG(st.st_mode)) {
+		io = TC_FILE_IO_READ;
+	} else if (lseek(fd, 0, SEEK_SET) != 0) {
+		return 0;
+	}
+
+	if (io == TC_FILE_IO_AUTO || io == TC_FILE_IO_MMAP) {
+		r = feed_mmap(fd, st.st_size, consume, ctx);
+	}
+	if (r < 0 && io != TC_FILE_IO_READ) {
+		r = feed_aio(fd, consume, ctx);
+	}
+	if (r < 0) {
+		r = feed_read(fd, consume, ctx);
+	}
+	return r;
+}
+
+static int sha256_consume(void *ctx, const uint8_t *data, size_t len)
+{
+	return tc_sha256_update((TCSha256State_t) ctx, data, len);
+}
+
+int tc_file_sha256_fd(uint8_t *digest, int fd, enum tc_file_io io)
+{
+	struct tc_sha256_state_struct s;
+
+	if (digest == (uint8_t *) 0 || fd < 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void) tc_sha256_init(&s);
+	if (feed(fd, io, &sha256_consume, &s) != 1) {
+		_set(&s, 0, sizeof(s));
+		return TC_CRYPTO_FAIL;
+	}
+	return tc_sha256_final(digest, &s);
+}
+
+int tc_file_sha256(uint8_t *digest, const char *path, enum tc_file_io io)
+{
+	int fd;
+	int r;
+	int saved;
+
+	if (path == (const char *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	r = tc_file_sha256_fd(digest, fd, io);
+	saved = errno;
+	(void) close(fd);
+	errno = saved;
+	return r;
+}
+
+struct ctr_ctx {
+	int out_fd;
+	uint8_t *ctr;
+	TCAesKeySched_t sched;
+	uint8_t *buf;
+};
+
+static int ctr_consume(void *ctx, const uint8_t *data, size_t len)
+{
+	struct ctr_ctx *c = (struct ctr_ctx *) ctx;
+
+	return tc_ctr_mode(c->buf, (unsigned int) len, data,
+			   (unsigned int) len, c->ctr, c->sched) &&
+	       write_full(c->out_fd, c->buf, len);
+}
+
+int tc_file_ctr_fd(int out_fd, int in_fd, uint8_t *ctr,
+		   const TCAesKeySched_t sched, enum tc_file_io io)
+{
+	struct ctr_ctx c;
+	int r;
+
+	if (out_fd < 0 || in_fd < 0 || ctr == (uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	c.out_fd = out_fd;
+	c.ctr = ctr;
+	c.sched = sched;
+	c.buf = malloc(CHUNK);
+	if (c.buf == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	r = feed(in_fd, io, &ctr_consume, &c) == 1;
+
+	_set(c.buf, 0, CHUNK);
+	free(c.buf);
+	return r ? TC_CRYPTO_SUCCESS : TC_CRYPTO_FAIL;
+}
+
+int tc_file_ctr(const char *out_path, const char *in_path, uint8_t *ctr,
+		const TCAesKeySched_t sched, enum tc_file_io io)
+{
+	int in_fd;
+	int out_fd;
+	int r;
+	int saved;
+
+	if (out_path == (const char *) 0 || in_path == (const char *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	in_fd = open(in_path, O_RDONLY);
+	if (in_fd < 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	out_fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	if (out_fd < 0) {
+		saved = errno;
+		(void) close(in_fd);
+		errno = saved;
+		return TC_CRYPTO_FAIL;
+	}
+
+	r = tc_file_ctr_fd(out_fd, in_fd, ctr, sched, io);
+	saved = errno;
+	if (close(out_fd) != 0 && r == TC_CRYPTO_SUCCESS) {
+		saved = errno;
+		r = TC_CRYPTO_FAIL;
+	}
+	(void) close(in_fd);
+	errno = saved;
+	return r;
+}
@@ -0,0 +1,136 @@
+/* tc_file.h - TinyCrypt host-side file hashing and encryption helpers */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Host-side helpers hashing or CTR-encrypting whole files.
+ *
+ *  Overview: These helpers feed a file to tc_sha256_update or tc_ctr_mode
+ *            TINYCRYPT_FILE_CHUNK_SIZE bytes at a time, overlapping the reads
+ *            with the computation:
+ *
+ *            TC_FILE_IO_MMAP maps a regular file and, while a chunk is
+ *            processed, asks the kernel to read ahead the next one
+ *            (posix_madvise). TC_FILE_IO_AIO alternates two buffers: while
+ *            one chunk is processed, the next one is read into the other
+ *            with aio_read. TC_FILE_IO_READ is a plain read() loop, which is
+ *            also what pipes and other streams always get. TC_FILE_IO_AUTO
+ *            tries them in that order.
+ *
+ *            Regular files are processed from their start whatever the
+ *            current file offset; streams from where they are.
+ *
+ *  Requires: POSIX (mmap, posix_madvise, aio), SHA-256, AES-128 and CTR
+ *            mode. These helpers are not part of libtinycrypt.a; build them
+ *            from tools/ on the host.
+ *
+ *  Usage:    call tc_file_sha256 (or tc_file_sha256_fd) to hash a file,
+ *            and tc_file_ctr (or tc_file_ctr_fd) with an AES key schedule and
+ *            counter to encrypt or decrypt one into another.
+ */
+
+#ifndef __TC_FILE_H__
+#define __TC_FILE_H__
+
+#include <tinycrypt/aes.h>
+#include <tinycrypt/sha256.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* how the input is read */
+enum tc_file_io {
+	TC_FILE_IO_AUTO,
+	TC_FILE_IO_MMAP,
+	TC_FILE_IO_AIO,
+	TC_FILE_IO_READ
+};
+
+/**
+ *  @brief Hashes the contents of an open file with SHA-256
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                digest == NULL or
+ *                fd < 0 or
+ *                reading the file failed (errno tells why)
+ *  @param digest OUT -- TC_SHA256_DIGEST_SIZE bytes
+ *  @param fd IN -- file descriptor open for reading
+ *  @param io IN -- how to read it
+ */
+int tc_file_sha256_fd(uint8_t *digest, int fd, enum tc_file_io io);
+
+/**
+ *  @brief Same as tc_file_sha256_fd for the file at path
+ *  @param digest OUT -- TC_SHA256_DIGEST_SIZE bytes
+ *  @param path IN -- the file to hash
+ *  @param io IN -- how to read it
+ */
+int tc_file_sha256(uint8_t *digest, const char *path, enum tc_file_io io);
+
+/**
+ *  @brief CTR-encrypts (or decrypts) an open file into another
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out_fd < 0 or
+ *                in_fd < 0 or
+ *                ctr == NULL or
+ *                sched == NULL or
+ *                reading or writing failed (errno tells why)
+ *  @note ctr is advanced as by one tc_ctr_mode call over the whole file, so
+ *        a counter must not be reused with the same key
+ *  @param out_fd IN -- file descriptor open for writing
+ *  @param in_fd IN -- file descriptor open for reading
+ *  @param ctr IN/OUT -- the current counter value
+ *  @param sched IN -- an initialized AES key schedule
+ *  @param io IN -- how to read the input
+ */
+int tc_file_ctr_fd(int out_fd, int in_fd, uint8_t *ctr,
+		   const TCAesKeySched_t sched, enum tc_file_io io);
+
+/**
+ *  @brief Same as tc_file_ctr_fd from in_path into out_path, which is
+ *  created (mode 0600) or truncated
+ *  @param out_path IN -- the output file
+ *  @param in_path IN -- the input file
+ *  @param ctr IN/OUT -- the current counter value
+ *  @param sched IN -- an initialized AES key schedule
+ *  @param io IN -- how to read the input
+ */
+int tc_file_ctr(const char *out_path, const char *in_path, uint8_t *ctr,
+		const TCAesKeySched_t sched, enum tc_file_io io);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_FILE_H__ */
@@ -0,0 +1,176 @@
+/* tcfile.c - TinyCrypt file hashing and encryption tool */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *  DESCRIPTION
+ * Hashes or CTR-encrypts files with the tc_file helpers:
+ *
+ *   tcfile [-i auto|mmap|aio|read] [-t] sha256 FILE...
+ *   tcfile [-i auto|mmap|aio|read] [-t] ctr KEYHEX CTRHEX IN OUT
+ *
+ *  sha256 prints one "digest  FILE" line per file, as sha256sum does. ctr
+ *  takes a 16-byte AES key and initial counter in hex; running it twice with
+ *  the same ones decrypts. -t reports the throughput of each file on stderr.
+ */
+
+/* for clock_gettime */
+#define _POSIX_C_SOURCE 200112L
+
+#include "tc_file.h"
+#include <tinycrypt/constants.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+static int parse_hex(uint8_t *out, unsigned int len, const char *hex)
+{
+	unsigned int i;
+	unsigned int v;
+
+	if (strlen(hex) != 2 * len) {
+		return 0;
+	}
+	for (i = 0; i < len; ++i) {
+		if (sscanf(hex + 2 * i, "%2x", &v) != 1) {
+			return 0;
+		}
+		out[i] = (uint8_t) v;
+	}
+	return 1;
+}
+
+static double now(void)
+{
+	struct timespec t;
+
+	(void) clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double) t.tv_sec + (double) t.tv_nsec / 1e9;
+}
+
+static void report(const char *path, double start)
+{
+	struct stat st;
+	double s = now() - start;
+
+	if (stat(path, &st) == 0 && s > 0) {
+		fprintf(stderr, "%s: %.1f MB/s\n", path,
+			(double) st.st_size / s / 1e6);
+	}
+}
+
+static int usage(const char *name)
+{
+	fprintf(stderr,
+		"usage: %s [-i auto|mmap|aio|read] [-t] sha256 FILE...\n"
+		"       %s [-i auto|mmap|aio|read] [-t] "
+		"ctr KEYHEX CTRHEX IN OUT\n", name, name);
+	return 2;
+}
+
+int main(int argc, char **argv)
+{
+	static const char *modes[] = { "auto", "mmap", "aio", "read" };
+	enum tc_file_io io = TC_FILE_IO_AUTO;
+	uint8_t digest[TC_SHA256_DIGEST_SIZE];
+	struct tc_aes_key_sched_struct sched;
+	uint8_t key[TC_AES_KEY_SIZE];
+	uint8_t ctr[TC_AES_BLOCK_SIZE];
+	unsigned int i, j;
+	int timed = 0;
+	int first = 1;
+	int ret = 0;
+	double start;
+
+	while (first < argc && argv[first][0] == '-') {
+		if (strcmp(argv[first], "-t") == 0) {
+			timed = 1;
+			first += 1;
+		} else if (strcmp(argv[first], "-i") == 0 &&
+			   first + 1 < argc) {
+			for (i = 0; i < 4; ++i) {
+				if (strcmp(argv[first + 1], modes[i]) == 0) {
+					break;
+				}
+			}
+			if (i == 4) {
+				return usage(argv[0]);
+			}
+			io = (enum tc_file_io) i;
+			first += 2;
+		} else {
+			return usage(argv[0]);
+		}
+	}
+
+	if (first + 1 < argc && strcmp(argv[first], "sha256") == 0) {
+		for (i = (unsigned int) first + 1; i < (unsigned int) argc;
+		     ++i) {
+			start = now();
+			if (!tc_file_sha256(digest, argv[i], io)) {
+				fprintf(stderr, "%s: %s: %s\n", argv[0],
+					argv[i], strerror(errno));
+				ret = 1;
+				continue;
+			}
+			for (j = 0; j < sizeof(digest); ++j) {
+				printf("%02x", digest[j]);
+			}
+			printf("  %s\n", argv[i]);
+			if (timed) {
+				report(argv[i], start);
+			}
+		}
+		return ret;
+	} else if (first + 5 == argc && strcmp(argv[first], "ctr") == 0) {
+		if (!parse_hex(key, sizeof(key), argv[first + 1]) ||
+		    !parse_hex(ctr, sizeof(ctr), argv[first + 2]) ||
+		    !tc_aes128_set_encrypt_key(&sched, key)) {
+			return usage(argv[0]);
+		}
+		start = now();
+		if (!tc_file_ctr(argv[first + 4], argv[first + 3], ctr, &sched,
+				 io)) {
+			fprintf(stderr, "%s: %s: %s\n", argv[0],
+				argv[first + 3], strerror(errno));
+			ret = 1;
+		} else if (timed) {
+			report(argv[first + 3], start);
+		}
+		memset(&sched, 0, sizeof(sched));
+		memset(key, 0, sizeof(key));
+		return ret;
+	}
+	return usage(argv[0]);
+}
@@ -0,0 +1,185 @@
+/* tcgentab.c - TinyCrypt generator of the precomputed ECC point tables */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *  DESCRIPTION
+ * Prints the precomputed multiples of the secp256r1 generator G used by the
+ * ECC code:
+ *
+ *   tcgentab comb  -- comb_table of ecc_fixed_base.c, for 4, 5 and 6 teeth
+ *   tcgentab wnaf  -- wnaf_g_table of ecc_wnaf.c, for windows of 4 to 7
+ *
+ *  Every point is computed with the Montgomery ladder (EccPoint_mult), which
+ *  uses neither table, and printed as the sources hold it: the affine x and
+ *  then y, least significant byte first, in BYTES_TO_WORDS_8 groups (so the
+ *  output does not depend on uECC_WORD_SIZE). "make tables" replaces the
+ *  blocks between the BEGIN and END tcgentab lines of the two sources with
+ *  this output, and "make check" checks that they match it.
+ */
+
+#include <tinycrypt/ecc.h>
+
+#include <stdio.h>
+#include <string.h>
+
+/* result = k * G, affine, for 0 < k < n */
+static void mult_g(uECC_word_t *result, const uECC_word_t *k,
+		   uECC_Curve curve)
+{
+	uECC_word_t k0[NUM_ECC_WORDS];
+	uECC_word_t k1[NUM_ECC_WORDS];
+	uECC_word_t carry;
+
+	/* the ladder cannot be used for 1 * G, which is G itself */
+	uECC_vli_clear(k0, NUM_ECC_WORDS);
+	k0[0] = 1;
+	if (uECC_vli_equal(k, k0, NUM_ECC_WORDS) == 0) {
+		uECC_vli_set(result, curve->G, 2 * NUM_ECC_WORDS);
+		return;
+	}
+
+	carry = regularize_k(k, k0, k1, curve);
+	EccPoint_mult(result, curve->G, carry ? k0 : k1, 0,
+		      curve->num_n_bits + 1, curve);
+}
+
+static void set_bit(uECC_word_t *k, unsigned int bit)
+{
+	k[bit / uECC_WORD_BITS] |= (uECC_word_t) 1 << (bit % uECC_WORD_BITS);
+}
+
+static unsigned int get_byte(const uECC_word_t *vli, unsigned int i)
+{
+	return (unsigned int)
+		(vli[i / uECC_WORD_SIZE] >> (8 * (i % uECC_WORD_SIZE))) & 0xff;
+}
+
+/* prints the rows of one table entry; the caller prints its braces */
+static void print_point(const uECC_word_t *point)
+{
+	unsigned int i;
+
+	for (i = 0; i < 2 * NUM_ECC_BYTES; ++i) {
+		printf("%s%02X", i % 8 == 0 ? "\t\tBYTES_TO_WORDS_8(" : ", ",
+		       get_byte(point + (i / NUM_ECC_BYTES) * NUM_ECC_WORDS,
+				i % NUM_ECC_BYTES));
+		if (i % 8 == 7) {
+			printf(")%s\n",
+			       i + 1 < 2 * NUM_ECC_BYTES ? "," : "");
+		}
+	}
+}
+
+/*
+ * Entry j - 1 of the table for t teeth of spacing ceil(256 / t) is
+ * sum(2^(i * spacing) * G) over the bits i set in j.
+ */
+static void print_comb(uECC_Curve curve)
+{
+	uECC_word_t point[2 * NUM_ECC_WORDS];
+	uECC_word_t k[NUM_ECC_WORDS];
+	unsigned int teeth;
+	unsigned int spacing;
+	unsigned int i;
+	unsigned int j;
+
+	for (teeth = 4; teeth <= 6; ++teeth) {
+		spacing = (NUM_ECC_BYTES * 8 + teeth - 1) / teeth;
+		printf("#%s uECC_FIXED_BASE_TEETH == %u\n",
+		       teeth == 4 ? "if" : "elif", teeth);
+		printf("#define COMB_SPACING %u\n", spacing);
+		printf("static const uECC_word_t comb_table[(1 << %u) - 1]"
+		       "[2 * NUM_ECC_WORDS] = {\n", teeth);
+		for (j = 1; j < (1u << teeth); ++j) {
+			uECC_vli_clear(k, NUM_ECC_WORDS);
+			for (i = 0; i < teeth; ++i) {
+				if (j & (1u << i)) {
+					set_bit(k, i * spacing);
+				}
+			}
+			mult_g(point, k, curve);
+			printf("\t{\n");
+			print_point(point);
+			printf("\t}%s\n", j + 1 < (1u << teeth) ? "," : "");
+		}
+		printf("};\n");
+	}
+	printf("#else\n");
+	printf("#error \"uECC_FIXED_BASE_TEETH must be 0, 4, 5 or 6\"\n");
+	printf("#endif\n");
+}
+
+/*
+ * Entry i of the table for a window of w bits is (2i + 1) * G, for
+ * i < 2^(w - 2); the entries a larger window adds are under an #if.
+ */
+static void print_wnaf(uECC_Curve curve)
+{
+	uECC_word_t point[2 * NUM_ECC_WORDS];
+	uECC_word_t k[NUM_ECC_WORDS];
+	unsigned int w;
+	unsigned int i;
+
+	printf("static const uECC_word_t "
+	       "wnaf_g_table[1 << (uECC_VERIFY_WNAF_WINDOW - 2)]\n"
+	       "\t\t\t\t     [2 * NUM_ECC_WORDS] = {\n");
+	for (i = 0, w = 4; w <= 7; ++w) {
+		if (w > 4) {
+			printf("#if uECC_VERIFY_WNAF_WINDOW > %u\n", w - 1);
+		}
+		for (; i < (1u << (w - 2)); ++i) {
+			uECC_vli_clear(k, NUM_ECC_WORDS);
+			k[0] = 2 * i + 1;
+			mult_g(point, k, curve);
+			printf("\t{ /* %uG */\n", 2 * i + 1);
+			print_point(point);
+			printf("\t},\n");
+		}
+		if (w > 4) {
+			printf("#endif\n");
+		}
+	}
+	printf("};\n");
+}
+
+int main(int argc, char **argv)
+{
+	if (argc == 2 && strcmp(argv[1], "comb") == 0) {
+		print_comb(uECC_secp256r1());
+	} else if (argc == 2 && strcmp(argv[1], "wnaf") == 0) {
+		print_wnaf(uECC_secp256r1());
+	} else {
+		fprintf(stderr, "usage: %s comb|wnaf\n", argv[0]);
+		return 2;
+	}
+	return 0;
+}